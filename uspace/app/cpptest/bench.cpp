@@ -0,0 +1,101 @@
+/*
+ * Copyright (c) 2019 Jaroslav Jindrak
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * - Redistributions of source code must retain the above copyright
+ *   notice, this list of conditions and the following disclaimer.
+ * - Redistributions in binary form must reproduce the above copyright
+ *   notice, this list of conditions and the following disclaimer in the
+ *   documentation and/or other materials provided with the distribution.
+ * - The name of the author may not be used to endorse or promote products
+ *   derived from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHOR ``AS IS'' AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+ * OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+ * IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT
+ * NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF
+ * THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <cstdio>
+#include <string>
+#include "bench.hpp"
+
+namespace bench
+{
+    namespace
+    {
+        const benchmark benchmarks[] = {
+            { "async", "std::async fan out and per task overhead", &async },
+            { "atomic", "Atomic counters, flags and shared_ptr under contention", &atomic },
+            { "hash_map", "Flat hash map versus unordered_map", &hash_map },
+            { "iostream", "Formatted stream output versus stdio", &iostreams },
+            { "pmr", "Memory resources versus the global heap", &pmr },
+            { "push_back", "Vector and deque growth and bulk insertion", &push_back },
+            { "regex", "Compiled regular expressions versus a backtracking matcher", &regexes },
+            { "sort", "Sorting, partial sorting and selection", &sort },
+            { "string", "String construction, copying and concatenation", &strings },
+            { "valarray", "Valarray expressions versus hand written loops", &valarrays },
+            { nullptr, nullptr, nullptr }
+        };
+
+        bool run_benchmark(const benchmark& b)
+        {
+            std::printf("%s (%s)\n", b.name, b.desc);
+            bool res = b.run();
+            std::printf("%s\n", res ? "OK" : "FAILED");
+
+            return res;
+        }
+
+        void list_benchmarks()
+        {
+            for (auto b = benchmarks; b->name; ++b)
+                std::printf("%-16s %s\n", b->name, b->desc);
+            std::printf("%-16s Run all benchmarks\n", "*");
+        }
+    }
+
+    int main(int argc, char** argv)
+    {
+        if (argc < 2)
+        {
+            std::printf("Usage: cpptest bench <benchmark>\n\n");
+            list_benchmarks();
+
+            return 0;
+        }
+
+        std::string name{argv[1]};
+        bool all = name == "*";
+        bool found{false};
+        bool res{true};
+
+        for (auto b = benchmarks; b->name; ++b)
+        {
+            if (all || name == b->name)
+            {
+                found = true;
+                res &= run_benchmark(*b);
+            }
+        }
+
+        if (!found)
+        {
+            std::printf("Unknown benchmark \"%s\"\n", argv[1]);
+
+            return 2;
+        }
+
+        return res ? 0 : 1;
+    }
+}
@@ -0,0 +1,89 @@
+/*
+ * Copyright (c) 2019 Jaroslav Jindrak
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * - Redistributions of source code must retain the above copyright
+ *   notice, this list of conditions and the following disclaimer.
+ * - Redistributions in binary form must reproduce the above copyright
+ *   notice, this list of conditions and the following disclaimer in the
+ *   documentation and/or other materials provided with the distribution.
+ * - The name of the author may not be used to endorse or promote products
+ *   derived from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHOR ``AS IS'' AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+ * OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+ * IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT
+ * NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF
+ * THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef CPPTEST_BENCH_HPP
+#define CPPTEST_BENCH_HPP
+
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+
+namespace bench
+{
+    struct benchmark
+    {
+        const char* name;
+        const char* desc;
+        bool (*run)();
+    };
+
+    /**
+     * Measures wall clock time since construction.
+     */
+    class stopwatch
+    {
+        public:
+            stopwatch()
+                : start_{std::chrono::steady_clock::now()}
+            { /* DUMMY BODY */ }
+
+            std::uint64_t usecs() const
+            {
+                auto diff = std::chrono::steady_clock::now() - start_;
+
+                return std::chrono::duration_cast<std::chrono::microseconds>(diff).count();
+            }
+
+        private:
+            std::chrono::steady_clock::time_point start_;
+    };
+
+    inline void report(const char* what, std::uint64_t ops, std::uint64_t usecs)
+    {
+        std::printf("  %-32s %10llu us", what, (unsigned long long)usecs);
+        if (usecs > 0)
+            std::printf(" %12llu ops/s\n", (unsigned long long)(ops * 1'000'000 / usecs));
+        else
+            std::printf("\n");
+    }
+
+    int main(int, char**);
+
+    bool async();
+    bool atomic();
+    bool hash_map();
+    bool iostreams();
+    bool pmr();
+    bool push_back();
+    bool regexes();
+    bool sort();
+    bool strings();
+    bool valarrays();
+}
+
+#endif
@@ -0,0 +1,123 @@
+/*
+ * Copyright (c) 2019 Jaroslav Jindrak
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * - Redistributions of source code must retain the above copyright
+ *   notice, this list of conditions and the following disclaimer.
+ * - Redistributions in binary form must reproduce the above copyright
+ *   notice, this list of conditions and the following disclaimer in the
+ *   documentation and/or other materials provided with the distribution.
+ * - The name of the author may not be used to endorse or promote products
+ *   derived from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHOR ``AS IS'' AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+ * OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+ * IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT
+ * NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF
+ * THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <cstdint>
+#include <cstdio>
+#include <future>
+#include <thread>
+#include <vector>
+#include "../bench.hpp"
+
+namespace bench
+{
+    namespace
+    {
+        constexpr std::uint64_t work = 50'000'000;
+        constexpr std::uint64_t small_tasks = 10'000;
+
+        volatile std::uint64_t sink{};
+
+        std::uint64_t spin(std::uint64_t first, std::uint64_t last)
+        {
+            std::uint64_t res{};
+            for (auto i = first; i < last; ++i)
+                res += (i * i) ^ (res >> 3);
+
+            return res;
+        }
+
+        bool fan_out(unsigned int tasks)
+        {
+            std::uint64_t expected{};
+            auto chunk = work / tasks;
+            for (unsigned int i = 0; i < tasks; ++i)
+                expected += spin(i * chunk, (i + 1) * chunk);
+
+            std::vector<std::future<std::uint64_t>> futs{};
+            stopwatch sw{};
+            for (unsigned int i = 0; i < tasks; ++i)
+                futs.push_back(std::async(std::launch::async, spin, i * chunk, (i + 1) * chunk));
+
+            std::uint64_t res{};
+            for (auto& fut: futs)
+                res += fut.get();
+
+            char what[32];
+            std::snprintf(what, sizeof(what), "fan out, %u tasks", tasks);
+            report(what, work, sw.usecs());
+
+            return res == expected;
+        }
+
+        bool task_overhead()
+        {
+            std::uint64_t res{};
+            stopwatch sw{};
+            for (std::uint64_t i = 0; i < small_tasks; ++i)
+                res += std::async(std::launch::async, spin, 0, 10).get();
+            report("async round trip", small_tasks, sw.usecs());
+
+            return res == small_tasks * spin(0, 10);
+        }
+
+        bool thread_overhead()
+        {
+            std::uint64_t res{};
+            stopwatch sw{};
+            for (std::uint64_t i = 0; i < small_tasks; ++i)
+            {
+                std::uint64_t val{};
+                std::thread thr{[&val](){ val = spin(0, 10); }};
+                thr.join();
+                res += val;
+            }
+            report("thread round trip", small_tasks, sw.usecs());
+
+            return res == small_tasks * spin(0, 10);
+        }
+    }
+
+    bool async()
+    {
+        auto cpus = std::thread::hardware_concurrency();
+        std::printf("  %u CPUs\n", cpus);
+
+        stopwatch sw{};
+        sink = spin(0, work);
+        report("sequential", work, sw.usecs());
+
+        bool res = fan_out(1);
+        if (cpus > 1)
+            res &= fan_out(cpus);
+        res &= fan_out(4 * (cpus ? cpus : 1));
+        res &= task_overhead();
+        res &= thread_overhead();
+
+        return res;
+    }
+}
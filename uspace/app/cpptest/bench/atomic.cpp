@@ -0,0 +1,176 @@
+/*
+ * Copyright (c) 2019 Jaroslav Jindrak
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * - Redistributions of source code must retain the above copyright
+ *   notice, this list of conditions and the following disclaimer.
+ * - Redistributions in binary form must reproduce the above copyright
+ *   notice, this list of conditions and the following disclaimer in the
+ *   documentation and/or other materials provided with the distribution.
+ * - The name of the author may not be used to endorse or promote products
+ *   derived from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHOR ``AS IS'' AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+ * OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+ * IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT
+ * NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF
+ * THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include "../bench.hpp"
+
+namespace bench
+{
+    namespace
+    {
+        constexpr unsigned threads = 4;
+        constexpr std::uint64_t iterations = 250'000;
+        constexpr std::uint64_t pingpongs = 20'000;
+
+        /**
+         * Runs f(i) in each of the worker threads
+         * and returns the elapsed time.
+         */
+        template<class F>
+        std::uint64_t run_threads(F f)
+        {
+            std::vector<std::thread> workers{};
+            stopwatch sw{};
+
+            for (unsigned i = 0; i < threads; ++i)
+                workers.emplace_back([&f, i](){ f(i); });
+            for (auto& w: workers)
+                w.join();
+
+            return sw.usecs();
+        }
+
+        bool counters()
+        {
+            std::atomic<std::uint64_t> acnt{0};
+            auto usecs = run_threads([&acnt](unsigned){
+                for (std::uint64_t i = 0; i < iterations; ++i)
+                    acnt.fetch_add(1, std::memory_order_relaxed);
+            });
+            report("atomic fetch_add", threads * iterations, usecs);
+
+            std::atomic<std::uint64_t> ccnt{0};
+            usecs = run_threads([&ccnt](unsigned){
+                for (std::uint64_t i = 0; i < iterations; ++i)
+                {
+                    auto old = ccnt.load(std::memory_order_relaxed);
+                    while (!ccnt.compare_exchange_weak(old, old + 1,
+                                                       std::memory_order_relaxed))
+                    { /* DUMMY BODY */ }
+                }
+            });
+            report("atomic compare_exchange loop", threads * iterations, usecs);
+
+            std::atomic_flag flag = ATOMIC_FLAG_INIT;
+            std::uint64_t scnt{0};
+            usecs = run_threads([&flag, &scnt](unsigned){
+                for (std::uint64_t i = 0; i < iterations; ++i)
+                {
+                    while (flag.test_and_set(std::memory_order_acquire))
+                    { /* DUMMY BODY */ }
+                    ++scnt;
+                    flag.clear(std::memory_order_release);
+                }
+            });
+            report("atomic_flag spinlock", threads * iterations, usecs);
+
+            std::mutex mtx{};
+            std::uint64_t mcnt{0};
+            usecs = run_threads([&mtx, &mcnt](unsigned){
+                for (std::uint64_t i = 0; i < iterations; ++i)
+                {
+                    std::lock_guard<std::mutex> lock{mtx};
+                    ++mcnt;
+                }
+            });
+            report("mutex", threads * iterations, usecs);
+
+            std::uint64_t expected = threads * iterations;
+
+            return acnt.load() == expected && ccnt.load() == expected &&
+                   scnt == expected && mcnt == expected;
+        }
+
+        bool shared_ptrs()
+        {
+            auto ptr = std::make_shared<int>(42);
+            auto usecs = run_threads([&ptr](unsigned){
+                for (std::uint64_t i = 0; i < iterations; ++i)
+                {
+                    auto copy = ptr;
+                    (void)copy;
+                }
+            });
+            report("shared_ptr copy", threads * iterations, usecs);
+
+            return ptr.use_count() == 1;
+        }
+
+        bool pingpong()
+        {
+            std::atomic<std::uint64_t> turn{0};
+            stopwatch sw{};
+
+            std::thread peer{[&turn](){
+                for (std::uint64_t i = 0; i < pingpongs; ++i)
+                {
+                    turn.wait(2 * i);
+                    turn.store(2 * i + 2);
+                    turn.notify_one();
+                }
+            }};
+
+            for (std::uint64_t i = 0; i < pingpongs; ++i)
+            {
+                turn.store(2 * i + 1);
+                turn.notify_one();
+                turn.wait(2 * i + 1);
+            }
+
+            peer.join();
+            report("wait/notify ping-pong", pingpongs, sw.usecs());
+
+            return turn.load() == 2 * pingpongs;
+        }
+    }
+
+    bool atomic()
+    {
+        /**
+         * Let the fibrils of the worker threads
+         * actually run in parallel.
+         */
+        static bool runners{false};
+        if (!runners)
+        {
+            std::hel::fibril_test_spawn_runners(threads - 1);
+            runners = true;
+        }
+
+        bool res = counters();
+        res &= shared_ptrs();
+        res &= pingpong();
+
+        return res;
+    }
+}
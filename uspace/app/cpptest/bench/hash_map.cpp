@@ -0,0 +1,107 @@
+/*
+ * Copyright (c) 2019 Jaroslav Jindrak
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * - Redistributions of source code must retain the above copyright
+ *   notice, this list of conditions and the following disclaimer.
+ * - Redistributions in binary form must reproduce the above copyright
+ *   notice, this list of conditions and the following disclaimer in the
+ *   documentation and/or other materials provided with the distribution.
+ * - The name of the author may not be used to endorse or promote products
+ *   derived from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHOR ``AS IS'' AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+ * OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+ * IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT
+ * NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF
+ * THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <cstdint>
+#include <cstdio>
+#include <flat_hash_map>
+#include <unordered_map>
+#include <vector>
+#include "../bench.hpp"
+
+namespace bench
+{
+    namespace
+    {
+        constexpr std::uint64_t count = 100'000;
+
+        std::vector<std::uint64_t> make_keys()
+        {
+            /**
+             * Keys are scrambled by a multiplicative constant,
+             * sequential keys would favour the identity std::hash
+             * of the node based map.
+             */
+            std::vector<std::uint64_t> keys{};
+            keys.reserve(count);
+            for (std::uint64_t i = 0; i < count; ++i)
+                keys.push_back((i + 1) * 0x9E3779B97F4A7C15ULL);
+
+            return keys;
+        }
+
+        template<class Map>
+        bool run(const char* name, const std::vector<std::uint64_t>& keys)
+        {
+            Map map{};
+            bool res{true};
+
+            std::printf("%s:\n", name);
+
+            stopwatch insert_sw{};
+            for (auto key: keys)
+                map[key] = key;
+            report("insert", count, insert_sw.usecs());
+
+            std::uint64_t hits{};
+            stopwatch hit_sw{};
+            for (auto key: keys)
+                hits += map.count(key);
+            report("lookup hit", count, hit_sw.usecs());
+            res &= (hits == count);
+
+            hits = 0;
+            stopwatch miss_sw{};
+            for (auto key: keys)
+                hits += map.count(key + 1);
+            report("lookup miss", count, miss_sw.usecs());
+            res &= (hits == 0);
+
+            stopwatch erase_sw{};
+            for (auto key: keys)
+                map.erase(key);
+            report("erase", count, erase_sw.usecs());
+            res &= map.empty();
+
+            return res;
+        }
+    }
+
+    bool hash_map()
+    {
+        auto keys = make_keys();
+
+        bool res = run<std::hel::flat_hash_map<std::uint64_t, std::uint64_t>>(
+            "flat_hash_map", keys
+        );
+        res &= run<std::unordered_map<std::uint64_t, std::uint64_t>>(
+            "unordered_map", keys
+        );
+
+        return res;
+    }
+}
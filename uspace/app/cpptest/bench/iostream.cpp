@@ -0,0 +1,112 @@
+/*
+ * Copyright (c) 2019 Jaroslav Jindrak
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * - Redistributions of source code must retain the above copyright
+ *   notice, this list of conditions and the following disclaimer.
+ * - Redistributions in binary form must reproduce the above copyright
+ *   notice, this list of conditions and the following disclaimer in the
+ *   documentation and/or other materials provided with the distribution.
+ * - The name of the author may not be used to endorse or promote products
+ *   derived from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHOR ``AS IS'' AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+ * OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+ * IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT
+ * NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF
+ * THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <cstdint>
+#include <cstdio>
+#include <fstream>
+#include <sstream>
+#include "../bench.hpp"
+
+namespace bench
+{
+    namespace
+    {
+        constexpr std::uint64_t numbers = 100'000;
+
+        const char* path = "/tmp/cpptest-iostream.txt";
+
+        bool ints_stdio()
+        {
+            FILE* file = std::fopen(path, "w");
+            if (!file)
+                return false;
+
+            stopwatch sw{};
+            for (std::uint64_t i = 0; i < numbers; ++i)
+                std::fprintf(file, "%llu\n", (unsigned long long)(i * 7919));
+            std::fclose(file);
+            report("ints, fprintf", numbers, sw.usecs());
+
+            return true;
+        }
+
+        bool ints_ofstream()
+        {
+            std::ofstream file{path};
+            if (!file)
+                return false;
+
+            stopwatch sw{};
+            for (std::uint64_t i = 0; i < numbers; ++i)
+                file << i * 7919 << '\n';
+            file.close();
+            report("ints, ofstream", numbers, sw.usecs());
+
+            return true;
+        }
+
+        bool doubles_ofstream()
+        {
+            std::ofstream file{path};
+            if (!file)
+                return false;
+
+            stopwatch sw{};
+            for (std::uint64_t i = 0; i < numbers; ++i)
+                file << i * 0.25 << '\n';
+            file.close();
+            report("doubles, ofstream", numbers, sw.usecs());
+
+            return true;
+        }
+
+        bool ints_ostringstream()
+        {
+            std::ostringstream oss{};
+
+            stopwatch sw{};
+            for (std::uint64_t i = 0; i < numbers; ++i)
+                oss << static_cast<long>(i) - 50'000 << ' ';
+            report("ints, ostringstream", numbers, sw.usecs());
+
+            return oss.str().size() > numbers;
+        }
+    }
+
+    bool iostreams()
+    {
+        bool res = ints_stdio();
+        res &= ints_ofstream();
+        res &= doubles_ofstream();
+        res &= ints_ostringstream();
+
+        std::remove(path);
+
+        return res;
+    }
+}
@@ -0,0 +1,120 @@
+/*
+ * Copyright (c) 2019 Jaroslav Jindrak
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * - Redistributions of source code must retain the above copyright
+ *   notice, this list of conditions and the following disclaimer.
+ * - Redistributions in binary form must reproduce the above copyright
+ *   notice, this list of conditions and the following disclaimer in the
+ *   documentation and/or other materials provided with the distribution.
+ * - The name of the author may not be used to endorse or promote products
+ *   derived from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHOR ``AS IS'' AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+ * OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+ * IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT
+ * NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF
+ * THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <cstdint>
+#include <memory_resource>
+#include <string>
+#include <vector>
+#include "../bench.hpp"
+
+namespace bench
+{
+    namespace
+    {
+        constexpr std::uint64_t requests = 2'000;
+        constexpr std::uint64_t items = 100;
+        constexpr std::uint64_t blocks = 200'000;
+
+        const char* text = "a request scoped string that is not stored inline";
+
+        /**
+         * Simulates a request that builds a small
+         * table of strings and then throws it away.
+         */
+        template<class Vector>
+        std::size_t request(Vector& vec)
+        {
+            for (std::uint64_t i = 0; i < items; ++i)
+                vec.emplace_back(text);
+
+            return vec.size();
+        }
+
+        bool requests_global()
+        {
+            std::size_t total{};
+            stopwatch sw{};
+            for (std::uint64_t i = 0; i < requests; ++i)
+            {
+                std::vector<std::string> vec{};
+                total += request(vec);
+            }
+            report("request, global heap", requests, sw.usecs());
+
+            return total == requests * items;
+        }
+
+        bool requests_monotonic()
+        {
+            std::size_t total{};
+            char buffer[16384];
+            stopwatch sw{};
+            for (std::uint64_t i = 0; i < requests; ++i)
+            {
+                std::pmr::monotonic_buffer_resource arena{buffer, sizeof(buffer)};
+                std::pmr::vector<std::pmr::string> vec{&arena};
+                total += request(vec);
+            }
+            report("request, monotonic arena", requests, sw.usecs());
+
+            return total == requests * items;
+        }
+
+        bool blocks_churn(const char* what, std::pmr::memory_resource* res)
+        {
+            void* ptrs[64];
+            stopwatch sw{};
+            for (std::uint64_t i = 0; i < blocks / 64; ++i)
+            {
+                for (std::size_t j = 0; j < 64; ++j)
+                    ptrs[j] = res->allocate(16 + (j % 8) * 8);
+                for (std::size_t j = 0; j < 64; ++j)
+                    res->deallocate(ptrs[j], 16 + (j % 8) * 8);
+            }
+            report(what, blocks, sw.usecs());
+
+            return true;
+        }
+    }
+
+    bool pmr()
+    {
+        bool res = requests_global();
+        res &= requests_monotonic();
+
+        res &= blocks_churn("blocks, new_delete_resource", std::pmr::new_delete_resource());
+
+        std::pmr::unsynchronized_pool_resource unsync{};
+        res &= blocks_churn("blocks, unsynchronized pool", &unsync);
+
+        std::pmr::synchronized_pool_resource sync{};
+        res &= blocks_churn("blocks, synchronized pool", &sync);
+
+        return res;
+    }
+}
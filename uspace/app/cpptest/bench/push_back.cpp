@@ -0,0 +1,169 @@
+/*
+ * Copyright (c) 2019 Jaroslav Jindrak
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * - Redistributions of source code must retain the above copyright
+ *   notice, this list of conditions and the following disclaimer.
+ * - Redistributions in binary form must reproduce the above copyright
+ *   notice, this list of conditions and the following disclaimer in the
+ *   documentation and/or other materials provided with the distribution.
+ * - The name of the author may not be used to endorse or promote products
+ *   derived from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHOR ``AS IS'' AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+ * OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+ * IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT
+ * NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF
+ * THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+#include <cstdint>
+#include <deque>
+#include <string>
+#include <type_traits>
+#include <vector>
+#include "../bench.hpp"
+
+namespace bench
+{
+    namespace
+    {
+        constexpr std::size_t elements = 1'000'000;
+        constexpr std::size_t rounds = 20;
+
+        struct point
+        {
+            std::int64_t x;
+            std::int64_t y;
+        };
+
+        template<class Container>
+        bool fill(const char* what, bool reserve)
+        {
+            std::size_t total{};
+            stopwatch sw{};
+            for (std::size_t r = 0; r < rounds; ++r)
+            {
+                Container cont{};
+                if constexpr (std::is_same_v<Container, std::vector<int>>)
+                {
+                    if (reserve)
+                        cont.reserve(elements);
+                }
+
+                for (std::size_t i = 0; i < elements; ++i)
+                    cont.push_back(static_cast<int>(i));
+                total += cont.size();
+            }
+            report(what, rounds * elements, sw.usecs());
+
+            return total == rounds * elements;
+        }
+
+        bool points()
+        {
+            std::size_t total{};
+            stopwatch sw{};
+            for (std::size_t r = 0; r < rounds; ++r)
+            {
+                std::vector<point> vec{};
+                for (std::size_t i = 0; i < elements; ++i)
+                    vec.push_back(point{(std::int64_t)i, (std::int64_t)i});
+                total += vec.size();
+            }
+            report("vector<point>", rounds * elements, sw.usecs());
+
+            return total == rounds * elements;
+        }
+
+        bool long_strings()
+        {
+            constexpr std::size_t count = elements / 10;
+
+            std::size_t total{};
+            stopwatch sw{};
+            for (std::size_t r = 0; r < rounds; ++r)
+            {
+                std::vector<std::string> vec{};
+                for (std::size_t i = 0; i < count; ++i)
+                    vec.push_back("a rather long string that cannot be stored inline");
+                total += vec.size();
+            }
+            report("vector<string>", rounds * count, sw.usecs());
+
+            return total == rounds * count;
+        }
+
+        bool push_front()
+        {
+            std::size_t total{};
+            stopwatch sw{};
+            for (std::size_t r = 0; r < rounds; ++r)
+            {
+                std::deque<int> deq{};
+                for (std::size_t i = 0; i < elements; ++i)
+                    deq.push_front(static_cast<int>(i));
+                total += deq.size();
+            }
+            report("deque<int> push_front", rounds * elements, sw.usecs());
+
+            return total == rounds * elements;
+        }
+
+        bool range_insert()
+        {
+            constexpr std::size_t count = 64;
+            constexpr std::size_t inserts = 64;
+
+            std::vector<int> chunk(count, 1);
+            std::size_t total{};
+
+            stopwatch sw_range{};
+            for (std::size_t r = 0; r < rounds; ++r)
+            {
+                std::vector<int> vec(count, 0);
+                for (std::size_t i = 0; i < inserts; ++i)
+                    vec.insert(vec.begin() + count / 2, chunk.begin(), chunk.end());
+                total += vec.size();
+            }
+            report("vector range insert", rounds * inserts * count, sw_range.usecs());
+
+            stopwatch sw_single{};
+            for (std::size_t r = 0; r < rounds; ++r)
+            {
+                std::vector<int> vec(count, 0);
+                for (std::size_t i = 0; i < inserts; ++i)
+                {
+                    auto pos = count / 2;
+                    for (auto x: chunk)
+                        vec.insert(vec.begin() + pos++, x);
+                }
+                total -= vec.size();
+            }
+            report("vector insert one by one", rounds * inserts * count, sw_single.usecs());
+
+            return total == 0;
+        }
+    }
+
+    bool push_back()
+    {
+        bool res = fill<std::vector<int>>("vector<int>", false);
+        res &= fill<std::vector<int>>("vector<int> reserved", true);
+        res &= points();
+        res &= long_strings();
+        res &= fill<std::deque<int>>("deque<int>", false);
+        res &= push_front();
+        res &= range_insert();
+
+        return res;
+    }
+}
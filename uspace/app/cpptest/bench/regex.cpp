@@ -0,0 +1,201 @@
+/*
+ * Copyright (c) 2019 Jaroslav Jindrak
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * - Redistributions of source code must retain the above copyright
+ *   notice, this list of conditions and the following disclaimer.
+ * - Redistributions in binary form must reproduce the above copyright
+ *   notice, this list of conditions and the following disclaimer in the
+ *   documentation and/or other materials provided with the distribution.
+ * - The name of the author may not be used to endorse or promote products
+ *   derived from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHOR ``AS IS'' AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+ * OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+ * IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT
+ * NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF
+ * THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+#include <cstdint>
+#include <cstring>
+#include <regex>
+#include <string>
+#include <vector>
+#include "../bench.hpp"
+
+namespace bench
+{
+    namespace
+    {
+        constexpr std::size_t line_count = 32'768;
+        constexpr std::size_t line_length = 64;
+
+        /**
+         * Kernighan and Pike's backtracking matcher, supports
+         * literals, '.', '*', '^' and '$'. This is the kind
+         * of code the compiled engine is meant to replace.
+         */
+        bool naive_here(const char*, const char*);
+
+        bool naive_star(char c, const char* re, const char* text)
+        {
+            do
+            {
+                if (naive_here(re, text))
+                    return true;
+            } while (*text != '\0' && (*text++ == c || c == '.'));
+
+            return false;
+        }
+
+        bool naive_here(const char* re, const char* text)
+        {
+            if (re[0] == '\0')
+                return true;
+            if (re[1] == '*')
+                return naive_star(re[0], re + 2, text);
+            if (re[0] == '$' && re[1] == '\0')
+                return *text == '\0';
+            if (*text != '\0' && (re[0] == '.' || re[0] == *text))
+                return naive_here(re + 1, text + 1);
+
+            return false;
+        }
+
+        bool naive_search(const char* re, const char* text)
+        {
+            if (re[0] == '^')
+                return naive_here(re + 1, text);
+
+            do
+            {
+                if (naive_here(re, text))
+                    return true;
+            } while (*text++ != '\0');
+
+            return false;
+        }
+
+        std::vector<std::string> make_lines()
+        {
+            const char* words[] = {
+                "lorem", "ipsum", "dolor", "sit", "amet", "kernel",
+                "fibril", "async", "ipc", "task", "thread", "page"
+            };
+
+            std::vector<std::string> lines{};
+            lines.reserve(line_count);
+
+            std::uint32_t seed{2019};
+            for (std::size_t i = 0; i < line_count; ++i)
+            {
+                std::string line{};
+                while (line.size() < line_length)
+                {
+                    seed = seed * 1103515245U + 12345U;
+                    line += words[(seed >> 16) % 12];
+                    line += ' ';
+                }
+
+                if (i % 97 == 0)
+                    line += "needle";
+                lines.push_back(line);
+            }
+
+            return lines;
+        }
+
+        bool compare(const char* what, const std::vector<std::string>& lines,
+                     const char* naive_pattern, const char* pattern)
+        {
+            std::size_t naive_hits{};
+            stopwatch naive_sw{};
+            for (const auto& line: lines)
+            {
+                if (naive_search(naive_pattern, line.c_str()))
+                    ++naive_hits;
+            }
+            auto naive_time = naive_sw.usecs();
+
+            std::regex re{pattern};
+            std::size_t hits{};
+            stopwatch sw{};
+            for (const auto& line: lines)
+            {
+                if (std::regex_search(line.c_str(), re))
+                    ++hits;
+            }
+            auto time = sw.usecs();
+
+            std::string label{what};
+            report((label + ", naive").c_str(), lines.size(), naive_time);
+            report((label + ", std::regex").c_str(), lines.size(), time);
+
+            return hits == naive_hits;
+        }
+
+        bool iterate(const std::vector<std::string>& lines)
+        {
+            std::string text{};
+            for (const auto& line: lines)
+            {
+                text += line;
+                text += '\n';
+            }
+
+            std::regex re{"[a-z]+ing|needle"};
+            std::size_t count{};
+            stopwatch sw{};
+            auto it = std::sregex_iterator{text.begin(), text.end(), re};
+            for (; it != std::sregex_iterator{}; ++it)
+                ++count;
+            report("iterate over matches", text.size(), sw.usecs());
+
+            return count > 0;
+        }
+
+        bool pathological()
+        {
+            constexpr std::size_t rounds = 20;
+            std::string text(24, 'a');
+
+            stopwatch naive_sw{};
+            bool naive_found{false};
+            for (std::size_t i = 0; i < rounds; ++i)
+                naive_found |= naive_search("a*a*a*a*a*a*b", text.c_str());
+            report("a*a*a*a*a*a*b, naive", rounds, naive_sw.usecs());
+
+            std::regex re{"a*a*a*a*a*a*b"};
+            stopwatch sw{};
+            bool found{false};
+            for (std::size_t i = 0; i < rounds; ++i)
+                found |= std::regex_search(text, re);
+            report("a*a*a*a*a*a*b, std::regex", rounds, sw.usecs());
+
+            return !found && !naive_found;
+        }
+    }
+
+    bool regexes()
+    {
+        auto lines = make_lines();
+
+        bool res = compare("literal", lines, "needle", "needle");
+        res &= compare("wildcards", lines, "k.*l.*c", "k.*l.*c");
+        res &= compare("anchored", lines, "^fibril", "^fibril");
+        res &= compare("no match", lines, "x.*y", "x.*y");
+        res &= iterate(lines);
+        res &= pathological();
+
+        return res;
+    }
+}
@@ -0,0 +1,137 @@
+/*
+ * Copyright (c) 2019 Jaroslav Jindrak
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * - Redistributions of source code must retain the above copyright
+ *   notice, this list of conditions and the following disclaimer.
+ * - Redistributions in binary form must reproduce the above copyright
+ *   notice, this list of conditions and the following disclaimer in the
+ *   documentation and/or other materials provided with the distribution.
+ * - The name of the author may not be used to endorse or promote products
+ *   derived from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHOR ``AS IS'' AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+ * OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+ * IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT
+ * NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF
+ * THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <algorithm>
+#include <cstdint>
+#include <vector>
+#include "../bench.hpp"
+
+namespace bench
+{
+    namespace
+    {
+        constexpr std::size_t elements = 200'000;
+        constexpr std::size_t top = 100;
+
+        enum class pattern
+        {
+            random,
+            sorted,
+            reversed,
+            few_unique
+        };
+
+        std::vector<std::uint32_t> make_input(pattern p)
+        {
+            std::vector<std::uint32_t> res(elements);
+            std::uint32_t state{2463534242u};
+
+            for (std::size_t i = 0; i < elements; ++i)
+            {
+                // Xorshift, we only need reproducible noise.
+                state ^= state << 13;
+                state ^= state >> 17;
+                state ^= state << 5;
+
+                switch (p)
+                {
+                    case pattern::random:
+                        res[i] = state;
+                        break;
+                    case pattern::sorted:
+                        res[i] = i;
+                        break;
+                    case pattern::reversed:
+                        res[i] = elements - i;
+                        break;
+                    case pattern::few_unique:
+                        res[i] = state % 16;
+                        break;
+                }
+            }
+
+            return res;
+        }
+
+        /**
+         * Runs f on a fresh copy of input, reports the time
+         * and returns the result for verification.
+         */
+        template<class F>
+        std::vector<std::uint32_t> measure(const char* what,
+                                           const std::vector<std::uint32_t>& input,
+                                           F f)
+        {
+            auto data = input;
+            stopwatch sw{};
+            f(data);
+            report(what, data.size(), sw.usecs());
+
+            return data;
+        }
+
+        bool sort_pattern(const char* name, pattern p)
+        {
+            std::printf(" %s:\n", name);
+            auto input = make_input(p);
+
+            auto sorted = measure("sort", input, [](auto& v){
+                std::sort(v.begin(), v.end());
+            });
+            auto heap = measure("make_heap + sort_heap", input, [](auto& v){
+                std::make_heap(v.begin(), v.end());
+                std::sort_heap(v.begin(), v.end());
+            });
+            auto stable = measure("stable_sort", input, [](auto& v){
+                std::stable_sort(v.begin(), v.end());
+            });
+            auto partial = measure("partial_sort (top 100)", input, [](auto& v){
+                std::partial_sort(v.begin(), v.begin() + top, v.end());
+            });
+            auto nth = measure("nth_element (median)", input, [](auto& v){
+                std::nth_element(v.begin(), v.begin() + v.size() / 2, v.end());
+            });
+
+            return std::is_sorted(sorted.begin(), sorted.end()) &&
+                   heap == sorted && stable == sorted &&
+                   std::equal(partial.begin(), partial.begin() + top,
+                              sorted.begin()) &&
+                   nth[elements / 2] == sorted[elements / 2];
+        }
+    }
+
+    bool sort()
+    {
+        bool res = sort_pattern("random", pattern::random);
+        res &= sort_pattern("sorted", pattern::sorted);
+        res &= sort_pattern("reversed", pattern::reversed);
+        res &= sort_pattern("few unique", pattern::few_unique);
+
+        return res;
+    }
+}
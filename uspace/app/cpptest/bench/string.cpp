@@ -0,0 +1,119 @@
+/*
+ * Copyright (c) 2019 Jaroslav Jindrak
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * - Redistributions of source code must retain the above copyright
+ *   notice, this list of conditions and the following disclaimer.
+ * - Redistributions in binary form must reproduce the above copyright
+ *   notice, this list of conditions and the following disclaimer in the
+ *   documentation and/or other materials provided with the distribution.
+ * - The name of the author may not be used to endorse or promote products
+ *   derived from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHOR ``AS IS'' AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+ * OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+ * IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT
+ * NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF
+ * THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <cstdint>
+#include <string>
+#include <utility>
+#include <vector>
+#include "../bench.hpp"
+
+namespace bench
+{
+    namespace
+    {
+        constexpr std::uint64_t iterations = 200'000;
+
+        const char* short_text = "identifier";
+        const char* long_text = "a rather long string that cannot be stored inline";
+
+        bool construct(const char* what, const char* text)
+        {
+            std::size_t total{};
+            stopwatch sw{};
+            for (std::uint64_t i = 0; i < iterations; ++i)
+            {
+                std::string str{text};
+                total += str.size();
+            }
+            report(what, iterations, sw.usecs());
+
+            return total == iterations * std::string{text}.size();
+        }
+
+        bool copy(const char* what, const char* text)
+        {
+            std::string orig{text};
+            std::size_t total{};
+            stopwatch sw{};
+            for (std::uint64_t i = 0; i < iterations; ++i)
+            {
+                std::string str{orig};
+                total += str.size();
+            }
+            report(what, iterations, sw.usecs());
+
+            return total == iterations * orig.size();
+        }
+
+        bool concat()
+        {
+            std::string prefix{"key_"};
+            std::string suffix{"_tail"};
+            std::size_t total{};
+            stopwatch sw{};
+            for (std::uint64_t i = 0; i < iterations; ++i)
+            {
+                auto str = prefix + suffix + 'x';
+                total += str.size();
+            }
+            report("concatenate short", iterations, sw.usecs());
+
+            return total == iterations * 10;
+        }
+
+        bool move_around()
+        {
+            std::vector<std::string> strs{};
+            strs.reserve(1000);
+            stopwatch sw{};
+            for (std::uint64_t i = 0; i < iterations; ++i)
+            {
+                std::string str{(i % 2) ? short_text : long_text};
+                strs.push_back(std::move(str));
+                if (strs.size() == 1000)
+                    strs.clear();
+            }
+            report("move into vector", iterations, sw.usecs());
+
+            return true;
+        }
+    }
+
+    bool strings()
+    {
+        bool res = construct("construct short", short_text);
+        res &= construct("construct long", long_text);
+        res &= construct("construct empty", "");
+        res &= copy("copy short", short_text);
+        res &= copy("copy long", long_text);
+        res &= concat();
+        res &= move_around();
+
+        return res;
+    }
+}
@@ -0,0 +1,138 @@
+/*
+ * Copyright (c) 2019 Jaroslav Jindrak
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * - Redistributions of source code must retain the above copyright
+ *   notice, this list of conditions and the following disclaimer.
+ * - Redistributions in binary form must reproduce the above copyright
+ *   notice, this list of conditions and the following disclaimer in the
+ *   documentation and/or other materials provided with the distribution.
+ * - The name of the author may not be used to endorse or promote products
+ *   derived from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHOR ``AS IS'' AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+ * OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+ * IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT
+ * NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF
+ * THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <cstdint>
+#include <valarray>
+#include <vector>
+#include "../bench.hpp"
+
+namespace bench
+{
+    namespace
+    {
+        constexpr std::size_t length = 10'000;
+        constexpr std::uint64_t rounds = 500;
+
+        /**
+         * Computes z = a * x + y + 1 with a plain loop,
+         * which is the baseline for the valarray versions.
+         */
+        bool axpy_loop()
+        {
+            std::vector<double> x(length, 1.0), y(length, 2.0), z(length);
+            double a{3.0};
+
+            stopwatch sw{};
+            for (std::uint64_t r = 0; r < rounds; ++r)
+            {
+                for (std::size_t i = 0; i < length; ++i)
+                    z[i] = a * x[i] + y[i] + 1.0;
+            }
+            report("axpy, hand written loop", rounds * length, sw.usecs());
+
+            return z[length - 1] == 6.0;
+        }
+
+        bool axpy_expression()
+        {
+            std::valarray<double> x(1.0, length), y(2.0, length), z(length);
+            double a{3.0};
+
+            stopwatch sw{};
+            for (std::uint64_t r = 0; r < rounds; ++r)
+                z = a * x + y + 1.0;
+            report("axpy, valarray expression", rounds * length, sw.usecs());
+
+            return z[length - 1] == 6.0;
+        }
+
+        /**
+         * Materializes every intermediate result, which is
+         * what evaluating the operators eagerly amounts to.
+         */
+        bool axpy_temporaries()
+        {
+            std::valarray<double> x(1.0, length), y(2.0, length), z(length);
+            double a{3.0};
+
+            stopwatch sw{};
+            for (std::uint64_t r = 0; r < rounds; ++r)
+            {
+                std::valarray<double> t1 = a * x;
+                std::valarray<double> t2 = t1 + y;
+                z = t2 + 1.0;
+            }
+            report("axpy, valarray temporaries", rounds * length, sw.usecs());
+
+            return z[length - 1] == 6.0;
+        }
+
+        bool stencil_slices()
+        {
+            std::valarray<double> x(1.0, length), z(length);
+            std::slice left{0, length - 2, 1};
+            std::slice mid{1, length - 2, 1};
+            std::slice right{2, length - 2, 1};
+
+            stopwatch sw{};
+            for (std::uint64_t r = 0; r < rounds; ++r)
+            {
+                z[mid] = x[left];
+                z[mid] += x[mid];
+                z[mid] += x[right];
+            }
+            report("3 point stencil, slices", rounds * length, sw.usecs());
+
+            return z[1] == 3.0;
+        }
+
+        bool sum()
+        {
+            std::valarray<double> x(0.5, length);
+            double total{};
+
+            stopwatch sw{};
+            for (std::uint64_t r = 0; r < rounds; ++r)
+                total += (x * x).sum();
+            report("sum of squares", rounds * length, sw.usecs());
+
+            return total == rounds * length * 0.25;
+        }
+    }
+
+    bool valarrays()
+    {
+        bool res = axpy_loop();
+        res &= axpy_expression();
+        res &= axpy_temporaries();
+        res &= stencil_slices();
+        res &= sum();
+
+        return res;
+    }
+}
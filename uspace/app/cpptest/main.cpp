@@ -68,6 +68,7 @@
 #include <numeric>
 #include <ostream>
 #include <ratio>
+#include <regex>
 #include <sstream>
 #include <stack>
 #include <streambuf>
@@ -100,8 +101,13 @@
 
 #include <__bits/trycatch.hpp>
 
-int main()
+#include "bench.hpp"
+
+int main(int argc, char** argv)
 {
+    if (argc > 1 && std::string{argv[1]} == "bench")
+        return bench::main(argc - 1, argv + 1);
+
     std::test::test_set ts{};
     ts.add<std::test::vector_test>();
     ts.add<std::test::string_test>();
@@ -120,6 +126,13 @@ int main()
     ts.add<std::test::ratio_test>();
     ts.add<std::test::functional_test>();
     ts.add<std::test::algorithm_test>();
+    ts.add<std::test::atomic_test>();
+    ts.add<std::test::flat_hash_map_test>();
+    ts.add<std::test::future_test>();
+    ts.add<std::test::memory_resource_test>();
+    ts.add<std::test::valarray_test>();
+    ts.add<std::test::regex_test>();
+    ts.add<std::test::iostream_test>();
 
     return ts.run(true) ? 0 : 1;
 }
@@ -37,6 +37,7 @@
 #include <errno.h>
 #include <inet/addr.h>
 #include <inet/inetcfg.h>
+#include <inttypes.h>
 #include <io/table.h>
 #include <loc.h>
 #include <stdio.h>
@@ -58,6 +59,7 @@ static void print_syntax(void)
 	printf("  %s create-sr <dest-addr>/<width> <router-addr> <route-name>\n", NAME);
 	printf("  %s delete-sr <route-name>\n", NAME);
 	printf("  %s list-link\n", NAME);
+	printf("  %s list-nstats\n", NAME);
 }
 
 static errno_t addr_create_static(int argc, char *argv[])
@@ -395,6 +397,88 @@ out:
 	return rc;
 }
 
+/** Add neighbour cache statistics row to table.
+ *
+ * @param table Table
+ * @param name  Link name
+ * @param proto Protocol name
+ * @param stats Statistics
+ */
+static void nstats_row(table_t *table, const char *name, const char *proto,
+    inet_nstats_t *stats)
+{
+	table_printf(table, "%s\t" "%s\t" "%" PRIu64 "\t" "%" PRIu64 "\t"
+	    "%" PRIu64 "\t" "%" PRIu64 "\t" "%" PRIu64 "\t" "%" PRIu64 "\t"
+	    "%" PRIu64 "\t" "%" PRIu64 "\n", name, proto, stats->entries,
+	    stats->hits, stats->misses, stats->neg_hits, stats->queued,
+	    stats->dropped, stats->solicits, stats->expired);
+}
+
+static errno_t nstats_list(void)
+{
+	sysarg_t *link_list = NULL;
+	inet_link_info_t linfo;
+	inet_nstats_t stats;
+	table_t *table = NULL;
+
+	size_t count;
+	size_t i;
+	errno_t rc;
+
+	rc = inetcfg_get_link_list(&link_list, &count);
+	if (rc != EOK) {
+		printf(NAME ": Failed getting link list.\n");
+		return rc;
+	}
+
+	rc = table_create(&table);
+	if (rc != EOK) {
+		printf("Memory allocation failed.\n");
+		goto out;
+	}
+
+	table_header_row(table);
+	table_printf(table, "Link-Name\t" "Proto\t" "Entries\t" "Hits\t"
+	    "Misses\t" "Neg-Hits\t" "Queued\t" "Dropped\t" "Solicits\t"
+	    "Expired\n");
+
+	for (i = 0; i < count; i++) {
+		rc = inetcfg_link_get(link_list[i], &linfo);
+		if (rc != EOK) {
+			printf("Failed getting properties of link %zu.\n",
+			    (size_t)link_list[i]);
+			continue;
+		}
+
+		/* Links without a neighbour cache return ENOTSUP */
+		rc = inetcfg_link_get_nstats(link_list[i], ip_v4, &stats);
+		if (rc == EOK)
+			nstats_row(table, linfo.name, "ARP", &stats);
+
+		rc = inetcfg_link_get_nstats(link_list[i], ip_v6, &stats);
+		if (rc == EOK)
+			nstats_row(table, linfo.name, "NDP", &stats);
+
+		free(linfo.name);
+		linfo.name = NULL;
+	}
+
+	if (count != 0) {
+		rc = table_print_out(table, stdout);
+		if (rc != EOK) {
+			printf("Error printing table.\n");
+			goto out;
+		}
+	}
+
+	rc = EOK;
+out:
+	table_destroy(table);
+	free(link_list);
+
+	return rc;
+}
+
 static errno_t sroute_list(void)
 {
 	sysarg_t *sroute_list = NULL;
@@ -526,6 +610,10 @@ int main(int argc, char *argv[])
 		rc = link_list();
 		if (rc != EOK)
 			return 1;
+	} else if (str_cmp(argv[1], "list-nstats") == 0) {
+		rc = nstats_list();
+		if (rc != EOK)
+			return 1;
 	} else {
 		printf(NAME ": Unknown command '%s'.\n", argv[1]);
 		print_syntax();
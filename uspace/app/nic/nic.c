@@ -53,6 +53,7 @@ typedef struct {
 	nic_unicast_mode_t unicast_mode;
 	nic_multicast_mode_t multicast_mode;
 	nic_broadcast_mode_t broadcast_mode;
+	nic_device_stats_t stats;
 	int speed;
 } nic_info_t;
 
@@ -174,6 +175,13 @@ static errno_t nic_get_info(service_id_t svc_id, char *svc_name,
 		goto error;
 	}
 
+	rc = nic_get_stats(sess, &info->stats);
+	if (rc != EOK) {
+		printf("Error getting NIC statistics.\n");
+		rc = EIO;
+		goto error;
+	}
+
 	return EOK;
 error:
 	return rc;
@@ -335,6 +343,21 @@ static errno_t nic_list(void)
 			    nic_duplex_mode_str(nic_info.duplex));
 		}
 
+		printf("\tReceived frames: %lu (%lu dropped)\n",
+		    nic_info.stats.receive_packets,
+		    nic_info.stats.receive_dropped);
+		printf("\tSent frames: %lu\n", nic_info.stats.send_packets);
+
+		if (nic_info.stats.receive_batches > 0) {
+			printf("\tReceive batches: %lu (avg. %lu frames, "
+			    "avg. queue delay %lu us)\n",
+			    nic_info.stats.receive_batches,
+			    nic_info.stats.receive_packets /
+			    nic_info.stats.receive_batches,
+			    nic_info.stats.receive_queue_usec /
+			    nic_info.stats.receive_packets);
+		}
+
 		free(svc_name);
 		free(addr_str);
 	}
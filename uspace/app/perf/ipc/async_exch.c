@@ -0,0 +1,161 @@
+/*
+ * Copyright (c) 2019 Jiri Svoboda
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * - Redistributions of source code must retain the above copyright
+ *   notice, this list of conditions and the following disclaimer.
+ * - Redistributions in binary form must reproduce the above copyright
+ *   notice, this list of conditions and the following disclaimer in the
+ *   documentation and/or other materials provided with the distribution.
+ * - The name of the author may not be used to endorse or promote products
+ *   derived from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHOR ``AS IS'' AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+ * OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+ * IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT
+ * NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF
+ * THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <fibril.h>
+#include <fibril_synch.h>
+#include <stdatomic.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+#include <ns.h>
+#include <async.h>
+#include <errno.h>
+#include "../perf.h"
+
+/** Total number of round trips per measurement */
+#define NUM_ITER  100000
+
+/** Number of runner threads in the multi-threaded phase */
+#define NUM_THREADS  4
+
+/** Maximum number of concurrent fibrils */
+#define MAX_FIBRILS  64
+
+typedef struct {
+	/** Round trips to perform */
+	uint64_t niter;
+	/** Signalled by each fibril when finished */
+	fibril_semaphore_t done;
+	/** Number of failed round trips */
+	atomic_uint failures;
+} async_exch_work_t;
+
+static errno_t async_exch_fibril(void *arg)
+{
+	async_exch_work_t *work = (async_exch_work_t *) arg;
+	uint64_t count;
+
+	for (count = 0; count < work->niter; count++) {
+		if (ns_ping() != EOK)
+			atomic_fetch_add(&work->failures, 1);
+	}
+
+	fibril_semaphore_up(&work->done);
+	return EOK;
+}
+
+static errno_t async_exch_measure(int nfibrils, uint64_t *rduration)
+{
+	async_exch_work_t work;
+	struct timespec start;
+	int started;
+	int i;
+
+	work.niter = NUM_ITER / nfibrils;
+	fibril_semaphore_initialize(&work.done, 0);
+	atomic_init(&work.failures, 0);
+
+	getuptime(&start);
+
+	started = 0;
+	for (i = 0; i < nfibrils; i++) {
+		fid_t fid = fibril_create(async_exch_fibril, &work);
+		if (!fid)
+			break;
+
+		fibril_add_ready(fid);
+		started++;
+	}
+
+	for (i = 0; i < started; i++)
+		fibril_semaphore_down(&work.done);
+
+	struct timespec now;
+	getuptime(&now);
+
+	if (started != nfibrils) {
+		printf("Error creating fibrils.\n");
+		return ENOMEM;
+	}
+
+	if (atomic_load(&work.failures) > 0) {
+		printf("Error sending ping message.\n");
+		return EIO;
+	}
+
+	*rduration = ts_sub_diff(&now, &start) / 1000;
+	return EOK;
+}
+
+static errno_t async_exch_run(int nthreads)
+{
+	uint64_t duration;
+	errno_t rc;
+	int nfibrils;
+
+	for (nfibrils = 1; nfibrils <= MAX_FIBRILS; nfibrils *= 2) {
+		rc = async_exch_measure(nfibrils, &duration);
+		if (rc != EOK)
+			return rc;
+
+		uint64_t niter = (NUM_ITER / nfibrils) * nfibrils;
+
+		printf("%d thread(s), %2d fibril(s): %" PRIu64 " round trips "
+		    "in %" PRIu64 " us", nthreads, nfibrils, niter, duration);
+
+		if (duration > 0) {
+			printf(", %" PRIu64 " rt/s.\n",
+			    niter * 1000 * 1000 / duration);
+		} else {
+			printf(".\n");
+		}
+	}
+
+	return EOK;
+}
+
+const char *bench_async_exch(void)
+{
+	errno_t rc;
+
+	printf("Concurrent exchanges in a single thread...\n");
+
+	rc = async_exch_run(1);
+	if (rc != EOK)
+		return "Failed.";
+
+	printf("Concurrent exchanges in multiple threads...\n");
+
+	int nthreads = 1 + fibril_test_spawn_runners(NUM_THREADS - 1);
+
+	rc = async_exch_run(nthreads);
+	if (rc != EOK)
+		return "Failed.";
+
+	return NULL;
+}
@@ -0,0 +1,192 @@
+/*
+ * Copyright (c) 2019 Jiri Svoboda
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * - Redistributions of source code must retain the above copyright
+ *   notice, this list of conditions and the following disclaimer.
+ * - Redistributions in binary form must reproduce the above copyright
+ *   notice, this list of conditions and the following disclaimer in the
+ *   documentation and/or other materials provided with the distribution.
+ * - The name of the author may not be used to endorse or promote products
+ *   derived from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHOR ``AS IS'' AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+ * OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+ * IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT
+ * NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF
+ * THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/** @addtogroup perf
+ * @{
+ */
+/**
+ * @file Association map demultiplexing benchmark
+ */
+
+#include <errno.h>
+#include <inet/addr.h>
+#include <inet/endpoint.h>
+#include <nettl/amap.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+#include "../perf.h"
+
+/** Number of established associations in the map */
+#define NUM_ASSOC  10000
+
+/** Number of lookups per measurement */
+#define NUM_ITER  1000000
+
+/** Local port shared by all associations (as with a busy server) */
+#define LOCAL_PORT  80
+
+/** Set up endpoint pair for the @a i-th simulated connection.
+ *
+ * @param i    Connection index
+ * @param epp  Place to store endpoint pair
+ */
+static void amap_demux_epp(unsigned i, inet_ep2_t *epp)
+{
+	inet_ep2_init(epp);
+	inet_addr(&epp->local.addr, 10, 0, 0, 1);
+	epp->local.port = LOCAL_PORT;
+	inet_addr(&epp->remote.addr, 192, 168, (i >> 8) & 0xff, i & 0xff);
+	epp->remote.port = 1024 + i / 256;
+}
+
+/** Measure lookups in the association map.
+ *
+ * @param map        Association map
+ * @param listener   Argument of the listening association
+ * @param miss       @c true to look up endpoint pairs with no established
+ *                   association (falling back to the listener)
+ * @param rduration  Place to store duration in microseconds
+ * @return EOK on success or an error code
+ */
+static errno_t amap_demux_measure(amap_t *map, void *listener, bool miss,
+    uint64_t *rduration)
+{
+	struct timespec start;
+	struct timespec now;
+	inet_ep2_t epp;
+	void *arg;
+	unsigned i;
+	errno_t rc;
+
+	getuptime(&start);
+
+	for (i = 0; i < NUM_ITER; i++) {
+		amap_demux_epp(i % NUM_ASSOC, &epp);
+		if (miss)
+			epp.remote.port = 1;
+
+		rc = amap_find_match(map, &epp, &arg);
+		if (rc != EOK)
+			return rc;
+
+		if (miss && arg != listener)
+			return EIO;
+		if (!miss && arg == listener)
+			return EIO;
+	}
+
+	getuptime(&now);
+
+	*rduration = ts_sub_diff(&now, &start) / 1000;
+	return EOK;
+}
+
+/** Print lookup rate.
+ *
+ * @param what      Description of the measurement
+ * @param duration  Duration in microseconds
+ */
+static void amap_demux_report(const char *what, uint64_t duration)
+{
+	printf("%s: %u lookups in %" PRIu64 " us", what, NUM_ITER, duration);
+
+	if (duration > 0) {
+		printf(", %" PRIu64 " lookups/s.\n",
+		    (uint64_t) NUM_ITER * 1000 * 1000 / duration);
+	} else {
+		printf(".\n");
+	}
+}
+
+const char *bench_amap_demux(void)
+{
+	amap_t *map;
+	inet_ep2_t epp;
+	inet_ep2_t aepp;
+	uint64_t duration;
+	unsigned i;
+	int listener;
+	errno_t rc;
+
+	rc = amap_create(&map);
+	if (rc != EOK)
+		return "Out of memory.";
+
+	/* Listening association on the local address */
+	inet_ep2_init(&epp);
+	inet_addr(&epp.local.addr, 10, 0, 0, 1);
+	epp.local.port = LOCAL_PORT;
+
+	rc = amap_insert(map, &epp, &listener, af_allow_system, &aepp);
+	if (rc != EOK)
+		goto error;
+
+	printf("Inserting %u associations...\n", NUM_ASSOC);
+
+	for (i = 0; i < NUM_ASSOC; i++) {
+		amap_demux_epp(i, &epp);
+		rc = amap_insert(map, &epp, (void *) (uintptr_t) (i + 1),
+		    af_allow_system, &aepp);
+		if (rc != EOK)
+			goto error;
+	}
+
+	rc = amap_demux_measure(map, &listener, false, &duration);
+	if (rc != EOK)
+		goto error;
+
+	amap_demux_report("Established", duration);
+
+	rc = amap_demux_measure(map, &listener, true, &duration);
+	if (rc != EOK)
+		goto error;
+
+	amap_demux_report("Listener fallback", duration);
+
+	for (i = 0; i < NUM_ASSOC; i++) {
+		amap_demux_epp(i, &epp);
+		amap_remove(map, &epp);
+	}
+
+	inet_ep2_init(&epp);
+	inet_addr(&epp.local.addr, 10, 0, 0, 1);
+	epp.local.port = LOCAL_PORT;
+	amap_remove(map, &epp);
+
+	amap_destroy(map);
+	return NULL;
+error:
+	amap_destroy(map);
+	return "Failed.";
+}
+
+/** @}
+ */
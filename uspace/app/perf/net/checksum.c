@@ -0,0 +1,159 @@
+/*
+ * Copyright (c) 2019 Jiri Svoboda
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * - Redistributions of source code must retain the above copyright
+ *   notice, this list of conditions and the following disclaimer.
+ * - Redistributions in binary form must reproduce the above copyright
+ *   notice, this list of conditions and the following disclaimer in the
+ *   documentation and/or other materials provided with the distribution.
+ * - The name of the author may not be used to endorse or promote products
+ *   derived from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHOR ``AS IS'' AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+ * OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+ * IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT
+ * NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF
+ * THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+
+/** @addtogroup perf
+ * @{
+ */
+/**
+ * @file Checksum throughput benchmark
+ *
+ * Measures the throughput of the Internet checksum, CRC32 and CRC32C
+ * routines in libc for packet-sized and large buffers.
+ */
+
+#include <adt/checksum.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+#include "../perf.h"
+
+/** Size of the test buffer */
+#define BUF_SIZE  65536
+
+/** Number of bytes processed per measurement */
+#define TOTAL_BYTES  (64 * 1024 * 1024)
+
+/** Checksum function under test */
+typedef uint32_t (*checksum_fn_t)(uint8_t *, size_t);
+
+static uint32_t checksum_ocsum(uint8_t *data, size_t size)
+{
+	return compute_ocsum(data, size, 0);
+}
+
+/** Ones' complement sum one 16-bit word at a time (for comparison) */
+static uint32_t checksum_ocsum_word(uint8_t *data, size_t size)
+{
+	uint32_t sum = 0;
+	size_t i;
+
+	for (i = 0; i + 1 < size; i += 2) {
+		sum += ((uint32_t) data[i] << 8) | data[i + 1];
+		sum = (sum & 0xffff) + (sum >> 16);
+	}
+
+	if (i < size) {
+		sum += (uint32_t) data[i] << 8;
+		sum = (sum & 0xffff) + (sum >> 16);
+	}
+
+	return sum;
+}
+
+static uint32_t checksum_crc32(uint8_t *data, size_t size)
+{
+	return compute_crc32(data, size);
+}
+
+static uint32_t checksum_crc32c(uint8_t *data, size_t size)
+{
+	return compute_crc32c(data, size);
+}
+
+/** Measure and print checksum throughput.
+ *
+ * @param what   Description of the measurement
+ * @param fn     Checksum function
+ * @param buf    Buffer to checksum
+ * @param chunk  Number of bytes to checksum per call
+ */
+static void checksum_measure(const char *what, checksum_fn_t fn,
+    uint8_t *buf, size_t chunk)
+{
+	struct timespec start;
+	struct timespec now;
+	volatile uint32_t res;
+	uint64_t duration;
+	size_t done;
+	size_t offs;
+
+	offs = 0;
+	getuptime(&start);
+
+	for (done = 0; done < TOTAL_BYTES; done += chunk) {
+		res = fn(buf + offs, chunk);
+		offs += chunk;
+		if (offs + chunk > BUF_SIZE)
+			offs = 0;
+	}
+
+	getuptime(&now);
+	(void) res;
+
+	duration = ts_sub_diff(&now, &start) / 1000;
+
+	printf("%s, %zu-byte blocks: %u bytes in %" PRIu64 " us", what,
+	    chunk, TOTAL_BYTES, duration);
+
+	if (duration > 0) {
+		printf(", %" PRIu64 " MB/s.\n",
+		    (uint64_t) TOTAL_BYTES / duration);
+	} else {
+		printf(".\n");
+	}
+}
+
+const char *bench_checksum(void)
+{
+	uint8_t *buf;
+	size_t i;
+
+	buf = malloc(BUF_SIZE);
+	if (buf == NULL)
+		return "Out of memory.";
+
+	for (i = 0; i < BUF_SIZE; i++)
+		buf[i] = (uint8_t) (i * 7 + (i >> 8));
+
+	checksum_measure("Internet checksum (word loop)", checksum_ocsum_word,
+	    buf, 1500);
+	checksum_measure("Internet checksum", checksum_ocsum, buf, 1500);
+	checksum_measure("Internet checksum", checksum_ocsum, buf, BUF_SIZE);
+	checksum_measure("CRC32", checksum_crc32, buf, 1500);
+	checksum_measure("CRC32", checksum_crc32, buf, BUF_SIZE);
+	checksum_measure("CRC32C", checksum_crc32c, buf, 1500);
+	checksum_measure("CRC32C", checksum_crc32c, buf, BUF_SIZE);
+
+	free(buf);
+	return NULL;
+}
+
+/** @}
+ */
@@ -0,0 +1,254 @@
+/*
+ * Copyright (c) 2019 Jiri Svoboda
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * - Redistributions of source code must retain the above copyright
+ *   notice, this list of conditions and the following disclaimer.
+ * - Redistributions in binary form must reproduce the above copyright
+ *   notice, this list of conditions and the following disclaimer in the
+ *   documentation and/or other materials provided with the distribution.
+ * - The name of the author may not be used to endorse or promote products
+ *   derived from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHOR ``AS IS'' AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+ * OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+ * IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT
+ * NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF
+ * THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/** @addtogroup perf
+ * @{
+ */
+/**
+ * @file UDP loopback packet rate benchmark
+ *
+ * Measures how many datagrams per second make it through the whole
+ * network stack (UDP, inetsrv and the loopback IP link) and back,
+ * sending them either one by one or in batches.
+ */
+
+#include <errno.h>
+#include <fibril_synch.h>
+#include <inet/addr.h>
+#include <inet/endpoint.h>
+#include <inet/udp.h>
+#include <macros.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <time.h>
+#include "../perf.h"
+
+/** Number of datagrams per measurement */
+#define NUM_PKTS  20000
+
+/** Maximum number of datagrams in flight */
+#define WINDOW  32
+
+/** Number of datagrams per batch when sending in batches */
+#define BATCH  16
+
+/** Datagram payload size */
+#define PKT_SIZE  64
+
+/** UDP port of the receiving association */
+#define RECV_PORT  17001
+
+/** Timeout waiting for a datagram in microseconds */
+#define RECV_TIMEOUT  1000000
+
+/** Receiver state */
+typedef struct {
+	fibril_mutex_t lock;
+	fibril_condvar_t cv;
+	/** Number of datagrams received */
+	unsigned received;
+} udp_pps_rcv_t;
+
+static void udp_pps_recv_msg(udp_assoc_t *, udp_rmsg_t *);
+
+static udp_cb_t udp_pps_cb = {
+	.recv_msg = udp_pps_recv_msg
+};
+
+/** Datagram received callback.
+ *
+ * @param assoc Receiving association
+ * @param rmsg  Received message
+ */
+static void udp_pps_recv_msg(udp_assoc_t *assoc, udp_rmsg_t *rmsg)
+{
+	udp_pps_rcv_t *rcv = (udp_pps_rcv_t *) udp_assoc_userptr(assoc);
+	uint8_t buf[PKT_SIZE];
+
+	(void) udp_rmsg_read(rmsg, 0, buf, sizeof(buf));
+
+	fibril_mutex_lock(&rcv->lock);
+	rcv->received++;
+	fibril_condvar_broadcast(&rcv->cv);
+	fibril_mutex_unlock(&rcv->lock);
+}
+
+/** Wait until at most @a inflight datagrams are outstanding.
+ *
+ * Datagrams that do not arrive in time are counted as lost.
+ *
+ * @param rcv      Receiver state
+ * @param sent     Number of datagrams sent so far
+ * @param inflight Number of datagrams allowed in flight
+ * @param lost     Number of datagrams lost so far, updated
+ */
+static void udp_pps_wait(udp_pps_rcv_t *rcv, unsigned sent,
+    unsigned inflight, unsigned *lost)
+{
+	errno_t rc;
+
+	fibril_mutex_lock(&rcv->lock);
+	while (rcv->received + *lost + inflight < sent) {
+		rc = fibril_condvar_wait_timeout(&rcv->cv, &rcv->lock,
+		    RECV_TIMEOUT);
+		if (rc == ETIMEOUT)
+			*lost = sent - inflight - rcv->received;
+	}
+	fibril_mutex_unlock(&rcv->lock);
+}
+
+/** Run UDP packet rate measurement.
+ *
+ * @param batch @c true to send datagrams in batches
+ * @return NULL on success, error message otherwise
+ */
+static const char *udp_pps_run(bool batch)
+{
+	udp_t *udp = NULL;
+	udp_assoc_t *rassoc = NULL;
+	udp_assoc_t *sassoc = NULL;
+	udp_pps_rcv_t rcv;
+	inet_ep2_t epp;
+	inet_ep_t dest;
+	uint8_t pkt[PKT_SIZE];
+	udp_smsg_t smsgs[BATCH];
+	size_t nsent;
+	size_t n;
+	struct timespec start;
+	struct timespec now;
+	uint64_t duration;
+	unsigned sent;
+	unsigned lost;
+	const char *err = NULL;
+	errno_t rc;
+
+	fibril_mutex_initialize(&rcv.lock);
+	fibril_condvar_initialize(&rcv.cv);
+	rcv.received = 0;
+
+	rc = udp_create(&udp);
+	if (rc != EOK)
+		return "Failed connecting to UDP service.";
+
+	inet_ep2_init(&epp);
+	inet_addr(&epp.local.addr, 127, 0, 0, 1);
+	epp.local.port = RECV_PORT;
+
+	rc = udp_assoc_create(udp, &epp, &udp_pps_cb, &rcv, &rassoc);
+	if (rc != EOK) {
+		err = "Failed creating receiving association.";
+		goto out;
+	}
+
+	inet_ep2_init(&epp);
+	inet_addr(&epp.local.addr, 127, 0, 0, 1);
+
+	rc = udp_assoc_create(udp, &epp, &udp_pps_cb, &rcv, &sassoc);
+	if (rc != EOK) {
+		err = "Failed creating sending association.";
+		goto out;
+	}
+
+	inet_ep_init(&dest);
+	inet_addr(&dest.addr, 127, 0, 0, 1);
+	dest.port = RECV_PORT;
+
+	for (unsigned i = 0; i < PKT_SIZE; i++)
+		pkt[i] = i;
+
+	for (unsigned i = 0; i < BATCH; i++) {
+		smsgs[i].dest = &dest;
+		smsgs[i].data = pkt;
+		smsgs[i].size = sizeof(pkt);
+	}
+
+	printf("Sending %u datagrams of %u bytes over loopback%s...\n",
+	    NUM_PKTS, PKT_SIZE, batch ? " in batches" : "");
+
+	lost = 0;
+	getuptime(&start);
+
+	sent = 0;
+	while (sent < NUM_PKTS) {
+		if (batch) {
+			n = min(BATCH, NUM_PKTS - sent);
+			udp_pps_wait(&rcv, sent, WINDOW - n, &lost);
+
+			rc = udp_assoc_send_msgs(sassoc, smsgs, n, &nsent);
+			sent += nsent;
+		} else {
+			udp_pps_wait(&rcv, sent, WINDOW - 1, &lost);
+
+			rc = udp_assoc_send_msg(sassoc, &dest, pkt, sizeof(pkt));
+			if (rc == EOK)
+				++sent;
+		}
+
+		if (rc != EOK) {
+			err = "Failed sending datagram.";
+			goto out;
+		}
+	}
+
+	udp_pps_wait(&rcv, sent, 0, &lost);
+	getuptime(&now);
+
+	duration = ts_sub_diff(&now, &start) / 1000;
+
+	printf("Received %u datagrams (%u lost) in %" PRIu64 " us",
+	    rcv.received, lost, duration);
+
+	if (duration > 0) {
+		printf(", %" PRIu64 " packets/s.\n",
+		    (uint64_t) rcv.received * 1000 * 1000 / duration);
+	} else {
+		printf(".\n");
+	}
+
+out:
+	if (sassoc != NULL)
+		udp_assoc_destroy(sassoc);
+	if (rassoc != NULL)
+		udp_assoc_destroy(rassoc);
+	udp_destroy(udp);
+	return err;
+}
+
+const char *bench_udp_pps(void)
+{
+	return udp_pps_run(false);
+}
+
+const char *bench_udp_pps_batch(void)
+{
+	return udp_pps_run(true);
+}
+
+/** @}
+ */
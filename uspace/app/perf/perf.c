@@ -40,10 +40,14 @@
 #include "perf.h"
 
 benchmark_t benchmarks[] = {
+#include "ipc/async_exch.def"
 #include "ipc/ns_ping.def"
 #include "ipc/ping_pong.def"
 #include "malloc/malloc1.def"
 #include "malloc/malloc2.def"
+#include "net/amap_demux.def"
+#include "net/checksum.def"
+#include "net/udp_pps.def"
 	{ NULL, NULL, NULL }
 };
 
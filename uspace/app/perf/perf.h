@@ -45,10 +45,15 @@ typedef struct {
 	benchmark_entry_t entry;
 } benchmark_t;
 
+extern const char *bench_amap_demux(void);
+extern const char *bench_async_exch(void);
+extern const char *bench_checksum(void);
 extern const char *bench_malloc1(void);
 extern const char *bench_malloc2(void);
 extern const char *bench_ns_ping(void);
 extern const char *bench_ping_pong(void);
+extern const char *bench_udp_pps(void);
+extern const char *bench_udp_pps_batch(void);
 
 extern benchmark_t benchmarks[];
 
@@ -44,6 +44,7 @@
 #include <stdbool.h>
 #include <str.h>
 #include <arg_parse.h>
+#include <vfs/vfs.h>
 
 #define NAME  "stats"
 
@@ -196,10 +197,35 @@ static void print_uptime(void)
 	    (uptime.tv_sec % HOUR) / MINUTE, uptime.tv_sec % MINUTE);
 }
 
+static void print_vfs(void)
+{
+	vfs_stats_t stats;
+	errno_t rc;
+
+	rc = vfs_stats(&stats);
+	if (rc != EOK) {
+		fprintf(stderr, "%s: Unable to get VFS statistics\n", NAME);
+		return;
+	}
+
+	printf("%s: VFS path lookups: %" PRIu64 " total, %" PRIu64
+	    " in progress, %" PRIu64 " at most\n", NAME, stats.lookups,
+	    stats.lookups_active, stats.lookups_active_max);
+	printf("%s: VFS lookups waiting for PLB: %" PRIu64 " (%" PRIu64
+	    " us total)\n", NAME, stats.lookup_waits, stats.lookup_wait_usec);
+	printf("%s: VFS name cache: %" PRIu64 " entries, %" PRIu64
+	    " hits (%" PRIu64 " negative), %" PRIu64 " misses\n", NAME,
+	    stats.dcache_entries, stats.dcache_hits, stats.dcache_neg_hits,
+	    stats.dcache_misses);
+	printf("%s: VFS attribute cache: %" PRIu64 " entries, %" PRIu64
+	    " hits, %" PRIu64 " misses\n", NAME, stats.acache_entries,
+	    stats.acache_hits, stats.acache_misses);
+}
+
 static void usage(const char *name)
 {
 	printf(
-	    "Usage: %s [-t task_id] [-a] [-c] [-l] [-u]\n"
+	    "Usage: %s [-t task_id] [-a] [-c] [-l] [-u] [-v]\n"
 	    "\n"
 	    "Options:\n"
 	    "\t-t task_id\n"
@@ -222,6 +248,10 @@ static void usage(const char *name)
 	    "\t--uptime\n"
 	    "\t\tPrint system uptime\n"
 	    "\n"
+	    "\t-v\n"
+	    "\t--vfs\n"
+	    "\t\tPrint VFS statistics\n"
+	    "\n"
 	    "\t-h\n"
 	    "\t--help\n"
 	    "\t\tPrint this usage information\n"
@@ -238,6 +268,7 @@ int main(int argc, char *argv[])
 	bool toggle_cpus = false;
 	bool toggle_load = false;
 	bool toggle_uptime = false;
+	bool toggle_vfs = false;
 
 	task_id_t task_id = 0;
 
@@ -296,6 +327,13 @@ int main(int argc, char *argv[])
 			toggle_uptime = true;
 			continue;
 		}
+
+		/* VFS */
+		if ((off = arg_parse_short_long(argv[i], "-v", "--vfs")) != -1) {
+			toggle_tasks = false;
+			toggle_vfs = true;
+			continue;
+		}
 	}
 
 	if (toggle_tasks)
@@ -313,6 +351,9 @@ int main(int argc, char *argv[])
 	if (toggle_uptime)
 		print_uptime();
 
+	if (toggle_vfs)
+		print_vfs();
+
 	return 0;
 }
 
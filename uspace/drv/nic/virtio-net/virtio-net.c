@@ -197,7 +197,7 @@ static errno_t virtio_net_initialize(ddf_dev_t *dev)
 
 	/* Reset the device and negotiate the feature bits */
 	rc = virtio_device_setup_start(vdev,
-	    VIRTIO_NET_F_MAC | VIRTIO_NET_F_CTRL_VQ);
+	    VIRTIO_NET_F_MAC | VIRTIO_NET_F_CTRL_VQ, VIRTIO_NET_F_CSUM);
 	if (rc != EOK)
 		goto fail;
 
@@ -323,12 +323,22 @@ static void virtio_net_uninitialize(ddf_dev_t *dev)
 	virtio_pci_dev_cleanup(&virtio_net->virtio_dev);
 }
 
-static void virtio_net_send(nic_t *nic, void *data, size_t size)
+/** Put frame into the TX virtqueue.
+ *
+ * @param nic        NIC
+ * @param data       Frame data
+ * @param size       Frame size in bytes
+ * @param flags      virtio-net header flags
+ * @param csum_start Offset where checksumming starts
+ * @param csum_offs  Offset of checksum field relative to @a csum_start
+ */
+static void virtio_net_send_hdr(nic_t *nic, void *data, size_t size,
+    uint8_t flags, size_t csum_start, size_t csum_offs)
 {
 	virtio_net_t *virtio_net = nic_get_specific(nic);
 	virtio_dev_t *vdev = &virtio_net->virtio_dev;
 
-	if (size > sizeof(virtio_net) + TX_BUF_SIZE) {
+	if (size > TX_BUF_SIZE - sizeof(virtio_net_hdr_t)) {
 		ddf_msg(LVL_WARN, "TX data too big, frame dropped");
 		return;
 	}
@@ -344,7 +354,10 @@ static void virtio_net_send(nic_t *nic, void *data, size_t size)
 	/* Setup the packed header */
 	virtio_net_hdr_t *hdr = (virtio_net_hdr_t *) virtio_net->tx_buf[descno];
 	memset(hdr, 0, sizeof(virtio_net_hdr_t));
+	hdr->flags = flags;
 	hdr->gso_type = VIRTIO_NET_HDR_GSO_NONE;
+	hdr->csum_start = csum_start;
+	hdr->csum_offset = csum_offs;
 
 	/* Copy packet data into the buffer just past the header */
 	memcpy(&hdr[1], data, size);
@@ -357,6 +370,19 @@ static void virtio_net_send(nic_t *nic, void *data, size_t size)
 	virtio_virtq_produce_available(vdev, TX_QUEUE_1, descno);
 }
 
+static void virtio_net_send(nic_t *nic, void *data, size_t size)
+{
+	virtio_net_send_hdr(nic, data, size, 0, 0, 0);
+}
+
+/** Send frame, letting the device complete its transport checksum. */
+static void virtio_net_send_csum(nic_t *nic, void *data, size_t size,
+    size_t csum_start, size_t csum_offs)
+{
+	virtio_net_send_hdr(nic, data, size, VIRTIO_NET_HDR_F_NEEDS_CSUM,
+	    csum_start, csum_offs);
+}
+
 static errno_t virtio_net_on_multicast_mode_change(nic_t *nic,
     nic_multicast_mode_t new_mode, const nic_address_t *address_list,
     size_t address_count)
@@ -409,6 +435,12 @@ static errno_t virtio_net_dev_add(ddf_dev_t *dev)
 	ddf_fun_set_ops(fun, &virtio_net_dev_ops);
 
 	nic_set_send_frame_handler(nic, virtio_net_send);
+
+	virtio_net_t *virtio_net = nic_get_specific(nic);
+	if ((virtio_net->virtio_dev.features & VIRTIO_NET_F_CSUM) != 0) {
+		nic_set_send_frame_csum_handler(nic, virtio_net_send_csum);
+		nic_report_offload(nic, NIC_OFFLOAD_TX_CSUM);
+	}
 	nic_set_filtering_change_handlers(nic, NULL,
 	    virtio_net_on_multicast_mode_change,
 	    virtio_net_on_broadcast_mode_change, NULL, NULL);
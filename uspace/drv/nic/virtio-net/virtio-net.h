@@ -46,6 +46,9 @@
 /** Control channel is available */
 #define VIRTIO_NET_F_CTRL_VQ		(1U << 17)
 
+/** Driver needs device to complete the checksum (csum_start, csum_offset) */
+#define VIRTIO_NET_HDR_F_NEEDS_CSUM	1
+
 #define VIRTIO_NET_HDR_GSO_NONE 0
 typedef struct {
 	uint8_t flags;
@@ -27,6 +27,28 @@
  */
 
 #include <adt/checksum.h>
+#include <byteorder.h>
+#include <macros.h>
+
+/** CRC32C divisor polynomial (reflected) */
+#define CRC32C_POLY  0x82f63b78
+
+/** CRC32 divisor polynomial (reflected) */
+#define CRC32_POLY  0xedb88320
+
+/** Bytes summed per iteration of the vector ones' complement loop */
+#define OCSUM_BLOCK  32
+
+/** Iterations after which the 32-bit vector lanes must be flushed.
+ *
+ * Each iteration adds at most 4 * 0xffff to a lane, so 8192 iterations
+ * stay well below 2^32.
+ */
+#define OCSUM_MAX_BLOCKS  8192
+
+/** Four 32-bit lanes (SSE2 register on amd64, scalar code elsewhere) */
+typedef uint32_t ocsum_vec_t __attribute__((vector_size(16)));
+
 
 /**
  * 256-value table of precomputed polynomials for CRC32. Note
@@ -102,6 +124,593 @@ uint32_t poly_table[256] = {
 	0xb40bbe37, 0xc30c8ea1, 0x5a05df1b, 0x2d02ef8d
 };
 
+/**
+ * Tables for processing CRC32 four bytes at a time (slicing-by-4).
+ * Table @c k gives the CRC contribution of a byte followed by @c k+1
+ * zero bytes; the single-byte table is @c poly_table.
+ */
+static const uint32_t crc32_slice_table[3][256] = {
+	{
+		0x00000000, 0x191b3141, 0x32366282, 0x2b2d53c3,
+		0x646cc504, 0x7d77f445, 0x565aa786, 0x4f4196c7,
+		0xc8d98a08, 0xd1c2bb49, 0xfaefe88a, 0xe3f4d9cb,
+		0xacb54f0c, 0xb5ae7e4d, 0x9e832d8e, 0x87981ccf,
+		0x4ac21251, 0x53d92310, 0x78f470d3, 0x61ef4192,
+		0x2eaed755, 0x37b5e614, 0x1c98b5d7, 0x05838496,
+		0x821b9859, 0x9b00a918, 0xb02dfadb, 0xa936cb9a,
+		0xe6775d5d, 0xff6c6c1c, 0xd4413fdf, 0xcd5a0e9e,
+		0x958424a2, 0x8c9f15e3, 0xa7b24620, 0xbea97761,
+		0xf1e8e1a6, 0xe8f3d0e7, 0xc3de8324, 0xdac5b265,
+		0x5d5daeaa, 0x44469feb, 0x6f6bcc28, 0x7670fd69,
+		0x39316bae, 0x202a5aef, 0x0b07092c, 0x121c386d,
+		0xdf4636f3, 0xc65d07b2, 0xed705471, 0xf46b6530,
+		0xbb2af3f7, 0xa231c2b6, 0x891c9175, 0x9007a034,
+		0x179fbcfb, 0x0e848dba, 0x25a9de79, 0x3cb2ef38,
+		0x73f379ff, 0x6ae848be, 0x41c51b7d, 0x58de2a3c,
+		0xf0794f05, 0xe9627e44, 0xc24f2d87, 0xdb541cc6,
+		0x94158a01, 0x8d0ebb40, 0xa623e883, 0xbf38d9c2,
+		0x38a0c50d, 0x21bbf44c, 0x0a96a78f, 0x138d96ce,
+		0x5ccc0009, 0x45d73148, 0x6efa628b, 0x77e153ca,
+		0xbabb5d54, 0xa3a06c15, 0x888d3fd6, 0x91960e97,
+		0xded79850, 0xc7cca911, 0xece1fad2, 0xf5facb93,
+		0x7262d75c, 0x6b79e61d, 0x4054b5de, 0x594f849f,
+		0x160e1258, 0x0f152319, 0x243870da, 0x3d23419b,
+		0x65fd6ba7, 0x7ce65ae6, 0x57cb0925, 0x4ed03864,
+		0x0191aea3, 0x188a9fe2, 0x33a7cc21, 0x2abcfd60,
+		0xad24e1af, 0xb43fd0ee, 0x9f12832d, 0x8609b26c,
+		0xc94824ab, 0xd05315ea, 0xfb7e4629, 0xe2657768,
+		0x2f3f79f6, 0x362448b7, 0x1d091b74, 0x04122a35,
+		0x4b53bcf2, 0x52488db3, 0x7965de70, 0x607eef31,
+		0xe7e6f3fe, 0xfefdc2bf, 0xd5d0917c, 0xcccba03d,
+		0x838a36fa, 0x9a9107bb, 0xb1bc5478, 0xa8a76539,
+		0x3b83984b, 0x2298a90a, 0x09b5fac9, 0x10aecb88,
+		0x5fef5d4f, 0x46f46c0e, 0x6dd93fcd, 0x74c20e8c,
+		0xf35a1243, 0xea412302, 0xc16c70c1, 0xd8774180,
+		0x9736d747, 0x8e2de606, 0xa500b5c5, 0xbc1b8484,
+		0x71418a1a, 0x685abb5b, 0x4377e898, 0x5a6cd9d9,
+		0x152d4f1e, 0x0c367e5f, 0x271b2d9c, 0x3e001cdd,
+		0xb9980012, 0xa0833153, 0x8bae6290, 0x92b553d1,
+		0xddf4c516, 0xc4eff457, 0xefc2a794, 0xf6d996d5,
+		0xae07bce9, 0xb71c8da8, 0x9c31de6b, 0x852aef2a,
+		0xca6b79ed, 0xd37048ac, 0xf85d1b6f, 0xe1462a2e,
+		0x66de36e1, 0x7fc507a0, 0x54e85463, 0x4df36522,
+		0x02b2f3e5, 0x1ba9c2a4, 0x30849167, 0x299fa026,
+		0xe4c5aeb8, 0xfdde9ff9, 0xd6f3cc3a, 0xcfe8fd7b,
+		0x80a96bbc, 0x99b25afd, 0xb29f093e, 0xab84387f,
+		0x2c1c24b0, 0x350715f1, 0x1e2a4632, 0x07317773,
+		0x4870e1b4, 0x516bd0f5, 0x7a468336, 0x635db277,
+		0xcbfad74e, 0xd2e1e60f, 0xf9ccb5cc, 0xe0d7848d,
+		0xaf96124a, 0xb68d230b, 0x9da070c8, 0x84bb4189,
+		0x03235d46, 0x1a386c07, 0x31153fc4, 0x280e0e85,
+		0x674f9842, 0x7e54a903, 0x5579fac0, 0x4c62cb81,
+		0x8138c51f, 0x9823f45e, 0xb30ea79d, 0xaa1596dc,
+		0xe554001b, 0xfc4f315a, 0xd7626299, 0xce7953d8,
+		0x49e14f17, 0x50fa7e56, 0x7bd72d95, 0x62cc1cd4,
+		0x2d8d8a13, 0x3496bb52, 0x1fbbe891, 0x06a0d9d0,
+		0x5e7ef3ec, 0x4765c2ad, 0x6c48916e, 0x7553a02f,
+		0x3a1236e8, 0x230907a9, 0x0824546a, 0x113f652b,
+		0x96a779e4, 0x8fbc48a5, 0xa4911b66, 0xbd8a2a27,
+		0xf2cbbce0, 0xebd08da1, 0xc0fdde62, 0xd9e6ef23,
+		0x14bce1bd, 0x0da7d0fc, 0x268a833f, 0x3f91b27e,
+		0x70d024b9, 0x69cb15f8, 0x42e6463b, 0x5bfd777a,
+		0xdc656bb5, 0xc57e5af4, 0xee530937, 0xf7483876,
+		0xb809aeb1, 0xa1129ff0, 0x8a3fcc33, 0x9324fd72
+	},
+	{
+		0x00000000, 0x01c26a37, 0x0384d46e, 0x0246be59,
+		0x0709a8dc, 0x06cbc2eb, 0x048d7cb2, 0x054f1685,
+		0x0e1351b8, 0x0fd13b8f, 0x0d9785d6, 0x0c55efe1,
+		0x091af964, 0x08d89353, 0x0a9e2d0a, 0x0b5c473d,
+		0x1c26a370, 0x1de4c947, 0x1fa2771e, 0x1e601d29,
+		0x1b2f0bac, 0x1aed619b, 0x18abdfc2, 0x1969b5f5,
+		0x1235f2c8, 0x13f798ff, 0x11b126a6, 0x10734c91,
+		0x153c5a14, 0x14fe3023, 0x16b88e7a, 0x177ae44d,
+		0x384d46e0, 0x398f2cd7, 0x3bc9928e, 0x3a0bf8b9,
+		0x3f44ee3c, 0x3e86840b, 0x3cc03a52, 0x3d025065,
+		0x365e1758, 0x379c7d6f, 0x35dac336, 0x3418a901,
+		0x3157bf84, 0x3095d5b3, 0x32d36bea, 0x331101dd,
+		0x246be590, 0x25a98fa7, 0x27ef31fe, 0x262d5bc9,
+		0x23624d4c, 0x22a0277b, 0x20e69922, 0x2124f315,
+		0x2a78b428, 0x2bbade1f, 0x29fc6046, 0x283e0a71,
+		0x2d711cf4, 0x2cb376c3, 0x2ef5c89a, 0x2f37a2ad,
+		0x709a8dc0, 0x7158e7f7, 0x731e59ae, 0x72dc3399,
+		0x7793251c, 0x76514f2b, 0x7417f172, 0x75d59b45,
+		0x7e89dc78, 0x7f4bb64f, 0x7d0d0816, 0x7ccf6221,
+		0x798074a4, 0x78421e93, 0x7a04a0ca, 0x7bc6cafd,
+		0x6cbc2eb0, 0x6d7e4487, 0x6f38fade, 0x6efa90e9,
+		0x6bb5866c, 0x6a77ec5b, 0x68315202, 0x69f33835,
+		0x62af7f08, 0x636d153f, 0x612bab66, 0x60e9c151,
+		0x65a6d7d4, 0x6464bde3, 0x662203ba, 0x67e0698d,
+		0x48d7cb20, 0x4915a117, 0x4b531f4e, 0x4a917579,
+		0x4fde63fc, 0x4e1c09cb, 0x4c5ab792, 0x4d98dda5,
+		0x46c49a98, 0x4706f0af, 0x45404ef6, 0x448224c1,
+		0x41cd3244, 0x400f5873, 0x4249e62a, 0x438b8c1d,
+		0x54f16850, 0x55330267, 0x5775bc3e, 0x56b7d609,
+		0x53f8c08c, 0x523aaabb, 0x507c14e2, 0x51be7ed5,
+		0x5ae239e8, 0x5b2053df, 0x5966ed86, 0x58a487b1,
+		0x5deb9134, 0x5c29fb03, 0x5e6f455a, 0x5fad2f6d,
+		0xe1351b80, 0xe0f771b7, 0xe2b1cfee, 0xe373a5d9,
+		0xe63cb35c, 0xe7fed96b, 0xe5b86732, 0xe47a0d05,
+		0xef264a38, 0xeee4200f, 0xeca29e56, 0xed60f461,
+		0xe82fe2e4, 0xe9ed88d3, 0xebab368a, 0xea695cbd,
+		0xfd13b8f0, 0xfcd1d2c7, 0xfe976c9e, 0xff5506a9,
+		0xfa1a102c, 0xfbd87a1b, 0xf99ec442, 0xf85cae75,
+		0xf300e948, 0xf2c2837f, 0xf0843d26, 0xf1465711,
+		0xf4094194, 0xf5cb2ba3, 0xf78d95fa, 0xf64fffcd,
+		0xd9785d60, 0xd8ba3757, 0xdafc890e, 0xdb3ee339,
+		0xde71f5bc, 0xdfb39f8b, 0xddf521d2, 0xdc374be5,
+		0xd76b0cd8, 0xd6a966ef, 0xd4efd8b6, 0xd52db281,
+		0xd062a404, 0xd1a0ce33, 0xd3e6706a, 0xd2241a5d,
+		0xc55efe10, 0xc49c9427, 0xc6da2a7e, 0xc7184049,
+		0xc25756cc, 0xc3953cfb, 0xc1d382a2, 0xc011e895,
+		0xcb4dafa8, 0xca8fc59f, 0xc8c97bc6, 0xc90b11f1,
+		0xcc440774, 0xcd866d43, 0xcfc0d31a, 0xce02b92d,
+		0x91af9640, 0x906dfc77, 0x922b422e, 0x93e92819,
+		0x96a63e9c, 0x976454ab, 0x9522eaf2, 0x94e080c5,
+		0x9fbcc7f8, 0x9e7eadcf, 0x9c381396, 0x9dfa79a1,
+		0x98b56f24, 0x99770513, 0x9b31bb4a, 0x9af3d17d,
+		0x8d893530, 0x8c4b5f07, 0x8e0de15e, 0x8fcf8b69,
+		0x8a809dec, 0x8b42f7db, 0x89044982, 0x88c623b5,
+		0x839a6488, 0x82580ebf, 0x801eb0e6, 0x81dcdad1,
+		0x8493cc54, 0x8551a663, 0x8717183a, 0x86d5720d,
+		0xa9e2d0a0, 0xa820ba97, 0xaa6604ce, 0xaba46ef9,
+		0xaeeb787c, 0xaf29124b, 0xad6fac12, 0xacadc625,
+		0xa7f18118, 0xa633eb2f, 0xa4755576, 0xa5b73f41,
+		0xa0f829c4, 0xa13a43f3, 0xa37cfdaa, 0xa2be979d,
+		0xb5c473d0, 0xb40619e7, 0xb640a7be, 0xb782cd89,
+		0xb2cddb0c, 0xb30fb13b, 0xb1490f62, 0xb08b6555,
+		0xbbd72268, 0xba15485f, 0xb853f606, 0xb9919c31,
+		0xbcde8ab4, 0xbd1ce083, 0xbf5a5eda, 0xbe9834ed
+	},
+	{
+		0x00000000, 0xb8bc6765, 0xaa09c88b, 0x12b5afee,
+		0x8f629757, 0x37def032, 0x256b5fdc, 0x9dd738b9,
+		0xc5b428ef, 0x7d084f8a, 0x6fbde064, 0xd7018701,
+		0x4ad6bfb8, 0xf26ad8dd, 0xe0df7733, 0x58631056,
+		0x5019579f, 0xe8a530fa, 0xfa109f14, 0x42acf871,
+		0xdf7bc0c8, 0x67c7a7ad, 0x75720843, 0xcdce6f26,
+		0x95ad7f70, 0x2d111815, 0x3fa4b7fb, 0x8718d09e,
+		0x1acfe827, 0xa2738f42, 0xb0c620ac, 0x087a47c9,
+		0xa032af3e, 0x188ec85b, 0x0a3b67b5, 0xb28700d0,
+		0x2f503869, 0x97ec5f0c, 0x8559f0e2, 0x3de59787,
+		0x658687d1, 0xdd3ae0b4, 0xcf8f4f5a, 0x7733283f,
+		0xeae41086, 0x525877e3, 0x40edd80d, 0xf851bf68,
+		0xf02bf8a1, 0x48979fc4, 0x5a22302a, 0xe29e574f,
+		0x7f496ff6, 0xc7f50893, 0xd540a77d, 0x6dfcc018,
+		0x359fd04e, 0x8d23b72b, 0x9f9618c5, 0x272a7fa0,
+		0xbafd4719, 0x0241207c, 0x10f48f92, 0xa848e8f7,
+		0x9b14583d, 0x23a83f58, 0x311d90b6, 0x89a1f7d3,
+		0x1476cf6a, 0xaccaa80f, 0xbe7f07e1, 0x06c36084,
+		0x5ea070d2, 0xe61c17b7, 0xf4a9b859, 0x4c15df3c,
+		0xd1c2e785, 0x697e80e0, 0x7bcb2f0e, 0xc377486b,
+		0xcb0d0fa2, 0x73b168c7, 0x6104c729, 0xd9b8a04c,
+		0x446f98f5, 0xfcd3ff90, 0xee66507e, 0x56da371b,
+		0x0eb9274d, 0xb6054028, 0xa4b0efc6, 0x1c0c88a3,
+		0x81dbb01a, 0x3967d77f, 0x2bd27891, 0x936e1ff4,
+		0x3b26f703, 0x839a9066, 0x912f3f88, 0x299358ed,
+		0xb4446054, 0x0cf80731, 0x1e4da8df, 0xa6f1cfba,
+		0xfe92dfec, 0x462eb889, 0x549b1767, 0xec277002,
+		0x71f048bb, 0xc94c2fde, 0xdbf98030, 0x6345e755,
+		0x6b3fa09c, 0xd383c7f9, 0xc1366817, 0x798a0f72,
+		0xe45d37cb, 0x5ce150ae, 0x4e54ff40, 0xf6e89825,
+		0xae8b8873, 0x1637ef16, 0x048240f8, 0xbc3e279d,
+		0x21e91f24, 0x99557841, 0x8be0d7af, 0x335cb0ca,
+		0xed59b63b, 0x55e5d15e, 0x47507eb0, 0xffec19d5,
+		0x623b216c, 0xda874609, 0xc832e9e7, 0x708e8e82,
+		0x28ed9ed4, 0x9051f9b1, 0x82e4565f, 0x3a58313a,
+		0xa78f0983, 0x1f336ee6, 0x0d86c108, 0xb53aa66d,
+		0xbd40e1a4, 0x05fc86c1, 0x1749292f, 0xaff54e4a,
+		0x322276f3, 0x8a9e1196, 0x982bbe78, 0x2097d91d,
+		0x78f4c94b, 0xc048ae2e, 0xd2fd01c0, 0x6a4166a5,
+		0xf7965e1c, 0x4f2a3979, 0x5d9f9697, 0xe523f1f2,
+		0x4d6b1905, 0xf5d77e60, 0xe762d18e, 0x5fdeb6eb,
+		0xc2098e52, 0x7ab5e937, 0x680046d9, 0xd0bc21bc,
+		0x88df31ea, 0x3063568f, 0x22d6f961, 0x9a6a9e04,
+		0x07bda6bd, 0xbf01c1d8, 0xadb46e36, 0x15080953,
+		0x1d724e9a, 0xa5ce29ff, 0xb77b8611, 0x0fc7e174,
+		0x9210d9cd, 0x2aacbea8, 0x38191146, 0x80a57623,
+		0xd8c66675, 0x607a0110, 0x72cfaefe, 0xca73c99b,
+		0x57a4f122, 0xef189647, 0xfdad39a9, 0x45115ecc,
+		0x764dee06, 0xcef18963, 0xdc44268d, 0x64f841e8,
+		0xf92f7951, 0x41931e34, 0x5326b1da, 0xeb9ad6bf,
+		0xb3f9c6e9, 0x0b45a18c, 0x19f00e62, 0xa14c6907,
+		0x3c9b51be, 0x842736db, 0x96929935, 0x2e2efe50,
+		0x2654b999, 0x9ee8defc, 0x8c5d7112, 0x34e11677,
+		0xa9362ece, 0x118a49ab, 0x033fe645, 0xbb838120,
+		0xe3e09176, 0x5b5cf613, 0x49e959fd, 0xf1553e98,
+		0x6c820621, 0xd43e6144, 0xc68bceaa, 0x7e37a9cf,
+		0xd67f4138, 0x6ec3265d, 0x7c7689b3, 0xc4caeed6,
+		0x591dd66f, 0xe1a1b10a, 0xf3141ee4, 0x4ba87981,
+		0x13cb69d7, 0xab770eb2, 0xb9c2a15c, 0x017ec639,
+		0x9ca9fe80, 0x241599e5, 0x36a0360b, 0x8e1c516e,
+		0x866616a7, 0x3eda71c2, 0x2c6fde2c, 0x94d3b949,
+		0x090481f0, 0xb1b8e695, 0xa30d497b, 0x1bb12e1e,
+		0x43d23e48, 0xfb6e592d, 0xe9dbf6c3, 0x516791a6,
+		0xccb0a91f, 0x740cce7a, 0x66b96194, 0xde0506f1
+	}
+};
+
+/**
+ * Tables for CRC32C (Castagnoli, reflected divisor polynomial 0x82f63b78),
+ * organized the same way as @c poly_table (row 0) and
+ * @c crc32_slice_table (rows 1 to 3).
+ */
+static const uint32_t crc32c_table[4][256] = {
+	{
+		0x00000000, 0xf26b8303, 0xe13b70f7, 0x1350f3f4,
+		0xc79a971f, 0x35f1141c, 0x26a1e7e8, 0xd4ca64eb,
+		0x8ad958cf, 0x78b2dbcc, 0x6be22838, 0x9989ab3b,
+		0x4d43cfd0, 0xbf284cd3, 0xac78bf27, 0x5e133c24,
+		0x105ec76f, 0xe235446c, 0xf165b798, 0x030e349b,
+		0xd7c45070, 0x25afd373, 0x36ff2087, 0xc494a384,
+		0x9a879fa0, 0x68ec1ca3, 0x7bbcef57, 0x89d76c54,
+		0x5d1d08bf, 0xaf768bbc, 0xbc267848, 0x4e4dfb4b,
+		0x20bd8ede, 0xd2d60ddd, 0xc186fe29, 0x33ed7d2a,
+		0xe72719c1, 0x154c9ac2, 0x061c6936, 0xf477ea35,
+		0xaa64d611, 0x580f5512, 0x4b5fa6e6, 0xb93425e5,
+		0x6dfe410e, 0x9f95c20d, 0x8cc531f9, 0x7eaeb2fa,
+		0x30e349b1, 0xc288cab2, 0xd1d83946, 0x23b3ba45,
+		0xf779deae, 0x05125dad, 0x1642ae59, 0xe4292d5a,
+		0xba3a117e, 0x4851927d, 0x5b016189, 0xa96ae28a,
+		0x7da08661, 0x8fcb0562, 0x9c9bf696, 0x6ef07595,
+		0x417b1dbc, 0xb3109ebf, 0xa0406d4b, 0x522bee48,
+		0x86e18aa3, 0x748a09a0, 0x67dafa54, 0x95b17957,
+		0xcba24573, 0x39c9c670, 0x2a993584, 0xd8f2b687,
+		0x0c38d26c, 0xfe53516f, 0xed03a29b, 0x1f682198,
+		0x5125dad3, 0xa34e59d0, 0xb01eaa24, 0x42752927,
+		0x96bf4dcc, 0x64d4cecf, 0x77843d3b, 0x85efbe38,
+		0xdbfc821c, 0x2997011f, 0x3ac7f2eb, 0xc8ac71e8,
+		0x1c661503, 0xee0d9600, 0xfd5d65f4, 0x0f36e6f7,
+		0x61c69362, 0x93ad1061, 0x80fde395, 0x72966096,
+		0xa65c047d, 0x5437877e, 0x4767748a, 0xb50cf789,
+		0xeb1fcbad, 0x197448ae, 0x0a24bb5a, 0xf84f3859,
+		0x2c855cb2, 0xdeeedfb1, 0xcdbe2c45, 0x3fd5af46,
+		0x7198540d, 0x83f3d70e, 0x90a324fa, 0x62c8a7f9,
+		0xb602c312, 0x44694011, 0x5739b3e5, 0xa55230e6,
+		0xfb410cc2, 0x092a8fc1, 0x1a7a7c35, 0xe811ff36,
+		0x3cdb9bdd, 0xceb018de, 0xdde0eb2a, 0x2f8b6829,
+		0x82f63b78, 0x709db87b, 0x63cd4b8f, 0x91a6c88c,
+		0x456cac67, 0xb7072f64, 0xa457dc90, 0x563c5f93,
+		0x082f63b7, 0xfa44e0b4, 0xe9141340, 0x1b7f9043,
+		0xcfb5f4a8, 0x3dde77ab, 0x2e8e845f, 0xdce5075c,
+		0x92a8fc17, 0x60c37f14, 0x73938ce0, 0x81f80fe3,
+		0x55326b08, 0xa759e80b, 0xb4091bff, 0x466298fc,
+		0x1871a4d8, 0xea1a27db, 0xf94ad42f, 0x0b21572c,
+		0xdfeb33c7, 0x2d80b0c4, 0x3ed04330, 0xccbbc033,
+		0xa24bb5a6, 0x502036a5, 0x4370c551, 0xb11b4652,
+		0x65d122b9, 0x97baa1ba, 0x84ea524e, 0x7681d14d,
+		0x2892ed69, 0xdaf96e6a, 0xc9a99d9e, 0x3bc21e9d,
+		0xef087a76, 0x1d63f975, 0x0e330a81, 0xfc588982,
+		0xb21572c9, 0x407ef1ca, 0x532e023e, 0xa145813d,
+		0x758fe5d6, 0x87e466d5, 0x94b49521, 0x66df1622,
+		0x38cc2a06, 0xcaa7a905, 0xd9f75af1, 0x2b9cd9f2,
+		0xff56bd19, 0x0d3d3e1a, 0x1e6dcdee, 0xec064eed,
+		0xc38d26c4, 0x31e6a5c7, 0x22b65633, 0xd0ddd530,
+		0x0417b1db, 0xf67c32d8, 0xe52cc12c, 0x1747422f,
+		0x49547e0b, 0xbb3ffd08, 0xa86f0efc, 0x5a048dff,
+		0x8ecee914, 0x7ca56a17, 0x6ff599e3, 0x9d9e1ae0,
+		0xd3d3e1ab, 0x21b862a8, 0x32e8915c, 0xc083125f,
+		0x144976b4, 0xe622f5b7, 0xf5720643, 0x07198540,
+		0x590ab964, 0xab613a67, 0xb831c993, 0x4a5a4a90,
+		0x9e902e7b, 0x6cfbad78, 0x7fab5e8c, 0x8dc0dd8f,
+		0xe330a81a, 0x115b2b19, 0x020bd8ed, 0xf0605bee,
+		0x24aa3f05, 0xd6c1bc06, 0xc5914ff2, 0x37faccf1,
+		0x69e9f0d5, 0x9b8273d6, 0x88d28022, 0x7ab90321,
+		0xae7367ca, 0x5c18e4c9, 0x4f48173d, 0xbd23943e,
+		0xf36e6f75, 0x0105ec76, 0x12551f82, 0xe03e9c81,
+		0x34f4f86a, 0xc69f7b69, 0xd5cf889d, 0x27a40b9e,
+		0x79b737ba, 0x8bdcb4b9, 0x988c474d, 0x6ae7c44e,
+		0xbe2da0a5, 0x4c4623a6, 0x5f16d052, 0xad7d5351
+	},
+	{
+		0x00000000, 0x13a29877, 0x274530ee, 0x34e7a899,
+		0x4e8a61dc, 0x5d28f9ab, 0x69cf5132, 0x7a6dc945,
+		0x9d14c3b8, 0x8eb65bcf, 0xba51f356, 0xa9f36b21,
+		0xd39ea264, 0xc03c3a13, 0xf4db928a, 0xe7790afd,
+		0x3fc5f181, 0x2c6769f6, 0x1880c16f, 0x0b225918,
+		0x714f905d, 0x62ed082a, 0x560aa0b3, 0x45a838c4,
+		0xa2d13239, 0xb173aa4e, 0x859402d7, 0x96369aa0,
+		0xec5b53e5, 0xfff9cb92, 0xcb1e630b, 0xd8bcfb7c,
+		0x7f8be302, 0x6c297b75, 0x58ced3ec, 0x4b6c4b9b,
+		0x310182de, 0x22a31aa9, 0x1644b230, 0x05e62a47,
+		0xe29f20ba, 0xf13db8cd, 0xc5da1054, 0xd6788823,
+		0xac154166, 0xbfb7d911, 0x8b507188, 0x98f2e9ff,
+		0x404e1283, 0x53ec8af4, 0x670b226d, 0x74a9ba1a,
+		0x0ec4735f, 0x1d66eb28, 0x298143b1, 0x3a23dbc6,
+		0xdd5ad13b, 0xcef8494c, 0xfa1fe1d5, 0xe9bd79a2,
+		0x93d0b0e7, 0x80722890, 0xb4958009, 0xa737187e,
+		0xff17c604, 0xecb55e73, 0xd852f6ea, 0xcbf06e9d,
+		0xb19da7d8, 0xa23f3faf, 0x96d89736, 0x857a0f41,
+		0x620305bc, 0x71a19dcb, 0x45463552, 0x56e4ad25,
+		0x2c896460, 0x3f2bfc17, 0x0bcc548e, 0x186eccf9,
+		0xc0d23785, 0xd370aff2, 0xe797076b, 0xf4359f1c,
+		0x8e585659, 0x9dface2e, 0xa91d66b7, 0xbabffec0,
+		0x5dc6f43d, 0x4e646c4a, 0x7a83c4d3, 0x69215ca4,
+		0x134c95e1, 0x00ee0d96, 0x3409a50f, 0x27ab3d78,
+		0x809c2506, 0x933ebd71, 0xa7d915e8, 0xb47b8d9f,
+		0xce1644da, 0xddb4dcad, 0xe9537434, 0xfaf1ec43,
+		0x1d88e6be, 0x0e2a7ec9, 0x3acdd650, 0x296f4e27,
+		0x53028762, 0x40a01f15, 0x7447b78c, 0x67e52ffb,
+		0xbf59d487, 0xacfb4cf0, 0x981ce469, 0x8bbe7c1e,
+		0xf1d3b55b, 0xe2712d2c, 0xd69685b5, 0xc5341dc2,
+		0x224d173f, 0x31ef8f48, 0x050827d1, 0x16aabfa6,
+		0x6cc776e3, 0x7f65ee94, 0x4b82460d, 0x5820de7a,
+		0xfbc3faf9, 0xe861628e, 0xdc86ca17, 0xcf245260,
+		0xb5499b25, 0xa6eb0352, 0x920cabcb, 0x81ae33bc,
+		0x66d73941, 0x7575a136, 0x419209af, 0x523091d8,
+		0x285d589d, 0x3bffc0ea, 0x0f186873, 0x1cbaf004,
+		0xc4060b78, 0xd7a4930f, 0xe3433b96, 0xf0e1a3e1,
+		0x8a8c6aa4, 0x992ef2d3, 0xadc95a4a, 0xbe6bc23d,
+		0x5912c8c0, 0x4ab050b7, 0x7e57f82e, 0x6df56059,
+		0x1798a91c, 0x043a316b, 0x30dd99f2, 0x237f0185,
+		0x844819fb, 0x97ea818c, 0xa30d2915, 0xb0afb162,
+		0xcac27827, 0xd960e050, 0xed8748c9, 0xfe25d0be,
+		0x195cda43, 0x0afe4234, 0x3e19eaad, 0x2dbb72da,
+		0x57d6bb9f, 0x447423e8, 0x70938b71, 0x63311306,
+		0xbb8de87a, 0xa82f700d, 0x9cc8d894, 0x8f6a40e3,
+		0xf50789a6, 0xe6a511d1, 0xd242b948, 0xc1e0213f,
+		0x26992bc2, 0x353bb3b5, 0x01dc1b2c, 0x127e835b,
+		0x68134a1e, 0x7bb1d269, 0x4f567af0, 0x5cf4e287,
+		0x04d43cfd, 0x1776a48a, 0x23910c13, 0x30339464,
+		0x4a5e5d21, 0x59fcc556, 0x6d1b6dcf, 0x7eb9f5b8,
+		0x99c0ff45, 0x8a626732, 0xbe85cfab, 0xad2757dc,
+		0xd74a9e99, 0xc4e806ee, 0xf00fae77, 0xe3ad3600,
+		0x3b11cd7c, 0x28b3550b, 0x1c54fd92, 0x0ff665e5,
+		0x759baca0, 0x663934d7, 0x52de9c4e, 0x417c0439,
+		0xa6050ec4, 0xb5a796b3, 0x81403e2a, 0x92e2a65d,
+		0xe88f6f18, 0xfb2df76f, 0xcfca5ff6, 0xdc68c781,
+		0x7b5fdfff, 0x68fd4788, 0x5c1aef11, 0x4fb87766,
+		0x35d5be23, 0x26772654, 0x12908ecd, 0x013216ba,
+		0xe64b1c47, 0xf5e98430, 0xc10e2ca9, 0xd2acb4de,
+		0xa8c17d9b, 0xbb63e5ec, 0x8f844d75, 0x9c26d502,
+		0x449a2e7e, 0x5738b609, 0x63df1e90, 0x707d86e7,
+		0x0a104fa2, 0x19b2d7d5, 0x2d557f4c, 0x3ef7e73b,
+		0xd98eedc6, 0xca2c75b1, 0xfecbdd28, 0xed69455f,
+		0x97048c1a, 0x84a6146d, 0xb041bcf4, 0xa3e32483
+	},
+	{
+		0x00000000, 0xa541927e, 0x4f6f520d, 0xea2ec073,
+		0x9edea41a, 0x3b9f3664, 0xd1b1f617, 0x74f06469,
+		0x38513ec5, 0x9d10acbb, 0x773e6cc8, 0xd27ffeb6,
+		0xa68f9adf, 0x03ce08a1, 0xe9e0c8d2, 0x4ca15aac,
+		0x70a27d8a, 0xd5e3eff4, 0x3fcd2f87, 0x9a8cbdf9,
+		0xee7cd990, 0x4b3d4bee, 0xa1138b9d, 0x045219e3,
+		0x48f3434f, 0xedb2d131, 0x079c1142, 0xa2dd833c,
+		0xd62de755, 0x736c752b, 0x9942b558, 0x3c032726,
+		0xe144fb14, 0x4405696a, 0xae2ba919, 0x0b6a3b67,
+		0x7f9a5f0e, 0xdadbcd70, 0x30f50d03, 0x95b49f7d,
+		0xd915c5d1, 0x7c5457af, 0x967a97dc, 0x333b05a2,
+		0x47cb61cb, 0xe28af3b5, 0x08a433c6, 0xade5a1b8,
+		0x91e6869e, 0x34a714e0, 0xde89d493, 0x7bc846ed,
+		0x0f382284, 0xaa79b0fa, 0x40577089, 0xe516e2f7,
+		0xa9b7b85b, 0x0cf62a25, 0xe6d8ea56, 0x43997828,
+		0x37691c41, 0x92288e3f, 0x78064e4c, 0xdd47dc32,
+		0xc76580d9, 0x622412a7, 0x880ad2d4, 0x2d4b40aa,
+		0x59bb24c3, 0xfcfab6bd, 0x16d476ce, 0xb395e4b0,
+		0xff34be1c, 0x5a752c62, 0xb05bec11, 0x151a7e6f,
+		0x61ea1a06, 0xc4ab8878, 0x2e85480b, 0x8bc4da75,
+		0xb7c7fd53, 0x12866f2d, 0xf8a8af5e, 0x5de93d20,
+		0x29195949, 0x8c58cb37, 0x66760b44, 0xc337993a,
+		0x8f96c396, 0x2ad751e8, 0xc0f9919b, 0x65b803e5,
+		0x1148678c, 0xb409f5f2, 0x5e273581, 0xfb66a7ff,
+		0x26217bcd, 0x8360e9b3, 0x694e29c0, 0xcc0fbbbe,
+		0xb8ffdfd7, 0x1dbe4da9, 0xf7908dda, 0x52d11fa4,
+		0x1e704508, 0xbb31d776, 0x511f1705, 0xf45e857b,
+		0x80aee112, 0x25ef736c, 0xcfc1b31f, 0x6a802161,
+		0x56830647, 0xf3c29439, 0x19ec544a, 0xbcadc634,
+		0xc85da25d, 0x6d1c3023, 0x8732f050, 0x2273622e,
+		0x6ed23882, 0xcb93aafc, 0x21bd6a8f, 0x84fcf8f1,
+		0xf00c9c98, 0x554d0ee6, 0xbf63ce95, 0x1a225ceb,
+		0x8b277743, 0x2e66e53d, 0xc448254e, 0x6109b730,
+		0x15f9d359, 0xb0b84127, 0x5a968154, 0xffd7132a,
+		0xb3764986, 0x1637dbf8, 0xfc191b8b, 0x595889f5,
+		0x2da8ed9c, 0x88e97fe2, 0x62c7bf91, 0xc7862def,
+		0xfb850ac9, 0x5ec498b7, 0xb4ea58c4, 0x11abcaba,
+		0x655baed3, 0xc01a3cad, 0x2a34fcde, 0x8f756ea0,
+		0xc3d4340c, 0x6695a672, 0x8cbb6601, 0x29faf47f,
+		0x5d0a9016, 0xf84b0268, 0x1265c21b, 0xb7245065,
+		0x6a638c57, 0xcf221e29, 0x250cde5a, 0x804d4c24,
+		0xf4bd284d, 0x51fcba33, 0xbbd27a40, 0x1e93e83e,
+		0x5232b292, 0xf77320ec, 0x1d5de09f, 0xb81c72e1,
+		0xccec1688, 0x69ad84f6, 0x83834485, 0x26c2d6fb,
+		0x1ac1f1dd, 0xbf8063a3, 0x55aea3d0, 0xf0ef31ae,
+		0x841f55c7, 0x215ec7b9, 0xcb7007ca, 0x6e3195b4,
+		0x2290cf18, 0x87d15d66, 0x6dff9d15, 0xc8be0f6b,
+		0xbc4e6b02, 0x190ff97c, 0xf321390f, 0x5660ab71,
+		0x4c42f79a, 0xe90365e4, 0x032da597, 0xa66c37e9,
+		0xd29c5380, 0x77ddc1fe, 0x9df3018d, 0x38b293f3,
+		0x7413c95f, 0xd1525b21, 0x3b7c9b52, 0x9e3d092c,
+		0xeacd6d45, 0x4f8cff3b, 0xa5a23f48, 0x00e3ad36,
+		0x3ce08a10, 0x99a1186e, 0x738fd81d, 0xd6ce4a63,
+		0xa23e2e0a, 0x077fbc74, 0xed517c07, 0x4810ee79,
+		0x04b1b4d5, 0xa1f026ab, 0x4bdee6d8, 0xee9f74a6,
+		0x9a6f10cf, 0x3f2e82b1, 0xd50042c2, 0x7041d0bc,
+		0xad060c8e, 0x08479ef0, 0xe2695e83, 0x4728ccfd,
+		0x33d8a894, 0x96993aea, 0x7cb7fa99, 0xd9f668e7,
+		0x9557324b, 0x3016a035, 0xda386046, 0x7f79f238,
+		0x0b899651, 0xaec8042f, 0x44e6c45c, 0xe1a75622,
+		0xdda47104, 0x78e5e37a, 0x92cb2309, 0x378ab177,
+		0x437ad51e, 0xe63b4760, 0x0c158713, 0xa954156d,
+		0xe5f54fc1, 0x40b4ddbf, 0xaa9a1dcc, 0x0fdb8fb2,
+		0x7b2bebdb, 0xde6a79a5, 0x3444b9d6, 0x91052ba8
+	},
+	{
+		0x00000000, 0xdd45aab8, 0xbf672381, 0x62228939,
+		0x7b2231f3, 0xa6679b4b, 0xc4451272, 0x1900b8ca,
+		0xf64463e6, 0x2b01c95e, 0x49234067, 0x9466eadf,
+		0x8d665215, 0x5023f8ad, 0x32017194, 0xef44db2c,
+		0xe964b13d, 0x34211b85, 0x560392bc, 0x8b463804,
+		0x924680ce, 0x4f032a76, 0x2d21a34f, 0xf06409f7,
+		0x1f20d2db, 0xc2657863, 0xa047f15a, 0x7d025be2,
+		0x6402e328, 0xb9474990, 0xdb65c0a9, 0x06206a11,
+		0xd725148b, 0x0a60be33, 0x6842370a, 0xb5079db2,
+		0xac072578, 0x71428fc0, 0x136006f9, 0xce25ac41,
+		0x2161776d, 0xfc24ddd5, 0x9e0654ec, 0x4343fe54,
+		0x5a43469e, 0x8706ec26, 0xe524651f, 0x3861cfa7,
+		0x3e41a5b6, 0xe3040f0e, 0x81268637, 0x5c632c8f,
+		0x45639445, 0x98263efd, 0xfa04b7c4, 0x27411d7c,
+		0xc805c650, 0x15406ce8, 0x7762e5d1, 0xaa274f69,
+		0xb327f7a3, 0x6e625d1b, 0x0c40d422, 0xd1057e9a,
+		0xaba65fe7, 0x76e3f55f, 0x14c17c66, 0xc984d6de,
+		0xd0846e14, 0x0dc1c4ac, 0x6fe34d95, 0xb2a6e72d,
+		0x5de23c01, 0x80a796b9, 0xe2851f80, 0x3fc0b538,
+		0x26c00df2, 0xfb85a74a, 0x99a72e73, 0x44e284cb,
+		0x42c2eeda, 0x9f874462, 0xfda5cd5b, 0x20e067e3,
+		0x39e0df29, 0xe4a57591, 0x8687fca8, 0x5bc25610,
+		0xb4868d3c, 0x69c32784, 0x0be1aebd, 0xd6a40405,
+		0xcfa4bccf, 0x12e11677, 0x70c39f4e, 0xad8635f6,
+		0x7c834b6c, 0xa1c6e1d4, 0xc3e468ed, 0x1ea1c255,
+		0x07a17a9f, 0xdae4d027, 0xb8c6591e, 0x6583f3a6,
+		0x8ac7288a, 0x57828232, 0x35a00b0b, 0xe8e5a1b3,
+		0xf1e51979, 0x2ca0b3c1, 0x4e823af8, 0x93c79040,
+		0x95e7fa51, 0x48a250e9, 0x2a80d9d0, 0xf7c57368,
+		0xeec5cba2, 0x3380611a, 0x51a2e823, 0x8ce7429b,
+		0x63a399b7, 0xbee6330f, 0xdcc4ba36, 0x0181108e,
+		0x1881a844, 0xc5c402fc, 0xa7e68bc5, 0x7aa3217d,
+		0x52a0c93f, 0x8fe56387, 0xedc7eabe, 0x30824006,
+		0x2982f8cc, 0xf4c75274, 0x96e5db4d, 0x4ba071f5,
+		0xa4e4aad9, 0x79a10061, 0x1b838958, 0xc6c623e0,
+		0xdfc69b2a, 0x02833192, 0x60a1b8ab, 0xbde41213,
+		0xbbc47802, 0x6681d2ba, 0x04a35b83, 0xd9e6f13b,
+		0xc0e649f1, 0x1da3e349, 0x7f816a70, 0xa2c4c0c8,
+		0x4d801be4, 0x90c5b15c, 0xf2e73865, 0x2fa292dd,
+		0x36a22a17, 0xebe780af, 0x89c50996, 0x5480a32e,
+		0x8585ddb4, 0x58c0770c, 0x3ae2fe35, 0xe7a7548d,
+		0xfea7ec47, 0x23e246ff, 0x41c0cfc6, 0x9c85657e,
+		0x73c1be52, 0xae8414ea, 0xcca69dd3, 0x11e3376b,
+		0x08e38fa1, 0xd5a62519, 0xb784ac20, 0x6ac10698,
+		0x6ce16c89, 0xb1a4c631, 0xd3864f08, 0x0ec3e5b0,
+		0x17c35d7a, 0xca86f7c2, 0xa8a47efb, 0x75e1d443,
+		0x9aa50f6f, 0x47e0a5d7, 0x25c22cee, 0xf8878656,
+		0xe1873e9c, 0x3cc29424, 0x5ee01d1d, 0x83a5b7a5,
+		0xf90696d8, 0x24433c60, 0x4661b559, 0x9b241fe1,
+		0x8224a72b, 0x5f610d93, 0x3d4384aa, 0xe0062e12,
+		0x0f42f53e, 0xd2075f86, 0xb025d6bf, 0x6d607c07,
+		0x7460c4cd, 0xa9256e75, 0xcb07e74c, 0x16424df4,
+		0x106227e5, 0xcd278d5d, 0xaf050464, 0x7240aedc,
+		0x6b401616, 0xb605bcae, 0xd4273597, 0x09629f2f,
+		0xe6264403, 0x3b63eebb, 0x59416782, 0x8404cd3a,
+		0x9d0475f0, 0x4041df48, 0x22635671, 0xff26fcc9,
+		0x2e238253, 0xf36628eb, 0x9144a1d2, 0x4c010b6a,
+		0x5501b3a0, 0x88441918, 0xea669021, 0x37233a99,
+		0xd867e1b5, 0x05224b0d, 0x6700c234, 0xba45688c,
+		0xa345d046, 0x7e007afe, 0x1c22f3c7, 0xc167597f,
+		0xc747336e, 0x1a0299d6, 0x782010ef, 0xa565ba57,
+		0xbc65029d, 0x6120a825, 0x0302211c, 0xde478ba4,
+		0x31035088, 0xec46fa30, 0x8e647309, 0x5321d9b1,
+		0x4a21617b, 0x9764cbc3, 0xf54642fa, 0x2803e842
+	}
+};
+
+/** Update reflected CRC four bytes at a time.
+ *
+ * @param t0     Single-byte table
+ * @param tn     Tables for bytes followed by one, two and three zero bytes
+ * @param crc    Current (inverted) CRC register value
+ * @param data   Data to process
+ * @param length Length of the data in bytes
+ *
+ * @return New CRC register value
+ */
+static uint32_t crc_update(const uint32_t *t0, const uint32_t (*tn)[256],
+    uint32_t crc, const uint8_t *data, size_t length)
+{
+	while (length >= 4) {
+		crc ^= (uint32_t) data[0] | ((uint32_t) data[1] << 8) |
+		    ((uint32_t) data[2] << 16) | ((uint32_t) data[3] << 24);
+		crc = tn[2][crc & 0xff] ^ tn[1][(crc >> 8) & 0xff] ^
+		    tn[0][(crc >> 16) & 0xff] ^ t0[crc >> 24];
+		data += 4;
+		length -= 4;
+	}
+
+	while (length > 0) {
+		crc = t0[(uint8_t) crc ^ *data] ^ (crc >> 8);
+		data++;
+		length--;
+	}
+
+	return crc;
+}
+
+/** Multiply GF(2) 32x32 matrix by vector. */
+static uint32_t crc_gf2_times(const uint32_t *mat, uint32_t vec)
+{
+	uint32_t sum = 0;
+
+	while (vec != 0) {
+		if ((vec & 1) != 0)
+			sum ^= *mat;
+		vec >>= 1;
+		mat++;
+	}
+
+	return sum;
+}
+
+/** Square GF(2) 32x32 matrix. */
+static void crc_gf2_square(uint32_t *square, const uint32_t *mat)
+{
+	unsigned n;
+
+	for (n = 0; n < 32; n++)
+		square[n] = crc_gf2_times(mat, mat[n]);
+}
+
+/** Combine two reflected CRCs.
+ *
+ * Applies the operator for @a len2 zero bytes to @a crc1 by repeated
+ * squaring, so the cost is logarithmic in @a len2.
+ *
+ * @param poly Reflected divisor polynomial
+ * @param crc1 CRC of the first block
+ * @param crc2 CRC of the second block
+ * @param len2 Length of the second block in bytes
+ *
+ * @return CRC of the concatenation of both blocks
+ */
+static uint32_t crc_combine(uint32_t poly, uint32_t crc1, uint32_t crc2,
+    size_t len2)
+{
+	uint32_t even[32];
+	uint32_t odd[32];
+	uint32_t row;
+	unsigned n;
+
+	if (len2 == 0)
+		return crc1;
+
+	/* Operator for one zero bit */
+	odd[0] = poly;
+	row = 1;
+	for (n = 1; n < 32; n++) {
+		odd[n] = row;
+		row <<= 1;
+	}
+
+	/* Two zero bits, then four zero bits */
+	crc_gf2_square(even, odd);
+	crc_gf2_square(odd, even);
+
+	/* First squaring yields the operator for one zero byte */
+	do {
+		crc_gf2_square(even, odd);
+		if ((len2 & 1) != 0)
+			crc1 = crc_gf2_times(even, crc1);
+		len2 >>= 1;
+
+		if (len2 == 0)
+			break;
+
+		crc_gf2_square(odd, even);
+		if ((len2 & 1) != 0)
+			crc1 = crc_gf2_times(odd, crc1);
+		len2 >>= 1;
+	} while (len2 != 0);
+
+	return crc1 ^ crc2;
+}
+
 /** Compute CRC32 value.
  *
  * See wiki.osdev.org/CRC32 for reference.
@@ -134,12 +743,181 @@ uint32_t compute_crc32(uint8_t *data, size_t length)
  */
 uint32_t compute_crc32_seed(uint8_t *data, size_t length, uint32_t seed)
 {
-	uint32_t crc;
+	return ~crc_update(poly_table, crc32_slice_table, ~seed, data,
+	    length);
+}
+
+/** Combine CRC32 values of two adjacent blocks.
+ *
+ * Unlike compute_crc32_seed() this does not need the data of the second
+ * block, so blocks can be checksummed independently (in any order) and
+ * the results combined afterwards.
+ *
+ * @param[in] crc1 CRC32 of the first block.
+ * @param[in] crc2 CRC32 of the second block.
+ * @param[in] len2 Length of the second block in bytes.
+ *
+ * @return CRC32 of the first block followed by the second block.
+ *
+ */
+uint32_t crc32_combine(uint32_t crc1, uint32_t crc2, size_t len2)
+{
+	return crc_combine(CRC32_POLY, crc1, crc2, len2);
+}
+
+/** Compute CRC32C (Castagnoli) value.
+ *
+ * This is the variant used by iSCSI, SCTP and ext4/btrfs metadata.
+ *
+ * @param[in] data   Data to process.
+ * @param[in] length Length of the data in bytes.
+ *
+ * @return Computed CRC32C of the data.
+ *
+ */
+uint32_t compute_crc32c(const uint8_t *data, size_t length)
+{
+	return compute_crc32c_seed(data, length, 0);
+}
 
-	for (crc = ~seed; length > 0; length--)
-		crc = poly_table[((uint8_t) crc ^ *(data++))] ^ (crc >> 8);
+/** Compute CRC32C value with initial seed.
+ *
+ * Seeding works the same way as with compute_crc32_seed().
+ *
+ * @param[in] data   Data to process.
+ * @param[in] length Length of the data in bytes.
+ * @param[in] seed   The starting value of the CRC.
+ *
+ * @return Computed CRC32C of the data of all the previous blocks.
+ *
+ */
+uint32_t compute_crc32c_seed(const uint8_t *data, size_t length,
+    uint32_t seed)
+{
+	return ~crc_update(crc32c_table[0], &crc32c_table[1], ~seed, data,
+	    length);
+}
+
+/** Combine CRC32C values of two adjacent blocks.
+ *
+ * @param[in] crc1 CRC32C of the first block.
+ * @param[in] crc2 CRC32C of the second block.
+ * @param[in] len2 Length of the second block in bytes.
+ *
+ * @return CRC32C of the first block followed by the second block.
+ *
+ */
+uint32_t crc32c_combine(uint32_t crc1, uint32_t crc2, size_t len2)
+{
+	return crc_combine(CRC32C_POLY, crc1, crc2, len2);
+}
+
+/** Ones' complement addition of two 16-bit values.
+ *
+ * @param[in] a First addend.
+ * @param[in] b Second addend.
+ *
+ * @return a + b with end-around carry.
+ *
+ */
+uint16_t ocsum_add(uint16_t a, uint16_t b)
+{
+	uint32_t s;
+
+	s = (uint32_t) a + (uint32_t) b;
+	return (s & 0xffff) + (s >> 16);
+}
+
+/** Compute ones' complement sum (Internet checksum, RFC 1071).
+ *
+ * The data is treated as a sequence of big-endian 16-bit words, an odd
+ * trailing byte is padded with zero. The sum is not complemented, so
+ * partial sums of consecutive blocks can be chained through @a seed or
+ * merged with ocsum_combine(). The Internet checksum of the data is
+ * the complement of the result.
+ *
+ * The bulk of the data is summed 32 bytes at a time in 32-bit vector
+ * lanes in native byte order. This is correct since the ones' complement
+ * sum commutes with byte swapping (RFC 1071 section 2 (B)).
+ *
+ * @param[in] data Data to process.
+ * @param[in] size Size of the data in bytes.
+ * @param[in] seed Sum to start with (zero for a fresh checksum).
+ *
+ * @return Ones' complement sum of @a seed and the data.
+ *
+ */
+uint16_t compute_ocsum(const void *data, size_t size, uint16_t seed)
+{
+	const uint8_t *bdata = data;
+	ocsum_vec_t vacc;
+	ocsum_vec_t v;
+	uint64_t sum = 0;
+	size_t nblocks;
+	size_t i;
+	uint32_t w;
+	uint16_t hw;
+
+	while (size >= OCSUM_BLOCK) {
+		nblocks = min(size / OCSUM_BLOCK, OCSUM_MAX_BLOCKS);
+		vacc = (ocsum_vec_t) { 0, 0, 0, 0 };
+
+		for (i = 0; i < nblocks; i++) {
+			__builtin_memcpy(&v, bdata, sizeof(v));
+			vacc += (v & 0xffff) + (v >> 16);
+			__builtin_memcpy(&v, bdata + sizeof(v), sizeof(v));
+			vacc += (v & 0xffff) + (v >> 16);
+			bdata += OCSUM_BLOCK;
+		}
+
+		size -= nblocks * OCSUM_BLOCK;
+		sum += (uint64_t) vacc[0] + vacc[1] + vacc[2] + vacc[3];
+	}
+
+	while (size >= sizeof(w)) {
+		__builtin_memcpy(&w, bdata, sizeof(w));
+		sum += (w & 0xffff) + (w >> 16);
+		bdata += sizeof(w);
+		size -= sizeof(w);
+	}
+
+	if (size >= sizeof(hw)) {
+		__builtin_memcpy(&hw, bdata, sizeof(hw));
+		sum += hw;
+		bdata += sizeof(hw);
+		size -= sizeof(hw);
+	}
+
+	if (size > 0) {
+		/* Pad to a full word in memory order */
+		hw = 0;
+		__builtin_memcpy(&hw, bdata, 1);
+		sum += hw;
+	}
+
+	while ((sum >> 16) != 0)
+		sum = (sum & 0xffff) + (sum >> 16);
+
+	/* Native-order sum has the bytes of the big-endian sum */
+	return ocsum_add(uint16_t_be2host(sum), seed);
+}
+
+/** Combine ones' complement sums of two adjacent blocks.
+ *
+ * @param[in] sum  Sum of the data preceding the block.
+ * @param[in] bsum Sum of the block computed on its own.
+ * @param[in] offs Offset of the block from the start of the data.
+ *
+ * @return Ones' complement sum of the data including the block.
+ *
+ */
+uint16_t ocsum_combine(uint16_t sum, uint16_t bsum, size_t offs)
+{
+	/* A block at an odd offset has its bytes in the other word halves */
+	if ((offs % 2) != 0)
+		bsum = (bsum << 8) | (bsum >> 8);
 
-	return (~crc);
+	return ocsum_add(sum, bsum);
 }
 
 /** @}
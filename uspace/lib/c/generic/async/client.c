@@ -139,6 +139,9 @@ typedef struct {
 	/** Pointer to where the answer data is stored. */
 	ipc_call_t *dataptr;
 
+	/** Additional event to notify when the reply arrives. */
+	fibril_event_t *notify;
+
 	errno_t retval;
 } amsg_t;
 
@@ -152,20 +155,45 @@ static void amsg_destroy(amsg_t *msg)
 	free(msg);
 }
 
-/** Mutex protecting inactive_exch_list and avail_phone_cv.
+/** Mutex protecting async_sess_list.
  *
  */
 static FIBRIL_MUTEX_INITIALIZE(async_sess_mutex);
 
-/** List of all currently inactive exchanges.
+/** List of sessions which have connected parallel data phones.
+ *
+ * Inactive exchanges pooled in these sessions can be evicted when
+ * another session fails to connect a new data phone.
  *
  */
-static LIST_INITIALIZE(inactive_exch_list);
+static LIST_INITIALIZE(async_sess_list);
+
+/** Initial delay before retrying to connect a new data phone */
+#define ASYNC_EXCH_RETRY_MIN_USEC  1000
 
-/** Condition variable to wait for a phone to become available.
+/** Maximum delay before retrying to connect a new data phone */
+#define ASYNC_EXCH_RETRY_MAX_USEC  100000
+
+/** Initialize exchange management data of a session.
+ *
+ * @param sess Session.
  *
  */
-static FIBRIL_CONDVAR_INITIALIZE(avail_phone_cv);
+void async_sess_init(async_sess_t *sess)
+{
+	for (size_t i = 0; i < ASYNC_SESS_EXCH_SLOTS; i++)
+		atomic_init(&sess->exch_pool[i], NULL);
+
+	link_initialize(&sess->sess_link);
+	atomic_init(&sess->exchanges, 0);
+	atomic_init(&sess->exch_waiters, 0);
+
+	fibril_mutex_initialize(&sess->exch_mutex);
+	fibril_condvar_initialize(&sess->exch_avail_cv);
+
+	fibril_mutex_initialize(&sess->remote_state_mtx);
+	fibril_mutex_initialize(&sess->mutex);
+}
 
 /** Initialize the async framework.
  *
@@ -182,12 +210,9 @@ void __async_client_init(void)
 	session_ns.arg2 = 0;
 	session_ns.arg3 = 0;
 
-	fibril_mutex_initialize(&session_ns.remote_state_mtx);
 	session_ns.remote_state_data = NULL;
 
-	list_initialize(&session_ns.exch_list);
-	fibril_mutex_initialize(&session_ns.mutex);
-	session_ns.exchanges = 0;
+	async_sess_init(&session_ns);
 }
 
 void __async_client_fini(void)
@@ -227,6 +252,8 @@ void async_reply_received(ipc_call_t *data)
 		amsg_destroy(msg);
 	} else {
 		fibril_notify(&msg->received);
+		if (msg->notify != NULL)
+			fibril_notify(msg->notify);
 	}
 
 	fibril_rmutex_unlock(&message_mutex);
@@ -405,12 +432,60 @@ void async_forget(aid_t amsgid)
 		amsg_destroy(msg);
 	} else {
 		msg->dataptr = NULL;
+		msg->notify = NULL;
 		msg->forget = true;
 	}
 
 	fibril_rmutex_unlock(&message_mutex);
 }
 
+/** Request notification of an event when the reply to a message arrives.
+ *
+ * This allows a single fibril to wait for replies to many messages at
+ * once. The event is notified in addition to the normal wakeup of
+ * async_wait_for(), or immediately if the reply has already arrived.
+ * The reply still needs to be collected using async_wait_for() or
+ * discarded using async_forget().
+ *
+ * @param amsgid Hash of the message.
+ * @param event  Event to notify.
+ */
+void async_reply_notify(aid_t amsgid, fibril_event_t *event)
+{
+	assert(amsgid != 0);
+
+	amsg_t *msg = (amsg_t *) amsgid;
+
+	fibril_rmutex_lock(&message_mutex);
+
+	if (msg->done)
+		fibril_notify(event);
+	else
+		msg->notify = event;
+
+	fibril_rmutex_unlock(&message_mutex);
+}
+
+/** Determine whether the reply to a message has arrived.
+ *
+ * @param amsgid Hash of the message.
+ *
+ * @return True if async_wait_for() would not block.
+ */
+bool async_reply_done(aid_t amsgid)
+{
+	if (amsgid == 0)
+		return true;
+
+	amsg_t *msg = (amsg_t *) amsgid;
+
+	fibril_rmutex_lock(&message_mutex);
+	bool done = msg->done;
+	fibril_rmutex_unlock(&message_mutex);
+
+	return done;
+}
+
 /** Pseudo-synchronous message sending - fast version.
  *
  * Send message asynchronously and return only after the reply arrives.
@@ -633,9 +708,7 @@ async_sess_t *async_connect_me_to(async_exch_t *exch, iface_t iface,
 	sess->arg2 = arg2;
 	sess->arg3 = arg3;
 
-	fibril_mutex_initialize(&sess->remote_state_mtx);
-	list_initialize(&sess->exch_list);
-	fibril_mutex_initialize(&sess->mutex);
+	async_sess_init(sess);
 
 	return sess;
 }
@@ -701,9 +774,7 @@ async_sess_t *async_connect_me_to_blocking(async_exch_t *exch, iface_t iface,
 	sess->arg2 = arg2;
 	sess->arg3 = arg3;
 
-	fibril_mutex_initialize(&sess->remote_state_mtx);
-	list_initialize(&sess->exch_list);
-	fibril_mutex_initialize(&sess->mutex);
+	async_sess_init(sess);
 
 	return sess;
 }
@@ -731,9 +802,7 @@ async_sess_t *async_connect_kbox(task_id_t id)
 	sess->mgmt = EXCHANGE_ATOMIC;
 	sess->phone = phone;
 
-	fibril_mutex_initialize(&sess->remote_state_mtx);
-	list_initialize(&sess->exch_list);
-	fibril_mutex_initialize(&sess->mutex);
+	async_sess_init(sess);
 
 	return sess;
 }
@@ -743,6 +812,187 @@ static errno_t async_hangup_internal(cap_phone_handle_t phone)
 	return ipc_hangup(phone);
 }
 
+/** Take an inactive exchange from the session pool.
+ *
+ * @param sess Session.
+ *
+ * @return Inactive exchange or NULL if the pool is empty.
+ *
+ */
+static async_exch_t *async_exch_pool_get(async_sess_t *sess)
+{
+	for (size_t i = 0; i < ASYNC_SESS_EXCH_SLOTS; i++) {
+		if (atomic_load(&sess->exch_pool[i]) == NULL)
+			continue;
+
+		async_exch_t *exch = atomic_exchange(&sess->exch_pool[i],
+		    NULL);
+		if (exch != NULL)
+			return exch;
+	}
+
+	return NULL;
+}
+
+/** Return an inactive exchange into the session pool.
+ *
+ * @param sess Session.
+ * @param exch Inactive exchange.
+ *
+ * @return True if the exchange was stored, false if the pool is full.
+ *
+ */
+static bool async_exch_pool_put(async_sess_t *sess, async_exch_t *exch)
+{
+	for (size_t i = 0; i < ASYNC_SESS_EXCH_SLOTS; i++) {
+		async_exch_t *expected = NULL;
+
+		if (atomic_compare_exchange_strong(&sess->exch_pool[i],
+		    &expected, exch))
+			return true;
+	}
+
+	return false;
+}
+
+/** Destroy an inactive exchange.
+ *
+ * Parallel exchanges own their data phone which is hung up.
+ *
+ * @param sess Session.
+ * @param exch Inactive exchange.
+ *
+ */
+static void async_exch_destroy(async_sess_t *sess, async_exch_t *exch)
+{
+	if (exch->phone != sess->phone)
+		async_hangup_internal(exch->phone);
+
+	free(exch);
+}
+
+/** Create a new exchange.
+ *
+ * @param sess  Session.
+ * @param phone Phone used by the exchange.
+ *
+ * @return New exchange or NULL if out of memory.
+ *
+ */
+static async_exch_t *async_exch_create(async_sess_t *sess,
+    cap_phone_handle_t phone)
+{
+	async_exch_t *exch = (async_exch_t *) malloc(sizeof(async_exch_t));
+	if (exch == NULL)
+		return NULL;
+
+	exch->sess = sess;
+	exch->phone = phone;
+	return exch;
+}
+
+/** Register a session as an owner of parallel data phones.
+ *
+ * @param sess Session.
+ *
+ */
+static void async_sess_register(async_sess_t *sess)
+{
+	fibril_mutex_lock(&async_sess_mutex);
+
+	if (!link_in_use(&sess->sess_link))
+		list_append(&sess->sess_link, &async_sess_list);
+
+	fibril_mutex_unlock(&async_sess_mutex);
+}
+
+/** Unregister a session before it is destroyed.
+ *
+ * @param sess Session.
+ *
+ */
+static void async_sess_unregister(async_sess_t *sess)
+{
+	fibril_mutex_lock(&async_sess_mutex);
+
+	if (link_in_use(&sess->sess_link))
+		list_remove(&sess->sess_link);
+
+	fibril_mutex_unlock(&async_sess_mutex);
+}
+
+/** Evict an inactive exchange from another session.
+ *
+ * Hang up the data phone of an inactive parallel exchange pooled in a
+ * session other than @a sess, so that a new data phone can be connected.
+ * The session which lost the exchange is moved to the end of the list
+ * so that the evictions are spread among the sessions.
+ *
+ * @param sess Session which needs a new data phone.
+ *
+ * @return True if an exchange was evicted.
+ *
+ */
+static bool async_exch_evict(async_sess_t *sess)
+{
+	bool evicted = false;
+
+	fibril_mutex_lock(&async_sess_mutex);
+
+	list_foreach(async_sess_list, sess_link, async_sess_t, other) {
+		if (other == sess)
+			continue;
+
+		async_exch_t *exch = async_exch_pool_get(other);
+		if (exch == NULL)
+			continue;
+
+		async_exch_destroy(other, exch);
+
+		list_remove(&other->sess_link);
+		list_append(&other->sess_link, &async_sess_list);
+
+		evicted = true;
+		break;
+	}
+
+	fibril_mutex_unlock(&async_sess_mutex);
+
+	return evicted;
+}
+
+/** Wait for an exchange of the session to become inactive.
+ *
+ * @param sess Session.
+ *
+ * @return Inactive exchange or NULL if there are no active exchanges
+ *         in the session which could be waited for.
+ *
+ */
+static async_exch_t *async_exch_wait(async_sess_t *sess)
+{
+	async_exch_t *exch;
+
+	fibril_mutex_lock(&sess->exch_mutex);
+	atomic_fetch_add(&sess->exch_waiters, 1);
+
+	while (true) {
+		exch = async_exch_pool_get(sess);
+		if (exch != NULL)
+			break;
+
+		if (atomic_load(&sess->exchanges) == 0)
+			break;
+
+		fibril_condvar_wait(&sess->exch_avail_cv, &sess->exch_mutex);
+	}
+
+	atomic_fetch_sub(&sess->exch_waiters, 1);
+	fibril_mutex_unlock(&sess->exch_mutex);
+
+	return exch;
+}
+
 /** Wrapper for ipc_hangup.
  *
  * @param sess Session to hung up.
@@ -756,34 +1006,28 @@ errno_t async_hangup(async_sess_t *sess)
 
 	assert(sess);
 
-	fibril_mutex_lock(&async_sess_mutex);
-
-	if (sess->exchanges > 0) {
-		fibril_mutex_unlock(&async_sess_mutex);
+	if (atomic_load(&sess->exchanges) > 0)
 		return EBUSY;
-	}
 
-	errno_t rc = async_hangup_internal(sess->phone);
+	async_sess_unregister(sess);
 
-	while (!list_empty(&sess->exch_list)) {
-		exch = (async_exch_t *)
-		    list_get_instance(list_first(&sess->exch_list),
-		    async_exch_t, sess_link);
+	errno_t rc = async_hangup_internal(sess->phone);
 
-		list_remove(&exch->sess_link);
-		list_remove(&exch->global_link);
-		async_hangup_internal(exch->phone);
-		free(exch);
-	}
+	while ((exch = async_exch_pool_get(sess)) != NULL)
+		async_exch_destroy(sess, exch);
 
 	free(sess);
 
-	fibril_mutex_unlock(&async_sess_mutex);
-
 	return rc;
 }
 
 /** Start new exchange in a session.
+ *
+ * Inactive exchanges are taken from the per-session pool without any
+ * locking. Only if the pool is empty and no new data phone can be
+ * connected for a parallel exchange, an inactive exchange of another
+ * session is evicted to free a phone, or the caller waits for another
+ * exchange of the same session to finish.
  *
  * @param session Session.
  *
@@ -799,90 +1043,80 @@ async_exch_t *async_exchange_begin(async_sess_t *sess)
 	if (sess->iface != 0)
 		mgmt = sess->iface & IFACE_EXCHANGE_MASK;
 
-	async_exch_t *exch = NULL;
-
-	fibril_mutex_lock(&async_sess_mutex);
-
-	if (!list_empty(&sess->exch_list)) {
-		/*
-		 * There are inactive exchanges in the session.
-		 */
-		exch = (async_exch_t *)
-		    list_get_instance(list_first(&sess->exch_list),
-		    async_exch_t, sess_link);
+	async_exch_t *exch = async_exch_pool_get(sess);
 
-		list_remove(&exch->sess_link);
-		list_remove(&exch->global_link);
-	} else {
+	if (exch == NULL) {
 		/*
-		 * There are no available exchanges in the session.
+		 * There are no inactive exchanges in the session.
 		 */
 
 		if ((mgmt == EXCHANGE_ATOMIC) ||
 		    (mgmt == EXCHANGE_SERIALIZE)) {
-			exch = (async_exch_t *) malloc(sizeof(async_exch_t));
-			if (exch != NULL) {
-				link_initialize(&exch->sess_link);
-				link_initialize(&exch->global_link);
-				exch->sess = sess;
-				exch->phone = sess->phone;
-			}
+			exch = async_exch_create(sess, sess->phone);
 		} else if (mgmt == EXCHANGE_PARALLEL) {
+			usec_t delay = ASYNC_EXCH_RETRY_MIN_USEC;
 			cap_phone_handle_t phone;
 			errno_t rc;
 
-		retry:
-			/*
-			 * Make a one-time attempt to connect a new data phone.
-			 */
-			rc = async_connect_me_to_internal(sess->phone, sess->arg1,
-			    sess->arg2, sess->arg3, 0, &phone);
-			if (rc == EOK) {
-				exch = (async_exch_t *) malloc(sizeof(async_exch_t));
-				if (exch != NULL) {
-					link_initialize(&exch->sess_link);
-					link_initialize(&exch->global_link);
-					exch->sess = sess;
-					exch->phone = phone;
-				} else
-					async_hangup_internal(phone);
-			} else if (!list_empty(&inactive_exch_list)) {
+			while (exch == NULL) {
+				/*
+				 * Make an attempt to connect a new data phone.
+				 */
+				rc = async_connect_me_to_internal(sess->phone,
+				    sess->arg1, sess->arg2, sess->arg3, 0, &phone);
+				if (rc == EOK) {
+					exch = async_exch_create(sess, phone);
+					if (exch == NULL)
+						async_hangup_internal(phone);
+					else
+						async_sess_register(sess);
+					break;
+				}
+
 				/*
 				 * We did not manage to connect a new phone. But we
 				 * can try to close some of the currently inactive
 				 * connections in other sessions and try again.
 				 */
-				exch = (async_exch_t *)
-				    list_get_instance(list_first(&inactive_exch_list),
-				    async_exch_t, global_link);
-
-				list_remove(&exch->sess_link);
-				list_remove(&exch->global_link);
-				async_hangup_internal(exch->phone);
-				free(exch);
-				goto retry;
-			} else {
+				if (async_exch_evict(sess))
+					continue;
+
+				/*
+				 * Wait for another exchange in this session
+				 * to finish so that we can reuse its phone.
+				 */
+				exch = async_exch_wait(sess);
+				if (exch != NULL)
+					break;
+
 				/*
-				 * Wait for a phone to become available.
+				 * There is nothing to wait for in this session.
+				 * Back off and retry in hope that other sessions
+				 * release some of their phones.
 				 */
-				fibril_condvar_wait(&avail_phone_cv, &async_sess_mutex);
-				goto retry;
+				fibril_usleep(delay);
+				if (delay < ASYNC_EXCH_RETRY_MAX_USEC)
+					delay *= 2;
 			}
 		}
 	}
 
-	if (exch != NULL)
-		sess->exchanges++;
+	if (exch == NULL)
+		return NULL;
 
-	fibril_mutex_unlock(&async_sess_mutex);
+	atomic_fetch_add(&sess->exchanges, 1);
 
-	if (exch != NULL && mgmt == EXCHANGE_SERIALIZE)
+	if (mgmt == EXCHANGE_SERIALIZE)
 		fibril_mutex_lock(&sess->mutex);
 
 	return exch;
 }
 
 /** Finish an exchange.
+ *
+ * The exchange is returned into the per-session pool. If the pool is
+ * full, the exchange is destroyed instead, so that idle sessions do not
+ * hold on to more than ASYNC_SESS_EXCH_SLOTS data phones.
  *
  * @param exch Exchange to finish.
  *
@@ -902,15 +1136,16 @@ void async_exchange_end(async_exch_t *exch)
 	if (mgmt == EXCHANGE_SERIALIZE)
 		fibril_mutex_unlock(&sess->mutex);
 
-	fibril_mutex_lock(&async_sess_mutex);
-
-	sess->exchanges--;
+	if (!async_exch_pool_put(sess, exch))
+		async_exch_destroy(sess, exch);
 
-	list_append(&exch->sess_link, &sess->exch_list);
-	list_append(&exch->global_link, &inactive_exch_list);
-	fibril_condvar_signal(&avail_phone_cv);
+	atomic_fetch_sub(&sess->exchanges, 1);
 
-	fibril_mutex_unlock(&async_sess_mutex);
+	if (atomic_load(&sess->exch_waiters) > 0) {
+		fibril_mutex_lock(&sess->exch_mutex);
+		fibril_condvar_broadcast(&sess->exch_avail_cv);
+		fibril_mutex_unlock(&sess->exch_mutex);
+	}
 }
 
 /** Wrapper for IPC_M_SHARE_IN calls using the async framework.
@@ -997,6 +1232,26 @@ errno_t async_data_read_start(async_exch_t *exch, void *dst, size_t size)
 	    (sysarg_t) size);
 }
 
+/** Wrapper for IPC_M_DATA_WRITE calls using the async framework.
+ *
+ * Unlike async_data_write_start(), this does not wait for the transfer
+ * to finish.
+ *
+ * @param exch    Exchange for sending the message.
+ * @param src     Address of the beginning of the source buffer.
+ * @param size    Size of the source buffer.
+ * @param dataptr If non-NULL, storage where the reply data will be stored.
+ *
+ * @return Hash of the sent message or 0 on error.
+ *
+ */
+aid_t async_data_write(async_exch_t *exch, const void *src, size_t size,
+    ipc_call_t *dataptr)
+{
+	return async_send_2(exch, IPC_M_DATA_WRITE, (sysarg_t) src,
+	    (sysarg_t) size, dataptr);
+}
+
 /** Wrapper for IPC_M_DATA_WRITE calls using the async framework.
  *
  * @param exch Exchange for sending the message.
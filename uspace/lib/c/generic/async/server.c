@@ -1565,9 +1565,7 @@ async_sess_t *async_callback_receive(exch_mgmt_t mgmt)
 	sess->mgmt = mgmt;
 	sess->phone = phandle;
 
-	fibril_mutex_initialize(&sess->remote_state_mtx);
-	list_initialize(&sess->exch_list);
-	fibril_mutex_initialize(&sess->mutex);
+	async_sess_init(sess);
 
 	/* Acknowledge the connected phone */
 	async_answer_0(&call, EOK);
@@ -1605,9 +1603,7 @@ async_sess_t *async_callback_receive_start(exch_mgmt_t mgmt, ipc_call_t *call)
 	sess->mgmt = mgmt;
 	sess->phone = phandle;
 
-	fibril_mutex_initialize(&sess->remote_state_mtx);
-	list_initialize(&sess->exch_list);
-	fibril_mutex_initialize(&sess->mutex);
+	async_sess_init(sess);
 
 	return sess;
 }
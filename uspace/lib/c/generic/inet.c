@@ -114,8 +114,8 @@ errno_t inet_send(inet_dgram_t *dgram, uint8_t ttl, inet_df_t df)
 	async_exch_t *exch = async_exchange_begin(inet_sess);
 
 	ipc_call_t answer;
-	aid_t req = async_send_4(exch, INET_SEND, dgram->iplink, dgram->tos,
-	    ttl, df, &answer);
+	aid_t req = async_send_5(exch, INET_SEND, dgram->iplink, dgram->tos,
+	    ttl, df, dgram->csum_offs, &answer);
 
 	errno_t rc = async_data_write_start(exch, &dgram->src, sizeof(inet_addr_t));
 	if (rc != EOK) {
@@ -181,6 +181,7 @@ static void inet_ev_recv(ipc_call_t *icall)
 
 	dgram.tos = IPC_GET_ARG1(*icall);
 	dgram.iplink = IPC_GET_ARG2(*icall);
+	dgram.csum_offs = 0;
 
 	ipc_call_t call;
 	size_t size;
@@ -0,0 +1,396 @@
+/*
+ * Copyright (c) 2019 Jiri Svoboda
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * - Redistributions of source code must retain the above copyright
+ *   notice, this list of conditions and the following disclaimer.
+ * - Redistributions in binary form must reproduce the above copyright
+ *   notice, this list of conditions and the following disclaimer in the
+ *   documentation and/or other materials provided with the distribution.
+ * - The name of the author may not be used to endorse or promote products
+ *   derived from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHOR ``AS IS'' AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+ * OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+ * IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT
+ * NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF
+ * THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/** @addtogroup libc
+ * @{
+ */
+/** @file Packet buffers
+ *
+ * Packet buffers let the layers of a network stack hand one packet from
+ * one to another without copying it. Each buffer reserves headroom in front
+ * of the packet data, so that a lower layer can prepend its header in place,
+ * and an upper layer consumes a received packet by pulling the lower-layer
+ * headers off the front. Buffers are reference-counted and recycled
+ * through a pool, so that steady-state packet processing does not need to
+ * touch the heap.
+ */
+
+#include <assert.h>
+#include <async.h>
+#include <errno.h>
+#include <inet/pbuf.h>
+#include <mem.h>
+#include <stdlib.h>
+
+/** Initialize packet buffer for (re)use.
+ *
+ * @param pbuf     Packet buffer
+ * @param headroom Headroom to reserve in front of packet data
+ */
+static void pbuf_reset(pbuf_t *pbuf, size_t headroom)
+{
+	assert(headroom <= pbuf->bsize);
+
+	refcount_init(&pbuf->refcnt);
+	pbuf->offs = headroom;
+	pbuf->size = 0;
+}
+
+/** Create packet buffer pool.
+ *
+ * @param count    Number of buffers in the pool
+ * @param bsize    Size of each buffer's storage area (including headroom)
+ * @param headroom Headroom to reserve in each allocated buffer
+ * @param rpool    Place to store pointer to new pool
+ *
+ * @return EOK on success, EINVAL if @a headroom exceeds @a bsize,
+ *         ENOMEM if out of memory
+ */
+errno_t pbuf_pool_create(size_t count, size_t bsize, size_t headroom,
+    pbuf_pool_t **rpool)
+{
+	pbuf_pool_t *pool;
+	size_t i;
+
+	if (headroom > bsize)
+		return EINVAL;
+
+	pool = calloc(1, sizeof(pbuf_pool_t));
+	if (pool == NULL)
+		return ENOMEM;
+
+	pool->pbufs = calloc(count, sizeof(pbuf_t));
+	pool->storage = malloc(count * bsize);
+	if (pool->pbufs == NULL || pool->storage == NULL) {
+		free(pool->pbufs);
+		free(pool->storage);
+		free(pool);
+		return ENOMEM;
+	}
+
+	fibril_mutex_initialize(&pool->lock);
+	list_initialize(&pool->free);
+	pool->count = count;
+	pool->bsize = bsize;
+	pool->headroom = headroom;
+
+	for (i = 0; i < count; i++) {
+		pool->pbufs[i].pool = pool;
+		pool->pbufs[i].buf = pool->storage + i * bsize;
+		pool->pbufs[i].bsize = bsize;
+		list_append(&pool->pbufs[i].lfree, &pool->free);
+	}
+
+	*rpool = pool;
+	return EOK;
+}
+
+/** Destroy packet buffer pool.
+ *
+ * All buffers allocated from the pool must have been released.
+ *
+ * @param pool Packet buffer pool or @c NULL
+ */
+void pbuf_pool_destroy(pbuf_pool_t *pool)
+{
+	if (pool == NULL)
+		return;
+
+	assert(list_count(&pool->free) == pool->count);
+
+	free(pool->pbufs);
+	free(pool->storage);
+	free(pool);
+}
+
+/** Allocate packet buffer.
+ *
+ * The new buffer is empty, has the pool's headroom reserved and holds
+ * one reference, which the caller must eventually drop using
+ * pbuf_release(). If the pool is exhausted, the buffer is allocated
+ * from the heap instead so that a burst of traffic does not cause
+ * packets to be dropped.
+ *
+ * @param pool  Packet buffer pool
+ * @param rpbuf Place to store pointer to new packet buffer
+ *
+ * @return EOK on success, ENOMEM if out of memory
+ */
+errno_t pbuf_alloc(pbuf_pool_t *pool, pbuf_t **rpbuf)
+{
+	pbuf_t *pbuf;
+	link_t *link;
+
+	fibril_mutex_lock(&pool->lock);
+	link = list_first(&pool->free);
+	if (link != NULL)
+		list_remove(link);
+	fibril_mutex_unlock(&pool->lock);
+
+	if (link != NULL) {
+		pbuf = list_get_instance(link, pbuf_t, lfree);
+	} else {
+		pbuf = malloc(sizeof(pbuf_t) + pool->bsize);
+		if (pbuf == NULL)
+			return ENOMEM;
+
+		pbuf->pool = NULL;
+		link_initialize(&pbuf->lfree);
+		pbuf->buf = (uint8_t *) (pbuf + 1);
+		pbuf->bsize = pool->bsize;
+	}
+
+	pbuf_reset(pbuf, pool->headroom);
+	*rpbuf = pbuf;
+	return EOK;
+}
+
+/** Add reference to packet buffer.
+ *
+ * @param pbuf Packet buffer
+ */
+void pbuf_ref(pbuf_t *pbuf)
+{
+	refcount_up(&pbuf->refcnt);
+}
+
+/** Drop reference to packet buffer.
+ *
+ * When the last reference is dropped, the buffer is returned to its
+ * pool (or freed if it did not come from one).
+ *
+ * @param pbuf Packet buffer or @c NULL
+ */
+void pbuf_release(pbuf_t *pbuf)
+{
+	pbuf_pool_t *pool;
+
+	if (pbuf == NULL)
+		return;
+
+	if (!refcount_down(&pbuf->refcnt))
+		return;
+
+	pool = pbuf->pool;
+	if (pool == NULL) {
+		free(pbuf);
+		return;
+	}
+
+	fibril_mutex_lock(&pool->lock);
+	list_prepend(&pbuf->lfree, &pool->free);
+	fibril_mutex_unlock(&pool->lock);
+}
+
+/** Get pointer to packet data.
+ *
+ * @param pbuf Packet buffer
+ * @return Pointer to first byte of packet data
+ */
+void *pbuf_data(pbuf_t *pbuf)
+{
+	return pbuf->buf + pbuf->offs;
+}
+
+/** Get size of packet data.
+ *
+ * @param pbuf Packet buffer
+ * @return Size of packet data in bytes
+ */
+size_t pbuf_size(pbuf_t *pbuf)
+{
+	return pbuf->size;
+}
+
+/** Get amount of free space in front of packet data.
+ *
+ * @param pbuf Packet buffer
+ * @return Headroom in bytes
+ */
+size_t pbuf_headroom(pbuf_t *pbuf)
+{
+	return pbuf->offs;
+}
+
+/** Get amount of free space after packet data.
+ *
+ * @param pbuf Packet buffer
+ * @return Tailroom in bytes
+ */
+size_t pbuf_tailroom(pbuf_t *pbuf)
+{
+	return pbuf->bsize - pbuf->offs - pbuf->size;
+}
+
+/** Prepend space for a header to packet data.
+ *
+ * @param pbuf Packet buffer
+ * @param size Number of bytes to prepend
+ * @return Pointer to the new start of packet data or @c NULL if there
+ *         is not enough headroom
+ */
+void *pbuf_push(pbuf_t *pbuf, size_t size)
+{
+	if (size > pbuf->offs)
+		return NULL;
+
+	pbuf->offs -= size;
+	pbuf->size += size;
+	return pbuf->buf + pbuf->offs;
+}
+
+/** Remove a header from the start of packet data.
+ *
+ * @param pbuf Packet buffer
+ * @param size Number of bytes to remove
+ * @return Pointer to the removed header or @c NULL if the packet is
+ *         shorter than @a size
+ */
+void *pbuf_pull(pbuf_t *pbuf, size_t size)
+{
+	void *hdr;
+
+	if (size > pbuf->size)
+		return NULL;
+
+	hdr = pbuf->buf + pbuf->offs;
+	pbuf->offs += size;
+	pbuf->size -= size;
+	return hdr;
+}
+
+/** Append space to the end of packet data.
+ *
+ * @param pbuf Packet buffer
+ * @param size Number of bytes to append
+ * @return Pointer to the appended space or @c NULL if there is not enough
+ *         tailroom
+ */
+void *pbuf_put(pbuf_t *pbuf, size_t size)
+{
+	void *tail;
+
+	if (size > pbuf_tailroom(pbuf))
+		return NULL;
+
+	tail = pbuf->buf + pbuf->offs + pbuf->size;
+	pbuf->size += size;
+	return tail;
+}
+
+/** Truncate packet data.
+ *
+ * @param pbuf Packet buffer
+ * @param size New size of packet data, must not exceed the current size
+ */
+void pbuf_trim(pbuf_t *pbuf, size_t size)
+{
+	assert(size <= pbuf->size);
+	pbuf->size = size;
+}
+
+/** Receive data written by the client into a packet buffer.
+ *
+ * Accept an IPC_M_DATA_WRITE and store the data into a buffer allocated
+ * from @a pool, so that protocol headers can be stripped or prepended
+ * without copying. Data which does not fit into a packet buffer, or any
+ * data if @a pool is @c NULL, are stored into a block allocated from the
+ * heap instead. Release the data with pbuf_data_free().
+ *
+ * @param pool  Packet buffer pool or @c NULL
+ * @param rdata Place to store pointer to the data
+ * @param rsize Place to store size of the data
+ * @param rpbuf Place to store packet buffer holding the data or @c NULL
+ *              if the data were allocated from the heap
+ * @return EOK on success or an error code
+ */
+errno_t pbuf_data_write_receive(pbuf_pool_t *pool, void **rdata,
+    size_t *rsize, pbuf_t **rpbuf)
+{
+	ipc_call_t call;
+	pbuf_t *pbuf;
+	size_t size;
+	void *data;
+	errno_t rc;
+
+	if (pool == NULL) {
+		*rpbuf = NULL;
+		return async_data_write_accept(rdata, false, 0, 0, 0, rsize);
+	}
+
+	if (!async_data_write_receive(&call, &size)) {
+		async_answer_0(&call, EREFUSED);
+		return EREFUSED;
+	}
+
+	rc = pbuf_alloc(pool, &pbuf);
+	if (rc != EOK) {
+		async_answer_0(&call, rc);
+		return rc;
+	}
+
+	data = pbuf_put(pbuf, size);
+	if (data == NULL) {
+		/* Does not fit into a packet buffer */
+		pbuf_release(pbuf);
+		pbuf = NULL;
+
+		data = malloc(size);
+		if (data == NULL) {
+			async_answer_0(&call, ENOMEM);
+			return ENOMEM;
+		}
+	}
+
+	rc = async_data_write_finalize(&call, data, size);
+	if (rc != EOK) {
+		pbuf_data_free(data, pbuf);
+		return rc;
+	}
+
+	*rdata = data;
+	*rsize = size;
+	*rpbuf = pbuf;
+	return EOK;
+}
+
+/** Free data received by pbuf_data_write_receive().
+ *
+ * @param data Data
+ * @param pbuf Packet buffer holding the data or @c NULL
+ */
+void pbuf_data_free(void *data, pbuf_t *pbuf)
+{
+	if (pbuf != NULL)
+		pbuf_release(pbuf);
+	else
+		free(data);
+}
+
+/** @}
+ */
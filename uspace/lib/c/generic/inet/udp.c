@@ -38,8 +38,13 @@
 #include <ipc/services.h>
 #include <ipc/udp.h>
 #include <loc.h>
+#include <macros.h>
+#include <mem.h>
 #include <stdlib.h>
 
+/** Size of buffer for batched receiving of messages */
+#define UDP_RBUF_SIZE DATA_XFER_LIMIT
+
 static void udp_cb_conn(ipc_call_t *, void *);
 
 /** Create callback connection from UDP service.
@@ -133,6 +138,7 @@ void udp_destroy(udp_t *udp)
 		fibril_condvar_wait(&udp->cv, &udp->lock);
 	fibril_mutex_unlock(&udp->lock);
 
+	free(udp->rbuf);
 	free(udp);
 }
 
@@ -161,6 +167,30 @@ void udp_destroy(udp_t *udp)
  */
 errno_t udp_assoc_create(udp_t *udp, inet_ep2_t *epp, udp_cb_t *cb, void *arg,
     udp_assoc_t **rassoc)
+{
+	return udp_assoc_create_flags(udp, epp, 0, cb, arg, rassoc);
+}
+
+/** Create new UDP association with flags.
+ *
+ * Same as udp_assoc_create, but allows passing association flags.
+ * With @c udp_af_reuseport several associations (from one or more clients)
+ * may be created with the same endpoint pair as long as all of them set
+ * this flag. Incoming messages are then distributed among them based on
+ * the remote endpoint, so that all messages from one remote endpoint are
+ * delivered to the same association.
+ *
+ * @param udp    UDP client
+ * @param epp    Internet endpoint pair
+ * @param flags  Association flags
+ * @param cb     Callbacks
+ * @param arg    Argument to callbacks
+ * @param rassoc Place to store pointer to new association
+ *
+ * @return EOK on success or an error code.
+ */
+errno_t udp_assoc_create_flags(udp_t *udp, inet_ep2_t *epp,
+    udp_assoc_flags_t flags, udp_cb_t *cb, void *arg, udp_assoc_t **rassoc)
 {
 	async_exch_t *exch;
 	udp_assoc_t *assoc;
@@ -171,7 +201,7 @@ errno_t udp_assoc_create(udp_t *udp, inet_ep2_t *epp, udp_cb_t *cb, void *arg,
 		return ENOMEM;
 
 	exch = async_exchange_begin(udp->sess);
-	aid_t req = async_send_0(exch, UDP_ASSOC_CREATE, &answer);
+	aid_t req = async_send_1(exch, UDP_ASSOC_CREATE, flags, &answer);
 	errno_t rc = async_data_write_start(exch, (void *)epp,
 	    sizeof(inet_ep2_t));
 	async_exchange_end(exch);
@@ -284,6 +314,101 @@ errno_t udp_assoc_send_msg(udp_assoc_t *assoc, inet_ep_t *dest, void *data,
 	return rc;
 }
 
+/** Send a batch of messages via UDP association.
+ *
+ * Messages are packed together and passed to the UDP service in as few
+ * transfers as possible. Sending stops at the first message that fails.
+ *
+ * @param assoc Association
+ * @param msgs  Array of messages
+ * @param cnt   Number of messages in @a msgs
+ * @param rsent Place to store number of messages actually sent
+ *
+ * @return EOK if at least one message was sent (or @a cnt is zero),
+ *         otherwise an error code
+ */
+errno_t udp_assoc_send_msgs(udp_assoc_t *assoc, udp_smsg_t *msgs, size_t cnt,
+    size_t *rsent)
+{
+	async_exch_t *exch;
+	ipc_call_t answer;
+	udp_mrec_t *mrec;
+	uint8_t *buf;
+	size_t bsize;
+	size_t sent;
+	size_t i;
+	size_t n;
+	errno_t rc;
+
+	i = 0;
+	rc = EOK;
+
+	while (i < cnt) {
+		/* Determine how many messages fit in one transfer */
+		bsize = 0;
+		for (n = 0; i + n < cnt; n++) {
+			if (bsize + UDP_MREC_SIZE(msgs[i + n].size) >
+			    DATA_XFER_LIMIT)
+				break;
+			bsize += UDP_MREC_SIZE(msgs[i + n].size);
+		}
+
+		if (n == 0) {
+			/* Message too large to be batched */
+			rc = udp_assoc_send_msg(assoc, msgs[i].dest,
+			    msgs[i].data, msgs[i].size);
+			if (rc != EOK)
+				break;
+
+			++i;
+			continue;
+		}
+
+		buf = malloc(bsize);
+		if (buf == NULL) {
+			rc = ENOMEM;
+			break;
+		}
+
+		bsize = 0;
+		for (size_t j = 0; j < n; j++) {
+			mrec = (udp_mrec_t *) (buf + bsize);
+			memset(mrec, 0, sizeof(udp_mrec_t));
+			if (msgs[i + j].dest != NULL)
+				mrec->ep = *msgs[i + j].dest;
+			else
+				inet_ep_init(&mrec->ep);
+			mrec->size = msgs[i + j].size;
+			memcpy(mrec + 1, msgs[i + j].data, msgs[i + j].size);
+			bsize += UDP_MREC_SIZE(msgs[i + j].size);
+		}
+
+		exch = async_exchange_begin(assoc->udp->sess);
+		aid_t req = async_send_2(exch, UDP_ASSOC_SEND_MSGS, assoc->id,
+		    n, &answer);
+		rc = async_data_write_start(exch, buf, bsize);
+		async_exchange_end(exch);
+		free(buf);
+
+		if (rc != EOK) {
+			async_forget(req);
+			break;
+		}
+
+		async_wait_for(req, &rc);
+		if (rc != EOK)
+			break;
+
+		sent = IPC_GET_ARG1(answer);
+		i += sent;
+		if (sent < n)
+			break;
+	}
+
+	*rsent = i;
+	return i > 0 ? EOK : rc;
+}
+
 /** Get the user/callback argument for an association.
  *
  * @param assoc UDP association
@@ -322,6 +447,16 @@ errno_t udp_rmsg_read(udp_rmsg_t *rmsg, size_t off, void *buf, size_t bsize)
 	async_exch_t *exch;
 	ipc_call_t answer;
 
+	if (rmsg->data != NULL) {
+		/* Message was received as part of a batch */
+		if (off > rmsg->size)
+			return EINVAL;
+
+		memcpy(buf, (uint8_t *) rmsg->data + off,
+		    min(rmsg->size - off, bsize));
+		return EOK;
+	}
+
 	exch = async_exchange_begin(rmsg->udp->sess);
 	aid_t req = async_send_1(exch, UDP_RMSG_READ, off, &answer);
 	errno_t rc = async_data_read_start(exch, buf, bsize);
@@ -406,6 +541,7 @@ static errno_t udp_rmsg_info(udp_t *udp, udp_rmsg_t *rmsg)
 	rmsg->assoc_id = IPC_GET_ARG1(answer);
 	rmsg->size = IPC_GET_ARG2(answer);
 	rmsg->remote_ep = ep;
+	rmsg->data = NULL;
 	return EOK;
 }
 
@@ -445,10 +581,67 @@ static errno_t udp_assoc_get(udp_t *udp, sysarg_t id, udp_assoc_t **rassoc)
 	return EINVAL;
 }
 
+/** Read a batch of received messages from UDP service.
+ *
+ * As many received messages as fit in @a udp->rbuf are transferred
+ * and removed from the queue in UDP service.
+ *
+ * @param udp  UDP client
+ * @param rcnt Place to store number of messages read
+ *
+ * @return EOK on success, ENOENT if there are no messages, EOVERFLOW
+ *         if the next message does not fit in the buffer or an error code
+ */
+static errno_t udp_rmsg_read_msgs(udp_t *udp, size_t *rcnt)
+{
+	async_exch_t *exch;
+	ipc_call_t answer;
+
+	exch = async_exchange_begin(udp->sess);
+	aid_t req = async_send_0(exch, UDP_RMSG_READ_MSGS, &answer);
+	errno_t rc = async_data_read_start(exch, udp->rbuf, UDP_RBUF_SIZE);
+	async_exchange_end(exch);
+
+	if (rc != EOK) {
+		async_forget(req);
+		return rc;
+	}
+
+	errno_t retval;
+	async_wait_for(req, &retval);
+	if (retval != EOK)
+		return retval;
+
+	*rcnt = IPC_GET_ARG1(answer);
+	return EOK;
+}
+
+/** Deliver received message to association.
+ *
+ * @param udp  UDP client
+ * @param rmsg Received message
+ */
+static void udp_rmsg_deliver(udp_t *udp, udp_rmsg_t *rmsg)
+{
+	udp_assoc_t *assoc;
+	errno_t rc;
+
+	rc = udp_assoc_get(udp, rmsg->assoc_id, &assoc);
+	if (rc != EOK)
+		return;
+
+	if (assoc->cb != NULL && assoc->cb->recv_msg != NULL)
+		assoc->cb->recv_msg(assoc, rmsg);
+}
+
 /** Handle 'data' event, i.e. some message(s) arrived.
  *
- * For each received message, get information about it, call @c recv_msg
- * callback and discard it.
+ * Received messages are read from UDP service in batches and the
+ * @c recv_msg callback is called for each of them. A message which is too
+ * large to be batched is handled separately: we get information about it,
+ * call @c recv_msg callback (which reads the message data) and discard it.
+ * UDP only sends another event once we have found the queue empty or one
+ * of our requests has failed, so we keep reading until then.
  *
  * @param udp   UDP client
  * @param icall IPC message
@@ -457,22 +650,46 @@ static errno_t udp_assoc_get(udp_t *udp, sysarg_t id, udp_assoc_t **rassoc)
 static void udp_ev_data(udp_t *udp, ipc_call_t *icall)
 {
 	udp_rmsg_t rmsg;
-	udp_assoc_t *assoc;
+	udp_mrec_t *mrec;
+	size_t off;
+	size_t cnt;
 	errno_t rc;
 
+	if (udp->rbuf == NULL)
+		udp->rbuf = malloc(UDP_RBUF_SIZE);
+
 	while (true) {
-		rc = udp_rmsg_info(udp, &rmsg);
-		if (rc != EOK) {
-			break;
+		if (udp->rbuf != NULL) {
+			rc = udp_rmsg_read_msgs(udp, &cnt);
+			if (rc == EOK) {
+				off = 0;
+				while (cnt-- > 0) {
+					mrec = (udp_mrec_t *) ((uint8_t *)
+					    udp->rbuf + off);
+
+					rmsg.udp = udp;
+					rmsg.assoc_id = mrec->assoc_id;
+					rmsg.size = mrec->size;
+					rmsg.remote_ep = mrec->ep;
+					rmsg.data = mrec + 1;
+					udp_rmsg_deliver(udp, &rmsg);
+
+					off += UDP_MREC_SIZE(mrec->size);
+				}
+
+				continue;
+			}
+
+			if (rc != EOVERFLOW)
+				break;
 		}
 
-		rc = udp_assoc_get(udp, rmsg.assoc_id, &assoc);
+		rc = udp_rmsg_info(udp, &rmsg);
 		if (rc != EOK) {
-			continue;
+			break;
 		}
 
-		if (assoc->cb != NULL && assoc->cb->recv_msg != NULL)
-			assoc->cb->recv_msg(assoc, &rmsg);
+		udp_rmsg_deliver(udp, &rmsg);
 
 		rc = udp_rmsg_discard(udp);
 		if (rc != EOK) {
@@ -480,7 +697,11 @@ static void udp_ev_data(udp_t *udp, ipc_call_t *icall)
 		}
 	}
 
-	async_answer_0(icall, EOK);
+	/*
+	 * ENOENT means we have read all messages. On any other error UDP
+	 * sends the event again if some messages are left.
+	 */
+	async_answer_0(icall, rc == ENOENT ? EOK : rc);
 }
 
 /** UDP service callback connection.
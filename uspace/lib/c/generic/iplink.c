@@ -89,8 +89,8 @@ errno_t iplink_send(iplink_t *iplink, iplink_sdu_t *sdu)
 	async_exch_t *exch = async_exchange_begin(iplink->sess);
 
 	ipc_call_t answer;
-	aid_t req = async_send_2(exch, IPLINK_SEND, (sysarg_t) sdu->src,
-	    (sysarg_t) sdu->dest, &answer);
+	aid_t req = async_send_4(exch, IPLINK_SEND, (sysarg_t) sdu->src,
+	    (sysarg_t) sdu->dest, sdu->csum_start, sdu->csum_offs, &answer);
 
 	errno_t rc = async_data_write_start(exch, sdu->data, sdu->size);
 
@@ -112,7 +112,8 @@ errno_t iplink_send6(iplink_t *iplink, iplink_sdu6_t *sdu)
 	async_exch_t *exch = async_exchange_begin(iplink->sess);
 
 	ipc_call_t answer;
-	aid_t req = async_send_0(exch, IPLINK_SEND6, &answer);
+	aid_t req = async_send_2(exch, IPLINK_SEND6, sdu->csum_start,
+	    sdu->csum_offs, &answer);
 
 	errno_t rc = async_data_write_start(exch, &sdu->dest, sizeof(addr48_t));
 	if (rc != EOK) {
@@ -152,6 +153,50 @@ errno_t iplink_get_mtu(iplink_t *iplink, size_t *rmtu)
 	return EOK;
 }
 
+/** Get offload computations the link performs.
+ *
+ * @param iplink   IP link
+ * @param roffload Place to store IPLINK_OFFLOAD_* flags
+ * @return EOK on success or an error code
+ */
+errno_t iplink_get_offload(iplink_t *iplink, uint32_t *roffload)
+{
+	async_exch_t *exch = async_exchange_begin(iplink->sess);
+
+	sysarg_t offload;
+	errno_t rc = async_req_0_1(exch, IPLINK_GET_OFFLOAD, &offload);
+
+	async_exchange_end(exch);
+
+	if (rc != EOK)
+		return rc;
+
+	*roffload = offload;
+	return EOK;
+}
+
+errno_t iplink_get_nstats(iplink_t *iplink, inet_nstats_t *stats)
+{
+	async_exch_t *exch = async_exchange_begin(iplink->sess);
+
+	ipc_call_t answer;
+	aid_t req = async_send_0(exch, IPLINK_GET_NSTATS, &answer);
+
+	errno_t rc = async_data_read_start(exch, stats, sizeof(inet_nstats_t));
+
+	async_exchange_end(exch);
+
+	if (rc != EOK) {
+		async_forget(req);
+		return rc;
+	}
+
+	errno_t retval;
+	async_wait_for(req, &retval);
+
+	return retval;
+}
+
 errno_t iplink_get_mac48(iplink_t *iplink, addr48_t *mac)
 {
 	async_exch_t *exch = async_exchange_begin(iplink->sess);
@@ -261,6 +306,57 @@ static void iplink_ev_recv(iplink_t *iplink, ipc_call_t *icall)
 	async_answer_0(icall, rc);
 }
 
+static void iplink_ev_recv_batch(iplink_t *iplink, ipc_call_t *icall)
+{
+	ipc_iplink_recv_ent_t *ents;
+	iplink_recv_sdu_t sdu;
+	size_t count;
+	size_t esize;
+	size_t total;
+	size_t i;
+
+	count = IPC_GET_ARG1(*icall);
+	if (count == 0 || count > IPLINK_EV_RECV_BATCH_MAX) {
+		async_answer_0(icall, EINVAL);
+		return;
+	}
+
+	esize = count * sizeof(ipc_iplink_recv_ent_t);
+	errno_t rc = async_data_write_accept((void **) &ents, false, esize,
+	    esize, 0, NULL);
+	if (rc != EOK) {
+		async_answer_0(icall, rc);
+		return;
+	}
+
+	/* Reject empty SDUs and batches whose total size is out of bounds */
+	total = 0;
+	for (i = 0; i < count; i++) {
+		if (ents[i].size == 0 ||
+		    ents[i].size > IPLINK_EV_RECV_BATCH_SIZE_MAX - total) {
+			free(ents);
+			async_answer_0(icall, EINVAL);
+			return;
+		}
+
+		total += ents[i].size;
+	}
+
+	for (i = 0; i < count; i++) {
+		rc = async_data_write_accept(&sdu.data, false, ents[i].size,
+		    ents[i].size, 0, NULL);
+		if (rc != EOK)
+			break;
+
+		sdu.size = ents[i].size;
+		(void) iplink->ev_ops->recv(iplink, &sdu, ents[i].ver);
+		free(sdu.data);
+	}
+
+	free(ents);
+	async_answer_0(icall, rc);
+}
+
 static void iplink_ev_change_addr(iplink_t *iplink, ipc_call_t *icall)
 {
 	addr48_t *addr;
@@ -295,6 +391,9 @@ static void iplink_cb_conn(ipc_call_t *icall, void *arg)
 		case IPLINK_EV_RECV:
 			iplink_ev_recv(iplink, &call);
 			break;
+		case IPLINK_EV_RECV_BATCH:
+			iplink_ev_recv_batch(iplink, &call);
+			break;
 		case IPLINK_EV_CHANGE_ADDR:
 			iplink_ev_change_addr(iplink, &call);
 			break;
@@ -34,12 +34,15 @@
  * @brief IP link server stub
  */
 
+#include <assert.h>
 #include <errno.h>
 #include <ipc/iplink.h>
 #include <stdlib.h>
 #include <stddef.h>
+#include <mem.h>
 #include <inet/addr.h>
 #include <inet/iplink_srv.h>
+#include <inet/pbuf.h>
 
 static void iplink_get_mtu_srv(iplink_srv_t *srv, ipc_call_t *call)
 {
@@ -48,6 +51,53 @@ static void iplink_get_mtu_srv(iplink_srv_t *srv, ipc_call_t *call)
 	async_answer_1(call, rc, mtu);
 }
 
+static void iplink_get_offload_srv(iplink_srv_t *srv, ipc_call_t *call)
+{
+	uint32_t offload = 0;
+	errno_t rc = EOK;
+
+	if (srv->ops->get_offload != NULL)
+		rc = srv->ops->get_offload(srv, &offload);
+	async_answer_1(call, rc, offload);
+}
+
+static void iplink_get_nstats_srv(iplink_srv_t *srv, ipc_call_t *icall)
+{
+	inet_nstats_t stats;
+	errno_t rc;
+
+	if (srv->ops->get_nstats == NULL) {
+		async_answer_0(icall, ENOTSUP);
+		return;
+	}
+
+	rc = srv->ops->get_nstats(srv, &stats);
+	if (rc != EOK) {
+		async_answer_0(icall, rc);
+		return;
+	}
+
+	ipc_call_t call;
+	size_t size;
+	if (!async_data_read_receive(&call, &size)) {
+		async_answer_0(&call, EREFUSED);
+		async_answer_0(icall, EREFUSED);
+		return;
+	}
+
+	if (size != sizeof(inet_nstats_t)) {
+		async_answer_0(&call, EINVAL);
+		async_answer_0(icall, EINVAL);
+		return;
+	}
+
+	rc = async_data_read_finalize(&call, &stats, size);
+	if (rc != EOK)
+		async_answer_0(&call, rc);
+
+	async_answer_0(icall, rc);
+}
+
 static void iplink_get_mac48_srv(iplink_srv_t *srv, ipc_call_t *icall)
 {
 	addr48_t mac;
@@ -163,16 +213,18 @@ static void iplink_send_srv(iplink_srv_t *srv, ipc_call_t *icall)
 
 	sdu.src = IPC_GET_ARG1(*icall);
 	sdu.dest = IPC_GET_ARG2(*icall);
+	sdu.csum_start = IPC_GET_ARG3(*icall);
+	sdu.csum_offs = IPC_GET_ARG4(*icall);
 
-	errno_t rc = async_data_write_accept(&sdu.data, false, 0, 0, 0,
-	    &sdu.size);
+	errno_t rc = pbuf_data_write_receive(srv->pool, &sdu.data, &sdu.size,
+	    &sdu.pbuf);
 	if (rc != EOK) {
 		async_answer_0(icall, rc);
 		return;
 	}
 
 	rc = srv->ops->send(srv, &sdu);
-	free(sdu.data);
+	pbuf_data_free(sdu.data, sdu.pbuf);
 	async_answer_0(icall, rc);
 }
 
@@ -180,6 +232,9 @@ static void iplink_send6_srv(iplink_srv_t *srv, ipc_call_t *icall)
 {
 	iplink_sdu6_t sdu;
 
+	sdu.csum_start = IPC_GET_ARG1(*icall);
+	sdu.csum_offs = IPC_GET_ARG2(*icall);
+
 	ipc_call_t call;
 	size_t size;
 	if (!async_data_write_receive(&call, &size)) {
@@ -200,15 +255,15 @@ static void iplink_send6_srv(iplink_srv_t *srv, ipc_call_t *icall)
 		async_answer_0(icall, rc);
 	}
 
-	rc = async_data_write_accept(&sdu.data, false, 0, 0, 0,
-	    &sdu.size);
+	rc = pbuf_data_write_receive(srv->pool, &sdu.data, &sdu.size,
+	    &sdu.pbuf);
 	if (rc != EOK) {
 		async_answer_0(icall, rc);
 		return;
 	}
 
 	rc = srv->ops->send6(srv, &sdu);
-	free(sdu.data);
+	pbuf_data_free(sdu.data, sdu.pbuf);
 	async_answer_0(icall, rc);
 }
 
@@ -219,6 +274,7 @@ void iplink_srv_init(iplink_srv_t *srv)
 	srv->ops = NULL;
 	srv->arg = NULL;
 	srv->client_sess = NULL;
+	srv->pool = NULL;
 }
 
 errno_t iplink_conn(ipc_call_t *icall, void *arg)
@@ -285,6 +341,12 @@ errno_t iplink_conn(ipc_call_t *icall, void *arg)
 		case IPLINK_ADDR_REMOVE:
 			iplink_addr_remove_srv(srv, &call);
 			break;
+		case IPLINK_GET_OFFLOAD:
+			iplink_get_offload_srv(srv, &call);
+			break;
+		case IPLINK_GET_NSTATS:
+			iplink_get_nstats_srv(srv, &call);
+			break;
 		default:
 			async_answer_0(&call, EINVAL);
 		}
@@ -321,6 +383,57 @@ errno_t iplink_ev_recv(iplink_srv_t *srv, iplink_recv_sdu_t *sdu, ip_ver_t ver)
 	return EOK;
 }
 
+/** Deliver a batch of received SDUs to the client.
+ *
+ * All SDUs are delivered by a single event, which saves the IPC round
+ * trips of delivering them one by one. The SDU descriptors are followed
+ * by one data write per SDU in the same exchange.
+ *
+ * @param srv   IP link server
+ * @param sdus  Array of SDUs
+ * @param vers  Array of IP versions of the SDUs
+ * @param count Number of SDUs, at most IPLINK_EV_RECV_BATCH_MAX
+ *
+ * @return EOK on success or an error code
+ */
+errno_t iplink_ev_recv_batch(iplink_srv_t *srv, iplink_recv_sdu_t *sdus,
+    ip_ver_t *vers, size_t count)
+{
+	ipc_iplink_recv_ent_t ents[IPLINK_EV_RECV_BATCH_MAX];
+	size_t i;
+
+	assert(count > 0);
+	assert(count <= IPLINK_EV_RECV_BATCH_MAX);
+
+	if (srv->client_sess == NULL)
+		return EIO;
+
+	for (i = 0; i < count; i++) {
+		ents[i].size = sdus[i].size;
+		ents[i].ver = vers[i];
+	}
+
+	async_exch_t *exch = async_exchange_begin(srv->client_sess);
+
+	ipc_call_t answer;
+	aid_t req = async_send_1(exch, IPLINK_EV_RECV_BATCH, count, &answer);
+
+	errno_t rc = async_data_write_start(exch, ents,
+	    count * sizeof(ipc_iplink_recv_ent_t));
+	for (i = 0; i < count && rc == EOK; i++)
+		rc = async_data_write_start(exch, sdus[i].data, sdus[i].size);
+	async_exchange_end(exch);
+
+	if (rc != EOK) {
+		async_forget(req);
+		return rc;
+	}
+
+	errno_t retval;
+	async_wait_for(req, &retval);
+	return retval;
+}
+
 errno_t iplink_ev_change_addr(iplink_srv_t *srv, addr48_t *addr)
 {
 	if (srv->client_sess == NULL)
@@ -40,12 +40,24 @@
 #include <fibril.h>
 #include <fibril_synch.h>
 #include <time.h>
+#include <stdatomic.h>
 #include <stdbool.h>
+#include "./fibril.h"
+
+/** Maximum number of inactive exchanges kept in a session.
+ *
+ * Inactive exchanges beyond this limit are destroyed (and their phones
+ * hung up in case of parallel exchanges) when they are finished.
+ */
+#define ASYNC_SESS_EXCH_SLOTS  8
 
 /** Session data */
 struct async_sess {
-	/** List of inactive exchanges */
-	list_t exch_list;
+	/** Pool of inactive exchanges (NULL denotes a free slot) */
+	_Atomic(async_exch_t *) exch_pool[ASYNC_SESS_EXCH_SLOTS];
+
+	/** Link into global list of sessions with parallel data phones */
+	link_t sess_link;
 
 	/** Session interface */
 	iface_t iface;
@@ -69,7 +81,16 @@ struct async_sess {
 	fibril_mutex_t mutex;
 
 	/** Number of opened exchanges */
-	int exchanges;
+	atomic_int exchanges;
+
+	/** Number of fibrils waiting for an inactive exchange */
+	atomic_int exch_waiters;
+
+	/** Mutex protecting exch_avail_cv */
+	fibril_mutex_t exch_mutex;
+
+	/** Condition variable to wait for an exchange to become inactive */
+	fibril_condvar_t exch_avail_cv;
 
 	/** Mutex for stateful connections */
 	fibril_mutex_t remote_state_mtx;
@@ -80,12 +101,6 @@ struct async_sess {
 
 /** Exchange data */
 struct async_exch {
-	/** Link into list of inactive exchanges */
-	link_t sess_link;
-
-	/** Link into global list of inactive exchanges */
-	link_t global_link;
-
 	/** Session pointer */
 	async_sess_t *sess;
 
@@ -100,11 +115,15 @@ extern void __async_client_fini(void);
 extern void __async_ports_init(void);
 extern void __async_ports_fini(void);
 
+extern void async_sess_init(async_sess_t *);
+
 extern errno_t async_create_port_internal(iface_t, async_port_handler_t,
     void *, port_id_t *);
 extern async_port_handler_t async_get_port_handler(iface_t, port_id_t, void **);
 
 extern void async_reply_received(ipc_call_t *);
+extern void async_reply_notify(aid_t, fibril_event_t *);
+extern bool async_reply_done(aid_t);
 
 #endif
 
@@ -138,6 +138,9 @@ static inline errno_t _ready_down(const struct timespec *expires)
 
 static atomic_int threads_in_ipc_wait;
 
+/* Number of runner threads, including the main thread. */
+static atomic_int runner_count = 1;
+
 /** Function that spans the whole life-cycle of a fibril.
  *
  * Each fibril begins execution in this function. Then the function implementing
@@ -782,14 +785,12 @@ static void _runner_fn(void *arg)
 }
 
 /**
- * Spawn a given number of runners (i.e. OS threads) immediately, and
- * unconditionally. This is meant to be used for tests and debugging.
- * Regular programs should just use `fibril_enable_multithreaded()`.
+ * Spawn runners without accounting for them in runner_count.
  *
  * @param n  Number of runners to spawn.
  * @return   Number of runners successfully spawned.
  */
-int fibril_test_spawn_runners(int n)
+static int _spawn_runners(int n)
 {
 	assert(fibril_self()->rmutex_locks == 0);
 
@@ -813,6 +814,22 @@ int fibril_test_spawn_runners(int n)
 	return n;
 }
 
+/**
+ * Spawn a given number of runners (i.e. OS threads) immediately, and
+ * unconditionally. This is meant to be used for tests and debugging.
+ * Regular programs should just use `fibril_enable_multithreaded()`
+ * or `fibril_enable_multithreaded_runners()`.
+ *
+ * @param n  Number of runners to spawn.
+ * @return   Number of runners successfully spawned.
+ */
+int fibril_test_spawn_runners(int n)
+{
+	int spawned = _spawn_runners(n);
+	atomic_fetch_add(&runner_count, spawned);
+	return spawned;
+}
+
 /**
  * Opt-in to have more than one runner thread.
  *
@@ -831,6 +848,36 @@ void fibril_enable_multithreaded(void)
 	}
 }
 
+/**
+ * Opt-in to have a given total number of runner threads.
+ *
+ * Meant for programs that spread computation over all processors and
+ * therefore want one runner per processor rather than the default of
+ * `fibril_enable_multithreaded()`. Runners are never taken away, so
+ * if the task already has @a n runners or more, nothing happens.
+ *
+ * @param n  Requested total number of runners, including the main thread.
+ * @return   Total number of runners.
+ */
+int fibril_enable_multithreaded_runners(int n)
+{
+	int count = atomic_load(&runner_count);
+
+	while (count < n) {
+		/* Reserve the missing runners so concurrent callers do not overshoot. */
+		if (!atomic_compare_exchange_weak(&runner_count, &count, n))
+			continue;
+
+		int missing = n - count;
+		int spawned = _spawn_runners(missing);
+		if (spawned < missing)
+			atomic_fetch_sub(&runner_count, missing - spawned);
+		break;
+	}
+
+	return atomic_load(&runner_count);
+}
+
 /**
  * Detach a fibril.
  */
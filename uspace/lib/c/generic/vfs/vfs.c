@@ -906,6 +906,174 @@ errno_t vfs_read_short(int file, aoff64_t pos, void *buf, size_t nbyte,
 	return EOK;
 }
 
+/** Transfer data described by an I/O vector in a single VFS request
+ *
+ * The request is followed by the sizes of the data transfers and then by
+ * one data transfer per non-empty vector element, each limited to
+ * DATA_XFER_LIMIT bytes. The sequence ends with the first element which
+ * had to be truncated or after VFS_VEC_MAX transfers. VFS refuses the
+ * transfer following a short one with ELIMIT.
+ *
+ * @param read          Read data if true, write data otherwise
+ * @param file          File handle
+ * @param pos           Position in the file
+ * @param iov           I/O vector
+ * @param iovcnt        Number of elements in @a iov
+ * @param off           Offset into the first element of @a iov
+ * @param[out] nbytes   Number of bytes transferred
+ *
+ * @return              EOK on success or an error code
+ */
+static errno_t vfs_rdwrv_short(bool read, int file, aoff64_t pos,
+    const vfs_iovec_t *iov, size_t iovcnt, size_t off, ssize_t *nbytes)
+{
+	size_t sizes[VFS_VEC_MAX];
+	size_t cnt = 0;
+	size_t i;
+
+	for (i = 0; i < iovcnt && cnt < VFS_VEC_MAX; i++) {
+		size_t size = iov[i].size - (i == 0 ? off : 0);
+		if (size == 0)
+			continue;
+
+		sizes[cnt++] = min(size, DATA_XFER_LIMIT);
+		if (size > DATA_XFER_LIMIT)
+			break;
+	}
+
+	if (cnt == 0) {
+		*nbytes = 0;
+		return EOK;
+	}
+
+	async_exch_t *exch = vfs_exchange_begin();
+
+	ipc_call_t answer;
+	aid_t req = async_send_4(exch, read ? VFS_IN_READV : VFS_IN_WRITEV,
+	    file, LOWER32(pos), UPPER32(pos), cnt, &answer);
+
+	errno_t rc = async_data_write_start(exch, sizes, cnt * sizeof(size_t));
+	if (rc != EOK) {
+		vfs_exchange_end(exch);
+		async_forget(req);
+		return rc;
+	}
+
+	size_t sent = 0;
+
+	for (i = 0; sent < cnt; i++) {
+		uint8_t *base = (uint8_t *) iov[i].base + (i == 0 ? off : 0);
+		if (iov[i].size - (i == 0 ? off : 0) == 0)
+			continue;
+
+		if (read)
+			rc = async_data_read_start(exch, base, sizes[sent]);
+		else
+			rc = async_data_write_start(exch, base, sizes[sent]);
+		if (rc != EOK)
+			break;
+
+		sent++;
+	}
+
+	vfs_exchange_end(exch);
+
+	if (rc != EOK && sent == 0) {
+		async_forget(req);
+		return rc;
+	}
+
+	async_wait_for(req, &rc);
+	if (rc != EOK)
+		return rc;
+
+	*nbytes = (ssize_t) IPC_GET_ARG1(answer);
+	return EOK;
+}
+
+/** Transfer all data described by an I/O vector
+ *
+ * @param read          Read data if true, write data otherwise
+ * @param file          File handle
+ * @param[inout] pos    Position in the file, updated by the bytes transferred
+ * @param iov           I/O vector
+ * @param iovcnt        Number of elements in @a iov
+ * @param[out] nbytes   Number of bytes transferred
+ *
+ * @return              EOK on success or an error code
+ */
+static errno_t vfs_rdwrv(bool read, int file, aoff64_t *pos,
+    const vfs_iovec_t *iov, size_t iovcnt, size_t *nbytes)
+{
+	size_t total = 0;
+	size_t idx = 0;
+	size_t off = 0;
+	ssize_t cnt;
+	errno_t rc;
+
+	do {
+		rc = vfs_rdwrv_short(read, file, *pos, iov + idx,
+		    iovcnt - idx, off, &cnt);
+		if (rc != EOK)
+			break;
+
+		*pos += cnt;
+		total += cnt;
+
+		/* Skip the elements which have been transferred. */
+		off += cnt;
+		while (idx < iovcnt && off >= iov[idx].size) {
+			off -= iov[idx].size;
+			idx++;
+		}
+	} while (cnt > 0 && idx < iovcnt);
+
+	*nbytes = total;
+	return rc;
+}
+
+/** Read data into an I/O vector
+ *
+ * Read up to the total size of @a iov from file if available. The buffers
+ * are filled in order. This function always reads all the available bytes
+ * up to the total size of @a iov.
+ *
+ * @param file          File handle to read from
+ * @param[inout] pos    Position to read from, updated by the actual bytes read
+ * @param iov           I/O vector describing the buffers
+ * @param iovcnt        Number of elements in @a iov
+ * @param nread         Place to store number of bytes actually read
+ *
+ * @return              On success, EOK and @a *nread is filled with number
+ *                      of bytes actually read.
+ * @return              On failure, an error code
+ */
+errno_t vfs_readv(int file, aoff64_t *pos, const vfs_iovec_t *iov,
+    size_t iovcnt, size_t *nread)
+{
+	return vfs_rdwrv(true, file, pos, iov, iovcnt, nread);
+}
+
+/** Read bytes from a file into an I/O vector
+ *
+ * The whole vector is transferred in a single VFS request. The actual
+ * number of bytes read may be lower than the total size of @a iov, but
+ * greater than zero if there are any bytes available.
+ *
+ * @param file          File handle to read from
+ * @param[in] pos       Position to read from
+ * @param iov           I/O vector describing the buffers
+ * @param iovcnt        Number of elements in @a iov
+ * @param[out] nread    Actual number of bytes read (0 or more)
+ *
+ * @return              EOK on success or an error code
+ */
+errno_t vfs_readv_short(int file, aoff64_t pos, const vfs_iovec_t *iov,
+    size_t iovcnt, ssize_t *nread)
+{
+	return vfs_rdwrv_short(true, file, pos, iov, iovcnt, 0, nread);
+}
+
 /** Rename a file or directory
  *
  * There is no file-handle-based variant to disallow attempts to introduce loops
@@ -1143,6 +1311,30 @@ errno_t vfs_statfs_path(const char *path, vfs_statfs_t *st)
 	return rc;
 }
 
+/** Get VFS server statistics
+ *
+ * @param[out] stats    Buffer for storing the statistics
+ *
+ * @return              EOK on success or an error code
+ */
+errno_t vfs_stats(vfs_stats_t *stats)
+{
+	errno_t rc, ret;
+	aid_t req;
+
+	async_exch_t *exch = vfs_exchange_begin();
+
+	req = async_send_0(exch, VFS_IN_STATS, NULL);
+	rc = async_data_read_start(exch, (void *) stats, sizeof(*stats));
+
+	vfs_exchange_end(exch);
+	async_wait_for(req, &ret);
+
+	rc = (ret != EOK ? ret : rc);
+
+	return rc;
+}
+
 /** Synchronize file
  *
  * @param file  File handle to synchronize
@@ -1370,5 +1562,47 @@ errno_t vfs_write_short(int file, aoff64_t pos, const void *buf, size_t nbyte,
 	return EOK;
 }
 
+/** Write data from an I/O vector
+ *
+ * This function fails if it cannot write all the data described by @a iov
+ * to the file.
+ *
+ * @param file          File handle to write to
+ * @param[inout] pos    Position to write to, updated by the actual bytes
+ *                      written
+ * @param iov           I/O vector describing the data
+ * @param iovcnt        Number of elements in @a iov
+ * @param nwritten      Place to store number of bytes written
+ *
+ * @return              On success, EOK, @a *nwritten is filled with number
+ *                      of bytes written
+ * @return              On failure, an error code
+ */
+errno_t vfs_writev(int file, aoff64_t *pos, const vfs_iovec_t *iov,
+    size_t iovcnt, size_t *nwritten)
+{
+	return vfs_rdwrv(false, file, pos, iov, iovcnt, nwritten);
+}
+
+/** Write bytes from an I/O vector to a file
+ *
+ * The whole vector is transferred in a single VFS request. The actual
+ * number of bytes written may be lower than the total size of @a iov,
+ * but greater than zero.
+ *
+ * @param file          File handle to write to
+ * @param[in] pos       Position to write to
+ * @param iov           I/O vector describing the data
+ * @param iovcnt        Number of elements in @a iov
+ * @param[out] nwritten Actual number of bytes written (0 or more)
+ *
+ * @return              EOK on success or an error code
+ */
+errno_t vfs_writev_short(int file, aoff64_t pos, const vfs_iovec_t *iov,
+    size_t iovcnt, ssize_t *nwritten)
+{
+	return vfs_rdwrv_short(false, file, pos, iov, iovcnt, 0, nwritten);
+}
+
 /** @}
  */
@@ -0,0 +1,589 @@
+/*
+ * Copyright (c) 2019 Jiri Svoboda
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * - Redistributions of source code must retain the above copyright
+ *   notice, this list of conditions and the following disclaimer.
+ * - Redistributions in binary form must reproduce the above copyright
+ *   notice, this list of conditions and the following disclaimer in the
+ *   documentation and/or other materials provided with the distribution.
+ * - The name of the author may not be used to endorse or promote products
+ *   derived from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHOR ``AS IS'' AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+ * OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+ * IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT
+ * NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF
+ * THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/** @addtogroup libc
+ * @{
+ */
+/** @file Asynchronous file I/O.
+ *
+ * Requests are submitted to a queue and each of them is sent to VFS in
+ * its own exchange. Since the VFS session allows parallel exchanges, VFS
+ * and, in turn, the file system servers see all the requests of the queue
+ * at the same time instead of one after another.
+ *
+ * The queue limits the number of requests in progress. Requests over the
+ * limit are kept in the queue and submitted as soon as earlier requests
+ * complete, which is detected whenever the queue is polled or waited on.
+ *
+ * A queue is meant to be used by a single fibril at a time.
+ */
+
+#include <adt/list.h>
+#include <assert.h>
+#include <async.h>
+#include <errno.h>
+#include <fibril_synch.h>
+#include <ipc/vfs.h>
+#include <macros.h>
+#include <stdlib.h>
+#include <vfs/vfs.h>
+#include <vfs/vfs_aio.h>
+#include "../private/async.h"
+#include "../private/fibril.h"
+
+/** Request state */
+typedef enum {
+	/** Waiting in the queue for being submitted */
+	vas_queued,
+	/** Submitted to VFS */
+	vas_active,
+	/** Completed or cancelled */
+	vas_done
+} vfs_aio_state_t;
+
+/** Asynchronous I/O request */
+struct vfs_aio {
+	/** Containing queue */
+	vfs_aio_queue_t *queue;
+	/** Link to vfs_aio_queue_t.queued, .active or .done */
+	link_t lqueue;
+	/** Request state */
+	vfs_aio_state_t state;
+	/** @c true for read, @c false for write */
+	bool read;
+	/** File handle */
+	int file;
+	/** Position in the file */
+	aoff64_t pos;
+	/** Data buffer */
+	void *buf;
+	/** Number of bytes to transfer */
+	size_t nbyte;
+	/** User argument */
+	void *arg;
+	/** Exchange used by the active request */
+	async_exch_t *exch;
+	/** VFS request message */
+	aid_t req;
+	/** Data transfer message */
+	aid_t xfer;
+	/** Answer to the VFS request */
+	ipc_call_t answer;
+	/** Completion status */
+	errno_t rc;
+	/** Number of bytes transferred */
+	size_t nbytes;
+};
+
+/** Queue of asynchronous I/O requests */
+struct vfs_aio_queue {
+	/** Protects the queue */
+	fibril_mutex_t lock;
+	/** Notified when a reply to an active request arrives */
+	fibril_event_t event;
+	/** Maximum number of active requests */
+	size_t depth;
+	/** Number of active requests */
+	size_t nactive;
+	/** Requests waiting for submission, vfs_aio_t */
+	list_t queued;
+	/** Active requests, vfs_aio_t */
+	list_t active;
+	/** Completed requests not yet collected, vfs_aio_t */
+	list_t done;
+};
+
+/** Create queue of asynchronous I/O requests.
+ *
+ * @param depth Maximum number of requests in progress at the same time
+ *              or zero to use VFS_AIO_DEPTH_DEFAULT
+ * @param rqueue Place to store pointer to the new queue
+ *
+ * @return EOK on success, ENOMEM if out of memory
+ */
+errno_t vfs_aio_queue_create(size_t depth, vfs_aio_queue_t **rqueue)
+{
+	vfs_aio_queue_t *queue;
+
+	queue = calloc(1, sizeof(vfs_aio_queue_t));
+	if (queue == NULL)
+		return ENOMEM;
+
+	fibril_mutex_initialize(&queue->lock);
+	queue->event = FIBRIL_EVENT_INIT;
+	queue->depth = depth != 0 ? depth : VFS_AIO_DEPTH_DEFAULT;
+	list_initialize(&queue->queued);
+	list_initialize(&queue->active);
+	list_initialize(&queue->done);
+
+	*rqueue = queue;
+	return EOK;
+}
+
+/** Send request to VFS.
+ *
+ * @param aio Request
+ */
+static void vfs_aio_start(vfs_aio_t *aio)
+{
+	vfs_aio_queue_t *queue = aio->queue;
+
+	assert(fibril_mutex_is_locked(&queue->lock));
+
+	aio->exch = vfs_exchange_begin();
+	aio->req = async_send_3(aio->exch, aio->read ? VFS_IN_READ :
+	    VFS_IN_WRITE, aio->file, LOWER32(aio->pos), UPPER32(aio->pos),
+	    &aio->answer);
+	if (aio->req == 0) {
+		vfs_exchange_end(aio->exch);
+		aio->exch = NULL;
+		aio->state = vas_done;
+		aio->rc = ENOMEM;
+		list_append(&aio->lqueue, &queue->done);
+		return;
+	}
+
+	if (aio->read)
+		aio->xfer = async_data_read(aio->exch, aio->buf, aio->nbyte,
+		    NULL);
+	else
+		aio->xfer = async_data_write(aio->exch, aio->buf, aio->nbyte,
+		    NULL);
+	if (aio->xfer == 0) {
+		async_forget(aio->req);
+		vfs_exchange_end(aio->exch);
+		aio->exch = NULL;
+		aio->state = vas_done;
+		aio->rc = ENOMEM;
+		list_append(&aio->lqueue, &queue->done);
+		return;
+	}
+
+	async_reply_notify(aio->req, &queue->event);
+
+	aio->state = vas_active;
+	list_append(&aio->lqueue, &queue->active);
+	queue->nactive++;
+}
+
+/** Collect results of an active request whose reply has arrived.
+ *
+ * @param aio Request
+ */
+static void vfs_aio_finish(vfs_aio_t *aio)
+{
+	vfs_aio_queue_t *queue = aio->queue;
+	errno_t xrc;
+	errno_t rc;
+
+	assert(fibril_mutex_is_locked(&queue->lock));
+	assert(aio->state == vas_active);
+
+	/* VFS answers the request only after the data transfer is over. */
+	async_wait_for(aio->xfer, &xrc);
+	async_wait_for(aio->req, &rc);
+	vfs_exchange_end(aio->exch);
+	aio->exch = NULL;
+
+	if (rc == EOK && xrc != EOK)
+		rc = xrc;
+
+	aio->rc = rc;
+	aio->nbytes = rc == EOK ? IPC_GET_ARG1(aio->answer) : 0;
+	aio->state = vas_done;
+
+	list_remove(&aio->lqueue);
+	list_append(&aio->lqueue, &queue->done);
+	queue->nactive--;
+}
+
+/** Collect completed requests and submit waiting ones.
+ *
+ * @param queue Queue
+ */
+static void vfs_aio_queue_update(vfs_aio_queue_t *queue)
+{
+	assert(fibril_mutex_is_locked(&queue->lock));
+
+	list_foreach_safe(queue->active, cur, next) {
+		vfs_aio_t *aio = list_get_instance(cur, vfs_aio_t, lqueue);
+		if (async_reply_done(aio->req))
+			vfs_aio_finish(aio);
+	}
+
+	while (queue->nactive < queue->depth && !list_empty(&queue->queued)) {
+		vfs_aio_t *aio = list_get_instance(list_first(&queue->queued),
+		    vfs_aio_t, lqueue);
+		list_remove(&aio->lqueue);
+		vfs_aio_start(aio);
+	}
+}
+
+/** Wait for a reply to any active request of the queue.
+ *
+ * @param queue Queue
+ * @param timeout Timeout in microseconds, negative to wait indefinitely
+ *
+ * @return EOK if a reply might have arrived, ETIMEOUT if timed out
+ */
+static errno_t vfs_aio_queue_sleep(vfs_aio_queue_t *queue, usec_t timeout)
+{
+	struct timespec expires;
+
+	if (timeout < 0) {
+		fibril_wait_for(&queue->event);
+		return EOK;
+	}
+
+	getuptime(&expires);
+	ts_add_diff(&expires, USEC2NSEC(timeout));
+	return fibril_wait_timeout(&queue->event, &expires);
+}
+
+/** Create and submit a request.
+ *
+ * @param queue Queue
+ * @param read @c true to read, @c false to write
+ * @param file File handle
+ * @param pos Position in the file
+ * @param buf Data buffer
+ * @param nbyte Number of bytes to transfer
+ * @param arg User argument
+ * @param raio Place to store pointer to the new request
+ *
+ * @return EOK on success, ENOMEM if out of memory
+ */
+static errno_t vfs_aio_submit(vfs_aio_queue_t *queue, bool read, int file,
+    aoff64_t pos, void *buf, size_t nbyte, void *arg, vfs_aio_t **raio)
+{
+	vfs_aio_t *aio;
+
+	aio = calloc(1, sizeof(vfs_aio_t));
+	if (aio == NULL)
+		return ENOMEM;
+
+	aio->queue = queue;
+	aio->read = read;
+	aio->file = file;
+	aio->pos = pos;
+	aio->buf = buf;
+	aio->nbyte = min(nbyte, DATA_XFER_LIMIT);
+	aio->arg = arg;
+
+	fibril_mutex_lock(&queue->lock);
+
+	aio->state = vas_queued;
+	list_append(&aio->lqueue, &queue->queued);
+	vfs_aio_queue_update(queue);
+
+	fibril_mutex_unlock(&queue->lock);
+
+	*raio = aio;
+	return EOK;
+}
+
+/** Submit asynchronous read request.
+ *
+ * The request transfers at most DATA_XFER_LIMIT bytes. Like with
+ * vfs_read_short(), the number of bytes actually read may be lower
+ * than requested.
+ *
+ * @param queue Queue
+ * @param file File handle to read from
+ * @param pos Position to read from
+ * @param buf Buffer, @a nbyte bytes long, which must stay valid until the
+ *            request completes
+ * @param nbyte Number of bytes to read
+ * @param arg User argument, see vfs_aio_arg()
+ * @param raio Place to store pointer to the new request
+ *
+ * @return EOK on success, ENOMEM if out of memory
+ */
+errno_t vfs_aio_read(vfs_aio_queue_t *queue, int file, aoff64_t pos,
+    void *buf, size_t nbyte, void *arg, vfs_aio_t **raio)
+{
+	return vfs_aio_submit(queue, true, file, pos, buf, nbyte, arg, raio);
+}
+
+/** Submit asynchronous write request.
+ *
+ * The request transfers at most DATA_XFER_LIMIT bytes. Like with
+ * vfs_write_short(), the number of bytes actually written may be lower
+ * than requested.
+ *
+ * @param queue Queue
+ * @param file File handle to write to
+ * @param pos Position to write to
+ * @param buf Data, @a nbyte bytes long, which must stay valid until the
+ *            request completes
+ * @param nbyte Number of bytes to write
+ * @param arg User argument, see vfs_aio_arg()
+ * @param raio Place to store pointer to the new request
+ *
+ * @return EOK on success, ENOMEM if out of memory
+ */
+errno_t vfs_aio_write(vfs_aio_queue_t *queue, int file, aoff64_t pos,
+    const void *buf, size_t nbyte, void *arg, vfs_aio_t **raio)
+{
+	return vfs_aio_submit(queue, false, file, pos, (void *) buf, nbyte,
+	    arg, raio);
+}
+
+/** Determine whether request has completed, without blocking.
+ *
+ * @param aio Request
+ * @return @c true if the request has completed or was cancelled
+ */
+bool vfs_aio_poll(vfs_aio_t *aio)
+{
+	vfs_aio_queue_t *queue = aio->queue;
+	bool done;
+
+	fibril_mutex_lock(&queue->lock);
+	vfs_aio_queue_update(queue);
+	done = aio->state == vas_done;
+	fibril_mutex_unlock(&queue->lock);
+
+	return done;
+}
+
+/** Wait for request to complete.
+ *
+ * Once this function returns, the request is no longer reported
+ * by vfs_aio_wait_any().
+ *
+ * @param aio Request
+ * @param nbytes Place to store number of bytes transferred or @c NULL
+ *
+ * @return Completion status of the request
+ */
+errno_t vfs_aio_wait(vfs_aio_t *aio, size_t *nbytes)
+{
+	vfs_aio_queue_t *queue = aio->queue;
+
+	fibril_mutex_lock(&queue->lock);
+
+	while (true) {
+		vfs_aio_queue_update(queue);
+		if (aio->state == vas_done)
+			break;
+
+		fibril_mutex_unlock(&queue->lock);
+		(void) vfs_aio_queue_sleep(queue, -1);
+		fibril_mutex_lock(&queue->lock);
+	}
+
+	if (link_in_use(&aio->lqueue))
+		list_remove(&aio->lqueue);
+
+	fibril_mutex_unlock(&queue->lock);
+
+	return vfs_aio_result(aio, nbytes);
+}
+
+/** Wait for any request of the queue to complete.
+ *
+ * Each completed request is returned only once.
+ *
+ * @param queue Queue
+ * @param timeout Timeout in microseconds, zero to only poll, negative to
+ *                wait indefinitely
+ * @param raio Place to store pointer to the completed request
+ *
+ * @return EOK on success, ETIMEOUT if no request completed before the
+ *         timeout expired, ENOENT if there are no outstanding requests
+ */
+errno_t vfs_aio_wait_any(vfs_aio_queue_t *queue, usec_t timeout,
+    vfs_aio_t **raio)
+{
+	errno_t rc;
+
+	fibril_mutex_lock(&queue->lock);
+
+	while (true) {
+		vfs_aio_queue_update(queue);
+
+		if (!list_empty(&queue->done)) {
+			vfs_aio_t *aio = list_get_instance(
+			    list_first(&queue->done), vfs_aio_t, lqueue);
+			list_remove(&aio->lqueue);
+			fibril_mutex_unlock(&queue->lock);
+
+			*raio = aio;
+			return EOK;
+		}
+
+		if (list_empty(&queue->active)) {
+			fibril_mutex_unlock(&queue->lock);
+			return ENOENT;
+		}
+
+		fibril_mutex_unlock(&queue->lock);
+		rc = vfs_aio_queue_sleep(queue, timeout);
+		if (rc != EOK)
+			return rc;
+		fibril_mutex_lock(&queue->lock);
+	}
+}
+
+/** Get result of a completed request.
+ *
+ * @param aio Request
+ * @param nbytes Place to store number of bytes transferred or @c NULL
+ *
+ * @return Completion status of the request, ECANCELED if the request
+ *         was cancelled, EBUSY if it has not completed yet
+ */
+errno_t vfs_aio_result(vfs_aio_t *aio, size_t *nbytes)
+{
+	vfs_aio_queue_t *queue = aio->queue;
+	errno_t rc;
+
+	fibril_mutex_lock(&queue->lock);
+
+	if (aio->state != vas_done) {
+		fibril_mutex_unlock(&queue->lock);
+		return EBUSY;
+	}
+
+	if (nbytes != NULL)
+		*nbytes = aio->nbytes;
+	rc = aio->rc;
+
+	fibril_mutex_unlock(&queue->lock);
+	return rc;
+}
+
+/** Get user argument of a request.
+ *
+ * @param aio Request
+ * @return User argument passed when submitting the request
+ */
+void *vfs_aio_arg(vfs_aio_t *aio)
+{
+	return aio->arg;
+}
+
+/** Cancel request.
+ *
+ * Only requests which have not been submitted to VFS yet can be cancelled.
+ * A cancelled request completes with ECANCELED.
+ *
+ * @param aio Request
+ *
+ * @return EOK if the request was cancelled, EBUSY if it is in progress
+ *         and will complete normally, EALREADY if it has already completed
+ */
+errno_t vfs_aio_cancel(vfs_aio_t *aio)
+{
+	vfs_aio_queue_t *queue = aio->queue;
+	errno_t rc;
+
+	fibril_mutex_lock(&queue->lock);
+
+	switch (aio->state) {
+	case vas_queued:
+		list_remove(&aio->lqueue);
+		aio->state = vas_done;
+		aio->rc = ECANCELED;
+		list_append(&aio->lqueue, &queue->done);
+		rc = EOK;
+		break;
+	case vas_active:
+		rc = EBUSY;
+		break;
+	default:
+		rc = EALREADY;
+		break;
+	}
+
+	fibril_mutex_unlock(&queue->lock);
+	return rc;
+}
+
+/** Destroy request.
+ *
+ * A request which has not been submitted yet is cancelled. If the request
+ * is in progress, wait for it to complete first, since VFS might still be
+ * accessing its buffer.
+ *
+ * @param aio Request
+ */
+void vfs_aio_destroy(vfs_aio_t *aio)
+{
+	(void) vfs_aio_cancel(aio);
+	(void) vfs_aio_wait(aio, NULL);
+	free(aio);
+}
+
+/** Destroy queue.
+ *
+ * Requests not submitted yet are cancelled, requests in progress are
+ * waited for. All requests of the queue which have not been collected using
+ * vfs_aio_wait() or vfs_aio_wait_any() are destroyed together with the
+ * queue.
+ *
+ * @param queue Queue
+ */
+void vfs_aio_queue_destroy(vfs_aio_queue_t *queue)
+{
+	vfs_aio_t *aio;
+
+	if (queue == NULL)
+		return;
+
+	fibril_mutex_lock(&queue->lock);
+
+	list_foreach_safe(queue->queued, cur, next) {
+		aio = list_get_instance(cur, vfs_aio_t, lqueue);
+		list_remove(&aio->lqueue);
+		free(aio);
+	}
+
+	while (!list_empty(&queue->active)) {
+		vfs_aio_queue_update(queue);
+		if (list_empty(&queue->active))
+			break;
+
+		fibril_mutex_unlock(&queue->lock);
+		(void) vfs_aio_queue_sleep(queue, -1);
+		fibril_mutex_lock(&queue->lock);
+	}
+
+	list_foreach_safe(queue->done, cur, next) {
+		aio = list_get_instance(cur, vfs_aio_t, lqueue);
+		list_remove(&aio->lqueue);
+		free(aio);
+	}
+
+	fibril_mutex_unlock(&queue->lock);
+	free(queue);
+}
+
+/** @}
+ */
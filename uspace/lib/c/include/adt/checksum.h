@@ -40,6 +40,13 @@
 
 extern uint32_t compute_crc32(uint8_t *, size_t);
 extern uint32_t compute_crc32_seed(uint8_t *, size_t, uint32_t);
+extern uint32_t crc32_combine(uint32_t, uint32_t, size_t);
+extern uint32_t compute_crc32c(const uint8_t *, size_t);
+extern uint32_t compute_crc32c_seed(const uint8_t *, size_t, uint32_t);
+extern uint32_t crc32c_combine(uint32_t, uint32_t, size_t);
+extern uint16_t compute_ocsum(const void *, size_t, uint16_t);
+extern uint16_t ocsum_add(uint16_t, uint16_t);
+extern uint16_t ocsum_combine(uint16_t, uint16_t, size_t);
 
 #endif
 
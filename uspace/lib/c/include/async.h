@@ -443,6 +443,8 @@ extern errno_t async_data_read_forward_fast(async_exch_t *, sysarg_t, sysarg_t,
 	async_data_write_forward_fast(exch, method, arg1, arg2, arg3, arg4, \
 	    answer)
 
+extern aid_t async_data_write(async_exch_t *, const void *, size_t,
+    ipc_call_t *);
 extern errno_t async_data_write_start(async_exch_t *, const void *, size_t);
 extern bool async_data_write_receive(ipc_call_t *, size_t *);
 extern errno_t async_data_write_finalize(ipc_call_t *, void *, size_t);
@@ -63,6 +63,7 @@ extern void fibril_usleep(usec_t);
 extern void fibril_sleep(sec_t);
 
 extern void fibril_enable_multithreaded(void);
+extern int fibril_enable_multithreaded_runners(int);
 extern int fibril_test_spawn_runners(int);
 
 extern void fibril_detach(fid_t fid);
@@ -49,6 +49,7 @@ extern errno_t inetcfg_get_link_list(sysarg_t **, size_t *);
 extern errno_t inetcfg_get_sroute_list(sysarg_t **, size_t *);
 extern errno_t inetcfg_link_add(sysarg_t);
 extern errno_t inetcfg_link_get(sysarg_t, inet_link_info_t *);
+extern errno_t inetcfg_link_get_nstats(sysarg_t, ip_ver_t, inet_nstats_t *);
 extern errno_t inetcfg_link_remove(sysarg_t);
 extern errno_t inetcfg_sroute_get(sysarg_t, inet_sroute_info_t *);
 extern errno_t inetcfg_sroute_get_id(const char *, sysarg_t *);
@@ -37,9 +37,17 @@
 
 #include <async.h>
 #include <inet/addr.h>
+#include <inet/pbuf.h>
+#include <types/inet/nstats.h>
 
 struct iplink_ev_ops;
 
+/**
+ * Link completes partial transport-layer checksums (see @c csum_offs in
+ * iplink_sdu_t), so the sender need not sum up the payload.
+ */
+#define IPLINK_OFFLOAD_CSUM  0x0001
+
 typedef struct {
 	async_sess_t *sess;
 	struct iplink_ev_ops *ev_ops;
@@ -56,6 +64,15 @@ typedef struct {
 	void *data;
 	/** Size of @c data in bytes */
 	size_t size;
+	/** Offset in @c data where transport checksumming starts */
+	uint16_t csum_start;
+	/**
+	 * Offset of partial transport checksum relative to @c csum_start
+	 * or zero if the packet is complete
+	 */
+	uint16_t csum_offs;
+	/** Packet buffer holding @c data or @c NULL (only set on server side) */
+	pbuf_t *pbuf;
 } iplink_sdu_t;
 
 /** IPv6 link Service Data Unit */
@@ -66,6 +83,15 @@ typedef struct {
 	void *data;
 	/** Size of @c data in bytes */
 	size_t size;
+	/** Offset in @c data where transport checksumming starts */
+	uint16_t csum_start;
+	/**
+	 * Offset of partial transport checksum relative to @c csum_start
+	 * or zero if the packet is complete
+	 */
+	uint16_t csum_offs;
+	/** Packet buffer holding @c data or @c NULL (only set on server side) */
+	pbuf_t *pbuf;
 } iplink_sdu6_t;
 
 /** Internet link receive Service Data Unit */
@@ -88,6 +114,8 @@ extern errno_t iplink_send6(iplink_t *, iplink_sdu6_t *);
 extern errno_t iplink_addr_add(iplink_t *, inet_addr_t *);
 extern errno_t iplink_addr_remove(iplink_t *, inet_addr_t *);
 extern errno_t iplink_get_mtu(iplink_t *, size_t *);
+extern errno_t iplink_get_offload(iplink_t *, uint32_t *);
+extern errno_t iplink_get_nstats(iplink_t *, inet_nstats_t *);
 extern errno_t iplink_get_mac48(iplink_t *, addr48_t *);
 extern errno_t iplink_set_mac48(iplink_t *, addr48_t);
 extern void *iplink_get_userptr(iplink_t *);
@@ -40,6 +40,7 @@
 #include <stdbool.h>
 #include <inet/addr.h>
 #include <inet/iplink.h>
+#include <inet/pbuf.h>
 
 struct iplink_ops;
 
@@ -49,6 +50,11 @@ typedef struct {
 	struct iplink_ops *ops;
 	void *arg;
 	async_sess_t *client_sess;
+	/**
+	 * Pool to receive outgoing SDUs into or @c NULL. The pool's headroom
+	 * lets the link prepend its header without copying the SDU.
+	 */
+	pbuf_pool_t *pool;
 } iplink_srv_t;
 
 typedef struct iplink_ops {
@@ -57,6 +63,8 @@ typedef struct iplink_ops {
 	errno_t (*send)(iplink_srv_t *, iplink_sdu_t *);
 	errno_t (*send6)(iplink_srv_t *, iplink_sdu6_t *);
 	errno_t (*get_mtu)(iplink_srv_t *, size_t *);
+	errno_t (*get_offload)(iplink_srv_t *, uint32_t *);
+	errno_t (*get_nstats)(iplink_srv_t *, inet_nstats_t *);
 	errno_t (*get_mac48)(iplink_srv_t *, addr48_t *);
 	errno_t (*set_mac48)(iplink_srv_t *, addr48_t *);
 	errno_t (*addr_add)(iplink_srv_t *, inet_addr_t *);
@@ -67,6 +75,8 @@ extern void iplink_srv_init(iplink_srv_t *);
 
 extern errno_t iplink_conn(ipc_call_t *, void *);
 extern errno_t iplink_ev_recv(iplink_srv_t *, iplink_recv_sdu_t *, ip_ver_t);
+extern errno_t iplink_ev_recv_batch(iplink_srv_t *, iplink_recv_sdu_t *,
+    ip_ver_t *, size_t);
 extern errno_t iplink_ev_change_addr(iplink_srv_t *, addr48_t *);
 
 #endif
@@ -0,0 +1,114 @@
+/*
+ * Copyright (c) 2019 Jiri Svoboda
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * - Redistributions of source code must retain the above copyright
+ *   notice, this list of conditions and the following disclaimer.
+ * - Redistributions in binary form must reproduce the above copyright
+ *   notice, this list of conditions and the following disclaimer in the
+ *   documentation and/or other materials provided with the distribution.
+ * - The name of the author may not be used to endorse or promote products
+ *   derived from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHOR ``AS IS'' AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+ * OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+ * IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT
+ * NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF
+ * THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/** @addtogroup libc
+ * @{
+ */
+/** @file Packet buffers
+ */
+
+#ifndef LIBC_INET_PBUF_H_
+#define LIBC_INET_PBUF_H_
+
+#include <adt/list.h>
+#include <errno.h>
+#include <fibril_synch.h>
+#include <refcount.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+struct pbuf_pool;
+
+/** Packet buffer.
+ *
+ * A packet buffer holds one packet in a contiguous storage area. The valid
+ * data occupy a window inside the storage area, so that protocol layers
+ * can prepend (push) or strip (pull) headers just by moving the window
+ * boundaries, without copying the packet.
+ */
+typedef struct pbuf {
+	/** Containing pool or @c NULL if allocated from the heap */
+	struct pbuf_pool *pool;
+	/** Link to pool free list */
+	link_t lfree;
+	/** Reference count */
+	atomic_refcount_t refcnt;
+	/** Storage area */
+	uint8_t *buf;
+	/** Size of storage area in bytes */
+	size_t bsize;
+	/** Offset of packet data within the storage area */
+	size_t offs;
+	/** Size of packet data in bytes */
+	size_t size;
+} pbuf_t;
+
+/** Packet buffer pool.
+ *
+ * Pre-allocated set of equally sized packet buffers that are recycled
+ * instead of being freed.
+ */
+typedef struct pbuf_pool {
+	/** Protects @c free */
+	fibril_mutex_t lock;
+	/** Free buffers (pbuf_t) */
+	list_t free;
+	/** Number of buffers in the pool */
+	size_t count;
+	/** Size of each buffer's storage area in bytes */
+	size_t bsize;
+	/** Headroom reserved in newly allocated buffers */
+	size_t headroom;
+	/** Buffer descriptors */
+	pbuf_t *pbufs;
+	/** Storage for all buffers */
+	uint8_t *storage;
+} pbuf_pool_t;
+
+extern errno_t pbuf_pool_create(size_t, size_t, size_t, pbuf_pool_t **);
+extern void pbuf_pool_destroy(pbuf_pool_t *);
+extern errno_t pbuf_alloc(pbuf_pool_t *, pbuf_t **);
+extern void pbuf_ref(pbuf_t *);
+extern void pbuf_release(pbuf_t *);
+extern void *pbuf_data(pbuf_t *);
+extern size_t pbuf_size(pbuf_t *);
+extern size_t pbuf_headroom(pbuf_t *);
+extern size_t pbuf_tailroom(pbuf_t *);
+extern void *pbuf_push(pbuf_t *, size_t);
+extern void *pbuf_pull(pbuf_t *, size_t);
+extern void *pbuf_put(pbuf_t *, size_t);
+extern void pbuf_trim(pbuf_t *, size_t);
+extern errno_t pbuf_data_write_receive(pbuf_pool_t *, void **, size_t *,
+    pbuf_t **);
+extern void pbuf_data_free(void *, pbuf_t *);
+
+#endif
+
+/** @}
+ */
@@ -40,6 +40,7 @@
 #include <inet/addr.h>
 #include <inet/endpoint.h>
 #include <inet/inet.h>
+#include <ipc/udp.h>
 #include <stdbool.h>
 
 /** UDP link state */
@@ -54,8 +55,20 @@ typedef struct {
 	sysarg_t assoc_id;
 	size_t size;
 	inet_ep_t remote_ep;
+	/** Message data if already transferred as part of a batch */
+	void *data;
 } udp_rmsg_t;
 
+/** UDP message to send as part of a batch */
+typedef struct {
+	/** Destination endpoint or @c NULL to use association default */
+	inet_ep_t *dest;
+	/** Message data */
+	void *data;
+	/** Message size */
+	size_t size;
+} udp_smsg_t;
+
 /** UDP received error */
 typedef struct {
 } udp_rerr_t;
@@ -88,15 +101,21 @@ typedef struct udp {
 	fibril_condvar_t cv;
 	/** Set to @a true when callback connection handler has terminated */
 	bool cb_done;
+	/** Buffer for batched receiving of messages */
+	void *rbuf;
 } udp_t;
 
 extern errno_t udp_create(udp_t **);
 extern void udp_destroy(udp_t *);
 extern errno_t udp_assoc_create(udp_t *, inet_ep2_t *, udp_cb_t *, void *,
     udp_assoc_t **);
+extern errno_t udp_assoc_create_flags(udp_t *, inet_ep2_t *,
+    udp_assoc_flags_t, udp_cb_t *, void *, udp_assoc_t **);
 extern errno_t udp_assoc_set_nolocal(udp_assoc_t *);
 extern void udp_assoc_destroy(udp_assoc_t *);
 extern errno_t udp_assoc_send_msg(udp_assoc_t *, inet_ep_t *, void *, size_t);
+extern errno_t udp_assoc_send_msgs(udp_assoc_t *, udp_smsg_t *, size_t,
+    size_t *);
 extern void *udp_assoc_userptr(udp_assoc_t *);
 extern size_t udp_rmsg_size(udp_rmsg_t *);
 extern errno_t udp_rmsg_read(udp_rmsg_t *, size_t, void *, size_t);
@@ -65,7 +65,8 @@ typedef enum {
 	INETCFG_SROUTE_CREATE,
 	INETCFG_SROUTE_DELETE,
 	INETCFG_SROUTE_GET,
-	INETCFG_SROUTE_GET_ID
+	INETCFG_SROUTE_GET_ID,
+	INETCFG_LINK_GET_NSTATS
 } inetcfg_request_t;
 
 /** Events on Inet ping port */
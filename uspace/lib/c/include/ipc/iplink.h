@@ -44,14 +44,31 @@ typedef enum {
 	IPLINK_SEND,
 	IPLINK_SEND6,
 	IPLINK_ADDR_ADD,
-	IPLINK_ADDR_REMOVE
+	IPLINK_ADDR_REMOVE,
+	IPLINK_GET_OFFLOAD,
+	IPLINK_GET_NSTATS
 } iplink_request_t;
 
 typedef enum {
 	IPLINK_EV_RECV = IPC_FIRST_USER_METHOD,
 	IPLINK_EV_CHANGE_ADDR,
+	IPLINK_EV_RECV_BATCH
 } iplink_event_t;
 
+/** Maximum number of SDUs delivered by one IPLINK_EV_RECV_BATCH event */
+#define IPLINK_EV_RECV_BATCH_MAX  32
+
+/** Maximum total size of SDUs in one IPLINK_EV_RECV_BATCH event */
+#define IPLINK_EV_RECV_BATCH_SIZE_MAX  (IPLINK_EV_RECV_BATCH_MAX * 65536)
+
+/** Description of one SDU in an IPLINK_EV_RECV_BATCH event */
+typedef struct {
+	/** Size of the SDU in bytes */
+	size_t size;
+	/** IP version (ip_ver_t) */
+	sysarg_t ver;
+} ipc_iplink_recv_ent_t;
+
 #endif
 
 /**
@@ -35,7 +35,9 @@
 #ifndef LIBC_IPC_UDP_H_
 #define LIBC_IPC_UDP_H_
 
+#include <inet/endpoint.h>
 #include <ipc/common.h>
+#include <stddef.h>
 
 typedef enum {
 	UDP_CALLBACK_CREATE = IPC_FIRST_USER_METHOD,
@@ -45,13 +47,41 @@ typedef enum {
 	UDP_ASSOC_SEND_MSG,
 	UDP_RMSG_INFO,
 	UDP_RMSG_READ,
-	UDP_RMSG_DISCARD
+	UDP_RMSG_DISCARD,
+	UDP_ASSOC_SEND_MSGS,
+	UDP_RMSG_READ_MSGS
 } udp_request_t;
 
 typedef enum {
 	UDP_EV_DATA = IPC_FIRST_USER_METHOD
 } udp_event_t;
 
+/** UDP association flags */
+typedef enum {
+	/** Allow several associations to share the same endpoint pair */
+	udp_af_reuseport = 0x1
+} udp_assoc_flags_t;
+
+/** Message record header in batched transfers.
+ *
+ * UDP_ASSOC_SEND_MSGS and UDP_RMSG_READ_MSGS transfer a sequence of
+ * records, each consisting of this header immediately followed by
+ * @c size bytes of message data, padded to a multiple of @c sizeof(sysarg_t).
+ */
+typedef struct {
+	/** Association ID (ignored when sending) */
+	sysarg_t assoc_id;
+	/** Remote endpoint, any to use the association default when sending */
+	inet_ep_t ep;
+	/** Size of message data */
+	size_t size;
+} udp_mrec_t;
+
+/** Size of a message record with @a size bytes of message data */
+#define UDP_MREC_SIZE(size) \
+	((sizeof(udp_mrec_t) + (size) + sizeof(sysarg_t) - 1) & \
+	~(sizeof(sysarg_t) - 1))
+
 #endif
 
 /** @}
@@ -46,6 +46,9 @@
 #define MAX_MNTOPTS_LEN 256
 #define PLB_SIZE        (2 * MAX_PATH_LEN)
 
+/** Maximum number of data transfers in a VFS_IN_READV/VFS_IN_WRITEV request */
+#define VFS_VEC_MAX     64
+
 /* Basic types. */
 typedef int16_t fs_handle_t;
 typedef uint32_t fs_index_t;
@@ -61,8 +64,38 @@ typedef struct {
 	unsigned int instance;
 	bool concurrent_read_write;
 	bool write_retains_size;
+	/** Name space and node attributes may be cached by VFS. */
+	bool cacheable;
 } vfs_info_t;
 
+/** VFS server statistics. */
+typedef struct {
+	/** Number of path lookups performed. */
+	uint64_t lookups;
+	/** Number of path lookups currently in progress. */
+	uint64_t lookups_active;
+	/** Maximum number of path lookups in progress at the same time. */
+	uint64_t lookups_active_max;
+	/** Number of path lookups which had to wait for PLB space. */
+	uint64_t lookup_waits;
+	/** Total time spent waiting for PLB space (in microseconds). */
+	uint64_t lookup_wait_usec;
+	/** Number of entries in the name cache. */
+	uint64_t dcache_entries;
+	/** Number of name cache hits. */
+	uint64_t dcache_hits;
+	/** Number of negative name cache hits. */
+	uint64_t dcache_neg_hits;
+	/** Number of name cache misses. */
+	uint64_t dcache_misses;
+	/** Number of entries in the attribute cache. */
+	uint64_t acache_entries;
+	/** Number of attribute cache hits. */
+	uint64_t acache_hits;
+	/** Number of attribute cache misses. */
+	uint64_t acache_misses;
+} vfs_stats_t;
+
 /** Data returned by filesystem probe regarding a specific volume. */
 typedef struct {
 	char label[FS_LABEL_MAXLEN + 1];
@@ -77,17 +110,20 @@ typedef enum {
 	VFS_IN_OPEN,
 	VFS_IN_PUT,
 	VFS_IN_READ,
+	VFS_IN_READV,
 	VFS_IN_REGISTER,
 	VFS_IN_RENAME,
 	VFS_IN_RESIZE,
 	VFS_IN_STAT,
 	VFS_IN_STATFS,
+	VFS_IN_STATS,
 	VFS_IN_SYNC,
 	VFS_IN_UNLINK,
 	VFS_IN_UNMOUNT,
 	VFS_IN_WAIT_HANDLE,
 	VFS_IN_WALK,
 	VFS_IN_WRITE,
+	VFS_IN_WRITEV,
 } vfs_in_request_t;
 
 typedef enum {
@@ -75,6 +75,13 @@
 #define NIC_DEFECTIVE_BAD_TCP_CHECKSUM   0x0080
 #define NIC_DEFECTIVE_BAD_UDP_CHECKSUM   0x0100
 
+/**
+ * NIC completes partial transport-layer checksums of frames sent with
+ * nic_send_frame_csum(): the checksum field holds the folded pseudo-header
+ * sum and the NIC sums up the frame from the checksum start to its end.
+ */
+#define NIC_OFFLOAD_TX_CSUM  0x0001
+
 /**
  * The bitmap uses single bit for each of the 2^12 = 4096 possible VLAN tags.
  * This means its size is 4096/8 = 512 bytes.
@@ -222,6 +229,13 @@ typedef struct nic_device_stats {
 	unsigned long receive_compressed;
 	/** Total compressed packet transmitted. */
 	unsigned long send_compressed;
+
+	/* receive batching */
+
+	/** Number of deliveries of received frames to the client */
+	unsigned long receive_batches;
+	/** Total time received frames spent queued for delivery (in usec) */
+	unsigned long receive_queue_usec;
 } nic_device_stats_t;
 
 /** Errors corresponding to those in the nic_device_stats_t */
@@ -50,6 +50,12 @@ typedef struct {
 	uint8_t tos;
 	void *data;
 	size_t size;
+	/**
+	 * Offset of the transport checksum field in @c data if it only holds
+	 * the pseudo-header sum and the rest of the sum is to be completed by
+	 * the network layer or the NIC, zero if the datagram is complete
+	 */
+	uint16_t csum_offs;
 } inet_dgram_t;
 
 typedef struct {
@@ -0,0 +1,63 @@
+/*
+ * Copyright (c) 2019 Jiri Svoboda
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * - Redistributions of source code must retain the above copyright
+ *   notice, this list of conditions and the following disclaimer.
+ * - Redistributions in binary form must reproduce the above copyright
+ *   notice, this list of conditions and the following disclaimer in the
+ *   documentation and/or other materials provided with the distribution.
+ * - The name of the author may not be used to endorse or promote products
+ *   derived from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHOR ``AS IS'' AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+ * OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+ * IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT
+ * NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF
+ * THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/** @addtogroup libc
+ * @{
+ */
+/** @file
+ */
+
+#ifndef LIBC_TYPES_INET_NSTATS_H_
+#define LIBC_TYPES_INET_NSTATS_H_
+
+#include <stdint.h>
+
+/** Neighbour cache (ARP/NDP) statistics */
+typedef struct {
+	/** Number of entries in the cache */
+	uint64_t entries;
+	/** Lookups answered from the cache */
+	uint64_t hits;
+	/** Lookups that started address resolution */
+	uint64_t misses;
+	/** Lookups answered from negative entries */
+	uint64_t neg_hits;
+	/** Packets queued waiting for address resolution */
+	uint64_t queued;
+	/** Queued packets dropped (queue overflow or failed resolution) */
+	uint64_t dropped;
+	/** Solicitations (ARP requests, neighbour solicitations) sent */
+	uint64_t solicits;
+	/** Entries removed after their lifetime expired */
+	uint64_t expired;
+} inet_nstats_t;
+
+#endif
+
+/** @}
+ */
@@ -36,7 +36,9 @@
 #define LIBC_TYPES_INETCFG_H_
 
 #include <inet/inet.h>
+#include <types/inet/nstats.h>
 #include <stddef.h>
+#include <stdint.h>
 
 /** Address object info */
 typedef struct {
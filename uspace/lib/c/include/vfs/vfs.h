@@ -66,6 +66,14 @@ typedef struct {
 	service_id_t service;
 } vfs_stat_t;
 
+/** I/O vector element */
+typedef struct {
+	/** Buffer */
+	void *base;
+	/** Buffer size in bytes */
+	size_t size;
+} vfs_iovec_t;
+
 typedef struct {
 	char fs_name[FS_NAME_MAXLEN + 1];
 	uint32_t f_bsize;    /* fundamental file system block size */
@@ -104,6 +112,10 @@ extern errno_t vfs_pass_handle(async_exch_t *, int, async_exch_t *);
 extern errno_t vfs_put(int);
 extern errno_t vfs_read(int, aoff64_t *, void *, size_t, size_t *);
 extern errno_t vfs_read_short(int, aoff64_t, void *, size_t, ssize_t *);
+extern errno_t vfs_readv(int, aoff64_t *, const vfs_iovec_t *, size_t,
+    size_t *);
+extern errno_t vfs_readv_short(int, aoff64_t, const vfs_iovec_t *, size_t,
+    ssize_t *);
 extern errno_t vfs_receive_handle(bool, int *);
 extern errno_t vfs_rename_path(const char *, const char *);
 extern errno_t vfs_resize(int, aoff64_t);
@@ -113,6 +125,7 @@ extern errno_t vfs_stat(int, vfs_stat_t *);
 extern errno_t vfs_stat_path(const char *, vfs_stat_t *);
 extern errno_t vfs_statfs(int, vfs_statfs_t *);
 extern errno_t vfs_statfs_path(const char *, vfs_statfs_t *);
+extern errno_t vfs_stats(vfs_stats_t *);
 extern errno_t vfs_sync(int);
 extern errno_t vfs_unlink(int, const char *, int);
 extern errno_t vfs_unlink_path(const char *);
@@ -121,6 +134,10 @@ extern errno_t vfs_unmount_path(const char *);
 extern errno_t vfs_walk(int, const char *, int, int *);
 extern errno_t vfs_write(int, aoff64_t *, const void *, size_t, size_t *);
 extern errno_t vfs_write_short(int, aoff64_t, const void *, size_t, ssize_t *);
+extern errno_t vfs_writev(int, aoff64_t *, const vfs_iovec_t *, size_t,
+    size_t *);
+extern errno_t vfs_writev_short(int, aoff64_t, const vfs_iovec_t *, size_t,
+    ssize_t *);
 
 #endif
 
@@ -0,0 +1,70 @@
+/*
+ * Copyright (c) 2019 Jiri Svoboda
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * - Redistributions of source code must retain the above copyright
+ *   notice, this list of conditions and the following disclaimer.
+ * - Redistributions in binary form must reproduce the above copyright
+ *   notice, this list of conditions and the following disclaimer in the
+ *   documentation and/or other materials provided with the distribution.
+ * - The name of the author may not be used to endorse or promote products
+ *   derived from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHOR ``AS IS'' AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+ * OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+ * IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT
+ * NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF
+ * THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/** @addtogroup libc
+ * @{
+ */
+/** @file Asynchronous file I/O.
+ */
+
+#ifndef LIBC_VFS_AIO_H_
+#define LIBC_VFS_AIO_H_
+
+#include <errno.h>
+#include <offset.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <time.h>
+
+/** Asynchronous I/O request */
+typedef struct vfs_aio vfs_aio_t;
+
+/** Queue of asynchronous I/O requests */
+typedef struct vfs_aio_queue vfs_aio_queue_t;
+
+/** Default maximum number of requests in progress in one queue */
+#define VFS_AIO_DEPTH_DEFAULT  16
+
+extern errno_t vfs_aio_queue_create(size_t, vfs_aio_queue_t **);
+extern void vfs_aio_queue_destroy(vfs_aio_queue_t *);
+extern errno_t vfs_aio_read(vfs_aio_queue_t *, int, aoff64_t, void *, size_t,
+    void *, vfs_aio_t **);
+extern errno_t vfs_aio_write(vfs_aio_queue_t *, int, aoff64_t, const void *,
+    size_t, void *, vfs_aio_t **);
+extern bool vfs_aio_poll(vfs_aio_t *);
+extern errno_t vfs_aio_wait(vfs_aio_t *, size_t *);
+extern errno_t vfs_aio_wait_any(vfs_aio_queue_t *, usec_t, vfs_aio_t **);
+extern errno_t vfs_aio_result(vfs_aio_t *, size_t *);
+extern void *vfs_aio_arg(vfs_aio_t *);
+extern errno_t vfs_aio_cancel(vfs_aio_t *);
+extern void vfs_aio_destroy(vfs_aio_t *);
+
+#endif
+
+/** @}
+ */
@@ -0,0 +1,161 @@
+/*
+ * Copyright (c) 2019 Jiri Svoboda
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * - Redistributions of source code must retain the above copyright
+ *   notice, this list of conditions and the following disclaimer.
+ * - Redistributions in binary form must reproduce the above copyright
+ *   notice, this list of conditions and the following disclaimer in the
+ *   documentation and/or other materials provided with the distribution.
+ * - The name of the author may not be used to endorse or promote products
+ *   derived from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHOR ``AS IS'' AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+ * OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+ * IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT
+ * NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF
+ * THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <adt/checksum.h>
+#include <pcut/pcut.h>
+#include <stdint.h>
+
+PCUT_INIT;
+
+PCUT_TEST_SUITE(checksum);
+
+enum {
+	test_size = 1000
+};
+
+/** Standard check string for CRC algorithms */
+static uint8_t check_str[] = "123456789";
+
+static uint8_t test_data[test_size];
+
+static void test_data_init(void)
+{
+	size_t i;
+
+	for (i = 0; i < test_size; i++)
+		test_data[i] = (uint8_t) (i * 31 + (i >> 3));
+}
+
+/** Reference Internet checksum, one 16-bit word at a time */
+static uint16_t ocsum_ref(const uint8_t *data, size_t size)
+{
+	uint32_t sum = 0;
+	size_t i;
+
+	for (i = 0; i + 1 < size; i += 2) {
+		sum += ((uint32_t) data[i] << 8) | data[i + 1];
+		sum = (sum & 0xffff) + (sum >> 16);
+	}
+
+	if (i < size) {
+		sum += (uint32_t) data[i] << 8;
+		sum = (sum & 0xffff) + (sum >> 16);
+	}
+
+	return sum;
+}
+
+/** CRC32 of the standard check string */
+PCUT_TEST(crc32_check)
+{
+	PCUT_ASSERT_INT_EQUALS(0xcbf43926, compute_crc32(check_str, 9));
+}
+
+/** CRC32C of the standard check string */
+PCUT_TEST(crc32c_check)
+{
+	PCUT_ASSERT_INT_EQUALS(0xe3069283, compute_crc32c(check_str, 9));
+}
+
+/** Seeded and combined CRCs match CRC of the whole data */
+PCUT_TEST(crc_seed_combine)
+{
+	uint32_t crc;
+	uint32_t crcc;
+	uint32_t crc1;
+	uint32_t crc2;
+	size_t split;
+
+	test_data_init();
+	crc = compute_crc32(test_data, test_size);
+	crcc = compute_crc32c(test_data, test_size);
+
+	for (split = 0; split <= test_size; split += 37) {
+		crc1 = compute_crc32(test_data, split);
+		crc2 = compute_crc32(test_data + split, test_size - split);
+		PCUT_ASSERT_INT_EQUALS(crc, compute_crc32_seed(test_data +
+		    split, test_size - split, crc1));
+		PCUT_ASSERT_INT_EQUALS(crc, crc32_combine(crc1, crc2,
+		    test_size - split));
+
+		crc1 = compute_crc32c(test_data, split);
+		crc2 = compute_crc32c(test_data + split, test_size - split);
+		PCUT_ASSERT_INT_EQUALS(crcc, compute_crc32c_seed(test_data +
+		    split, test_size - split, crc1));
+		PCUT_ASSERT_INT_EQUALS(crcc, crc32c_combine(crc1, crc2,
+		    test_size - split));
+	}
+}
+
+/** Internet checksum example from RFC 1071 */
+PCUT_TEST(ocsum_rfc1071)
+{
+	uint8_t data[] = { 0x00, 0x01, 0xf2, 0x03, 0xf4, 0xf5, 0xf6, 0xf7 };
+
+	PCUT_ASSERT_INT_EQUALS(0xddf2, compute_ocsum(data, sizeof(data), 0));
+}
+
+/** Internet checksum matches reference for all lengths and alignments */
+PCUT_TEST(ocsum_ref)
+{
+	size_t offs;
+	size_t size;
+
+	test_data_init();
+
+	for (offs = 0; offs < 4; offs++) {
+		for (size = 0; size <= test_size - offs; size++) {
+			PCUT_ASSERT_INT_EQUALS(ocsum_ref(test_data + offs,
+			    size), compute_ocsum(test_data + offs, size, 0));
+		}
+	}
+}
+
+/** Combining sums at even and odd offsets */
+PCUT_TEST(ocsum_combine)
+{
+	uint16_t sum1;
+	uint16_t sum2;
+	size_t split;
+
+	test_data_init();
+
+	for (split = 0; split <= test_size; split += 13) {
+		sum1 = compute_ocsum(test_data, split, 0);
+		sum2 = compute_ocsum(test_data + split, test_size - split, 0);
+		PCUT_ASSERT_INT_EQUALS(ocsum_ref(test_data, test_size),
+		    ocsum_combine(sum1, sum2, split));
+		if (split % 2 == 0) {
+			PCUT_ASSERT_INT_EQUALS(ocsum_ref(test_data, test_size),
+			    compute_ocsum(test_data + split,
+			    test_size - split, sum1));
+		}
+	}
+}
+
+PCUT_EXPORT(checksum);
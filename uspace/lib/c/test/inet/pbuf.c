@@ -0,0 +1,195 @@
+/*
+ * Copyright (c) 2019 Jiri Svoboda
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * - Redistributions of source code must retain the above copyright
+ *   notice, this list of conditions and the following disclaimer.
+ * - Redistributions in binary form must reproduce the above copyright
+ *   notice, this list of conditions and the following disclaimer in the
+ *   documentation and/or other materials provided with the distribution.
+ * - The name of the author may not be used to endorse or promote products
+ *   derived from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHOR ``AS IS'' AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+ * OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+ * IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT
+ * NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF
+ * THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <inet/pbuf.h>
+#include <mem.h>
+#include <pcut/pcut.h>
+#include <stdint.h>
+#include <stdlib.h>
+
+PCUT_INIT;
+
+PCUT_TEST_SUITE(inet_pbuf);
+
+enum {
+	/** Number of buffers in test pool */
+	test_count = 2,
+	/** Buffer size */
+	test_bsize = 128,
+	/** Headroom */
+	test_headroom = 16
+};
+
+/** Create and destroy pool */
+PCUT_TEST(pool_create_destroy)
+{
+	pbuf_pool_t *pool;
+	errno_t rc;
+
+	rc = pbuf_pool_create(test_count, test_bsize, test_headroom, &pool);
+	PCUT_ASSERT_ERRNO_VAL(EOK, rc);
+
+	pbuf_pool_destroy(pool);
+}
+
+/** Headroom larger than buffer is rejected */
+PCUT_TEST(pool_create_bad_headroom)
+{
+	pbuf_pool_t *pool;
+	errno_t rc;
+
+	rc = pbuf_pool_create(test_count, test_bsize, test_bsize + 1, &pool);
+	PCUT_ASSERT_ERRNO_VAL(EINVAL, rc);
+}
+
+/** Push, pull, put and trim move the data window in place */
+PCUT_TEST(push_pull_put_trim)
+{
+	pbuf_pool_t *pool;
+	pbuf_t *pbuf;
+	uint8_t *data;
+	uint8_t *hdr;
+	uint8_t *p;
+	errno_t rc;
+
+	rc = pbuf_pool_create(test_count, test_bsize, test_headroom, &pool);
+	PCUT_ASSERT_ERRNO_VAL(EOK, rc);
+
+	rc = pbuf_alloc(pool, &pbuf);
+	PCUT_ASSERT_ERRNO_VAL(EOK, rc);
+
+	PCUT_ASSERT_INT_EQUALS(0, pbuf_size(pbuf));
+	PCUT_ASSERT_INT_EQUALS(test_headroom, pbuf_headroom(pbuf));
+	PCUT_ASSERT_INT_EQUALS(test_bsize - test_headroom, pbuf_tailroom(pbuf));
+
+	data = pbuf_put(pbuf, 10);
+	PCUT_ASSERT_NOT_NULL(data);
+	PCUT_ASSERT_TRUE(data == pbuf_data(pbuf));
+	memset(data, 0xaa, 10);
+	PCUT_ASSERT_INT_EQUALS(10, pbuf_size(pbuf));
+
+	hdr = pbuf_push(pbuf, 4);
+	PCUT_ASSERT_NOT_NULL(hdr);
+	PCUT_ASSERT_TRUE(hdr + 4 == data);
+	PCUT_ASSERT_INT_EQUALS(14, pbuf_size(pbuf));
+	PCUT_ASSERT_INT_EQUALS(test_headroom - 4, pbuf_headroom(pbuf));
+
+	/* Not enough headroom */
+	p = pbuf_push(pbuf, test_headroom);
+	PCUT_ASSERT_NULL(p);
+
+	p = pbuf_pull(pbuf, 4);
+	PCUT_ASSERT_TRUE(p == hdr);
+	PCUT_ASSERT_TRUE(pbuf_data(pbuf) == data);
+	PCUT_ASSERT_INT_EQUALS(0xaa, data[9]);
+
+	/* Packet too short */
+	p = pbuf_pull(pbuf, 11);
+	PCUT_ASSERT_NULL(p);
+
+	/* Not enough tailroom */
+	p = pbuf_put(pbuf, pbuf_tailroom(pbuf) + 1);
+	PCUT_ASSERT_NULL(p);
+
+	pbuf_trim(pbuf, 3);
+	PCUT_ASSERT_INT_EQUALS(3, pbuf_size(pbuf));
+
+	pbuf_release(pbuf);
+	pbuf_pool_destroy(pool);
+}
+
+/** Buffer is recycled only when the last reference is dropped */
+PCUT_TEST(ref_release)
+{
+	pbuf_pool_t *pool;
+	pbuf_t *pbuf;
+	pbuf_t *pbuf2;
+	errno_t rc;
+
+	rc = pbuf_pool_create(1, test_bsize, test_headroom, &pool);
+	PCUT_ASSERT_ERRNO_VAL(EOK, rc);
+
+	rc = pbuf_alloc(pool, &pbuf);
+	PCUT_ASSERT_ERRNO_VAL(EOK, rc);
+	PCUT_ASSERT_TRUE(pbuf->pool == pool);
+
+	pbuf_ref(pbuf);
+	pbuf_release(pbuf);
+
+	/* Still referenced, so the pool is exhausted and we get a heap buffer */
+	rc = pbuf_alloc(pool, &pbuf2);
+	PCUT_ASSERT_ERRNO_VAL(EOK, rc);
+	PCUT_ASSERT_NULL(pbuf2->pool);
+	PCUT_ASSERT_INT_EQUALS(test_headroom, pbuf_headroom(pbuf2));
+	pbuf_release(pbuf2);
+
+	pbuf_release(pbuf);
+
+	/* Now the pooled buffer is returned again */
+	rc = pbuf_alloc(pool, &pbuf2);
+	PCUT_ASSERT_ERRNO_VAL(EOK, rc);
+	PCUT_ASSERT_TRUE(pbuf2 == pbuf);
+	pbuf_release(pbuf2);
+
+	pbuf_pool_destroy(pool);
+}
+
+/** Received data is returned to the pool or freed from the heap */
+PCUT_TEST(data_free)
+{
+	pbuf_pool_t *pool;
+	pbuf_t *pbuf;
+	pbuf_t *pbuf2;
+	void *data;
+	errno_t rc;
+
+	rc = pbuf_pool_create(1, test_bsize, test_headroom, &pool);
+	PCUT_ASSERT_ERRNO_VAL(EOK, rc);
+
+	rc = pbuf_alloc(pool, &pbuf);
+	PCUT_ASSERT_ERRNO_VAL(EOK, rc);
+
+	data = pbuf_put(pbuf, 10);
+	PCUT_ASSERT_NOT_NULL(data);
+	pbuf_data_free(data, pbuf);
+
+	/* The buffer is back in the pool */
+	rc = pbuf_alloc(pool, &pbuf2);
+	PCUT_ASSERT_ERRNO_VAL(EOK, rc);
+	PCUT_ASSERT_TRUE(pbuf2 == pbuf);
+	pbuf_release(pbuf2);
+
+	/* Data which did not fit into a packet buffer */
+	data = malloc(test_bsize + 1);
+	PCUT_ASSERT_NOT_NULL(data);
+	pbuf_data_free(data, NULL);
+
+	pbuf_pool_destroy(pool);
+}
+
+PCUT_EXPORT(inet_pbuf);
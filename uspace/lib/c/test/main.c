@@ -32,7 +32,9 @@
 PCUT_INIT;
 
 PCUT_IMPORT(circ_buf);
+PCUT_IMPORT(checksum);
 PCUT_IMPORT(fibril_timer);
+PCUT_IMPORT(inet_pbuf);
 PCUT_IMPORT(inttypes);
 PCUT_IMPORT(mem);
 PCUT_IMPORT(odict);
@@ -45,5 +47,6 @@ PCUT_IMPORT(stdlib);
 PCUT_IMPORT(str);
 PCUT_IMPORT(string);
 PCUT_IMPORT(table);
+PCUT_IMPORT(vfs_aio);
 
 PCUT_MAIN();
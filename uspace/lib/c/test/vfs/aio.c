@@ -0,0 +1,183 @@
+/*
+ * Copyright (c) 2019 Jiri Svoboda
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * - Redistributions of source code must retain the above copyright
+ *   notice, this list of conditions and the following disclaimer.
+ * - Redistributions in binary form must reproduce the above copyright
+ *   notice, this list of conditions and the following disclaimer in the
+ *   documentation and/or other materials provided with the distribution.
+ * - The name of the author may not be used to endorse or promote products
+ *   derived from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHOR ``AS IS'' AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+ * OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+ * IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT
+ * NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF
+ * THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <mem.h>
+#include <pcut/pcut.h>
+#include <stdio.h>
+#include <vfs/vfs.h>
+#include <vfs/vfs_aio.h>
+
+PCUT_INIT;
+
+PCUT_TEST_SUITE(vfs_aio);
+
+enum {
+	/** Number of blocks to transfer */
+	test_blocks = 8,
+	/** Block size */
+	test_bsize = 512
+};
+
+static uint8_t wbuf[test_blocks][test_bsize];
+static uint8_t rbuf[test_blocks][test_bsize];
+
+/** Create temporary file */
+static int test_file_create(char *name)
+{
+	char *p;
+	errno_t rc;
+	int fd;
+
+	p = tmpnam(name);
+	PCUT_ASSERT_NOT_NULL(p);
+
+	rc = vfs_lookup_open(name, WALK_REGULAR | WALK_MUST_CREATE,
+	    MODE_READ | MODE_WRITE, &fd);
+	PCUT_ASSERT_ERRNO_VAL(EOK, rc);
+
+	return fd;
+}
+
+/** Write blocks out of order, then read them back, more than depth at once */
+PCUT_TEST(write_read)
+{
+	char name[L_tmpnam];
+	vfs_aio_queue_t *queue;
+	vfs_aio_t *aio;
+	size_t nbytes;
+	size_t cnt;
+	errno_t rc;
+	int fd;
+	int i;
+
+	fd = test_file_create(name);
+
+	rc = vfs_aio_queue_create(3, &queue);
+	PCUT_ASSERT_ERRNO_VAL(EOK, rc);
+
+	for (i = 0; i < test_blocks; i++)
+		memset(wbuf[i], 'a' + i, test_bsize);
+
+	for (i = test_blocks - 1; i >= 0; i--) {
+		rc = vfs_aio_write(queue, fd, i * test_bsize, wbuf[i],
+		    test_bsize, NULL, &aio);
+		PCUT_ASSERT_ERRNO_VAL(EOK, rc);
+
+		rc = vfs_aio_wait(aio, &nbytes);
+		PCUT_ASSERT_ERRNO_VAL(EOK, rc);
+		PCUT_ASSERT_INT_EQUALS(test_bsize, nbytes);
+		vfs_aio_destroy(aio);
+	}
+
+	for (i = 0; i < test_blocks; i++) {
+		rc = vfs_aio_read(queue, fd, i * test_bsize, rbuf[i],
+		    test_bsize, rbuf[i], &aio);
+		PCUT_ASSERT_ERRNO_VAL(EOK, rc);
+	}
+
+	cnt = 0;
+	while ((rc = vfs_aio_wait_any(queue, -1, &aio)) == EOK) {
+		rc = vfs_aio_result(aio, &nbytes);
+		PCUT_ASSERT_ERRNO_VAL(EOK, rc);
+		PCUT_ASSERT_INT_EQUALS(test_bsize, nbytes);
+
+		i = (uint8_t (*)[test_bsize]) vfs_aio_arg(aio) - rbuf;
+		PCUT_ASSERT_INT_EQUALS(0, memcmp(rbuf[i], wbuf[i],
+		    test_bsize));
+
+		vfs_aio_destroy(aio);
+		++cnt;
+	}
+
+	PCUT_ASSERT_ERRNO_VAL(ENOENT, rc);
+	PCUT_ASSERT_INT_EQUALS(test_blocks, cnt);
+
+	vfs_aio_queue_destroy(queue);
+	vfs_put(fd);
+	(void) vfs_unlink_path(name);
+}
+
+/** Requests over the queue depth can be cancelled */
+PCUT_TEST(cancel)
+{
+	char name[L_tmpnam];
+	vfs_aio_queue_t *queue;
+	vfs_aio_t *aio[2];
+	size_t nbytes;
+	errno_t rc;
+	int fd;
+
+	fd = test_file_create(name);
+
+	rc = vfs_aio_queue_create(1, &queue);
+	PCUT_ASSERT_ERRNO_VAL(EOK, rc);
+
+	rc = vfs_aio_read(queue, fd, 0, rbuf[0], test_bsize, NULL, &aio[0]);
+	PCUT_ASSERT_ERRNO_VAL(EOK, rc);
+	rc = vfs_aio_read(queue, fd, 0, rbuf[1], test_bsize, NULL, &aio[1]);
+	PCUT_ASSERT_ERRNO_VAL(EOK, rc);
+
+	/* Unless the first one already completed, the second one waits */
+	rc = vfs_aio_cancel(aio[1]);
+	if (rc == EOK) {
+		rc = vfs_aio_wait(aio[1], &nbytes);
+		PCUT_ASSERT_ERRNO_VAL(ECANCELED, rc);
+	}
+
+	/* Empty file */
+	rc = vfs_aio_wait(aio[0], &nbytes);
+	PCUT_ASSERT_ERRNO_VAL(EOK, rc);
+	PCUT_ASSERT_INT_EQUALS(0, nbytes);
+
+	rc = vfs_aio_cancel(aio[0]);
+	PCUT_ASSERT_ERRNO_VAL(EALREADY, rc);
+
+	vfs_aio_destroy(aio[0]);
+	vfs_aio_destroy(aio[1]);
+	vfs_aio_queue_destroy(queue);
+	vfs_put(fd);
+	(void) vfs_unlink_path(name);
+}
+
+/** Waiting on an empty queue */
+PCUT_TEST(wait_empty)
+{
+	vfs_aio_queue_t *queue;
+	vfs_aio_t *aio;
+	errno_t rc;
+
+	rc = vfs_aio_queue_create(0, &queue);
+	PCUT_ASSERT_ERRNO_VAL(EOK, rc);
+
+	rc = vfs_aio_wait_any(queue, 0, &aio);
+	PCUT_ASSERT_ERRNO_VAL(ENOENT, rc);
+
+	vfs_aio_queue_destroy(queue);
+}
+
+PCUT_EXPORT(vfs_aio);
@@ -954,7 +954,15 @@ namespace std
             size_type front_bucket_;
             size_type back_bucket_;
 
-            static constexpr size_type bucket_size_{16};
+            /**
+             * Buckets span about 512 bytes so that small elements
+             * do not need a bucket allocation every few insertions
+             * and traversals stay within a few cache lines, large
+             * elements get at least 16 per bucket.
+             */
+            static constexpr size_type bucket_size_{
+                sizeof(value_type) < 32 ? 512 / sizeof(value_type) : 16
+            };
             static constexpr size_type default_bucket_count_{2};
             static constexpr size_type default_bucket_capacity_{4};
             static constexpr size_type default_front_{1};
@@ -1169,14 +1177,13 @@ namespace std
         auto min_size = min(lhs.size(), rhs.size());
         for (decltype(lhs.size()) i = 0; i < min_size; ++i)
         {
-            if (lhs[i] >= rhs[i])
+            if (lhs[i] < rhs[i])
+                return true;
+            if (rhs[i] < lhs[i])
                 return false;
         }
 
-        if (lhs.size() == rhs.size())
-            return true;
-        else
-            return lhs.size() < rhs.size();
+        return lhs.size() < rhs.size();
     }
 
     template<class T, class Allocator>
@@ -1213,6 +1220,15 @@ namespace std
     {
         lhs.swap(rhs);
     }
+
+    namespace pmr
+    {
+        template<class T>
+        class polymorphic_allocator;
+
+        template<class T>
+        using deque = std::deque<T, polymorphic_allocator<T>>;
+    }
 }
 
 #endif
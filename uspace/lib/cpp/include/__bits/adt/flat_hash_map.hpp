@@ -0,0 +1,1028 @@
+/*
+ * Copyright (c) 2019 Jaroslav Jindrak
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * - Redistributions of source code must retain the above copyright
+ *   notice, this list of conditions and the following disclaimer.
+ * - Redistributions in binary form must reproduce the above copyright
+ *   notice, this list of conditions and the following disclaimer in the
+ *   documentation and/or other materials provided with the distribution.
+ * - The name of the author may not be used to endorse or promote products
+ *   derived from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHOR ``AS IS'' AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+ * OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+ * IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT
+ * NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF
+ * THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef LIBCPP_BITS_ADT_FLAT_HASH_MAP
+#define LIBCPP_BITS_ADT_FLAT_HASH_MAP
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <functional>
+#include <initializer_list>
+#include <iterator>
+#include <memory>
+#include <utility>
+
+/**
+ * HelenOS extension: std::hel::flat_hash_map, an open addressing
+ * hash map that stores its elements in a single array next to an
+ * array of one byte control words (the "Swiss table" layout).
+ *
+ * Each control byte is either empty, deleted (a tombstone), the
+ * end of table sentinel or, for full slots, the low 7 bits of the
+ * hash of the key stored there. Lookups probe whole groups of
+ * control bytes at once and compare keys only for slots whose
+ * control byte matches, which avoids both per element allocations
+ * and the pointer chasing of the node based unordered containers.
+ *
+ * Iterators, pointers and references to elements are invalidated
+ * by any insertion that causes a rehash.
+ */
+
+namespace std::aux
+{
+    using flat_ctrl_t = signed char;
+
+    inline constexpr flat_ctrl_t flat_ctrl_empty{-128};
+    inline constexpr flat_ctrl_t flat_ctrl_deleted{-2};
+    inline constexpr flat_ctrl_t flat_ctrl_sentinel{-1};
+
+    inline bool flat_ctrl_is_full(flat_ctrl_t ctrl)
+    {
+        return ctrl >= 0;
+    }
+
+    /**
+     * Our std::hash is the identity for arithmetic types,
+     * so the bits have to be mixed before they are split
+     * into the probe start (h1) and the control byte (h2).
+     */
+    inline size_t flat_mix(size_t hash)
+    {
+        uint64_t x = static_cast<uint64_t>(hash) * 0x9E3779B97F4A7C15ULL;
+
+        return static_cast<size_t>(x ^ (x >> 32));
+    }
+
+    inline size_t flat_h1(size_t hash)
+    {
+        return hash >> 7;
+    }
+
+    inline flat_ctrl_t flat_h2(size_t hash)
+    {
+        return static_cast<flat_ctrl_t>(hash & 0x7F);
+    }
+
+#if defined(__SSE2__)
+    /**
+     * Group of 16 control bytes compared with single
+     * SSE2 instructions.
+     */
+    class flat_group
+    {
+        public:
+            static constexpr size_t width{16};
+            using mask_type = uint32_t;
+
+            explicit flat_group(const flat_ctrl_t* ctrl)
+            {
+                memcpy(&ctrl_, ctrl, width);
+            }
+
+            mask_type match(flat_ctrl_t h2) const
+            {
+                return to_mask_(ctrl_ == splat_(h2));
+            }
+
+            mask_type match_empty() const
+            {
+                return to_mask_(ctrl_ == splat_(flat_ctrl_empty));
+            }
+
+            mask_type match_empty_or_deleted() const
+            {
+                return to_mask_(ctrl_ < splat_(flat_ctrl_sentinel));
+            }
+
+            static size_t lowest(mask_type mask)
+            {
+                return __builtin_ctz(mask);
+            }
+
+            static size_t leading(mask_type mask)
+            {
+                return mask ? __builtin_clz(mask) - 16 : width;
+            }
+
+        private:
+            using vector_type = signed char __attribute__((vector_size(16)));
+            using byte_vector_type = char __attribute__((vector_size(16)));
+
+            vector_type ctrl_;
+
+            static vector_type splat_(flat_ctrl_t ctrl)
+            {
+                return vector_type{} + ctrl;
+            }
+
+            template<class Vector>
+            static mask_type to_mask_(Vector cmp)
+            {
+                return static_cast<mask_type>(
+                    __builtin_ia32_pmovmskb128((byte_vector_type)cmp)
+                );
+            }
+    };
+#else
+    /**
+     * Group of 8 control bytes compared as a single 64 bit
+     * word, the resulting masks have the top bit of each
+     * matching byte set.
+     */
+    class flat_group
+    {
+        public:
+            static constexpr size_t width{8};
+            using mask_type = uint64_t;
+
+            explicit flat_group(const flat_ctrl_t* ctrl)
+            {
+                memcpy(&ctrl_, ctrl, width);
+#if __BYTE_ORDER__ == __ORDER_BIG_ENDIAN__
+                ctrl_ = __builtin_bswap64(ctrl_);
+#endif
+            }
+
+            mask_type match(flat_ctrl_t h2) const
+            {
+                /**
+                 * Note: This can report a false positive for a byte
+                 *       following a real match, which is harmless as
+                 *       every match is verified by comparing keys.
+                 */
+                auto x = ctrl_ ^ (lsbs_ * static_cast<uint8_t>(h2));
+
+                return (x - lsbs_) & ~x & msbs_;
+            }
+
+            mask_type match_empty() const
+            {
+                // Empty is the only value with bit 7 set and bit 1 clear.
+                return ctrl_ & ~(ctrl_ << 6) & msbs_;
+            }
+
+            mask_type match_empty_or_deleted() const
+            {
+                // Sentinel is the only special value with bit 0 set.
+                return ctrl_ & ~(ctrl_ << 7) & msbs_;
+            }
+
+            static size_t lowest(mask_type mask)
+            {
+                return __builtin_ctzll(mask) / 8;
+            }
+
+            static size_t leading(mask_type mask)
+            {
+                return mask ? __builtin_clzll(mask) / 8 : width;
+            }
+
+        private:
+            static constexpr uint64_t lsbs_{0x0101010101010101ULL};
+            static constexpr uint64_t msbs_{0x8080808080808080ULL};
+
+            uint64_t ctrl_;
+    };
+#endif
+
+    template<class Value, class Reference, class Pointer>
+    class flat_hash_map_iterator
+    {
+        public:
+            using value_type      = Value;
+            using reference       = Reference;
+            using pointer         = Pointer;
+            using difference_type = ptrdiff_t;
+
+            using iterator_category = forward_iterator_tag;
+
+            flat_hash_map_iterator(const flat_ctrl_t* ctrl = nullptr,
+                                   value_type* slot = nullptr)
+                : ctrl_{ctrl}, slot_{slot}
+            { /* DUMMY BODY */ }
+
+            template<class R, class P>
+            flat_hash_map_iterator(const flat_hash_map_iterator<Value, R, P>& other)
+                : ctrl_{other.ctrl()}, slot_{other.slot()}
+            { /* DUMMY BODY */ }
+
+            reference operator*() const
+            {
+                return *slot_;
+            }
+
+            pointer operator->() const
+            {
+                return slot_;
+            }
+
+            flat_hash_map_iterator& operator++()
+            {
+                ++ctrl_;
+                ++slot_;
+                skip_empty_();
+
+                return *this;
+            }
+
+            flat_hash_map_iterator operator++(int)
+            {
+                auto tmp = *this;
+                ++(*this);
+
+                return tmp;
+            }
+
+            const flat_ctrl_t* ctrl() const
+            {
+                return ctrl_;
+            }
+
+            value_type* slot() const
+            {
+                return slot_;
+            }
+
+            /**
+             * Moves to the first full slot at or after the
+             * current one, the sentinel stops the scan.
+             */
+            void skip_empty_()
+            {
+                while (*ctrl_ < flat_ctrl_sentinel)
+                {
+                    ++ctrl_;
+                    ++slot_;
+                }
+            }
+
+        private:
+            const flat_ctrl_t* ctrl_;
+            value_type* slot_;
+    };
+
+    template<class Value, class R1, class P1, class R2, class P2>
+    bool operator==(const flat_hash_map_iterator<Value, R1, P1>& lhs,
+                    const flat_hash_map_iterator<Value, R2, P2>& rhs)
+    {
+        return lhs.slot() == rhs.slot();
+    }
+
+    template<class Value, class R1, class P1, class R2, class P2>
+    bool operator!=(const flat_hash_map_iterator<Value, R1, P1>& lhs,
+                    const flat_hash_map_iterator<Value, R2, P2>& rhs)
+    {
+        return !(lhs == rhs);
+    }
+}
+
+namespace std::hel
+{
+    template<
+        class Key, class Value,
+        class Hash = hash<Key>,
+        class Pred = equal_to<Key>,
+        class Alloc = allocator<pair<const Key, Value>>
+    >
+    class flat_hash_map
+    {
+        public:
+            using key_type        = Key;
+            using mapped_type     = Value;
+            using value_type      = pair<const key_type, mapped_type>;
+            using hasher          = Hash;
+            using key_equal       = Pred;
+            using allocator_type  = Alloc;
+            using pointer         = typename allocator_traits<allocator_type>::pointer;
+            using const_pointer   = typename allocator_traits<allocator_type>::const_pointer;
+            using reference       = value_type&;
+            using const_reference = const value_type&;
+            using size_type       = size_t;
+            using difference_type = ptrdiff_t;
+
+            using iterator       = aux::flat_hash_map_iterator<
+                value_type, reference, pointer
+            >;
+            using const_iterator = aux::flat_hash_map_iterator<
+                value_type, const_reference, const_pointer
+            >;
+
+            flat_hash_map()
+                : flat_hash_map(size_type{})
+            { /* DUMMY BODY */ }
+
+            explicit flat_hash_map(size_type count,
+                                   const hasher& hf = hasher{},
+                                   const key_equal& eql = key_equal{},
+                                   const allocator_type& alloc = allocator_type{})
+                : ctrl_{}, slots_{}, capacity_{}, size_{}, growth_left_{},
+                  hasher_{hf}, key_eq_{eql}, allocator_{alloc}
+            {
+                if (count > 0)
+                    reserve(count);
+            }
+
+            template<class InputIterator>
+            flat_hash_map(InputIterator first, InputIterator last,
+                          size_type count = size_type{},
+                          const hasher& hf = hasher{},
+                          const key_equal& eql = key_equal{},
+                          const allocator_type& alloc = allocator_type{})
+                : flat_hash_map{count, hf, eql, alloc}
+            {
+                insert(first, last);
+            }
+
+            flat_hash_map(initializer_list<value_type> init,
+                          size_type count = size_type{},
+                          const hasher& hf = hasher{},
+                          const key_equal& eql = key_equal{},
+                          const allocator_type& alloc = allocator_type{})
+                : flat_hash_map{count, hf, eql, alloc}
+            {
+                insert(init.begin(), init.end());
+            }
+
+            flat_hash_map(const flat_hash_map& other)
+                : flat_hash_map{other.size_, other.hasher_,
+                                other.key_eq_, other.allocator_}
+            {
+                for (const auto& val: other)
+                    insert(val);
+            }
+
+            flat_hash_map(flat_hash_map&& other) noexcept
+                : ctrl_{other.ctrl_}, slots_{other.slots_},
+                  capacity_{other.capacity_}, size_{other.size_},
+                  growth_left_{other.growth_left_},
+                  hasher_{move(other.hasher_)}, key_eq_{move(other.key_eq_)},
+                  allocator_{move(other.allocator_)}
+            {
+                other.ctrl_ = nullptr;
+                other.slots_ = nullptr;
+                other.capacity_ = 0;
+                other.size_ = 0;
+                other.growth_left_ = 0;
+            }
+
+            ~flat_hash_map()
+            {
+                release_(storage_{ctrl_, slots_, capacity_});
+            }
+
+            flat_hash_map& operator=(const flat_hash_map& other)
+            {
+                if (this != &other)
+                {
+                    flat_hash_map tmp{other};
+                    swap(tmp);
+                }
+
+                return *this;
+            }
+
+            flat_hash_map& operator=(flat_hash_map&& other) noexcept
+            {
+                swap(other);
+
+                return *this;
+            }
+
+            flat_hash_map& operator=(initializer_list<value_type> init)
+            {
+                flat_hash_map tmp{init};
+                swap(tmp);
+
+                return *this;
+            }
+
+            allocator_type get_allocator() const noexcept
+            {
+                return allocator_;
+            }
+
+            bool empty() const noexcept
+            {
+                return size_ == 0;
+            }
+
+            size_type size() const noexcept
+            {
+                return size_;
+            }
+
+            size_type max_size() const noexcept
+            {
+                return allocator_traits<allocator_type>::max_size(allocator_);
+            }
+
+            iterator begin() noexcept
+            {
+                if (capacity_ == 0)
+                    return end();
+
+                iterator it{ctrl_, slots_};
+                it.skip_empty_();
+
+                return it;
+            }
+
+            const_iterator begin() const noexcept
+            {
+                return cbegin();
+            }
+
+            iterator end() noexcept
+            {
+                return iterator_at_(capacity_);
+            }
+
+            const_iterator end() const noexcept
+            {
+                return cend();
+            }
+
+            const_iterator cbegin() const noexcept
+            {
+                return const_cast<flat_hash_map*>(this)->begin();
+            }
+
+            const_iterator cend() const noexcept
+            {
+                return const_cast<flat_hash_map*>(this)->end();
+            }
+
+            template<class... Args>
+            pair<iterator, bool> emplace(Args&&... args)
+            {
+                /**
+                 * The key is not known before the element
+                 * is constructed, so we construct it on the
+                 * side and move it in if it is not there yet.
+                 */
+                value_type val{forward<Args>(args)...};
+
+                return emplace_key_(val.first, move(val));
+            }
+
+            pair<iterator, bool> insert(const value_type& val)
+            {
+                return emplace_key_(val.first, val);
+            }
+
+            pair<iterator, bool> insert(value_type&& val)
+            {
+                return emplace_key_(val.first, move(val));
+            }
+
+            template<class InputIterator>
+            void insert(InputIterator first, InputIterator last)
+            {
+                while (first != last)
+                    insert(*first++);
+            }
+
+            void insert(initializer_list<value_type> init)
+            {
+                insert(init.begin(), init.end());
+            }
+
+            template<class... Args>
+            pair<iterator, bool> try_emplace(const key_type& key, Args&&... args)
+            {
+                /**
+                 * Note: The lookup is done up front so that args
+                 *       are left untouched if the key is present.
+                 */
+                auto it = find(key);
+                if (it != end())
+                    return make_pair(it, false);
+
+                return emplace_key_(
+                    key, key, mapped_type(forward<Args>(args)...)
+                );
+            }
+
+            template<class... Args>
+            pair<iterator, bool> try_emplace(key_type&& key, Args&&... args)
+            {
+                /**
+                 * Note: The lookup is done up front so that args
+                 *       are left untouched if the key is present.
+                 */
+                auto it = find(key);
+                if (it != end())
+                    return make_pair(it, false);
+
+                return emplace_key_(
+                    key, move(key), mapped_type(forward<Args>(args)...)
+                );
+            }
+
+            template<class T>
+            pair<iterator, bool> insert_or_assign(const key_type& key, T&& obj)
+            {
+                auto res = try_emplace(key, forward<T>(obj));
+                if (!res.second)
+                    res.first->second = forward<T>(obj);
+
+                return res;
+            }
+
+            iterator erase(const_iterator position)
+            {
+                auto idx = static_cast<size_type>(position.slot() - slots_);
+                erase_at_(idx);
+
+                iterator it = iterator_at_(idx);
+                it.skip_empty_();
+
+                return it;
+            }
+
+            size_type erase(const key_type& key)
+            {
+                if (capacity_ == 0)
+                    return 0;
+
+                auto idx = find_index_(key, hash_(key));
+                if (idx == capacity_)
+                    return 0;
+
+                erase_at_(idx);
+
+                return 1;
+            }
+
+            iterator erase(const_iterator first, const_iterator last)
+            {
+                while (first != last)
+                    first = erase(first);
+
+                return iterator_at_(static_cast<size_type>(last.slot() - slots_));
+            }
+
+            void clear() noexcept
+            {
+                if (capacity_ == 0)
+                    return;
+
+                for (size_type i = 0; i < capacity_; ++i)
+                {
+                    if (aux::flat_ctrl_is_full(ctrl_[i]))
+                        allocator_traits<allocator_type>::destroy(allocator_, slots_ + i);
+                }
+
+                reset_ctrl_();
+                size_ = 0;
+            }
+
+            void swap(flat_hash_map& other)
+                noexcept(allocator_traits<allocator_type>::is_always_equal::value &&
+                         noexcept(std::swap(declval<hasher&>(), declval<hasher&>())) &&
+                         noexcept(std::swap(declval<key_equal&>(), declval<key_equal&>())))
+            {
+                std::swap(ctrl_, other.ctrl_);
+                std::swap(slots_, other.slots_);
+                std::swap(capacity_, other.capacity_);
+                std::swap(size_, other.size_);
+                std::swap(growth_left_, other.growth_left_);
+                std::swap(hasher_, other.hasher_);
+                std::swap(key_eq_, other.key_eq_);
+                std::swap(allocator_, other.allocator_);
+            }
+
+            hasher hash_function() const
+            {
+                return hasher_;
+            }
+
+            key_equal key_eq() const
+            {
+                return key_eq_;
+            }
+
+            iterator find(const key_type& key)
+            {
+                if (capacity_ == 0)
+                    return end();
+
+                return iterator_at_(find_index_(key, hash_(key)));
+            }
+
+            const_iterator find(const key_type& key) const
+            {
+                return const_cast<flat_hash_map*>(this)->find(key);
+            }
+
+            size_type count(const key_type& key) const
+            {
+                return find(key) != end() ? 1 : 0;
+            }
+
+            bool contains(const key_type& key) const
+            {
+                return find(key) != end();
+            }
+
+            mapped_type& operator[](const key_type& key)
+            {
+                return try_emplace(key).first->second;
+            }
+
+            mapped_type& operator[](key_type&& key)
+            {
+                return try_emplace(move(key)).first->second;
+            }
+
+            mapped_type& at(const key_type& key)
+            {
+                auto it = find(key);
+
+                // TODO: throw out_of_range if it == end()
+                return it->second;
+            }
+
+            const mapped_type& at(const key_type& key) const
+            {
+                auto it = find(key);
+
+                // TODO: throw out_of_range if it == end()
+                return it->second;
+            }
+
+            size_type bucket_count() const noexcept
+            {
+                return capacity_;
+            }
+
+            float load_factor() const noexcept
+            {
+                if (capacity_ == 0)
+                    return 0.f;
+
+                return size_ / static_cast<float>(capacity_);
+            }
+
+            float max_load_factor() const noexcept
+            {
+                return 7.f / 8.f;
+            }
+
+            void rehash(size_type count)
+            {
+                count = max(count, growth_to_lower_bound_capacity_(size_));
+                if (count == 0)
+                {
+                    // Like clear(), but also releases the memory.
+                    release_(storage_{ctrl_, slots_, capacity_});
+                    ctrl_ = nullptr;
+                    slots_ = nullptr;
+                    capacity_ = 0;
+                    growth_left_ = 0;
+
+                    return;
+                }
+
+                auto new_capacity = normalize_capacity_(count);
+                if (new_capacity != capacity_)
+                    release_(resize_(new_capacity));
+            }
+
+            void reserve(size_type count)
+            {
+                if (count > size_ + growth_left_)
+                    rehash(growth_to_lower_bound_capacity_(count));
+            }
+
+        private:
+            using group_type = aux::flat_group;
+            using ctrl_allocator_type =
+                typename allocator_traits<allocator_type>::template rebind_alloc<aux::flat_ctrl_t>;
+
+            /**
+             * Cloned copy of the first width - 1 control bytes is
+             * kept past the sentinel, so that a group can be loaded
+             * starting at any slot without wrapping around.
+             */
+            static constexpr size_type cloned_bytes_{group_type::width - 1};
+
+            struct storage_
+            {
+                aux::flat_ctrl_t* ctrl;
+                value_type* slots;
+                size_type capacity;
+            };
+
+            /**
+             * Capacity is always 2^n - 1, so that it can be used
+             * as a mask, and at least one group wide.
+             */
+            aux::flat_ctrl_t* ctrl_;
+            value_type* slots_;
+            size_type capacity_;
+            size_type size_;
+            size_type growth_left_;
+            hasher hasher_;
+            key_equal key_eq_;
+            allocator_type allocator_;
+
+            size_type hash_(const key_type& key) const
+            {
+                return aux::flat_mix(hasher_(key));
+            }
+
+            iterator iterator_at_(size_type idx)
+            {
+                if (capacity_ == 0)
+                    return iterator{};
+
+                return iterator{ctrl_ + idx, slots_ + idx};
+            }
+
+            /**
+             * Returns the index of key or capacity_ (the
+             * index of the sentinel) if it is not present.
+             */
+            size_type find_index_(const key_type& key, size_type hash) const
+            {
+                auto h2 = aux::flat_h2(hash);
+                size_type offset = aux::flat_h1(hash) & capacity_;
+                size_type step{};
+
+                while (true)
+                {
+                    group_type group{ctrl_ + offset};
+                    for (auto mask = group.match(h2); mask; mask &= mask - 1)
+                    {
+                        auto idx = (offset + group_type::lowest(mask)) & capacity_;
+                        if (key_eq_(slots_[idx].first, key))
+                            return idx;
+                    }
+
+                    // A probe sequence never continues past an empty slot.
+                    if (group.match_empty())
+                        return capacity_;
+
+                    step += group_type::width;
+                    offset = (offset + step) & capacity_;
+                }
+            }
+
+            size_type find_first_non_full_(size_type hash) const
+            {
+                size_type offset = aux::flat_h1(hash) & capacity_;
+                size_type step{};
+
+                while (true)
+                {
+                    group_type group{ctrl_ + offset};
+                    auto mask = group.match_empty_or_deleted();
+                    if (mask)
+                        return (offset + group_type::lowest(mask)) & capacity_;
+
+                    step += group_type::width;
+                    offset = (offset + step) & capacity_;
+                }
+            }
+
+            void set_ctrl_(size_type idx, aux::flat_ctrl_t ctrl)
+            {
+                ctrl_[idx] = ctrl;
+                ctrl_[((idx - cloned_bytes_) & capacity_) + cloned_bytes_] = ctrl;
+            }
+
+            template<class... Args>
+            pair<iterator, bool> emplace_key_(const key_type& key, Args&&... args)
+            {
+                if (capacity_ == 0)
+                    release_(resize_(normalize_capacity_(1)));
+
+                auto hash = hash_(key);
+                auto idx = find_index_(key, hash);
+                if (idx != capacity_)
+                    return make_pair(iterator_at_(idx), false);
+
+                /**
+                 * Note: The old storage is only released after the
+                 *       new element is constructed, because key and
+                 *       args may refer to an element of this map.
+                 */
+                storage_ old{};
+                idx = find_first_non_full_(hash);
+                if (growth_left_ == 0 && ctrl_[idx] != aux::flat_ctrl_deleted)
+                {
+                    old = grow_();
+                    idx = find_first_non_full_(hash);
+                }
+
+                allocator_traits<allocator_type>::construct(
+                    allocator_, slots_ + idx, forward<Args>(args)...
+                );
+
+                if (ctrl_[idx] == aux::flat_ctrl_empty)
+                    --growth_left_;
+                set_ctrl_(idx, aux::flat_h2(hash));
+                ++size_;
+
+                release_(old);
+
+                return make_pair(iterator_at_(idx), true);
+            }
+
+            void erase_at_(size_type idx)
+            {
+                allocator_traits<allocator_type>::destroy(allocator_, slots_ + idx);
+                --size_;
+
+                /**
+                 * If there is an empty slot within a group width on
+                 * both sides, no probe sequence could have passed
+                 * over this slot and it can become empty again.
+                 * Otherwise a tombstone has to be left behind.
+                 */
+                auto idx_before = (idx - group_type::width) & capacity_;
+                auto empty_after = group_type{ctrl_ + idx}.match_empty();
+                auto empty_before = group_type{ctrl_ + idx_before}.match_empty();
+
+                bool was_never_full = empty_before && empty_after &&
+                    (group_type::lowest(empty_after) +
+                     group_type::leading(empty_before)) < group_type::width;
+
+                if (was_never_full)
+                {
+                    set_ctrl_(idx, aux::flat_ctrl_empty);
+                    ++growth_left_;
+                }
+                else
+                    set_ctrl_(idx, aux::flat_ctrl_deleted);
+            }
+
+            static size_type growth_(size_type capacity)
+            {
+                // Maximum load factor of 7/8.
+                if (capacity < 8)
+                    return capacity - 1;
+
+                return capacity - capacity / 8;
+            }
+
+            static size_type growth_to_lower_bound_capacity_(size_type growth)
+            {
+                // Inverse of growth_(), rounded up.
+                if (growth == 0)
+                    return 0;
+
+                return growth + (growth - 1) / 7 + 1;
+            }
+
+            static size_type normalize_capacity_(size_type count)
+            {
+                size_type capacity{cloned_bytes_};
+                while (capacity < count)
+                    capacity = capacity * 2 + 1;
+
+                return capacity;
+            }
+
+            storage_ grow_()
+            {
+                /**
+                 * When most of the used up growth are tombstones,
+                 * rehashing in place (well, into a table of the
+                 * same size) is enough to get rid of them.
+                 */
+                if (capacity_ > group_type::width &&
+                    size_ * 32 <= capacity_ * 25)
+                {
+                    return resize_(capacity_);
+                }
+
+                return resize_(capacity_ * 2 + 1);
+            }
+
+            void reset_ctrl_()
+            {
+                memset(ctrl_, aux::flat_ctrl_empty, capacity_ + group_type::width);
+                ctrl_[capacity_] = aux::flat_ctrl_sentinel;
+                growth_left_ = growth_(capacity_);
+            }
+
+            /**
+             * Moves all elements to a table of the given capacity
+             * and returns the old storage, whose elements are left
+             * moved from, but not destroyed.
+             */
+            storage_ resize_(size_type new_capacity)
+            {
+                storage_ old{ctrl_, slots_, capacity_};
+
+                ctrl_allocator_type ctrl_alloc{allocator_};
+                ctrl_ = allocator_traits<ctrl_allocator_type>::allocate(
+                    ctrl_alloc, new_capacity + group_type::width
+                );
+                slots_ = allocator_traits<allocator_type>::allocate(
+                    allocator_, new_capacity
+                );
+                capacity_ = new_capacity;
+                reset_ctrl_();
+
+                for (size_type i = 0; i < old.capacity; ++i)
+                {
+                    if (!aux::flat_ctrl_is_full(old.ctrl[i]))
+                        continue;
+
+                    auto hash = hash_(old.slots[i].first);
+                    auto idx = find_first_non_full_(hash);
+
+                    allocator_traits<allocator_type>::construct(
+                        allocator_, slots_ + idx, move(old.slots[i])
+                    );
+                    set_ctrl_(idx, aux::flat_h2(hash));
+                }
+                growth_left_ -= size_;
+
+                return old;
+            }
+
+            void release_(storage_ storage)
+            {
+                if (!storage.ctrl)
+                    return;
+
+                for (size_type i = 0; i < storage.capacity; ++i)
+                {
+                    if (aux::flat_ctrl_is_full(storage.ctrl[i]))
+                        allocator_traits<allocator_type>::destroy(allocator_, storage.slots + i);
+                }
+
+                ctrl_allocator_type ctrl_alloc{allocator_};
+                allocator_traits<ctrl_allocator_type>::deallocate(
+                    ctrl_alloc, storage.ctrl, storage.capacity + group_type::width
+                );
+                allocator_traits<allocator_type>::deallocate(
+                    allocator_, storage.slots, storage.capacity
+                );
+            }
+    };
+
+    template<class Key, class Value, class Hash, class Pred, class Alloc>
+    bool operator==(const flat_hash_map<Key, Value, Hash, Pred, Alloc>& lhs,
+                    const flat_hash_map<Key, Value, Hash, Pred, Alloc>& rhs)
+    {
+        if (lhs.size() != rhs.size())
+            return false;
+
+        for (const auto& val: lhs)
+        {
+            auto it = rhs.find(val.first);
+            if (it == rhs.end() || !(it->second == val.second))
+                return false;
+        }
+
+        return true;
+    }
+
+    template<class Key, class Value, class Hash, class Pred, class Alloc>
+    bool operator!=(const flat_hash_map<Key, Value, Hash, Pred, Alloc>& lhs,
+                    const flat_hash_map<Key, Value, Hash, Pred, Alloc>& rhs)
+    {
+        return !(lhs == rhs);
+    }
+
+    template<class Key, class Value, class Hash, class Pred, class Alloc>
+    void swap(flat_hash_map<Key, Value, Hash, Pred, Alloc>& lhs,
+              flat_hash_map<Key, Value, Hash, Pred, Alloc>& rhs)
+        noexcept(noexcept(lhs.swap(rhs)))
+    {
+        lhs.swap(rhs);
+    }
+}
+
+#endif
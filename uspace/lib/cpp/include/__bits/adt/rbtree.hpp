@@ -33,6 +33,7 @@
 #include <__bits/adt/rbtree_iterators.hpp>
 #include <__bits/adt/rbtree_node.hpp>
 #include <__bits/adt/rbtree_policies.hpp>
+#include <__bits/memory/allocator_traits.hpp>
 
 namespace std::aux
 {
@@ -81,6 +82,11 @@ namespace std::aux
                 other.size_ = size_type{};
             }
 
+            ~rbtree()
+            {
+                clear();
+            }
+
             rbtree& operator=(const rbtree& other)
             {
                 auto tmp{other};
@@ -232,7 +238,7 @@ namespace std::aux
 
             void swap(rbtree& other)
                 noexcept(allocator_traits<allocator_type>::is_always_equal::value &&
-                         noexcept(swap(declval<KeyComp&>(), declval<KeyComp&>())))
+                         noexcept(std::swap(declval<KeyComp&>(), declval<KeyComp&>())))
             {
                 std::swap(root_, other.root_);
                 std::swap(size_, other.size_);
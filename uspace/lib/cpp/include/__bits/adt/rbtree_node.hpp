@@ -712,7 +712,26 @@ namespace std::aux
                 if (right_)
                     delete right_;
 
-                // TODO: delete the list
+                /**
+                 * The first node of a list of equivalent keys
+                 * owns the rest of the list, which shares its
+                 * children, so those must not be deleted twice.
+                 */
+                if (first_ == this)
+                {
+                    auto tmp = next_;
+                    while (tmp)
+                    {
+                        auto next = tmp->next_;
+
+                        tmp->left_ = nullptr;
+                        tmp->right_ = nullptr;
+                        tmp->next_ = nullptr;
+                        delete tmp;
+
+                        tmp = next;
+                    }
+                }
             }
 
         private:
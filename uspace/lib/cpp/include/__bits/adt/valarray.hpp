@@ -29,6 +29,2344 @@
 #ifndef LIBCPP_BITS_ADT_VALARRAY
 #define LIBCPP_BITS_ADT_VALARRAY
 
-#error "<valarray> is not implemented"
+#include <__bits/functional/arithmetic_operations.hpp>
+#include <cstddef>
+#include <initializer_list>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+namespace std::hel
+{
+    extern "C" {
+        #include <math.h>
+    }
+}
+
+namespace std
+{
+    template<class T>
+    class valarray;
+
+    class slice;
+
+    template<class T>
+    class slice_array;
+
+    class gslice;
+
+    template<class T>
+    class gslice_array;
+
+    template<class T>
+    class mask_array;
+
+    template<class T>
+    class indirect_array;
+}
+
+namespace std::aux
+{
+    /**
+     * Arithmetic on valarrays is implemented with expression
+     * templates (26.6.1/3 allows operators to return a replacement
+     * type). Operators build a tree of the following nodes and the
+     * whole expression is evaluated in a single loop once it is
+     * assigned to a valarray, which avoids the temporaries and lets
+     * the compiler vectorize the loop.
+     */
+
+    /**
+     * The second parameter is never specified explicitly, it only
+     * makes std an associated namespace of every expression (each
+     * has at least one leaf), so that argument dependent lookup
+     * finds the non-member operators and functions for expressions
+     * that only consist of the nodes from this namespace.
+     */
+    template<class T, class Array = valarray<T>>
+    class valarray_leaf
+    {
+        public:
+            using value_type = T;
+
+            explicit valarray_leaf(const valarray<T>& arr)
+                : data_{arr.data_}, size_{arr.size_}
+            { /* DUMMY BODY */ }
+
+            const T& operator[](size_t i) const
+            {
+                return data_[i];
+            }
+
+            size_t size() const
+            {
+                return size_;
+            }
+
+        private:
+            const T* data_;
+            size_t size_;
+    };
+
+    template<class T>
+    class valarray_scalar
+    {
+        public:
+            using value_type = T;
+
+            explicit valarray_scalar(const T& value)
+                : value_{value}
+            { /* DUMMY BODY */ }
+
+            const T& operator[](size_t) const
+            {
+                return value_;
+            }
+
+        private:
+            T value_;
+    };
+
+    template<class E>
+    struct is_valarray_scalar: false_type
+    { /* DUMMY BODY */ };
+
+    template<class T>
+    struct is_valarray_scalar<valarray_scalar<T>>: true_type
+    { /* DUMMY BODY */ };
+
+    template<class Op, class E>
+    class valarray_unary
+    {
+        public:
+            using value_type = decay_t<decltype(
+                declval<Op>()(declval<const typename E::value_type&>())
+            )>;
+
+            explicit valarray_unary(const E& expr)
+                : expr_{expr}
+            { /* DUMMY BODY */ }
+
+            value_type operator[](size_t i) const
+            {
+                return Op{}(expr_[i]);
+            }
+
+            size_t size() const
+            {
+                return expr_.size();
+            }
+
+        private:
+            E expr_;
+    };
+
+    template<class Op, class L, class R>
+    class valarray_binary
+    {
+        public:
+            using value_type = decay_t<decltype(
+                declval<Op>()(declval<const typename L::value_type&>(),
+                              declval<const typename R::value_type&>())
+            )>;
+
+            valarray_binary(const L& lhs, const R& rhs)
+                : lhs_{lhs}, rhs_{rhs}
+            { /* DUMMY BODY */ }
+
+            value_type operator[](size_t i) const
+            {
+                return Op{}(lhs_[i], rhs_[i]);
+            }
+
+            size_t size() const
+            {
+                if constexpr (is_valarray_scalar<L>::value)
+                    return rhs_.size();
+                else
+                    return lhs_.size();
+            }
+
+        private:
+            L lhs_;
+            R rhs_;
+    };
+
+    /**
+     * Reductions. The sum uses four independent accumulators,
+     * the order of additions is unspecified (26.6.2.8/3) and
+     * this way the additions do not wait on each other.
+     */
+
+    template<class E>
+    typename E::value_type valarray_sum(const E& expr)
+    {
+        auto n = expr.size();
+        if (n == 0)
+            return typename E::value_type{};
+
+        if (n < 8)
+        {
+            typename E::value_type res = expr[0];
+            for (size_t i = 1; i < n; ++i)
+                res += expr[i];
+
+            return res;
+        }
+
+        typename E::value_type acc0 = expr[0];
+        typename E::value_type acc1 = expr[1];
+        typename E::value_type acc2 = expr[2];
+        typename E::value_type acc3 = expr[3];
+
+        size_t i{4};
+        for (; i + 4 <= n; i += 4)
+        {
+            acc0 += expr[i];
+            acc1 += expr[i + 1];
+            acc2 += expr[i + 2];
+            acc3 += expr[i + 3];
+        }
+
+        for (; i < n; ++i)
+            acc0 += expr[i];
+
+        acc0 += acc1;
+        acc2 += acc3;
+        acc0 += acc2;
+
+        return acc0;
+    }
+
+    template<class E>
+    typename E::value_type valarray_min(const E& expr)
+    {
+        auto n = expr.size();
+        if (n == 0)
+            return typename E::value_type{};
+
+        typename E::value_type res = expr[0];
+        for (size_t i = 1; i < n; ++i)
+        {
+            typename E::value_type tmp = expr[i];
+            if (tmp < res)
+                res = tmp;
+        }
+
+        return res;
+    }
+
+    template<class E>
+    typename E::value_type valarray_max(const E& expr)
+    {
+        auto n = expr.size();
+        if (n == 0)
+            return typename E::value_type{};
+
+        typename E::value_type res = expr[0];
+        for (size_t i = 1; i < n; ++i)
+        {
+            typename E::value_type tmp = expr[i];
+            if (res < tmp)
+                res = tmp;
+        }
+
+        return res;
+    }
+
+    template<class T>
+    struct valarray_unary_plus
+    {
+        T operator()(const T& x) const
+        {
+            return +x;
+        }
+    };
+
+    template<class T>
+    struct valarray_shift_left
+    {
+        T operator()(const T& lhs, const T& rhs) const
+        {
+            return lhs << rhs;
+        }
+    };
+
+    template<class T>
+    struct valarray_shift_right
+    {
+        T operator()(const T& lhs, const T& rhs) const
+        {
+            return lhs >> rhs;
+        }
+    };
+
+    template<class E>
+    class valarray_expr;
+
+    template<class Op, class E>
+    auto make_valarray_unary(const E& expr)
+    {
+        using expr_type = valarray_unary<Op, E>;
+
+        return valarray_expr<expr_type>{expr_type{expr}};
+    }
+
+    template<class Op, class L, class R>
+    auto make_valarray_binary(const L& lhs, const R& rhs)
+    {
+        using expr_type = valarray_binary<Op, L, R>;
+
+        return valarray_expr<expr_type>{expr_type{lhs, rhs}};
+    }
+
+    template<class E>
+    class valarray_expr
+    {
+        public:
+            using value_type = typename E::value_type;
+
+            explicit valarray_expr(const E& expr)
+                : expr_{expr}
+            { /* DUMMY BODY */ }
+
+            value_type operator[](size_t i) const
+            {
+                return expr_[i];
+            }
+
+            /**
+             * Subsets of an expression are not lazy, the expression
+             * is evaluated into a const valarray (so that we get
+             * a copy rather than a reference into a temporary)
+             * which is then subscripted.
+             */
+
+            valarray<value_type> operator[](const slice& sl) const
+            {
+                const valarray<value_type> va{*this};
+
+                return va[sl];
+            }
+
+            valarray<value_type> operator[](const gslice& gsl) const
+            {
+                const valarray<value_type> va{*this};
+
+                return va[gsl];
+            }
+
+            valarray<value_type> operator[](const valarray<bool>& mask) const
+            {
+                const valarray<value_type> va{*this};
+
+                return va[mask];
+            }
+
+            valarray<value_type> operator[](const valarray<size_t>& idx) const
+            {
+                const valarray<value_type> va{*this};
+
+                return va[idx];
+            }
+
+            size_t size() const
+            {
+                return expr_.size();
+            }
+
+            value_type sum() const
+            {
+                return valarray_sum(expr_);
+            }
+
+            value_type min() const
+            {
+                return valarray_min(expr_);
+            }
+
+            value_type max() const
+            {
+                return valarray_max(expr_);
+            }
+
+            valarray<value_type> shift(int n) const
+            {
+                return valarray<value_type>{*this}.shift(n);
+            }
+
+            valarray<value_type> cshift(int n) const
+            {
+                return valarray<value_type>{*this}.cshift(n);
+            }
+
+            valarray<value_type> apply(value_type func(value_type)) const
+            {
+                return valarray<value_type>{*this}.apply(func);
+            }
+
+            valarray<value_type> apply(value_type func(const value_type&)) const
+            {
+                return valarray<value_type>{*this}.apply(func);
+            }
+
+            auto operator+() const
+            {
+                return make_valarray_unary<valarray_unary_plus<value_type>>(expr_);
+            }
+
+            auto operator-() const
+            {
+                return make_valarray_unary<negate<value_type>>(expr_);
+            }
+
+            auto operator~() const
+            {
+                return make_valarray_unary<bit_not<value_type>>(expr_);
+            }
+
+            auto operator!() const
+            {
+                return make_valarray_unary<logical_not<value_type>>(expr_);
+            }
+
+            const E& expr() const
+            {
+                return expr_;
+            }
+
+        private:
+            E expr_;
+    };
+
+    /**
+     * Operands of the non-member operators are either valarrays,
+     * expressions or (when paired with one of those) scalars.
+     */
+
+    template<class X>
+    struct valarray_operand
+    {
+        static constexpr bool value = false;
+    };
+
+    template<class T>
+    struct valarray_operand<valarray<T>>
+    {
+        static constexpr bool value = true;
+
+        using value_type = T;
+    };
+
+    template<class E>
+    struct valarray_operand<valarray_expr<E>>
+    {
+        static constexpr bool value = true;
+
+        using value_type = typename E::value_type;
+    };
+
+    template<class X>
+    using valarray_value_t = typename valarray_operand<X>::value_type;
+
+    template<class X>
+    using enable_valarray_operand_t = enable_if_t<valarray_operand<X>::value>;
+
+    template<class L, class R>
+    using enable_valarray_operands_t = enable_if_t<
+        is_same<valarray_value_t<L>, valarray_value_t<R>>::value
+    >;
+
+    template<class T>
+    valarray_leaf<T> valarray_unwrap(const valarray<T>& arr)
+    {
+        return valarray_leaf<T>{arr};
+    }
+
+    template<class E>
+    const E& valarray_unwrap(const valarray_expr<E>& expr)
+    {
+        return expr.expr();
+    }
+
+    /**
+     * The transcendental functions use the C library, picking
+     * the variant that matches the element type.
+     */
+
+    template<class T, class F, class D, class L>
+    T valarray_math(const T& x, F fn_float, D fn_double, L fn_long_double)
+    {
+        if constexpr (is_same_v<T, float>)
+            return fn_float(x);
+        else if constexpr (is_same_v<T, long double>)
+            return fn_long_double(x);
+        else
+            return fn_double(x);
+    }
+
+    template<class T, class F, class D, class L>
+    T valarray_math(const T& x, const T& y, F fn_float, D fn_double, L fn_long_double)
+    {
+        if constexpr (is_same_v<T, float>)
+            return fn_float(x, y);
+        else if constexpr (is_same_v<T, long double>)
+            return fn_long_double(x, y);
+        else
+            return fn_double(x, y);
+    }
+
+    struct valarray_abs
+    {
+        template<class T>
+        T operator()(const T& x) const
+        {
+            if constexpr (is_integral<T>::value)
+                return x < 0 ? -x : x;
+            else
+                return valarray_math(x, hel::fabsf, hel::fabs, hel::fabsl);
+        }
+    };
+
+    struct valarray_acos
+    {
+        template<class T>
+        T operator()(const T& x) const
+        {
+            return valarray_math(x, hel::acosf, hel::acos, hel::acosl);
+        }
+    };
+
+    struct valarray_asin
+    {
+        template<class T>
+        T operator()(const T& x) const
+        {
+            return valarray_math(x, hel::asinf, hel::asin, hel::asinl);
+        }
+    };
+
+    struct valarray_atan
+    {
+        template<class T>
+        T operator()(const T& x) const
+        {
+            return valarray_math(x, hel::atanf, hel::atan, hel::atanl);
+        }
+    };
+
+    struct valarray_cos
+    {
+        template<class T>
+        T operator()(const T& x) const
+        {
+            return valarray_math(x, hel::cosf, hel::cos, hel::cosl);
+        }
+    };
+
+    struct valarray_cosh
+    {
+        template<class T>
+        T operator()(const T& x) const
+        {
+            return valarray_math(x, hel::coshf, hel::cosh, hel::coshl);
+        }
+    };
+
+    struct valarray_exp
+    {
+        template<class T>
+        T operator()(const T& x) const
+        {
+            return valarray_math(x, hel::expf, hel::exp, hel::expl);
+        }
+    };
+
+    struct valarray_log
+    {
+        template<class T>
+        T operator()(const T& x) const
+        {
+            return valarray_math(x, hel::logf, hel::log, hel::logl);
+        }
+    };
+
+    struct valarray_log10
+    {
+        template<class T>
+        T operator()(const T& x) const
+        {
+            return valarray_math(x, hel::log10f, hel::log10, hel::log10l);
+        }
+    };
+
+    struct valarray_sin
+    {
+        template<class T>
+        T operator()(const T& x) const
+        {
+            return valarray_math(x, hel::sinf, hel::sin, hel::sinl);
+        }
+    };
+
+    struct valarray_sinh
+    {
+        template<class T>
+        T operator()(const T& x) const
+        {
+            return valarray_math(x, hel::sinhf, hel::sinh, hel::sinhl);
+        }
+    };
+
+    struct valarray_sqrt
+    {
+        template<class T>
+        T operator()(const T& x) const
+        {
+            return valarray_math(x, hel::sqrtf, hel::sqrt, hel::sqrtl);
+        }
+    };
+
+    struct valarray_tan
+    {
+        template<class T>
+        T operator()(const T& x) const
+        {
+            return valarray_math(x, hel::tanf, hel::tan, hel::tanl);
+        }
+    };
+
+    struct valarray_tanh
+    {
+        template<class T>
+        T operator()(const T& x) const
+        {
+            return valarray_math(x, hel::tanhf, hel::tanh, hel::tanhl);
+        }
+    };
+
+    struct valarray_atan2
+    {
+        template<class T>
+        T operator()(const T& x, const T& y) const
+        {
+            return valarray_math(x, y, hel::atan2f, hel::atan2, hel::atan2l);
+        }
+    };
+
+    struct valarray_pow
+    {
+        template<class T>
+        T operator()(const T& x, const T& y) const
+        {
+            return valarray_math(x, y, hel::powf, hel::pow, hel::powl);
+        }
+    };
+}
+
+namespace std
+{
+    /**
+     * 26.6.2, class template valarray:
+     */
+
+    template<class T>
+    class valarray
+    {
+        public:
+            using value_type = T;
+
+            /**
+             * 26.6.2.2, construct/destroy:
+             */
+
+            valarray()
+                : data_{nullptr}, size_{}
+            { /* DUMMY BODY */ }
+
+            explicit valarray(size_t n)
+                : valarray{}
+            {
+                allocate_(n);
+                for (size_t i = 0; i < n; ++i)
+                    ::new(&data_[i]) T();
+            }
+
+            valarray(const T& val, size_t n)
+                : valarray{}
+            {
+                allocate_(n);
+                for (size_t i = 0; i < n; ++i)
+                    ::new(&data_[i]) T(val);
+            }
+
+            valarray(const T* vals, size_t n)
+                : valarray{}
+            {
+                allocate_(n);
+                for (size_t i = 0; i < n; ++i)
+                    ::new(&data_[i]) T(vals[i]);
+            }
+
+            valarray(const valarray& other)
+                : valarray{}
+            {
+                construct_(aux::valarray_leaf<T>{other});
+            }
+
+            valarray(valarray&& other) noexcept
+                : data_{other.data_}, size_{other.size_}
+            {
+                other.data_ = nullptr;
+                other.size_ = 0;
+            }
+
+            valarray(const slice_array<T>& arr)
+                : valarray{}
+            {
+                construct_(arr);
+            }
+
+            valarray(const gslice_array<T>& arr)
+                : valarray{}
+            {
+                construct_(arr);
+            }
+
+            valarray(const mask_array<T>& arr)
+                : valarray{}
+            {
+                construct_(arr);
+            }
+
+            valarray(const indirect_array<T>& arr)
+                : valarray{}
+            {
+                construct_(arr);
+            }
+
+            valarray(initializer_list<T> init)
+                : valarray(init.begin(), init.size())
+            { /* DUMMY BODY */ }
+
+            template<
+                class E,
+                class = enable_if_t<is_same<typename E::value_type, T>::value>
+            >
+            valarray(const aux::valarray_expr<E>& expr)
+                : valarray{}
+            {
+                construct_(expr.expr());
+            }
+
+            ~valarray()
+            {
+                release_();
+            }
+
+            /**
+             * 26.6.2.3, assignment:
+             */
+
+            valarray& operator=(const valarray& rhs)
+            {
+                if (this != &rhs)
+                    assign_(aux::valarray_leaf<T>{rhs});
+
+                return *this;
+            }
+
+            valarray& operator=(valarray&& rhs) noexcept
+            {
+                swap(rhs);
+
+                return *this;
+            }
+
+            valarray& operator=(initializer_list<T> init)
+            {
+                *this = valarray{init};
+
+                return *this;
+            }
+
+            valarray& operator=(const T& val)
+            {
+                for (size_t i = 0; i < size_; ++i)
+                    data_[i] = val;
+
+                return *this;
+            }
+
+            valarray& operator=(const slice_array<T>& arr)
+            {
+                assign_(arr);
+
+                return *this;
+            }
+
+            valarray& operator=(const gslice_array<T>& arr)
+            {
+                assign_(arr);
+
+                return *this;
+            }
+
+            valarray& operator=(const mask_array<T>& arr)
+            {
+                assign_(arr);
+
+                return *this;
+            }
+
+            valarray& operator=(const indirect_array<T>& arr)
+            {
+                assign_(arr);
+
+                return *this;
+            }
+
+            template<
+                class E,
+                class = enable_if_t<is_same<typename E::value_type, T>::value>
+            >
+            valarray& operator=(const aux::valarray_expr<E>& expr)
+            {
+                assign_(expr.expr());
+
+                return *this;
+            }
+
+            /**
+             * 26.6.2.4, element access:
+             */
+
+            const T& operator[](size_t idx) const
+            {
+                return data_[idx];
+            }
+
+            T& operator[](size_t idx)
+            {
+                return data_[idx];
+            }
+
+            /**
+             * 26.6.2.5, subset operations:
+             */
+
+            valarray operator[](slice s) const;
+            slice_array<T> operator[](slice s);
+            valarray operator[](const gslice& gs) const;
+            gslice_array<T> operator[](const gslice& gs);
+            valarray operator[](const valarray<bool>& mask) const;
+            mask_array<T> operator[](const valarray<bool>& mask);
+            valarray operator[](const valarray<size_t>& indices) const;
+            indirect_array<T> operator[](const valarray<size_t>& indices);
+
+            /**
+             * 26.6.2.6, unary operators:
+             */
+
+            auto operator+() const
+            {
+                return aux::make_valarray_unary<aux::valarray_unary_plus<T>>(
+                    aux::valarray_leaf<T>{*this}
+                );
+            }
+
+            auto operator-() const
+            {
+                return aux::make_valarray_unary<negate<T>>(
+                    aux::valarray_leaf<T>{*this}
+                );
+            }
+
+            auto operator~() const
+            {
+                return aux::make_valarray_unary<bit_not<T>>(
+                    aux::valarray_leaf<T>{*this}
+                );
+            }
+
+            auto operator!() const
+            {
+                return aux::make_valarray_unary<logical_not<T>>(
+                    aux::valarray_leaf<T>{*this}
+                );
+            }
+
+            /**
+             * 26.6.2.7, compound assignment:
+             */
+
+            valarray& operator*=(const T& val)
+            {
+                return compute_assign_<multiplies<void>>(aux::valarray_scalar<T>{val});
+            }
+
+            valarray& operator*=(const valarray& rhs)
+            {
+                return compute_assign_<multiplies<void>>(aux::valarray_leaf<T>{rhs});
+            }
+
+            template<class E>
+            valarray& operator*=(const aux::valarray_expr<E>& rhs)
+            {
+                return compute_assign_<multiplies<void>>(rhs.expr());
+            }
+
+            valarray& operator/=(const T& val)
+            {
+                return compute_assign_<divides<void>>(aux::valarray_scalar<T>{val});
+            }
+
+            valarray& operator/=(const valarray& rhs)
+            {
+                return compute_assign_<divides<void>>(aux::valarray_leaf<T>{rhs});
+            }
+
+            template<class E>
+            valarray& operator/=(const aux::valarray_expr<E>& rhs)
+            {
+                return compute_assign_<divides<void>>(rhs.expr());
+            }
+
+            valarray& operator%=(const T& val)
+            {
+                return compute_assign_<modulus<void>>(aux::valarray_scalar<T>{val});
+            }
+
+            valarray& operator%=(const valarray& rhs)
+            {
+                return compute_assign_<modulus<void>>(aux::valarray_leaf<T>{rhs});
+            }
+
+            template<class E>
+            valarray& operator%=(const aux::valarray_expr<E>& rhs)
+            {
+                return compute_assign_<modulus<void>>(rhs.expr());
+            }
+
+            valarray& operator+=(const T& val)
+            {
+                return compute_assign_<plus<void>>(aux::valarray_scalar<T>{val});
+            }
+
+            valarray& operator+=(const valarray& rhs)
+            {
+                return compute_assign_<plus<void>>(aux::valarray_leaf<T>{rhs});
+            }
+
+            template<class E>
+            valarray& operator+=(const aux::valarray_expr<E>& rhs)
+            {
+                return compute_assign_<plus<void>>(rhs.expr());
+            }
+
+            valarray& operator-=(const T& val)
+            {
+                return compute_assign_<minus<void>>(aux::valarray_scalar<T>{val});
+            }
+
+            valarray& operator-=(const valarray& rhs)
+            {
+                return compute_assign_<minus<void>>(aux::valarray_leaf<T>{rhs});
+            }
+
+            template<class E>
+            valarray& operator-=(const aux::valarray_expr<E>& rhs)
+            {
+                return compute_assign_<minus<void>>(rhs.expr());
+            }
+
+            valarray& operator^=(const T& val)
+            {
+                return compute_assign_<bit_xor<void>>(aux::valarray_scalar<T>{val});
+            }
+
+            valarray& operator^=(const valarray& rhs)
+            {
+                return compute_assign_<bit_xor<void>>(aux::valarray_leaf<T>{rhs});
+            }
+
+            template<class E>
+            valarray& operator^=(const aux::valarray_expr<E>& rhs)
+            {
+                return compute_assign_<bit_xor<void>>(rhs.expr());
+            }
+
+            valarray& operator&=(const T& val)
+            {
+                return compute_assign_<bit_and<void>>(aux::valarray_scalar<T>{val});
+            }
+
+            valarray& operator&=(const valarray& rhs)
+            {
+                return compute_assign_<bit_and<void>>(aux::valarray_leaf<T>{rhs});
+            }
+
+            template<class E>
+            valarray& operator&=(const aux::valarray_expr<E>& rhs)
+            {
+                return compute_assign_<bit_and<void>>(rhs.expr());
+            }
+
+            valarray& operator|=(const T& val)
+            {
+                return compute_assign_<bit_or<void>>(aux::valarray_scalar<T>{val});
+            }
+
+            valarray& operator|=(const valarray& rhs)
+            {
+                return compute_assign_<bit_or<void>>(aux::valarray_leaf<T>{rhs});
+            }
+
+            template<class E>
+            valarray& operator|=(const aux::valarray_expr<E>& rhs)
+            {
+                return compute_assign_<bit_or<void>>(rhs.expr());
+            }
+
+            valarray& operator<<=(const T& val)
+            {
+                return compute_assign_<aux::valarray_shift_left<T>>(aux::valarray_scalar<T>{val});
+            }
+
+            valarray& operator<<=(const valarray& rhs)
+            {
+                return compute_assign_<aux::valarray_shift_left<T>>(aux::valarray_leaf<T>{rhs});
+            }
+
+            template<class E>
+            valarray& operator<<=(const aux::valarray_expr<E>& rhs)
+            {
+                return compute_assign_<aux::valarray_shift_left<T>>(rhs.expr());
+            }
+
+            valarray& operator>>=(const T& val)
+            {
+                return compute_assign_<aux::valarray_shift_right<T>>(aux::valarray_scalar<T>{val});
+            }
+
+            valarray& operator>>=(const valarray& rhs)
+            {
+                return compute_assign_<aux::valarray_shift_right<T>>(aux::valarray_leaf<T>{rhs});
+            }
+
+            template<class E>
+            valarray& operator>>=(const aux::valarray_expr<E>& rhs)
+            {
+                return compute_assign_<aux::valarray_shift_right<T>>(rhs.expr());
+            }
+
+            /**
+             * 26.6.2.8, member functions:
+             */
+
+            void swap(valarray& other) noexcept
+            {
+                std::swap(data_, other.data_);
+                std::swap(size_, other.size_);
+            }
+
+            size_t size() const
+            {
+                return size_;
+            }
+
+            T sum() const
+            {
+                return aux::valarray_sum(aux::valarray_leaf<T>{*this});
+            }
+
+            T min() const
+            {
+                return aux::valarray_min(aux::valarray_leaf<T>{*this});
+            }
+
+            T max() const
+            {
+                return aux::valarray_max(aux::valarray_leaf<T>{*this});
+            }
+
+            valarray shift(int n) const
+            {
+                valarray res(size_);
+
+                /**
+                 * Note: Elements shifted in from outside are
+                 *       value initialized by the constructor.
+                 */
+                auto size = static_cast<long>(size_);
+                for (long i = 0; i < size; ++i)
+                {
+                    auto idx = i + n;
+                    if (0 <= idx && idx < size)
+                        res.data_[i] = data_[idx];
+                }
+
+                return res;
+            }
+
+            valarray cshift(int n) const
+            {
+                valarray res(size_);
+                if (size_ == 0)
+                    return res;
+
+                auto size = static_cast<long>(size_);
+                auto offset = n % size;
+                if (offset < 0)
+                    offset += size;
+
+                for (long i = 0; i < size; ++i)
+                {
+                    auto idx = i + offset;
+                    if (idx >= size)
+                        idx -= size;
+
+                    res.data_[i] = data_[idx];
+                }
+
+                return res;
+            }
+
+            valarray apply(T func(T)) const
+            {
+                valarray res(size_);
+                for (size_t i = 0; i < size_; ++i)
+                    res.data_[i] = func(data_[i]);
+
+                return res;
+            }
+
+            valarray apply(T func(const T&)) const
+            {
+                valarray res(size_);
+                for (size_t i = 0; i < size_; ++i)
+                    res.data_[i] = func(data_[i]);
+
+                return res;
+            }
+
+            void resize(size_t n, T val = T())
+            {
+                release_();
+
+                allocate_(n);
+                for (size_t i = 0; i < n; ++i)
+                    ::new(&data_[i]) T(val);
+            }
+
+        private:
+            T* data_;
+            size_t size_;
+
+            void allocate_(size_t n)
+            {
+                if (n > 0)
+                    data_ = static_cast<T*>(::operator new(n * sizeof(T)));
+                else
+                    data_ = nullptr;
+                size_ = n;
+            }
+
+            void release_()
+            {
+                if (!data_)
+                    return;
+
+                for (size_t i = 0; i < size_; ++i)
+                    data_[i].~T();
+                ::operator delete(data_);
+
+                data_ = nullptr;
+                size_ = 0;
+            }
+
+            /**
+             * Evaluation of expressions, which is the only place
+             * where the actual element-wise loops live.
+             */
+
+            template<class E>
+            void construct_(const E& expr)
+            {
+                auto n = expr.size();
+
+                allocate_(n);
+                for (size_t i = 0; i < n; ++i)
+                    ::new(&data_[i]) T(expr[i]);
+            }
+
+            template<class E>
+            void assign_(const E& expr)
+            {
+                auto n = expr.size();
+
+                if (n == size_)
+                {
+                    T* data = data_;
+                    for (size_t i = 0; i < n; ++i)
+                        data[i] = expr[i];
+                }
+                else
+                {
+                    /**
+                     * The expression is evaluated before we let
+                     * go of the old elements in case it refers
+                     * to them.
+                     */
+                    valarray tmp{};
+                    tmp.construct_(expr);
+                    swap(tmp);
+                }
+            }
+
+            template<class Op, class E>
+            valarray& compute_assign_(const E& expr)
+            {
+                T* data = data_;
+                for (size_t i = 0; i < size_; ++i)
+                    data[i] = Op{}(data[i], expr[i]);
+
+                return *this;
+            }
+
+            template<class U, class Array>
+            friend class aux::valarray_leaf;
+    };
+
+    /**
+     * 26.6.4, class slice:
+     */
+
+    class slice
+    {
+        public:
+            slice()
+                : start_{}, size_{}, stride_{}
+            { /* DUMMY BODY */ }
+
+            slice(size_t start, size_t size, size_t stride)
+                : start_{start}, size_{size}, stride_{stride}
+            { /* DUMMY BODY */ }
+
+            slice(const slice&) = default;
+
+            slice& operator=(const slice&) = default;
+
+            size_t start() const
+            {
+                return start_;
+            }
+
+            size_t size() const
+            {
+                return size_;
+            }
+
+            size_t stride() const
+            {
+                return stride_;
+            }
+
+        private:
+            size_t start_;
+            size_t size_;
+            size_t stride_;
+    };
+
+    /**
+     * 26.6.6, class gslice:
+     */
+
+    class gslice
+    {
+        public:
+            gslice()
+                : start_{}, sizes_{}, strides_{}, indices_{}
+            { /* DUMMY BODY */ }
+
+            gslice(size_t start, const valarray<size_t>& sizes,
+                   const valarray<size_t>& strides)
+                : start_{start}, sizes_{sizes}, strides_{strides}, indices_{}
+            {
+                compute_indices_();
+            }
+
+            gslice(const gslice&) = default;
+
+            gslice& operator=(const gslice&) = default;
+
+            size_t start() const
+            {
+                return start_;
+            }
+
+            valarray<size_t> size() const
+            {
+                return sizes_;
+            }
+
+            valarray<size_t> stride() const
+            {
+                return strides_;
+            }
+
+        private:
+            size_t start_;
+            valarray<size_t> sizes_;
+            valarray<size_t> strides_;
+
+            /**
+             * The indices are computed once here, so that
+             * operations on gslice_arrays are simple gathers.
+             */
+            valarray<size_t> indices_;
+
+            void compute_indices_()
+            {
+                auto dims = sizes_.size();
+                if (dims == 0 || dims != strides_.size())
+                    return;
+
+                size_t total{1};
+                for (size_t d = 0; d < dims; ++d)
+                    total *= sizes_[d];
+
+                indices_.resize(total);
+                if (total == 0)
+                    return;
+
+                valarray<size_t> counters(dims);
+                size_t idx = start_;
+                for (size_t i = 0; i < total; ++i)
+                {
+                    indices_[i] = idx;
+
+                    // The last dimension varies fastest.
+                    for (size_t d = dims; d-- > 0;)
+                    {
+                        if (++counters[d] < sizes_[d])
+                        {
+                            idx += strides_[d];
+                            break;
+                        }
+
+                        idx -= (sizes_[d] - 1) * strides_[d];
+                        counters[d] = 0;
+                    }
+                }
+            }
+
+            template<class T>
+            friend class valarray;
+    };
+}
+
+namespace std::aux
+{
+    class valarray_slice_indexer
+    {
+        public:
+            explicit valarray_slice_indexer(const slice& s)
+                : start_{s.start()}, size_{s.size()}, stride_{s.stride()}
+            { /* DUMMY BODY */ }
+
+            size_t operator()(size_t i) const
+            {
+                return start_ + i * stride_;
+            }
+
+            size_t size() const
+            {
+                return size_;
+            }
+
+        private:
+            size_t start_;
+            size_t size_;
+            size_t stride_;
+    };
+
+    class valarray_index_indexer
+    {
+        public:
+            explicit valarray_index_indexer(const valarray<size_t>& indices)
+                : indices_{indices}
+            { /* DUMMY BODY */ }
+
+            size_t operator()(size_t i) const
+            {
+                return indices_[i];
+            }
+
+            size_t size() const
+            {
+                return indices_.size();
+            }
+
+        private:
+            valarray<size_t> indices_;
+    };
+
+    inline valarray<size_t> valarray_mask_indices(const valarray<bool>& mask)
+    {
+        size_t count{};
+        for (size_t i = 0; i < mask.size(); ++i)
+        {
+            if (mask[i])
+                ++count;
+        }
+
+        valarray<size_t> res(count);
+        for (size_t i = 0, j = 0; i < mask.size(); ++i)
+        {
+            if (mask[i])
+                res[j++] = i;
+        }
+
+        return res;
+    }
+
+    /**
+     * Common base of slice_array, gslice_array, mask_array
+     * and indirect_array, which only differ in the way they
+     * map their elements to the elements of the valarray.
+     */
+    template<class T, class Indexer>
+    class valarray_view
+    {
+        public:
+            using value_type = T;
+
+            void operator*=(const valarray<T>& arr) const
+            {
+                compute_assign_<multiplies<void>>(valarray_leaf<T>{arr});
+            }
+
+            void operator/=(const valarray<T>& arr) const
+            {
+                compute_assign_<divides<void>>(valarray_leaf<T>{arr});
+            }
+
+            void operator%=(const valarray<T>& arr) const
+            {
+                compute_assign_<modulus<void>>(valarray_leaf<T>{arr});
+            }
+
+            void operator+=(const valarray<T>& arr) const
+            {
+                compute_assign_<plus<void>>(valarray_leaf<T>{arr});
+            }
+
+            void operator-=(const valarray<T>& arr) const
+            {
+                compute_assign_<minus<void>>(valarray_leaf<T>{arr});
+            }
+
+            void operator^=(const valarray<T>& arr) const
+            {
+                compute_assign_<bit_xor<void>>(valarray_leaf<T>{arr});
+            }
+
+            void operator&=(const valarray<T>& arr) const
+            {
+                compute_assign_<bit_and<void>>(valarray_leaf<T>{arr});
+            }
+
+            void operator|=(const valarray<T>& arr) const
+            {
+                compute_assign_<bit_or<void>>(valarray_leaf<T>{arr});
+            }
+
+            void operator<<=(const valarray<T>& arr) const
+            {
+                compute_assign_<valarray_shift_left<T>>(valarray_leaf<T>{arr});
+            }
+
+            void operator>>=(const valarray<T>& arr) const
+            {
+                compute_assign_<valarray_shift_right<T>>(valarray_leaf<T>{arr});
+            }
+
+        protected:
+            valarray_view(T* data, const Indexer& indexer)
+                : data_{data}, indexer_{indexer}
+            { /* DUMMY BODY */ }
+
+            valarray_view(const valarray_view&) = default;
+
+            const T& operator[](size_t i) const
+            {
+                return data_[indexer_(i)];
+            }
+
+            size_t size() const
+            {
+                return indexer_.size();
+            }
+
+            template<class E>
+            void assign_(const E& expr) const
+            {
+                auto n = indexer_.size();
+                for (size_t i = 0; i < n; ++i)
+                    data_[indexer_(i)] = expr[i];
+            }
+
+            template<class Op, class E>
+            void compute_assign_(const E& expr) const
+            {
+                auto n = indexer_.size();
+                for (size_t i = 0; i < n; ++i)
+                {
+                    auto& elem = data_[indexer_(i)];
+                    elem = Op{}(elem, expr[i]);
+                }
+            }
+
+        private:
+            T* data_;
+            Indexer indexer_;
+
+            friend class valarray<T>;
+    };
+}
+
+namespace std
+{
+    /**
+     * 26.6.5, class template slice_array:
+     */
+
+    template<class T>
+    class slice_array: public aux::valarray_view<T, aux::valarray_slice_indexer>
+    {
+        public:
+            using value_type = T;
+
+            slice_array(const slice_array&) = default;
+
+            const slice_array& operator=(const slice_array& other) const
+            {
+                this->assign_(other);
+
+                return *this;
+            }
+
+            void operator=(const valarray<T>& arr) const
+            {
+                this->assign_(aux::valarray_leaf<T>{arr});
+            }
+
+            void operator=(const T& val) const
+            {
+                this->assign_(aux::valarray_scalar<T>{val});
+            }
+
+            slice_array() = delete;
+
+        private:
+            slice_array(T* data, const slice& s)
+                : aux::valarray_view<T, aux::valarray_slice_indexer>{
+                    data, aux::valarray_slice_indexer{s}
+                  }
+            { /* DUMMY BODY */ }
+
+            friend class valarray<T>;
+    };
+
+    /**
+     * 26.6.7, class template gslice_array:
+     */
+
+    template<class T>
+    class gslice_array: public aux::valarray_view<T, aux::valarray_index_indexer>
+    {
+        public:
+            using value_type = T;
+
+            gslice_array(const gslice_array&) = default;
+
+            const gslice_array& operator=(const gslice_array& other) const
+            {
+                this->assign_(other);
+
+                return *this;
+            }
+
+            void operator=(const valarray<T>& arr) const
+            {
+                this->assign_(aux::valarray_leaf<T>{arr});
+            }
+
+            void operator=(const T& val) const
+            {
+                this->assign_(aux::valarray_scalar<T>{val});
+            }
+
+            gslice_array() = delete;
+
+        private:
+            gslice_array(T* data, const valarray<size_t>& indices)
+                : aux::valarray_view<T, aux::valarray_index_indexer>{
+                    data, aux::valarray_index_indexer{indices}
+                  }
+            { /* DUMMY BODY */ }
+
+            friend class valarray<T>;
+    };
+
+    /**
+     * 26.6.8, class template mask_array:
+     */
+
+    template<class T>
+    class mask_array: public aux::valarray_view<T, aux::valarray_index_indexer>
+    {
+        public:
+            using value_type = T;
+
+            mask_array(const mask_array&) = default;
+
+            const mask_array& operator=(const mask_array& other) const
+            {
+                this->assign_(other);
+
+                return *this;
+            }
+
+            void operator=(const valarray<T>& arr) const
+            {
+                this->assign_(aux::valarray_leaf<T>{arr});
+            }
+
+            void operator=(const T& val) const
+            {
+                this->assign_(aux::valarray_scalar<T>{val});
+            }
+
+            mask_array() = delete;
+
+        private:
+            mask_array(T* data, const valarray<size_t>& indices)
+                : aux::valarray_view<T, aux::valarray_index_indexer>{
+                    data, aux::valarray_index_indexer{indices}
+                  }
+            { /* DUMMY BODY */ }
+
+            friend class valarray<T>;
+    };
+
+    /**
+     * 26.6.9, class template indirect_array:
+     */
+
+    template<class T>
+    class indirect_array: public aux::valarray_view<T, aux::valarray_index_indexer>
+    {
+        public:
+            using value_type = T;
+
+            indirect_array(const indirect_array&) = default;
+
+            const indirect_array& operator=(const indirect_array& other) const
+            {
+                this->assign_(other);
+
+                return *this;
+            }
+
+            void operator=(const valarray<T>& arr) const
+            {
+                this->assign_(aux::valarray_leaf<T>{arr});
+            }
+
+            void operator=(const T& val) const
+            {
+                this->assign_(aux::valarray_scalar<T>{val});
+            }
+
+            indirect_array() = delete;
+
+        private:
+            indirect_array(T* data, const valarray<size_t>& indices)
+                : aux::valarray_view<T, aux::valarray_index_indexer>{
+                    data, aux::valarray_index_indexer{indices}
+                  }
+            { /* DUMMY BODY */ }
+
+            friend class valarray<T>;
+    };
+
+    /**
+     * 26.6.2.5, subset operations:
+     */
+
+    template<class T>
+    valarray<T> valarray<T>::operator[](slice s) const
+    {
+        return valarray{slice_array<T>{data_, s}};
+    }
+
+    template<class T>
+    slice_array<T> valarray<T>::operator[](slice s)
+    {
+        return slice_array<T>{data_, s};
+    }
+
+    template<class T>
+    valarray<T> valarray<T>::operator[](const gslice& gs) const
+    {
+        return valarray{gslice_array<T>{data_, gs.indices_}};
+    }
+
+    template<class T>
+    gslice_array<T> valarray<T>::operator[](const gslice& gs)
+    {
+        return gslice_array<T>{data_, gs.indices_};
+    }
+
+    template<class T>
+    valarray<T> valarray<T>::operator[](const valarray<bool>& mask) const
+    {
+        return valarray{mask_array<T>{data_, aux::valarray_mask_indices(mask)}};
+    }
+
+    template<class T>
+    mask_array<T> valarray<T>::operator[](const valarray<bool>& mask)
+    {
+        return mask_array<T>{data_, aux::valarray_mask_indices(mask)};
+    }
+
+    template<class T>
+    valarray<T> valarray<T>::operator[](const valarray<size_t>& indices) const
+    {
+        return valarray{indirect_array<T>{data_, indices}};
+    }
+
+    template<class T>
+    indirect_array<T> valarray<T>::operator[](const valarray<size_t>& indices)
+    {
+        return indirect_array<T>{data_, indices};
+    }
+
+    /**
+     * 26.6.3, valarray non-member operations:
+     */
+
+    template<class T>
+    void swap(valarray<T>& lhs, valarray<T>& rhs) noexcept
+    {
+        lhs.swap(rhs);
+    }
+
+    /**
+     * 26.6.3.1, binary operators:
+     */
+
+    template<class L, class R, class = aux::enable_valarray_operands_t<L, R>>
+    auto operator*(const L& lhs, const R& rhs)
+    {
+        return aux::make_valarray_binary<multiplies<aux::valarray_value_t<L>>>(
+            aux::valarray_unwrap(lhs), aux::valarray_unwrap(rhs)
+        );
+    }
+
+    template<class L, class = aux::enable_valarray_operand_t<L>>
+    auto operator*(const L& lhs, const aux::valarray_value_t<L>& rhs)
+    {
+        return aux::make_valarray_binary<multiplies<aux::valarray_value_t<L>>>(
+            aux::valarray_unwrap(lhs), aux::valarray_scalar<aux::valarray_value_t<L>>{rhs}
+        );
+    }
+
+    template<class R, class = aux::enable_valarray_operand_t<R>>
+    auto operator*(const aux::valarray_value_t<R>& lhs, const R& rhs)
+    {
+        return aux::make_valarray_binary<multiplies<aux::valarray_value_t<R>>>(
+            aux::valarray_scalar<aux::valarray_value_t<R>>{lhs}, aux::valarray_unwrap(rhs)
+        );
+    }
+
+    template<class L, class R, class = aux::enable_valarray_operands_t<L, R>>
+    auto operator/(const L& lhs, const R& rhs)
+    {
+        return aux::make_valarray_binary<divides<aux::valarray_value_t<L>>>(
+            aux::valarray_unwrap(lhs), aux::valarray_unwrap(rhs)
+        );
+    }
+
+    template<class L, class = aux::enable_valarray_operand_t<L>>
+    auto operator/(const L& lhs, const aux::valarray_value_t<L>& rhs)
+    {
+        return aux::make_valarray_binary<divides<aux::valarray_value_t<L>>>(
+            aux::valarray_unwrap(lhs), aux::valarray_scalar<aux::valarray_value_t<L>>{rhs}
+        );
+    }
+
+    template<class R, class = aux::enable_valarray_operand_t<R>>
+    auto operator/(const aux::valarray_value_t<R>& lhs, const R& rhs)
+    {
+        return aux::make_valarray_binary<divides<aux::valarray_value_t<R>>>(
+            aux::valarray_scalar<aux::valarray_value_t<R>>{lhs}, aux::valarray_unwrap(rhs)
+        );
+    }
+
+    template<class L, class R, class = aux::enable_valarray_operands_t<L, R>>
+    auto operator%(const L& lhs, const R& rhs)
+    {
+        return aux::make_valarray_binary<modulus<aux::valarray_value_t<L>>>(
+            aux::valarray_unwrap(lhs), aux::valarray_unwrap(rhs)
+        );
+    }
+
+    template<class L, class = aux::enable_valarray_operand_t<L>>
+    auto operator%(const L& lhs, const aux::valarray_value_t<L>& rhs)
+    {
+        return aux::make_valarray_binary<modulus<aux::valarray_value_t<L>>>(
+            aux::valarray_unwrap(lhs), aux::valarray_scalar<aux::valarray_value_t<L>>{rhs}
+        );
+    }
+
+    template<class R, class = aux::enable_valarray_operand_t<R>>
+    auto operator%(const aux::valarray_value_t<R>& lhs, const R& rhs)
+    {
+        return aux::make_valarray_binary<modulus<aux::valarray_value_t<R>>>(
+            aux::valarray_scalar<aux::valarray_value_t<R>>{lhs}, aux::valarray_unwrap(rhs)
+        );
+    }
+
+    template<class L, class R, class = aux::enable_valarray_operands_t<L, R>>
+    auto operator+(const L& lhs, const R& rhs)
+    {
+        return aux::make_valarray_binary<plus<aux::valarray_value_t<L>>>(
+            aux::valarray_unwrap(lhs), aux::valarray_unwrap(rhs)
+        );
+    }
+
+    template<class L, class = aux::enable_valarray_operand_t<L>>
+    auto operator+(const L& lhs, const aux::valarray_value_t<L>& rhs)
+    {
+        return aux::make_valarray_binary<plus<aux::valarray_value_t<L>>>(
+            aux::valarray_unwrap(lhs), aux::valarray_scalar<aux::valarray_value_t<L>>{rhs}
+        );
+    }
+
+    template<class R, class = aux::enable_valarray_operand_t<R>>
+    auto operator+(const aux::valarray_value_t<R>& lhs, const R& rhs)
+    {
+        return aux::make_valarray_binary<plus<aux::valarray_value_t<R>>>(
+            aux::valarray_scalar<aux::valarray_value_t<R>>{lhs}, aux::valarray_unwrap(rhs)
+        );
+    }
+
+    template<class L, class R, class = aux::enable_valarray_operands_t<L, R>>
+    auto operator-(const L& lhs, const R& rhs)
+    {
+        return aux::make_valarray_binary<minus<aux::valarray_value_t<L>>>(
+            aux::valarray_unwrap(lhs), aux::valarray_unwrap(rhs)
+        );
+    }
+
+    template<class L, class = aux::enable_valarray_operand_t<L>>
+    auto operator-(const L& lhs, const aux::valarray_value_t<L>& rhs)
+    {
+        return aux::make_valarray_binary<minus<aux::valarray_value_t<L>>>(
+            aux::valarray_unwrap(lhs), aux::valarray_scalar<aux::valarray_value_t<L>>{rhs}
+        );
+    }
+
+    template<class R, class = aux::enable_valarray_operand_t<R>>
+    auto operator-(const aux::valarray_value_t<R>& lhs, const R& rhs)
+    {
+        return aux::make_valarray_binary<minus<aux::valarray_value_t<R>>>(
+            aux::valarray_scalar<aux::valarray_value_t<R>>{lhs}, aux::valarray_unwrap(rhs)
+        );
+    }
+
+    template<class L, class R, class = aux::enable_valarray_operands_t<L, R>>
+    auto operator^(const L& lhs, const R& rhs)
+    {
+        return aux::make_valarray_binary<bit_xor<aux::valarray_value_t<L>>>(
+            aux::valarray_unwrap(lhs), aux::valarray_unwrap(rhs)
+        );
+    }
+
+    template<class L, class = aux::enable_valarray_operand_t<L>>
+    auto operator^(const L& lhs, const aux::valarray_value_t<L>& rhs)
+    {
+        return aux::make_valarray_binary<bit_xor<aux::valarray_value_t<L>>>(
+            aux::valarray_unwrap(lhs), aux::valarray_scalar<aux::valarray_value_t<L>>{rhs}
+        );
+    }
+
+    template<class R, class = aux::enable_valarray_operand_t<R>>
+    auto operator^(const aux::valarray_value_t<R>& lhs, const R& rhs)
+    {
+        return aux::make_valarray_binary<bit_xor<aux::valarray_value_t<R>>>(
+            aux::valarray_scalar<aux::valarray_value_t<R>>{lhs}, aux::valarray_unwrap(rhs)
+        );
+    }
+
+    template<class L, class R, class = aux::enable_valarray_operands_t<L, R>>
+    auto operator&(const L& lhs, const R& rhs)
+    {
+        return aux::make_valarray_binary<bit_and<aux::valarray_value_t<L>>>(
+            aux::valarray_unwrap(lhs), aux::valarray_unwrap(rhs)
+        );
+    }
+
+    template<class L, class = aux::enable_valarray_operand_t<L>>
+    auto operator&(const L& lhs, const aux::valarray_value_t<L>& rhs)
+    {
+        return aux::make_valarray_binary<bit_and<aux::valarray_value_t<L>>>(
+            aux::valarray_unwrap(lhs), aux::valarray_scalar<aux::valarray_value_t<L>>{rhs}
+        );
+    }
+
+    template<class R, class = aux::enable_valarray_operand_t<R>>
+    auto operator&(const aux::valarray_value_t<R>& lhs, const R& rhs)
+    {
+        return aux::make_valarray_binary<bit_and<aux::valarray_value_t<R>>>(
+            aux::valarray_scalar<aux::valarray_value_t<R>>{lhs}, aux::valarray_unwrap(rhs)
+        );
+    }
+
+    template<class L, class R, class = aux::enable_valarray_operands_t<L, R>>
+    auto operator|(const L& lhs, const R& rhs)
+    {
+        return aux::make_valarray_binary<bit_or<aux::valarray_value_t<L>>>(
+            aux::valarray_unwrap(lhs), aux::valarray_unwrap(rhs)
+        );
+    }
+
+    template<class L, class = aux::enable_valarray_operand_t<L>>
+    auto operator|(const L& lhs, const aux::valarray_value_t<L>& rhs)
+    {
+        return aux::make_valarray_binary<bit_or<aux::valarray_value_t<L>>>(
+            aux::valarray_unwrap(lhs), aux::valarray_scalar<aux::valarray_value_t<L>>{rhs}
+        );
+    }
+
+    template<class R, class = aux::enable_valarray_operand_t<R>>
+    auto operator|(const aux::valarray_value_t<R>& lhs, const R& rhs)
+    {
+        return aux::make_valarray_binary<bit_or<aux::valarray_value_t<R>>>(
+            aux::valarray_scalar<aux::valarray_value_t<R>>{lhs}, aux::valarray_unwrap(rhs)
+        );
+    }
+
+    template<class L, class R, class = aux::enable_valarray_operands_t<L, R>>
+    auto operator<<(const L& lhs, const R& rhs)
+    {
+        return aux::make_valarray_binary<aux::valarray_shift_left<aux::valarray_value_t<L>>>(
+            aux::valarray_unwrap(lhs), aux::valarray_unwrap(rhs)
+        );
+    }
+
+    template<class L, class = aux::enable_valarray_operand_t<L>>
+    auto operator<<(const L& lhs, const aux::valarray_value_t<L>& rhs)
+    {
+        return aux::make_valarray_binary<aux::valarray_shift_left<aux::valarray_value_t<L>>>(
+            aux::valarray_unwrap(lhs), aux::valarray_scalar<aux::valarray_value_t<L>>{rhs}
+        );
+    }
+
+    template<class R, class = aux::enable_valarray_operand_t<R>>
+    auto operator<<(const aux::valarray_value_t<R>& lhs, const R& rhs)
+    {
+        return aux::make_valarray_binary<aux::valarray_shift_left<aux::valarray_value_t<R>>>(
+            aux::valarray_scalar<aux::valarray_value_t<R>>{lhs}, aux::valarray_unwrap(rhs)
+        );
+    }
+
+    template<class L, class R, class = aux::enable_valarray_operands_t<L, R>>
+    auto operator>>(const L& lhs, const R& rhs)
+    {
+        return aux::make_valarray_binary<aux::valarray_shift_right<aux::valarray_value_t<L>>>(
+            aux::valarray_unwrap(lhs), aux::valarray_unwrap(rhs)
+        );
+    }
+
+    template<class L, class = aux::enable_valarray_operand_t<L>>
+    auto operator>>(const L& lhs, const aux::valarray_value_t<L>& rhs)
+    {
+        return aux::make_valarray_binary<aux::valarray_shift_right<aux::valarray_value_t<L>>>(
+            aux::valarray_unwrap(lhs), aux::valarray_scalar<aux::valarray_value_t<L>>{rhs}
+        );
+    }
+
+    template<class R, class = aux::enable_valarray_operand_t<R>>
+    auto operator>>(const aux::valarray_value_t<R>& lhs, const R& rhs)
+    {
+        return aux::make_valarray_binary<aux::valarray_shift_right<aux::valarray_value_t<R>>>(
+            aux::valarray_scalar<aux::valarray_value_t<R>>{lhs}, aux::valarray_unwrap(rhs)
+        );
+    }
+
+    template<class L, class R, class = aux::enable_valarray_operands_t<L, R>>
+    auto operator&&(const L& lhs, const R& rhs)
+    {
+        return aux::make_valarray_binary<logical_and<aux::valarray_value_t<L>>>(
+            aux::valarray_unwrap(lhs), aux::valarray_unwrap(rhs)
+        );
+    }
+
+    template<class L, class = aux::enable_valarray_operand_t<L>>
+    auto operator&&(const L& lhs, const aux::valarray_value_t<L>& rhs)
+    {
+        return aux::make_valarray_binary<logical_and<aux::valarray_value_t<L>>>(
+            aux::valarray_unwrap(lhs), aux::valarray_scalar<aux::valarray_value_t<L>>{rhs}
+        );
+    }
+
+    template<class R, class = aux::enable_valarray_operand_t<R>>
+    auto operator&&(const aux::valarray_value_t<R>& lhs, const R& rhs)
+    {
+        return aux::make_valarray_binary<logical_and<aux::valarray_value_t<R>>>(
+            aux::valarray_scalar<aux::valarray_value_t<R>>{lhs}, aux::valarray_unwrap(rhs)
+        );
+    }
+
+    template<class L, class R, class = aux::enable_valarray_operands_t<L, R>>
+    auto operator||(const L& lhs, const R& rhs)
+    {
+        return aux::make_valarray_binary<logical_or<aux::valarray_value_t<L>>>(
+            aux::valarray_unwrap(lhs), aux::valarray_unwrap(rhs)
+        );
+    }
+
+    template<class L, class = aux::enable_valarray_operand_t<L>>
+    auto operator||(const L& lhs, const aux::valarray_value_t<L>& rhs)
+    {
+        return aux::make_valarray_binary<logical_or<aux::valarray_value_t<L>>>(
+            aux::valarray_unwrap(lhs), aux::valarray_scalar<aux::valarray_value_t<L>>{rhs}
+        );
+    }
+
+    template<class R, class = aux::enable_valarray_operand_t<R>>
+    auto operator||(const aux::valarray_value_t<R>& lhs, const R& rhs)
+    {
+        return aux::make_valarray_binary<logical_or<aux::valarray_value_t<R>>>(
+            aux::valarray_scalar<aux::valarray_value_t<R>>{lhs}, aux::valarray_unwrap(rhs)
+        );
+    }
+
+    /**
+     * 26.6.3.2, logical operators:
+     */
+
+    template<class L, class R, class = aux::enable_valarray_operands_t<L, R>>
+    auto operator==(const L& lhs, const R& rhs)
+    {
+        return aux::make_valarray_binary<equal_to<aux::valarray_value_t<L>>>(
+            aux::valarray_unwrap(lhs), aux::valarray_unwrap(rhs)
+        );
+    }
+
+    template<class L, class = aux::enable_valarray_operand_t<L>>
+    auto operator==(const L& lhs, const aux::valarray_value_t<L>& rhs)
+    {
+        return aux::make_valarray_binary<equal_to<aux::valarray_value_t<L>>>(
+            aux::valarray_unwrap(lhs), aux::valarray_scalar<aux::valarray_value_t<L>>{rhs}
+        );
+    }
+
+    template<class R, class = aux::enable_valarray_operand_t<R>>
+    auto operator==(const aux::valarray_value_t<R>& lhs, const R& rhs)
+    {
+        return aux::make_valarray_binary<equal_to<aux::valarray_value_t<R>>>(
+            aux::valarray_scalar<aux::valarray_value_t<R>>{lhs}, aux::valarray_unwrap(rhs)
+        );
+    }
+
+    template<class L, class R, class = aux::enable_valarray_operands_t<L, R>>
+    auto operator!=(const L& lhs, const R& rhs)
+    {
+        return aux::make_valarray_binary<not_equal_to<aux::valarray_value_t<L>>>(
+            aux::valarray_unwrap(lhs), aux::valarray_unwrap(rhs)
+        );
+    }
+
+    template<class L, class = aux::enable_valarray_operand_t<L>>
+    auto operator!=(const L& lhs, const aux::valarray_value_t<L>& rhs)
+    {
+        return aux::make_valarray_binary<not_equal_to<aux::valarray_value_t<L>>>(
+            aux::valarray_unwrap(lhs), aux::valarray_scalar<aux::valarray_value_t<L>>{rhs}
+        );
+    }
+
+    template<class R, class = aux::enable_valarray_operand_t<R>>
+    auto operator!=(const aux::valarray_value_t<R>& lhs, const R& rhs)
+    {
+        return aux::make_valarray_binary<not_equal_to<aux::valarray_value_t<R>>>(
+            aux::valarray_scalar<aux::valarray_value_t<R>>{lhs}, aux::valarray_unwrap(rhs)
+        );
+    }
+
+    template<class L, class R, class = aux::enable_valarray_operands_t<L, R>>
+    auto operator<(const L& lhs, const R& rhs)
+    {
+        return aux::make_valarray_binary<less<aux::valarray_value_t<L>>>(
+            aux::valarray_unwrap(lhs), aux::valarray_unwrap(rhs)
+        );
+    }
+
+    template<class L, class = aux::enable_valarray_operand_t<L>>
+    auto operator<(const L& lhs, const aux::valarray_value_t<L>& rhs)
+    {
+        return aux::make_valarray_binary<less<aux::valarray_value_t<L>>>(
+            aux::valarray_unwrap(lhs), aux::valarray_scalar<aux::valarray_value_t<L>>{rhs}
+        );
+    }
+
+    template<class R, class = aux::enable_valarray_operand_t<R>>
+    auto operator<(const aux::valarray_value_t<R>& lhs, const R& rhs)
+    {
+        return aux::make_valarray_binary<less<aux::valarray_value_t<R>>>(
+            aux::valarray_scalar<aux::valarray_value_t<R>>{lhs}, aux::valarray_unwrap(rhs)
+        );
+    }
+
+    template<class L, class R, class = aux::enable_valarray_operands_t<L, R>>
+    auto operator>(const L& lhs, const R& rhs)
+    {
+        return aux::make_valarray_binary<greater<aux::valarray_value_t<L>>>(
+            aux::valarray_unwrap(lhs), aux::valarray_unwrap(rhs)
+        );
+    }
+
+    template<class L, class = aux::enable_valarray_operand_t<L>>
+    auto operator>(const L& lhs, const aux::valarray_value_t<L>& rhs)
+    {
+        return aux::make_valarray_binary<greater<aux::valarray_value_t<L>>>(
+            aux::valarray_unwrap(lhs), aux::valarray_scalar<aux::valarray_value_t<L>>{rhs}
+        );
+    }
+
+    template<class R, class = aux::enable_valarray_operand_t<R>>
+    auto operator>(const aux::valarray_value_t<R>& lhs, const R& rhs)
+    {
+        return aux::make_valarray_binary<greater<aux::valarray_value_t<R>>>(
+            aux::valarray_scalar<aux::valarray_value_t<R>>{lhs}, aux::valarray_unwrap(rhs)
+        );
+    }
+
+    template<class L, class R, class = aux::enable_valarray_operands_t<L, R>>
+    auto operator<=(const L& lhs, const R& rhs)
+    {
+        return aux::make_valarray_binary<less_equal<aux::valarray_value_t<L>>>(
+            aux::valarray_unwrap(lhs), aux::valarray_unwrap(rhs)
+        );
+    }
+
+    template<class L, class = aux::enable_valarray_operand_t<L>>
+    auto operator<=(const L& lhs, const aux::valarray_value_t<L>& rhs)
+    {
+        return aux::make_valarray_binary<less_equal<aux::valarray_value_t<L>>>(
+            aux::valarray_unwrap(lhs), aux::valarray_scalar<aux::valarray_value_t<L>>{rhs}
+        );
+    }
+
+    template<class R, class = aux::enable_valarray_operand_t<R>>
+    auto operator<=(const aux::valarray_value_t<R>& lhs, const R& rhs)
+    {
+        return aux::make_valarray_binary<less_equal<aux::valarray_value_t<R>>>(
+            aux::valarray_scalar<aux::valarray_value_t<R>>{lhs}, aux::valarray_unwrap(rhs)
+        );
+    }
+
+    template<class L, class R, class = aux::enable_valarray_operands_t<L, R>>
+    auto operator>=(const L& lhs, const R& rhs)
+    {
+        return aux::make_valarray_binary<greater_equal<aux::valarray_value_t<L>>>(
+            aux::valarray_unwrap(lhs), aux::valarray_unwrap(rhs)
+        );
+    }
+
+    template<class L, class = aux::enable_valarray_operand_t<L>>
+    auto operator>=(const L& lhs, const aux::valarray_value_t<L>& rhs)
+    {
+        return aux::make_valarray_binary<greater_equal<aux::valarray_value_t<L>>>(
+            aux::valarray_unwrap(lhs), aux::valarray_scalar<aux::valarray_value_t<L>>{rhs}
+        );
+    }
+
+    template<class R, class = aux::enable_valarray_operand_t<R>>
+    auto operator>=(const aux::valarray_value_t<R>& lhs, const R& rhs)
+    {
+        return aux::make_valarray_binary<greater_equal<aux::valarray_value_t<R>>>(
+            aux::valarray_scalar<aux::valarray_value_t<R>>{lhs}, aux::valarray_unwrap(rhs)
+        );
+    }
+
+    /**
+     * 26.6.3.3, transcendentals:
+     */
+
+    template<class X, class = aux::enable_valarray_operand_t<X>>
+    auto abs(const X& x)
+    {
+        return aux::make_valarray_unary<aux::valarray_abs>(aux::valarray_unwrap(x));
+    }
+
+    template<class X, class = aux::enable_valarray_operand_t<X>>
+    auto acos(const X& x)
+    {
+        return aux::make_valarray_unary<aux::valarray_acos>(aux::valarray_unwrap(x));
+    }
+
+    template<class X, class = aux::enable_valarray_operand_t<X>>
+    auto asin(const X& x)
+    {
+        return aux::make_valarray_unary<aux::valarray_asin>(aux::valarray_unwrap(x));
+    }
+
+    template<class X, class = aux::enable_valarray_operand_t<X>>
+    auto atan(const X& x)
+    {
+        return aux::make_valarray_unary<aux::valarray_atan>(aux::valarray_unwrap(x));
+    }
+
+    template<class L, class R, class = aux::enable_valarray_operands_t<L, R>>
+    auto atan2(const L& lhs, const R& rhs)
+    {
+        return aux::make_valarray_binary<aux::valarray_atan2>(
+            aux::valarray_unwrap(lhs), aux::valarray_unwrap(rhs)
+        );
+    }
+
+    template<class L, class = aux::enable_valarray_operand_t<L>>
+    auto atan2(const L& lhs, const aux::valarray_value_t<L>& rhs)
+    {
+        return aux::make_valarray_binary<aux::valarray_atan2>(
+            aux::valarray_unwrap(lhs), aux::valarray_scalar<aux::valarray_value_t<L>>{rhs}
+        );
+    }
+
+    template<class R, class = aux::enable_valarray_operand_t<R>>
+    auto atan2(const aux::valarray_value_t<R>& lhs, const R& rhs)
+    {
+        return aux::make_valarray_binary<aux::valarray_atan2>(
+            aux::valarray_scalar<aux::valarray_value_t<R>>{lhs}, aux::valarray_unwrap(rhs)
+        );
+    }
+
+    template<class X, class = aux::enable_valarray_operand_t<X>>
+    auto cos(const X& x)
+    {
+        return aux::make_valarray_unary<aux::valarray_cos>(aux::valarray_unwrap(x));
+    }
+
+    template<class X, class = aux::enable_valarray_operand_t<X>>
+    auto cosh(const X& x)
+    {
+        return aux::make_valarray_unary<aux::valarray_cosh>(aux::valarray_unwrap(x));
+    }
+
+    template<class X, class = aux::enable_valarray_operand_t<X>>
+    auto exp(const X& x)
+    {
+        return aux::make_valarray_unary<aux::valarray_exp>(aux::valarray_unwrap(x));
+    }
+
+    template<class X, class = aux::enable_valarray_operand_t<X>>
+    auto log(const X& x)
+    {
+        return aux::make_valarray_unary<aux::valarray_log>(aux::valarray_unwrap(x));
+    }
+
+    template<class X, class = aux::enable_valarray_operand_t<X>>
+    auto log10(const X& x)
+    {
+        return aux::make_valarray_unary<aux::valarray_log10>(aux::valarray_unwrap(x));
+    }
+
+    template<class L, class R, class = aux::enable_valarray_operands_t<L, R>>
+    auto pow(const L& lhs, const R& rhs)
+    {
+        return aux::make_valarray_binary<aux::valarray_pow>(
+            aux::valarray_unwrap(lhs), aux::valarray_unwrap(rhs)
+        );
+    }
+
+    template<class L, class = aux::enable_valarray_operand_t<L>>
+    auto pow(const L& lhs, const aux::valarray_value_t<L>& rhs)
+    {
+        return aux::make_valarray_binary<aux::valarray_pow>(
+            aux::valarray_unwrap(lhs), aux::valarray_scalar<aux::valarray_value_t<L>>{rhs}
+        );
+    }
+
+    template<class R, class = aux::enable_valarray_operand_t<R>>
+    auto pow(const aux::valarray_value_t<R>& lhs, const R& rhs)
+    {
+        return aux::make_valarray_binary<aux::valarray_pow>(
+            aux::valarray_scalar<aux::valarray_value_t<R>>{lhs}, aux::valarray_unwrap(rhs)
+        );
+    }
+
+    template<class X, class = aux::enable_valarray_operand_t<X>>
+    auto sin(const X& x)
+    {
+        return aux::make_valarray_unary<aux::valarray_sin>(aux::valarray_unwrap(x));
+    }
+
+    template<class X, class = aux::enable_valarray_operand_t<X>>
+    auto sinh(const X& x)
+    {
+        return aux::make_valarray_unary<aux::valarray_sinh>(aux::valarray_unwrap(x));
+    }
+
+    template<class X, class = aux::enable_valarray_operand_t<X>>
+    auto sqrt(const X& x)
+    {
+        return aux::make_valarray_unary<aux::valarray_sqrt>(aux::valarray_unwrap(x));
+    }
+
+    template<class X, class = aux::enable_valarray_operand_t<X>>
+    auto tan(const X& x)
+    {
+        return aux::make_valarray_unary<aux::valarray_tan>(aux::valarray_unwrap(x));
+    }
+
+    template<class X, class = aux::enable_valarray_operand_t<X>>
+    auto tanh(const X& x)
+    {
+        return aux::make_valarray_unary<aux::valarray_tanh>(aux::valarray_unwrap(x));
+    }
+
+    /**
+     * 26.6.10, valarray range access:
+     */
+
+    template<class T>
+    T* begin(valarray<T>& arr)
+    {
+        return arr.size() > 0 ? &arr[0] : nullptr;
+    }
+
+    template<class T>
+    const T* begin(const valarray<T>& arr)
+    {
+        return arr.size() > 0 ? &arr[0] : nullptr;
+    }
+
+    template<class T>
+    T* end(valarray<T>& arr)
+    {
+        return begin(arr) + arr.size();
+    }
+
+    template<class T>
+    const T* end(const valarray<T>& arr)
+    {
+        return begin(arr) + arr.size();
+    }
+}
 
 #endif
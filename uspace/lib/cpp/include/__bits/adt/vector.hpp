@@ -29,7 +29,9 @@
 #ifndef LIBCPP_BITS_ADT_VECTOR
 #define LIBCPP_BITS_ADT_VECTOR
 
+#include <__bits/insert_iterator.hpp>
 #include <algorithm>
+#include <cstdlib>
 #include <initializer_list>
 #include <iterator>
 #include <memory>
@@ -70,7 +72,7 @@ namespace std
             explicit vector(size_type n, const Allocator& alloc = Allocator{})
                 : data_{}, size_{n}, capacity_{n}, allocator_{alloc}
             {
-                data_ = allocator_.allocate(capacity_);
+                data_ = allocate_(capacity_);
 
                 for (size_type i = 0; i < size_; ++i)
                     allocator_traits<Allocator>::construct(allocator_, data_ + i);
@@ -79,28 +81,47 @@ namespace std
             vector(size_type n, const T& val, const Allocator& alloc = Allocator{})
                 : data_{}, size_{n}, capacity_{n}, allocator_{alloc}
             {
-                data_ = allocator_.allocate(capacity_);
+                data_ = allocate_(capacity_);
 
                 for (size_type i = 0; i < size_; ++i)
-                    data_[i] = val;
+                    allocator_traits<Allocator>::construct(allocator_, data_ + i, val);
             }
 
             template<class InputIterator>
             vector(InputIterator first, InputIterator last,
                    const Allocator& alloc = Allocator{})
-            {
-                // TODO: research constraints and provide multiple
-                //       implementations via enable_if
+                : data_{nullptr}, size_{}, capacity_{}, allocator_{alloc}
+            {
+                if constexpr (is_integral<InputIterator>::value)
+                { // Required by the standard.
+                    size_ = capacity_ = static_cast<size_type>(first);
+                    data_ = allocate_(capacity_);
+
+                    for (size_type i = 0; i < size_; ++i)
+                    {
+                        allocator_traits<Allocator>::construct(
+                            allocator_, data_ + i, static_cast<value_type>(last)
+                        );
+                    }
+                }
+                else
+                {
+                    if constexpr (is_forward_iterator_<InputIterator>())
+                        reserve(static_cast<size_type>(distance(first, last)));
+
+                    while (first != last)
+                        push_back(*first++);
+                }
             }
 
             vector(const vector& other)
                 : data_{nullptr}, size_{other.size_}, capacity_{other.capacity_},
                   allocator_{other.allocator_}
             {
-                data_ = allocator_.allocate(capacity_);
+                data_ = allocate_(capacity_);
 
                 for (size_type i = 0; i < size_; ++i)
-                    data_[i] = other.data_[i];
+                    allocator_traits<Allocator>::construct(allocator_, data_ + i, other.data_[i]);
             }
 
             vector(vector&& other) noexcept
@@ -116,28 +137,30 @@ namespace std
                 : data_{nullptr}, size_{other.size_}, capacity_{other.capacity_},
                   allocator_{alloc}
             {
-                data_ = allocator_.allocate(capacity_);
+                data_ = allocate_(capacity_);
 
                 for (size_type i = 0; i < size_; ++i)
-                    data_[i] = other.data_[i];
+                    allocator_traits<Allocator>::construct(allocator_, data_ + i, other.data_[i]);
             }
 
             vector(initializer_list<T> init, const Allocator& alloc = Allocator{})
                 : data_{nullptr}, size_{init.size()}, capacity_{init.size()},
                   allocator_{alloc}
             {
-                data_ = allocator_.allocate(capacity_);
+                data_ = allocate_(capacity_);
 
                 auto it = init.begin();
                 for (size_type i = 0; it != init.end(); ++i, ++it)
                 {
-                    data_[i] = *it;
+                    allocator_traits<Allocator>::construct(allocator_, data_ + i, *it);
                 }
             }
 
             ~vector()
             {
-                allocator_.deallocate(data_, capacity_);
+                clear();
+                if (data_)
+                    deallocate_(data_, capacity_);
             }
 
             vector& operator=(const vector& other)
@@ -152,10 +175,10 @@ namespace std
                 noexcept(allocator_traits<Allocator>::propagate_on_container_move_assignment::value ||
                          allocator_traits<Allocator>::is_always_equal::value)
             {
+                clear();
                 if (data_)
-                    allocator_.deallocate(data_, capacity_);
+                    deallocate_(data_, capacity_);
 
-                // TODO: test this
                 data_ = other.data_;
                 size_ = other.size_;
                 capacity_ = other.capacity_;
@@ -274,16 +297,33 @@ namespace std
 
             void resize(size_type sz)
             {
-                resize_with_copy_(size_, capacity_);
+                if (sz <= size_)
+                {
+                    destroy_from_end_until_(begin() + sz);
+                    size_ = sz;
+
+                    return;
+                }
+
+                reserve(sz);
+                while (size_ < sz)
+                    emplace_back();
             }
 
             void resize(size_type sz, const value_type& val)
             {
-                auto old_size = size_;
-                resize_with_copy_(sz, capacity_);
+                if (sz <= size_)
+                {
+                    destroy_from_end_until_(begin() + sz);
+                    size_ = sz;
+
+                    return;
+                }
 
-                for (size_type i = old_size - 1; i < size_; ++i)
-                    data_[i] = val;
+                value_type tmp{val};
+                reserve(sz);
+                while (size_ < sz)
+                    emplace_back(tmp);
             }
 
             size_type capacity() const noexcept
@@ -302,12 +342,13 @@ namespace std
                 //       length_error (this function shall have no
                 //       effect in such case)
                 if (new_capacity > capacity_)
-                    resize_with_copy_(size_, new_capacity);
+                    reallocate_(new_capacity);
             }
 
             void shrink_to_fit()
             {
-                resize_with_copy_(size_, size_);
+                if (size_ < capacity_)
+                    reallocate_(size_);
             }
 
             reference operator[](size_type idx)
@@ -356,7 +397,7 @@ namespace std
 
             const_reference back() const
             {
-                return at(size - 1);
+                return at(size_ - 1);
             }
 
             T* data() noexcept
@@ -373,26 +414,50 @@ namespace std
             reference emplace_back(Args&&... args)
             {
                 if (size_ >= capacity_)
-                    resize_with_copy_(size_, next_capacity_());
-
-                allocator_traits<Allocator>::construct(allocator_,
-                                                       begin() + size_, forward<Args>(args)...);
+                {
+                    /**
+                     * The new element is constructed before the old
+                     * ones are moved as the arguments might refer
+                     * to an element of this vector.
+                     */
+                    if constexpr (realloc_growth_)
+                    {
+                        value_type tmp(forward<Args>(args)...);
+                        reallocate_(next_capacity_());
+                        allocator_traits<Allocator>::construct(
+                            allocator_, data_ + size_, move(tmp)
+                        );
+                    }
+                    else
+                    {
+                        auto new_capacity = next_capacity_();
+                        auto new_data = allocate_(new_capacity);
+                        allocator_traits<Allocator>::construct(
+                            allocator_, new_data + size_, forward<Args>(args)...
+                        );
+
+                        move_to_(new_data, new_capacity);
+                    }
+                }
+                else
+                {
+                    allocator_traits<Allocator>::construct(
+                        allocator_, data_ + size_, forward<Args>(args)...
+                    );
+                }
+                ++size_;
 
                 return back();
             }
 
             void push_back(const T& x)
             {
-                if (size_ >= capacity_)
-                    resize_with_copy_(size_, next_capacity_());
-                data_[size_++] = x;
+                emplace_back(x);
             }
 
             void push_back(T&& x)
             {
-                if (size_ >= capacity_)
-                    resize_with_copy_(size_, next_capacity_());
-                data_[size_++] = forward<T>(x);
+                emplace_back(forward<T>(x));
             }
 
             void pop_back()
@@ -404,82 +469,78 @@ namespace std
             template<class... Args>
             iterator emplace(const_iterator position, Args&&... args)
             {
-                auto pos = const_cast<iterator>(position);
-
-                pos = shift_(pos, 1);
-                allocator_.construct(pos, forward<Args>(args)...);
+                auto idx = static_cast<size_type>(position - cbegin());
+                emplace_back(forward<Args>(args)...);
 
-                return pos;
+                return rotate_tail_(idx, size_ - 1);
             }
 
             iterator insert(const_iterator position, const value_type& x)
             {
-                auto pos = const_cast<iterator>(position);
-
-                pos = shift_(pos, 1);
-                *pos = x;
-
-                return pos;
+                return emplace(position, x);
             }
 
             iterator insert(const_iterator position, value_type&& x)
             {
-                auto pos = const_cast<iterator>(position);
-
-                pos = shift_(pos, 1);
-                *pos = forward<value_type>(x);
-
-                return pos;
+                return emplace(position, forward<value_type>(x));
             }
 
             iterator insert(const_iterator position, size_type count, const value_type& x)
             {
-                auto pos = const_cast<iterator>(position);
-
-                pos = shift_(pos, count);
-                auto copy_target = pos;
-                for (size_type i = 0; i < count; ++i)
-                    *copy_target++ = x;
+                auto idx = static_cast<size_type>(position - cbegin());
+                insert_range_(idx, aux::insert_iterator<value_type>{0u, x}, count);
 
-                return pos;
+                return begin() + idx;
             }
 
             template<class InputIterator>
             iterator insert(const_iterator position, InputIterator first,
                             InputIterator last)
             {
-                auto pos = const_cast<iterator>(position);
-                auto count = static_cast<size_type>(last - first);
+                auto idx = static_cast<size_type>(position - cbegin());
 
-                pos = shift_(pos, count);
-                copy(first, last, pos);
+                if constexpr (is_integral<InputIterator>::value)
+                { // Required by the standard.
+                    return insert(
+                        position, static_cast<size_type>(first),
+                        static_cast<value_type>(last)
+                    );
+                }
+                else if constexpr (is_forward_iterator_<InputIterator>())
+                {
+                    auto count = static_cast<size_type>(distance(first, last));
+                    insert_range_(idx, first, count);
 
-                return pos;
+                    return begin() + idx;
+                }
+                else
+                {
+                    auto old_size = size_;
+                    while (first != last)
+                        emplace_back(*first++);
+
+                    return rotate_tail_(idx, old_size);
+                }
             }
 
             iterator insert(const_iterator position, initializer_list<T> init)
             {
-                auto pos = const_cast<iterator>(position);
-
-                pos = shift_(pos, init.size());
-                copy(init.begin(), init.end(), pos);
-
-                return pos;
+                return insert(position, init.begin(), init.end());
             }
 
             iterator erase(const_iterator position)
             {
-                iterator pos = const_cast<iterator>(position);
-                copy(position + 1, cend(), pos);
-                --size_;
-
-                return pos;
+                return erase(position, position + 1);
             }
 
             iterator erase(const_iterator first, const_iterator last)
             {
                 iterator pos = const_cast<iterator>(first);
-                copy(last, cend(), pos);
+                if (first == last)
+                    return pos;
+
+                auto new_end = move(const_cast<iterator>(last), end(), pos);
+                destroy_from_end_until_(new_end);
                 size_ -= static_cast<size_type>(last - first);
 
                 return pos;
@@ -507,36 +568,96 @@ namespace std
             size_type capacity_;
             allocator_type allocator_;
 
-            void resize_without_copy_(size_type capacity)
+            /**
+             * Trivially relocatable elements held by the default
+             * allocator are kept in storage obtained from malloc,
+             * so that growing it can use realloc, which is often
+             * able to extend the block in place.
+             */
+            static constexpr bool realloc_growth_ =
+                is_same<allocator_type, allocator<value_type>>::value &&
+                aux::is_trivially_relocatable<value_type>::value;
+
+            template<class Iterator>
+            static constexpr bool is_forward_iterator_()
             {
-                if (data_)
-                    allocator_.deallocate(data_, capacity_);
+                return is_base_of<
+                    forward_iterator_tag,
+                    typename iterator_traits<Iterator>::iterator_category
+                >::value;
+            }
 
-                data_ = allocator_.allocate(capacity);
-                size_ = 0;
-                capacity_ = capacity;
+            value_type* allocate_(size_type n)
+            {
+                if constexpr (realloc_growth_)
+                {
+                    if (n == 0)
+                        return nullptr;
+
+                    auto res = std::malloc(n * sizeof(value_type));
+                    if (!res)
+                        throw bad_alloc{};
+
+                    return static_cast<value_type*>(res);
+                }
+                else
+                    return allocator_.allocate(n);
             }
 
-            void resize_with_copy_(size_type size, size_type capacity)
+            void deallocate_(value_type* ptr, size_type n)
             {
-                if (size < size_)
-                    destroy_from_end_until_(begin() + size);
+                if constexpr (realloc_growth_)
+                    std::free(ptr);
+                else
+                    allocator_.deallocate(ptr, n);
+            }
 
-                if(capacity_ == 0 || capacity_ < capacity)
+            void reallocate_(size_type capacity)
+            {
+                if constexpr (realloc_growth_)
                 {
-                    auto new_data = allocator_.allocate(capacity);
+                    if (capacity == 0)
+                    {
+                        std::free(data_);
+                        data_ = nullptr;
+                        capacity_ = 0;
 
-                    auto to_copy = min(size, size_);
-                    for (size_type i = 0; i < to_copy; ++i)
-                        new_data[i] = move(data_[i]);
+                        return;
+                    }
 
-                    std::swap(data_, new_data);
+                    auto res = std::realloc(data_, capacity * sizeof(value_type));
+                    if (!res)
+                    {
+                        throw bad_alloc{};
 
-                    allocator_.deallocate(new_data, capacity_);
+                        return;
+                    }
+
+                    data_ = static_cast<value_type*>(res);
+                    capacity_ = capacity;
+                }
+                else
+                    move_to_(allocate_(capacity), capacity);
+            }
+
+            /**
+             * Moves the elements to a new buffer and
+             * releases the old one.
+             */
+            void move_to_(value_type* new_data, size_type new_capacity)
+            {
+                for (size_type i = 0; i < size_; ++i)
+                {
+                    allocator_traits<Allocator>::construct(
+                        allocator_, new_data + i, move(data_[i])
+                    );
+                    allocator_traits<Allocator>::destroy(allocator_, data_ + i);
                 }
 
-                capacity_ = capacity;
-                size_ = size;
+                if (data_)
+                    deallocate_(data_, capacity_);
+                data_ = new_data;
+                capacity_ = new_capacity;
             }
 
             void destroy_from_end_until_(iterator target)
@@ -557,37 +678,84 @@ namespace std
                     return max(capacity_ * 2, size_type{2u});
             }
 
-            iterator shift_(iterator position, size_type count)
+            /**
+             * Inserts count elements starting at first before
+             * the index idx, reallocating at most once.
+             */
+            template<class ForwardIterator>
+            void insert_range_(size_type idx, ForwardIterator first, size_type count)
             {
-                if (size_ + count < capacity_)
+                if (count == 0)
+                    return;
+
+                if (size_ + count > capacity_)
                 {
-                    copy_backward(position, end(), end() + count);
+                    auto new_capacity = next_capacity_(size_ + count);
+                    auto new_data = allocate_(new_capacity);
+
+                    for (size_type i = 0; i < count; ++i, ++first)
+                        allocator_traits<Allocator>::construct(allocator_, new_data + idx + i, *first);
+
+                    for (size_type i = 0; i < size_; ++i)
+                    {
+                        auto target = new_data + (i < idx ? i : i + count);
+                        allocator_traits<Allocator>::construct(allocator_, target, move(data_[i]));
+                        allocator_traits<Allocator>::destroy(allocator_, data_ + i);
+                    }
+
+                    if (data_)
+                        deallocate_(data_, capacity_);
+                    data_ = new_data;
+                    capacity_ = new_capacity;
                     size_ += count;
 
-                    return position;
+                    return;
+                }
+
+                auto pos = begin() + idx;
+                auto old_end = end();
+                auto tail = size_ - idx;
+
+                if (count <= tail)
+                {
+                    // The last count elements move to the uninitialized part.
+                    for (size_type i = 0; i < count; ++i)
+                    {
+                        allocator_traits<Allocator>::construct(
+                            allocator_, old_end + i, move(*(old_end - count + i))
+                        );
+                    }
+
+                    move_backward(pos, old_end - count, old_end);
+                    copy_n(first, count, pos);
                 }
                 else
                 {
-                    auto start_idx = static_cast<size_type>(position - begin());
-                    auto end_idx = start_idx + count;
-                    auto new_size = size_ + count;
+                    // The range extends past the old end.
+                    auto mid = first;
+                    advance(mid, tail);
 
-                    // Auxiliary vector for easier swap.
-                    vector tmp{};
-                    tmp.resize_without_copy_(max(new_size, capacity_));
-                    tmp.size_ = new_size;
+                    auto it = old_end;
+                    for (size_type i = tail; i < count; ++i, ++mid)
+                        allocator_traits<Allocator>::construct(allocator_, it++, *mid);
+                    for (size_type i = 0; i < tail; ++i)
+                        allocator_traits<Allocator>::construct(allocator_, it++, move(pos[i]));
 
-                    // Copy before insertion index.
-                    copy(begin(), begin() + start_idx, tmp.begin());
+                    copy_n(first, tail, pos);
+                }
 
-                    // Copy after insertion index.
-                    copy(begin() + start_idx, end(), tmp.begin() + end_idx);
+                size_ += count;
+            }
 
-                    swap(tmp);
+            /**
+             * Moves the elements appended at index tail
+             * and above to the index idx.
+             */
+            iterator rotate_tail_(size_type idx, size_type tail)
+            {
+                rotate(begin() + idx, begin() + tail, end());
 
-                    // Position was invalidated!
-                    return begin() + start_idx;
-                }
+                return begin() + idx;
             }
     };
 
@@ -612,14 +780,13 @@ namespace std
         auto min_size = min(lhs.size(), rhs.size());
         for (decltype(lhs.size()) i = 0; i < min_size; ++i)
         {
-            if (lhs[i] >= rhs[i])
+            if (lhs[i] < rhs[i])
+                return true;
+            if (rhs[i] < lhs[i])
                 return false;
         }
 
-        if (lhs.size() == rhs.size())
-            return true;
-        else
-            return lhs.size() < rhs.size();
+        return lhs.size() < rhs.size();
     }
 
     template<class T, class Alloc>
@@ -661,6 +828,15 @@ namespace std
      */
 
     // TODO: implement
+
+    namespace pmr
+    {
+        template<class T>
+        class polymorphic_allocator;
+
+        template<class T>
+        using vector = std::vector<T, polymorphic_allocator<T>>;
+    }
 }
 
 #endif
@@ -29,6 +29,7 @@
 #ifndef LIBCPP_BITS_ALGORITHM
 #define LIBCPP_BITS_ALGORITHM
 
+#include <__bits/memory/misc.hpp>
 #include <iterator>
 #include <utility>
 
@@ -37,6 +38,9 @@ namespace std
     template<class T>
     struct less;
 
+    template<class T>
+    struct equal_to;
+
     /**
      * 25.2, non-modyfing sequence operations:
      */
@@ -408,9 +412,10 @@ namespace std
     BidirectionalIterator2 move_backward(BidirectionalIterator1 first, BidirectionalIterator1 last,
                                          BidirectionalIterator2 result)
     {
-        // Note: We're copying [first, last) so we need to skip the initial value of last.
-        while (last-- != first)
-            *result-- = move(*last);
+        while (last != first)
+            *--result = move(*--last);
+
+        return result;
     }
 
     /**
@@ -622,7 +627,32 @@ namespace std
      * 25.3.9, unique:
      */
 
-    // TODO: implement
+    template<class ForwardIterator, class BinaryPredicate>
+    ForwardIterator unique(ForwardIterator first, ForwardIterator last,
+                           BinaryPredicate pred)
+    {
+        if (first == last)
+            return last;
+
+        auto result = first;
+        while (++first != last)
+        {
+            if (!pred(*result, *first) && ++result != first)
+                *result = move(*first);
+        }
+
+        return ++result;
+    }
+
+    template<class ForwardIterator>
+    ForwardIterator unique(ForwardIterator first, ForwardIterator last)
+    {
+        using value_type = typename iterator_traits<ForwardIterator>::value_type;
+
+        return unique(first, last, equal_to<value_type>{});
+    }
+
+    // TODO: implement unique_copy
 
     /**
      * 25.3.10, reverse:
@@ -653,7 +683,43 @@ namespace std
      * 25.3.11, rotate:
      */
 
-    // TODO: implement
+    template<class ForwardIterator>
+    ForwardIterator rotate(ForwardIterator first, ForwardIterator middle,
+                           ForwardIterator last)
+    {
+        if (first == middle)
+            return last;
+        if (middle == last)
+            return first;
+
+        /**
+         * Swap the second part into place one element at a time,
+         * whatever remains of the first part then gets rotated
+         * the same way until nothing is left.
+         */
+        auto next = middle;
+        do
+        {
+            iter_swap(first++, next++);
+            if (first == middle)
+                middle = next;
+        } while (next != last);
+
+        auto res = first;
+        next = middle;
+        while (next != last)
+        {
+            iter_swap(first++, next++);
+            if (first == middle)
+                middle = next;
+            else if (next == last)
+                next = middle;
+        }
+
+        return res;
+    }
+
+    // TODO: implement rotate_copy
 
     /**
      * 25.3.12, shuffle:
@@ -687,6 +753,226 @@ namespace std
     void sort_heap(RandomAccessIterator, RandomAccessIterator,
                    Compare);
 
+    namespace aux
+    {
+        /**
+         * Ranges shorter than this are left for insertion sort,
+         * which beats partitioning and merging on small inputs.
+         */
+        inline constexpr ptrdiff_t insertion_sort_threshold{16};
+
+        template<class T>
+        T heap_parent(T idx)
+        {
+            return (idx - 1) / 2;
+        }
+
+        template<class T>
+        T heap_left_child(T idx)
+        {
+            return 2 * idx + 1;
+        }
+
+        template<class T>
+        T heap_right_child(T idx)
+        {
+            return 2 * idx + 2;
+        }
+
+        /**
+         * Places value into the hole at idx and moves it down
+         * the heap of count elements until both of its children
+         * are not greater than it.
+         */
+        template<class RandomAccessIterator, class Size, class T, class Compare>
+        void sift_down(RandomAccessIterator first, Size idx, Size count,
+                       T value, Compare comp)
+        {
+            auto child = heap_left_child(idx);
+            while (child < count)
+            {
+                if (child + 1 < count && comp(first[child], first[child + 1]))
+                    ++child;
+
+                if (!comp(value, first[child]))
+                    break;
+
+                first[idx] = move(first[child]);
+                idx = child;
+                child = heap_left_child(idx);
+            }
+
+            first[idx] = move(value);
+        }
+
+        template<class RandomAccessIterator, class Compare>
+        void insertion_sort(RandomAccessIterator first,
+                            RandomAccessIterator last,
+                            Compare comp)
+        {
+            if (first == last)
+                return;
+
+            for (auto it = first + 1; it != last; ++it)
+            {
+                auto value = move(*it);
+
+                if (comp(value, *first))
+                {
+                    move_backward(first, it, it + 1);
+                    *first = move(value);
+
+                    continue;
+                }
+
+                /**
+                 * The first element is not greater than value,
+                 * so it stops the scan without a bounds check.
+                 */
+                auto hole = it;
+                while (comp(value, *(hole - 1)))
+                {
+                    *hole = move(*(hole - 1));
+                    --hole;
+                }
+                *hole = move(value);
+            }
+        }
+
+        template<class RandomAccessIterator, class Compare>
+        void move_median_to_first(RandomAccessIterator res,
+                                  RandomAccessIterator a,
+                                  RandomAccessIterator b,
+                                  RandomAccessIterator c,
+                                  Compare comp)
+        {
+            if (comp(*a, *b))
+            {
+                if (comp(*b, *c))
+                    iter_swap(res, b);
+                else if (comp(*a, *c))
+                    iter_swap(res, c);
+                else
+                    iter_swap(res, a);
+            }
+            else if (comp(*a, *c))
+                iter_swap(res, a);
+            else if (comp(*b, *c))
+                iter_swap(res, c);
+            else
+                iter_swap(res, b);
+        }
+
+        /**
+         * Hoare partition of [first, last) around *pivot, the
+         * median of three selection guarantees that both scans
+         * stop before leaving the range.
+         */
+        template<class RandomAccessIterator, class Compare>
+        RandomAccessIterator unguarded_partition(RandomAccessIterator first,
+                                                 RandomAccessIterator last,
+                                                 RandomAccessIterator pivot,
+                                                 Compare comp)
+        {
+            while (true)
+            {
+                while (comp(*first, *pivot))
+                    ++first;
+
+                --last;
+                while (comp(*pivot, *last))
+                    --last;
+
+                if (!(first < last))
+                    return first;
+
+                iter_swap(first, last);
+                ++first;
+            }
+        }
+
+        /**
+         * Requires at least three elements, returns the partition
+         * point such that no element before it is greater and no
+         * element after it is smaller than the chosen pivot.
+         */
+        template<class RandomAccessIterator, class Compare>
+        RandomAccessIterator partition_pivot(RandomAccessIterator first,
+                                             RandomAccessIterator last,
+                                             Compare comp)
+        {
+            auto mid = first + (last - first) / 2;
+            move_median_to_first(first, first + 1, mid, last - 1, comp);
+
+            return unguarded_partition(first + 1, last, first, comp);
+        }
+
+        /**
+         * Returns the recursion depth allowed to introsort and
+         * introselect before they switch to heap based methods,
+         * which is 2 * floor(log2(count)).
+         */
+        template<class Size>
+        Size introsort_depth(Size count)
+        {
+            Size res{};
+            while (count > 1)
+            {
+                count /= 2;
+                ++res;
+            }
+
+            return 2 * res;
+        }
+
+        template<class RandomAccessIterator, class Compare>
+        void heap_select(RandomAccessIterator first,
+                         RandomAccessIterator middle,
+                         RandomAccessIterator last,
+                         Compare comp)
+        {
+            make_heap(first, middle, comp);
+
+            auto count = middle - first;
+            for (auto it = middle; it < last; ++it)
+            {
+                if (comp(*it, *first))
+                {
+                    auto value = move(*it);
+                    *it = move(*first);
+                    sift_down(first, decltype(count){}, count, move(value), comp);
+                }
+            }
+        }
+
+        template<class RandomAccessIterator, class Size, class Compare>
+        void introsort_loop(RandomAccessIterator first,
+                            RandomAccessIterator last,
+                            Size depth, Compare comp)
+        {
+            while (last - first > insertion_sort_threshold)
+            {
+                if (depth == 0)
+                {
+                    /**
+                     * Partitioning keeps degenerating, finish
+                     * this range with heap sort to stay within
+                     * O(n log n).
+                     */
+                    make_heap(first, last, comp);
+                    sort_heap(first, last, comp);
+
+                    return;
+                }
+                --depth;
+
+                auto cut = partition_pivot(first, last, comp);
+                introsort_loop(cut, last, depth, comp);
+                last = cut;
+            }
+        }
+    }
+
     template<class RandomAccessIterator>
     void sort(RandomAccessIterator first, RandomAccessIterator last)
     {
@@ -700,89 +986,333 @@ namespace std
               Compare comp)
     {
         /**
-         * Note: This isn't the most effective approach,
-         *       but since we already have these two functions
-         *       and they satisfy asymptotic limitations
-         *       imposed by the standard, we're using them at
-         *       the moment. Might be good to change it to qsort
-         *       or merge sort later.
+         * Introsort: quicksort with median of three pivots that
+         * falls back to heap sort when the recursion gets too
+         * deep, the short unsorted runs it leaves behind are
+         * finished by a single pass of insertion sort.
          */
+        auto count = last - first;
+        if (count < 2)
+            return;
 
-        make_heap(first, last, comp);
-        sort_heap(first, last, comp);
+        aux::introsort_loop(first, last, aux::introsort_depth(count), comp);
+        aux::insertion_sort(first, last, comp);
     }
 
     /**
      * 25.4.1.2, stable_sort:
      */
 
-    // TODO: implement
+    template<class ForwardIterator, class T, class Compare>
+    ForwardIterator lower_bound(ForwardIterator, ForwardIterator,
+                                const T&, Compare);
+
+    template<class ForwardIterator, class T, class Compare>
+    ForwardIterator upper_bound(ForwardIterator, ForwardIterator,
+                                const T&, Compare);
+
+    namespace aux
+    {
+        template<class BidirectionalIterator, class Distance, class Compare>
+        void merge_without_buffer(BidirectionalIterator first,
+                                  BidirectionalIterator middle,
+                                  BidirectionalIterator last,
+                                  Distance len1, Distance len2,
+                                  Compare comp)
+        {
+            if (len1 == 0 || len2 == 0)
+                return;
+
+            if (len1 + len2 == 2)
+            {
+                if (comp(*middle, *first))
+                    iter_swap(first, middle);
+
+                return;
+            }
+
+            auto cut1 = first;
+            auto cut2 = middle;
+            Distance len11{};
+            Distance len22{};
+            if (len1 > len2)
+            {
+                len11 = len1 / 2;
+                advance(cut1, len11);
+                cut2 = lower_bound(middle, last, *cut1, comp);
+                len22 = distance(middle, cut2);
+            }
+            else
+            {
+                len22 = len2 / 2;
+                advance(cut2, len22);
+                cut1 = upper_bound(first, middle, *cut2, comp);
+                len11 = distance(first, cut1);
+            }
+
+            auto new_middle = rotate(cut1, middle, cut2);
+            merge_without_buffer(first, cut1, new_middle,
+                                 len11, len22, comp);
+            merge_without_buffer(new_middle, cut2, last,
+                                 len1 - len11, len2 - len22, comp);
+        }
+
+        /**
+         * Moves the first run into uninitialized storage at buf
+         * and merges it back with the second one, ties are taken
+         * from the first run to keep the merge stable.
+         */
+        template<class RandomAccessIterator, class T, class Compare>
+        void merge_with_buffer(RandomAccessIterator first,
+                               RandomAccessIterator middle,
+                               RandomAccessIterator last,
+                               T* buf, Compare comp)
+        {
+            T* buf_end{buf};
+            for (auto it = first; it != middle; ++it, ++buf_end)
+                ::new(static_cast<void*>(buf_end)) T(move(*it));
+
+            auto out = first;
+            T* left{buf};
+            auto right = middle;
+            while (left != buf_end && right != last)
+            {
+                if (comp(*right, *left))
+                    *out++ = move(*right++);
+                else
+                    *out++ = move(*left++);
+            }
+
+            while (left != buf_end)
+                *out++ = move(*left++);
+
+            for (T* it = buf; it != buf_end; ++it)
+                it->~T();
+        }
+
+        template<class RandomAccessIterator, class T, class Compare>
+        void merge_sort(RandomAccessIterator first,
+                        RandomAccessIterator last,
+                        T* buf, ptrdiff_t buf_size,
+                        Compare comp)
+        {
+            auto count = last - first;
+            if (count <= insertion_sort_threshold)
+            {
+                insertion_sort(first, last, comp);
+
+                return;
+            }
+
+            auto middle = first + count / 2;
+            merge_sort(first, middle, buf, buf_size, comp);
+            merge_sort(middle, last, buf, buf_size, comp);
+
+            // Runs that are already in order need no merging.
+            if (!comp(*middle, *(middle - 1)))
+                return;
+
+            if (middle - first <= buf_size)
+                merge_with_buffer(first, middle, last, buf, comp);
+            else
+                merge_without_buffer(first, middle, last,
+                                     middle - first, last - middle, comp);
+        }
+    }
+
+    template<class RandomAccessIterator>
+    void stable_sort(RandomAccessIterator first, RandomAccessIterator last)
+    {
+        using value_type = typename iterator_traits<RandomAccessIterator>::value_type;
+
+        stable_sort(first, last, less<value_type>{});
+    }
+
+    template<class RandomAccessIterator, class Compare>
+    void stable_sort(RandomAccessIterator first, RandomAccessIterator last,
+                     Compare comp)
+    {
+        using value_type = typename iterator_traits<RandomAccessIterator>::value_type;
+
+        auto count = last - first;
+        if (count < 2)
+            return;
+
+        /**
+         * Merges only ever need to hold the left run, so half
+         * of the range is enough. If we get less (or nothing)
+         * the merges that do not fit are done in place with
+         * rotations, which is slower but needs no memory.
+         */
+        auto buf = get_temporary_buffer<value_type>((count + 1) / 2);
+        aux::merge_sort(first, last, buf.first, buf.second, comp);
+        return_temporary_buffer(buf.first);
+    }
 
     /**
      * 25.4.1.3, partial_sort:
      */
 
-    // TODO: implement
+    template<class RandomAccessIterator>
+    void partial_sort(RandomAccessIterator first,
+                      RandomAccessIterator middle,
+                      RandomAccessIterator last)
+    {
+        using value_type = typename iterator_traits<RandomAccessIterator>::value_type;
 
-    /**
-     * 25.4.1.4, partial_sort_copy:
-     */
+        partial_sort(first, middle, last, less<value_type>{});
+    }
 
-    // TODO: implement
+    template<class RandomAccessIterator, class Compare>
+    void partial_sort(RandomAccessIterator first,
+                      RandomAccessIterator middle,
+                      RandomAccessIterator last,
+                      Compare comp)
+    {
+        /**
+         * Keep the smallest elements seen so far in a max heap
+         * of size middle - first, so that the rest of the range
+         * is only compared against its top.
+         */
+        aux::heap_select(first, middle, last, comp);
+        sort_heap(first, middle, comp);
+    }
 
     /**
-     * 25.4.1.5, is_sorted:
+     * 25.4.1.4, partial_sort_copy:
      */
 
-    template<class ForwardIterator>
-    bool is_sorted(ForwardIterator first, ForwardIterator last)
+    template<class InputIterator, class RandomAccessIterator>
+    RandomAccessIterator partial_sort_copy(InputIterator first,
+                                           InputIterator last,
+                                           RandomAccessIterator result_first,
+                                           RandomAccessIterator result_last)
     {
-        return is_sorted_until(first, last) == last;
-    }
+        using value_type = typename iterator_traits<RandomAccessIterator>::value_type;
 
-    template<class ForwardIterator, class Comp>
-    bool is_sorted(ForwardIterator first, ForwardIterator last,
-                   Comp comp)
-    {
-        return is_sorted_until(first, last, comp) == last;
+        return partial_sort_copy(first, last, result_first, result_last,
+                                 less<value_type>{});
     }
 
-    template<class ForwardIterator>
-    ForwardIterator is_sorted_until(ForwardIterator first, ForwardIterator last)
+    template<class InputIterator, class RandomAccessIterator, class Compare>
+    RandomAccessIterator partial_sort_copy(InputIterator first,
+                                           InputIterator last,
+                                           RandomAccessIterator result_first,
+                                           RandomAccessIterator result_last,
+                                           Compare comp)
     {
-        if (distance(first, last) < 2)
-            return last;
+        auto result_end = result_first;
+        while (first != last && result_end != result_last)
+            *result_end++ = *first++;
+
+        make_heap(result_first, result_end, comp);
 
+        auto count = result_end - result_first;
         while (first != last)
         {
-            if (*first > *(++first))
-                return first;
+            if (count > 0 && comp(*first, *result_first))
+            {
+                aux::sift_down(result_first, decltype(count){}, count,
+                               typename iterator_traits<RandomAccessIterator>::value_type(*first),
+                               comp);
+            }
+            ++first;
         }
 
-        return last;
+        sort_heap(result_first, result_end, comp);
+
+        return result_end;
+    }
+
+    /**
+     * 25.4.1.5, is_sorted:
+     */
+
+    template<class ForwardIterator>
+    ForwardIterator is_sorted_until(ForwardIterator first, ForwardIterator last)
+    {
+        using value_type = typename iterator_traits<ForwardIterator>::value_type;
+
+        return is_sorted_until(first, last, less<value_type>{});
     }
 
     template<class ForwardIterator, class Comp>
     ForwardIterator is_sorted_until(ForwardIterator first, ForwardIterator last,
                                     Comp comp)
     {
-        if (distance(first, last) < 2)
+        if (first == last)
             return last;
 
-        while (first != last)
+        auto next = first;
+        while (++next != last)
         {
-            if (!comp(*first, *(++first)))
-                return first;
+            if (comp(*next, *first))
+                return next;
+            ++first;
         }
 
         return last;
     }
 
+    template<class ForwardIterator>
+    bool is_sorted(ForwardIterator first, ForwardIterator last)
+    {
+        return is_sorted_until(first, last) == last;
+    }
+
+    template<class ForwardIterator, class Comp>
+    bool is_sorted(ForwardIterator first, ForwardIterator last,
+                   Comp comp)
+    {
+        return is_sorted_until(first, last, comp) == last;
+    }
+
     /**
      * 25.4.2, nth_element:
      */
 
-    // TODO: implement
+    template<class RandomAccessIterator>
+    void nth_element(RandomAccessIterator first, RandomAccessIterator nth,
+                     RandomAccessIterator last)
+    {
+        using value_type = typename iterator_traits<RandomAccessIterator>::value_type;
+
+        nth_element(first, nth, last, less<value_type>{});
+    }
+
+    template<class RandomAccessIterator, class Compare>
+    void nth_element(RandomAccessIterator first, RandomAccessIterator nth,
+                     RandomAccessIterator last, Compare comp)
+    {
+        if (first == last || nth == last)
+            return;
+
+        /**
+         * Introselect: partition like sort does, but only descend
+         * into the part that contains nth. If that degenerates,
+         * heap select the prefix up to nth instead.
+         */
+        auto depth = aux::introsort_depth(last - first);
+        while (last - first > 3)
+        {
+            if (depth == 0)
+            {
+                aux::heap_select(first, nth + 1, last, comp);
+                iter_swap(first, nth);
+
+                return;
+            }
+            --depth;
+
+            auto cut = aux::partition_pivot(first, last, comp);
+            if (cut <= nth)
+                first = cut;
+            else
+                last = cut;
+        }
+
+        aux::insertion_sort(first, last, comp);
+    }
 
     /**
      * 25.4.3, binary search:
@@ -792,13 +1322,69 @@ namespace std
      * 25.4.3.1, lower_bound
      */
 
-    // TODO: implement
+    template<class ForwardIterator, class T>
+    ForwardIterator lower_bound(ForwardIterator first, ForwardIterator last,
+                                const T& value)
+    {
+        return lower_bound(first, last, value, less<T>{});
+    }
+
+    template<class ForwardIterator, class T, class Compare>
+    ForwardIterator lower_bound(ForwardIterator first, ForwardIterator last,
+                                const T& value, Compare comp)
+    {
+        auto count = distance(first, last);
+        while (count > 0)
+        {
+            auto step = count / 2;
+            auto it = first;
+            advance(it, step);
+
+            if (comp(*it, value))
+            {
+                first = ++it;
+                count -= step + 1;
+            }
+            else
+                count = step;
+        }
+
+        return first;
+    }
 
     /**
      * 25.4.3.2, upper_bound
      */
 
-    // TODO: implement
+    template<class ForwardIterator, class T>
+    ForwardIterator upper_bound(ForwardIterator first, ForwardIterator last,
+                                const T& value)
+    {
+        return upper_bound(first, last, value, less<T>{});
+    }
+
+    template<class ForwardIterator, class T, class Compare>
+    ForwardIterator upper_bound(ForwardIterator first, ForwardIterator last,
+                                const T& value, Compare comp)
+    {
+        auto count = distance(first, last);
+        while (count > 0)
+        {
+            auto step = count / 2;
+            auto it = first;
+            advance(it, step);
+
+            if (!comp(value, *it))
+            {
+                first = ++it;
+                count -= step + 1;
+            }
+            else
+                count = step;
+        }
+
+        return first;
+    }
 
     /**
      * 25.4.3.3, equal_range:
@@ -856,63 +1442,6 @@ namespace std
      * 25.4.6, heap operations:
      */
 
-    namespace aux
-    {
-        template<class T>
-        T heap_parent(T idx)
-        {
-            return (idx - 1) / 2;
-        }
-
-        template<class T>
-        T heap_left_child(T idx)
-        {
-            return 2 * idx + 1;
-        }
-
-        template<class T>
-        T heap_right_child(T idx)
-        {
-            return 2 * idx + 2;
-        }
-
-        template<class RandomAccessIterator, class Size, class Compare>
-        void correct_children(RandomAccessIterator first,
-                              Size idx, Size count, Compare comp)
-        {
-            using aux::heap_left_child;
-            using aux::heap_right_child;
-
-            auto left = heap_left_child(idx);
-            auto right = heap_right_child(idx);
-
-            bool left_incorrect{comp(first[idx], first[left])};
-            bool right_incorrect{comp(first[idx], first[right])};
-            while ((left < count && left_incorrect) ||
-                   (right < count && right_incorrect))
-            {
-                if (right >= count || (left_incorrect && comp(first[right], first[left])))
-                {
-                    swap(first[idx], first[left]);
-
-                    idx = left;
-                }
-                else if (right < count && right_incorrect)
-                {
-                    swap(first[idx], first[right]);
-
-                    idx = right;
-                } // Else should not happen because of the while condition.
-
-                left = heap_left_child(idx);
-                right = heap_right_child(idx);
-
-                left_incorrect = comp(first[idx], first[left]);
-                right_incorrect = comp(first[idx], first[right]);
-            }
-        }
-    }
-
     /**
      * 25.4.6.1, push_heap:
      */
@@ -970,8 +1499,13 @@ namespace std
         if (count <= 1)
             return;
 
-        swap(first[0], first[count - 1]);
-        aux::correct_children(first, decltype(count){}, count - 2, comp);
+        /**
+         * The last element is moved into the hole left at the top
+         * and the former top takes its place.
+         */
+        auto value = move(first[count - 1]);
+        first[count - 1] = move(first[0]);
+        aux::sift_down(first, decltype(count){}, count - 1, move(value), comp);
     }
 
     /**
@@ -996,11 +1530,12 @@ namespace std
         if (count <= 1)
             return;
 
-        for (auto i = count; i > 0; --i)
+        // Leaves are heaps already, start at the last parent.
+        for (auto i = count / 2; i > 0; --i)
         {
             auto idx = i - 1;
 
-            aux::correct_children(first, idx, count, comp);
+            aux::sift_down(first, idx, count, move(first[idx]), comp);
         }
     }
 
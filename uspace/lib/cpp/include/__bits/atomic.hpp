@@ -29,6 +29,916 @@
 #ifndef LIBCPP_BITS_ATOMIC
 #define LIBCPP_BITS_ATOMIC
 
-#error "<atomic> is not implemented"
+#include <cstddef>
+#include <cstdint>
+
+#define ATOMIC_BOOL_LOCK_FREE     __GCC_ATOMIC_BOOL_LOCK_FREE
+#define ATOMIC_CHAR_LOCK_FREE     __GCC_ATOMIC_CHAR_LOCK_FREE
+#define ATOMIC_CHAR16_T_LOCK_FREE __GCC_ATOMIC_CHAR16_T_LOCK_FREE
+#define ATOMIC_CHAR32_T_LOCK_FREE __GCC_ATOMIC_CHAR32_T_LOCK_FREE
+#define ATOMIC_WCHAR_T_LOCK_FREE  __GCC_ATOMIC_WCHAR_T_LOCK_FREE
+#define ATOMIC_SHORT_LOCK_FREE    __GCC_ATOMIC_SHORT_LOCK_FREE
+#define ATOMIC_INT_LOCK_FREE      __GCC_ATOMIC_INT_LOCK_FREE
+#define ATOMIC_LONG_LOCK_FREE     __GCC_ATOMIC_LONG_LOCK_FREE
+#define ATOMIC_LLONG_LOCK_FREE    __GCC_ATOMIC_LLONG_LOCK_FREE
+#define ATOMIC_POINTER_LOCK_FREE  __GCC_ATOMIC_POINTER_LOCK_FREE
+
+#define ATOMIC_VAR_INIT(value) {value}
+#define ATOMIC_FLAG_INIT {false}
+
+namespace std
+{
+    /**
+     * 32.4, order and consistency:
+     */
+
+    typedef enum memory_order
+    {
+        memory_order_relaxed = __ATOMIC_RELAXED,
+        memory_order_consume = __ATOMIC_CONSUME,
+        memory_order_acquire = __ATOMIC_ACQUIRE,
+        memory_order_release = __ATOMIC_RELEASE,
+        memory_order_acq_rel = __ATOMIC_ACQ_REL,
+        memory_order_seq_cst = __ATOMIC_SEQ_CST
+    } memory_order;
+
+    template<class T>
+    T kill_dependency(T y) noexcept
+    {
+        return y;
+    }
+}
+
+namespace std::aux
+{
+    /**
+     * The strongest failure order allowed for a given
+     * success order of a compare-exchange operation.
+     */
+    constexpr memory_order cmpxchg_failure_order(memory_order order) noexcept
+    {
+        if (order == memory_order_acq_rel)
+            return memory_order_acquire;
+        else if (order == memory_order_release)
+            return memory_order_relaxed;
+        else
+            return order;
+    }
+
+    /**
+     * Objects whose size is a power of two are aligned to
+     * their size so that the processor can access them atomically.
+     */
+    template<class T>
+    constexpr size_t atomic_alignment()
+    {
+        constexpr size_t size = sizeof(T);
+
+        if ((size & (size - 1)) == 0 && size <= 16 && size > alignof(T))
+            return size;
+        else
+            return alignof(T);
+    }
+
+    /**
+     * Types that the processor cannot access atomically
+     * are protected by a spinlock picked from a table
+     * based on the address of the object.
+     */
+    void atomic_lock(const volatile void*) noexcept;
+    void atomic_unlock(const volatile void*) noexcept;
+
+    class atomic_guard
+    {
+        public:
+            atomic_guard(const volatile void* obj) noexcept
+                : obj_{obj}
+            {
+                atomic_lock(obj_);
+            }
+
+            ~atomic_guard()
+            {
+                atomic_unlock(obj_);
+            }
+
+            atomic_guard(const atomic_guard&) = delete;
+            atomic_guard& operator=(const atomic_guard&) = delete;
+
+        private:
+            const volatile void* obj_;
+    };
+
+    /**
+     * Waiting fibrils are parked on a condition variable picked
+     * from a table based on the address of the object they wait
+     * on. The predicate tells if the object still holds the old
+     * value and is reevaluated under the lock of the table entry,
+     * so that a notification cannot be missed.
+     */
+    using atomic_wait_pred_t = bool (*)(const volatile void*, const void*,
+                                        memory_order);
+
+    void atomic_wait(const volatile void*, const void*, memory_order,
+                     atomic_wait_pred_t) noexcept;
+    void atomic_notify(const volatile void*) noexcept;
+
+    /**
+     * Number of times a waiter polls the object before
+     * it goes to sleep.
+     */
+    inline constexpr int atomic_wait_spin = 16;
+
+    template<class T>
+    class atomic_base
+    {
+        public:
+            static constexpr bool is_always_lock_free =
+                __atomic_always_lock_free(sizeof(T), 0) &&
+                atomic_alignment<T>() >= sizeof(T);
+
+            bool is_lock_free() const volatile noexcept
+            {
+                return is_always_lock_free;
+            }
+
+            void store(T desired, memory_order order = memory_order_seq_cst) volatile noexcept
+            {
+                if constexpr (is_always_lock_free)
+                    __atomic_store(&value_, &desired, order);
+                else
+                {
+                    atomic_guard guard{&value_};
+                    __builtin_memcpy(ptr_(), &desired, sizeof(T));
+                }
+            }
+
+            T load(memory_order order = memory_order_seq_cst) const volatile noexcept
+            {
+                alignas(T) unsigned char buf[sizeof(T)];
+                T* res = reinterpret_cast<T*>(buf);
+
+                if constexpr (is_always_lock_free)
+                    __atomic_load(&value_, res, order);
+                else
+                {
+                    atomic_guard guard{&value_};
+                    __builtin_memcpy(res, ptr_(), sizeof(T));
+                }
+
+                return *res;
+            }
+
+            operator T() const volatile noexcept
+            {
+                return load();
+            }
+
+            T exchange(T desired, memory_order order = memory_order_seq_cst) volatile noexcept
+            {
+                alignas(T) unsigned char buf[sizeof(T)];
+                T* res = reinterpret_cast<T*>(buf);
+
+                if constexpr (is_always_lock_free)
+                    __atomic_exchange(&value_, &desired, res, order);
+                else
+                {
+                    atomic_guard guard{&value_};
+                    __builtin_memcpy(res, ptr_(), sizeof(T));
+                    __builtin_memcpy(ptr_(), &desired, sizeof(T));
+                }
+
+                return *res;
+            }
+
+            bool compare_exchange_weak(T& expected, T desired,
+                                       memory_order success,
+                                       memory_order failure) volatile noexcept
+            {
+                return cmpxchg_(expected, desired, true, success, failure);
+            }
+
+            bool compare_exchange_strong(T& expected, T desired,
+                                         memory_order success,
+                                         memory_order failure) volatile noexcept
+            {
+                return cmpxchg_(expected, desired, false, success, failure);
+            }
+
+            bool compare_exchange_weak(T& expected, T desired,
+                                       memory_order order = memory_order_seq_cst) volatile noexcept
+            {
+                return cmpxchg_(expected, desired, true, order,
+                                cmpxchg_failure_order(order));
+            }
+
+            bool compare_exchange_strong(T& expected, T desired,
+                                         memory_order order = memory_order_seq_cst) volatile noexcept
+            {
+                return cmpxchg_(expected, desired, false, order,
+                                cmpxchg_failure_order(order));
+            }
+
+            void wait(T old, memory_order order = memory_order_seq_cst) const volatile noexcept
+            {
+                for (int i = 0; i < atomic_wait_spin; ++i)
+                {
+                    if (!same_value_(&value_, &old, order))
+                        return;
+                }
+
+                atomic_wait(&value_, &old, order, &atomic_base::same_value_);
+            }
+
+            void notify_one() volatile noexcept
+            {
+                atomic_notify(&value_);
+            }
+
+            void notify_all() volatile noexcept
+            {
+                atomic_notify(&value_);
+            }
+
+            atomic_base() noexcept = default;
+
+            constexpr atomic_base(T desired) noexcept
+                : value_{desired}
+            { /* DUMMY BODY */ }
+
+            atomic_base(const atomic_base&) = delete;
+            atomic_base& operator=(const atomic_base&) = delete;
+            atomic_base& operator=(const atomic_base&) volatile = delete;
+
+        protected:
+            alignas(atomic_alignment<T>()) T value_;
+
+            T* ptr_() const volatile noexcept
+            {
+                return const_cast<T*>(&value_);
+            }
+
+            /**
+             * Used for read-modify-write operations
+             * on types that are not lock free.
+             */
+            template<class F>
+            T fetch_modify_(F f) volatile noexcept
+            {
+                atomic_guard guard{&value_};
+                T old = *ptr_();
+                *ptr_() = f(old);
+
+                return old;
+            }
+
+        private:
+            bool cmpxchg_(T& expected, T desired, bool weak,
+                          memory_order success,
+                          memory_order failure) volatile noexcept
+            {
+                if constexpr (is_always_lock_free)
+                {
+                    return __atomic_compare_exchange(
+                        &value_, &expected, &desired, weak, success, failure
+                    );
+                }
+                else
+                {
+                    atomic_guard guard{&value_};
+                    if (__builtin_memcmp(ptr_(), &expected, sizeof(T)) == 0)
+                    {
+                        __builtin_memcpy(ptr_(), &desired, sizeof(T));
+
+                        return true;
+                    }
+                    else
+                    {
+                        __builtin_memcpy(&expected, ptr_(), sizeof(T));
+
+                        return false;
+                    }
+                }
+            }
+
+            static bool same_value_(const volatile void* obj, const void* old,
+                                    memory_order order) noexcept
+            {
+                auto base = reinterpret_cast<const volatile atomic_base*>(
+                    reinterpret_cast<const volatile unsigned char*>(obj) -
+                    offsetof(atomic_base, value_)
+                );
+                T val = base->load(order);
+
+                return __builtin_memcmp(&val, old, sizeof(T)) == 0;
+            }
+    };
+
+    template<class T>
+    class atomic_integral: public atomic_base<T>
+    {
+        using base = atomic_base<T>;
+
+        public:
+            using base::base;
+            using base::operator T;
+
+            T fetch_add(T arg, memory_order order = memory_order_seq_cst) volatile noexcept
+            {
+                if constexpr (base::is_always_lock_free)
+                    return __atomic_fetch_add(&this->value_, arg, order);
+                else
+                    return this->fetch_modify_([arg](T v){ return static_cast<T>(v + arg); });
+            }
+
+            T fetch_sub(T arg, memory_order order = memory_order_seq_cst) volatile noexcept
+            {
+                if constexpr (base::is_always_lock_free)
+                    return __atomic_fetch_sub(&this->value_, arg, order);
+                else
+                    return this->fetch_modify_([arg](T v){ return static_cast<T>(v - arg); });
+            }
+
+            T fetch_and(T arg, memory_order order = memory_order_seq_cst) volatile noexcept
+            {
+                if constexpr (base::is_always_lock_free)
+                    return __atomic_fetch_and(&this->value_, arg, order);
+                else
+                    return this->fetch_modify_([arg](T v){ return static_cast<T>(v & arg); });
+            }
+
+            T fetch_or(T arg, memory_order order = memory_order_seq_cst) volatile noexcept
+            {
+                if constexpr (base::is_always_lock_free)
+                    return __atomic_fetch_or(&this->value_, arg, order);
+                else
+                    return this->fetch_modify_([arg](T v){ return static_cast<T>(v | arg); });
+            }
+
+            T fetch_xor(T arg, memory_order order = memory_order_seq_cst) volatile noexcept
+            {
+                if constexpr (base::is_always_lock_free)
+                    return __atomic_fetch_xor(&this->value_, arg, order);
+                else
+                    return this->fetch_modify_([arg](T v){ return static_cast<T>(v ^ arg); });
+            }
+
+            T operator++(int) volatile noexcept
+            {
+                return fetch_add(1);
+            }
+
+            T operator--(int) volatile noexcept
+            {
+                return fetch_sub(1);
+            }
+
+            T operator++() volatile noexcept
+            {
+                return static_cast<T>(fetch_add(1) + 1);
+            }
+
+            T operator--() volatile noexcept
+            {
+                return static_cast<T>(fetch_sub(1) - 1);
+            }
+
+            T operator+=(T arg) volatile noexcept
+            {
+                return static_cast<T>(fetch_add(arg) + arg);
+            }
+
+            T operator-=(T arg) volatile noexcept
+            {
+                return static_cast<T>(fetch_sub(arg) - arg);
+            }
+
+            T operator&=(T arg) volatile noexcept
+            {
+                return static_cast<T>(fetch_and(arg) & arg);
+            }
+
+            T operator|=(T arg) volatile noexcept
+            {
+                return static_cast<T>(fetch_or(arg) | arg);
+            }
+
+            T operator^=(T arg) volatile noexcept
+            {
+                return static_cast<T>(fetch_xor(arg) ^ arg);
+            }
+    };
+
+    /**
+     * Note: <type_traits> includes <memory> (through <utility>),
+     *       which uses atomics for reference counting, so we
+     *       cannot use the traits from there.
+     */
+    template<class T>
+    inline constexpr bool atomic_has_arithmetic = false;
+
+    template<>
+    inline constexpr bool atomic_has_arithmetic<char> = true;
+
+    template<>
+    inline constexpr bool atomic_has_arithmetic<signed char> = true;
+
+    template<>
+    inline constexpr bool atomic_has_arithmetic<unsigned char> = true;
+
+    template<>
+    inline constexpr bool atomic_has_arithmetic<short> = true;
+
+    template<>
+    inline constexpr bool atomic_has_arithmetic<unsigned short> = true;
+
+    template<>
+    inline constexpr bool atomic_has_arithmetic<int> = true;
+
+    template<>
+    inline constexpr bool atomic_has_arithmetic<unsigned int> = true;
+
+    template<>
+    inline constexpr bool atomic_has_arithmetic<long> = true;
+
+    template<>
+    inline constexpr bool atomic_has_arithmetic<unsigned long> = true;
+
+    template<>
+    inline constexpr bool atomic_has_arithmetic<long long> = true;
+
+    template<>
+    inline constexpr bool atomic_has_arithmetic<unsigned long long> = true;
+
+    template<>
+    inline constexpr bool atomic_has_arithmetic<char16_t> = true;
+
+    template<>
+    inline constexpr bool atomic_has_arithmetic<char32_t> = true;
+
+    template<>
+    inline constexpr bool atomic_has_arithmetic<wchar_t> = true;
+
+    template<bool, class T>
+    struct atomic_select
+    {
+        using type = atomic_base<T>;
+    };
+
+    template<class T>
+    struct atomic_select<true, T>
+    {
+        using type = atomic_integral<T>;
+    };
+
+    template<class T>
+    using atomic_base_t = typename atomic_select<atomic_has_arithmetic<T>, T>::type;
+}
+
+namespace std
+{
+    /**
+     * 32.6, class template atomic:
+     */
+
+    template<class T>
+    struct atomic: aux::atomic_base_t<T>
+    {
+        static_assert(__is_trivially_copyable(T), "atomic<T> requires a trivially copyable T");
+
+        using base = aux::atomic_base_t<T>;
+        using base::base;
+
+        atomic() noexcept = default;
+        atomic(const atomic&) = delete;
+        atomic& operator=(const atomic&) = delete;
+        atomic& operator=(const atomic&) volatile = delete;
+
+        T operator=(T desired) noexcept
+        {
+            this->store(desired);
+
+            return desired;
+        }
+
+        T operator=(T desired) volatile noexcept
+        {
+            this->store(desired);
+
+            return desired;
+        }
+    };
+
+    /**
+     * 32.6.4, partial specialization for pointers:
+     */
+
+    template<class T>
+    struct atomic<T*>: aux::atomic_base<T*>
+    {
+        using base = aux::atomic_base<T*>;
+        using base::base;
+        using base::operator T*;
+
+        atomic() noexcept = default;
+        atomic(const atomic&) = delete;
+        atomic& operator=(const atomic&) = delete;
+        atomic& operator=(const atomic&) volatile = delete;
+
+        T* operator=(T* desired) noexcept
+        {
+            this->store(desired);
+
+            return desired;
+        }
+
+        T* operator=(T* desired) volatile noexcept
+        {
+            this->store(desired);
+
+            return desired;
+        }
+
+        T* fetch_add(ptrdiff_t arg, memory_order order = memory_order_seq_cst) volatile noexcept
+        {
+            if constexpr (base::is_always_lock_free)
+            {
+                /**
+                 * Note: The builtin does not scale by the size
+                 *       of the pointed-to type.
+                 */
+                return __atomic_fetch_add(&this->value_, arg * sizeof(T), order);
+            }
+            else
+                return this->fetch_modify_([arg](T* v){ return v + arg; });
+        }
+
+        T* fetch_sub(ptrdiff_t arg, memory_order order = memory_order_seq_cst) volatile noexcept
+        {
+            if constexpr (base::is_always_lock_free)
+                return __atomic_fetch_sub(&this->value_, arg * sizeof(T), order);
+            else
+                return this->fetch_modify_([arg](T* v){ return v - arg; });
+        }
+
+        T* operator++(int) volatile noexcept
+        {
+            return fetch_add(1);
+        }
+
+        T* operator--(int) volatile noexcept
+        {
+            return fetch_sub(1);
+        }
+
+        T* operator++() volatile noexcept
+        {
+            return fetch_add(1) + 1;
+        }
+
+        T* operator--() volatile noexcept
+        {
+            return fetch_sub(1) - 1;
+        }
+
+        T* operator+=(ptrdiff_t arg) volatile noexcept
+        {
+            return fetch_add(arg) + arg;
+        }
+
+        T* operator-=(ptrdiff_t arg) volatile noexcept
+        {
+            return fetch_sub(arg) - arg;
+        }
+    };
+
+    /**
+     * 32.6.1, named typedefs:
+     */
+
+    using atomic_bool           = atomic<bool>;
+    using atomic_char           = atomic<char>;
+    using atomic_schar          = atomic<signed char>;
+    using atomic_uchar          = atomic<unsigned char>;
+    using atomic_short          = atomic<short>;
+    using atomic_ushort         = atomic<unsigned short>;
+    using atomic_int            = atomic<int>;
+    using atomic_uint           = atomic<unsigned int>;
+    using atomic_long           = atomic<long>;
+    using atomic_ulong          = atomic<unsigned long>;
+    using atomic_llong          = atomic<long long>;
+    using atomic_ullong         = atomic<unsigned long long>;
+    using atomic_char16_t       = atomic<char16_t>;
+    using atomic_char32_t       = atomic<char32_t>;
+    using atomic_wchar_t        = atomic<wchar_t>;
+
+    using atomic_int8_t         = atomic<int8_t>;
+    using atomic_uint8_t        = atomic<uint8_t>;
+    using atomic_int16_t        = atomic<int16_t>;
+    using atomic_uint16_t       = atomic<uint16_t>;
+    using atomic_int32_t        = atomic<int32_t>;
+    using atomic_uint32_t       = atomic<uint32_t>;
+    using atomic_int64_t        = atomic<int64_t>;
+    using atomic_uint64_t       = atomic<uint64_t>;
+
+    using atomic_int_least8_t   = atomic<int_least8_t>;
+    using atomic_uint_least8_t  = atomic<uint_least8_t>;
+    using atomic_int_least16_t  = atomic<int_least16_t>;
+    using atomic_uint_least16_t = atomic<uint_least16_t>;
+    using atomic_int_least32_t  = atomic<int_least32_t>;
+    using atomic_uint_least32_t = atomic<uint_least32_t>;
+    using atomic_int_least64_t  = atomic<int_least64_t>;
+    using atomic_uint_least64_t = atomic<uint_least64_t>;
+    using atomic_int_fast8_t    = atomic<int_fast8_t>;
+    using atomic_uint_fast8_t   = atomic<uint_fast8_t>;
+    using atomic_int_fast16_t   = atomic<int_fast16_t>;
+    using atomic_uint_fast16_t  = atomic<uint_fast16_t>;
+    using atomic_int_fast32_t   = atomic<int_fast32_t>;
+    using atomic_uint_fast32_t  = atomic<uint_fast32_t>;
+    using atomic_int_fast64_t   = atomic<int_fast64_t>;
+    using atomic_uint_fast64_t  = atomic<uint_fast64_t>;
+    using atomic_intptr_t       = atomic<intptr_t>;
+    using atomic_uintptr_t      = atomic<uintptr_t>;
+    using atomic_size_t         = atomic<size_t>;
+    using atomic_ptrdiff_t      = atomic<ptrdiff_t>;
+    using atomic_intmax_t       = atomic<intmax_t>;
+    using atomic_uintmax_t      = atomic<uintmax_t>;
+
+    /**
+     * 32.6.1, non-member functions:
+     */
+
+    template<class T>
+    bool atomic_is_lock_free(const volatile atomic<T>* obj) noexcept
+    {
+        return obj->is_lock_free();
+    }
+
+    template<class T>
+    void atomic_init(volatile atomic<T>* obj, T desired) noexcept
+    {
+        obj->store(desired, memory_order_relaxed);
+    }
+
+    template<class T>
+    void atomic_store(volatile atomic<T>* obj, T desired) noexcept
+    {
+        obj->store(desired);
+    }
+
+    template<class T>
+    void atomic_store_explicit(volatile atomic<T>* obj, T desired,
+                               memory_order order) noexcept
+    {
+        obj->store(desired, order);
+    }
+
+    template<class T>
+    T atomic_load(const volatile atomic<T>* obj) noexcept
+    {
+        return obj->load();
+    }
+
+    template<class T>
+    T atomic_load_explicit(const volatile atomic<T>* obj,
+                           memory_order order) noexcept
+    {
+        return obj->load(order);
+    }
+
+    template<class T>
+    T atomic_exchange(volatile atomic<T>* obj, T desired) noexcept
+    {
+        return obj->exchange(desired);
+    }
+
+    template<class T>
+    T atomic_exchange_explicit(volatile atomic<T>* obj, T desired,
+                               memory_order order) noexcept
+    {
+        return obj->exchange(desired, order);
+    }
+
+    template<class T>
+    bool atomic_compare_exchange_weak(volatile atomic<T>* obj,
+                                      T* expected, T desired) noexcept
+    {
+        return obj->compare_exchange_weak(*expected, desired);
+    }
+
+    template<class T>
+    bool atomic_compare_exchange_strong(volatile atomic<T>* obj,
+                                        T* expected, T desired) noexcept
+    {
+        return obj->compare_exchange_strong(*expected, desired);
+    }
+
+    template<class T>
+    bool atomic_compare_exchange_weak_explicit(volatile atomic<T>* obj,
+                                               T* expected, T desired,
+                                               memory_order success,
+                                               memory_order failure) noexcept
+    {
+        return obj->compare_exchange_weak(*expected, desired, success, failure);
+    }
+
+    template<class T>
+    bool atomic_compare_exchange_strong_explicit(volatile atomic<T>* obj,
+                                                 T* expected, T desired,
+                                                 memory_order success,
+                                                 memory_order failure) noexcept
+    {
+        return obj->compare_exchange_strong(*expected, desired, success, failure);
+    }
+
+    template<class T, class U>
+    T atomic_fetch_add(volatile atomic<T>* obj, U arg) noexcept
+    {
+        return obj->fetch_add(arg);
+    }
+
+    template<class T, class U>
+    T atomic_fetch_add_explicit(volatile atomic<T>* obj, U arg,
+                                memory_order order) noexcept
+    {
+        return obj->fetch_add(arg, order);
+    }
+
+    template<class T, class U>
+    T atomic_fetch_sub(volatile atomic<T>* obj, U arg) noexcept
+    {
+        return obj->fetch_sub(arg);
+    }
+
+    template<class T, class U>
+    T atomic_fetch_sub_explicit(volatile atomic<T>* obj, U arg,
+                                memory_order order) noexcept
+    {
+        return obj->fetch_sub(arg, order);
+    }
+
+    template<class T>
+    T atomic_fetch_and(volatile atomic<T>* obj, T arg) noexcept
+    {
+        return obj->fetch_and(arg);
+    }
+
+    template<class T>
+    T atomic_fetch_and_explicit(volatile atomic<T>* obj, T arg,
+                                memory_order order) noexcept
+    {
+        return obj->fetch_and(arg, order);
+    }
+
+    template<class T>
+    T atomic_fetch_or(volatile atomic<T>* obj, T arg) noexcept
+    {
+        return obj->fetch_or(arg);
+    }
+
+    template<class T>
+    T atomic_fetch_or_explicit(volatile atomic<T>* obj, T arg,
+                               memory_order order) noexcept
+    {
+        return obj->fetch_or(arg, order);
+    }
+
+    template<class T>
+    T atomic_fetch_xor(volatile atomic<T>* obj, T arg) noexcept
+    {
+        return obj->fetch_xor(arg);
+    }
+
+    template<class T>
+    T atomic_fetch_xor_explicit(volatile atomic<T>* obj, T arg,
+                                memory_order order) noexcept
+    {
+        return obj->fetch_xor(arg, order);
+    }
+
+    template<class T>
+    void atomic_wait(const volatile atomic<T>* obj, T old) noexcept
+    {
+        obj->wait(old);
+    }
+
+    template<class T>
+    void atomic_wait_explicit(const volatile atomic<T>* obj, T old,
+                              memory_order order) noexcept
+    {
+        obj->wait(old, order);
+    }
+
+    template<class T>
+    void atomic_notify_one(volatile atomic<T>* obj) noexcept
+    {
+        obj->notify_one();
+    }
+
+    template<class T>
+    void atomic_notify_all(volatile atomic<T>* obj) noexcept
+    {
+        obj->notify_all();
+    }
+
+    /**
+     * 32.8, flag type and operations:
+     */
+
+    struct atomic_flag
+    {
+        bool test(memory_order order = memory_order_seq_cst) const volatile noexcept
+        {
+            return __atomic_load_n(&flag_, order);
+        }
+
+        bool test_and_set(memory_order order = memory_order_seq_cst) volatile noexcept
+        {
+            return __atomic_test_and_set(&flag_, order);
+        }
+
+        void clear(memory_order order = memory_order_seq_cst) volatile noexcept
+        {
+            __atomic_clear(&flag_, order);
+        }
+
+        void wait(bool old, memory_order order = memory_order_seq_cst) const volatile noexcept
+        {
+            for (int i = 0; i < aux::atomic_wait_spin; ++i)
+            {
+                if (test(order) != old)
+                    return;
+            }
+
+            aux::atomic_wait(&flag_, &old, order, &atomic_flag::same_value_);
+        }
+
+        void notify_one() volatile noexcept
+        {
+            aux::atomic_notify(&flag_);
+        }
+
+        void notify_all() volatile noexcept
+        {
+            aux::atomic_notify(&flag_);
+        }
+
+        atomic_flag() noexcept = default;
+
+        constexpr atomic_flag(bool flag) noexcept
+            : flag_{flag}
+        { /* DUMMY BODY */ }
+
+        atomic_flag(const atomic_flag&) = delete;
+        atomic_flag& operator=(const atomic_flag&) = delete;
+        atomic_flag& operator=(const atomic_flag&) volatile = delete;
+
+        private:
+            bool flag_;
+
+            static bool same_value_(const volatile void* obj, const void* old,
+                                    memory_order order) noexcept
+            {
+                return __atomic_load_n(static_cast<const volatile bool*>(obj), order) ==
+                       *static_cast<const bool*>(old);
+            }
+    };
+
+    inline bool atomic_flag_test_and_set(volatile atomic_flag* flag) noexcept
+    {
+        return flag->test_and_set();
+    }
+
+    inline bool atomic_flag_test_and_set_explicit(volatile atomic_flag* flag,
+                                                  memory_order order) noexcept
+    {
+        return flag->test_and_set(order);
+    }
+
+    inline void atomic_flag_clear(volatile atomic_flag* flag) noexcept
+    {
+        flag->clear();
+    }
+
+    inline void atomic_flag_clear_explicit(volatile atomic_flag* flag,
+                                           memory_order order) noexcept
+    {
+        flag->clear(order);
+    }
+
+    /**
+     * 32.9, fences:
+     */
+
+    inline void atomic_thread_fence(memory_order order) noexcept
+    {
+        __atomic_thread_fence(order);
+    }
+
+    inline void atomic_signal_fence(memory_order order) noexcept
+    {
+        __atomic_signal_fence(order);
+    }
+}
 
 #endif
@@ -143,7 +143,7 @@ namespace std
         constexpr auto operator()(T&& lhs, U&& rhs) const
             -> decltype(forward<T>(lhs) + forward<U>(rhs))
         {
-            return forward<T>(lhs) + forward<T>(rhs);
+            return forward<T>(lhs) + forward<U>(rhs);
         }
 
         using is_transparent = aux::transparent_t;
@@ -156,7 +156,7 @@ namespace std
         constexpr auto operator()(T&& lhs, U&& rhs) const
             -> decltype(forward<T>(lhs) - forward<U>(rhs))
         {
-            return forward<T>(lhs) - forward<T>(rhs);
+            return forward<T>(lhs) - forward<U>(rhs);
         }
 
         using is_transparent = aux::transparent_t;
@@ -169,7 +169,7 @@ namespace std
         constexpr auto operator()(T&& lhs, U&& rhs) const
             -> decltype(forward<T>(lhs) * forward<U>(rhs))
         {
-            return forward<T>(lhs) * forward<T>(rhs);
+            return forward<T>(lhs) * forward<U>(rhs);
         }
 
         using is_transparent = aux::transparent_t;
@@ -182,7 +182,7 @@ namespace std
         constexpr auto operator()(T&& lhs, U&& rhs) const
             -> decltype(forward<T>(lhs) / forward<U>(rhs))
         {
-            return forward<T>(lhs) / forward<T>(rhs);
+            return forward<T>(lhs) / forward<U>(rhs);
         }
 
         using is_transparent = aux::transparent_t;
@@ -195,7 +195,7 @@ namespace std
         constexpr auto operator()(T&& lhs, U&& rhs) const
             -> decltype(forward<T>(lhs) % forward<U>(rhs))
         {
-            return forward<T>(lhs) % forward<T>(rhs);
+            return forward<T>(lhs) % forward<U>(rhs);
         }
 
         using is_transparent = aux::transparent_t;
@@ -75,7 +75,13 @@ namespace std
             static_assert(is_arithmetic<T>::value || is_pointer<T>::value,
                           "invalid type passed to aux::hash");
 
+            /**
+             * Note: The bytes not covered by the value would
+             *       otherwise be left uninitialized, making the
+             *       hash of the narrower types nondeterministic.
+             */
             converter<T> conv;
+            conv.converted = 0;
             conv.value = x;
 
             return hash_<size_t>(conv.converted);
@@ -31,7 +31,7 @@
 
 namespace std
 {
-    struct forward_iterator_tag;
+    struct input_iterator_tag;
 }
 
 namespace std::aux
@@ -77,6 +77,9 @@ namespace std
             {
                 // TODO: exception here caught and not rethrown
                 close();
+
+                delete[] obuf_;
+                delete[] ibuf_;
             }
 
             /**
@@ -142,6 +145,14 @@ namespace std
                     obuf_ = new char_type[buf_size_];
                 init_();
 
+                /**
+                 * Output only files are written from our put area
+                 * in whole blocks, so buffering them in stdio as well
+                 * would only add another copy of the data.
+                 */
+                if (!mode_is_in_(mode_))
+                    std::setbuf(file_, nullptr);
+
                 return this;
             }
 
@@ -253,15 +264,45 @@ namespace std
                 if (!mode_is_out_(mode_))
                     return traits_type::eof();
 
-                auto count = static_cast<size_t>(this->output_next_ - this->output_begin_);
-                fwrite(obuf_, sizeof(char_type), count, file_);
-                fflush(file_);
+                if (!flush_obuf_())
+                    return traits_type::eof();
 
-                this->output_next_ = this->output_begin_;
+                if (!traits_type::eq_int_type(c, traits_type::eof()))
+                    traits_type::assign(*this->output_next_++, traits_type::to_char_type(c));
 
                 return traits_type::not_eof(c);
             }
 
+            streamsize xsputn(const char_type* s, streamsize n) override
+            {
+                // TODO: use codecvt
+                if (!mode_is_out_(mode_) || !obuf_)
+                    return 0;
+
+                if (n <= this->output_end_ - this->output_next_)
+                {
+                    traits_type::copy(this->output_next_, s, n);
+                    this->output_next_ += n;
+
+                    return n;
+                }
+
+                if (!flush_obuf_())
+                    return 0;
+
+                /**
+                 * Blocks that would not fit into an empty buffer
+                 * are written directly without copying them first.
+                 */
+                if (n >= static_cast<streamsize>(buf_size_))
+                    return fwrite(s, sizeof(char_type), n, file_);
+
+                traits_type::copy(this->output_next_, s, n);
+                this->output_next_ += n;
+
+                return n;
+            }
+
             basic_streambuf<char_type, traits_type>*
             setbuf(char_type* s, streamsize n) override
             {
@@ -286,9 +327,12 @@ namespace std
             int sync() override
             {
                 if (mode_is_out_(mode_))
-                    overflow();
+                {
+                    if (!flush_obuf_() || fflush(file_))
+                        return -1;
+                }
 
-                return 0; // TODO: what is the correct return value?
+                return 0;
             }
 
             void imbue(const locale& loc) override
@@ -305,7 +349,7 @@ namespace std
 
             FILE* file_;
 
-            static constexpr size_t buf_size_{128};
+            static constexpr size_t buf_size_{2 * BUFSIZ};
 
             const char* get_mode_str_(ios_base::openmode mode)
             {
@@ -359,6 +403,17 @@ namespace std
                 return (mode & (ios_base::out | ios_base::app | ios_base::trunc)) != 0;
             }
 
+            bool flush_obuf_()
+            {
+                auto count = static_cast<size_t>(this->output_next_ - this->output_begin_);
+                this->output_next_ = this->output_begin_;
+
+                if (count == 0)
+                    return true;
+
+                return fwrite(obuf_, sizeof(char_type), count, file_) == count;
+            }
+
             void init_()
             {
                 if (ibuf_)
@@ -183,13 +183,7 @@ namespace std
             using event_callback = void (*)(event, ios_base&, int);
             void register_callback(event_callback fn, int index);
 
-            static bool sync_with_stdio(bool sync = true)
-            {
-                auto old = sync_;
-                sync_ = sync;
-
-                return old;
-            }
+            static bool sync_with_stdio(bool sync = true);
 
         protected:
             ios_base();
@@ -212,6 +206,15 @@ namespace std
 
             locale locale_;
 
+            /**
+             * Cached result of the check whether locale_ is
+             * the classic one, which allows basic_ostream to
+             * format numbers without going through the facets.
+             */
+            bool classic_;
+
+            static bool is_classic_(const locale& loc);
+
             vector<pair<event_callback, int>> callbacks_;
 
         private:
@@ -392,6 +395,7 @@ namespace std
                 precision_  = rhs.precision_;
                 fill_      = rhs.fill_;
                 locale_     = rhs.locale_;
+                classic_    = rhs.classic_;
 
                 delete[] iarray_;
                 iarray_size_ = rhs.iarray_size_;
@@ -465,6 +469,7 @@ namespace std
 
                 fill_ = widen(' ');
                 locale_ = locale();
+                classic_ = true;
 
                 iarray_ = nullptr;
                 parray_ = nullptr;
@@ -480,6 +485,7 @@ namespace std
                 precision_  = rhs.precision_;
                 fill_       = rhs.fill_;
                 locale_     = move(rhs.locale_);
+                classic_    = rhs.classic_;
                 rdstate_    = rhs.rdstate_;
                 callbacks_  = move(rhs.callbacks_);
 
@@ -506,6 +512,7 @@ namespace std
                 precision_  = rhs.precision_;
                 fill_       = rhs.fill_;
                 locale_     = move(rhs.locale_);
+                classic_    = rhs.classic_;
                 rdstate_    = rhs.rdstate_;
                 callbacks_.swap(rhs.callbacks_);
 
@@ -532,6 +539,7 @@ namespace std
                 swap(precision_, rhs.precision_);
                 swap(fill_, rhs.fill_);
                 swap(locale_, rhs.locale_);
+                swap(classic_, rhs.classic_);
                 swap(rdstate_, rhs.rdstate_);
                 swap(callbacks_, rhs.callbacks_);
                 swap(iarray_);
@@ -0,0 +1,124 @@
+/*
+ * Copyright (c) 2019 Jaroslav Jindrak
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * - Redistributions of source code must retain the above copyright
+ *   notice, this list of conditions and the following disclaimer.
+ * - Redistributions in binary form must reproduce the above copyright
+ *   notice, this list of conditions and the following disclaimer in the
+ *   documentation and/or other materials provided with the distribution.
+ * - The name of the author may not be used to endorse or promote products
+ *   derived from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHOR ``AS IS'' AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+ * OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+ * IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT
+ * NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF
+ * THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef LIBCPP_BITS_IO_NUM_FORMAT
+#define LIBCPP_BITS_IO_NUM_FORMAT
+
+#include <cstdio>
+#include <cstdlib>
+
+namespace std::aux
+{
+    /**
+     * Formatting primitives used by basic_ostream when its locale
+     * is the classic one. In that case num_put would only copy
+     * the output of snprintf through ctype::widen and numpunct,
+     * so we can skip the facets and write the characters straight
+     * into the put area of the stream buffer.
+     */
+
+    /**
+     * Longest decimal representation of a 64bit integer
+     * including the minus sign.
+     */
+    inline constexpr size_t max_decimal_length{21};
+
+    /**
+     * Enough for the %g representation of any double
+     * or long double (including sign, exponent and nan/inf).
+     */
+    inline constexpr size_t max_float_length{32};
+
+    inline size_t decimal_length(unsigned long long v)
+    {
+        size_t len{1};
+        while (v >= 10000)
+        {
+            v /= 10000;
+            len += 4;
+        }
+
+        if (v >= 1000)
+            return len + 3;
+        else if (v >= 100)
+            return len + 2;
+        else if (v >= 10)
+            return len + 1;
+        else
+            return len;
+    }
+
+    /**
+     * Writes the digits of v backwards so that the last one
+     * ends right before end and returns the position of the
+     * first one. Two digits are produced per division.
+     */
+    template<class Char>
+    Char* format_decimal(Char* end, unsigned long long v)
+    {
+        static constexpr char pairs[] =
+            "0001020304050607080910111213141516171819"
+            "2021222324252627282930313233343536373839"
+            "4041424344454647484950515253545556575859"
+            "6061626364656667686970717273747576777879"
+            "8081828384858687888990919293949596979899";
+
+        while (v >= 100)
+        {
+            auto idx = (v % 100) * 2;
+            v /= 100;
+
+            *--end = static_cast<Char>(pairs[idx + 1]);
+            *--end = static_cast<Char>(pairs[idx]);
+        }
+
+        if (v >= 10)
+        {
+            auto idx = v * 2;
+
+            *--end = static_cast<Char>(pairs[idx + 1]);
+            *--end = static_cast<Char>(pairs[idx]);
+        }
+        else
+            *--end = static_cast<Char>('0' + v);
+
+        return end;
+    }
+
+    inline int format_float(char* buf, size_t size, double v)
+    {
+        return snprintf(buf, size, "%g", v);
+    }
+
+    inline int format_float(char* buf, size_t size, long double v)
+    {
+        return snprintf(buf, size, "%Lg", v);
+    }
+}
+
+#endif
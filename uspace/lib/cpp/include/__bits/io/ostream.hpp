@@ -29,9 +29,11 @@
 #ifndef LIBCPP_BITS_IO_OSTREAM
 #define LIBCPP_BITS_IO_OSTREAM
 
+#include <__bits/io/num_format.hpp>
 #include <ios>
 #include <iosfwd>
 #include <locale>
+#include <type_traits>
 
 namespace std
 {
@@ -138,12 +140,17 @@ namespace std
 
                 if (sen)
                 {
-                    bool failed = use_facet<
-                        num_put<char_type, ostreambuf_iterator<char_type, traits_type>>
-                    >(this->getloc()).put(*this, *this, this->fill(), x).failed();
+                    if (fast_integral_() && (this->flags_ & ios_base::boolalpha) == 0)
+                        put_integral_(static_cast<long>(x));
+                    else
+                    {
+                        bool failed = use_facet<
+                            num_put<char_type, ostreambuf_iterator<char_type, traits_type>>
+                        >(this->getloc()).put(*this, *this, this->fill(), x).failed();
 
-                    if (failed)
-                        this->setstate(ios_base::badbit);
+                        if (failed)
+                            this->setstate(ios_base::badbit);
+                    }
                 }
 
                 return *this;
@@ -155,16 +162,21 @@ namespace std
 
                 if (sen)
                 {
-                    auto basefield = (this->flags() & ios_base::basefield);
-                    bool failed = use_facet<
-                        num_put<char_type, ostreambuf_iterator<char_type, traits_type>>
-                    >(this->getloc()).put(*this, *this, this->fill(),
-                                          (basefield == ios_base::oct || basefield == ios_base::hex)
-                                          ? static_cast<long>(static_cast<unsigned short>(x))
-                                          : static_cast<long>(x)).failed();
-
-                    if (failed)
-                        this->setstate(ios_base::badbit);
+                    if (fast_integral_())
+                        put_integral_(static_cast<long>(x));
+                    else
+                    {
+                        auto basefield = (this->flags() & ios_base::basefield);
+                        bool failed = use_facet<
+                            num_put<char_type, ostreambuf_iterator<char_type, traits_type>>
+                        >(this->getloc()).put(*this, *this, this->fill(),
+                                              (basefield == ios_base::oct || basefield == ios_base::hex)
+                                              ? static_cast<long>(static_cast<unsigned short>(x))
+                                              : static_cast<long>(x)).failed();
+
+                        if (failed)
+                            this->setstate(ios_base::badbit);
+                    }
                 }
 
                 return *this;
@@ -176,13 +188,18 @@ namespace std
 
                 if (sen)
                 {
-                    bool failed = use_facet<
-                        num_put<char_type, ostreambuf_iterator<char_type, traits_type>>
-                    >(this->getloc()).put(*this, *this, this->fill(),
-                                          static_cast<unsigned long>(x)).failed();
+                    if (fast_integral_())
+                        put_integral_(static_cast<unsigned long>(x));
+                    else
+                    {
+                        bool failed = use_facet<
+                            num_put<char_type, ostreambuf_iterator<char_type, traits_type>>
+                        >(this->getloc()).put(*this, *this, this->fill(),
+                                              static_cast<unsigned long>(x)).failed();
 
-                    if (failed)
-                        this->setstate(ios_base::badbit);
+                        if (failed)
+                            this->setstate(ios_base::badbit);
+                    }
                 }
 
                 return *this;
@@ -194,16 +211,21 @@ namespace std
 
                 if (sen)
                 {
-                    auto basefield = (this->flags() & ios_base::basefield);
-                    bool failed = use_facet<
-                        num_put<char_type, ostreambuf_iterator<char_type, traits_type>>
-                    >(this->getloc()).put(*this, *this, this->fill(),
-                                          (basefield == ios_base::oct || basefield == ios_base::hex)
-                                          ? static_cast<long>(static_cast<unsigned int>(x))
-                                          : static_cast<long>(x)).failed();
-
-                    if (failed)
-                        this->setstate(ios_base::badbit);
+                    if (fast_integral_())
+                        put_integral_(static_cast<long>(x));
+                    else
+                    {
+                        auto basefield = (this->flags() & ios_base::basefield);
+                        bool failed = use_facet<
+                            num_put<char_type, ostreambuf_iterator<char_type, traits_type>>
+                        >(this->getloc()).put(*this, *this, this->fill(),
+                                              (basefield == ios_base::oct || basefield == ios_base::hex)
+                                              ? static_cast<long>(static_cast<unsigned int>(x))
+                                              : static_cast<long>(x)).failed();
+
+                        if (failed)
+                            this->setstate(ios_base::badbit);
+                    }
                 }
 
                 return *this;
@@ -215,13 +237,18 @@ namespace std
 
                 if (sen)
                 {
-                    bool failed = use_facet<
-                        num_put<char_type, ostreambuf_iterator<char_type, traits_type>>
-                    >(this->getloc()).put(*this, *this, this->fill(),
-                                          static_cast<unsigned long>(x)).failed();
+                    if (fast_integral_())
+                        put_integral_(static_cast<unsigned long>(x));
+                    else
+                    {
+                        bool failed = use_facet<
+                            num_put<char_type, ostreambuf_iterator<char_type, traits_type>>
+                        >(this->getloc()).put(*this, *this, this->fill(),
+                                              static_cast<unsigned long>(x)).failed();
 
-                    if (failed)
-                        this->setstate(ios_base::badbit);
+                        if (failed)
+                            this->setstate(ios_base::badbit);
+                    }
                 }
 
                 return *this;
@@ -233,12 +260,17 @@ namespace std
 
                 if (sen)
                 {
-                    bool failed = use_facet<
-                        num_put<char_type, ostreambuf_iterator<char_type, traits_type>>
-                    >(this->getloc()).put(*this, *this, this->fill(), x).failed();
+                    if (fast_integral_())
+                        put_integral_(x);
+                    else
+                    {
+                        bool failed = use_facet<
+                            num_put<char_type, ostreambuf_iterator<char_type, traits_type>>
+                        >(this->getloc()).put(*this, *this, this->fill(), x).failed();
 
-                    if (failed)
-                        this->setstate(ios_base::badbit);
+                        if (failed)
+                            this->setstate(ios_base::badbit);
+                    }
                 }
 
                 return *this;
@@ -250,12 +282,17 @@ namespace std
 
                 if (sen)
                 {
-                    bool failed = use_facet<
-                        num_put<char_type, ostreambuf_iterator<char_type, traits_type>>
-                    >(this->getloc()).put(*this, *this, this->fill(), x).failed();
+                    if (fast_integral_())
+                        put_integral_(x);
+                    else
+                    {
+                        bool failed = use_facet<
+                            num_put<char_type, ostreambuf_iterator<char_type, traits_type>>
+                        >(this->getloc()).put(*this, *this, this->fill(), x).failed();
 
-                    if (failed)
-                        this->setstate(ios_base::badbit);
+                        if (failed)
+                            this->setstate(ios_base::badbit);
+                    }
                 }
 
                 return *this;
@@ -267,12 +304,17 @@ namespace std
 
                 if (sen)
                 {
-                    bool failed = use_facet<
-                        num_put<char_type, ostreambuf_iterator<char_type, traits_type>>
-                    >(this->getloc()).put(*this, *this, this->fill(), x).failed();
+                    if (fast_integral_())
+                        put_integral_(x);
+                    else
+                    {
+                        bool failed = use_facet<
+                            num_put<char_type, ostreambuf_iterator<char_type, traits_type>>
+                        >(this->getloc()).put(*this, *this, this->fill(), x).failed();
 
-                    if (failed)
-                        this->setstate(ios_base::badbit);
+                        if (failed)
+                            this->setstate(ios_base::badbit);
+                    }
                 }
 
                 return *this;
@@ -284,12 +326,17 @@ namespace std
 
                 if (sen)
                 {
-                    bool failed = use_facet<
-                        num_put<char_type, ostreambuf_iterator<char_type, traits_type>>
-                    >(this->getloc()).put(*this, *this, this->fill(), x).failed();
+                    if (fast_integral_())
+                        put_integral_(x);
+                    else
+                    {
+                        bool failed = use_facet<
+                            num_put<char_type, ostreambuf_iterator<char_type, traits_type>>
+                        >(this->getloc()).put(*this, *this, this->fill(), x).failed();
 
-                    if (failed)
-                        this->setstate(ios_base::badbit);
+                        if (failed)
+                            this->setstate(ios_base::badbit);
+                    }
                 }
 
                 return *this;
@@ -301,12 +348,17 @@ namespace std
 
                 if (sen)
                 {
-                    bool failed = use_facet<
-                        num_put<char_type, ostreambuf_iterator<char_type, traits_type>>
-                    >(this->getloc()).put(*this, *this, this->fill(), static_cast<double>(x)).failed();
+                    if (fast_floating_())
+                        put_floating_(static_cast<double>(x));
+                    else
+                    {
+                        bool failed = use_facet<
+                            num_put<char_type, ostreambuf_iterator<char_type, traits_type>>
+                        >(this->getloc()).put(*this, *this, this->fill(), static_cast<double>(x)).failed();
 
-                    if (failed)
-                        this->setstate(ios_base::badbit);
+                        if (failed)
+                            this->setstate(ios_base::badbit);
+                    }
                 }
 
                 return *this;
@@ -318,12 +370,17 @@ namespace std
 
                 if (sen)
                 {
-                    bool failed = use_facet<
-                        num_put<char_type, ostreambuf_iterator<char_type, traits_type>>
-                    >(this->getloc()).put(*this, *this, this->fill(), x).failed();
+                    if (fast_floating_())
+                        put_floating_(x);
+                    else
+                    {
+                        bool failed = use_facet<
+                            num_put<char_type, ostreambuf_iterator<char_type, traits_type>>
+                        >(this->getloc()).put(*this, *this, this->fill(), x).failed();
 
-                    if (failed)
-                        this->setstate(ios_base::badbit);
+                        if (failed)
+                            this->setstate(ios_base::badbit);
+                    }
                 }
 
                 return *this;
@@ -335,12 +392,17 @@ namespace std
 
                 if (sen)
                 {
-                    bool failed = use_facet<
-                        num_put<char_type, ostreambuf_iterator<char_type, traits_type>>
-                    >(this->getloc()).put(*this, *this, this->fill(), x).failed();
+                    if (fast_floating_())
+                        put_floating_(x);
+                    else
+                    {
+                        bool failed = use_facet<
+                            num_put<char_type, ostreambuf_iterator<char_type, traits_type>>
+                        >(this->getloc()).put(*this, *this, this->fill(), x).failed();
 
-                    if (failed)
-                        this->setstate(ios_base::badbit);
+                        if (failed)
+                            this->setstate(ios_base::badbit);
+                    }
                 }
 
                 return *this;
@@ -497,6 +559,129 @@ namespace std
             {
                 basic_ios<Char, Traits>::swap(rhs);
             }
+
+        private:
+            /**
+             * In the classic locale, num_put only copies the output
+             * of snprintf through ctype::widen (which is identity on
+             * digits) and numpunct::decimal_point (which is '.'),
+             * so unless the formatting flags ask for something the
+             * fast path does not handle, we format the number here
+             * and write it directly into the put area.
+             */
+
+            bool fast_integral_() const
+            {
+                auto basefield = (this->flags_ & ios_base::basefield);
+
+                return this->classic_ && this->width_ == 0 &&
+                       basefield != ios_base::oct && basefield != ios_base::hex &&
+                       (this->flags_ & (ios_base::showpos | ios_base::showbase)) == 0;
+            }
+
+            bool fast_floating_() const
+            {
+                /**
+                 * The fast path prints with %g, which uses
+                 * the default precision of 6.
+                 */
+                return this->classic_ && this->width_ == 0 &&
+                       this->precision_ == 6 &&
+                       (this->flags_ & ios_base::floatfield) == 0 &&
+                       (this->flags_ & (ios_base::showpos | ios_base::showpoint |
+                                        ios_base::uppercase)) == 0;
+            }
+
+            template<class Int>
+            void put_integral_(Int x)
+            {
+                if constexpr (is_signed_v<Int>)
+                {
+                    if (x < 0)
+                    {
+                        put_decimal_(0ULL - static_cast<unsigned long long>(x), true);
+
+                        return;
+                    }
+                }
+
+                put_decimal_(static_cast<unsigned long long>(x), false);
+            }
+
+            void put_decimal_(unsigned long long x, bool negative)
+            {
+                auto len = aux::decimal_length(x) + (negative ? 1 : 0);
+                auto sb = this->rdbuf();
+
+                if (sb->output_next_ &&
+                    static_cast<size_t>(sb->output_end_ - sb->output_next_) >= len)
+                {
+                    auto end = sb->output_next_ + len;
+                    auto it = aux::format_decimal(end, x);
+                    if (negative)
+                        *--it = '-';
+
+                    sb->output_next_ = end;
+                }
+                else
+                {
+                    char_type buf[aux::max_decimal_length];
+
+                    auto it = aux::format_decimal(buf + len, x);
+                    if (negative)
+                        *--it = '-';
+
+                    put_formatted_(sb, buf, len);
+                }
+            }
+
+            template<class Float>
+            void put_floating_(Float x)
+            {
+                auto sb = this->rdbuf();
+                auto avail = sb->output_next_ ? sb->output_end_ - sb->output_next_ : 0;
+
+                if constexpr (is_same_v<char_type, char>)
+                {
+                    if (static_cast<size_t>(avail) >= aux::max_float_length)
+                    {
+                        auto len = aux::format_float(sb->output_next_, avail, x);
+                        if (len < 0)
+                            this->setstate(ios_base::badbit);
+                        else
+                            sb->output_next_ += len;
+
+                        return;
+                    }
+                }
+
+                char buf[aux::max_float_length];
+                auto len = aux::format_float(buf, aux::max_float_length, x);
+                if (len < 0)
+                {
+                    this->setstate(ios_base::badbit);
+
+                    return;
+                }
+
+                if constexpr (is_same_v<char_type, char>)
+                    put_formatted_(sb, buf, len);
+                else
+                {
+                    char_type wbuf[aux::max_float_length];
+                    for (int i = 0; i < len; ++i)
+                        wbuf[i] = static_cast<char_type>(buf[i]);
+
+                    put_formatted_(sb, wbuf, len);
+                }
+            }
+
+            void put_formatted_(basic_streambuf<Char, Traits>* sb,
+                                const char_type* buf, streamsize len)
+            {
+                if (sb->sputn(buf, len) != len)
+                    this->setstate(ios_base::badbit);
+            }
     };
 
     using ostream  = basic_ostream<char>;
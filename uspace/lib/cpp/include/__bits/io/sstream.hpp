@@ -72,9 +72,13 @@ namespace std
             basic_stringbuf(const basic_stringbuf&) = delete;
 
             basic_stringbuf(basic_stringbuf&& other)
-                : mode_{move(other.mode_)}, str_{move(other.str_)}
+                : mode_{move(other.mode_)}, str_{}
             {
+                auto old = other.str_.begin();
+                str_ = move(other.str_);
+
                 basic_streambuf<char_type, traits_type>::swap(other);
+                rebase_(old);
             }
 
             /**
@@ -90,10 +94,15 @@ namespace std
 
             void swap(basic_stringbuf& rhs)
             {
+                auto old = str_.begin();
+                auto rhs_old = rhs.str_.begin();
+
                 std::swap(mode_, rhs.mode_);
                 std::swap(str_, rhs.str_);
 
                 basic_streambuf<char_type, traits_type>::swap(rhs);
+                rebase_(rhs_old);
+                rhs.rebase_(old);
             }
 
             /**
@@ -104,7 +113,7 @@ namespace std
             {
                 if (mode_ & ios_base::out)
                     return basic_string<char_type, traits_type, allocator_type>{
-                        this->output_begin_, this->output_next_ - 1, str_.get_allocator()
+                        this->output_begin_, this->output_next_, str_.get_allocator()
                     };
                 else if (mode_ == ios_base::in)
                     return basic_string<char_type, traits_type, allocator_type>{
@@ -250,6 +259,26 @@ namespace std
                 }
             }
 
+            /**
+             * Short strings keep their contents inline, so
+             * the buffer can move along with the string and
+             * our pointers have to follow it.
+             */
+            void rebase_(char_type* old)
+            {
+                auto rebase = [this, old](char_type*& ptr){
+                    if (ptr)
+                        ptr = str_.begin() + (ptr - old);
+                };
+
+                rebase(this->input_begin_);
+                rebase(this->input_next_);
+                rebase(this->input_end_);
+                rebase(this->output_begin_);
+                rebase(this->output_next_);
+                rebase(this->output_end_);
+            }
+
             bool ensure_free_space_(size_t n = 1)
             {
                 str_.ensure_free_space_(n);
@@ -214,15 +214,15 @@ namespace std
 
             void swap(basic_streambuf& rhs)
             {
-                swap(input_begin_, rhs.input_begin_);
-                swap(input_next_, rhs.input_next_);
-                swap(input_end_, rhs.input_end_);
+                std::swap(input_begin_, rhs.input_begin_);
+                std::swap(input_next_, rhs.input_next_);
+                std::swap(input_end_, rhs.input_end_);
 
-                swap(output_begin_, rhs.output_begin_);
-                swap(output_next_, rhs.output_next_);
-                swap(output_end_, rhs.output_end_);
+                std::swap(output_begin_, rhs.output_begin_);
+                std::swap(output_next_, rhs.output_next_);
+                std::swap(output_end_, rhs.output_end_);
 
-                swap(locale_, rhs.locale_);
+                std::swap(locale_, rhs.locale_);
             }
 
             /**
@@ -381,12 +381,13 @@ namespace std
                     return 0;
 
                 streamsize i{0};
-                for (; i <= n; ++i)
+                for (; i < n; ++i, ++s)
                 {
-                    if (!write_avail_() && traits_type::eq_int_type(overflow(), traits_type::eof()))
+                    if (write_avail_())
+                        traits_type::assign(*output_next_++, *s);
+                    else if (traits_type::eq_int_type(overflow(traits_type::to_int_type(*s)),
+                                                      traits_type::eof()))
                         break;
-
-                    *output_next_++ = *s++;
                 }
 
                 return i;
@@ -422,6 +423,13 @@ namespace std
             {
                 return input_next_ && input_next_ < input_end_;
             }
+
+            /**
+             * Formatted output in the classic locale
+             * writes directly into the put area.
+             */
+            template<class C, class T>
+            friend class basic_ostream;
     };
 
     using streambuf  = basic_streambuf<char>;
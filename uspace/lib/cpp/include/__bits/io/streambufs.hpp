@@ -128,11 +128,44 @@ namespace std::aux
     {
         public:
             stdout_streambuf()
-                : basic_streambuf<Char, Traits>{}
+                : basic_streambuf<Char, Traits>{}, buffer_{nullptr}
             { /* DUMMY BODY */ }
 
             virtual ~stdout_streambuf()
-            { /* DUMMY BODY */ }
+            {
+                if (buffer_)
+                {
+                    flush_buffer_();
+                    delete[] buffer_;
+                }
+            }
+
+            /**
+             * While synchronized with stdio, every write goes straight
+             * to stdout so that it interleaves correctly with printf
+             * and friends. Once the synchronization is turned off, we
+             * gather the output in our own put area and hand it to
+             * stdio in large blocks.
+             */
+            void sync_with_stdio(bool sync)
+            {
+                if (sync && buffer_)
+                {
+                    flush_buffer_();
+                    this->setp(nullptr, nullptr);
+
+                    delete[] buffer_;
+                    buffer_ = nullptr;
+                }
+                else if (!sync && !buffer_)
+                {
+                    // Anything written so far must precede our output.
+                    fflush(out_);
+
+                    buffer_ = new char_type[buf_size_];
+                    this->setp(buffer_, buffer_ + buf_size_);
+                }
+            }
 
         protected:
             using traits_type = Traits;
@@ -140,9 +173,21 @@ namespace std::aux
             using int_type    = typename traits_type::int_type;
             using off_type    = typename traits_type::off_type;
 
+            using basic_streambuf<Char, Traits>::output_begin_;
+            using basic_streambuf<Char, Traits>::output_next_;
+            using basic_streambuf<Char, Traits>::output_end_;
+
             int_type overflow(int_type c = traits_type::eof()) override
             {
-                if (!traits_type::eq_int_type(c, traits_type::eof()))
+                if (buffer_)
+                {
+                    if (!flush_buffer_())
+                        return traits_type::eof();
+
+                    if (!traits_type::eq_int_type(c, traits_type::eof()))
+                        traits_type::assign(*output_next_++, traits_type::to_char_type(c));
+                }
+                else if (!traits_type::eq_int_type(c, traits_type::eof()))
                 {
                     auto cc = traits_type::to_char_type(c);
                     fwrite(&cc, sizeof(char_type), 1, out_);
@@ -153,11 +198,34 @@ namespace std::aux
 
             streamsize xsputn(const char_type* s, streamsize n) override
             {
-                return fwrite(s, sizeof(char_type), n, out_);
+                if (!buffer_)
+                    return fwrite(s, sizeof(char_type), n, out_);
+
+                if (n <= output_end_ - output_next_)
+                {
+                    traits_type::copy(output_next_, s, n);
+                    output_next_ += n;
+
+                    return n;
+                }
+
+                if (!flush_buffer_())
+                    return 0;
+
+                if (n >= static_cast<streamsize>(buf_size_))
+                    return fwrite(s, sizeof(char_type), n, out_);
+
+                traits_type::copy(output_next_, s, n);
+                output_next_ += n;
+
+                return n;
             }
 
             int sync() override
             {
+                if (buffer_ && !flush_buffer_())
+                    return -1;
+
                 if (fflush(out_))
                     return -1;
                 return 0;
@@ -165,6 +233,21 @@ namespace std::aux
 
         private:
             FILE* out_{stdout};
+
+            char_type* buffer_;
+
+            static constexpr size_t buf_size_{4096};
+
+            bool flush_buffer_()
+            {
+                auto count = static_cast<size_t>(output_next_ - output_begin_);
+                output_next_ = output_begin_;
+
+                if (count == 0)
+                    return true;
+
+                return fwrite(output_begin_, sizeof(char_type), count, out_) == count;
+            }
     };
 }
 
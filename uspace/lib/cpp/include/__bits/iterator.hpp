@@ -115,8 +115,22 @@ namespace std
     template<class InputIterator, class Distance>
     void advance(InputIterator& it, Distance n)
     {
-        for (Distance i = Distance{}; i < n; ++i)
-            ++it;
+        using cat_t = typename iterator_traits<InputIterator>::iterator_category;
+
+        if constexpr (is_same_v<cat_t, random_access_iterator_tag>)
+            it += n;
+        else
+        {
+            for (; n > Distance{}; --n)
+                ++it;
+
+            // Negative distance is only allowed for bidirectional iterators.
+            if constexpr (is_base_of_v<bidirectional_iterator_tag, cat_t>)
+            {
+                for (; n < Distance{}; ++n)
+                    --it;
+            }
+        }
     }
 
     template<class InputIterator>
@@ -113,99 +113,46 @@ namespace std
 
             iter_type do_put(iter_type it, ios_base& base, char_type fill, long v) const
             {
-                auto basefield = (base.flags() & ios_base::basefield);
-                auto uppercase = (base.flags() & ios_base::uppercase);
-
-                int ret{};
-                if (basefield == ios_base::oct)
-                    ret = snprintf(base.buffer_, ios_base::buffer_size_, "%lo", v);
-                else if ((basefield == ios_base::hex) && !uppercase)
-                    ret = snprintf(base.buffer_, ios_base::buffer_size_, "%lx", v);
-                else if (basefield == ios_base::hex)
-                    ret = snprintf(base.buffer_, ios_base::buffer_size_, "%lX", v);
-                else
-                    ret = snprintf(base.buffer_, ios_base::buffer_size_, "%ld", v);
+                char fmt[format_size_];
+                int ret = snprintf(base.buffer_, ios_base::buffer_size_,
+                                   integral_format_(fmt, base, "l", true), v);
 
                 return put_adjusted_buffer_(it, base, fill, ret);
             }
 
             iter_type do_put(iter_type it, ios_base& base, char_type fill, long long v) const
             {
-                auto basefield = (base.flags() & ios_base::basefield);
-                auto uppercase = (base.flags() & ios_base::uppercase);
-
-                int ret{};
-                if (basefield == ios_base::oct)
-                    ret = snprintf(base.buffer_, ios_base::buffer_size_, "%llo", v);
-                else if ((basefield == ios_base::hex) && !uppercase)
-                    ret = snprintf(base.buffer_, ios_base::buffer_size_, "%llx", v);
-                else if (basefield == ios_base::hex)
-                    ret = snprintf(base.buffer_, ios_base::buffer_size_, "%llX", v);
-                else
-                    ret = snprintf(base.buffer_, ios_base::buffer_size_, "%lld", v);
+                char fmt[format_size_];
+                int ret = snprintf(base.buffer_, ios_base::buffer_size_,
+                                   integral_format_(fmt, base, "ll", true), v);
 
                 return put_adjusted_buffer_(it, base, fill, ret);
             }
 
             iter_type do_put(iter_type it, ios_base& base, char_type fill, unsigned long v) const
             {
-                auto basefield = (base.flags() & ios_base::basefield);
-                auto uppercase = (base.flags() & ios_base::uppercase);
-
-                int ret{};
-                if (basefield == ios_base::oct)
-                    ret = snprintf(base.buffer_, ios_base::buffer_size_, "%lo", v);
-                else if ((basefield == ios_base::hex) && !uppercase)
-                    ret = snprintf(base.buffer_, ios_base::buffer_size_, "%lx", v);
-                else if (basefield == ios_base::hex)
-                    ret = snprintf(base.buffer_, ios_base::buffer_size_, "%lX", v);
-                else
-                    ret = snprintf(base.buffer_, ios_base::buffer_size_, "%lu", v);
+                char fmt[format_size_];
+                int ret = snprintf(base.buffer_, ios_base::buffer_size_,
+                                   integral_format_(fmt, base, "l", false), v);
 
                 return put_adjusted_buffer_(it, base, fill, ret);
             }
 
             iter_type do_put(iter_type it, ios_base& base, char_type fill, unsigned long long v) const
             {
-                auto basefield = (base.flags() & ios_base::basefield);
-                auto uppercase = (base.flags() & ios_base::uppercase);
-
-                // TODO: showbase
-                int ret{};
-                if (basefield == ios_base::oct)
-                    ret = snprintf(base.buffer_, ios_base::buffer_size_, "%llo", v);
-                else if ((basefield == ios_base::hex) && !uppercase)
-                    ret = snprintf(base.buffer_, ios_base::buffer_size_, "%llx", v);
-                else if (basefield == ios_base::hex)
-                    ret = snprintf(base.buffer_, ios_base::buffer_size_, "%llX", v);
-                else
-                    ret = snprintf(base.buffer_, ios_base::buffer_size_, "%llu", v);
+                char fmt[format_size_];
+                int ret = snprintf(base.buffer_, ios_base::buffer_size_,
+                                   integral_format_(fmt, base, "ll", false), v);
 
                 return put_adjusted_buffer_(it, base, fill, ret);
             }
 
             iter_type do_put(iter_type it, ios_base& base, char_type fill, double v) const
             {
-                auto floatfield = (base.flags() & ios_base::floatfield);
-                auto uppercase = (base.flags() & ios_base::uppercase);
-
-                // TODO: showbase
-                // TODO: precision
-                int ret{};
-                if (floatfield == ios_base::fixed)
-                    ret = snprintf(base.buffer_, ios_base::buffer_size_, "%f", v);
-                else if (floatfield == ios_base::scientific && !uppercase)
-                    ret = snprintf(base.buffer_, ios_base::buffer_size_, "%e", v);
-                else if (floatfield == ios_base::scientific)
-                    ret = snprintf(base.buffer_, ios_base::buffer_size_, "%E", v);
-                else if (floatfield == (ios_base::fixed | ios_base::scientific) && !uppercase)
-                    ret = snprintf(base.buffer_, ios_base::buffer_size_, "%a", v);
-                else if (floatfield == (ios_base::fixed | ios_base::scientific))
-                    ret = snprintf(base.buffer_, ios_base::buffer_size_, "%A", v);
-                else if (!uppercase)
-                    ret = snprintf(base.buffer_, ios_base::buffer_size_, "%g", v);
-                else
-                    ret = snprintf(base.buffer_, ios_base::buffer_size_, "%G", v);
+                char fmt[format_size_];
+                auto prec = floating_precision_(base);
+                int ret = snprintf(base.buffer_, ios_base::buffer_size_,
+                                   floating_format_(fmt, base, ""), prec, v);
 
                 return put_adjusted_buffer_(it, base, fill, ret);
             }
@@ -215,38 +162,102 @@ namespace std
                 /**
                  * Note: Long double is not support at the moment in snprintf.
                  */
+                char fmt[format_size_];
+                auto prec = floating_precision_(base);
+                int ret = snprintf(base.buffer_, ios_base::buffer_size_,
+                                   floating_format_(fmt, base, "L"), prec, v);
+
+                return put_adjusted_buffer_(it, base, fill, ret);
+            }
+
+            iter_type do_put(iter_type it, ios_base& base, char_type fill, const void* v) const
+            {
+                int ret = snprintf(base.buffer_, ios_base::buffer_size_, "%p", v);
+
+                return put_adjusted_buffer_(it, base, fill, ret);
+            }
+
+        private:
+            /**
+             * Enough for '%', the flags, the precision, the longest
+             * length modifier, the conversion and the terminator.
+             */
+            static constexpr size_t format_size_{10};
+
+            static const char* integral_format_(char* fmt, ios_base& base,
+                                                const char* length, bool is_signed)
+            {
+                auto basefield = (base.flags() & ios_base::basefield);
+                auto uppercase = (base.flags() & ios_base::uppercase);
+                auto decimal = (basefield != ios_base::oct && basefield != ios_base::hex);
+
+                auto p = fmt;
+                *p++ = '%';
+                if (decimal && is_signed && (base.flags() & ios_base::showpos))
+                    *p++ = '+';
+                if (!decimal && (base.flags() & ios_base::showbase))
+                    *p++ = '#';
+                while (*length)
+                    *p++ = *length++;
+
+                if (basefield == ios_base::oct)
+                    *p++ = 'o';
+                else if (basefield == ios_base::hex)
+                    *p++ = uppercase ? 'X' : 'x';
+                else
+                    *p++ = is_signed ? 'd' : 'u';
+                *p = '\0';
+
+                return fmt;
+            }
+
+            /**
+             * The returned format always takes the precision as
+             * an argument, see floating_precision_.
+             */
+            static const char* floating_format_(char* fmt, ios_base& base,
+                                                const char* length)
+            {
                 auto floatfield = (base.flags() & ios_base::floatfield);
                 auto uppercase = (base.flags() & ios_base::uppercase);
 
-                // TODO: showbase
-                // TODO: precision
-                int ret{};
+                auto p = fmt;
+                *p++ = '%';
+                if (base.flags() & ios_base::showpos)
+                    *p++ = '+';
+                if (base.flags() & ios_base::showpoint)
+                    *p++ = '#';
+                *p++ = '.';
+                *p++ = '*';
+                while (*length)
+                    *p++ = *length++;
+
                 if (floatfield == ios_base::fixed)
-                    ret = snprintf(base.buffer_, ios_base::buffer_size_, "%Lf", v);
-                else if (floatfield == ios_base::scientific && !uppercase)
-                    ret = snprintf(base.buffer_, ios_base::buffer_size_, "%Le", v);
+                    *p++ = 'f';
                 else if (floatfield == ios_base::scientific)
-                    ret = snprintf(base.buffer_, ios_base::buffer_size_, "%LE", v);
-                else if (floatfield == (ios_base::fixed | ios_base::scientific) && !uppercase)
-                    ret = snprintf(base.buffer_, ios_base::buffer_size_, "%La", v);
+                    *p++ = uppercase ? 'E' : 'e';
                 else if (floatfield == (ios_base::fixed | ios_base::scientific))
-                    ret = snprintf(base.buffer_, ios_base::buffer_size_, "%LA", v);
-                else if (!uppercase)
-                    ret = snprintf(base.buffer_, ios_base::buffer_size_, "%Lg", v);
+                    *p++ = uppercase ? 'A' : 'a';
                 else
-                    ret = snprintf(base.buffer_, ios_base::buffer_size_, "%LG", v);
+                    *p++ = uppercase ? 'G' : 'g';
+                *p = '\0';
 
-                return put_adjusted_buffer_(it, base, fill, ret);
+                return fmt;
             }
 
-            iter_type do_put(iter_type it, ios_base& base, char_type fill, const void* v) const
+            static int floating_precision_(ios_base& base)
             {
-                int ret = snprintf(base.buffer_, ios_base::buffer_size_, "%p", v);
+                /**
+                 * Hexfloat output is exact, negative precision
+                 * makes snprintf use its default.
+                 */
+                auto floatfield = (base.flags() & ios_base::floatfield);
+                if (floatfield == (ios_base::fixed | ios_base::scientific))
+                    return -1;
 
-                return put_adjusted_buffer_(it, base, fill, ret);
+                return static_cast<int>(base.precision());
             }
 
-        private:
             iter_type put_adjusted_buffer_(iter_type it, ios_base& base, char_type fill, size_t size) const
             {
                 auto adjustfield = (base.flags() & ios_base::adjustfield);
@@ -53,17 +53,26 @@ namespace std
         struct has_allocator_type<T, void_t<typename T::allocator_type>>
             : true_type
         { /* DUMMY BODY */ };
+
+        template<class T, class Alloc, class = void>
+        struct uses_allocator_impl: false_type
+        { /* DUMMY BODY */ };
+
+        template<class T, class Alloc>
+        struct uses_allocator_impl<T, Alloc, void_t<typename T::allocator_type>>
+            : aux::value_is<
+            bool, is_convertible_v<Alloc, typename T::allocator_type>
+        >
+        { /* DUMMY BODY */ };
     }
 
     template<class T, class Alloc>
-    struct uses_allocator
-        : aux::value_is<
-        bool, aux::has_allocator_type<T>::value && is_convertible_v<
-            Alloc, typename T::allocator_type
-        >
-    >
+    struct uses_allocator: aux::uses_allocator_impl<T, Alloc>
     { /* DUMMY BODY */ };
 
+    template<class T, class Alloc>
+    inline constexpr bool uses_allocator_v = uses_allocator<T, Alloc>::value;
+
     /**
      * 20.7.8, allocator traits:
      */
@@ -87,7 +96,7 @@ namespace std
         using is_always_equal                        = typename aux::alloc_get_always_equal<Alloc>::type;
 
         template<class T>
-        using rebind_alloc = typename aux::alloc_get_rebind_alloc<Alloc, T>;
+        using rebind_alloc = typename aux::alloc_get_rebind_alloc<Alloc, T>::type;
 
         template<class T>
         using rebind_traits = allocator_traits<rebind_alloc<T>>;
@@ -250,6 +259,23 @@ namespace std
     {
         return false;
     }
+
+    namespace aux
+    {
+        /**
+         * Objects of a trivially relocatable type can be moved
+         * to a different address by copying their bytes, which
+         * allows containers to grow their storage using realloc.
+         * Types that are not trivially copyable but do not keep
+         * pointers to themselves can specialize this.
+         */
+        template<class T>
+        struct is_trivially_relocatable: aux::value_is<
+            bool,
+            is_trivially_copyable<T>::value &&
+            is_trivially_destructible<T>::value>
+        { /* DUMMY BODY */ };
+    }
 }
 
 #endif
@@ -29,6 +29,7 @@
 #ifndef LIBCPP_BITS_MEMORY_SHARED_PAYLOAD
 #define LIBCPP_BITS_MEMORY_SHARED_PAYLOAD
 
+#include <atomic>
 #include <cinttypes>
 #include <utility>
 
@@ -42,10 +43,6 @@ namespace std
 
 namespace std::aux
 {
-    /**
-     * At the moment we do not have atomics, change this
-     * to std::atomic<long> once we do.
-     */
     using refcount_t = long;
 
     /**
@@ -143,17 +140,21 @@ namespace std::aux
 
             void increment() noexcept override
             {
-                __atomic_add_fetch(&refcount_, 1, __ATOMIC_ACQ_REL);
+                /**
+                 * New references are only made from existing ones,
+                 * so the increment itself needs no ordering.
+                 */
+                refcount_.fetch_add(1, memory_order_relaxed);
             }
 
             void increment_weak() noexcept override
             {
-                __atomic_add_fetch(&weak_refcount_, 1, __ATOMIC_ACQ_REL);
+                weak_refcount_.fetch_add(1, memory_order_relaxed);
             }
 
             bool decrement() noexcept override
             {
-                if (__atomic_sub_fetch(&refcount_, 1, __ATOMIC_ACQ_REL) == 0)
+                if (refcount_.fetch_sub(1, memory_order_acq_rel) == 1)
                 {
                     /**
                      * First call to destroy() will delete the held object,
@@ -170,17 +171,17 @@ namespace std::aux
 
             bool decrement_weak() noexcept override
             {
-                return __atomic_sub_fetch(&weak_refcount_, 1, __ATOMIC_ACQ_REL) == 0 && refs() == 0;
+                return weak_refcount_.fetch_sub(1, memory_order_acq_rel) == 1 && refs() == 0;
             }
 
             refcount_t refs() const noexcept override
             {
-                return __atomic_load_n(&refcount_, __ATOMIC_RELAXED);
+                return refcount_.load(memory_order_relaxed);
             }
 
             refcount_t weak_refs() const noexcept override
             {
-                return __atomic_load_n(&weak_refcount_, __ATOMIC_RELAXED);
+                return weak_refcount_.load(memory_order_relaxed);
             }
 
             bool expired() const noexcept override
@@ -193,9 +194,8 @@ namespace std::aux
                 refcount_t rfs = refs();
                 while (rfs != 0L)
                 {
-                    if (__atomic_compare_exchange_n(&refcount_, &rfs, rfs + 1,
-                                                    true, __ATOMIC_RELAXED,
-                                                    __ATOMIC_RELAXED))
+                    if (refcount_.compare_exchange_weak(rfs, rfs + 1,
+                                                        memory_order_relaxed))
                     {
                         return this;
                     }
@@ -215,8 +215,8 @@ namespace std::aux
              * can't decrement the weak_refcount_ to
              * zero with shared_ptrs using this object.
              */
-            refcount_t refcount_;
-            refcount_t weak_refcount_;
+            atomic<refcount_t> refcount_;
+            atomic<refcount_t> weak_refcount_;
     };
 }
 
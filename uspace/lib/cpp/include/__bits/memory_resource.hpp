@@ -0,0 +1,414 @@
+/*
+ * Copyright (c) 2019 Jaroslav Jindrak
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * - Redistributions of source code must retain the above copyright
+ *   notice, this list of conditions and the following disclaimer.
+ * - Redistributions in binary form must reproduce the above copyright
+ *   notice, this list of conditions and the following disclaimer in the
+ *   documentation and/or other materials provided with the distribution.
+ * - The name of the author may not be used to endorse or promote products
+ *   derived from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHOR ``AS IS'' AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+ * OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+ * IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT
+ * NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF
+ * THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef LIBCPP_BITS_MEMORY_RESOURCE
+#define LIBCPP_BITS_MEMORY_RESOURCE
+
+#include <__bits/memory/allocator_arg.hpp>
+#include <__bits/memory/allocator_traits.hpp>
+#include <__bits/thread/threading.hpp>
+#include <cstddef>
+#include <cstdint>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+namespace std::pmr
+{
+    /**
+     * 23.12.2, class memory_resource:
+     */
+
+    class memory_resource
+    {
+        public:
+            /**
+             * Note: We do not have max_align_t at the moment,
+             *       long double has the strictest alignment
+             *       among the fundamental types we support.
+             */
+            static constexpr size_t max_align = alignof(long double);
+
+            virtual ~memory_resource();
+
+            void* allocate(size_t bytes, size_t alignment = max_align)
+            {
+                return do_allocate(bytes, alignment);
+            }
+
+            void deallocate(void* ptr, size_t bytes, size_t alignment = max_align)
+            {
+                do_deallocate(ptr, bytes, alignment);
+            }
+
+            bool is_equal(const memory_resource& other) const noexcept
+            {
+                return do_is_equal(other);
+            }
+
+        private:
+            virtual void* do_allocate(size_t bytes, size_t alignment) = 0;
+            virtual void do_deallocate(void* ptr, size_t bytes, size_t alignment) = 0;
+            virtual bool do_is_equal(const memory_resource& other) const noexcept = 0;
+    };
+
+    inline bool operator==(const memory_resource& lhs, const memory_resource& rhs) noexcept
+    {
+        return &lhs == &rhs || lhs.is_equal(rhs);
+    }
+
+    inline bool operator!=(const memory_resource& lhs, const memory_resource& rhs) noexcept
+    {
+        return !(lhs == rhs);
+    }
+
+    /**
+     * 23.12.5, access to program-wide memory_resource objects:
+     */
+
+    memory_resource* new_delete_resource() noexcept;
+    memory_resource* null_memory_resource() noexcept;
+    memory_resource* set_default_resource(memory_resource* res) noexcept;
+    memory_resource* get_default_resource() noexcept;
+
+    /**
+     * 23.12.3, class template polymorphic_allocator:
+     */
+
+    template<class T>
+    class polymorphic_allocator
+    {
+        public:
+            using value_type = T;
+
+            polymorphic_allocator() noexcept
+                : resource_{get_default_resource()}
+            { /* DUMMY BODY */ }
+
+            polymorphic_allocator(memory_resource* res)
+                : resource_{res}
+            { /* DUMMY BODY */ }
+
+            polymorphic_allocator(const polymorphic_allocator&) = default;
+
+            template<class U>
+            polymorphic_allocator(const polymorphic_allocator<U>& other) noexcept
+                : resource_{other.resource()}
+            { /* DUMMY BODY */ }
+
+            /**
+             * Note: The standard deletes the assignment operator,
+             *       but our containers assign and swap allocators
+             *       together with their storage, so we keep it.
+             *       Memory always goes back to the resource it was
+             *       allocated from.
+             */
+            polymorphic_allocator& operator=(const polymorphic_allocator&) = default;
+
+            T* allocate(size_t n)
+            {
+                return static_cast<T*>(
+                    resource_->allocate(n * sizeof(T), alignof(T))
+                );
+            }
+
+            void deallocate(T* ptr, size_t n)
+            {
+                resource_->deallocate(ptr, n * sizeof(T), alignof(T));
+            }
+
+            /**
+             * Uses-allocator construction (20.7.7.2), so that
+             * elements that are themselves pmr containers
+             * allocate from the same resource.
+             */
+            template<class U, class... Args>
+            void construct(U* ptr, Args&&... args)
+            {
+                if constexpr (!uses_allocator_v<U, polymorphic_allocator>)
+                    ::new(static_cast<void*>(ptr)) U(forward<Args>(args)...);
+                else if constexpr (is_constructible_v<U, allocator_arg_t,
+                                                      const polymorphic_allocator&, Args...>)
+                    ::new(static_cast<void*>(ptr)) U(allocator_arg, *this, forward<Args>(args)...);
+                else
+                    ::new(static_cast<void*>(ptr)) U(forward<Args>(args)..., *this);
+            }
+
+            template<class U>
+            void destroy(U* ptr)
+            {
+                ptr->~U();
+            }
+
+            polymorphic_allocator select_on_container_copy_construction() const
+            {
+                return polymorphic_allocator{};
+            }
+
+            memory_resource* resource() const
+            {
+                return resource_;
+            }
+
+        private:
+            memory_resource* resource_;
+    };
+
+    template<class T1, class T2>
+    bool operator==(const polymorphic_allocator<T1>& lhs,
+                    const polymorphic_allocator<T2>& rhs) noexcept
+    {
+        return *lhs.resource() == *rhs.resource();
+    }
+
+    template<class T1, class T2>
+    bool operator!=(const polymorphic_allocator<T1>& lhs,
+                    const polymorphic_allocator<T2>& rhs) noexcept
+    {
+        return !(lhs == rhs);
+    }
+
+    /**
+     * 23.12.5, pool resource classes:
+     */
+
+    struct pool_options
+    {
+        size_t max_blocks_per_chunk = 0;
+        size_t largest_required_pool_block = 0;
+    };
+
+    /**
+     * Keeps one pool per power of two block size, each pool
+     * hands out blocks from chunks requested from the upstream
+     * resource and keeps freed blocks in an intrusive free list.
+     * Chunks grow geometrically up to max_blocks_per_chunk blocks
+     * and are only returned upstream on release() or destruction.
+     * Requests larger than largest_required_pool_block go directly
+     * to the upstream resource.
+     */
+    class unsynchronized_pool_resource: public memory_resource
+    {
+        public:
+            unsynchronized_pool_resource(const pool_options& opts, memory_resource* upstream);
+
+            unsynchronized_pool_resource()
+                : unsynchronized_pool_resource{pool_options{}, get_default_resource()}
+            { /* DUMMY BODY */ }
+
+            explicit unsynchronized_pool_resource(memory_resource* upstream)
+                : unsynchronized_pool_resource{pool_options{}, upstream}
+            { /* DUMMY BODY */ }
+
+            explicit unsynchronized_pool_resource(const pool_options& opts)
+                : unsynchronized_pool_resource{opts, get_default_resource()}
+            { /* DUMMY BODY */ }
+
+            unsynchronized_pool_resource(const unsynchronized_pool_resource&) = delete;
+            unsynchronized_pool_resource& operator=(const unsynchronized_pool_resource&) = delete;
+
+            virtual ~unsynchronized_pool_resource();
+
+            void release();
+
+            memory_resource* upstream_resource() const
+            {
+                return upstream_;
+            }
+
+            pool_options options() const
+            {
+                return options_;
+            }
+
+        protected:
+            void* do_allocate(size_t bytes, size_t alignment) override;
+            void do_deallocate(void* ptr, size_t bytes, size_t alignment) override;
+            bool do_is_equal(const memory_resource& other) const noexcept override;
+
+        private:
+            struct chunk
+            {
+                chunk* next;
+                size_t bytes;
+                size_t alignment;
+            };
+
+            struct block
+            {
+                block* next;
+            };
+
+            struct pool
+            {
+                block* free;
+                chunk* chunks;
+                size_t next_blocks;
+            };
+
+            /**
+             * Header placed in front of oversized allocations,
+             * they are kept in a doubly linked list so that
+             * release() can return them upstream.
+             */
+            struct oversized
+            {
+                oversized* prev;
+                oversized* next;
+                size_t bytes;
+                size_t alignment;
+                size_t offset;
+            };
+
+            static constexpr size_t min_block_shift_ = 3;
+            static constexpr size_t max_pools_ = 14;
+
+            memory_resource* upstream_;
+            pool_options options_;
+            size_t pool_count_;
+            pool pools_[max_pools_];
+            oversized* oversized_;
+
+            size_t pool_index_(size_t bytes, size_t alignment) const;
+            void refill_(pool& p, size_t block_size);
+    };
+
+    /**
+     * Same as unsynchronized_pool_resource, but guarded by
+     * a fibril mutex so that it can be shared between fibrils
+     * running on different threads.
+     */
+    class synchronized_pool_resource: public memory_resource
+    {
+        public:
+            synchronized_pool_resource(const pool_options& opts, memory_resource* upstream);
+
+            synchronized_pool_resource()
+                : synchronized_pool_resource{pool_options{}, get_default_resource()}
+            { /* DUMMY BODY */ }
+
+            explicit synchronized_pool_resource(memory_resource* upstream)
+                : synchronized_pool_resource{pool_options{}, upstream}
+            { /* DUMMY BODY */ }
+
+            explicit synchronized_pool_resource(const pool_options& opts)
+                : synchronized_pool_resource{opts, get_default_resource()}
+            { /* DUMMY BODY */ }
+
+            synchronized_pool_resource(const synchronized_pool_resource&) = delete;
+            synchronized_pool_resource& operator=(const synchronized_pool_resource&) = delete;
+
+            virtual ~synchronized_pool_resource();
+
+            void release();
+
+            memory_resource* upstream_resource() const
+            {
+                return pool_.upstream_resource();
+            }
+
+            pool_options options() const
+            {
+                return pool_.options();
+            }
+
+        protected:
+            void* do_allocate(size_t bytes, size_t alignment) override;
+            void do_deallocate(void* ptr, size_t bytes, size_t alignment) override;
+            bool do_is_equal(const memory_resource& other) const noexcept override;
+
+        private:
+            unsynchronized_pool_resource pool_;
+            aux::mutex_t mtx_;
+    };
+
+    /**
+     * 23.12.6, class monotonic_buffer_resource:
+     * Hands out memory by bumping a pointer through the current
+     * buffer, deallocation is a no-op and everything is returned
+     * upstream at once in release() or in the destructor. Each
+     * new buffer is twice the size of the previous one.
+     */
+    class monotonic_buffer_resource: public memory_resource
+    {
+        public:
+            explicit monotonic_buffer_resource(memory_resource* upstream);
+
+            monotonic_buffer_resource(size_t initial_size, memory_resource* upstream);
+
+            monotonic_buffer_resource(void* buffer, size_t size, memory_resource* upstream);
+
+            monotonic_buffer_resource()
+                : monotonic_buffer_resource{get_default_resource()}
+            { /* DUMMY BODY */ }
+
+            explicit monotonic_buffer_resource(size_t initial_size)
+                : monotonic_buffer_resource{initial_size, get_default_resource()}
+            { /* DUMMY BODY */ }
+
+            monotonic_buffer_resource(void* buffer, size_t size)
+                : monotonic_buffer_resource{buffer, size, get_default_resource()}
+            { /* DUMMY BODY */ }
+
+            monotonic_buffer_resource(const monotonic_buffer_resource&) = delete;
+            monotonic_buffer_resource& operator=(const monotonic_buffer_resource&) = delete;
+
+            virtual ~monotonic_buffer_resource();
+
+            void release();
+
+            memory_resource* upstream_resource() const
+            {
+                return upstream_;
+            }
+
+        protected:
+            void* do_allocate(size_t bytes, size_t alignment) override;
+            void do_deallocate(void* ptr, size_t bytes, size_t alignment) override;
+            bool do_is_equal(const memory_resource& other) const noexcept override;
+
+        private:
+            struct chunk
+            {
+                chunk* next;
+                size_t bytes;
+            };
+
+            static constexpr size_t default_size_ = 1024;
+
+            memory_resource* upstream_;
+            void* initial_buffer_;
+            size_t initial_size_;
+            char* current_;
+            size_t space_;
+            size_t next_size_;
+            chunk* chunks_;
+    };
+}
+
+#endif
@@ -0,0 +1,1123 @@
+/*
+ * Copyright (c) 2019 Jaroslav Jindrak
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * - Redistributions of source code must retain the above copyright
+ *   notice, this list of conditions and the following disclaimer.
+ * - Redistributions in binary form must reproduce the above copyright
+ *   notice, this list of conditions and the following disclaimer in the
+ *   documentation and/or other materials provided with the distribution.
+ * - The name of the author may not be used to endorse or promote products
+ *   derived from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHOR ``AS IS'' AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+ * OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+ * IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT
+ * NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF
+ * THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef LIBCPP_BITS_REGEX_COMPILER
+#define LIBCPP_BITS_REGEX_COMPILER
+
+#include <__bits/regex/constants.hpp>
+#include <__bits/thread/threading.hpp>
+#include <cstdint>
+#include <map>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace std::aux
+{
+    /**
+     * Patterns are compiled to a program for a Thompson NFA,
+     * each instruction either consumes a character, tests an
+     * assertion or is an epsilon transition (split, jump, save).
+     * A split prefers the transition to x over the one to y,
+     * which is how ECMAScript's priority of alternatives and
+     * greedy or lazy quantifiers is encoded.
+     */
+    enum class regex_opcode: uint8_t
+    {
+        match,
+        literal,
+        any,
+        char_class,
+        split,
+        jump,
+        save,
+        line_begin,
+        line_end,
+        word_boundary,
+        backref,
+        lookahead,
+        progress_mark,
+        progress_check
+    };
+
+    /**
+     * Meaning of the operands:
+     *   literal        - c is the (translated) character
+     *   char_class     - x is an index to the class table
+     *   split          - x is the preferred target, y the other one
+     *   jump           - x is the target
+     *   save           - x is the capture slot
+     *   word_boundary  - y is nonzero for \B
+     *   backref        - x is the group number
+     *   lookahead      - the subprogram starts right after this
+     *                    instruction and ends with match, x is the
+     *                    instruction after it, y is nonzero for (?!
+     *   progress_*     - x is the slot that guards against empty
+     *                    iterations of a loop
+     */
+    template<class Char>
+    struct regex_instruction
+    {
+        regex_opcode op;
+        Char c;
+        size_t x;
+        size_t y;
+    };
+
+    inline constexpr size_t regex_max_program_size{100'000};
+
+    template<class Char>
+    bool regex_is_line_terminator(Char c)
+    {
+        return c == Char('\n') || c == Char('\r')
+            || (sizeof(Char) > 1 && (static_cast<uint32_t>(c) == 0x2028
+                                     || static_cast<uint32_t>(c) == 0x2029));
+    }
+
+    template<class Char>
+    bool regex_is_word(Char c)
+    {
+        return (c >= Char('a') && c <= Char('z')) || (c >= Char('A') && c <= Char('Z'))
+            || (c >= Char('0') && c <= Char('9')) || c == Char('_');
+    }
+
+    /**
+     * Bracket expressions and the class escapes. The result for
+     * the first 256 characters is precomputed into a bitmap so
+     * that matching single byte strings is a single lookup.
+     */
+    template<class Char, class Traits>
+    class regex_char_class
+    {
+        public:
+            using char_class_type = typename Traits::char_class_type;
+
+            regex_char_class()
+                : ranges_{}, classes_{}, negated_classes_{},
+                  negate_{}, table_{}
+            { /* DUMMY BODY */ }
+
+            void add_char(Char c)
+            {
+                ranges_.emplace_back(c, c);
+            }
+
+            void add_range(Char first, Char last)
+            {
+                ranges_.emplace_back(first, last);
+            }
+
+            void add_class(char_class_type cls)
+            {
+                classes_ |= cls;
+            }
+
+            void add_negated_class(char_class_type cls)
+            {
+                negated_classes_.push_back(cls);
+            }
+
+            void negate()
+            {
+                negate_ = !negate_;
+            }
+
+            void finalize(const Traits& traits, bool icase)
+            {
+                for (unsigned int i = 0; i < 256; ++i)
+                {
+                    auto c = static_cast<Char>(i);
+                    if (static_cast<make_unsigned_t<Char>>(c) != i)
+                        break;
+
+                    if (test_(c, traits, icase))
+                        table_[i / 32] |= (uint32_t{1} << (i % 32));
+                }
+            }
+
+            bool matches(Char c, const Traits& traits, bool icase) const
+            {
+                auto idx = static_cast<make_unsigned_t<Char>>(c);
+                if (idx < 256)
+                    return table_[idx / 32] & (uint32_t{1} << (idx % 32));
+                else
+                    return test_(c, traits, icase);
+            }
+
+        private:
+            vector<pair<Char, Char>> ranges_;
+            char_class_type classes_;
+            vector<char_class_type> negated_classes_;
+            bool negate_;
+            uint32_t table_[8];
+
+            bool test_(Char c, const Traits& traits, bool icase) const
+            {
+                bool res = test_case_(c, traits);
+                if (!res && icase)
+                {
+                    res = test_case_(traits.translate_nocase(c), traits)
+                       || test_case_(to_upper_(c), traits);
+                }
+
+                return res != negate_;
+            }
+
+            bool test_case_(Char c, const Traits& traits) const
+            {
+                for (const auto& range: ranges_)
+                {
+                    if (range.first <= c && c <= range.second)
+                        return true;
+                }
+
+                if (classes_ && traits.isctype(c, classes_))
+                    return true;
+
+                for (const auto& cls: negated_classes_)
+                {
+                    if (!traits.isctype(c, cls))
+                        return true;
+                }
+
+                return false;
+            }
+
+            static Char to_upper_(Char c)
+            {
+                if (c >= Char('a') && c <= Char('z'))
+                    return static_cast<Char>(c - Char('a') + Char('A'));
+                else
+                    return c;
+            }
+    };
+
+    /**
+     * One state of the lazily built DFA, identified by the set
+     * of instructions the NFA threads are at (the kernel). The
+     * transitions are filled in as they are first taken.
+     */
+    struct regex_dfa_state
+    {
+        vector<size_t> key;
+        vector<size_t> leaves;
+        bool match;
+        bool end_match;
+        bool restart;
+        int next[256];
+    };
+
+    struct regex_dfa_cache
+    {
+        vector<regex_dfa_state> states{};
+        map<vector<size_t>, int> index{};
+        size_t flushes{};
+
+        /**
+         * Initial states for starting at a line beginning
+         * and elsewhere, -1 until they are built.
+         */
+        int initial[2]{-1, -1};
+    };
+
+    template<class Char, class Traits>
+    struct regex_program
+    {
+        regex_program()
+            : code{}, classes{}, traits{}, groups{}, slots{},
+              icase{}, multiline{}, backtrack{}, dfa{},
+              dfa_caches{}, dfa_mutex{}
+        {
+            threading::mutex::init(dfa_mutex);
+        }
+
+        vector<regex_instruction<Char>> code;
+        vector<regex_char_class<Char, Traits>> classes;
+        Traits traits;
+
+        /**
+         * Number of marked subexpressions (without the
+         * whole match) and of all slots, which are the pairs
+         * of capture positions followed by the loop guards.
+         */
+        size_t groups;
+        size_t slots;
+
+        bool icase;
+        bool multiline;
+
+        /**
+         * Backreferences and lookaheads require the backtracking
+         * executor, other programs run on the Pike VM and if the
+         * remaining assertions allow it, on the lazy DFA.
+         */
+        bool backtrack;
+        bool dfa;
+
+        /**
+         * One cache for unanchored and one for anchored matching,
+         * shared by all users of the regex.
+         */
+        mutable regex_dfa_cache dfa_caches[2];
+        mutable mutex_t dfa_mutex;
+    };
+
+    template<class Char, class Traits>
+    class regex_compiler
+    {
+        public:
+            using program_type = regex_program<Char, Traits>;
+            using instruction_type = regex_instruction<Char>;
+            using fragment_type = vector<instruction_type>;
+            using flag_type = regex_constants::syntax_option_type;
+            using char_class_type = typename Traits::char_class_type;
+
+            regex_compiler(const Char* first, const Char* last,
+                           flag_type flags, program_type& prog)
+                : first_{first}, curr_{first}, last_{last}, flags_{flags},
+                  prog_{prog}, code_{prog.code}, groups_{}, progress_slots_{},
+                  max_backref_{}, anchors_{}, word_boundaries_{}, failed_{}
+            { /* DUMMY BODY */ }
+
+            bool compile()
+            {
+                prog_.icase = flags_ & regex_constants::icase;
+                prog_.multiline = flags_ & regex_constants::multiline;
+
+                emit_(regex_opcode::save, Char{}, 0);
+                parse_disjunction_();
+
+                if (!failed_ && curr_ != last_)
+                    error_(regex_constants::error_paren);
+                if (!failed_ && max_backref_ > groups_)
+                    error_(regex_constants::error_backref);
+                if (failed_)
+                    return false;
+
+                emit_(regex_opcode::save, Char{}, 1);
+                emit_(regex_opcode::match);
+
+                prog_.groups = groups_;
+                prog_.slots = 2 * (groups_ + 1) + progress_slots_;
+                for (auto& instr: code_)
+                {
+                    if (instr.op == regex_opcode::progress_mark ||
+                        instr.op == regex_opcode::progress_check)
+                        instr.x += 2 * (groups_ + 1);
+                }
+
+                for (auto& cls: prog_.classes)
+                    cls.finalize(prog_.traits, prog_.icase);
+
+                prog_.dfa = sizeof(Char) == 1 && !prog_.backtrack &&
+                            !word_boundaries_ && !(prog_.multiline && anchors_);
+
+                return true;
+            }
+
+        private:
+            const Char* first_;
+            const Char* curr_;
+            const Char* last_;
+            flag_type flags_;
+            program_type& prog_;
+            fragment_type& code_;
+
+            size_t groups_;
+            size_t progress_slots_;
+            size_t max_backref_;
+            bool anchors_;
+            bool word_boundaries_;
+            bool failed_;
+
+            static constexpr size_t unbounded_ = static_cast<size_t>(-1);
+
+            void error_(regex_constants::error_type code)
+            {
+                failed_ = true;
+                curr_ = last_;
+
+                throw regex_error{code};
+            }
+
+            bool at_end_() const
+            {
+                return curr_ == last_;
+            }
+
+            bool peek_(Char c) const
+            {
+                return curr_ != last_ && *curr_ == c;
+            }
+
+            bool consume_(Char c)
+            {
+                if (peek_(c))
+                {
+                    ++curr_;
+
+                    return true;
+                }
+                else
+                    return false;
+            }
+
+            size_t emit_(regex_opcode op, Char c = Char{}, size_t x = 0, size_t y = 0)
+            {
+                if (code_.size() >= regex_max_program_size)
+                    error_(regex_constants::error_complexity);
+
+                code_.push_back(instruction_type{op, c, x, y});
+
+                return code_.size() - 1;
+            }
+
+            static bool is_target_(regex_opcode op)
+            {
+                return op == regex_opcode::split || op == regex_opcode::jump
+                    || op == regex_opcode::lookahead;
+            }
+
+            /**
+             * Fragments only jump within themselves (or right
+             * behind their end), so they can be cut from the
+             * program and appended again at a different place
+             * by relocating their targets.
+             */
+            fragment_type take_(size_t start)
+            {
+                fragment_type res(code_.begin() + start, code_.end());
+                code_.erase(code_.begin() + start, code_.end());
+
+                for (auto& instr: res)
+                {
+                    if (is_target_(instr.op))
+                    {
+                        instr.x -= start;
+                        if (instr.op == regex_opcode::split)
+                            instr.y -= start;
+                    }
+                }
+
+                return res;
+            }
+
+            void append_(const fragment_type& frag)
+            {
+                auto base = code_.size();
+                if (base + frag.size() > regex_max_program_size)
+                {
+                    error_(regex_constants::error_complexity);
+
+                    return;
+                }
+
+                for (auto instr: frag)
+                {
+                    if (is_target_(instr.op))
+                    {
+                        instr.x += base;
+                        if (instr.op == regex_opcode::split)
+                            instr.y += base;
+                    }
+                    code_.push_back(instr);
+                }
+            }
+
+            /**
+             * Checks if the fragment can match the empty string,
+             * loops over such fragments need the progress guard.
+             */
+            static bool nullable_(const fragment_type& frag)
+            {
+                vector<bool> visited(frag.size() + 1, false);
+                vector<size_t> stack{0};
+
+                while (!stack.empty())
+                {
+                    auto pc = stack.back();
+                    stack.pop_back();
+
+                    if (pc == frag.size())
+                        return true;
+                    if (visited[pc])
+                        continue;
+                    visited[pc] = true;
+
+                    const auto& instr = frag[pc];
+                    switch (instr.op)
+                    {
+                        case regex_opcode::literal:
+                        case regex_opcode::any:
+                        case regex_opcode::char_class:
+                        case regex_opcode::match:
+                            break;
+                        case regex_opcode::jump:
+                            stack.push_back(instr.x);
+                            break;
+                        case regex_opcode::split:
+                            stack.push_back(instr.x);
+                            stack.push_back(instr.y);
+                            break;
+                        case regex_opcode::lookahead:
+                            stack.push_back(instr.x);
+                            break;
+                        default:
+                            stack.push_back(pc + 1);
+                            break;
+                    }
+                }
+
+                return false;
+            }
+
+            Char translate_(Char c) const
+            {
+                if (prog_.icase)
+                    return prog_.traits.translate_nocase(c);
+                else
+                    return prog_.traits.translate(c);
+            }
+
+            /**
+             * 28.13, ECMAScript grammar:
+             * Disjunction :: Alternative | Alternative '|' Disjunction
+             */
+            void parse_disjunction_()
+            {
+                auto start = code_.size();
+                parse_alternative_();
+                if (failed_ || !peek_(Char('|')))
+                    return;
+
+                vector<fragment_type> alternatives{};
+                alternatives.push_back(take_(start));
+                while (!failed_ && consume_(Char('|')))
+                {
+                    parse_alternative_();
+                    alternatives.push_back(take_(start));
+                }
+
+                if (failed_)
+                    return;
+
+                vector<size_t> jumps{};
+                for (size_t i = 0; i < alternatives.size(); ++i)
+                {
+                    if (i + 1 < alternatives.size())
+                    {
+                        auto split = emit_(regex_opcode::split, Char{}, code_.size() + 1);
+                        append_(alternatives[i]);
+                        jumps.push_back(emit_(regex_opcode::jump));
+                        code_[split].y = code_.size();
+                    }
+                    else
+                        append_(alternatives[i]);
+
+                    if (failed_)
+                        return;
+                }
+
+                for (auto jump: jumps)
+                    code_[jump].x = code_.size();
+            }
+
+            void parse_alternative_()
+            {
+                while (!failed_ && !at_end_() && !peek_(Char('|')) && !peek_(Char(')')))
+                    parse_term_();
+            }
+
+            void parse_term_()
+            {
+                if (consume_(Char('^')))
+                {
+                    anchors_ = true;
+                    emit_(regex_opcode::line_begin);
+                }
+                else if (consume_(Char('$')))
+                {
+                    anchors_ = true;
+                    emit_(regex_opcode::line_end);
+                }
+                else if (peek_(Char('\\')) && curr_ + 1 != last_ &&
+                         (curr_[1] == Char('b') || curr_[1] == Char('B')))
+                {
+                    word_boundaries_ = true;
+                    emit_(regex_opcode::word_boundary, Char{}, 0, curr_[1] == Char('B'));
+                    curr_ += 2;
+                }
+                else if (peek_(Char('(')) && last_ - curr_ > 2 && curr_[1] == Char('?') &&
+                         (curr_[2] == Char('=') || curr_[2] == Char('!')))
+                {
+                    bool negative = curr_[2] == Char('!');
+                    curr_ += 3;
+
+                    prog_.backtrack = true;
+                    auto look = emit_(regex_opcode::lookahead, Char{}, 0, negative);
+                    parse_disjunction_();
+                    if (!consume_(Char(')')))
+                    {
+                        error_(regex_constants::error_paren);
+
+                        return;
+                    }
+                    emit_(regex_opcode::match);
+                    code_[look].x = code_.size();
+                }
+                else
+                {
+                    auto start = code_.size();
+                    parse_atom_();
+                    if (!failed_)
+                        parse_quantifier_(start);
+                }
+            }
+
+            void parse_atom_()
+            {
+                auto c = *curr_++;
+                switch (c)
+                {
+                    case Char('.'):
+                        emit_(regex_opcode::any);
+                        break;
+                    case Char('('):
+                        parse_group_();
+                        break;
+                    case Char('['):
+                        parse_class_();
+                        break;
+                    case Char('\\'):
+                        parse_atom_escape_();
+                        break;
+                    case Char('*'):
+                    case Char('+'):
+                    case Char('?'):
+                    case Char('{'):
+                        error_(regex_constants::error_badrepeat);
+                        break;
+                    default:
+                        emit_(regex_opcode::literal, translate_(c));
+                        break;
+                }
+            }
+
+            void parse_group_()
+            {
+                bool capture{true};
+                if (peek_(Char('?')))
+                {
+                    if (curr_ + 1 == last_ || curr_[1] != Char(':'))
+                    {
+                        error_(regex_constants::error_paren);
+
+                        return;
+                    }
+
+                    curr_ += 2;
+                    capture = false;
+                }
+
+                if (flags_ & regex_constants::nosubs)
+                    capture = false;
+
+                size_t group{};
+                if (capture)
+                {
+                    group = ++groups_;
+                    emit_(regex_opcode::save, Char{}, 2 * group);
+                }
+
+                parse_disjunction_();
+                if (failed_)
+                    return;
+
+                if (!consume_(Char(')')))
+                {
+                    error_(regex_constants::error_paren);
+
+                    return;
+                }
+
+                if (capture)
+                    emit_(regex_opcode::save, Char{}, 2 * group + 1);
+            }
+
+            bool parse_decimal_(size_t& res)
+            {
+                if (at_end_() || prog_.traits.value(*curr_, 10) < 0)
+                    return false;
+
+                res = 0;
+                while (!at_end_() && prog_.traits.value(*curr_, 10) >= 0)
+                {
+                    res = res * 10 + prog_.traits.value(*curr_++, 10);
+                    if (res > regex_max_program_size)
+                    {
+                        error_(regex_constants::error_badbrace);
+
+                        return false;
+                    }
+                }
+
+                return true;
+            }
+
+            /**
+             * Quantifier :: QuantifierPrefix | QuantifierPrefix '?'
+             */
+            void parse_quantifier_(size_t start)
+            {
+                size_t min{}, max{};
+                if (consume_(Char('*')))
+                {
+                    min = 0;
+                    max = unbounded_;
+                }
+                else if (consume_(Char('+')))
+                {
+                    min = 1;
+                    max = unbounded_;
+                }
+                else if (consume_(Char('?')))
+                {
+                    min = 0;
+                    max = 1;
+                }
+                else if (consume_(Char('{')))
+                {
+                    if (!parse_decimal_(min))
+                    {
+                        if (!failed_)
+                            error_(regex_constants::error_badbrace);
+
+                        return;
+                    }
+
+                    max = min;
+                    if (consume_(Char(',')))
+                    {
+                        if (peek_(Char('}')))
+                            max = unbounded_;
+                        else if (!parse_decimal_(max))
+                        {
+                            if (!failed_)
+                                error_(regex_constants::error_badbrace);
+
+                            return;
+                        }
+                    }
+
+                    if (!consume_(Char('}')))
+                    {
+                        error_(regex_constants::error_brace);
+
+                        return;
+                    }
+
+                    if (max < min)
+                    {
+                        error_(regex_constants::error_badbrace);
+
+                        return;
+                    }
+                }
+                else
+                    return;
+
+                bool greedy = !consume_(Char('?'));
+                repeat_(start, min, max, greedy);
+            }
+
+            void repeat_(size_t start, size_t min, size_t max, bool greedy)
+            {
+                auto frag = take_(start);
+                bool nullable = nullable_(frag);
+
+                /**
+                 * A loop over a fragment that cannot match the empty
+                 * string can reuse the last mandatory copy.
+                 */
+                if (max == unbounded_ && min > 0 && !nullable)
+                {
+                    for (size_t i = 1; i < min && !failed_; ++i)
+                        append_(frag);
+
+                    auto loop = code_.size();
+                    append_(frag);
+                    auto split = emit_(regex_opcode::split, Char{}, loop);
+                    code_[split].y = code_.size();
+                    if (!greedy)
+                        swap(code_[split].x, code_[split].y);
+
+                    return;
+                }
+
+                for (size_t i = 0; i < min && !failed_; ++i)
+                    append_(frag);
+
+                if (failed_)
+                    return;
+
+                if (max == unbounded_)
+                {
+                    auto split = emit_(regex_opcode::split, Char{}, code_.size() + 1);
+                    size_t slot{};
+                    if (nullable)
+                    {
+                        slot = progress_slots_++;
+                        emit_(regex_opcode::progress_mark, Char{}, slot);
+                    }
+                    append_(frag);
+                    if (nullable)
+                        emit_(regex_opcode::progress_check, Char{}, slot);
+                    emit_(regex_opcode::jump, Char{}, split);
+
+                    code_[split].y = code_.size();
+                    if (!greedy)
+                        swap(code_[split].x, code_[split].y);
+                }
+                else
+                {
+                    vector<size_t> splits{};
+                    for (size_t i = min; i < max && !failed_; ++i)
+                    {
+                        splits.push_back(emit_(regex_opcode::split, Char{}, code_.size() + 1));
+                        append_(frag);
+                    }
+
+                    for (auto split: splits)
+                    {
+                        code_[split].y = code_.size();
+                        if (!greedy)
+                            swap(code_[split].x, code_[split].y);
+                    }
+                }
+            }
+
+            size_t add_class_()
+            {
+                prog_.classes.emplace_back();
+
+                return prog_.classes.size() - 1;
+            }
+
+            bool class_escape_(Char c, char_class_type& cls, bool& negated)
+            {
+                const Char* name{};
+                Char names[] = {Char('d'), Char('s'), Char('w')};
+                switch (c)
+                {
+                    case Char('d'): case Char('D'):
+                        name = names;
+                        break;
+                    case Char('s'): case Char('S'):
+                        name = names + 1;
+                        break;
+                    case Char('w'): case Char('W'):
+                        name = names + 2;
+                        break;
+                    default:
+                        return false;
+                }
+
+                cls = prog_.traits.lookup_classname(name, name + 1);
+                negated = c == Char('D') || c == Char('S') || c == Char('W');
+
+                return true;
+            }
+
+            bool parse_hex_(size_t digits, Char& res)
+            {
+                uint32_t value{};
+                for (size_t i = 0; i < digits; ++i)
+                {
+                    int digit = at_end_() ? -1 : prog_.traits.value(*curr_, 16);
+                    if (digit < 0)
+                        return false;
+
+                    value = value * 16 + digit;
+                    ++curr_;
+                }
+
+                res = static_cast<Char>(value);
+
+                return static_cast<uint32_t>(static_cast<make_unsigned_t<Char>>(res)) == value;
+            }
+
+            /**
+             * Parses the escapes that stand for a single character,
+             * this is shared by atoms and bracket expressions.
+             */
+            bool parse_character_escape_(Char c, Char& res)
+            {
+                switch (c)
+                {
+                    case Char('f'):
+                        res = Char('\f');
+                        return true;
+                    case Char('n'):
+                        res = Char('\n');
+                        return true;
+                    case Char('r'):
+                        res = Char('\r');
+                        return true;
+                    case Char('t'):
+                        res = Char('\t');
+                        return true;
+                    case Char('v'):
+                        res = Char('\v');
+                        return true;
+                    case Char('0'):
+                        if (!at_end_() && prog_.traits.value(*curr_, 10) >= 0)
+                            return false;
+                        res = Char{};
+                        return true;
+                    case Char('c'):
+                        if (at_end_() || !((*curr_ >= Char('a') && *curr_ <= Char('z')) ||
+                                           (*curr_ >= Char('A') && *curr_ <= Char('Z'))))
+                            return false;
+                        res = static_cast<Char>(*curr_++ % 32);
+                        return true;
+                    case Char('x'):
+                        return parse_hex_(2, res);
+                    case Char('u'):
+                        return parse_hex_(4, res);
+                    default:
+                        if (regex_is_word(c))
+                            return false;
+                        res = c;
+                        return true;
+                }
+            }
+
+            void parse_atom_escape_()
+            {
+                if (at_end_())
+                {
+                    error_(regex_constants::error_escape);
+
+                    return;
+                }
+
+                auto c = *curr_;
+                size_t group{};
+                if (c != Char('0') && parse_decimal_(group))
+                {
+                    prog_.backtrack = true;
+                    if (group > max_backref_)
+                        max_backref_ = group;
+                    emit_(regex_opcode::backref, Char{}, group);
+
+                    return;
+                }
+
+                ++curr_;
+                char_class_type cls{};
+                bool negated{};
+                if (class_escape_(c, cls, negated))
+                {
+                    auto idx = add_class_();
+                    if (negated)
+                        prog_.classes[idx].add_negated_class(cls);
+                    else
+                        prog_.classes[idx].add_class(cls);
+                    emit_(regex_opcode::char_class, Char{}, idx);
+
+                    return;
+                }
+
+                Char res{};
+                if (parse_character_escape_(c, res))
+                    emit_(regex_opcode::literal, translate_(res));
+                else
+                    error_(regex_constants::error_escape);
+            }
+
+            /**
+             * A single element of a bracket expression, either
+             * a character (returns true) or a class that has
+             * already been added to cls.
+             */
+            bool parse_class_atom_(regex_char_class<Char, Traits>& cls, Char& res)
+            {
+                if (at_end_())
+                {
+                    error_(regex_constants::error_brack);
+
+                    return false;
+                }
+
+                auto c = *curr_++;
+                if (c == Char('[') && !at_end_() &&
+                    (*curr_ == Char(':') || *curr_ == Char('.') || *curr_ == Char('=')))
+                {
+                    auto kind = *curr_++;
+                    auto name = curr_;
+                    while (curr_ + 1 < last_ && !(curr_[0] == kind && curr_[1] == Char(']')))
+                        ++curr_;
+
+                    if (curr_ + 1 >= last_)
+                    {
+                        error_(regex_constants::error_brack);
+
+                        return false;
+                    }
+
+                    auto name_end = curr_;
+                    curr_ += 2;
+
+                    if (kind == Char(':'))
+                    {
+                        auto mask = prog_.traits.lookup_classname(
+                            name, name_end, prog_.icase
+                        );
+                        if (!mask)
+                            error_(regex_constants::error_ctype);
+                        cls.add_class(mask);
+
+                        return false;
+                    }
+                    else
+                    {
+                        auto elem = prog_.traits.lookup_collatename(name, name_end);
+                        if (elem.size() != 1)
+                        {
+                            error_(regex_constants::error_collate);
+
+                            return false;
+                        }
+                        res = elem[0];
+
+                        return true;
+                    }
+                }
+                else if (c == Char('\\'))
+                {
+                    if (at_end_())
+                    {
+                        error_(regex_constants::error_escape);
+
+                        return false;
+                    }
+
+                    c = *curr_++;
+                    char_class_type mask{};
+                    bool negated{};
+                    if (class_escape_(c, mask, negated))
+                    {
+                        if (negated)
+                            cls.add_negated_class(mask);
+                        else
+                            cls.add_class(mask);
+
+                        return false;
+                    }
+                    else if (c == Char('b'))
+                    {
+                        res = Char('\b');
+
+                        return true;
+                    }
+                    else if (c == Char('-'))
+                    {
+                        res = c;
+
+                        return true;
+                    }
+                    else if (!parse_character_escape_(c, res))
+                        error_(regex_constants::error_escape);
+
+                    return !failed_;
+                }
+                else
+                {
+                    res = c;
+
+                    return true;
+                }
+            }
+
+            void parse_class_()
+            {
+                auto idx = add_class_();
+                regex_char_class<Char, Traits> cls{};
+
+                if (consume_(Char('^')))
+                    cls.negate();
+
+                while (!failed_)
+                {
+                    if (at_end_())
+                    {
+                        error_(regex_constants::error_brack);
+
+                        return;
+                    }
+
+                    if (consume_(Char(']')))
+                        break;
+
+                    Char first{};
+                    if (!parse_class_atom_(cls, first))
+                        continue;
+
+                    if (peek_(Char('-')) && curr_ + 1 != last_ && curr_[1] != Char(']'))
+                    {
+                        ++curr_;
+
+                        Char last{};
+                        if (parse_class_atom_(cls, last))
+                        {
+                            if (last < first)
+                            {
+                                error_(regex_constants::error_range);
+
+                                return;
+                            }
+
+                            cls.add_range(first, last);
+                        }
+                        else
+                        {
+                            cls.add_char(first);
+                            cls.add_char(Char('-'));
+                        }
+                    }
+                    else
+                        cls.add_char(first);
+                }
+
+                prog_.classes[idx] = move(cls);
+                emit_(regex_opcode::char_class, Char{}, idx);
+            }
+    };
+}
+
+#endif
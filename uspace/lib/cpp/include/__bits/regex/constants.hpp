@@ -0,0 +1,120 @@
+/*
+ * Copyright (c) 2019 Jaroslav Jindrak
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * - Redistributions of source code must retain the above copyright
+ *   notice, this list of conditions and the following disclaimer.
+ * - Redistributions in binary form must reproduce the above copyright
+ *   notice, this list of conditions and the following disclaimer in the
+ *   documentation and/or other materials provided with the distribution.
+ * - The name of the author may not be used to endorse or promote products
+ *   derived from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHOR ``AS IS'' AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+ * OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+ * IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT
+ * NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF
+ * THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef LIBCPP_BITS_REGEX_CONSTANTS
+#define LIBCPP_BITS_REGEX_CONSTANTS
+
+#include <__bits/trycatch.hpp>
+#include <cstdint>
+#include <stdexcept>
+
+namespace std
+{
+    /**
+     * 28.5, namespace std::regex_constants:
+     */
+
+    namespace regex_constants
+    {
+        /**
+         * 28.5.1, bitmask type syntax_option_type:
+         */
+
+        using syntax_option_type = uint16_t;
+
+        inline constexpr syntax_option_type icase      = 0b0000'0000'0000'0001;
+        inline constexpr syntax_option_type nosubs     = 0b0000'0000'0000'0010;
+        inline constexpr syntax_option_type optimize   = 0b0000'0000'0000'0100;
+        inline constexpr syntax_option_type collate    = 0b0000'0000'0000'1000;
+        inline constexpr syntax_option_type ECMAScript = 0b0000'0000'0001'0000;
+        inline constexpr syntax_option_type basic      = 0b0000'0000'0010'0000;
+        inline constexpr syntax_option_type extended   = 0b0000'0000'0100'0000;
+        inline constexpr syntax_option_type awk        = 0b0000'0000'1000'0000;
+        inline constexpr syntax_option_type grep       = 0b0000'0001'0000'0000;
+        inline constexpr syntax_option_type egrep      = 0b0000'0010'0000'0000;
+        inline constexpr syntax_option_type multiline  = 0b0000'0100'0000'0000;
+
+        /**
+         * 28.5.2, bitmask type match_flag_type:
+         */
+
+        using match_flag_type = uint16_t;
+
+        inline constexpr match_flag_type match_default     = 0b0000'0000'0000'0000;
+        inline constexpr match_flag_type match_not_bol     = 0b0000'0000'0000'0001;
+        inline constexpr match_flag_type match_not_eol     = 0b0000'0000'0000'0010;
+        inline constexpr match_flag_type match_not_bow     = 0b0000'0000'0000'0100;
+        inline constexpr match_flag_type match_not_eow     = 0b0000'0000'0000'1000;
+        inline constexpr match_flag_type match_any         = 0b0000'0000'0001'0000;
+        inline constexpr match_flag_type match_not_null    = 0b0000'0000'0010'0000;
+        inline constexpr match_flag_type match_continuous  = 0b0000'0000'0100'0000;
+        inline constexpr match_flag_type match_prev_avail  = 0b0000'0000'1000'0000;
+        inline constexpr match_flag_type format_default    = 0b0000'0000'0000'0000;
+        inline constexpr match_flag_type format_sed        = 0b0000'0001'0000'0000;
+        inline constexpr match_flag_type format_no_copy    = 0b0000'0010'0000'0000;
+        inline constexpr match_flag_type format_first_only = 0b0000'0100'0000'0000;
+
+        /**
+         * 28.5.3, implementation defined error_type:
+         */
+
+        enum error_type
+        {
+            error_collate,
+            error_ctype,
+            error_escape,
+            error_backref,
+            error_brack,
+            error_paren,
+            error_brace,
+            error_badbrace,
+            error_range,
+            error_space,
+            error_badrepeat,
+            error_complexity,
+            error_stack
+        };
+    }
+
+    /**
+     * 28.6, class regex_error:
+     */
+
+    class regex_error: public runtime_error
+    {
+        public:
+            explicit regex_error(regex_constants::error_type ecode);
+
+            regex_constants::error_type code() const;
+
+        private:
+            regex_constants::error_type code_;
+    };
+}
+
+#endif
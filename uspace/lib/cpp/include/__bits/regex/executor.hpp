@@ -0,0 +1,762 @@
+/*
+ * Copyright (c) 2019 Jaroslav Jindrak
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * - Redistributions of source code must retain the above copyright
+ *   notice, this list of conditions and the following disclaimer.
+ * - Redistributions in binary form must reproduce the above copyright
+ *   notice, this list of conditions and the following disclaimer in the
+ *   documentation and/or other materials provided with the distribution.
+ * - The name of the author may not be used to endorse or promote products
+ *   derived from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHOR ``AS IS'' AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+ * OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+ * IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT
+ * NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF
+ * THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef LIBCPP_BITS_REGEX_EXECUTOR
+#define LIBCPP_BITS_REGEX_EXECUTOR
+
+#include <__bits/regex/compiler.hpp>
+#include <algorithm>
+#include <iterator>
+#include <vector>
+
+namespace std::aux
+{
+    template<class It>
+    struct regex_slot
+    {
+        It pos;
+        bool set;
+
+        bool operator==(const regex_slot& other) const
+        {
+            return set == other.set && (!set || pos == other.pos);
+        }
+
+        bool operator!=(const regex_slot& other) const
+        {
+            return !(*this == other);
+        }
+    };
+
+    /**
+     * The searched sequence together with the flags that
+     * determine how the assertions behave at its ends.
+     */
+    template<class It, class Char, class Traits>
+    class regex_context
+    {
+        public:
+            using program_type = regex_program<Char, Traits>;
+            using instruction_type = regex_instruction<Char>;
+            using flag_type = regex_constants::match_flag_type;
+
+            regex_context(It first, It last, const program_type& prog, flag_type flags)
+                : first{first}, last{last}, prog{prog}, flags{flags}
+            { /* DUMMY BODY */ }
+
+            It first;
+            It last;
+            const program_type& prog;
+            flag_type flags;
+
+            bool at_line_begin(It pos) const
+            {
+                if (pos == first && !(flags & regex_constants::match_prev_avail))
+                    return !(flags & regex_constants::match_not_bol);
+                else
+                    return prog.multiline && regex_is_line_terminator(Char(*prev(pos)));
+            }
+
+            bool at_line_end(It pos) const
+            {
+                if (pos == last)
+                    return !(flags & regex_constants::match_not_eol);
+                else
+                    return prog.multiline && regex_is_line_terminator(Char(*pos));
+            }
+
+            bool at_word_boundary(It pos) const
+            {
+                bool prev_avail = flags & regex_constants::match_prev_avail;
+                if (pos == first && !prev_avail && (flags & regex_constants::match_not_bow))
+                    return false;
+                if (pos == last && (flags & regex_constants::match_not_eow))
+                    return false;
+
+                bool left = (pos != first || prev_avail) && regex_is_word(Char(*prev(pos)));
+                bool right = pos != last && regex_is_word(Char(*pos));
+
+                return left != right;
+            }
+
+            bool assertion(const instruction_type& instr, It pos) const
+            {
+                switch (instr.op)
+                {
+                    case regex_opcode::line_begin:
+                        return at_line_begin(pos);
+                    case regex_opcode::line_end:
+                        return at_line_end(pos);
+                    case regex_opcode::word_boundary:
+                        return at_word_boundary(pos) != (instr.y != 0);
+                    default:
+                        return true;
+                }
+            }
+
+            Char translate(Char c) const
+            {
+                if (prog.icase)
+                    return prog.traits.translate_nocase(c);
+                else
+                    return prog.traits.translate(c);
+            }
+
+            bool consumes(const instruction_type& instr, Char c) const
+            {
+                switch (instr.op)
+                {
+                    case regex_opcode::literal:
+                        return translate(c) == instr.c;
+                    case regex_opcode::any:
+                        return !regex_is_line_terminator(c);
+                    case regex_opcode::char_class:
+                        return prog.classes[instr.x].matches(c, prog.traits, prog.icase);
+                    default:
+                        return false;
+                }
+            }
+    };
+
+    /**
+     * Depth first search with an explicit stack of choice points
+     * and capture restores, used for the patterns that contain
+     * backreferences or lookaheads. Like any backtracking matcher
+     * it can take exponential time on some patterns.
+     */
+    template<class It, class Char, class Traits>
+    class regex_backtracker
+    {
+        public:
+            using context_type = regex_context<It, Char, Traits>;
+            using slots_type = vector<regex_slot<It>>;
+
+            regex_backtracker(const context_type& ctx, bool full, bool not_null)
+                : ctx_{ctx}, full_{full}, not_null_{not_null}
+            { /* DUMMY BODY */ }
+
+            bool run(It start, slots_type& caps)
+            {
+                caps.assign(ctx_.prog.slots, regex_slot<It>{ctx_.last, false});
+
+                return run_(0, start, caps, true);
+            }
+
+        private:
+            const context_type& ctx_;
+            bool full_;
+            bool not_null_;
+
+            struct frame
+            {
+                size_t pc;
+                It pos;
+                size_t slot;
+                regex_slot<It> old;
+                bool restore;
+            };
+
+            bool accept_(It pos, const slots_type& caps) const
+            {
+                if (full_ && pos != ctx_.last)
+                    return false;
+                if (not_null_ && pos == caps[0].pos)
+                    return false;
+
+                return true;
+            }
+
+            bool run_(size_t pc, It pos, slots_type& caps, bool top)
+            {
+                const auto& code = ctx_.prog.code;
+                vector<frame> stack{};
+
+                while (true)
+                {
+                    const auto& instr = code[pc];
+                    bool ok{true};
+
+                    switch (instr.op)
+                    {
+                        case regex_opcode::match:
+                            if (!top || accept_(pos, caps))
+                                return true;
+                            ok = false;
+                            break;
+                        case regex_opcode::literal:
+                        case regex_opcode::any:
+                        case regex_opcode::char_class:
+                            if (pos != ctx_.last && ctx_.consumes(instr, *pos))
+                            {
+                                ++pos;
+                                ++pc;
+                            }
+                            else
+                                ok = false;
+                            break;
+                        case regex_opcode::split:
+                            stack.push_back(frame{instr.y, pos, 0, regex_slot<It>{}, false});
+                            pc = instr.x;
+                            break;
+                        case regex_opcode::jump:
+                            pc = instr.x;
+                            break;
+                        case regex_opcode::save:
+                        case regex_opcode::progress_mark:
+                            stack.push_back(frame{0, pos, instr.x, caps[instr.x], true});
+                            caps[instr.x] = regex_slot<It>{pos, true};
+                            ++pc;
+                            break;
+                        case regex_opcode::progress_check:
+                            ok = !(caps[instr.x].set && caps[instr.x].pos == pos);
+                            ++pc;
+                            break;
+                        case regex_opcode::line_begin:
+                        case regex_opcode::line_end:
+                        case regex_opcode::word_boundary:
+                            ok = ctx_.assertion(instr, pos);
+                            ++pc;
+                            break;
+                        case regex_opcode::backref:
+                        {
+                            const auto& begin = caps[2 * instr.x];
+                            const auto& end = caps[2 * instr.x + 1];
+                            if (begin.set && end.set)
+                            {
+                                for (auto it = begin.pos; ok && it != end.pos; ++it, ++pos)
+                                {
+                                    ok = pos != ctx_.last &&
+                                         ctx_.translate(*it) == ctx_.translate(*pos);
+                                }
+                            }
+                            ++pc;
+                            break;
+                        }
+                        case regex_opcode::lookahead:
+                        {
+                            auto sub = caps;
+                            bool negative = instr.y != 0;
+                            if (run_(pc + 1, pos, sub, false) == negative)
+                                ok = false;
+                            else if (!negative)
+                            {
+                                for (size_t i = 0; i < caps.size(); ++i)
+                                {
+                                    if (caps[i] != sub[i])
+                                    {
+                                        stack.push_back(frame{0, pos, i, caps[i], true});
+                                        caps[i] = sub[i];
+                                    }
+                                }
+                            }
+                            pc = instr.x;
+                            break;
+                        }
+                    }
+
+                    while (!ok)
+                    {
+                        if (stack.empty())
+                            return false;
+
+                        auto f = stack.back();
+                        stack.pop_back();
+
+                        if (f.restore)
+                            caps[f.slot] = f.old;
+                        else
+                        {
+                            pc = f.pc;
+                            pos = f.pos;
+                            ok = true;
+                        }
+                    }
+                }
+            }
+    };
+
+    /**
+     * Simulates the NFA with all threads in lockstep (Pike VM),
+     * so the time is linear in the length of the input. Threads
+     * are kept in priority order and each instruction is entered
+     * by at most one thread per position, which yields the same
+     * submatches as the backtracking semantics of ECMAScript.
+     */
+    template<class It, class Char, class Traits>
+    class regex_pike_vm
+    {
+        public:
+            using context_type = regex_context<It, Char, Traits>;
+            using slots_type = vector<regex_slot<It>>;
+
+            regex_pike_vm(const context_type& ctx, bool full, bool not_null)
+                : ctx_{ctx}, full_{full}, not_null_{not_null},
+                  slots_{ctx.prog.slots}, curr_{}, next_{},
+                  work_{}, stack_{}, generation_{}
+            {
+                auto size = ctx_.prog.code.size();
+                curr_.marks.resize(size, 0);
+                next_.marks.resize(size, 0);
+            }
+
+            bool run(It start, bool anchored, slots_type& res)
+            {
+                bool matched{};
+                const auto& code = ctx_.prog.code;
+                regex_slot<It> unset{ctx_.last, false};
+
+                clear_(curr_);
+                clear_(next_);
+
+                auto pos = start;
+                while (true)
+                {
+                    if (!matched && (!anchored || pos == start))
+                    {
+                        work_.assign(slots_, unset);
+                        add_(curr_, 0, pos);
+                    }
+
+                    if (curr_.pcs.empty() && (matched || anchored))
+                        break;
+
+                    for (size_t i = 0; i < curr_.pcs.size(); ++i)
+                    {
+                        auto pc = curr_.pcs[i];
+                        const auto& instr = code[pc];
+                        auto caps = curr_.caps.begin() + i * slots_;
+
+                        if (instr.op == regex_opcode::match)
+                        {
+                            if ((full_ && pos != ctx_.last) || (not_null_ && caps[0].pos == pos))
+                                continue;
+
+                            res.assign(caps, caps + slots_);
+                            matched = true;
+
+                            // Lower priority threads are cut off.
+                            break;
+                        }
+                        else if (pos != ctx_.last && ctx_.consumes(instr, *pos))
+                        {
+                            work_.assign(caps, caps + slots_);
+                            add_(next_, pc + 1, next(pos));
+                        }
+                    }
+
+                    if (pos == ctx_.last)
+                        break;
+
+                    ++pos;
+                    swap(curr_, next_);
+                    clear_(next_);
+                }
+
+                return matched;
+            }
+
+        private:
+            const context_type& ctx_;
+            bool full_;
+            bool not_null_;
+            size_t slots_;
+
+            struct thread_list
+            {
+                vector<size_t> pcs{};
+                slots_type caps{};
+                vector<size_t> marks{};
+                size_t generation{};
+            };
+
+            struct entry
+            {
+                size_t pc;
+                size_t slot;
+                regex_slot<It> old;
+                bool restore;
+            };
+
+            thread_list curr_;
+            thread_list next_;
+            slots_type work_;
+            vector<entry> stack_;
+            size_t generation_;
+
+            void clear_(thread_list& list)
+            {
+                list.pcs.clear();
+                list.caps.clear();
+                list.generation = ++generation_;
+            }
+
+            /**
+             * Follows the epsilon transitions from pc in priority
+             * order and adds the threads that stopped at a consuming
+             * instruction (or match) to the list, work_ holds the
+             * captures of the thread that is being added.
+             */
+            void add_(thread_list& list, size_t pc, It pos)
+            {
+                const auto& code = ctx_.prog.code;
+
+                stack_.clear();
+                stack_.push_back(entry{pc, 0, regex_slot<It>{}, false});
+                while (!stack_.empty())
+                {
+                    auto e = stack_.back();
+                    stack_.pop_back();
+
+                    if (e.restore)
+                    {
+                        work_[e.slot] = e.old;
+                        continue;
+                    }
+
+                    if (list.marks[e.pc] == list.generation)
+                        continue;
+                    list.marks[e.pc] = list.generation;
+
+                    const auto& instr = code[e.pc];
+                    switch (instr.op)
+                    {
+                        case regex_opcode::jump:
+                            stack_.push_back(entry{instr.x, 0, regex_slot<It>{}, false});
+                            break;
+                        case regex_opcode::split:
+                            stack_.push_back(entry{instr.y, 0, regex_slot<It>{}, false});
+                            stack_.push_back(entry{instr.x, 0, regex_slot<It>{}, false});
+                            break;
+                        case regex_opcode::save:
+                            stack_.push_back(entry{0, instr.x, work_[instr.x], true});
+                            work_[instr.x] = regex_slot<It>{pos, true};
+                            stack_.push_back(entry{e.pc + 1, 0, regex_slot<It>{}, false});
+                            break;
+                        case regex_opcode::progress_mark:
+                        case regex_opcode::progress_check:
+                            stack_.push_back(entry{e.pc + 1, 0, regex_slot<It>{}, false});
+                            break;
+                        case regex_opcode::line_begin:
+                        case regex_opcode::line_end:
+                        case regex_opcode::word_boundary:
+                            if (ctx_.assertion(instr, pos))
+                                stack_.push_back(entry{e.pc + 1, 0, regex_slot<It>{}, false});
+                            break;
+                        default:
+                            list.pcs.push_back(e.pc);
+                            list.caps.insert(list.caps.end(), work_.begin(), work_.end());
+                            break;
+                    }
+                }
+            }
+    };
+
+    /**
+     * Lazily built DFA over single byte characters. It only
+     * answers whether (and roughly where) a match exists, the
+     * submatches are then found by the Pike VM. States are built
+     * on first use and kept in the cache of the program, which is
+     * flushed when it grows too large.
+     */
+    template<class It, class Char, class Traits>
+    class regex_dfa
+    {
+        public:
+            using context_type = regex_context<It, Char, Traits>;
+
+            regex_dfa(const context_type& ctx, regex_dfa_cache& cache, bool anchored)
+                : ctx_{ctx}, cache_{cache}, anchored_{anchored},
+                  visited_{}, stack_{}
+            { /* DUMMY BODY */ }
+
+            /**
+             * Stops at the first position where some match ends.
+             * No match starts before restart, which is the last
+             * position where no earlier thread was alive.
+             */
+            bool search(It start, It& restart)
+            {
+                auto state = initial_(start);
+                auto pos = start;
+                restart = start;
+
+                while (true)
+                {
+                    const auto& st = cache_.states[state];
+                    if (st.restart)
+                        restart = pos;
+
+                    if (pos == ctx_.last)
+                        return ctx_.at_line_end(pos) ? st.end_match : st.match;
+                    if (st.match)
+                        return true;
+                    if (st.leaves.empty())
+                        return false;
+
+                    auto c = static_cast<unsigned char>(*pos);
+                    auto nxt = st.next[c];
+                    if (nxt < 0)
+                        nxt = step_(state, c);
+
+                    state = nxt;
+                    ++pos;
+                }
+            }
+
+            /**
+             * Checks if the whole sequence matches.
+             */
+            bool match(It start)
+            {
+                auto state = initial_(start);
+                auto pos = start;
+
+                while (true)
+                {
+                    const auto& st = cache_.states[state];
+                    if (pos == ctx_.last)
+                        return ctx_.at_line_end(pos) ? st.end_match : st.match;
+                    if (st.leaves.empty())
+                        return false;
+
+                    auto c = static_cast<unsigned char>(*pos);
+                    auto nxt = st.next[c];
+                    if (nxt < 0)
+                        nxt = step_(state, c);
+
+                    state = nxt;
+                    ++pos;
+                }
+            }
+
+        private:
+            const context_type& ctx_;
+            regex_dfa_cache& cache_;
+            bool anchored_;
+            vector<bool> visited_;
+            vector<size_t> stack_;
+
+            static constexpr size_t max_states_{1024};
+
+            /**
+             * Computes the consuming instructions reachable from
+             * the kernel, the first element of the key tells if
+             * the beginning of line assertion holds.
+             */
+            bool closure_(const vector<size_t>& key, bool eol, vector<size_t>* leaves)
+            {
+                const auto& code = ctx_.prog.code;
+                bool bol = key[0] != 0;
+                bool match{};
+
+                visited_.assign(code.size(), false);
+                stack_.assign(key.rbegin(), key.rend() - 1);
+                while (!stack_.empty())
+                {
+                    auto pc = stack_.back();
+                    stack_.pop_back();
+
+                    if (visited_[pc])
+                        continue;
+                    visited_[pc] = true;
+
+                    const auto& instr = code[pc];
+                    switch (instr.op)
+                    {
+                        case regex_opcode::match:
+                            match = true;
+                            break;
+                        case regex_opcode::jump:
+                            stack_.push_back(instr.x);
+                            break;
+                        case regex_opcode::split:
+                            stack_.push_back(instr.y);
+                            stack_.push_back(instr.x);
+                            break;
+                        case regex_opcode::line_begin:
+                            if (bol)
+                                stack_.push_back(pc + 1);
+                            break;
+                        case regex_opcode::line_end:
+                            if (eol)
+                                stack_.push_back(pc + 1);
+                            break;
+                        case regex_opcode::literal:
+                        case regex_opcode::any:
+                        case regex_opcode::char_class:
+                            if (leaves)
+                                leaves->push_back(pc);
+                            break;
+                        default:
+                            stack_.push_back(pc + 1);
+                            break;
+                    }
+                }
+
+                return match;
+            }
+
+            int state_(vector<size_t>&& key)
+            {
+                auto it = cache_.index.find(key);
+                if (it != cache_.index.end())
+                    return it->second;
+
+                if (cache_.states.size() >= max_states_)
+                {
+                    cache_.states.clear();
+                    cache_.index.clear();
+                    cache_.initial[0] = cache_.initial[1] = -1;
+                    ++cache_.flushes;
+                }
+
+                regex_dfa_state st{};
+                st.match = closure_(key, false, &st.leaves);
+                st.end_match = closure_(key, true, nullptr);
+                st.restart = !anchored_ && key.size() == 2 && key[1] == 0;
+                fill(begin(st.next), end(st.next), -1);
+
+                int idx = static_cast<int>(cache_.states.size());
+                st.key = key;
+                cache_.index.emplace(move(key), idx);
+                cache_.states.push_back(move(st));
+
+                return idx;
+            }
+
+            int initial_(It start)
+            {
+                bool bol = start == ctx_.first && ctx_.at_line_begin(start);
+                if (cache_.initial[bol] >= 0)
+                    return cache_.initial[bol];
+
+                auto res = state_(vector<size_t>{bol, 0});
+                cache_.initial[bol] = res;
+
+                return res;
+            }
+
+            int step_(int state, unsigned char c)
+            {
+                vector<size_t> key{0};
+                for (auto pc: cache_.states[state].leaves)
+                {
+                    if (ctx_.consumes(ctx_.prog.code[pc], static_cast<Char>(c)))
+                        key.push_back(pc + 1);
+                }
+                if (!anchored_)
+                    key.push_back(0);
+
+                sort(key.begin() + 1, key.end());
+                key.erase(unique(key.begin() + 1, key.end()), key.end());
+
+                auto flushes = cache_.flushes;
+                auto res = state_(move(key));
+
+                // The cache might have been flushed by the call.
+                if (cache_.flushes == flushes)
+                    cache_.states[state].next[c] = res;
+
+                return res;
+            }
+    };
+
+    /**
+     * Runs the DFA on the cache of the program, unless another
+     * thread is using it at the moment, in which case a private
+     * cache is used instead of waiting.
+     */
+    template<class It, class Char, class Traits>
+    bool regex_dfa_run(const regex_context<It, Char, Traits>& ctx, bool anchored,
+                       bool full, It& restart)
+    {
+        const auto& prog = ctx.prog;
+
+        if (threading::mutex::try_lock(prog.dfa_mutex))
+        {
+            regex_dfa<It, Char, Traits> dfa{ctx, prog.dfa_caches[anchored], anchored};
+            bool res = full ? dfa.match(ctx.first) : dfa.search(ctx.first, restart);
+            threading::mutex::unlock(prog.dfa_mutex);
+
+            return res;
+        }
+        else
+        {
+            regex_dfa_cache cache{};
+            regex_dfa<It, Char, Traits> dfa{ctx, cache, anchored};
+
+            return full ? dfa.match(ctx.first) : dfa.search(ctx.first, restart);
+        }
+    }
+
+    /**
+     * Common implementation of regex_match (full == true) and
+     * regex_search. The submatches are only computed when res
+     * is not null, if the program allows it, a pure yes or no
+     * query is answered by the DFA alone.
+     */
+    template<class It, class Char, class Traits>
+    bool regex_execute(It first, It last, const regex_program<Char, Traits>& prog,
+                       regex_constants::match_flag_type flags, bool full,
+                       vector<regex_slot<It>>* res)
+    {
+        regex_context<It, Char, Traits> ctx{first, last, prog, flags};
+        bool anchored = full || (flags & regex_constants::match_continuous);
+        bool not_null = flags & regex_constants::match_not_null;
+
+        vector<regex_slot<It>> local{};
+        auto& caps = res ? *res : local;
+
+        if (prog.backtrack)
+        {
+            regex_backtracker<It, Char, Traits> bt{ctx, full, not_null};
+            for (auto start = first; ; ++start)
+            {
+                if (bt.run(start, caps))
+                    return true;
+                if (anchored || start == last)
+                    return false;
+            }
+        }
+
+        auto start = first;
+        if (prog.dfa && !not_null)
+        {
+            if (!regex_dfa_run(ctx, anchored, full, start))
+                return false;
+            if (!res)
+                return true;
+        }
+
+        regex_pike_vm<It, Char, Traits> vm{ctx, full, not_null};
+
+        return vm.run(start, anchored, caps);
+    }
+}
+
+#endif
@@ -0,0 +1,1668 @@
+/*
+ * Copyright (c) 2019 Jaroslav Jindrak
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * - Redistributions of source code must retain the above copyright
+ *   notice, this list of conditions and the following disclaimer.
+ * - Redistributions in binary form must reproduce the above copyright
+ *   notice, this list of conditions and the following disclaimer in the
+ *   documentation and/or other materials provided with the distribution.
+ * - The name of the author may not be used to endorse or promote products
+ *   derived from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHOR ``AS IS'' AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+ * OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+ * IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT
+ * NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF
+ * THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef LIBCPP_BITS_REGEX_REGEX
+#define LIBCPP_BITS_REGEX_REGEX
+
+#include <__bits/regex/constants.hpp>
+#include <__bits/regex/executor.hpp>
+#include <__bits/regex/traits.hpp>
+#include <initializer_list>
+#include <iosfwd>
+#include <iterator>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace std
+{
+    template<class Char, class Traits>
+    class basic_regex;
+
+    template<class BidirectionalIterator, class Allocator>
+    class match_results;
+
+    namespace aux
+    {
+        struct regex_access;
+    }
+
+    /**
+     * 28.8, class template basic_regex:
+     * Only the ECMAScript grammar is implemented, patterns
+     * in the other grammars are parsed as ECMAScript.
+     */
+
+    template<class Char, class Traits = regex_traits<Char>>
+    class basic_regex
+    {
+        public:
+            using value_type  = Char;
+            using traits_type = Traits;
+            using string_type = typename Traits::string_type;
+            using flag_type   = regex_constants::syntax_option_type;
+            using locale_type = typename Traits::locale_type;
+
+            /**
+             * 28.8.1, constants:
+             */
+
+            static constexpr flag_type icase      = regex_constants::icase;
+            static constexpr flag_type nosubs     = regex_constants::nosubs;
+            static constexpr flag_type optimize   = regex_constants::optimize;
+            static constexpr flag_type collate    = regex_constants::collate;
+            static constexpr flag_type ECMAScript = regex_constants::ECMAScript;
+            static constexpr flag_type basic      = regex_constants::basic;
+            static constexpr flag_type extended   = regex_constants::extended;
+            static constexpr flag_type awk        = regex_constants::awk;
+            static constexpr flag_type grep       = regex_constants::grep;
+            static constexpr flag_type egrep      = regex_constants::egrep;
+            static constexpr flag_type multiline  = regex_constants::multiline;
+
+            /**
+             * 28.8.2, construct/copy/destroy:
+             */
+
+            basic_regex()
+                : flags_{}, traits_{}, program_{}
+            { /* DUMMY BODY */ }
+
+            explicit basic_regex(const value_type* ptr, flag_type flags = ECMAScript)
+                : basic_regex{}
+            {
+                assign(ptr, flags);
+            }
+
+            basic_regex(const value_type* ptr, size_t len, flag_type flags = ECMAScript)
+                : basic_regex{}
+            {
+                assign(ptr, len, flags);
+            }
+
+            basic_regex(const basic_regex& other) = default;
+
+            basic_regex(basic_regex&& other) noexcept = default;
+
+            template<class ST, class SA>
+            explicit basic_regex(const basic_string<value_type, ST, SA>& str,
+                                 flag_type flags = ECMAScript)
+                : basic_regex{}
+            {
+                assign(str, flags);
+            }
+
+            template<class ForwardIterator>
+            basic_regex(ForwardIterator first, ForwardIterator last,
+                        flag_type flags = ECMAScript)
+                : basic_regex{}
+            {
+                assign(first, last, flags);
+            }
+
+            basic_regex(initializer_list<value_type> init, flag_type flags = ECMAScript)
+                : basic_regex{}
+            {
+                assign(init, flags);
+            }
+
+            ~basic_regex() = default;
+
+            basic_regex& operator=(const basic_regex& other) = default;
+
+            basic_regex& operator=(basic_regex&& other) noexcept = default;
+
+            basic_regex& operator=(const value_type* ptr)
+            {
+                return assign(ptr);
+            }
+
+            basic_regex& operator=(initializer_list<value_type> init)
+            {
+                return assign(init);
+            }
+
+            template<class ST, class SA>
+            basic_regex& operator=(const basic_string<value_type, ST, SA>& str)
+            {
+                return assign(str);
+            }
+
+            /**
+             * 28.8.3, assign:
+             */
+
+            basic_regex& assign(const basic_regex& other)
+            {
+                return *this = other;
+            }
+
+            basic_regex& assign(basic_regex&& other) noexcept
+            {
+                return *this = move(other);
+            }
+
+            basic_regex& assign(const value_type* ptr, flag_type flags = ECMAScript)
+            {
+                return assign(ptr, traits_type::length(ptr), flags);
+            }
+
+            basic_regex& assign(const value_type* ptr, size_t len, flag_type flags = ECMAScript)
+            {
+                compile_(ptr, ptr + len, flags);
+
+                return *this;
+            }
+
+            template<class ST, class SA>
+            basic_regex& assign(const basic_string<value_type, ST, SA>& str,
+                                flag_type flags = ECMAScript)
+            {
+                return assign(str.data(), str.size(), flags);
+            }
+
+            template<class InputIterator>
+            basic_regex& assign(InputIterator first, InputIterator last,
+                                flag_type flags = ECMAScript)
+            {
+                string_type str(first, last);
+
+                return assign(str.data(), str.size(), flags);
+            }
+
+            basic_regex& assign(initializer_list<value_type> init,
+                                flag_type flags = ECMAScript)
+            {
+                return assign(init.begin(), init.size(), flags);
+            }
+
+            /**
+             * 28.8.4, const operations:
+             */
+
+            unsigned mark_count() const
+            {
+                return program_ ? program_->groups : 0U;
+            }
+
+            flag_type flags() const
+            {
+                return flags_;
+            }
+
+            /**
+             * 28.8.5, locale:
+             * Imbuing a locale discards the compiled pattern.
+             */
+
+            locale_type imbue(locale_type loc)
+            {
+                program_.reset();
+
+                return traits_.imbue(loc);
+            }
+
+            locale_type getloc() const
+            {
+                return traits_.getloc();
+            }
+
+            /**
+             * 28.8.6, swap:
+             */
+
+            void swap(basic_regex& other)
+            {
+                std::swap(flags_, other.flags_);
+                std::swap(traits_, other.traits_);
+                std::swap(program_, other.program_);
+            }
+
+        private:
+            flag_type flags_;
+            traits_type traits_;
+
+            /**
+             * The compiled program is not modified after compilation
+             * (apart from the DFA cache, which is synchronized) and
+             * thus shared by copies of the regex.
+             */
+            shared_ptr<aux::regex_program<Char, Traits>> program_;
+
+            void compile_(const value_type* first, const value_type* last, flag_type flags)
+            {
+                auto prog = make_shared<aux::regex_program<Char, Traits>>();
+                prog->traits = traits_;
+
+                flags_ = flags;
+                aux::regex_compiler<Char, Traits> compiler{first, last, flags, *prog};
+                if (compiler.compile())
+                    program_ = move(prog);
+                else
+                    program_.reset();
+            }
+
+            friend struct aux::regex_access;
+    };
+
+    /**
+     * 28.8.7, basic_regex non-member functions:
+     */
+
+    template<class Char, class Traits>
+    void swap(basic_regex<Char, Traits>& lhs, basic_regex<Char, Traits>& rhs)
+    {
+        lhs.swap(rhs);
+    }
+
+    using regex  = basic_regex<char>;
+    using wregex = basic_regex<wchar_t>;
+
+    /**
+     * 28.9, class template sub_match:
+     */
+
+    template<class BidirectionalIterator>
+    class sub_match: public pair<BidirectionalIterator, BidirectionalIterator>
+    {
+        public:
+            using value_type      = typename iterator_traits<BidirectionalIterator>::value_type;
+            using difference_type = typename iterator_traits<BidirectionalIterator>::difference_type;
+            using iterator        = BidirectionalIterator;
+            using string_type     = basic_string<value_type>;
+
+            bool matched;
+
+            constexpr sub_match()
+                : pair<BidirectionalIterator, BidirectionalIterator>{}, matched{false}
+            { /* DUMMY BODY */ }
+
+            difference_type length() const
+            {
+                return matched ? distance(this->first, this->second) : 0;
+            }
+
+            operator string_type() const
+            {
+                return str();
+            }
+
+            string_type str() const
+            {
+                if (matched)
+                    return string_type(this->first, this->second);
+                else
+                    return string_type{};
+            }
+
+            int compare(const sub_match& other) const
+            {
+                return str().compare(other.str());
+            }
+
+            int compare(const string_type& other) const
+            {
+                return str().compare(other);
+            }
+
+            int compare(const value_type* other) const
+            {
+                return str().compare(other);
+            }
+    };
+
+    using csub_match  = sub_match<const char*>;
+    using wcsub_match = sub_match<const wchar_t*>;
+    using ssub_match  = sub_match<string::const_iterator>;
+    using wssub_match = sub_match<wstring::const_iterator>;
+
+    /**
+     * 28.9.2, sub_match non-member operators:
+     */
+
+    template<class BidirectionalIterator>
+    bool operator==(const sub_match<BidirectionalIterator>& lhs,
+                    const sub_match<BidirectionalIterator>& rhs)
+    {
+        return lhs.compare(rhs) == 0;
+    }
+
+    template<class BidirectionalIterator>
+    bool operator!=(const sub_match<BidirectionalIterator>& lhs,
+                    const sub_match<BidirectionalIterator>& rhs)
+    {
+        return lhs.compare(rhs) != 0;
+    }
+
+    template<class BidirectionalIterator>
+    bool operator<(const sub_match<BidirectionalIterator>& lhs,
+                    const sub_match<BidirectionalIterator>& rhs)
+    {
+        return lhs.compare(rhs) < 0;
+    }
+
+    template<class BidirectionalIterator>
+    bool operator<=(const sub_match<BidirectionalIterator>& lhs,
+                    const sub_match<BidirectionalIterator>& rhs)
+    {
+        return lhs.compare(rhs) <= 0;
+    }
+
+    template<class BidirectionalIterator>
+    bool operator>(const sub_match<BidirectionalIterator>& lhs,
+                    const sub_match<BidirectionalIterator>& rhs)
+    {
+        return lhs.compare(rhs) > 0;
+    }
+
+    template<class BidirectionalIterator>
+    bool operator>=(const sub_match<BidirectionalIterator>& lhs,
+                    const sub_match<BidirectionalIterator>& rhs)
+    {
+        return lhs.compare(rhs) >= 0;
+    }
+
+    template<class BidirectionalIterator, class ST, class SA>
+    bool operator==(const basic_string<typename iterator_traits<BidirectionalIterator>::value_type, ST, SA>& lhs,
+                    const sub_match<BidirectionalIterator>& rhs)
+    {
+        return 0 == rhs.compare(typename sub_match<BidirectionalIterator>::string_type(lhs.data(), lhs.size()));
+    }
+
+    template<class BidirectionalIterator, class ST, class SA>
+    bool operator!=(const basic_string<typename iterator_traits<BidirectionalIterator>::value_type, ST, SA>& lhs,
+                    const sub_match<BidirectionalIterator>& rhs)
+    {
+        return 0 != rhs.compare(typename sub_match<BidirectionalIterator>::string_type(lhs.data(), lhs.size()));
+    }
+
+    template<class BidirectionalIterator, class ST, class SA>
+    bool operator<(const basic_string<typename iterator_traits<BidirectionalIterator>::value_type, ST, SA>& lhs,
+                    const sub_match<BidirectionalIterator>& rhs)
+    {
+        return 0 < rhs.compare(typename sub_match<BidirectionalIterator>::string_type(lhs.data(), lhs.size()));
+    }
+
+    template<class BidirectionalIterator, class ST, class SA>
+    bool operator<=(const basic_string<typename iterator_traits<BidirectionalIterator>::value_type, ST, SA>& lhs,
+                    const sub_match<BidirectionalIterator>& rhs)
+    {
+        return 0 <= rhs.compare(typename sub_match<BidirectionalIterator>::string_type(lhs.data(), lhs.size()));
+    }
+
+    template<class BidirectionalIterator, class ST, class SA>
+    bool operator>(const basic_string<typename iterator_traits<BidirectionalIterator>::value_type, ST, SA>& lhs,
+                    const sub_match<BidirectionalIterator>& rhs)
+    {
+        return 0 > rhs.compare(typename sub_match<BidirectionalIterator>::string_type(lhs.data(), lhs.size()));
+    }
+
+    template<class BidirectionalIterator, class ST, class SA>
+    bool operator>=(const basic_string<typename iterator_traits<BidirectionalIterator>::value_type, ST, SA>& lhs,
+                    const sub_match<BidirectionalIterator>& rhs)
+    {
+        return 0 >= rhs.compare(typename sub_match<BidirectionalIterator>::string_type(lhs.data(), lhs.size()));
+    }
+
+    template<class BidirectionalIterator, class ST, class SA>
+    bool operator==(const sub_match<BidirectionalIterator>& lhs,
+                    const basic_string<typename iterator_traits<BidirectionalIterator>::value_type, ST, SA>& rhs)
+    {
+        return lhs.compare(typename sub_match<BidirectionalIterator>::string_type(rhs.data(), rhs.size())) == 0;
+    }
+
+    template<class BidirectionalIterator, class ST, class SA>
+    bool operator!=(const sub_match<BidirectionalIterator>& lhs,
+                    const basic_string<typename iterator_traits<BidirectionalIterator>::value_type, ST, SA>& rhs)
+    {
+        return lhs.compare(typename sub_match<BidirectionalIterator>::string_type(rhs.data(), rhs.size())) != 0;
+    }
+
+    template<class BidirectionalIterator, class ST, class SA>
+    bool operator<(const sub_match<BidirectionalIterator>& lhs,
+                    const basic_string<typename iterator_traits<BidirectionalIterator>::value_type, ST, SA>& rhs)
+    {
+        return lhs.compare(typename sub_match<BidirectionalIterator>::string_type(rhs.data(), rhs.size())) < 0;
+    }
+
+    template<class BidirectionalIterator, class ST, class SA>
+    bool operator<=(const sub_match<BidirectionalIterator>& lhs,
+                    const basic_string<typename iterator_traits<BidirectionalIterator>::value_type, ST, SA>& rhs)
+    {
+        return lhs.compare(typename sub_match<BidirectionalIterator>::string_type(rhs.data(), rhs.size())) <= 0;
+    }
+
+    template<class BidirectionalIterator, class ST, class SA>
+    bool operator>(const sub_match<BidirectionalIterator>& lhs,
+                    const basic_string<typename iterator_traits<BidirectionalIterator>::value_type, ST, SA>& rhs)
+    {
+        return lhs.compare(typename sub_match<BidirectionalIterator>::string_type(rhs.data(), rhs.size())) > 0;
+    }
+
+    template<class BidirectionalIterator, class ST, class SA>
+    bool operator>=(const sub_match<BidirectionalIterator>& lhs,
+                    const basic_string<typename iterator_traits<BidirectionalIterator>::value_type, ST, SA>& rhs)
+    {
+        return lhs.compare(typename sub_match<BidirectionalIterator>::string_type(rhs.data(), rhs.size())) >= 0;
+    }
+
+    template<class BidirectionalIterator>
+    bool operator==(const typename iterator_traits<BidirectionalIterator>::value_type* lhs,
+                    const sub_match<BidirectionalIterator>& rhs)
+    {
+        return 0 == rhs.compare(lhs);
+    }
+
+    template<class BidirectionalIterator>
+    bool operator!=(const typename iterator_traits<BidirectionalIterator>::value_type* lhs,
+                    const sub_match<BidirectionalIterator>& rhs)
+    {
+        return 0 != rhs.compare(lhs);
+    }
+
+    template<class BidirectionalIterator>
+    bool operator<(const typename iterator_traits<BidirectionalIterator>::value_type* lhs,
+                    const sub_match<BidirectionalIterator>& rhs)
+    {
+        return 0 < rhs.compare(lhs);
+    }
+
+    template<class BidirectionalIterator>
+    bool operator<=(const typename iterator_traits<BidirectionalIterator>::value_type* lhs,
+                    const sub_match<BidirectionalIterator>& rhs)
+    {
+        return 0 <= rhs.compare(lhs);
+    }
+
+    template<class BidirectionalIterator>
+    bool operator>(const typename iterator_traits<BidirectionalIterator>::value_type* lhs,
+                    const sub_match<BidirectionalIterator>& rhs)
+    {
+        return 0 > rhs.compare(lhs);
+    }
+
+    template<class BidirectionalIterator>
+    bool operator>=(const typename iterator_traits<BidirectionalIterator>::value_type* lhs,
+                    const sub_match<BidirectionalIterator>& rhs)
+    {
+        return 0 >= rhs.compare(lhs);
+    }
+
+    template<class BidirectionalIterator>
+    bool operator==(const sub_match<BidirectionalIterator>& lhs,
+                    const typename iterator_traits<BidirectionalIterator>::value_type* rhs)
+    {
+        return lhs.compare(rhs) == 0;
+    }
+
+    template<class BidirectionalIterator>
+    bool operator!=(const sub_match<BidirectionalIterator>& lhs,
+                    const typename iterator_traits<BidirectionalIterator>::value_type* rhs)
+    {
+        return lhs.compare(rhs) != 0;
+    }
+
+    template<class BidirectionalIterator>
+    bool operator<(const sub_match<BidirectionalIterator>& lhs,
+                    const typename iterator_traits<BidirectionalIterator>::value_type* rhs)
+    {
+        return lhs.compare(rhs) < 0;
+    }
+
+    template<class BidirectionalIterator>
+    bool operator<=(const sub_match<BidirectionalIterator>& lhs,
+                    const typename iterator_traits<BidirectionalIterator>::value_type* rhs)
+    {
+        return lhs.compare(rhs) <= 0;
+    }
+
+    template<class BidirectionalIterator>
+    bool operator>(const sub_match<BidirectionalIterator>& lhs,
+                    const typename iterator_traits<BidirectionalIterator>::value_type* rhs)
+    {
+        return lhs.compare(rhs) > 0;
+    }
+
+    template<class BidirectionalIterator>
+    bool operator>=(const sub_match<BidirectionalIterator>& lhs,
+                    const typename iterator_traits<BidirectionalIterator>::value_type* rhs)
+    {
+        return lhs.compare(rhs) >= 0;
+    }
+
+    template<class BidirectionalIterator>
+    bool operator==(const typename iterator_traits<BidirectionalIterator>::value_type& lhs,
+                    const sub_match<BidirectionalIterator>& rhs)
+    {
+        return 0 == rhs.compare(typename sub_match<BidirectionalIterator>::string_type(1, lhs));
+    }
+
+    template<class BidirectionalIterator>
+    bool operator!=(const typename iterator_traits<BidirectionalIterator>::value_type& lhs,
+                    const sub_match<BidirectionalIterator>& rhs)
+    {
+        return 0 != rhs.compare(typename sub_match<BidirectionalIterator>::string_type(1, lhs));
+    }
+
+    template<class BidirectionalIterator>
+    bool operator<(const typename iterator_traits<BidirectionalIterator>::value_type& lhs,
+                    const sub_match<BidirectionalIterator>& rhs)
+    {
+        return 0 < rhs.compare(typename sub_match<BidirectionalIterator>::string_type(1, lhs));
+    }
+
+    template<class BidirectionalIterator>
+    bool operator<=(const typename iterator_traits<BidirectionalIterator>::value_type& lhs,
+                    const sub_match<BidirectionalIterator>& rhs)
+    {
+        return 0 <= rhs.compare(typename sub_match<BidirectionalIterator>::string_type(1, lhs));
+    }
+
+    template<class BidirectionalIterator>
+    bool operator>(const typename iterator_traits<BidirectionalIterator>::value_type& lhs,
+                    const sub_match<BidirectionalIterator>& rhs)
+    {
+        return 0 > rhs.compare(typename sub_match<BidirectionalIterator>::string_type(1, lhs));
+    }
+
+    template<class BidirectionalIterator>
+    bool operator>=(const typename iterator_traits<BidirectionalIterator>::value_type& lhs,
+                    const sub_match<BidirectionalIterator>& rhs)
+    {
+        return 0 >= rhs.compare(typename sub_match<BidirectionalIterator>::string_type(1, lhs));
+    }
+
+    template<class BidirectionalIterator>
+    bool operator==(const sub_match<BidirectionalIterator>& lhs,
+                    const typename iterator_traits<BidirectionalIterator>::value_type& rhs)
+    {
+        return lhs.compare(typename sub_match<BidirectionalIterator>::string_type(1, rhs)) == 0;
+    }
+
+    template<class BidirectionalIterator>
+    bool operator!=(const sub_match<BidirectionalIterator>& lhs,
+                    const typename iterator_traits<BidirectionalIterator>::value_type& rhs)
+    {
+        return lhs.compare(typename sub_match<BidirectionalIterator>::string_type(1, rhs)) != 0;
+    }
+
+    template<class BidirectionalIterator>
+    bool operator<(const sub_match<BidirectionalIterator>& lhs,
+                    const typename iterator_traits<BidirectionalIterator>::value_type& rhs)
+    {
+        return lhs.compare(typename sub_match<BidirectionalIterator>::string_type(1, rhs)) < 0;
+    }
+
+    template<class BidirectionalIterator>
+    bool operator<=(const sub_match<BidirectionalIterator>& lhs,
+                    const typename iterator_traits<BidirectionalIterator>::value_type& rhs)
+    {
+        return lhs.compare(typename sub_match<BidirectionalIterator>::string_type(1, rhs)) <= 0;
+    }
+
+    template<class BidirectionalIterator>
+    bool operator>(const sub_match<BidirectionalIterator>& lhs,
+                    const typename iterator_traits<BidirectionalIterator>::value_type& rhs)
+    {
+        return lhs.compare(typename sub_match<BidirectionalIterator>::string_type(1, rhs)) > 0;
+    }
+
+    template<class BidirectionalIterator>
+    bool operator>=(const sub_match<BidirectionalIterator>& lhs,
+                    const typename iterator_traits<BidirectionalIterator>::value_type& rhs)
+    {
+        return lhs.compare(typename sub_match<BidirectionalIterator>::string_type(1, rhs)) >= 0;
+    }
+
+    template<class Char, class ST, class BidirectionalIterator>
+    basic_ostream<Char, ST>& operator<<(basic_ostream<Char, ST>& os,
+                                        const sub_match<BidirectionalIterator>& sub)
+    {
+        return os << sub.str();
+    }
+
+    /**
+     * 28.10, class template match_results:
+     */
+
+    template<
+        class BidirectionalIterator,
+        class Allocator = allocator<sub_match<BidirectionalIterator>>
+    >
+    class match_results
+    {
+        public:
+            using value_type      = sub_match<BidirectionalIterator>;
+            using const_reference = const value_type&;
+            using reference       = value_type&;
+            using const_iterator  = typename vector<value_type, Allocator>::const_iterator;
+            using iterator        = const_iterator;
+            using difference_type = typename iterator_traits<BidirectionalIterator>::difference_type;
+            using size_type       = typename allocator_traits<Allocator>::size_type;
+            using allocator_type  = Allocator;
+            using char_type       = typename iterator_traits<BidirectionalIterator>::value_type;
+            using string_type     = basic_string<char_type>;
+
+            /**
+             * 28.10.1, construct/copy/destroy:
+             */
+
+            explicit match_results(const Allocator& alloc = Allocator{})
+                : subs_(alloc), prefix_{}, suffix_{}, unmatched_{},
+                  base_{}, ready_{false}
+            { /* DUMMY BODY */ }
+
+            match_results(const match_results& other) = default;
+
+            match_results(match_results&& other) noexcept = default;
+
+            match_results& operator=(const match_results& other) = default;
+
+            match_results& operator=(match_results&& other) = default;
+
+            ~match_results() = default;
+
+            /**
+             * 28.10.2, state:
+             */
+
+            bool ready() const
+            {
+                return ready_;
+            }
+
+            /**
+             * 28.10.3, size:
+             */
+
+            size_type size() const
+            {
+                return subs_.size();
+            }
+
+            size_type max_size() const
+            {
+                return subs_.max_size();
+            }
+
+            bool empty() const
+            {
+                return subs_.empty();
+            }
+
+            /**
+             * 28.10.4, element access:
+             */
+
+            difference_type length(size_type sub = 0) const
+            {
+                return (*this)[sub].length();
+            }
+
+            difference_type position(size_type sub = 0) const
+            {
+                return distance(base_, (*this)[sub].first);
+            }
+
+            string_type str(size_type sub = 0) const
+            {
+                return (*this)[sub].str();
+            }
+
+            const_reference operator[](size_type sub) const
+            {
+                if (sub < subs_.size())
+                    return subs_[sub];
+                else
+                    return unmatched_;
+            }
+
+            const_reference prefix() const
+            {
+                return prefix_;
+            }
+
+            const_reference suffix() const
+            {
+                return suffix_;
+            }
+
+            const_iterator begin() const
+            {
+                return subs_.begin();
+            }
+
+            const_iterator end() const
+            {
+                return subs_.end();
+            }
+
+            const_iterator cbegin() const
+            {
+                return subs_.cbegin();
+            }
+
+            const_iterator cend() const
+            {
+                return subs_.cend();
+            }
+
+            /**
+             * 28.10.5, format:
+             */
+
+            template<class OutputIterator>
+            OutputIterator format(
+                OutputIterator out, const char_type* fmt_first, const char_type* fmt_last,
+                regex_constants::match_flag_type flags = regex_constants::format_default
+            ) const
+            {
+                if (flags & regex_constants::format_sed)
+                    return format_sed_(out, fmt_first, fmt_last);
+                else
+                    return format_ecma_(out, fmt_first, fmt_last);
+            }
+
+            template<class OutputIterator, class ST, class SA>
+            OutputIterator format(
+                OutputIterator out, const basic_string<char_type, ST, SA>& fmt,
+                regex_constants::match_flag_type flags = regex_constants::format_default
+            ) const
+            {
+                return format(out, fmt.data(), fmt.data() + fmt.size(), flags);
+            }
+
+            template<class ST, class SA>
+            basic_string<char_type, ST, SA> format(
+                const basic_string<char_type, ST, SA>& fmt,
+                regex_constants::match_flag_type flags = regex_constants::format_default
+            ) const
+            {
+                basic_string<char_type, ST, SA> res{};
+                format(back_inserter(res), fmt, flags);
+
+                return res;
+            }
+
+            string_type format(
+                const char_type* fmt,
+                regex_constants::match_flag_type flags = regex_constants::format_default
+            ) const
+            {
+                string_type res{};
+                format(back_inserter(res), fmt,
+                       fmt + char_traits<char_type>::length(fmt), flags);
+
+                return res;
+            }
+
+            /**
+             * 28.10.6, allocator:
+             */
+
+            allocator_type get_allocator() const
+            {
+                return subs_.get_allocator();
+            }
+
+            /**
+             * 28.10.7, swap:
+             */
+
+            void swap(match_results& other)
+            {
+                std::swap(subs_, other.subs_);
+                std::swap(prefix_, other.prefix_);
+                std::swap(suffix_, other.suffix_);
+                std::swap(unmatched_, other.unmatched_);
+                std::swap(base_, other.base_);
+                std::swap(ready_, other.ready_);
+            }
+
+        private:
+            vector<value_type, Allocator> subs_;
+            value_type prefix_;
+            value_type suffix_;
+            value_type unmatched_;
+            BidirectionalIterator base_;
+            bool ready_;
+
+            template<class OutputIterator>
+            static OutputIterator copy_sub_(OutputIterator out, const value_type& sub)
+            {
+                if (sub.matched)
+                {
+                    for (auto it = sub.first; it != sub.second; ++it)
+                        *out++ = *it;
+                }
+
+                return out;
+            }
+
+            static int digit_(char_type c)
+            {
+                if (c >= char_type('0') && c <= char_type('9'))
+                    return static_cast<int>(c - char_type('0'));
+                else
+                    return -1;
+            }
+
+            /**
+             * ECMAScript replacement patterns: $$, $&, $`, $'
+             * and $n or $nn for the submatches.
+             */
+            template<class OutputIterator>
+            OutputIterator format_ecma_(OutputIterator out, const char_type* first,
+                                        const char_type* last) const
+            {
+                while (first != last)
+                {
+                    if (*first != char_type('$') || first + 1 == last)
+                    {
+                        *out++ = *first++;
+                        continue;
+                    }
+
+                    auto c = first[1];
+                    if (c == char_type('$'))
+                    {
+                        *out++ = c;
+                        first += 2;
+                    }
+                    else if (c == char_type('&'))
+                    {
+                        out = copy_sub_(out, (*this)[0]);
+                        first += 2;
+                    }
+                    else if (c == char_type('`'))
+                    {
+                        out = copy_sub_(out, prefix_);
+                        first += 2;
+                    }
+                    else if (c == char_type('\''))
+                    {
+                        out = copy_sub_(out, suffix_);
+                        first += 2;
+                    }
+                    else if (digit_(c) >= 0)
+                    {
+                        size_type sub = digit_(c);
+                        first += 2;
+                        if (first != last && digit_(*first) >= 0 &&
+                            sub * 10 + digit_(*first) < size())
+                            sub = sub * 10 + digit_(*first++);
+
+                        out = copy_sub_(out, (*this)[sub]);
+                    }
+                    else
+                        *out++ = *first++;
+                }
+
+                return out;
+            }
+
+            /**
+             * POSIX sed replacement patterns: & and \n.
+             */
+            template<class OutputIterator>
+            OutputIterator format_sed_(OutputIterator out, const char_type* first,
+                                       const char_type* last) const
+            {
+                while (first != last)
+                {
+                    if (*first == char_type('&'))
+                    {
+                        out = copy_sub_(out, (*this)[0]);
+                        ++first;
+                    }
+                    else if (*first == char_type('\\') && first + 1 != last)
+                    {
+                        auto c = first[1];
+                        if (digit_(c) >= 0)
+                            out = copy_sub_(out, (*this)[digit_(c)]);
+                        else
+                            *out++ = c;
+                        first += 2;
+                    }
+                    else
+                        *out++ = *first++;
+                }
+
+                return out;
+            }
+
+            friend struct aux::regex_access;
+    };
+
+    using cmatch  = match_results<const char*>;
+    using wcmatch = match_results<const wchar_t*>;
+    using smatch  = match_results<string::const_iterator>;
+    using wsmatch = match_results<wstring::const_iterator>;
+
+    /**
+     * 28.10.8, match_results comparisons:
+     */
+
+    template<class BidirectionalIterator, class Allocator>
+    bool operator==(const match_results<BidirectionalIterator, Allocator>& lhs,
+                    const match_results<BidirectionalIterator, Allocator>& rhs)
+    {
+        if (!lhs.ready() || !rhs.ready())
+            return false;
+        if (lhs.empty() || rhs.empty())
+            return lhs.empty() && rhs.empty();
+
+        return lhs.prefix() == rhs.prefix() && lhs.suffix() == rhs.suffix()
+            && lhs.size() == rhs.size() && equal(lhs.begin(), lhs.end(), rhs.begin());
+    }
+
+    template<class BidirectionalIterator, class Allocator>
+    bool operator!=(const match_results<BidirectionalIterator, Allocator>& lhs,
+                    const match_results<BidirectionalIterator, Allocator>& rhs)
+    {
+        return !(lhs == rhs);
+    }
+
+    /**
+     * 28.10.9, match_results swap:
+     */
+
+    template<class BidirectionalIterator, class Allocator>
+    void swap(match_results<BidirectionalIterator, Allocator>& lhs,
+              match_results<BidirectionalIterator, Allocator>& rhs)
+    {
+        lhs.swap(rhs);
+    }
+
+    namespace aux
+    {
+        /**
+         * Connects the public classes with the compiled
+         * program and the executors.
+         */
+        struct regex_access
+        {
+            template<class It, class Alloc, class Char, class Traits>
+            static bool run(It first, It last, match_results<It, Alloc>* res,
+                            const basic_regex<Char, Traits>& re,
+                            regex_constants::match_flag_type flags, bool full)
+            {
+                const auto* prog = re.program_.get();
+
+                vector<regex_slot<It>> caps{};
+                bool matched = prog && regex_execute(
+                    first, last, *prog, flags, full, res ? &caps : nullptr
+                );
+
+                if (res)
+                {
+                    res->subs_.clear();
+                    res->base_ = first;
+                    res->ready_ = true;
+                    res->unmatched_.first = last;
+                    res->unmatched_.second = last;
+                    res->unmatched_.matched = false;
+
+                    if (matched)
+                        fill_(*res, first, last, caps, prog->groups);
+                }
+
+                return matched;
+            }
+
+            /**
+             * Used by regex_iterator, whose match positions are
+             * relative to the beginning of the whole sequence and
+             * whose prefixes start at the end of the previous match.
+             */
+            template<class It, class Alloc>
+            static void rebase(match_results<It, Alloc>& res, It base, It prefix_first)
+            {
+                res.base_ = base;
+                res.prefix_.first = prefix_first;
+                res.prefix_.matched = prefix_first != res.prefix_.second;
+            }
+
+        private:
+            template<class It, class Alloc>
+            static void fill_(match_results<It, Alloc>& res, It first, It last,
+                              const vector<regex_slot<It>>& caps, size_t groups)
+            {
+                res.subs_.resize(groups + 1);
+                for (size_t i = 0; i <= groups; ++i)
+                {
+                    auto& sub = res.subs_[i];
+                    const auto& begin = caps[2 * i];
+                    const auto& end = caps[2 * i + 1];
+
+                    sub.matched = begin.set && end.set;
+                    sub.first = sub.matched ? begin.pos : last;
+                    sub.second = sub.matched ? end.pos : last;
+                }
+
+                res.prefix_.first = first;
+                res.prefix_.second = res.subs_[0].first;
+                res.prefix_.matched = res.prefix_.first != res.prefix_.second;
+
+                res.suffix_.first = res.subs_[0].second;
+                res.suffix_.second = last;
+                res.suffix_.matched = res.suffix_.first != res.suffix_.second;
+            }
+        };
+    }
+
+    /**
+     * 28.11.2, function template regex_match:
+     */
+
+    template<class BidirectionalIterator, class Allocator, class Char, class Traits>
+    bool regex_match(BidirectionalIterator first, BidirectionalIterator last,
+                     match_results<BidirectionalIterator, Allocator>& res,
+                     const basic_regex<Char, Traits>& re,
+                     regex_constants::match_flag_type flags = regex_constants::match_default)
+    {
+        return aux::regex_access::run(first, last, &res, re, flags, true);
+    }
+
+    template<class BidirectionalIterator, class Char, class Traits>
+    bool regex_match(BidirectionalIterator first, BidirectionalIterator last,
+                     const basic_regex<Char, Traits>& re,
+                     regex_constants::match_flag_type flags = regex_constants::match_default)
+    {
+        match_results<BidirectionalIterator>* res{};
+
+        return aux::regex_access::run(first, last, res, re, flags, true);
+    }
+
+    template<class Char, class Allocator, class Traits>
+    bool regex_match(const Char* str, match_results<const Char*, Allocator>& res,
+                     const basic_regex<Char, Traits>& re,
+                     regex_constants::match_flag_type flags = regex_constants::match_default)
+    {
+        return regex_match(str, str + char_traits<Char>::length(str), res, re, flags);
+    }
+
+    template<class ST, class SA, class Allocator, class Char, class Traits>
+    bool regex_match(const basic_string<Char, ST, SA>& str,
+                     match_results<typename basic_string<Char, ST, SA>::const_iterator,
+                                   Allocator>& res,
+                     const basic_regex<Char, Traits>& re,
+                     regex_constants::match_flag_type flags = regex_constants::match_default)
+    {
+        return regex_match(str.begin(), str.end(), res, re, flags);
+    }
+
+    template<class ST, class SA, class Allocator, class Char, class Traits>
+    bool regex_match(const basic_string<Char, ST, SA>&&,
+                     match_results<typename basic_string<Char, ST, SA>::const_iterator,
+                                   Allocator>&,
+                     const basic_regex<Char, Traits>&,
+                     regex_constants::match_flag_type = regex_constants::match_default) = delete;
+
+    template<class Char, class Traits>
+    bool regex_match(const Char* str, const basic_regex<Char, Traits>& re,
+                     regex_constants::match_flag_type flags = regex_constants::match_default)
+    {
+        return regex_match(str, str + char_traits<Char>::length(str), re, flags);
+    }
+
+    template<class ST, class SA, class Char, class Traits>
+    bool regex_match(const basic_string<Char, ST, SA>& str,
+                     const basic_regex<Char, Traits>& re,
+                     regex_constants::match_flag_type flags = regex_constants::match_default)
+    {
+        return regex_match(str.begin(), str.end(), re, flags);
+    }
+
+    /**
+     * 28.11.3, function template regex_search:
+     */
+
+    template<class BidirectionalIterator, class Allocator, class Char, class Traits>
+    bool regex_search(BidirectionalIterator first, BidirectionalIterator last,
+                      match_results<BidirectionalIterator, Allocator>& res,
+                      const basic_regex<Char, Traits>& re,
+                      regex_constants::match_flag_type flags = regex_constants::match_default)
+    {
+        return aux::regex_access::run(first, last, &res, re, flags, false);
+    }
+
+    template<class BidirectionalIterator, class Char, class Traits>
+    bool regex_search(BidirectionalIterator first, BidirectionalIterator last,
+                      const basic_regex<Char, Traits>& re,
+                      regex_constants::match_flag_type flags = regex_constants::match_default)
+    {
+        match_results<BidirectionalIterator>* res{};
+
+        return aux::regex_access::run(first, last, res, re, flags, false);
+    }
+
+    template<class Char, class Allocator, class Traits>
+    bool regex_search(const Char* str, match_results<const Char*, Allocator>& res,
+                      const basic_regex<Char, Traits>& re,
+                      regex_constants::match_flag_type flags = regex_constants::match_default)
+    {
+        return regex_search(str, str + char_traits<Char>::length(str), res, re, flags);
+    }
+
+    template<class Char, class Traits>
+    bool regex_search(const Char* str, const basic_regex<Char, Traits>& re,
+                      regex_constants::match_flag_type flags = regex_constants::match_default)
+    {
+        return regex_search(str, str + char_traits<Char>::length(str), re, flags);
+    }
+
+    template<class ST, class SA, class Char, class Traits>
+    bool regex_search(const basic_string<Char, ST, SA>& str,
+                      const basic_regex<Char, Traits>& re,
+                      regex_constants::match_flag_type flags = regex_constants::match_default)
+    {
+        return regex_search(str.begin(), str.end(), re, flags);
+    }
+
+    template<class ST, class SA, class Allocator, class Char, class Traits>
+    bool regex_search(const basic_string<Char, ST, SA>& str,
+                      match_results<typename basic_string<Char, ST, SA>::const_iterator,
+                                    Allocator>& res,
+                      const basic_regex<Char, Traits>& re,
+                      regex_constants::match_flag_type flags = regex_constants::match_default)
+    {
+        return regex_search(str.begin(), str.end(), res, re, flags);
+    }
+
+    template<class ST, class SA, class Allocator, class Char, class Traits>
+    bool regex_search(const basic_string<Char, ST, SA>&&,
+                      match_results<typename basic_string<Char, ST, SA>::const_iterator,
+                                    Allocator>&,
+                      const basic_regex<Char, Traits>&,
+                      regex_constants::match_flag_type = regex_constants::match_default) = delete;
+
+    /**
+     * 28.12.1, class template regex_iterator:
+     */
+
+    template<
+        class BidirectionalIterator,
+        class Char = typename iterator_traits<BidirectionalIterator>::value_type,
+        class Traits = regex_traits<Char>
+    >
+    class regex_iterator
+    {
+        public:
+            using regex_type        = basic_regex<Char, Traits>;
+            using value_type        = match_results<BidirectionalIterator>;
+            using difference_type   = ptrdiff_t;
+            using pointer           = const value_type*;
+            using reference         = const value_type&;
+            using iterator_category = forward_iterator_tag;
+
+            regex_iterator()
+                : begin_{}, end_{}, regex_{}, flags_{}, match_{}
+            { /* DUMMY BODY */ }
+
+            regex_iterator(BidirectionalIterator first, BidirectionalIterator last,
+                           const regex_type& re,
+                           regex_constants::match_flag_type flags = regex_constants::match_default)
+                : begin_{first}, end_{last}, regex_{&re}, flags_{flags}, match_{}
+            {
+                if (!regex_search(begin_, end_, match_, *regex_, flags_))
+                    regex_ = nullptr;
+            }
+
+            regex_iterator(BidirectionalIterator, BidirectionalIterator, const regex_type&&,
+                           regex_constants::match_flag_type = regex_constants::match_default) = delete;
+
+            regex_iterator(const regex_iterator& other) = default;
+
+            regex_iterator& operator=(const regex_iterator& other) = default;
+
+            bool operator==(const regex_iterator& other) const
+            {
+                if (!regex_ || !other.regex_)
+                    return !regex_ && !other.regex_;
+
+                return begin_ == other.begin_ && end_ == other.end_
+                    && regex_ == other.regex_ && flags_ == other.flags_
+                    && match_[0] == other.match_[0];
+            }
+
+            bool operator!=(const regex_iterator& other) const
+            {
+                return !(*this == other);
+            }
+
+            reference operator*() const
+            {
+                return match_;
+            }
+
+            pointer operator->() const
+            {
+                return &match_;
+            }
+
+            regex_iterator& operator++()
+            {
+                auto start = match_[0].second;
+                auto prev_end = start;
+
+                /**
+                 * After an empty match try a non empty one at the
+                 * same position first, otherwise move one character
+                 * forward so that the iteration does not get stuck.
+                 */
+                if (match_[0].first == match_[0].second)
+                {
+                    if (start == end_)
+                    {
+                        regex_ = nullptr;
+
+                        return *this;
+                    }
+
+                    auto flags = flags_ | regex_constants::match_not_null
+                        | regex_constants::match_continuous
+                        | regex_constants::match_prev_avail;
+                    if (regex_search(start, end_, match_, *regex_, flags))
+                    {
+                        aux::regex_access::rebase(match_, begin_, prev_end);
+
+                        return *this;
+                    }
+
+                    ++start;
+                }
+
+                flags_ |= regex_constants::match_prev_avail;
+                if (regex_search(start, end_, match_, *regex_, flags_))
+                    aux::regex_access::rebase(match_, begin_, prev_end);
+                else
+                    regex_ = nullptr;
+
+                return *this;
+            }
+
+            regex_iterator operator++(int)
+            {
+                auto tmp = *this;
+                ++(*this);
+
+                return tmp;
+            }
+
+        private:
+            BidirectionalIterator begin_;
+            BidirectionalIterator end_;
+            const regex_type* regex_;
+            regex_constants::match_flag_type flags_;
+            value_type match_;
+    };
+
+    using cregex_iterator  = regex_iterator<const char*>;
+    using wcregex_iterator = regex_iterator<const wchar_t*>;
+    using sregex_iterator  = regex_iterator<string::const_iterator>;
+    using wsregex_iterator = regex_iterator<wstring::const_iterator>;
+
+    /**
+     * 28.12.2, class template regex_token_iterator:
+     */
+
+    template<
+        class BidirectionalIterator,
+        class Char = typename iterator_traits<BidirectionalIterator>::value_type,
+        class Traits = regex_traits<Char>
+    >
+    class regex_token_iterator
+    {
+        public:
+            using regex_type        = basic_regex<Char, Traits>;
+            using value_type        = sub_match<BidirectionalIterator>;
+            using difference_type   = ptrdiff_t;
+            using pointer           = const value_type*;
+            using reference         = const value_type&;
+            using iterator_category = forward_iterator_tag;
+
+            regex_token_iterator()
+                : position_{}, result_{}, suffix_{}, n_{}, subs_{}
+            { /* DUMMY BODY */ }
+
+            regex_token_iterator(BidirectionalIterator first, BidirectionalIterator last,
+                                 const regex_type& re, int submatch = 0,
+                                 regex_constants::match_flag_type flags = regex_constants::match_default)
+                : position_{first, last, re, flags}, result_{}, suffix_{}, n_{},
+                  subs_{submatch}
+            {
+                init_(first, last);
+            }
+
+            regex_token_iterator(BidirectionalIterator first, BidirectionalIterator last,
+                                 const regex_type& re, const vector<int>& submatches,
+                                 regex_constants::match_flag_type flags = regex_constants::match_default)
+                : position_{first, last, re, flags}, result_{}, suffix_{}, n_{},
+                  subs_{submatches}
+            {
+                init_(first, last);
+            }
+
+            regex_token_iterator(BidirectionalIterator first, BidirectionalIterator last,
+                                 const regex_type& re, initializer_list<int> submatches,
+                                 regex_constants::match_flag_type flags = regex_constants::match_default)
+                : position_{first, last, re, flags}, result_{}, suffix_{}, n_{},
+                  subs_(submatches)
+            {
+                init_(first, last);
+            }
+
+            template<size_t N>
+            regex_token_iterator(BidirectionalIterator first, BidirectionalIterator last,
+                                 const regex_type& re, const int (&submatches)[N],
+                                 regex_constants::match_flag_type flags = regex_constants::match_default)
+                : position_{first, last, re, flags}, result_{}, suffix_{}, n_{},
+                  subs_(submatches, submatches + N)
+            {
+                init_(first, last);
+            }
+
+            regex_token_iterator(BidirectionalIterator, BidirectionalIterator,
+                                 const regex_type&&, int = 0,
+                                 regex_constants::match_flag_type =
+                                    regex_constants::match_default) = delete;
+
+            regex_token_iterator(BidirectionalIterator, BidirectionalIterator,
+                                 const regex_type&&, const vector<int>&,
+                                 regex_constants::match_flag_type =
+                                    regex_constants::match_default) = delete;
+
+            regex_token_iterator(BidirectionalIterator, BidirectionalIterator,
+                                 const regex_type&&, initializer_list<int>,
+                                 regex_constants::match_flag_type =
+                                    regex_constants::match_default) = delete;
+
+            template<size_t N>
+            regex_token_iterator(BidirectionalIterator, BidirectionalIterator,
+                                 const regex_type&&, const int (&)[N],
+                                 regex_constants::match_flag_type =
+                                    regex_constants::match_default) = delete;
+
+            regex_token_iterator(const regex_token_iterator& other)
+                : position_{other.position_}, result_{}, suffix_{other.suffix_},
+                  n_{other.n_}, subs_{other.subs_}
+            {
+                fix_result_(other);
+            }
+
+            regex_token_iterator& operator=(const regex_token_iterator& other)
+            {
+                position_ = other.position_;
+                suffix_ = other.suffix_;
+                n_ = other.n_;
+                subs_ = other.subs_;
+                fix_result_(other);
+
+                return *this;
+            }
+
+            bool operator==(const regex_token_iterator& other) const
+            {
+                if (!result_ || !other.result_)
+                    return !result_ && !other.result_;
+
+                bool suffix = result_ == &suffix_;
+                bool other_suffix = other.result_ == &other.suffix_;
+                if (suffix || other_suffix)
+                    return suffix && other_suffix && suffix_ == other.suffix_;
+
+                return position_ == other.position_ && n_ == other.n_
+                    && subs_ == other.subs_;
+            }
+
+            bool operator!=(const regex_token_iterator& other) const
+            {
+                return !(*this == other);
+            }
+
+            reference operator*() const
+            {
+                return *result_;
+            }
+
+            pointer operator->() const
+            {
+                return result_;
+            }
+
+            regex_token_iterator& operator++()
+            {
+                if (result_ == &suffix_)
+                {
+                    result_ = nullptr;
+
+                    return *this;
+                }
+
+                if (n_ + 1 < subs_.size())
+                {
+                    ++n_;
+                    result_ = &current_();
+
+                    return *this;
+                }
+
+                auto prev_suffix = position_->suffix();
+                n_ = 0;
+                ++position_;
+
+                if (position_ != position_iterator{})
+                    result_ = &current_();
+                else if (has_suffix_() && prev_suffix.length() != 0)
+                {
+                    suffix_ = prev_suffix;
+                    result_ = &suffix_;
+                }
+                else
+                    result_ = nullptr;
+
+                return *this;
+            }
+
+            regex_token_iterator operator++(int)
+            {
+                auto tmp = *this;
+                ++(*this);
+
+                return tmp;
+            }
+
+        private:
+            using position_iterator = regex_iterator<BidirectionalIterator, Char, Traits>;
+
+            position_iterator position_;
+            const value_type* result_;
+            value_type suffix_;
+            size_t n_;
+            vector<int> subs_;
+
+            bool has_suffix_() const
+            {
+                for (auto sub: subs_)
+                {
+                    if (sub == -1)
+                        return true;
+                }
+
+                return false;
+            }
+
+            const value_type& current_() const
+            {
+                if (subs_[n_] == -1)
+                    return position_->prefix();
+                else
+                    return (*position_)[subs_[n_]];
+            }
+
+            void init_(BidirectionalIterator first, BidirectionalIterator last)
+            {
+                if (position_ != position_iterator{})
+                    result_ = &current_();
+                else if (has_suffix_())
+                {
+                    suffix_.first = first;
+                    suffix_.second = last;
+                    suffix_.matched = first != last;
+                    result_ = &suffix_;
+                }
+                else
+                    result_ = nullptr;
+            }
+
+            void fix_result_(const regex_token_iterator& other)
+            {
+                if (!other.result_)
+                    result_ = nullptr;
+                else if (other.result_ == &other.suffix_)
+                    result_ = &suffix_;
+                else
+                    result_ = &current_();
+            }
+    };
+
+    using cregex_token_iterator  = regex_token_iterator<const char*>;
+    using wcregex_token_iterator = regex_token_iterator<const wchar_t*>;
+    using sregex_token_iterator  = regex_token_iterator<string::const_iterator>;
+    using wsregex_token_iterator = regex_token_iterator<wstring::const_iterator>;
+
+    /**
+     * 28.11.4, function template regex_replace:
+     */
+
+    template<class OutputIterator, class BidirectionalIterator,
+             class Traits, class Char, class ST, class SA>
+    OutputIterator regex_replace(OutputIterator out,
+                                 BidirectionalIterator first, BidirectionalIterator last,
+                                 const basic_regex<Char, Traits>& re,
+                                 const basic_string<Char, ST, SA>& fmt,
+                                 regex_constants::match_flag_type flags = regex_constants::match_default)
+    {
+        return regex_replace(out, first, last, re, fmt.c_str(), flags);
+    }
+
+    template<class OutputIterator, class BidirectionalIterator, class Traits, class Char>
+    OutputIterator regex_replace(OutputIterator out,
+                                 BidirectionalIterator first, BidirectionalIterator last,
+                                 const basic_regex<Char, Traits>& re, const Char* fmt,
+                                 regex_constants::match_flag_type flags = regex_constants::match_default)
+    {
+        using iterator = regex_iterator<BidirectionalIterator, Char, Traits>;
+
+        bool copy = !(flags & regex_constants::format_no_copy);
+        auto fmt_last = fmt + char_traits<Char>::length(fmt);
+
+        iterator it{first, last, re, flags};
+        iterator end{};
+        if (it == end)
+        {
+            if (copy)
+                out = std::copy(first, last, out);
+
+            return out;
+        }
+
+        sub_match<BidirectionalIterator> suffix{};
+        for (; it != end; ++it)
+        {
+            if (copy)
+                out = std::copy(it->prefix().first, it->prefix().second, out);
+            out = it->format(out, fmt, fmt_last, flags);
+
+            suffix = it->suffix();
+            if (flags & regex_constants::format_first_only)
+                break;
+        }
+
+        if (copy)
+            out = std::copy(suffix.first, suffix.second, out);
+
+        return out;
+    }
+
+    template<class Traits, class Char, class ST, class SA, class FST, class FSA>
+    basic_string<Char, ST, SA> regex_replace(
+        const basic_string<Char, ST, SA>& str, const basic_regex<Char, Traits>& re,
+        const basic_string<Char, FST, FSA>& fmt,
+        regex_constants::match_flag_type flags = regex_constants::match_default
+    )
+    {
+        basic_string<Char, ST, SA> res{};
+        regex_replace(back_inserter(res), str.begin(), str.end(), re, fmt.c_str(), flags);
+
+        return res;
+    }
+
+    template<class Traits, class Char, class ST, class SA>
+    basic_string<Char, ST, SA> regex_replace(
+        const basic_string<Char, ST, SA>& str, const basic_regex<Char, Traits>& re,
+        const Char* fmt,
+        regex_constants::match_flag_type flags = regex_constants::match_default
+    )
+    {
+        basic_string<Char, ST, SA> res{};
+        regex_replace(back_inserter(res), str.begin(), str.end(), re, fmt, flags);
+
+        return res;
+    }
+
+    template<class Traits, class Char, class ST, class SA>
+    basic_string<Char> regex_replace(
+        const Char* str, const basic_regex<Char, Traits>& re,
+        const basic_string<Char, ST, SA>& fmt,
+        regex_constants::match_flag_type flags = regex_constants::match_default
+    )
+    {
+        basic_string<Char> res{};
+        regex_replace(back_inserter(res), str, str + char_traits<Char>::length(str),
+                      re, fmt.c_str(), flags);
+
+        return res;
+    }
+
+    template<class Traits, class Char>
+    basic_string<Char> regex_replace(
+        const Char* str, const basic_regex<Char, Traits>& re, const Char* fmt,
+        regex_constants::match_flag_type flags = regex_constants::match_default
+    )
+    {
+        basic_string<Char> res{};
+        regex_replace(back_inserter(res), str, str + char_traits<Char>::length(str),
+                      re, fmt, flags);
+
+        return res;
+    }
+}
+
+#endif
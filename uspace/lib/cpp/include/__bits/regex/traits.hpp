@@ -0,0 +1,238 @@
+/*
+ * Copyright (c) 2019 Jaroslav Jindrak
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * - Redistributions of source code must retain the above copyright
+ *   notice, this list of conditions and the following disclaimer.
+ * - Redistributions in binary form must reproduce the above copyright
+ *   notice, this list of conditions and the following disclaimer in the
+ *   documentation and/or other materials provided with the distribution.
+ * - The name of the author may not be used to endorse or promote products
+ *   derived from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHOR ``AS IS'' AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+ * OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+ * IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT
+ * NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF
+ * THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef LIBCPP_BITS_REGEX_TRAITS
+#define LIBCPP_BITS_REGEX_TRAITS
+
+#include <cctype>
+#include <cstdint>
+#include <locale>
+#include <string>
+#include <type_traits>
+
+namespace std
+{
+    /**
+     * 28.7, class template regex_traits:
+     * Character classification is done by the C library, so only
+     * the ASCII range is classified and the locale is stored but
+     * otherwise ignored.
+     */
+
+    template<class Char>
+    class regex_traits
+    {
+        public:
+            using char_type       = Char;
+            using string_type     = basic_string<char_type>;
+            using locale_type     = locale;
+            using char_class_type = uint16_t;
+
+            regex_traits()
+                : loc_{}
+            { /* DUMMY BODY */ }
+
+            static size_t length(const char_type* str)
+            {
+                return char_traits<char_type>::length(str);
+            }
+
+            char_type translate(char_type c) const
+            {
+                return c;
+            }
+
+            char_type translate_nocase(char_type c) const
+            {
+                if (is_ascii_(c))
+                    return static_cast<char_type>(hel::tolower(to_int_(c)));
+                else
+                    return c;
+            }
+
+            template<class ForwardIterator>
+            string_type transform(ForwardIterator first, ForwardIterator last) const
+            {
+                return string_type(first, last);
+            }
+
+            template<class ForwardIterator>
+            string_type transform_primary(ForwardIterator first, ForwardIterator last) const
+            {
+                string_type res{};
+                for (; first != last; ++first)
+                    res.push_back(translate_nocase(*first));
+
+                return res;
+            }
+
+            /**
+             * Only single characters are valid collating
+             * elements in the C locale.
+             */
+            template<class ForwardIterator>
+            string_type lookup_collatename(ForwardIterator first, ForwardIterator last) const
+            {
+                string_type res(first, last);
+                if (res.size() != 1)
+                    res.clear();
+
+                return res;
+            }
+
+            template<class ForwardIterator>
+            char_class_type lookup_classname(ForwardIterator first, ForwardIterator last,
+                                             bool icase = false) const
+            {
+                char name[8]{};
+                size_t len{};
+                for (; first != last; ++first)
+                {
+                    if (len == sizeof(name) - 1 || !is_ascii_(*first))
+                        return char_class_type{};
+                    name[len++] = static_cast<char>(hel::tolower(to_int_(*first)));
+                }
+
+                for (const auto& cls: class_names_)
+                {
+                    if (char_traits<char>::compare(cls.name, name, len + 1) == 0)
+                    {
+                        if (icase && (cls.mask & (lower_ | upper_)))
+                            return alpha_;
+                        else
+                            return cls.mask;
+                    }
+                }
+
+                return char_class_type{};
+            }
+
+            bool isctype(char_type c, char_class_type mask) const
+            {
+                if (!is_ascii_(c))
+                    return false;
+
+                auto ch = to_int_(c);
+
+                return ((mask & alpha_) && hel::isalpha(ch))
+                    || ((mask & blank_) && hel::isblank(ch))
+                    || ((mask & cntrl_) && hel::iscntrl(ch))
+                    || ((mask & digit_) && hel::isdigit(ch))
+                    || ((mask & graph_) && hel::isgraph(ch))
+                    || ((mask & lower_) && hel::islower(ch))
+                    || ((mask & print_) && hel::isprint(ch))
+                    || ((mask & punct_) && hel::ispunct(ch))
+                    || ((mask & space_) && hel::isspace(ch))
+                    || ((mask & upper_) && hel::isupper(ch))
+                    || ((mask & xdigit_) && hel::isxdigit(ch))
+                    || ((mask & underscore_) && ch == '_');
+            }
+
+            int value(char_type c, int radix) const
+            {
+                if (!is_ascii_(c))
+                    return -1;
+
+                int res{};
+                auto ch = to_int_(c);
+                if (hel::isdigit(ch))
+                    res = ch - '0';
+                else if (hel::isxdigit(ch))
+                    res = hel::tolower(ch) - 'a' + 10;
+                else
+                    return -1;
+
+                return res < radix ? res : -1;
+            }
+
+            locale_type imbue(locale_type loc)
+            {
+                auto res = loc_;
+                loc_ = loc;
+
+                return res;
+            }
+
+            locale_type getloc() const
+            {
+                return loc_;
+            }
+
+        private:
+            static constexpr char_class_type alpha_      = 0b0000'0000'0000'0001;
+            static constexpr char_class_type blank_      = 0b0000'0000'0000'0010;
+            static constexpr char_class_type cntrl_      = 0b0000'0000'0000'0100;
+            static constexpr char_class_type digit_      = 0b0000'0000'0000'1000;
+            static constexpr char_class_type graph_      = 0b0000'0000'0001'0000;
+            static constexpr char_class_type lower_      = 0b0000'0000'0010'0000;
+            static constexpr char_class_type print_      = 0b0000'0000'0100'0000;
+            static constexpr char_class_type punct_      = 0b0000'0000'1000'0000;
+            static constexpr char_class_type space_      = 0b0000'0001'0000'0000;
+            static constexpr char_class_type upper_      = 0b0000'0010'0000'0000;
+            static constexpr char_class_type xdigit_     = 0b0000'0100'0000'0000;
+            static constexpr char_class_type underscore_ = 0b0000'1000'0000'0000;
+
+            struct class_name
+            {
+                const char* name;
+                char_class_type mask;
+            };
+
+            static constexpr class_name class_names_[]{
+                {"alnum", alpha_ | digit_},
+                {"alpha", alpha_},
+                {"blank", blank_},
+                {"cntrl", cntrl_},
+                {"d", digit_},
+                {"digit", digit_},
+                {"graph", graph_},
+                {"lower", lower_},
+                {"print", print_},
+                {"punct", punct_},
+                {"s", space_},
+                {"space", space_},
+                {"upper", upper_},
+                {"w", alpha_ | digit_ | underscore_},
+                {"xdigit", xdigit_}
+            };
+
+            static bool is_ascii_(char_type c)
+            {
+                return static_cast<make_unsigned_t<char_type>>(c) < 0x80;
+            }
+
+            static int to_int_(char_type c)
+            {
+                return static_cast<int>(static_cast<make_unsigned_t<char_type>>(c));
+            }
+
+            locale_type loc_;
+    };
+}
+
+#endif
@@ -462,8 +462,8 @@ namespace std
                  *  size() = 0
                  *  capacity() = unspecified
                  */
-                data_ = allocator_.allocate(default_capacity_);
-                capacity_ = default_capacity_;
+                set_local_();
+                ensure_null_terminator_();
             }
 
             basic_string(const basic_string& other)
@@ -474,12 +474,9 @@ namespace std
             }
 
             basic_string(basic_string&& other)
-                : data_{other.data_}, size_{other.size_},
-                  capacity_{other.capacity_}, allocator_{move(other.allocator_)}
+                : data_{}, size_{}, capacity_{}, allocator_{move(other.allocator_)}
             {
-                other.data_ = nullptr;
-                other.size_ = 0;
-                other.capacity_ = 0;
+                steal_(other);
             }
 
             basic_string(const basic_string& other, size_type pos, size_type n = npos,
@@ -504,9 +501,9 @@ namespace std
             }
 
             basic_string(size_type n, value_type c, const allocator_type& alloc = allocator_type{})
-                : data_{}, size_{n}, capacity_{n}, allocator_{alloc}
+                : data_{}, size_{n}, capacity_{}, allocator_{alloc}
             {
-                data_ = allocator_.allocate(capacity_);
+                allocate_(size_ + 1);
                 for (size_type i = 0; i < size_; ++i)
                     traits_type::assign(data_[i], c);
                 ensure_null_terminator_();
@@ -520,8 +517,7 @@ namespace std
                 if constexpr (is_integral<InputIterator>::value)
                 { // Required by the standard.
                     size_ = static_cast<size_type>(first);
-                    capacity_ = size_;
-                    data_ = allocator_.allocate(capacity_);
+                    allocate_(size_ + 1);
 
                     for (size_type i = 0; i < size_; ++i)
                         traits_type::assign(data_[i], static_cast<value_type>(last));
@@ -545,25 +541,24 @@ namespace std
             }
 
             basic_string(basic_string&& other, const allocator_type& alloc)
-                : data_{other.data_}, size_{other.size_}, capacity_{other.capacity_}, allocator_{alloc}
+                : data_{}, size_{}, capacity_{}, allocator_{alloc}
             {
-                other.data_ = nullptr;
-                other.size_ = 0;
-                other.capacity_ = 0;
+                steal_(other);
             }
 
             ~basic_string()
             {
-                allocator_.deallocate(data_, capacity_);
+                deallocate_();
             }
 
             basic_string& operator=(const basic_string& other)
             {
+                /**
+                 * Note: Assigning in place reuses our buffer
+                 *       when the other string fits in it.
+                 */
                 if (this != &other)
-                {
-                    basic_string tmp{other};
-                    swap(tmp);
-                }
+                    assign(other.data(), other.size());
 
                 return *this;
             }
@@ -580,16 +575,12 @@ namespace std
 
             basic_string& operator=(const value_type* other)
             {
-                *this = basic_string{other};
-
-                return *this;
+                return assign(other);
             }
 
             basic_string& operator=(value_type c)
             {
-                *this = basic_string{1, c};
-
-                return *this;
+                return assign(1, c);
             }
 
             basic_string& operator=(initializer_list<value_type> init)
@@ -690,7 +681,7 @@ namespace std
                 {
                     ensure_free_space_(new_size - size_ + 1);
                     for (size_type i = size_; i < new_size; ++i)
-                        traits_type::assign(data_[i], i);
+                        traits_type::assign(data_[i], c);
                 }
 
                 size_ = new_size;
@@ -704,7 +695,8 @@ namespace std
 
             size_type capacity() const noexcept
             {
-                return capacity_;
+                // The null terminator is not counted.
+                return capacity_ - 1;
             }
 
             void reserve(size_type new_capacity = 0)
@@ -712,16 +704,16 @@ namespace std
                 // TODO: if new_capacity > max_size() throw
                 //       length_error (this function shall have no
                 //       effect in such case)
-                if (new_capacity > capacity_)
-                    resize_with_copy_(size_, new_capacity);
-                else if (new_capacity < capacity_)
+                if (new_capacity + 1 > capacity_)
+                    resize_with_copy_(size_, new_capacity + 1);
+                else if (new_capacity + 1 < capacity_)
                     shrink_to_fit(); // Non-binding request, but why not.
             }
 
             void shrink_to_fit()
             {
-                if (size_ != capacity_)
-                    resize_with_copy_(size_, capacity_);
+                if (size_ + 1 < capacity_)
+                    resize_with_copy_(size_, size_ + 1);
             }
 
             void clear() noexcept
@@ -891,7 +883,10 @@ namespace std
             basic_string& assign(const value_type* str, size_type n)
             {
                 // TODO: if (n > max_size()) throw length_error.
-                resize_without_copy_(n);
+                if (data_ <= str && str < data_ + capacity_)
+                    return assign(basic_string{str, n});
+
+                resize_without_copy_(n + 1);
                 traits_type::copy(begin(), str, n);
                 size_ = n;
                 ensure_null_terminator_();
@@ -1067,7 +1062,7 @@ namespace std
                 auto len = min(n1, size_ - pos);
 
                 basic_string tmp{};
-                tmp.resize_without_copy_(size_ - len + n2);
+                tmp.resize_without_copy_(size_ - len + n2 + 1);
 
                 // Prefix.
                 copy_(begin(), begin() + pos, tmp.begin());
@@ -1079,6 +1074,7 @@ namespace std
                 copy_(begin() + pos + len, end(), tmp.begin() + pos + n2);
 
                 tmp.size_ = size_ - len + n2;
+                tmp.ensure_null_terminator_();
                 swap(tmp);
                 return *this;
             }
@@ -1144,9 +1140,23 @@ namespace std
                 noexcept(allocator_traits<allocator_type>::propagate_on_container_swap::value ||
                          allocator_traits<allocator_type>::is_always_equal::value)
             {
-                std::swap(data_, other.data_);
-                std::swap(size_, other.size_);
-                std::swap(capacity_, other.capacity_);
+                if (!is_local_() && !other.is_local_())
+                {
+                    std::swap(data_, other.data_);
+                    std::swap(size_, other.size_);
+                    std::swap(capacity_, other.capacity_);
+
+                    return;
+                }
+
+                /**
+                 * Inline buffers cannot change owners, so
+                 * go through a temporary that takes over
+                 * either the buffer or its contents.
+                 */
+                basic_string tmp{move(other)};
+                other.steal_(*this);
+                steal_(tmp);
             }
 
             /**
@@ -1460,31 +1470,90 @@ namespace std
             }
 
         private:
+            /**
+             * Short strings (including the null terminator)
+             * are stored in the inline buffer local_ and never
+             * touch the allocator. In that case data_ points
+             * to local_ and capacity_ is local_capacity_.
+             */
+            static constexpr size_type local_capacity_{
+                16 / sizeof(value_type) > 1 ? 16 / sizeof(value_type) : 2
+            };
+
             value_type* data_;
             size_type size_;
             size_type capacity_;
+            value_type local_[local_capacity_];
             allocator_type allocator_;
 
             template<class C, class T, class A>
             friend class basic_stringbuf;
 
+            bool is_local_() const noexcept
+            {
+                return data_ == local_;
+            }
+
+            void set_local_() noexcept
+            {
+                data_ = local_;
+                capacity_ = local_capacity_;
+            }
+
+            /**
+             * Sets up a buffer for at least capacity
+             * characters, previous buffer (if any) must
+             * have been released.
+             */
+            void allocate_(size_type capacity)
+            {
+                if (capacity <= local_capacity_)
+                    set_local_();
+                else
+                {
+                    data_ = allocator_.allocate(capacity);
+                    capacity_ = capacity;
+                }
+            }
+
+            void deallocate_()
+            {
+                if (data_ && !is_local_())
+                    allocator_.deallocate(data_, capacity_);
+                data_ = nullptr;
+            }
+
             /**
-             * Arbitrary value, standard just requires
-             * data() to have some capacity.
-             * (Well, we could've done data_ = &data_ and
-             * set capacity to 0, but that would be too cryptic.)
+             * Takes over the contents of other, which is left
+             * empty. Heap buffers are moved by pointer, only
+             * inline contents need to be copied.
              */
-            static constexpr size_type default_capacity_{4};
+            void steal_(basic_string& other) noexcept
+            {
+                if (other.is_local_())
+                {
+                    set_local_();
+                    traits_type::copy(data_, other.data_, other.size_ + 1);
+                }
+                else
+                {
+                    data_ = other.data_;
+                    capacity_ = other.capacity_;
+                }
+                size_ = other.size_;
+
+                other.set_local_();
+                other.size_ = 0;
+                other.ensure_null_terminator_();
+            }
 
             void init_(const value_type* str, size_type size)
             {
-                if (data_)
-                    allocator_.deallocate(data_, capacity_);
+                deallocate_();
 
                 size_ = size;
-                capacity_ = size + 1;
+                allocate_(size + 1);
 
-                data_ = allocator_.allocate(capacity_);
                 traits_type::copy(data_, str, size);
                 ensure_null_terminator_();
             }
@@ -1510,30 +1579,39 @@ namespace std
 
             void resize_without_copy_(size_type capacity)
             {
-                if (data_)
-                    allocator_.deallocate(data_, capacity_);
+                if (capacity > capacity_)
+                {
+                    deallocate_();
+                    allocate_(capacity);
+                }
 
-                data_ = allocator_.allocate(capacity);
                 size_ = 0;
-                capacity_ = capacity;
                 ensure_null_terminator_();
             }
 
             void resize_with_copy_(size_type size, size_type capacity)
             {
-                if(capacity_ == 0 || capacity_ < capacity)
+                if (capacity < size + 1)
+                    capacity = size + 1;
+
+                if (capacity != capacity_ && !(is_local_() && capacity <= local_capacity_))
                 {
-                    auto new_data = allocator_.allocate(capacity);
+                    value_type* new_data{local_};
+                    auto new_capacity = local_capacity_;
+                    if (capacity > local_capacity_)
+                    {
+                        new_data = allocator_.allocate(capacity);
+                        new_capacity = capacity;
+                    }
 
                     auto to_copy = min(size, size_);
                     traits_type::move(new_data, data_, to_copy);
 
-                    std::swap(data_, new_data);
-
-                    allocator_.deallocate(new_data, capacity_);
+                    deallocate_();
+                    data_ = new_data;
+                    capacity_ = new_capacity;
                 }
 
-                capacity_ = capacity;
                 size_ = size;
                 ensure_null_terminator_();
             }
@@ -1593,6 +1671,20 @@ namespace std
     using u32string = basic_string<char32_t>;
     using wstring   = basic_string<wchar_t>;
 
+    namespace pmr
+    {
+        template<class T>
+        class polymorphic_allocator;
+
+        template<class Char, class Traits = char_traits<Char>>
+        using basic_string = std::basic_string<Char, Traits, polymorphic_allocator<Char>>;
+
+        using string    = basic_string<char>;
+        using u16string = basic_string<char16_t>;
+        using u32string = basic_string<char32_t>;
+        using wstring   = basic_string<wchar_t>;
+    }
+
     /**
      * 21.4.8, basic_string non-member functions:
      */
@@ -1601,12 +1693,32 @@ namespace std
      * 21.4.8.1, operator+:
      */
 
+    namespace aux
+    {
+        /**
+         * Concatenates into a string that is allocated
+         * (if at all) only once.
+         */
+        template<class Char, class Traits, class Allocator>
+        basic_string<Char, Traits, Allocator>
+        concat(const basic_string<Char, Traits, Allocator>& lhs,
+               const Char* rhs, size_t rhs_size)
+        {
+            basic_string<Char, Traits, Allocator> res{lhs.get_allocator()};
+            res.reserve(lhs.size() + rhs_size);
+            res.append(lhs.data(), lhs.size());
+            res.append(rhs, rhs_size);
+
+            return res;
+        }
+    }
+
     template<class Char, class Traits, class Allocator>
     basic_string<Char, Traits, Allocator>
     operator+(const basic_string<Char, Traits, Allocator>& lhs,
               const basic_string<Char, Traits, Allocator>& rhs)
     {
-        return basic_string<Char, Traits, Allocator>{lhs}.append(rhs);
+        return aux::concat(lhs, rhs.data(), rhs.size());
     }
 
     template<class Char, class Traits, class Allocator>
@@ -1654,7 +1766,7 @@ namespace std
     operator+(Char lhs,
               const basic_string<Char, Traits, Allocator>& rhs)
     {
-        return basic_string<Char, Traits, Allocator>{1, lhs}.append(rhs);
+        return basic_string<Char, Traits, Allocator>(1, lhs).append(rhs);
     }
 
     template<class Char, class Traits, class Allocator>
@@ -1670,7 +1782,7 @@ namespace std
     operator+(const basic_string<Char, Traits, Allocator>& lhs,
               const Char* rhs)
     {
-        return lhs + basic_string<Char, Traits, Allocator>{rhs};
+        return aux::concat(lhs, rhs, Traits::length(rhs));
     }
 
     template<class Char, class Traits, class Allocator>
@@ -1686,7 +1798,7 @@ namespace std
     operator+(const basic_string<Char, Traits, Allocator>& lhs,
               Char rhs)
     {
-        return lhs + basic_string<Char, Traits, Allocator>{1, rhs};
+        return aux::concat(lhs, &rhs, 1);
     }
 
     template<class Char, class Traits, class Allocator>
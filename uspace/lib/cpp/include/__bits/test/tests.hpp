@@ -105,6 +105,9 @@ namespace std::test
             void test_construction_and_assignment();
             void test_insert();
             void test_erase();
+            void test_element_lifetimes();
+            void test_comparison();
+            void test_growth();
     };
 
     class string_test: public test_suite
@@ -123,6 +126,7 @@ namespace std::test
             void test_find();
             void test_substr();
             void test_compare();
+            void test_short_strings();
     };
 
     class bitset_test: public test_suite
@@ -177,6 +181,7 @@ namespace std::test
             void test_multi();
             void test_reverse_iterators();
             void test_multi_bounds_and_ranges();
+            void test_node_lifetimes();
     };
 
     class set_test: public test_suite
@@ -265,6 +270,7 @@ namespace std::test
         private:
             void test_construction_and_assignment();
             void test_modifiers();
+            void test_advance();
     };
 
     class ratio_test: public test_suite
@@ -285,6 +291,67 @@ namespace std::test
             void test_bind();
     };
 
+    class atomic_test: public test_suite
+    {
+        public:
+            bool run(bool) override;
+            const char* name() override;
+        private:
+            void test_integral();
+            void test_pointer();
+            void test_generic();
+            void test_flag();
+            void test_wait_notify();
+    };
+
+    class flat_hash_map_test: public test_suite
+    {
+        public:
+            bool run(bool) override;
+            const char* name() override;
+        private:
+            void test_insert_find();
+            void test_erase();
+            void test_growth();
+            void test_copy_move();
+    };
+
+    class iostream_test: public test_suite
+    {
+        public:
+            bool run(bool) override;
+            const char* name() override;
+
+        private:
+            void test_integral();
+            void test_floating();
+            void test_stringstream();
+            void test_fstream();
+    };
+
+    class future_test: public test_suite
+    {
+        public:
+            bool run(bool) override;
+            const char* name() override;
+        private:
+            void test_async();
+            void test_deferred();
+            void test_shared_future();
+            void test_nested();
+    };
+
+    class memory_resource_test: public test_suite
+    {
+        public:
+            bool run(bool) override;
+            const char* name() override;
+        private:
+            void test_monotonic();
+            void test_pools();
+            void test_containers();
+    };
+
     class algorithm_test: public test_suite
     {
         public:
@@ -293,6 +360,36 @@ namespace std::test
         private:
             void test_non_modifying();
             void test_mutating();
+            void test_sorting();
+    };
+
+    class valarray_test: public test_suite
+    {
+        public:
+            bool run(bool) override;
+            const char* name() override;
+        private:
+            void test_construction();
+            void test_operations();
+            void test_members();
+            void test_slices();
+            void test_masks();
+            void test_expression_subsets();
+    };
+
+    class regex_test: public test_suite
+    {
+        public:
+            bool run(bool) override;
+            const char* name() override;
+        private:
+            void test_compile();
+            void test_match();
+            void test_search();
+            void test_assertions();
+            void test_iterators();
+            void test_replace();
+            void test_engines();
     };
 }
 
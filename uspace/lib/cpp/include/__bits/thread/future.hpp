@@ -29,9 +29,14 @@
 #ifndef LIBCPP_BITS_THREAD_FUTURE
 #define LIBCPP_BITS_THREAD_FUTURE
 
+#include <__bits/thread/threading.hpp>
+#include <chrono>
+#include <functional>
 #include <memory>
 #include <system_error>
+#include <tuple>
 #include <type_traits>
+#include <utility>
 
 namespace std
 {
@@ -49,10 +54,53 @@ namespace std
 
     enum class launch
     {
-        async,
-        deferred
+        async = 0x1,
+        deferred = 0x2
     };
 
+    constexpr launch operator&(launch lhs, launch rhs)
+    {
+        return static_cast<launch>(
+            static_cast<int>(lhs) & static_cast<int>(rhs)
+        );
+    }
+
+    constexpr launch operator|(launch lhs, launch rhs)
+    {
+        return static_cast<launch>(
+            static_cast<int>(lhs) | static_cast<int>(rhs)
+        );
+    }
+
+    constexpr launch operator^(launch lhs, launch rhs)
+    {
+        return static_cast<launch>(
+            static_cast<int>(lhs) ^ static_cast<int>(rhs)
+        );
+    }
+
+    constexpr launch operator~(launch lhs)
+    {
+        return static_cast<launch>(
+            ~static_cast<int>(lhs) & 0x3
+        );
+    }
+
+    inline launch& operator&=(launch& lhs, launch rhs)
+    {
+        return lhs = lhs & rhs;
+    }
+
+    inline launch& operator|=(launch& lhs, launch rhs)
+    {
+        return lhs = lhs | rhs;
+    }
+
+    inline launch& operator^=(launch& lhs, launch rhs)
+    {
+        return lhs = lhs ^ rhs;
+    }
+
     enum class future_status
     {
         ready,
@@ -88,9 +136,299 @@ namespace std
             error_code code_;
     };
 
-    /**
-     * 30.6.4, shared state:
-     */
+    namespace aux
+    {
+        /**
+         * A unit of work for the process wide pool that
+         * runs std::async tasks. The pool keeps one worker
+         * fibril and one fibril runner thread per CPU, so tasks
+         * submitted to it are spread across all cores without
+         * creating a thread per task. While workers are blocked
+         * waiting for queued tasks, temporary workers are added.
+         * The pool takes ownership of submitted tasks and
+         * deletes them after they are run.
+         */
+        class pool_task
+        {
+            public:
+                virtual ~pool_task() = default;
+
+                virtual void run() = 0;
+
+            private:
+                pool_task* next_{nullptr};
+
+                friend class async_pool;
+        };
+
+        void async_submit(pool_task* task);
+        bool async_ensure_worker();
+
+        /**
+         * 30.6.4, shared state:
+         */
+
+        class shared_state_base
+        {
+            public:
+                shared_state_base()
+                    : mtx_{}, cv_{}, ready_{false}, claimed_{true},
+                      deferred_{false}, wait_on_release_{false}, owners_{1}
+                {
+                    threading::mutex::init(mtx_);
+                    threading::condvar::init(cv_);
+                }
+
+                shared_state_base(const shared_state_base&) = delete;
+                shared_state_base& operator=(const shared_state_base&) = delete;
+
+                virtual ~shared_state_base() = default;
+
+                /**
+                 * Runs the function associated with this state
+                 * unless someone else already took it.
+                 */
+                void run()
+                {
+                    if (claim_())
+                        execute_();
+                }
+
+                void wait()
+                {
+                    /**
+                     * Note: A deferred function is run by the first
+                     *       fibril that waits for it. A function
+                     *       launched with launch::async always runs
+                     *       in a pool worker as if in a new thread;
+                     *       if it is still queued, we make sure there
+                     *       is a worker to take it, so that nested
+                     *       async calls cannot exhaust the pool. Only
+                     *       if no worker can be created, we run the
+                     *       function ourselves rather than block
+                     *       forever.
+                     */
+                    if (deferred_ || (!started_() && !async_ensure_worker()))
+                        run();
+
+                    threading::mutex::lock(mtx_);
+                    while (!ready_)
+                        threading::condvar::wait(cv_, mtx_);
+                    threading::mutex::unlock(mtx_);
+                }
+
+                template<class Rep, class Period>
+                future_status wait_for(const chrono::duration<Rep, Period>& rel_time)
+                {
+                    return wait_until(chrono::steady_clock::now() + rel_time);
+                }
+
+                template<class Clock, class Duration>
+                future_status wait_until(const chrono::time_point<Clock, Duration>& abs_time)
+                {
+                    threading::mutex::lock(mtx_);
+                    if (deferred_ && !claimed_)
+                    {
+                        threading::mutex::unlock(mtx_);
+
+                        return future_status::deferred;
+                    }
+
+                    threading::mutex::unlock(mtx_);
+
+                    if (!started_())
+                        async_ensure_worker();
+
+                    threading::mutex::lock(mtx_);
+                    while (!ready_)
+                    {
+                        auto now = Clock::now();
+                        if (now >= abs_time)
+                            break;
+
+                        /**
+                         * Note: Zero timeout means no timeout at all
+                         *       for fibril condition variables.
+                         */
+                        auto timeout = threading::time::convert(abs_time - now);
+                        threading::condvar::wait_for(
+                            cv_, mtx_, timeout > 0 ? timeout : 1
+                        );
+                    }
+
+                    auto status = ready_ ? future_status::ready : future_status::timeout;
+                    threading::mutex::unlock(mtx_);
+
+                    return status;
+                }
+
+                bool is_ready()
+                {
+                    threading::mutex::lock(mtx_);
+                    auto res = ready_;
+                    threading::mutex::unlock(mtx_);
+
+                    return res;
+                }
+
+                /**
+                 * Futures and shared futures referring to this
+                 * state. The state itself is reference counted by
+                 * shared_ptr, but the pool holds a reference as well
+                 * so that count cannot tell us when the last future
+                 * goes away.
+                 */
+                void acquire()
+                {
+                    threading::mutex::lock(mtx_);
+                    ++owners_;
+                    threading::mutex::unlock(mtx_);
+                }
+
+                void release()
+                {
+                    threading::mutex::lock(mtx_);
+                    auto last = (--owners_ == 0);
+                    threading::mutex::unlock(mtx_);
+
+                    /**
+                     * 30.6.8 (5.4): The last future referring
+                     * to a state created by async with launch::async
+                     * blocks until the function finishes.
+                     */
+                    if (last && wait_on_release_)
+                        wait();
+                }
+
+            protected:
+                aux::mutex_t mtx_;
+                aux::condvar_t cv_;
+                bool ready_;
+                bool claimed_;
+                bool deferred_;
+                bool wait_on_release_;
+                size_t owners_;
+
+                void mark_ready_()
+                {
+                    threading::mutex::lock(mtx_);
+                    ready_ = true;
+                    threading::condvar::broadcast(cv_);
+                    threading::mutex::unlock(mtx_);
+                }
+
+                bool started_()
+                {
+                    threading::mutex::lock(mtx_);
+                    auto res = claimed_;
+                    threading::mutex::unlock(mtx_);
+
+                    return res;
+                }
+
+                bool claim_()
+                {
+                    threading::mutex::lock(mtx_);
+                    auto res = !claimed_;
+                    claimed_ = true;
+                    threading::mutex::unlock(mtx_);
+
+                    return res;
+                }
+
+                virtual void execute_()
+                { /* DUMMY BODY */ }
+        };
+
+        template<class R>
+        class shared_state: public shared_state_base
+        {
+            public:
+                shared_state()
+                    : shared_state_base{}, value_{}, has_value_{false}
+                { /* DUMMY BODY */ }
+
+                ~shared_state()
+                {
+                    if (has_value_)
+                        value_ptr_()->~R();
+                }
+
+                template<class... Args>
+                void set_value(Args&&... args)
+                {
+                    ::new(static_cast<void*>(&value_)) R(forward<Args>(args)...);
+                    has_value_ = true;
+
+                    mark_ready_();
+                }
+
+                R& get()
+                {
+                    wait();
+
+                    return *value_ptr_();
+                }
+
+            private:
+                aligned_storage_t<sizeof(R), alignof(R)> value_;
+                bool has_value_;
+
+                R* value_ptr_()
+                {
+                    return static_cast<R*>(static_cast<void*>(&value_));
+                }
+        };
+
+        template<class R>
+        class shared_state<R&>: public shared_state_base
+        {
+            public:
+                shared_state()
+                    : shared_state_base{}, value_{}
+                { /* DUMMY BODY */ }
+
+                void set_value(R& val)
+                {
+                    value_ = addressof(val);
+
+                    mark_ready_();
+                }
+
+                R& get()
+                {
+                    wait();
+
+                    return *value_;
+                }
+
+            private:
+                R* value_;
+        };
+
+        template<>
+        class shared_state<void>: public shared_state_base
+        {
+            public:
+                void set_value()
+                {
+                    mark_ready_();
+                }
+
+                void get()
+                {
+                    wait();
+                }
+        };
+
+        template<class R>
+        using shared_state_ptr = shared_ptr<shared_state<R>>;
+
+        template<class R>
+        using shared_future_result_t = conditional_t<
+            is_reference_v<R> || is_void_v<R>, R, const R&
+        >;
+    }
 
     template<class R>
     class promise
@@ -118,33 +456,209 @@ namespace std
     { /* DUMMY BODY */ };
 
     template<class R>
-    class future
-    {
-    };
+    class shared_future;
+
+    /**
+     * 30.6.6, class template future:
+     * Note: The R& and void specializations differ only
+     *       in the return type of get(), which the shared
+     *       state already provides, so one template covers
+     *       all three cases.
+     */
 
     template<class R>
-    class future<R&>
+    class future
     {
-    };
+        public:
+            future() noexcept
+                : state_{}
+            { /* DUMMY BODY */ }
+
+            explicit future(aux::shared_state_ptr<R> state)
+                : state_{move(state)}
+            { /* DUMMY BODY */ }
+
+            future(const future&) = delete;
+
+            future(future&& rhs) noexcept
+                : state_{move(rhs.state_)}
+            { /* DUMMY BODY */ }
+
+            ~future()
+            {
+                release_();
+            }
+
+            future& operator=(const future&) = delete;
+
+            future& operator=(future&& rhs) noexcept
+            {
+                if (this != &rhs)
+                {
+                    release_();
+                    state_ = move(rhs.state_);
+                }
+
+                return *this;
+            }
+
+            shared_future<R> share()
+            {
+                return shared_future<R>{move(*this)};
+            }
+
+            R get()
+            {
+                auto state = move(state_);
+                auto guard = release_guard_{state};
+
+                if constexpr (is_void_v<R> || is_reference_v<R>)
+                    return state->get();
+                else
+                    return move(state->get());
+            }
+
+            bool valid() const noexcept
+            {
+                return static_cast<bool>(state_);
+            }
+
+            void wait() const
+            {
+                state_->wait();
+            }
+
+            template<class Rep, class Period>
+            future_status wait_for(const chrono::duration<Rep, Period>& rel_time) const
+            {
+                return state_->wait_for(rel_time);
+            }
+
+            template<class Clock, class Duration>
+            future_status wait_until(const chrono::time_point<Clock, Duration>& abs_time) const
+            {
+                return state_->wait_until(abs_time);
+            }
 
-    template<>
-    class future<void>
-    {
+        private:
+            aux::shared_state_ptr<R> state_;
+
+            struct release_guard_
+            {
+                aux::shared_state_ptr<R>& state;
+
+                ~release_guard_()
+                {
+                    state->release();
+                }
+            };
+
+            void release_()
+            {
+                if (state_)
+                {
+                    state_->release();
+                    state_.reset();
+                }
+            }
+
+            friend class shared_future<R>;
     };
 
-    template<class R>
-    class shared_future
-    {
-    };
+    /**
+     * 30.6.7, class template shared_future:
+     */
 
     template<class R>
-    class shared_future<R&>
+    class shared_future
     {
-    };
+        public:
+            shared_future() noexcept
+                : state_{}
+            { /* DUMMY BODY */ }
+
+            shared_future(const shared_future& rhs)
+                : state_{rhs.state_}
+            {
+                if (state_)
+                    state_->acquire();
+            }
+
+            shared_future(future<R>&& rhs) noexcept
+                : state_{move(rhs.state_)}
+            { /* DUMMY BODY */ }
+
+            shared_future(shared_future&& rhs) noexcept
+                : state_{move(rhs.state_)}
+            { /* DUMMY BODY */ }
+
+            ~shared_future()
+            {
+                release_();
+            }
+
+            shared_future& operator=(const shared_future& rhs)
+            {
+                if (this != &rhs)
+                {
+                    release_();
+                    state_ = rhs.state_;
+                    if (state_)
+                        state_->acquire();
+                }
+
+                return *this;
+            }
+
+            shared_future& operator=(shared_future&& rhs) noexcept
+            {
+                if (this != &rhs)
+                {
+                    release_();
+                    state_ = move(rhs.state_);
+                }
+
+                return *this;
+            }
+
+            aux::shared_future_result_t<R> get() const
+            {
+                return state_->get();
+            }
+
+            bool valid() const noexcept
+            {
+                return static_cast<bool>(state_);
+            }
+
+            void wait() const
+            {
+                state_->wait();
+            }
+
+            template<class Rep, class Period>
+            future_status wait_for(const chrono::duration<Rep, Period>& rel_time) const
+            {
+                return state_->wait_for(rel_time);
+            }
+
+            template<class Clock, class Duration>
+            future_status wait_until(const chrono::time_point<Clock, Duration>& abs_time) const
+            {
+                return state_->wait_until(abs_time);
+            }
 
-    template<>
-    class shared_future<void>
-    {
+        private:
+            aux::shared_state_ptr<R> state_;
+
+            void release_()
+            {
+                if (state_)
+                {
+                    state_->release();
+                    state_.reset();
+                }
+            }
     };
 
     template<class>
@@ -165,18 +679,132 @@ namespace std
     struct uses_allocator<packaged_task<R>, Alloc>: true_type
     { /* DUMMY BODY */ };
 
+    namespace aux
+    {
+        /**
+         * Decayed copies of the function and its arguments,
+         * as required by 30.6.8 (3).
+         * Note: We use tuple_impl directly because the forwarding
+         *       constructor of tuple is not viable at the moment,
+         *       which would prevent move only arguments.
+         */
+        template<class F, class... Args>
+        class async_callable
+        {
+            public:
+                template<class G, class... As>
+                async_callable(G&& g, As&&... as)
+                    : func_{forward<G>(g)}, args_{forward<As>(as)...}
+                { /* DUMMY BODY */ }
+
+                decltype(auto) operator()()
+                {
+                    return call_(index_sequence_type{});
+                }
+
+            private:
+                using index_sequence_type = make_index_sequence<sizeof...(Args)>;
+
+                F func_;
+                tuple_impl<index_sequence_type, Args...> args_;
+
+                template<size_t... Is>
+                decltype(auto) call_(index_sequence<Is...>)
+                {
+                    return invoke(
+                        move(func_),
+                        move(static_cast<tuple_element_wrapper<Is, Args>&>(args_).value)...
+                    );
+                }
+        };
+
+        template<class R, class Callable>
+        class async_shared_state: public shared_state<R>
+        {
+            public:
+                async_shared_state(Callable&& clbl, bool deferred)
+                    : shared_state<R>{}, callable_{move(clbl)}
+                {
+                    this->claimed_ = false;
+                    this->deferred_ = deferred;
+                    this->wait_on_release_ = !deferred;
+                }
+
+            protected:
+                void execute_() override
+                {
+                    if constexpr (is_void_v<R>)
+                    {
+                        callable_();
+                        this->set_value();
+                    }
+                    else
+                        this->set_value(callable_());
+                }
+
+            private:
+                Callable callable_;
+        };
+
+        template<class R>
+        class async_task: public pool_task
+        {
+            public:
+                async_task(shared_state_ptr<R> state)
+                    : state_{move(state)}
+                { /* DUMMY BODY */ }
+
+                void run() override
+                {
+                    state_->run();
+                }
+
+            private:
+                shared_state_ptr<R> state_;
+        };
+    }
+
+    /**
+     * 30.6.8, function template async:
+     */
+
     template<class F, class... Args>
     future<result_of_t<decay_t<F>(decay_t<Args>...)>>
-    async(F&& f, Args&&... args)
+    async(launch policy, F&& f, Args&&... args)
     {
-        // TODO: implement
+        using result_type = result_of_t<decay_t<F>(decay_t<Args>...)>;
+        using callable_type = aux::async_callable<decay_t<F>, decay_t<Args>...>;
+        using state_type = aux::async_shared_state<result_type, callable_type>;
+
+        /**
+         * Note: When both policies are allowed, we choose
+         *       launch::async to get the parallelism.
+         */
+        bool deferred = (policy & launch::async) != launch::async;
+
+        aux::shared_state<result_type>* ptr = new state_type{
+            callable_type{forward<F>(f), forward<Args>(args)...},
+            deferred
+        };
+        aux::shared_state_ptr<result_type> state{ptr};
+
+        if (!deferred)
+            aux::async_submit(new aux::async_task<result_type>{state});
+
+        return future<result_type>{move(state)};
     }
 
-    template<class F, class... Args>
+    template<
+        class F, class... Args,
+        class = enable_if_t<!is_same_v<decay_t<F>, launch>>
+    >
     future<result_of_t<decay_t<F>(decay_t<Args>...)>>
-    async(launch, F&& f, Args&&... args)
+    async(F&& f, Args&&... args)
     {
-        // TODO: implement
+        return async(
+            launch::async | launch::deferred,
+            forward<F>(f), forward<Args>(args)...
+        );
     }
 }
 
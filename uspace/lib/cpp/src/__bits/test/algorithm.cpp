@@ -29,8 +29,10 @@
 #include <__bits/test/tests.hpp>
 #include <algorithm>
 #include <array>
+#include <functional>
 #include <string>
 #include <utility>
+#include <vector>
 
 namespace std::test
 {
@@ -41,6 +43,7 @@ namespace std::test
 
         test_non_modifying();
         test_mutating();
+        test_sorting();
 
         return end();
     }
@@ -292,5 +295,140 @@ namespace std::test
             data10.begin(), data10.end()
         );
         test_eq("transform pt2", res6, data10.end());
+
+        auto check8 = {1, 2, 3, 1, 4};
+        std::vector<int> data11{1, 1, 2, 3, 3, 3, 1, 4, 4};
+
+        auto res7 = std::unique(data11.begin(), data11.end());
+        test_eq(
+            "unique pt1",
+            check8.begin(), check8.end(),
+            data11.begin(), res7
+        );
+
+        auto check9 = {1, 4, 7};
+        std::vector<int> data12{1, 2, 4, 5, 6, 7};
+
+        auto res8 = std::unique(
+            data12.begin(), data12.end(),
+            [](auto x, auto y){ return y - x < 3; }
+        );
+        test_eq(
+            "unique pt2",
+            check9.begin(), check9.end(),
+            data12.begin(), res8
+        );
+
+        std::vector<std::string> data13{"a", "a", "b"};
+        auto res9 = std::unique(data13.begin(), data13.end());
+        test_eq("unique pt3", res9 - data13.begin(), 2l);
+        test_eq("unique pt4", data13[1], std::string{"b"});
+
+        std::vector<int> data14{};
+        test("unique pt5", std::unique(data14.begin(), data14.end()) == data14.end());
+    }
+    void algorithm_test::test_sorting()
+    {
+        /**
+         * Large enough to go through partitioning and merging
+         * rather than just the insertion sort cutoff, the values
+         * repeat to exercise equal keys.
+         */
+        std::vector<int> data1{};
+        for (int i = 0; i < 500; ++i)
+            data1.push_back((i * 7919) % 97);
+
+        auto check1 = data1;
+        std::make_heap(check1.begin(), check1.end());
+        std::sort_heap(check1.begin(), check1.end());
+        test("sort_heap", std::is_sorted(check1.begin(), check1.end()));
+
+        auto data2 = data1;
+        std::sort(data2.begin(), data2.end());
+        test_eq(
+            "sort pt1", check1.begin(), check1.end(),
+            data2.begin(), data2.end()
+        );
+
+        std::sort(data2.begin(), data2.end(), std::greater<int>{});
+        test("sort pt2", std::is_sorted(data2.rbegin(), data2.rend()));
+
+        // Already sorted input must not degrade.
+        std::sort(data2.begin(), data2.end());
+        test_eq(
+            "sort pt3", check1.begin(), check1.end(),
+            data2.begin(), data2.end()
+        );
+
+        std::vector<std::pair<int, int>> data3{};
+        for (int i = 0; i < 500; ++i)
+            data3.emplace_back(data1[i] % 10, i);
+
+        std::stable_sort(
+            data3.begin(), data3.end(),
+            [](const auto& lhs, const auto& rhs){
+                return lhs.first < rhs.first;
+            }
+        );
+        test("stable_sort pt1", std::is_sorted(data3.begin(), data3.end()));
+
+        auto data4 = data1;
+        std::partial_sort(data4.begin(), data4.begin() + 20, data4.end());
+        test_eq(
+            "partial_sort", check1.begin(), check1.begin() + 20,
+            data4.begin(), data4.begin() + 20
+        );
+
+        std::array<int, 20> data5{};
+        auto res1 = std::partial_sort_copy(
+            data1.begin(), data1.end(),
+            data5.begin(), data5.end()
+        );
+        test_eq(
+            "partial_sort_copy pt1", check1.begin(), check1.begin() + 20,
+            data5.begin(), data5.end()
+        );
+        test_eq("partial_sort_copy pt2", res1, data5.end());
+
+        auto check2 = {1, 2, 3};
+        std::array<int, 5> data6{};
+        auto res2 = std::partial_sort_copy(
+            check2.begin(), check2.end(),
+            data6.begin(), data6.end()
+        );
+        test_eq("partial_sort_copy pt3", res2, data6.begin() + 3);
+
+        bool nth_ok{true};
+        for (int n: {0, 1, 250, 498, 499})
+        {
+            auto data7 = data1;
+            std::nth_element(data7.begin(), data7.begin() + n, data7.end());
+
+            auto nth = data7[n];
+            if (nth != check1[n] ||
+                std::any_of(data7.begin(), data7.begin() + n,
+                            [nth](auto x){ return x > nth; }) ||
+                std::any_of(data7.begin() + n, data7.end(),
+                            [nth](auto x){ return x < nth; }))
+            {
+                nth_ok = false;
+            }
+        }
+        test("nth_element", nth_ok);
+
+        auto res3 = std::lower_bound(check1.begin(), check1.end(), 50);
+        auto res4 = std::upper_bound(check1.begin(), check1.end(), 50);
+        test_eq("lower_bound", *res3, 50);
+        test("upper_bound pt1", *res4 > 50);
+        test("upper_bound pt2", *(res4 - 1) == 50);
+
+        auto check3 = {3, 4, 5, 1, 2};
+        std::array<int, 5> data8{1, 2, 3, 4, 5};
+        auto res5 = std::rotate(data8.begin(), data8.begin() + 2, data8.end());
+        test_eq(
+            "rotate pt1", check3.begin(), check3.end(),
+            data8.begin(), data8.end()
+        );
+        test_eq("rotate pt2", res5, data8.begin() + 3);
     }
 }
@@ -0,0 +1,170 @@
+/*
+ * Copyright (c) 2019 Jaroslav Jindrak
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * - Redistributions of source code must retain the above copyright
+ *   notice, this list of conditions and the following disclaimer.
+ * - Redistributions in binary form must reproduce the above copyright
+ *   notice, this list of conditions and the following disclaimer in the
+ *   documentation and/or other materials provided with the distribution.
+ * - The name of the author may not be used to endorse or promote products
+ *   derived from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHOR ``AS IS'' AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+ * OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+ * IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT
+ * NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF
+ * THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <__bits/test/tests.hpp>
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <thread>
+
+namespace std::test
+{
+    bool atomic_test::run(bool report)
+    {
+        report_ = report;
+        start();
+
+        test_integral();
+        test_pointer();
+        test_generic();
+        test_flag();
+        test_wait_notify();
+
+        return end();
+    }
+
+    const char* atomic_test::name()
+    {
+        return "atomic";
+    }
+
+    void atomic_test::test_integral()
+    {
+        std::atomic<int> a{5};
+        test_eq("lock free int", a.is_lock_free(), true);
+        test_eq("load", a.load(), 5);
+
+        a.store(7, std::memory_order_release);
+        test_eq("store", a.load(std::memory_order_acquire), 7);
+
+        test_eq("fetch_add old", a.fetch_add(3), 7);
+        test_eq("fetch_add new", a.load(), 10);
+        test_eq("fetch_sub old", a.fetch_sub(4), 10);
+        test_eq("fetch_and", (a.fetch_and(0x4), a.load()), 4);
+        test_eq("fetch_or", (a.fetch_or(0x3), a.load()), 7);
+        test_eq("fetch_xor", (a.fetch_xor(0x5), a.load()), 2);
+
+        test_eq("pre-increment", ++a, 3);
+        test_eq("post-increment", a++, 3);
+        test_eq("pre-decrement", --a, 3);
+        test_eq("compound add", a += 10, 13);
+        test_eq("compound sub", a -= 3, 10);
+        test_eq("exchange", a.exchange(42), 10);
+        test_eq("assignment", (a = 11), 11);
+
+        int expected{0};
+        test_eq("cmpxchg fail", a.compare_exchange_strong(expected, 1), false);
+        test_eq("cmpxchg fail expected", expected, 11);
+        test_eq("cmpxchg success", a.compare_exchange_strong(expected, 1), true);
+        test_eq("cmpxchg success value", a.load(), 1);
+
+        std::atomic<std::uint8_t> u{255};
+        ++u;
+        test_eq("unsigned wraparound", (unsigned)u.load(), 0U);
+
+        std::atomic_long l{};
+        std::atomic_init(&l, 3L);
+        std::atomic_fetch_add_explicit(&l, 2L, std::memory_order_relaxed);
+        test_eq("free functions", std::atomic_load(&l), 5L);
+    }
+
+    void atomic_test::test_pointer()
+    {
+        int arr[]{1, 2, 3, 4, 5};
+        std::atomic<int*> p{arr};
+
+        test_eq("pointer fetch_add", p.fetch_add(2), &arr[0]);
+        test_eq("pointer after fetch_add", p.load(), &arr[2]);
+        test_eq("pointer pre-increment", ++p, &arr[3]);
+        test_eq("pointer compound sub", p -= 3, &arr[0]);
+        test_eq("pointer deref", *p.load(), 1);
+    }
+
+    namespace
+    {
+        struct triple
+        {
+            std::uint32_t a, b, c;
+        };
+    }
+
+    void atomic_test::test_generic()
+    {
+        std::atomic<triple> t{triple{1, 2, 3}};
+        triple res = t.load();
+        test_eq("generic load", res.a + res.b + res.c, 6U);
+
+        triple expected{1, 2, 3};
+        test_eq("generic cmpxchg", t.compare_exchange_strong(expected, triple{4, 5, 6}), true);
+        res = t.exchange(triple{7, 8, 9});
+        test_eq("generic exchange", res.c, 6U);
+        test_eq("generic after exchange", t.load().a, 7U);
+
+        std::atomic<bool> b{false};
+        test_eq("bool exchange", b.exchange(true), false);
+        test_eq("bool load", b.load(), true);
+    }
+
+    void atomic_test::test_flag()
+    {
+        std::atomic_flag flag = ATOMIC_FLAG_INIT;
+
+        test_eq("flag test_and_set initial", flag.test_and_set(), false);
+        test_eq("flag test_and_set second", flag.test_and_set(), true);
+        flag.clear();
+        test_eq("flag cleared", flag.test(), false);
+    }
+
+    void atomic_test::test_wait_notify()
+    {
+        std::atomic<int> state{0};
+
+        std::thread thr{[&state](){
+            state.wait(0);
+            state.store(2);
+            state.notify_one();
+        }};
+
+        state.store(1);
+        state.notify_one();
+        state.wait(1);
+        thr.join();
+
+        test_eq("wait/notify", state.load(), 2);
+
+        auto sp = std::make_shared<int>(1);
+        std::weak_ptr<int> wp{sp};
+        {
+            auto sp2 = sp;
+            test_eq("shared_ptr use_count", sp.use_count(), 2L);
+        }
+        test_eq("shared_ptr use_count after release", sp.use_count(), 1L);
+        sp.reset();
+        test_eq("weak_ptr expired", wp.expired(), true);
+    }
+}
@@ -0,0 +1,206 @@
+/*
+ * Copyright (c) 2019 Jaroslav Jindrak
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * - Redistributions of source code must retain the above copyright
+ *   notice, this list of conditions and the following disclaimer.
+ * - Redistributions in binary form must reproduce the above copyright
+ *   notice, this list of conditions and the following disclaimer in the
+ *   documentation and/or other materials provided with the distribution.
+ * - The name of the author may not be used to endorse or promote products
+ *   derived from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHOR ``AS IS'' AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+ * OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+ * IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT
+ * NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF
+ * THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <__bits/test/tests.hpp>
+#include <flat_hash_map>
+#include <initializer_list>
+#include <string>
+#include <utility>
+
+namespace std::test
+{
+    bool flat_hash_map_test::run(bool report)
+    {
+        report_ = report;
+        start();
+
+        test_insert_find();
+        test_erase();
+        test_growth();
+        test_copy_move();
+
+        return end();
+    }
+
+    const char* flat_hash_map_test::name()
+    {
+        return "flat_hash_map";
+    }
+
+    void flat_hash_map_test::test_insert_find()
+    {
+        std::hel::flat_hash_map<int, int> map1{};
+        test("default constructed empty", map1.empty());
+        test("find in empty", map1.find(1) == map1.end());
+        test("begin == end in empty", map1.begin() == map1.end());
+
+        auto res1 = map1.insert(std::pair<const int, int>{1, 10});
+        test("insert new", res1.second);
+        test_eq("insert new value", res1.first->second, 10);
+
+        auto res2 = map1.insert(std::pair<const int, int>{1, 20});
+        test("insert existing", !res2.second);
+        test_eq("insert existing keeps value", res2.first->second, 10);
+
+        auto res3 = map1.emplace(2, 20);
+        test("emplace", res3.second);
+
+        auto res4 = map1.try_emplace(3, 30);
+        test("try_emplace", res4.second);
+
+        map1[4] = 40;
+        test_eq("operator[] insert", map1.at(4), 40);
+        map1[4] += 1;
+        test_eq("operator[] update", map1.at(4), 41);
+
+        auto res5 = map1.insert_or_assign(1, 11);
+        test("insert_or_assign existing", !res5.second);
+        test_eq("insert_or_assign value", map1.at(1), 11);
+
+        test_eq("size", map1.size(), 4ul);
+        test_eq("count present", map1.count(2), 1ul);
+        test_eq("count missing", map1.count(5), 0ul);
+        test("contains", map1.contains(3) && !map1.contains(5));
+
+        int sum{};
+        for (const auto& x: map1)
+            sum += x.first;
+        test_eq("iteration", sum, 10);
+
+        std::hel::flat_hash_map<std::string, int> map2{
+            {"one", 1}, {"two", 2}, {"three", 3}
+        };
+        test_eq("string keys size", map2.size(), 3ul);
+        test_eq("string keys find", map2.find("two")->second, 2);
+        test("string keys missing", map2.find("four") == map2.end());
+    }
+
+    void flat_hash_map_test::test_erase()
+    {
+        std::hel::flat_hash_map<int, int> map1{};
+        for (int i = 0; i < 100; ++i)
+            map1[i] = i;
+
+        test_eq("erase by key", map1.erase(42), 1ul);
+        test_eq("erase missing key", map1.erase(42), 0ul);
+        test("erased key gone", map1.find(42) == map1.end());
+        test_eq("size after erase", map1.size(), 99ul);
+
+        for (auto it = map1.begin(); it != map1.end();)
+        {
+            if (it->first % 2 == 0)
+                it = map1.erase(it);
+            else
+                ++it;
+        }
+
+        bool ok{map1.size() == 50};
+        for (int i = 0; i < 100; ++i)
+            ok &= (map1.count(i) == static_cast<size_t>(i % 2));
+        test("erase by iterator", ok);
+
+        /**
+         * Keep the size constant while replacing keys, so
+         * that tombstones have to be reclaimed by rehashing.
+         */
+        for (int i = 101; i < 10000; i += 2)
+        {
+            map1.erase(i - 100);
+            map1[i] = i;
+        }
+        test_eq("tombstone churn size", map1.size(), 50ul);
+        test("tombstone churn capacity", map1.bucket_count() < 1024);
+        test_eq("tombstone churn find", map1.find(9999)->second, 9999);
+        test("tombstone churn erased", map1.find(9899) == map1.end());
+
+        map1.clear();
+        test("clear", map1.empty() && map1.begin() == map1.end());
+        map1[1] = 1;
+        test_eq("insert after clear", map1.size(), 1ul);
+    }
+
+    void flat_hash_map_test::test_growth()
+    {
+        std::hel::flat_hash_map<int, int> map1{};
+        map1.reserve(1000);
+        auto buckets = map1.bucket_count();
+
+        for (int i = 0; i < 1000; ++i)
+            map1[i * 7] = i;
+        test_eq("reserve avoids rehash", map1.bucket_count(), buckets);
+        test("load factor", map1.load_factor() <= map1.max_load_factor());
+
+        bool ok{true};
+        for (int i = 0; i < 1000; ++i)
+        {
+            auto it = map1.find(i * 7);
+            ok &= (it != map1.end() && it->second == i);
+        }
+        test("find after growth", ok);
+
+        std::hel::flat_hash_map<std::string, int> map2{};
+        std::string last{"a"};
+        map2[last] = 0;
+        for (int i = 0; i < 100; ++i)
+        {
+            // Key taken from the map itself while it grows.
+            auto it = map2.find(last);
+            map2[it->first + "b"] = i;
+            last += "b";
+        }
+        test_eq("self referencing insert", map2.size(), 101ul);
+        test_eq("self referencing insert chain", map2[last], 99);
+
+        map1.rehash(0);
+        test_eq("rehash keeps elements", map1.size(), 1000ul);
+    }
+
+    void flat_hash_map_test::test_copy_move()
+    {
+        std::hel::flat_hash_map<int, std::string> map1{
+            {1, "a"}, {2, "b"}, {3, "c"}
+        };
+
+        auto map2 = map1;
+        test("copy", map2 == map1);
+
+        map2[4] = "d";
+        test("copy is independent", map2 != map1);
+
+        auto map3 = std::move(map2);
+        test_eq("move", map3.size(), 4ul);
+        test("moved from empty", map2.empty());
+
+        map2 = map3;
+        test("copy assignment", map2 == map3);
+
+        map1.swap(map3);
+        test_eq("swap pt1", map1.size(), 4ul);
+        test_eq("swap pt2", map3.size(), 3ul);
+    }
+}
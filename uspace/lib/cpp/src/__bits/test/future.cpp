@@ -0,0 +1,162 @@
+/*
+ * Copyright (c) 2019 Jaroslav Jindrak
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * - Redistributions of source code must retain the above copyright
+ *   notice, this list of conditions and the following disclaimer.
+ * - Redistributions in binary form must reproduce the above copyright
+ *   notice, this list of conditions and the following disclaimer in the
+ *   documentation and/or other materials provided with the distribution.
+ * - The name of the author may not be used to endorse or promote products
+ *   derived from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHOR ``AS IS'' AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+ * OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+ * IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT
+ * NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF
+ * THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <__bits/test/tests.hpp>
+#include <future>
+#include <memory>
+#include <numeric>
+#include <utility>
+#include <vector>
+
+namespace std::test
+{
+    namespace
+    {
+        int sum_range(int first, int last)
+        {
+            int res{};
+            for (int i = first; i < last; ++i)
+                res += i;
+
+            return res;
+        }
+    }
+
+    bool future_test::run(bool report)
+    {
+        report_ = report;
+        start();
+
+        test_async();
+        test_deferred();
+        test_shared_future();
+        test_nested();
+
+        return end();
+    }
+
+    const char* future_test::name()
+    {
+        return "future";
+    }
+
+    void future_test::test_async()
+    {
+        auto fut1 = std::async(std::launch::async, sum_range, 0, 100);
+        test("async valid", fut1.valid());
+        test_eq("async get", fut1.get(), 4950);
+        test("async invalid after get", !fut1.valid());
+
+        std::vector<std::future<int>> futs{};
+        for (int i = 0; i < 16; ++i)
+            futs.push_back(std::async(std::launch::async, sum_range, i * 100, (i + 1) * 100));
+
+        int total{};
+        for (auto& fut: futs)
+            total += fut.get();
+        test_eq("async fan out", total, sum_range(0, 1600));
+
+        int counter{};
+        auto fut2 = std::async(std::launch::async, [&counter](){ ++counter; });
+        fut2.wait();
+        test_eq("async void", counter, 1);
+        test("async ready", fut2.wait_for(std::chrono::seconds{0}) == std::future_status::ready);
+
+        auto ptr = std::make_unique<int>(42);
+        auto fut3 = std::async(
+            std::launch::async,
+            [](std::unique_ptr<int> p){ return *p; },
+            std::move(ptr)
+        );
+        test_eq("async move only argument", fut3.get(), 42);
+
+        int value{3};
+        auto fut4 = std::async(std::launch::async, [&value]() -> int& { return value; });
+        test("async reference", &fut4.get() == &value);
+
+        auto fut5 = std::async(sum_range, 0, 10);
+        test_eq("async default policy", fut5.get(), 45);
+    }
+
+    void future_test::test_deferred()
+    {
+        int counter{};
+        auto fut1 = std::async(std::launch::deferred, [&counter](){ return ++counter; });
+        test_eq("deferred not run yet", counter, 0);
+        test("deferred status", fut1.wait_for(std::chrono::seconds{0}) == std::future_status::deferred);
+        test_eq("deferred get", fut1.get(), 1);
+        test_eq("deferred run once", counter, 1);
+
+        {
+            auto fut2 = std::async(std::launch::deferred, [&counter](){ ++counter; });
+        }
+        test_eq("deferred never waited", counter, 1);
+    }
+
+    void future_test::test_shared_future()
+    {
+        auto fut1 = std::async(std::launch::async, sum_range, 0, 10);
+        auto sfut1 = fut1.share();
+        test("share invalidates future", !fut1.valid());
+
+        auto sfut2 = sfut1;
+        test_eq("shared get pt1", sfut1.get(), 45);
+        test_eq("shared get pt2", sfut2.get(), 45);
+        test("shared get same object", &sfut1.get() == &sfut2.get());
+        test("shared still valid", sfut1.valid());
+    }
+
+    void future_test::test_nested()
+    {
+        /**
+         * More nested waits than there are workers, this would
+         * deadlock if the pool did not add workers for the tasks
+         * queued behind the blocked ones.
+         */
+        auto fut = std::async(std::launch::async, [](){
+            std::vector<std::future<int>> inner{};
+            for (int i = 0; i < 64; ++i)
+            {
+                inner.push_back(std::async(std::launch::async, [i](){
+                    return std::async(std::launch::async, sum_range, 0, i).get();
+                }));
+            }
+
+            int res{};
+            for (auto& f: inner)
+                res += f.get();
+
+            return res;
+        });
+
+        int expected{};
+        for (int i = 0; i < 64; ++i)
+            expected += sum_range(0, i);
+        test_eq("nested async", fut.get(), expected);
+    }
+}
@@ -0,0 +1,213 @@
+/*
+ * Copyright (c) 2019 Jaroslav Jindrak
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * - Redistributions of source code must retain the above copyright
+ *   notice, this list of conditions and the following disclaimer.
+ * - Redistributions in binary form must reproduce the above copyright
+ *   notice, this list of conditions and the following disclaimer in the
+ *   documentation and/or other materials provided with the distribution.
+ * - The name of the author may not be used to endorse or promote products
+ *   derived from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHOR ``AS IS'' AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+ * OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+ * IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT
+ * NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF
+ * THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <__bits/test/tests.hpp>
+#include <cstdio>
+#include <fstream>
+#include <iomanip>
+#include <limits>
+#include <sstream>
+#include <string>
+
+namespace std::test
+{
+    bool iostream_test::run(bool report)
+    {
+        report_ = report;
+        start();
+
+        test_integral();
+        test_floating();
+        test_stringstream();
+        test_fstream();
+
+        return end();
+    }
+
+    const char* iostream_test::name()
+    {
+        return "iostream";
+    }
+
+    void iostream_test::test_integral()
+    {
+        std::ostringstream oss1{};
+        oss1 << 0 << ' ' << 7 << ' ' << -42 << ' ' << 1234567890;
+        test_eq("int output", oss1.str(), std::string{"0 7 -42 1234567890"});
+
+        std::ostringstream oss2{};
+        oss2 << std::numeric_limits<long long>::min() << ' '
+             << std::numeric_limits<unsigned long long>::max();
+        test_eq(
+            "long long limits output",
+            oss2.str(),
+            std::string{"-9223372036854775808 18446744073709551615"}
+        );
+
+        std::ostringstream oss3{};
+        oss3 << static_cast<short>(-5) << static_cast<unsigned short>(65535)
+             << 10u << -10l << 10ul;
+        test_eq("mixed integral output", oss3.str(), std::string{"-56553510-1010"});
+
+        std::ostringstream oss4{};
+        oss4 << std::setw(6) << -42 << '|' << 42;
+        test_eq("int output with width", oss4.str(), std::string{"   -42|42"});
+
+        std::ostringstream oss5{};
+        oss5 << std::left << std::setw(4) << 7 << '|';
+        test_eq("int output left aligned", oss5.str(), std::string{"7   |"});
+
+        std::ostringstream oss6{};
+        oss6 << std::hex << 255 << ' ' << std::showbase << 255
+             << std::uppercase << ' ' << 255u << std::dec << ' ' << 255;
+        test_eq("int output in hex", oss6.str(), std::string{"ff 0xff 0XFF 255"});
+
+        std::ostringstream oss7{};
+        oss7 << std::oct << 8 << std::dec << ' ' << 8;
+        test_eq("int output in oct", oss7.str(), std::string{"10 8"});
+
+        std::ostringstream oss8{};
+        oss8 << std::showpos << 42 << ' ' << 0 << ' ' << -1
+             << std::noshowpos << ' ' << 42;
+        test_eq("int output with showpos", oss8.str(), std::string{"+42 +0 -1 42"});
+
+        std::ostringstream oss9{};
+        oss9 << true << ' ' << std::boolalpha << true << ' ' << false;
+        test_eq("bool output", oss9.str(), std::string{"1 true false"});
+    }
+
+    void iostream_test::test_floating()
+    {
+        std::ostringstream oss1{};
+        oss1 << 1.5 << ' ' << -0.25 << ' ' << 100.0 << ' ' << 1e20;
+        test_eq("double output", oss1.str(), std::string{"1.5 -0.25 100 1e+20"});
+
+        std::ostringstream oss2{};
+        oss2 << 3.14159265 << ' ' << 2.5f << ' ' << 0.1L;
+        test_eq("float output precision", oss2.str(), std::string{"3.14159 2.5 0.1"});
+
+        std::ostringstream oss3{};
+        oss3 << std::fixed << std::setprecision(2) << 3.14159;
+        test_eq("double output fixed", oss3.str(), std::string{"3.14"});
+
+        std::ostringstream oss4{};
+        oss4 << std::setw(8) << 1.5 << '|';
+        test_eq("double output with width", oss4.str(), std::string{"     1.5|"});
+
+        std::ostringstream oss5{};
+        oss5 << std::showpos << 1.5 << ' ' << -1.5;
+        test_eq("double output with showpos", oss5.str(), std::string{"+1.5 -1.5"});
+
+        std::ostringstream oss6{};
+        oss6 << std::scientific << std::uppercase << 1500.0;
+        test_eq("double output scientific", oss6.str(), std::string{"1.500000E+03"});
+
+        std::ostringstream oss7{};
+        oss7 << std::setprecision(3) << 3.14159 << ' ' << std::showpoint << 2.0;
+        test_eq("double output precision", oss7.str(), std::string{"3.14 2.00"});
+
+        std::ostringstream oss8{};
+        oss8 << std::hexfloat << 1.0;
+        test_eq("double output hexfloat", oss8.str(), std::string{"0x1p+0"});
+    }
+
+    void iostream_test::test_stringstream()
+    {
+        std::ostringstream oss1{};
+        test_eq("empty ostringstream", oss1.str(), std::string{});
+
+        oss1 << 'a';
+        test_eq("ostringstream single char", oss1.str(), std::string{"a"});
+
+        oss1 << "bc" << 1;
+        test_eq("ostringstream append", oss1.str(), std::string{"abc1"});
+
+        std::string check{};
+        std::ostringstream oss2{};
+        for (int i = 0; i < 1000; ++i)
+        {
+            oss2 << i << ',';
+            check += std::to_string(i);
+            check += ',';
+        }
+        test_eq("ostringstream growth", oss2.str(), check);
+
+        std::string big(5000, 'x');
+        std::ostringstream oss3{};
+        oss3 << "<" << big << ">";
+        test_eq("ostringstream large write size", oss3.str().size(), 5002ul);
+        test_eq("ostringstream large write", oss3.str(), "<" + big + ">");
+
+        oss3.str("reset");
+        test_eq("ostringstream str reset", oss3.str(), std::string{"reset"});
+    }
+
+    void iostream_test::test_fstream()
+    {
+        const char* path = "/tmp/cpptest_iostream.txt";
+
+        /**
+         * Larger than the buffer of the filebuf, so that
+         * the write bypasses it, surrounded by small writes
+         * that have to stay in order.
+         */
+        std::string big(20000, '\0');
+        for (size_t i = 0; i < big.size(); ++i)
+            big[i] = static_cast<char>('a' + i % 26);
+
+        {
+            std::ofstream ofs{path};
+            test("ofstream open", ofs.is_open());
+
+            ofs << "head" << 42 << '\n';
+            auto res = ofs.rdbuf()->sputn(big.c_str(), big.size());
+            test_eq("ofstream large sputn", res, static_cast<std::streamsize>(big.size()));
+            ofs << '\n' << "tail" << -1.5;
+        }
+
+        std::string check{"head42\n"};
+        check += big;
+        check += "\ntail-1.5";
+
+        std::string content{};
+        auto file = std::fopen(path, "r");
+        test("ofstream file exists", file != nullptr);
+        if (file)
+        {
+            char buf[512];
+            size_t n{};
+            while ((n = std::fread(buf, 1, sizeof(buf), file)) > 0)
+                content.append(buf, n);
+            std::fclose(file);
+        }
+        std::remove(path);
+
+        test_eq("ofstream large sputn size", content.size(), check.size());
+        test_eq("ofstream large sputn content", content, check);
+    }
+}
@@ -28,8 +28,10 @@
 
 #include <__bits/test/tests.hpp>
 #include <initializer_list>
+#include <iterator>
 #include <list>
 #include <utility>
+#include <vector>
 
 namespace std::test
 {
@@ -40,6 +42,7 @@ namespace std::test
 
         test_construction_and_assignment();
         test_modifiers();
+        test_advance();
 
         return end();
     }
@@ -311,5 +314,32 @@ namespace std::test
         );
         test_eq("unique predicate size", l6.size(), 7U);
     }
-}
 
+    void list_test::test_advance()
+    {
+        std::list<int> l1{1, 2, 3, 4, 5, 6};
+
+        auto it1 = l1.begin();
+        std::advance(it1, 4);
+        test_eq("advance forward", *it1, 5);
+
+        std::advance(it1, -3);
+        test_eq("advance backward", *it1, 2);
+
+        std::advance(it1, 0);
+        test_eq("advance by zero", *it1, 2);
+
+        auto it2 = l1.end();
+        std::advance(it2, -1);
+        test_eq("advance backward from end", *it2, 6);
+
+        std::vector<int> v1{1, 2, 3, 4, 5, 6};
+        auto it3 = v1.begin();
+        std::advance(it3, 5);
+        test_eq("random access advance forward", *it3, 6);
+        std::advance(it3, -4);
+        test_eq("random access advance backward", *it3, 2);
+
+        test_eq("distance", std::distance(l1.begin(), l1.end()), 6l);
+    }
+}
@@ -35,6 +35,41 @@
 
 namespace std::test
 {
+    namespace
+    {
+        /**
+         * Counts the live instances to check that the tree
+         * releases its nodes.
+         */
+        struct tracked
+        {
+            static int live;
+
+            int value;
+
+            tracked(int val = 0)
+                : value{val}
+            {
+                ++live;
+            }
+
+            tracked(const tracked& other)
+                : value{other.value}
+            {
+                ++live;
+            }
+
+            tracked& operator=(const tracked&) = default;
+
+            ~tracked()
+            {
+                --live;
+            }
+        };
+
+        int tracked::live{};
+    }
+
     bool map_test::run(bool report)
     {
         report_ = report;
@@ -47,6 +82,7 @@ namespace std::test
         test_multi();
         test_reverse_iterators();
         test_multi_bounds_and_ranges();
+        test_node_lifetimes();
 
         return end();
     }
@@ -431,4 +467,33 @@ namespace std::test
             res3.first, res3.second
         );
     }
+
+    void map_test::test_node_lifetimes()
+    {
+        {
+            std::map<int, tracked> map1{};
+            for (int i = 0; i < 100; ++i)
+                map1.emplace(i, tracked{i});
+            test_eq("nodes after insertion", tracked::live, 100);
+
+            std::map<int, tracked> map2{};
+            map2[1] = tracked{1};
+            map2 = map1;
+            test_eq("copy assignment size", map2.size(), 100ul);
+            test_eq("copy assignment value", map2[42].value, 42);
+            test_eq("nodes after copy assignment", tracked::live, 200);
+
+            map2.clear();
+            test_eq("nodes after clear", tracked::live, 100);
+        }
+        test_eq("nodes after destruction", tracked::live, 0);
+
+        {
+            std::multimap<int, tracked> mmap{};
+            for (int i = 0; i < 30; ++i)
+                mmap.emplace(i % 5, tracked{i});
+            test_eq("multi nodes after insertion", tracked::live, 30);
+        }
+        test_eq("multi nodes after destruction", tracked::live, 0);
+    }
 }
@@ -0,0 +1,215 @@
+/*
+ * Copyright (c) 2019 Jaroslav Jindrak
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * - Redistributions of source code must retain the above copyright
+ *   notice, this list of conditions and the following disclaimer.
+ * - Redistributions in binary form must reproduce the above copyright
+ *   notice, this list of conditions and the following disclaimer in the
+ *   documentation and/or other materials provided with the distribution.
+ * - The name of the author may not be used to endorse or promote products
+ *   derived from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHOR ``AS IS'' AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+ * OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+ * IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT
+ * NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF
+ * THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <__bits/test/tests.hpp>
+#include <cstdint>
+#include <deque>
+#include <memory_resource>
+#include <string>
+#include <vector>
+
+namespace std::test
+{
+    namespace
+    {
+        /**
+         * Upstream resource that counts outstanding
+         * allocations and bytes.
+         */
+        class counting_resource: public std::pmr::memory_resource
+        {
+            public:
+                size_t allocations{};
+                size_t bytes{};
+
+            private:
+                void* do_allocate(size_t n, size_t alignment) override
+                {
+                    ++allocations;
+                    bytes += n;
+
+                    return std::pmr::new_delete_resource()->allocate(n, alignment);
+                }
+
+                void do_deallocate(void* ptr, size_t n, size_t alignment) override
+                {
+                    --allocations;
+                    bytes -= n;
+
+                    std::pmr::new_delete_resource()->deallocate(ptr, n, alignment);
+                }
+
+                bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override
+                {
+                    return this == &other;
+                }
+        };
+
+        bool aligned(void* ptr, size_t alignment)
+        {
+            return reinterpret_cast<uintptr_t>(ptr) % alignment == 0;
+        }
+    }
+
+    bool memory_resource_test::run(bool report)
+    {
+        report_ = report;
+        start();
+
+        test_monotonic();
+        test_pools();
+        test_containers();
+
+        return end();
+    }
+
+    const char* memory_resource_test::name()
+    {
+        return "memory_resource";
+    }
+
+    void memory_resource_test::test_monotonic()
+    {
+        counting_resource upstream{};
+
+        {
+            char buffer[64];
+            std::pmr::monotonic_buffer_resource mbr{buffer, sizeof(buffer), &upstream};
+
+            auto p1 = mbr.allocate(16, 8);
+            test("monotonic initial buffer", p1 == buffer);
+            test_eq("monotonic no upstream", upstream.allocations, 0ul);
+
+            auto p2 = mbr.allocate(3, 1);
+            auto p3 = mbr.allocate(8, 8);
+            test("monotonic bump", p2 == buffer + 16);
+            test("monotonic alignment", aligned(p3, 8) && p3 > p2);
+
+            mbr.allocate(100, 16);
+            test_eq("monotonic overflow to upstream", upstream.allocations, 1ul);
+
+            auto p4 = mbr.allocate(10, 64);
+            test("monotonic over-aligned", aligned(p4, 64));
+
+            mbr.release();
+            test_eq("monotonic release", upstream.allocations, 0ul);
+            test("monotonic reuses buffer", mbr.allocate(1, 1) == buffer);
+
+            for (int i = 0; i < 1000; ++i)
+                mbr.allocate(24, 8);
+            test("monotonic growth", upstream.allocations < 10);
+        }
+        test_eq("monotonic destructor", upstream.allocations, 0ul);
+    }
+
+    void memory_resource_test::test_pools()
+    {
+        counting_resource upstream{};
+
+        {
+            std::pmr::unsynchronized_pool_resource pool{&upstream};
+            test("pool options", pool.options().largest_required_pool_block > 0);
+
+            auto p1 = pool.allocate(24, 8);
+            auto chunks = upstream.allocations;
+            pool.deallocate(p1, 24, 8);
+            auto p2 = pool.allocate(20, 8);
+            test("pool reuses freed block", p1 == p2);
+            test_eq("pool no new chunk", upstream.allocations, chunks);
+
+            bool ok{true};
+            void* ptrs[200];
+            for (int i = 0; i < 200; ++i)
+            {
+                ptrs[i] = pool.allocate(48, 16);
+                ok &= aligned(ptrs[i], 16);
+            }
+            test("pool alignment", ok);
+            for (int i = 0; i < 200; ++i)
+                pool.deallocate(ptrs[i], 48, 16);
+
+            auto big = pool.allocate(1 << 20, 8);
+            auto over = pool.allocate(32, 256);
+            test("pool oversized", big != nullptr);
+            test("pool over-aligned", aligned(over, 256));
+            pool.deallocate(over, 32, 256);
+
+            auto before = upstream.allocations;
+            pool.deallocate(big, 1 << 20, 8);
+            test_eq("pool oversized returned", upstream.allocations, before - 1);
+
+            pool.release();
+            test_eq("pool release", upstream.allocations, 0ul);
+        }
+
+        {
+            std::pmr::synchronized_pool_resource pool{&upstream};
+            auto p = pool.allocate(100);
+            pool.deallocate(p, 100);
+            test("synchronized pool", upstream.allocations > 0);
+        }
+        test_eq("pool destructor", upstream.allocations, 0ul);
+    }
+
+    void memory_resource_test::test_containers()
+    {
+        counting_resource upstream{};
+
+        {
+            std::pmr::monotonic_buffer_resource mbr{&upstream};
+
+            std::pmr::vector<int> vec{&mbr};
+            for (int i = 0; i < 100; ++i)
+                vec.push_back(i);
+            test_eq("pmr vector", vec[99], 99);
+            test("pmr vector resource", vec.get_allocator().resource() == &mbr);
+            test("pmr vector upstream", upstream.allocations > 0);
+
+            std::pmr::vector<std::pmr::string> strs{&mbr};
+            strs.emplace_back("a string long enough to not be stored inline");
+            test("pmr uses-allocator", strs[0].get_allocator().resource() == &mbr);
+
+            std::pmr::deque<int> deq{&mbr};
+            deq.push_back(1);
+            deq.push_front(0);
+            test_eq("pmr deque", deq.front(), 0);
+        }
+        test_eq("pmr containers released", upstream.allocations, 0ul);
+
+        auto old = std::pmr::set_default_resource(&upstream);
+        test("default resource", old == std::pmr::new_delete_resource());
+        test("get default resource", std::pmr::get_default_resource() == &upstream);
+        std::pmr::set_default_resource(nullptr);
+        test("reset default resource",
+             std::pmr::get_default_resource() == std::pmr::new_delete_resource());
+
+        std::pmr::polymorphic_allocator<int> a1{&upstream};
+        std::pmr::polymorphic_allocator<char> a2{a1};
+        test("allocator equality", a1 == a2);
+    }
+}
@@ -0,0 +1,349 @@
+/*
+ * Copyright (c) 2019 Jaroslav Jindrak
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * - Redistributions of source code must retain the above copyright
+ *   notice, this list of conditions and the following disclaimer.
+ * - Redistributions in binary form must reproduce the above copyright
+ *   notice, this list of conditions and the following disclaimer in the
+ *   documentation and/or other materials provided with the distribution.
+ * - The name of the author may not be used to endorse or promote products
+ *   derived from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHOR ``AS IS'' AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+ * OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+ * IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT
+ * NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF
+ * THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <__bits/test/tests.hpp>
+#include <__bits/trycatch.hpp>
+#include <iterator>
+#include <regex>
+#include <string>
+#include <vector>
+
+namespace std::test
+{
+    namespace
+    {
+        bool compile_fails(const char* pattern,
+                           std::regex::flag_type flags = std::regex::ECMAScript)
+        {
+            bool thrown{false};
+            try
+            {
+                std::regex re{pattern, flags};
+            }
+            LIBCPP_EXCEPTION_THROW_CHECK(thrown);
+
+#if LIBCPP_EXCEPTIONS_SUPPORTED == 0
+            std::aux::exception_thrown = false;
+#endif
+
+            return thrown;
+        }
+
+        /**
+         * Straightforward reference search used to check
+         * the results of the automaton based engines.
+         */
+        size_t naive_find(const std::string& str, const std::string& what)
+        {
+            for (size_t i = 0; i + what.size() <= str.size(); ++i)
+            {
+                if (str.compare(i, what.size(), what) == 0)
+                    return i;
+            }
+
+            return std::string::npos;
+        }
+    }
+
+    bool regex_test::run(bool report)
+    {
+        report_ = report;
+        start();
+
+        test_compile();
+        test_match();
+        test_search();
+        test_assertions();
+        test_iterators();
+        test_replace();
+        test_engines();
+
+        return end();
+    }
+
+    const char* regex_test::name()
+    {
+        return "regex";
+    }
+
+    void regex_test::test_compile()
+    {
+        std::regex re1{"(a)(b(c))|d"};
+        test_eq("mark_count", re1.mark_count(), 3U);
+
+        std::regex re2{"(a)(b)", std::regex::nosubs};
+        test_eq("mark_count nosubs", re2.mark_count(), 0U);
+        test_eq("flags", re2.flags(), std::regex::nosubs);
+
+        std::regex re3{"(?:a)(?=b)(?!c)"};
+        test_eq("non capturing groups", re3.mark_count(), 0U);
+
+        test("valid class", !compile_fails("[[:alpha:]\\d-]+"));
+        test("valid repeat", !compile_fails("a{2,3}b{4}c{5,}?"));
+        test("error paren", compile_fails("(ab"));
+        test("error paren close", compile_fails("ab)"));
+        test("error brack", compile_fails("[ab"));
+        test("error range", compile_fails("[z-a]"));
+        test("error badrepeat", compile_fails("*a"));
+        test("error badbrace", compile_fails("a{3,2}"));
+        test("error escape", compile_fails("ab\\"));
+        test("error ctype", compile_fails("[[:foo:]]"));
+        test("error backref", compile_fails("(a)\\2"));
+
+        std::regex_error err{std::regex_constants::error_brack};
+        test_eq("regex_error code", err.code(), std::regex_constants::error_brack);
+
+        std::regex re4{re1};
+        test_eq("copy", re4.mark_count(), 3U);
+
+        re4 = "x";
+        test_eq("assign", re4.mark_count(), 0U);
+
+        re4.swap(re1);
+        test_eq("swap", re4.mark_count(), 3U);
+    }
+
+    void regex_test::test_match()
+    {
+        std::regex re1{"(\\w+)@(\\w+)\\.com"};
+        std::cmatch m1{};
+        bool res = std::regex_match("user@example.com", m1, re1);
+        test("match", res);
+        test_eq("match size", m1.size(), 3U);
+        test_eq("match group 0", m1.str(0), std::string{"user@example.com"});
+        test_eq("match group 1", m1.str(1), std::string{"user"});
+        test_eq("match group 2", m1.str(2), std::string{"example"});
+        test_eq("match position", m1.position(2), 5);
+        test_eq("match length", m1.length(1), 4);
+
+        test("match is full", !std::regex_match("user@example.comx", re1));
+
+        std::regex re2{"HeLLo", std::regex::icase};
+        test("icase", std::regex_match("hello", re2));
+
+        std::regex re3{"[a-c]+", std::regex::icase};
+        test("icase range", std::regex_match("AbC", re3));
+
+        std::regex re4{"[^0-9]*"};
+        test("negated class", std::regex_match("abc", re4));
+        test("negated class mismatch", !std::regex_match("ab1", re4));
+
+        std::regex re5{"(a|ab)(c|bcd)(d*)"};
+        std::smatch m2{};
+        std::string str1{"abcd"};
+        res = std::regex_search(str1, m2, re5);
+        test("alternation priority", res && m2.str(1) == "a" && m2.str(2) == "bcd");
+
+        std::regex re6{"a(b)?c"};
+        std::cmatch m3{};
+        std::regex_match("ac", m3, re6);
+        test("unmatched group", m3.ready() && !m3[1].matched);
+
+        std::regex re7{"(a*)*b"};
+        test("nested star", std::regex_match("aaab", re7));
+
+        std::regex re8{"a{2,3}"};
+        test("bounded repeat", std::regex_match("aaa", re8) && !std::regex_match("aaaa", re8));
+
+        std::regex re9{"\\x41\\u0042\\t"};
+        test("hex escapes", std::regex_match("AB\t", re9));
+    }
+
+    void regex_test::test_search()
+    {
+        std::regex re1{"\\d+"};
+        std::cmatch m1{};
+        bool res = std::regex_search("abc 123 def 45", m1, re1);
+        test("search", res && m1.str() == "123");
+        test_eq("search prefix", m1.prefix().str(), std::string{"abc "});
+        test_eq("search suffix", m1.suffix().str(), std::string{" def 45"});
+
+        std::regex re2{"<.+>"};
+        std::regex re3{"<.+?>"};
+        std::cmatch m2{};
+        std::regex_search("<a><b>", m2, re2);
+        test_eq("greedy", m2.str(), std::string{"<a><b>"});
+        std::regex_search("<a><b>", m2, re3);
+        test_eq("lazy", m2.str(), std::string{"<a>"});
+
+        std::regex re4{"(\\w)\\1"};
+        std::cmatch m3{};
+        res = std::regex_search("abccd", m3, re4);
+        test("backreference", res && m3.str() == "cc" && m3.position() == 2);
+
+        test("search fails", !std::regex_search("abc", re1));
+
+        std::regex re5{"a*"};
+        std::cmatch m4{};
+        res = std::regex_search("bbb", m4, re5);
+        test("empty match", res && m4.length() == 0 && m4.position() == 0);
+        test("not_null", !std::regex_search("bbb", re5, std::regex_constants::match_not_null));
+        test("continuous", !std::regex_search("xab", std::regex{"ab"},
+                                              std::regex_constants::match_continuous));
+    }
+
+    void regex_test::test_assertions()
+    {
+        std::regex re1{"^abc$"};
+        test("anchors", std::regex_search("abc", re1));
+        test("anchors mismatch", !std::regex_search("xabc", re1));
+        test("not_bol", !std::regex_search("abc", re1, std::regex_constants::match_not_bol));
+
+        std::regex re2{"^b$", std::regex::multiline};
+        test("multiline", std::regex_search("a\nb\nc", re2));
+        test("multiline off", !std::regex_search("a\nb\nc", std::regex{"^b$"}));
+
+        std::regex re3{"\\bcat\\b"};
+        test("word boundary", std::regex_search("a cat!", re3));
+        test("word boundary mismatch", !std::regex_search("concat", re3));
+        test("not word boundary", std::regex_search("concat", std::regex{"\\Bcat"}));
+
+        std::regex re4{"\\w+(?=!)"};
+        std::cmatch m1{};
+        bool res = std::regex_search("hi there!", m1, re4);
+        test("lookahead", res && m1.str() == "there");
+
+        std::regex re5{"a(?!b)"};
+        std::cmatch m2{};
+        res = std::regex_search("abac", m2, re5);
+        test("negative lookahead", res && m2.position() == 2);
+    }
+
+    void regex_test::test_iterators()
+    {
+        std::string str1{"one, two,three ,four"};
+        std::regex re1{"\\w+"};
+
+        std::vector<std::string> words{};
+        for (std::sregex_iterator it{str1.begin(), str1.end(), re1}, end{}; it != end; ++it)
+            words.push_back(it->str());
+
+        std::vector<std::string> check1{"one", "two", "three", "four"};
+        test("regex_iterator", words == check1);
+
+        std::sregex_iterator it1{str1.begin(), str1.end(), re1};
+        ++it1;
+        test_eq("regex_iterator position", it1->position(), 5);
+        test_eq("regex_iterator prefix", it1->prefix().str(), std::string{", "});
+
+        std::regex re2{"\\s*,\\s*"};
+        std::vector<std::string> parts{};
+        std::sregex_token_iterator it2{str1.begin(), str1.end(), re2, -1};
+        for (std::sregex_token_iterator end{}; it2 != end; ++it2)
+            parts.push_back(it2->str());
+        test("token_iterator split", parts == check1);
+
+        std::regex re3{"(\\w)(\\w*)"};
+        std::vector<std::string> firsts{};
+        std::sregex_token_iterator it3{str1.begin(), str1.end(), re3, {1, 2}};
+        for (std::sregex_token_iterator end{}; it3 != end; ++it3)
+            firsts.push_back(it3->str());
+        std::vector<std::string> check2{"o", "ne", "t", "wo", "t", "hree", "f", "our"};
+        test("token_iterator submatches", firsts == check2);
+
+        std::regex re4{"x*"};
+        std::string str2{"axb"};
+        size_t count{};
+        for (std::sregex_iterator it{str2.begin(), str2.end(), re4}, end{}; it != end; ++it)
+            ++count;
+        test_eq("regex_iterator empty matches", count, 4U);
+    }
+
+    void regex_test::test_replace()
+    {
+        std::regex re1{"(\\w+)@(\\w+)"};
+        std::string str1{"mail alice@home or bob@work"};
+
+        auto res = std::regex_replace(str1, re1, "$2:$1");
+        test_eq("replace", res, std::string{"mail home:alice or work:bob"});
+
+        res = std::regex_replace(str1, re1, "[$&]", std::regex_constants::format_first_only);
+        test_eq("replace first only", res, std::string{"mail [alice@home] or bob@work"});
+
+        res = std::regex_replace(str1, re1, "$1;", std::regex_constants::format_no_copy);
+        test_eq("replace no copy", res, std::string{"alice;bob;"});
+
+        res = std::regex_replace(str1, re1, "\\2-&", std::regex_constants::format_sed);
+        test_eq("replace sed", res, std::string{"mail home-alice@home or work-bob@work"});
+
+        res = std::regex_replace("a.b.c", std::regex{"\\."}, "$$");
+        test_eq("replace dollar", res, std::string{"a$b$c"});
+
+        std::cmatch m1{};
+        std::regex_search("x=42;", m1, std::regex{"(\\w)=(\\d+)"});
+        test_eq("format", m1.format("$`<$2>$'"), std::string{"<42>;"});
+
+        std::string out{};
+        std::regex_replace(std::back_inserter(out), str1.begin(), str1.end(),
+                           std::regex{"o"}, "0");
+        test_eq("replace iterator", out, std::string{"mail alice@h0me 0r b0b@w0rk"});
+    }
+
+    void regex_test::test_engines()
+    {
+        /**
+         * Patterns without back references and lookaheads run
+         * on the cached DFA first, the rest on the backtracker,
+         * both must agree with a plain substring search.
+         */
+        std::string str1{};
+        for (size_t i = 0; i < 2000; ++i)
+            str1 += "lorem ipsum dolor sit amet ";
+        str1 += "needle42 and more text";
+
+        std::regex re1{"needle\\d+"};
+        std::regex re2{"(n)eedle(?=\\d)\\d+"};
+        std::smatch m1{};
+        std::smatch m2{};
+
+        bool res1 = std::regex_search(str1, m1, re1);
+        bool res2 = std::regex_search(str1, m2, re2);
+        auto pos = naive_find(str1, "needle42");
+
+        test("dfa search", res1 && static_cast<size_t>(m1.position()) == pos);
+        test("backtracking search", res2 && static_cast<size_t>(m2.position()) == pos);
+        test("engines agree", m1.str() == m2.str());
+
+        std::regex re3{"(a|b)*abb"};
+        std::string str2{};
+        for (size_t i = 0; i < 500; ++i)
+            str2 += "ab";
+        str2 += "abb";
+        test("dfa match", std::regex_match(str2, re3));
+        test("dfa match fails", !std::regex_match(str2 + "a", re3));
+
+        std::regex re4{"(a+)+b"};
+        std::string str3(30, 'a');
+        test("no exponential blowup", !std::regex_search(str3, re4));
+
+        std::regex re5{"[^#]*"};
+        std::smatch m3{};
+        std::regex_match(str1, m3, re5);
+        test_eq("long match", m3.length(), static_cast<std::ptrdiff_t>(str1.size()));
+    }
+}
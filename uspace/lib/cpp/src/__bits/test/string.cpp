@@ -30,6 +30,7 @@
 #include <__bits/test/tests.hpp>
 #include <string>
 #include <cstdio>
+#include <utility>
 
 namespace std::test
 {
@@ -47,6 +48,7 @@ namespace std::test
         test_find();
         test_substr();
         test_compare();
+        test_short_strings();
 
         return end();
     }
@@ -703,4 +705,56 @@ namespace std::test
             res, 0
         );
     }
+    void string_test::test_short_strings()
+    {
+        std::string check1{"short"};
+        std::string check2{"a string that does not fit inline"};
+
+        std::string str1{check1};
+        std::string str2{check2};
+        auto data2 = str2.data();
+
+        std::string str3{std::move(str2)};
+        test_eq("move steals buffer", str3.data(), data2);
+        test_eq("moved from is empty", str2.size(), 0ul);
+        test_eq("moved from is terminated", str2.c_str()[0], '\0');
+
+        std::string str4{std::move(str1)};
+        test_eq("move short", str4, check1);
+        test_eq("moved from short", str1.size(), 0ul);
+
+        str4.swap(str3);
+        test_eq("swap short/long pt1", str4, check2);
+        test_eq("swap short/long pt2", str3, check1);
+
+        str4.swap(str3);
+        test_eq("swap long/short pt1", str4, check1);
+        test_eq("swap long/short pt2", str3, check2);
+
+        std::string str5{};
+        for (char c = 'a'; c <= 'z'; ++c)
+            str5.push_back(c);
+        test_eq("grow out of inline", str5, std::string{"abcdefghijklmnopqrstuvwxyz"});
+        test("grow out of inline capacity", str5.capacity() >= str5.size());
+
+        str5.erase(3);
+        str5.shrink_to_fit();
+        test_eq("shrink into inline", str5, std::string{"abc"});
+        test_eq("shrink into inline terminator", str5.c_str()[3], '\0');
+
+        str5 = str3;
+        test_eq("copy assign long", str5, check2);
+        str5 = check1;
+        test_eq("copy assign short", str5, check1);
+
+        str5.assign(str5.data() + 1, 3);
+        test_eq("assign from self", str5, std::string{"hor"});
+
+        str5 = 'x';
+        test_eq("assign character", str5, std::string{"x"});
+        test_eq("prepend character", 'y' + str5, std::string{"yx"});
+        test_eq("append character", str5 + 'y', std::string{"xy"});
+        test_eq("concatenate", check1 + check2 + "!",
+                std::string{"shorta string that does not fit inline!"});
+    }
 }
@@ -0,0 +1,254 @@
+/*
+ * Copyright (c) 2019 Jaroslav Jindrak
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * - Redistributions of source code must retain the above copyright
+ *   notice, this list of conditions and the following disclaimer.
+ * - Redistributions in binary form must reproduce the above copyright
+ *   notice, this list of conditions and the following disclaimer in the
+ *   documentation and/or other materials provided with the distribution.
+ * - The name of the author may not be used to endorse or promote products
+ *   derived from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHOR ``AS IS'' AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+ * OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+ * IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT
+ * NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF
+ * THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <__bits/test/tests.hpp>
+#include <cstdlib>
+#include <initializer_list>
+#include <valarray>
+
+namespace std::test
+{
+    namespace
+    {
+        template<class T>
+        bool equal(const std::valarray<T>& arr, std::initializer_list<T> check)
+        {
+            if (arr.size() != check.size())
+                return false;
+
+            size_t i{};
+            for (const auto& x: check)
+            {
+                if (arr[i++] != x)
+                    return false;
+            }
+
+            return true;
+        }
+    }
+
+    bool valarray_test::run(bool report)
+    {
+        report_ = report;
+        start();
+
+        test_construction();
+        test_operations();
+        test_members();
+        test_slices();
+        test_masks();
+        test_expression_subsets();
+
+        return end();
+    }
+
+    const char* valarray_test::name()
+    {
+        return "valarray";
+    }
+
+    void valarray_test::test_construction()
+    {
+        std::valarray<int> va1{};
+        test_eq("default constructor", va1.size(), 0ul);
+
+        std::valarray<int> va2(5);
+        test("size constructor", equal(va2, {0, 0, 0, 0, 0}));
+
+        std::valarray<int> va3(7, 3);
+        test("value constructor", equal(va3, {7, 7, 7}));
+
+        int arr[]{1, 2, 3, 4};
+        std::valarray<int> va4(arr, 4);
+        test("array constructor", equal(va4, {1, 2, 3, 4}));
+
+        std::valarray<int> va5{va4};
+        test("copy constructor", equal(va5, {1, 2, 3, 4}));
+
+        std::valarray<int> va6{std::move(va5)};
+        test("move constructor", equal(va6, {1, 2, 3, 4}));
+        test_eq("move constructor source", va5.size(), 0ul);
+
+        va1 = va6;
+        test("copy assignment", equal(va1, {1, 2, 3, 4}));
+
+        va1 = 3;
+        test("value assignment", equal(va1, {3, 3, 3, 3}));
+
+        va1 = {5, 6};
+        test("initializer list assignment", equal(va1, {5, 6}));
+
+        va1.resize(3, 1);
+        test("resize", equal(va1, {1, 1, 1}));
+
+        va1.swap(va6);
+        test("swap", equal(va1, {1, 2, 3, 4}) && equal(va6, {1, 1, 1}));
+    }
+
+    void valarray_test::test_operations()
+    {
+        std::valarray<int> va1{1, 2, 3, 4};
+        std::valarray<int> va2(2, 4);
+
+        std::valarray<int> res = va1 * va2 + 1 - va1 / va2;
+        test("expression", equal(res, {3, 4, 6, 7}));
+
+        res = 10 - va1;
+        test("scalar on the left", equal(res, {9, 8, 7, 6}));
+
+        res = (va1 << 2) | 1;
+        test("bitwise", equal(res, {5, 9, 13, 17}));
+
+        res = va1 % 2;
+        test("modulus", equal(res, {1, 0, 1, 0}));
+
+        res = -va1;
+        test("unary minus", equal(res, {-1, -2, -3, -4}));
+
+        res = abs(res);
+        test("abs", equal(res, {1, 2, 3, 4}));
+
+        std::valarray<bool> cmp = va1 > 2;
+        test("comparison", equal(cmp, {false, false, true, true}));
+
+        cmp = !(va1 == va2) && va1 < 4;
+        test("logical", equal(cmp, {true, false, true, false}));
+
+        res += va1 * 3;
+        test("compound assignment", equal(res, {4, 8, 12, 16}));
+
+        res = res - res / 2;
+        test("aliasing expression", equal(res, {2, 4, 6, 8}));
+
+        test_eq("expression sum", (va1 + va2).sum(), 18);
+        test_eq("expression element", (va1 * va1)[3], 16);
+    }
+
+    void valarray_test::test_members()
+    {
+        std::valarray<int> va{3, 1, 4, 1, 5, 9, 2, 6, 5, 3};
+
+        test_eq("sum", va.sum(), 39);
+        test_eq("min", va.min(), 1);
+        test_eq("max", va.max(), 9);
+
+        std::valarray<int> small{1, 2, 3, 4};
+        test("shift left", equal(small.shift(1), {2, 3, 4, 0}));
+        test("shift right", equal(small.shift(-2), {0, 0, 1, 2}));
+        test("shift everything", equal(small.shift(7), {0, 0, 0, 0}));
+        test("cshift left", equal(small.cshift(1), {2, 3, 4, 1}));
+        test("cshift right", equal(small.cshift(-5), {4, 1, 2, 3}));
+
+        auto res = small.apply([](int x){ return x * x; });
+        test("apply", equal(res, {1, 4, 9, 16}));
+
+        int total{};
+        for (auto x: small)
+            total += x;
+        test_eq("range access", total, 10);
+    }
+
+    void valarray_test::test_slices()
+    {
+        std::valarray<int> va(20);
+        for (int i = 0; i < 20; ++i)
+            va[i] = i;
+
+        std::valarray<int> sl = va[std::slice(0, 4, 5)];
+        test("slice read", equal(sl, {0, 5, 10, 15}));
+
+        va[std::slice(1, 3, 5)] = -1;
+        test("slice fill", va[1] == -1 && va[6] == -1 && va[11] == -1 && va[16] == 16);
+
+        va[std::slice(0, 4, 5)] += std::valarray<int>(100, 4);
+        test("slice compound", va[0] == 100 && va[15] == 115 && va[2] == 2);
+
+        std::valarray<int> big(60);
+        for (int i = 0; i < 60; ++i)
+            big[i] = i;
+
+        /**
+         * Example from the standard (26.6.6.1).
+         */
+        std::valarray<size_t> lengths{2, 4, 3};
+        std::valarray<size_t> strides{19, 4, 1};
+        std::valarray<int> gs = big[std::gslice(3, lengths, strides)];
+        test("gslice", equal(gs, {
+            3, 4, 5, 7, 8, 9, 11, 12, 13, 15, 16, 17,
+            22, 23, 24, 26, 27, 28, 30, 31, 32, 34, 35, 36
+        }));
+
+        big[std::gslice(3, lengths, strides)] = 0;
+        test("gslice fill", big[3] == 0 && big[36] == 0 && big[6] == 6);
+    }
+
+    void valarray_test::test_masks()
+    {
+        std::valarray<int> va{1, 2, 3, 4, 5, 6};
+
+        std::valarray<int> masked = va[va % 2 == 0];
+        test("mask read", equal(masked, {2, 4, 6}));
+
+        va[va > 4] = 0;
+        test("mask fill", equal(va, {1, 2, 3, 4, 0, 0}));
+
+        std::valarray<size_t> indices{3, 0, 2};
+        std::valarray<int> indirect = va[indices];
+        test("indirect read", equal(indirect, {4, 1, 3}));
+
+        va[indices] = std::valarray<int>{7, 8, 9};
+        test("indirect assign", equal(va, {8, 2, 9, 7, 0, 0}));
+
+        va[indices] *= std::valarray<int>(2, 3);
+        test("indirect compound", equal(va, {16, 2, 18, 14, 0, 0}));
+    }
+
+    void valarray_test::test_expression_subsets()
+    {
+        const std::valarray<int> va{1, 2, 3, 4, 5, 6};
+
+        std::valarray<int> sl = (va + 1)[std::slice(0, 2, 1)];
+        test("expression slice", equal(sl, {2, 3}));
+
+        std::valarray<size_t> lengths{2, 2};
+        std::valarray<size_t> strides{3, 1};
+        std::valarray<int> gs = (va * 10)[std::gslice(0, lengths, strides)];
+        test("expression gslice", equal(gs, {10, 20, 40, 50}));
+
+        std::valarray<bool> mask{true, false, true, false, true, false};
+        std::valarray<int> masked = (va - 1)[mask];
+        test("expression mask", equal(masked, {0, 2, 4}));
+
+        std::valarray<int> by_expr = (va * va)[va > 4];
+        test("expression mask by expression", equal(by_expr, {25, 36}));
+
+        std::valarray<size_t> indices{5, 0};
+        std::valarray<int> indirect = (-va)[indices];
+        test("expression indirect", equal(indirect, {-6, -1}));
+    }
+}
@@ -29,11 +29,55 @@
 #include <__bits/test/tests.hpp>
 #include <algorithm>
 #include <initializer_list>
+#include <list>
+#include <string>
 #include <utility>
 #include <vector>
 
 namespace std::test
 {
+    namespace
+    {
+        /**
+         * Counts the live instances to check that the vector
+         * constructs and destroys exactly the elements it holds.
+         */
+        struct tracked
+        {
+            static int live;
+
+            int value;
+
+            tracked(int val = 0)
+                : value{val}
+            {
+                ++live;
+            }
+
+            tracked(const tracked& other)
+                : value{other.value}
+            {
+                ++live;
+            }
+
+            tracked(tracked&& other)
+                : value{other.value}
+            {
+                ++live;
+            }
+
+            tracked& operator=(const tracked&) = default;
+            tracked& operator=(tracked&&) = default;
+
+            ~tracked()
+            {
+                --live;
+            }
+        };
+
+        int tracked::live{};
+    }
+
     bool vector_test::run(bool report)
     {
         report_ = report;
@@ -42,6 +86,9 @@ namespace std::test
         test_construction_and_assignment();
         test_insert();
         test_erase();
+        test_element_lifetimes();
+        test_comparison();
+        test_growth();
 
         return end();
     }
@@ -85,7 +132,20 @@ namespace std::test
             check3.begin(), check3.end()
         );
 
-        // TODO: iterator constructor when implemented
+        std::list<int> lst{1, 2, 3, 4};
+        std::vector<int> vec5(lst.begin(), lst.end());
+        test_eq(
+            "iterator constructor",
+            vec5.begin(), vec5.end(),
+            check1.begin(), check1.end()
+        );
+
+        std::vector<int> vec5b(4, 5);
+        test_eq(
+            "iterator constructor with integers",
+            vec5b.begin(), vec5b.end(),
+            check3.begin(), check3.end()
+        );
 
         std::vector<int> vec6{vec4};
         test_eq(
@@ -227,4 +287,126 @@ namespace std::test
             check3.begin(), check3.end()
         );
     }
+
+    void vector_test::test_element_lifetimes()
+    {
+        {
+            std::vector<tracked> vec1{};
+            for (int i = 0; i < 20; ++i)
+                vec1.emplace_back(i);
+            test_eq("lifetimes after growth", tracked::live, 20);
+
+            vec1.insert(vec1.begin() + 5, tracked{100});
+            vec1.erase(vec1.begin(), vec1.begin() + 3);
+            test_eq("lifetimes after insert and erase", tracked::live, 18);
+            test_eq("insert and erase values", vec1[2].value, 100);
+
+            vec1.resize(4);
+            test_eq("lifetimes after shrinking resize", tracked::live, 4);
+            vec1.resize(10, tracked{7});
+            test_eq("lifetimes after growing resize", tracked::live, 10);
+            test_eq("growing resize value", vec1.back().value, 7);
+
+            std::vector<tracked> vec2{vec1};
+            vec2 = std::vector<tracked>(3);
+            test_eq("lifetimes after move assignment", tracked::live, 13);
+
+            vec1.clear();
+            test_eq("lifetimes after clear", tracked::live, 3);
+        }
+        test_eq("lifetimes after destruction", tracked::live, 0);
+
+        std::vector<std::vector<int>> vec3{};
+        for (int i = 0; i < 10; ++i)
+            vec3.push_back(std::vector<int>(i, i));
+        vec3.insert(vec3.begin(), std::vector<int>{42});
+        vec3.erase(vec3.begin() + 1);
+        bool ok{vec3.size() == 10 && vec3[0][0] == 42};
+        for (int i = 1; i < 10; ++i)
+            ok &= vec3[i].size() == static_cast<size_t>(i) && vec3[i][0] == i;
+        test("nested vectors", ok);
+
+        std::vector<std::vector<int>> vec4{};
+        vec4.push_back(std::vector<int>{1, 2});
+        for (int i = 0; i < 10; ++i)
+            vec4.push_back(vec4[0]);
+        test_eq("push_back of own element", vec4.back()[1], 2);
+    }
+
+    void vector_test::test_comparison()
+    {
+        std::vector<int> vec1{1, 2, 3};
+        std::vector<int> vec2{1, 3};
+        std::vector<int> vec3{1, 2};
+
+        test("less on first difference", vec1 < vec2);
+        test("not less on first difference", !(vec2 < vec1));
+        test("shorter prefix is less", vec3 < vec1);
+        test("longer is not less than prefix", !(vec1 < vec3));
+        test("irreflexive less", !(vec1 < vec1));
+        test("greater equal", vec2 >= vec1 && vec1 >= vec1);
+        test("equality", vec1 == std::vector<int>{1, 2, 3} && vec1 != vec2);
+    }
+
+    void vector_test::test_growth()
+    {
+        std::vector<int> vec1{};
+        bool ok{true};
+        for (int i = 0; i < 10000; ++i)
+            vec1.push_back(i);
+        for (int i = 0; i < 10000; ++i)
+            ok &= vec1[i] == i;
+        test("push_back growth keeps elements", ok);
+        test_eq("push_back growth size", vec1.size(), 10000ul);
+
+        vec1.resize(3);
+        vec1.shrink_to_fit();
+        test_eq("shrink_to_fit", vec1.capacity(), 3ul);
+
+        vec1.push_back(vec1[0]);
+        test_eq("push_back of own element on growth", vec1.back(), 0);
+
+        auto check1 = {1, 2, 7, 8, 3, 4, 5};
+        auto check2 = {1, 7, 8, 9, 10, 2};
+        auto range1 = {7, 8};
+        auto range2 = {7, 8, 9, 10};
+
+        std::vector<int> vec2{1, 2, 3, 4, 5};
+        vec2.reserve(10);
+        auto data = vec2.data();
+        vec2.insert(vec2.begin() + 2, range1.begin(), range1.end());
+        test_eq(
+            "range insert within capacity",
+            vec2.begin(), vec2.end(),
+            check1.begin(), check1.end()
+        );
+        test_eq("range insert does not reallocate", vec2.data(), data);
+
+        std::vector<int> vec3{1, 2};
+        vec3.reserve(10);
+        vec3.insert(vec3.begin() + 1, range2.begin(), range2.end());
+        test_eq(
+            "range insert past the end",
+            vec3.begin(), vec3.end(),
+            check2.begin(), check2.end()
+        );
+
+        std::vector<int> vec4(2ul, 5);
+        vec4.insert(vec4.begin(), 3, 4);
+        auto check3 = {4, 4, 4, 5, 5};
+        test_eq(
+            "integral range insert",
+            vec4.begin(), vec4.end(),
+            check3.begin(), check3.end()
+        );
+
+        std::vector<std::string> vec5{"a", "d"};
+        auto range3 = {"b", "c"};
+        vec5.insert(vec5.begin() + 1, range3.begin(), range3.end());
+        for (int i = 0; i < 100; ++i)
+            vec5.push_back("a rather long string that is not stored inline");
+        test_eq("non trivial growth size", vec5.size(), 104ul);
+        test_eq("non trivial range insert", vec5[2], std::string{"c"});
+        test_eq("non trivial growth", vec5.back(), vec5[50]);
+    }
 }
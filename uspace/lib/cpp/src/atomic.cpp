@@ -0,0 +1,149 @@
+/*
+ * Copyright (c) 2019 Jaroslav Jindrak
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * - Redistributions of source code must retain the above copyright
+ *   notice, this list of conditions and the following disclaimer.
+ * - Redistributions in binary form must reproduce the above copyright
+ *   notice, this list of conditions and the following disclaimer in the
+ *   documentation and/or other materials provided with the distribution.
+ * - The name of the author may not be used to endorse or promote products
+ *   derived from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHOR ``AS IS'' AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+ * OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+ * IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT
+ * NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF
+ * THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <__bits/thread/threading.hpp>
+#include <atomic>
+#include <cstdint>
+
+namespace std::aux
+{
+    namespace
+    {
+        /**
+         * Size of the spinlock and wait tables, the object
+         * address picks the entry.
+         */
+        constexpr size_t atomic_table_size = 64;
+
+        size_t atomic_table_index(const volatile void* obj) noexcept
+        {
+            auto addr = reinterpret_cast<uintptr_t>(obj);
+
+            /**
+             * Objects in the same cache line share an entry,
+             * which only costs us a spurious wakeup now and then.
+             */
+            addr >>= 6;
+            addr ^= addr >> 7;
+
+            return addr % atomic_table_size;
+        }
+
+        /**
+         * Note: We use unsigned locks because these are the ones
+         *       with compare-and-swap support on all our targets.
+         */
+        unsigned atomic_spinlocks[atomic_table_size]{};
+
+        struct atomic_wait_entry
+        {
+            atomic_wait_entry()
+                : waiters{}
+            {
+                threading::mutex::init(mtx);
+                threading::condvar::init(cv);
+            }
+
+            mutex_t mtx;
+            condvar_t cv;
+            size_t waiters;
+        };
+
+        atomic_wait_entry& atomic_wait_table(const volatile void* obj)
+        {
+            static atomic_wait_entry table[atomic_table_size]{};
+
+            return table[atomic_table_index(obj)];
+        }
+    }
+
+    void atomic_lock(const volatile void* obj) noexcept
+    {
+        auto& lock = atomic_spinlocks[atomic_table_index(obj)];
+
+        while (true)
+        {
+            unsigned expected{0};
+            if (__atomic_compare_exchange_n(&lock, &expected, 1U, true,
+                                            __ATOMIC_ACQUIRE, __ATOMIC_RELAXED))
+            {
+                return;
+            }
+
+            while (__atomic_load_n(&lock, __ATOMIC_RELAXED) != 0)
+                threading::thread::yield();
+        }
+    }
+
+    void atomic_unlock(const volatile void* obj) noexcept
+    {
+        auto& lock = atomic_spinlocks[atomic_table_index(obj)];
+
+        __atomic_store_n(&lock, 0U, __ATOMIC_RELEASE);
+    }
+
+    void atomic_wait(const volatile void* obj, const void* old,
+                     memory_order order, atomic_wait_pred_t same_value) noexcept
+    {
+        auto& entry = atomic_wait_table(obj);
+
+        threading::mutex::lock(entry.mtx);
+
+        /**
+         * The notifier stores the new value before it checks
+         * for waiters, we announce ourselves before we check
+         * the value, so one of us is bound to see the other.
+         */
+        __atomic_add_fetch(&entry.waiters, 1, __ATOMIC_RELAXED);
+        __atomic_thread_fence(__ATOMIC_SEQ_CST);
+
+        while (same_value(obj, old, order))
+            threading::condvar::wait(entry.cv, entry.mtx);
+
+        __atomic_sub_fetch(&entry.waiters, 1, __ATOMIC_RELAXED);
+
+        threading::mutex::unlock(entry.mtx);
+    }
+
+    void atomic_notify(const volatile void* obj) noexcept
+    {
+        auto& entry = atomic_wait_table(obj);
+
+        __atomic_thread_fence(__ATOMIC_SEQ_CST);
+        if (__atomic_load_n(&entry.waiters, __ATOMIC_RELAXED) == 0)
+            return;
+
+        /**
+         * Several objects can share the entry, so we have to wake
+         * up everyone, the predicate sends the others back to sleep.
+         */
+        threading::mutex::lock(entry.mtx);
+        threading::condvar::broadcast(entry.cv);
+        threading::mutex::unlock(entry.mtx);
+    }
+}
@@ -29,6 +29,7 @@
 #include <future>
 #include <string>
 #include <system_error>
+#include <thread>
 
 namespace std
 {
@@ -72,6 +73,168 @@ namespace std
         return instance;
     }
 
+    namespace aux
+    {
+        /**
+         * Process wide pool backing std::async(launch::async, ...).
+         * It is started lazily on the first submission with one
+         * worker fibril and one fibril runner thread per CPU.
+         * Surplus workers are added when a task someone waits for
+         * is still queued and no worker is idle (see ensure_worker),
+         * they exit as soon as they find the queue empty.
+         */
+        class async_pool
+        {
+            public:
+                async_pool()
+                    : mtx_{}, cv_{}, head_{}, tail_{}, idle_{},
+                      workers_{}, base_workers_{}, started_{false}
+                {
+                    threading::mutex::init(mtx_);
+                    threading::condvar::init(cv_);
+                }
+
+                void submit(pool_task* task)
+                {
+                    threading::mutex::lock(mtx_);
+                    if (!started_)
+                        start_();
+
+                    if (tail_)
+                        tail_->next_ = task;
+                    else
+                        head_ = task;
+                    tail_ = task;
+
+                    threading::condvar::signal(cv_);
+                    threading::mutex::unlock(mtx_);
+                }
+
+                /**
+                 * Makes sure the queued tasks get picked up
+                 * even if all workers are blocked, e.g. waiting
+                 * for results of tasks queued after their own.
+                 * Returns false if a needed worker could not be
+                 * created.
+                 */
+                bool ensure_worker()
+                {
+                    bool res{true};
+
+                    threading::mutex::lock(mtx_);
+                    if (head_ && idle_ == 0)
+                        res = spawn_worker_();
+                    threading::mutex::unlock(mtx_);
+
+                    return res;
+                }
+
+            private:
+                aux::mutex_t mtx_;
+                aux::condvar_t cv_;
+                pool_task* head_;
+                pool_task* tail_;
+                size_t idle_;
+                size_t workers_;
+                size_t base_workers_;
+                bool started_;
+
+                void start_()
+                {
+                    started_ = true;
+
+                    unsigned int workers = thread::hardware_concurrency();
+                    if (workers == 0)
+                        workers = 1;
+
+                    base_workers_ = workers;
+                    if (workers > 1)
+                        hel::fibril_enable_multithreaded_runners(workers);
+
+                    /**
+                     * Note: Should we fail to create any workers,
+                     *       ensure_worker tries again once someone
+                     *       waits for a result.
+                     */
+                    for (unsigned int i = 0; i < workers; ++i)
+                    {
+                        if (!spawn_worker_())
+                            break;
+                    }
+                }
+
+                bool spawn_worker_()
+                {
+                    auto fid = hel::fibril_create(worker_main_, this);
+                    if (!fid)
+                        return false;
+
+                    hel::fibril_add_ready(fid);
+                    ++workers_;
+
+                    return true;
+                }
+
+                pool_task* pop_()
+                {
+                    threading::mutex::lock(mtx_);
+                    ++idle_;
+                    while (!head_)
+                    {
+                        if (workers_ > base_workers_)
+                        {
+                            --idle_;
+                            --workers_;
+                            threading::mutex::unlock(mtx_);
+
+                            return nullptr;
+                        }
+
+                        threading::condvar::wait(cv_, mtx_);
+                    }
+                    --idle_;
+
+                    auto task = head_;
+                    head_ = task->next_;
+                    if (!head_)
+                        tail_ = nullptr;
+                    threading::mutex::unlock(mtx_);
+
+                    return task;
+                }
+
+                static int worker_main_(void* arg)
+                {
+                    auto pool = static_cast<async_pool*>(arg);
+
+                    while (auto task = pool->pop_())
+                    {
+                        task->run();
+                        delete task;
+                    }
+
+                    return 0;
+                }
+        };
+
+        static async_pool& get_async_pool()
+        {
+            static async_pool pool{};
+
+            return pool;
+        }
+
+        void async_submit(pool_task* task)
+        {
+            get_async_pool().submit(task);
+        }
+
+        bool async_ensure_worker()
+        {
+            return get_async_pool().ensure_worker();
+        }
+    }
+
     future_error::future_error(error_code ec)
         : logic_error{"future_error"}, code_{ec}
     { /* DUMMY BODY */ }
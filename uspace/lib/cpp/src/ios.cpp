@@ -38,7 +38,7 @@ namespace std
     ios_base::ios_base()
         : iarray_{}, parray_{}, iarray_size_{}, parray_size_{},
           flags_{}, precision_{}, width_{}, locale_{/* TODO: use locale()? */},
-          callbacks_{}
+          classic_{true}, callbacks_{}
     { /* DUMMY BODY */ }
 
     ios_base::~ios_base()
@@ -112,6 +112,7 @@ namespace std
     {
         auto old = locale_;
         locale_ = loc;
+        classic_ = is_classic_(loc);
 
         for (auto& callback: callbacks_)
             callback.first(imbue_event, *this, callback.second);
@@ -124,6 +125,17 @@ namespace std
         return locale_;
     }
 
+    bool ios_base::is_classic_(const locale& loc)
+    {
+        /**
+         * Note: Default constructed locales have an empty
+         *       name and stand for the "C" locale.
+         */
+        auto name = loc.name();
+
+        return name.empty() || name == "C" || name == "POSIX";
+    }
+
     long& ios_base::iword(int index)
     {
         if (!iarray_)
@@ -39,6 +39,12 @@ namespace std
     namespace aux
     {
         ios_base::Init init{};
+
+        /**
+         * Kept so that sync_with_stdio can reach the
+         * buffer even if cout gets a different one.
+         */
+        static stdout_streambuf<char>* cout_buffer{nullptr};
     }
 
     int ios_base::Init::init_cnt_{};
@@ -50,7 +56,8 @@ namespace std
             // TODO: These buffers should be static too
             //       in case somebody reassigns to cout/cin.
             ::new(&cin) istream{::new aux::stdin_streambuf<char>{}};
-            ::new(&cout) ostream{::new aux::stdout_streambuf<char>{}};
+            aux::cout_buffer = ::new aux::stdout_streambuf<char>{};
+            ::new(&cout) ostream{aux::cout_buffer};
 
             cin.tie(&cout);
         }
@@ -61,4 +68,15 @@ namespace std
         if (--init_cnt_ == 0)
             cout.flush();
     }
+
+    bool ios_base::sync_with_stdio(bool sync)
+    {
+        auto old = sync_;
+        sync_ = sync;
+
+        if (old != sync && aux::cout_buffer)
+            aux::cout_buffer->sync_with_stdio(sync);
+
+        return old;
+    }
 }
@@ -0,0 +1,437 @@
+/*
+ * Copyright (c) 2019 Jaroslav Jindrak
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * - Redistributions of source code must retain the above copyright
+ *   notice, this list of conditions and the following disclaimer.
+ * - Redistributions in binary form must reproduce the above copyright
+ *   notice, this list of conditions and the following disclaimer in the
+ *   documentation and/or other materials provided with the distribution.
+ * - The name of the author may not be used to endorse or promote products
+ *   derived from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHOR ``AS IS'' AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+ * OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+ * IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT
+ * NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF
+ * THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <algorithm>
+#include <atomic>
+#include <cstdlib>
+#include <memory_resource>
+#include <new>
+
+namespace std::hel
+{
+    extern "C" {
+        #include <malloc.h>
+    }
+}
+
+namespace std::pmr
+{
+    memory_resource::~memory_resource()
+    { /* DUMMY BODY */ }
+
+    namespace
+    {
+        class new_delete_resource_t: public memory_resource
+        {
+            private:
+                void* do_allocate(size_t bytes, size_t alignment) override
+                {
+                    if (alignment <= max_align)
+                        return ::operator new(bytes);
+                    else
+                        return hel::memalign(alignment, bytes);
+                }
+
+                void do_deallocate(void* ptr, size_t, size_t alignment) override
+                {
+                    if (alignment <= max_align)
+                        ::operator delete(ptr);
+                    else
+                        std::free(ptr);
+                }
+
+                bool do_is_equal(const memory_resource& other) const noexcept override
+                {
+                    return this == &other;
+                }
+        };
+
+        class null_memory_resource_t: public memory_resource
+        {
+            private:
+                void* do_allocate(size_t, size_t) override
+                {
+                    throw bad_alloc{};
+
+                    return nullptr;
+                }
+
+                void do_deallocate(void*, size_t, size_t) override
+                { /* DUMMY BODY */ }
+
+                bool do_is_equal(const memory_resource& other) const noexcept override
+                {
+                    return this == &other;
+                }
+        };
+
+        atomic<memory_resource*> default_resource{nullptr};
+
+        constexpr size_t default_max_blocks_per_chunk = 1024;
+        constexpr size_t default_largest_required_pool_block = 4096;
+        constexpr size_t initial_blocks_per_chunk = 16;
+
+        size_t ceil_log2(size_t n)
+        {
+            size_t res{};
+            while ((size_t{1} << res) < n)
+                ++res;
+
+            return res;
+        }
+    }
+
+    memory_resource* new_delete_resource() noexcept
+    {
+        static new_delete_resource_t instance{};
+
+        return &instance;
+    }
+
+    memory_resource* null_memory_resource() noexcept
+    {
+        static null_memory_resource_t instance{};
+
+        return &instance;
+    }
+
+    memory_resource* set_default_resource(memory_resource* res) noexcept
+    {
+        if (!res)
+            res = new_delete_resource();
+
+        auto old = default_resource.exchange(res);
+
+        return old ? old : new_delete_resource();
+    }
+
+    memory_resource* get_default_resource() noexcept
+    {
+        auto res = default_resource.load();
+
+        return res ? res : new_delete_resource();
+    }
+
+    unsynchronized_pool_resource::unsynchronized_pool_resource(
+        const pool_options& opts, memory_resource* upstream
+    )
+        : upstream_{upstream}, options_{opts}, pool_count_{},
+          pools_{}, oversized_{}
+    {
+        if (options_.max_blocks_per_chunk == 0)
+            options_.max_blocks_per_chunk = default_max_blocks_per_chunk;
+
+        if (options_.largest_required_pool_block == 0)
+            options_.largest_required_pool_block = default_largest_required_pool_block;
+
+        auto shift = ceil_log2(options_.largest_required_pool_block);
+        shift = std::max(shift, min_block_shift_);
+        shift = std::min(shift, min_block_shift_ + max_pools_ - 1);
+
+        options_.largest_required_pool_block = size_t{1} << shift;
+        pool_count_ = shift - min_block_shift_ + 1;
+
+        for (size_t i = 0; i < pool_count_; ++i)
+        {
+            pools_[i].next_blocks = std::min(
+                initial_blocks_per_chunk, options_.max_blocks_per_chunk
+            );
+        }
+    }
+
+    unsynchronized_pool_resource::~unsynchronized_pool_resource()
+    {
+        release();
+    }
+
+    void unsynchronized_pool_resource::release()
+    {
+        for (size_t i = 0; i < pool_count_; ++i)
+        {
+            auto& p = pools_[i];
+            while (p.chunks)
+            {
+                auto c = p.chunks;
+                p.chunks = c->next;
+
+                auto base = reinterpret_cast<char*>(c) - (c->bytes - sizeof(chunk));
+                upstream_->deallocate(base, c->bytes, c->alignment);
+            }
+
+            p.free = nullptr;
+            p.next_blocks = std::min(
+                initial_blocks_per_chunk, options_.max_blocks_per_chunk
+            );
+        }
+
+        while (oversized_)
+        {
+            auto o = oversized_;
+            oversized_ = o->next;
+
+            auto base = reinterpret_cast<char*>(o + 1) - o->offset;
+            upstream_->deallocate(base, o->bytes, o->alignment);
+        }
+    }
+
+    void* unsynchronized_pool_resource::do_allocate(size_t bytes, size_t alignment)
+    {
+        auto idx = pool_index_(bytes, alignment);
+        if (idx < pool_count_)
+        {
+            auto& p = pools_[idx];
+            if (!p.free)
+                refill_(p, size_t{1} << (idx + min_block_shift_));
+
+            auto b = p.free;
+            p.free = b->next;
+
+            return b;
+        }
+
+        /**
+         * The header is placed right in front of the returned
+         * memory, the padding in front of it keeps the memory
+         * aligned as requested.
+         */
+        alignment = std::max(alignment, alignof(oversized));
+        auto offset = (sizeof(oversized) + alignment - 1) / alignment * alignment;
+
+        auto base = static_cast<char*>(upstream_->allocate(bytes + offset, alignment));
+        auto o = reinterpret_cast<oversized*>(base + offset) - 1;
+        o->bytes = bytes + offset;
+        o->alignment = alignment;
+        o->offset = offset;
+
+        o->prev = nullptr;
+        o->next = oversized_;
+        if (oversized_)
+            oversized_->prev = o;
+        oversized_ = o;
+
+        return o + 1;
+    }
+
+    void unsynchronized_pool_resource::do_deallocate(void* ptr, size_t bytes, size_t alignment)
+    {
+        auto idx = pool_index_(bytes, alignment);
+        if (idx < pool_count_)
+        {
+            auto& p = pools_[idx];
+            auto b = static_cast<block*>(ptr);
+
+            b->next = p.free;
+            p.free = b;
+
+            return;
+        }
+
+        auto o = static_cast<oversized*>(ptr) - 1;
+        if (o->prev)
+            o->prev->next = o->next;
+        else
+            oversized_ = o->next;
+        if (o->next)
+            o->next->prev = o->prev;
+
+        auto base = static_cast<char*>(ptr) - o->offset;
+        upstream_->deallocate(base, o->bytes, o->alignment);
+    }
+
+    bool unsynchronized_pool_resource::do_is_equal(const memory_resource& other) const noexcept
+    {
+        return this == &other;
+    }
+
+    size_t unsynchronized_pool_resource::pool_index_(size_t bytes, size_t alignment) const
+    {
+        /**
+         * Note: Chunks are only aligned to max_align, over-aligned
+         *       requests are therefore served from upstream.
+         */
+        if (alignment > max_align || bytes > options_.largest_required_pool_block)
+            return pool_count_;
+
+        auto shift = ceil_log2(std::max(bytes, alignment));
+
+        return shift < min_block_shift_ ? 0 : shift - min_block_shift_;
+    }
+
+    void unsynchronized_pool_resource::refill_(pool& p, size_t block_size)
+    {
+        auto count = p.next_blocks;
+        auto alignment = std::min(block_size, max_align);
+        auto bytes = count * block_size + sizeof(chunk);
+
+        auto base = static_cast<char*>(upstream_->allocate(bytes, alignment));
+
+        /**
+         * The chunk header goes after the blocks, so that
+         * it does not disturb their alignment.
+         */
+        auto c = reinterpret_cast<chunk*>(base + count * block_size);
+        c->bytes = bytes;
+        c->alignment = alignment;
+        c->next = p.chunks;
+        p.chunks = c;
+
+        for (size_t i = count; i > 0; --i)
+        {
+            auto b = reinterpret_cast<block*>(base + (i - 1) * block_size);
+            b->next = p.free;
+            p.free = b;
+        }
+
+        p.next_blocks = std::min(count * 2, options_.max_blocks_per_chunk);
+    }
+
+    synchronized_pool_resource::synchronized_pool_resource(
+        const pool_options& opts, memory_resource* upstream
+    )
+        : pool_{opts, upstream}, mtx_{}
+    {
+        aux::threading::mutex::init(mtx_);
+    }
+
+    synchronized_pool_resource::~synchronized_pool_resource()
+    { /* DUMMY BODY */ }
+
+    void synchronized_pool_resource::release()
+    {
+        aux::threading::mutex::lock(mtx_);
+        pool_.release();
+        aux::threading::mutex::unlock(mtx_);
+    }
+
+    void* synchronized_pool_resource::do_allocate(size_t bytes, size_t alignment)
+    {
+        aux::threading::mutex::lock(mtx_);
+        auto res = pool_.allocate(bytes, alignment);
+        aux::threading::mutex::unlock(mtx_);
+
+        return res;
+    }
+
+    void synchronized_pool_resource::do_deallocate(void* ptr, size_t bytes, size_t alignment)
+    {
+        aux::threading::mutex::lock(mtx_);
+        pool_.deallocate(ptr, bytes, alignment);
+        aux::threading::mutex::unlock(mtx_);
+    }
+
+    bool synchronized_pool_resource::do_is_equal(const memory_resource& other) const noexcept
+    {
+        return this == &other;
+    }
+
+    monotonic_buffer_resource::monotonic_buffer_resource(memory_resource* upstream)
+        : upstream_{upstream}, initial_buffer_{}, initial_size_{default_size_},
+          current_{}, space_{}, next_size_{default_size_}, chunks_{}
+    { /* DUMMY BODY */ }
+
+    monotonic_buffer_resource::monotonic_buffer_resource(
+        size_t initial_size, memory_resource* upstream
+    )
+        : upstream_{upstream}, initial_buffer_{},
+          initial_size_{initial_size ? initial_size : default_size_},
+          current_{}, space_{}, next_size_{initial_size_}, chunks_{}
+    { /* DUMMY BODY */ }
+
+    monotonic_buffer_resource::monotonic_buffer_resource(
+        void* buffer, size_t size, memory_resource* upstream
+    )
+        : upstream_{upstream}, initial_buffer_{buffer}, initial_size_{size},
+          current_{static_cast<char*>(buffer)}, space_{size},
+          next_size_{size ? size * 2 : default_size_}, chunks_{}
+    { /* DUMMY BODY */ }
+
+    monotonic_buffer_resource::~monotonic_buffer_resource()
+    {
+        release();
+    }
+
+    void monotonic_buffer_resource::release()
+    {
+        while (chunks_)
+        {
+            auto c = chunks_;
+            chunks_ = c->next;
+
+            upstream_->deallocate(c, c->bytes, max_align);
+        }
+
+        current_ = static_cast<char*>(initial_buffer_);
+        if (initial_buffer_)
+        {
+            space_ = initial_size_;
+            next_size_ = initial_size_ ? initial_size_ * 2 : default_size_;
+        }
+        else
+        {
+            space_ = 0;
+            next_size_ = initial_size_;
+        }
+    }
+
+    void* monotonic_buffer_resource::do_allocate(size_t bytes, size_t alignment)
+    {
+        auto addr = reinterpret_cast<uintptr_t>(current_);
+        auto padding = ((addr + alignment - 1) & ~(alignment - 1)) - addr;
+
+        if (!current_ || padding + bytes > space_)
+        {
+            auto size = std::max(next_size_, bytes + alignment + sizeof(chunk));
+
+            auto c = static_cast<chunk*>(upstream_->allocate(size, max_align));
+            c->next = chunks_;
+            c->bytes = size;
+            chunks_ = c;
+
+            current_ = reinterpret_cast<char*>(c + 1);
+            space_ = size - sizeof(chunk);
+            next_size_ = size * 2;
+
+            addr = reinterpret_cast<uintptr_t>(current_);
+            padding = ((addr + alignment - 1) & ~(alignment - 1)) - addr;
+        }
+
+        auto res = current_ + padding;
+        current_ = res + bytes;
+        space_ -= padding + bytes;
+
+        return res;
+    }
+
+    void monotonic_buffer_resource::do_deallocate(void*, size_t, size_t)
+    { /* DUMMY BODY */ }
+
+    bool monotonic_buffer_resource::do_is_equal(const memory_resource& other) const noexcept
+    {
+        return this == &other;
+    }
+}
@@ -31,6 +31,13 @@
 #include <thread>
 #include <utility>
 
+namespace std::hel
+{
+    extern "C" {
+        #include <stats.h>
+    }
+}
+
 namespace std
 {
     thread::thread() noexcept
@@ -118,8 +125,20 @@ namespace std
 
     unsigned thread::hardware_concurrency() noexcept
     {
-        // TODO:
-        return 0;
+        size_t count{};
+        auto cpus = hel::stats_get_cpus(&count);
+        if (!cpus)
+            return 0;
+
+        unsigned res{};
+        for (size_t i = 0; i < count; ++i)
+        {
+            if (cpus[i].active)
+                ++res;
+        }
+        std::free(cpus);
+
+        return res;
     }
 
     void swap(thread& x, thread& y) noexcept
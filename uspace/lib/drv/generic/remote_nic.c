@@ -85,7 +85,8 @@ typedef enum {
 	NIC_OFFLOAD_SET,
 	NIC_POLL_GET_MODE,
 	NIC_POLL_SET_MODE,
-	NIC_POLL_NOW
+	NIC_POLL_NOW,
+	NIC_SEND_MESSAGE_CSUM
 } nic_funcs_t;
 
 /** Send frame from NIC
@@ -117,6 +118,43 @@ errno_t nic_send_frame(async_sess_t *dev_sess, void *data, size_t size)
 	return retval;
 }
 
+/** Send frame with a partial transport-layer checksum
+ *
+ * The checksum field at offset @a csum_start + @a csum_offs holds the
+ * folded pseudo-header sum. The checksum is completed by the NIC if
+ * NIC_OFFLOAD_TX_CSUM is active, otherwise in software by the driver
+ * framework.
+ *
+ * @param[in] dev_sess
+ * @param[in] data       Frame data
+ * @param[in] size       Frame size in bytes
+ * @param[in] csum_start Offset where checksumming starts
+ * @param[in] csum_offs  Offset of checksum field relative to @a csum_start
+ *
+ * @return EOK If the operation was successfully completed
+ *
+ */
+errno_t nic_send_frame_csum(async_sess_t *dev_sess, void *data, size_t size,
+    size_t csum_start, size_t csum_offs)
+{
+	async_exch_t *exch = async_exchange_begin(dev_sess);
+
+	ipc_call_t answer;
+	aid_t req = async_send_3(exch, DEV_IFACE_ID(NIC_DEV_IFACE),
+	    NIC_SEND_MESSAGE_CSUM, csum_start, csum_offs, &answer);
+	errno_t retval = async_data_write_start(exch, data, size);
+
+	async_exchange_end(exch);
+
+	if (retval != EOK) {
+		async_forget(req);
+		return retval;
+	}
+
+	async_wait_for(req, &retval);
+	return retval;
+}
+
 /** Create callback connection from NIC service
  *
  * @param[in] dev_sess
@@ -1244,7 +1282,7 @@ errno_t nic_offload_set(async_sess_t *dev_sess, uint32_t mask, uint32_t active)
 {
 	async_exch_t *exch = async_exchange_begin(dev_sess);
 	errno_t rc = async_req_3_0(exch, DEV_IFACE_ID(NIC_DEV_IFACE),
-	    NIC_AUTONEG_RESTART, (sysarg_t) mask, (sysarg_t) active);
+	    NIC_OFFLOAD_SET, (sysarg_t) mask, (sysarg_t) active);
 	async_exchange_end(exch);
 
 	return rc;
@@ -1356,6 +1394,32 @@ static void remote_nic_send_frame(ddf_fun_t *dev, void *iface,
 	free(data);
 }
 
+static void remote_nic_send_frame_csum(ddf_fun_t *dev, void *iface,
+    ipc_call_t *call)
+{
+	nic_iface_t *nic_iface = (nic_iface_t *) iface;
+	if (nic_iface->send_frame_csum == NULL) {
+		async_answer_0(call, ENOTSUP);
+		return;
+	}
+
+	size_t csum_start = (size_t) IPC_GET_ARG2(*call);
+	size_t csum_offs = (size_t) IPC_GET_ARG3(*call);
+	void *data;
+	size_t size;
+	errno_t rc;
+
+	rc = async_data_write_accept(&data, false, 0, 0, 0, &size);
+	if (rc != EOK) {
+		async_answer_0(call, EINVAL);
+		return;
+	}
+
+	rc = nic_iface->send_frame_csum(dev, data, size, csum_start, csum_offs);
+	async_answer_0(call, rc);
+	free(data);
+}
+
 static void remote_nic_callback_create(ddf_fun_t *dev, void *iface,
     ipc_call_t *call)
 {
@@ -2529,7 +2593,8 @@ static const remote_iface_func_ptr_t remote_nic_iface_ops[] = {
 	[NIC_OFFLOAD_SET] = remote_nic_offload_set,
 	[NIC_POLL_GET_MODE] = remote_nic_poll_get_mode,
 	[NIC_POLL_SET_MODE] = remote_nic_poll_set_mode,
-	[NIC_POLL_NOW] = remote_nic_poll_now
+	[NIC_POLL_NOW] = remote_nic_poll_now,
+	[NIC_SEND_MESSAGE_CSUM] = remote_nic_send_frame_csum
 };
 
 /** Remote NIC interface structure.
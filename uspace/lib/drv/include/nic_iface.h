@@ -42,10 +42,19 @@
 typedef enum {
 	NIC_EV_ADDR_CHANGED = IPC_FIRST_USER_METHOD,
 	NIC_EV_RECEIVED,
-	NIC_EV_DEVICE_STATE
+	NIC_EV_DEVICE_STATE,
+	NIC_EV_RECEIVED_BATCH
 } nic_event_t;
 
+/** Maximum number of frames delivered by one NIC_EV_RECEIVED_BATCH event */
+#define NIC_EV_RECEIVED_BATCH_MAX  32
+
+/** Maximum total size of frames in one NIC_EV_RECEIVED_BATCH event */
+#define NIC_EV_RECEIVED_BATCH_SIZE_MAX  (NIC_EV_RECEIVED_BATCH_MAX * 65536)
+
 extern errno_t nic_send_frame(async_sess_t *, void *, size_t);
+extern errno_t nic_send_frame_csum(async_sess_t *, void *, size_t, size_t,
+    size_t);
 extern errno_t nic_callback_create(async_sess_t *, async_port_handler_t, void *);
 extern errno_t nic_get_state(async_sess_t *, nic_device_state_t *);
 extern errno_t nic_set_state(async_sess_t *, nic_device_state_t);
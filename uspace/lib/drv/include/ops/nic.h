@@ -101,6 +101,7 @@ typedef struct nic_iface {
 
 	errno_t (*offload_probe)(ddf_fun_t *, uint32_t *, uint32_t *);
 	errno_t (*offload_set)(ddf_fun_t *, uint32_t, uint32_t);
+	errno_t (*send_frame_csum)(ddf_fun_t *, void *, size_t, size_t, size_t);
 
 	errno_t (*poll_get_mode)(ddf_fun_t *, nic_poll_mode_t *,
 	    struct timespec *);
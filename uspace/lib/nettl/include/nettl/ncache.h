@@ -0,0 +1,123 @@
+/*
+ * Copyright (c) 2019 Jiri Svoboda
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * - Redistributions of source code must retain the above copyright
+ *   notice, this list of conditions and the following disclaimer.
+ * - Redistributions in binary form must reproduce the above copyright
+ *   notice, this list of conditions and the following disclaimer in the
+ *   documentation and/or other materials provided with the distribution.
+ * - The name of the author may not be used to endorse or promote products
+ *   derived from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHOR ``AS IS'' AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+ * OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+ * IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT
+ * NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF
+ * THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/** @addtogroup libnettl
+ * @{
+ */
+/**
+ * @file Neighbour cache.
+ */
+
+#ifndef LIBNETTL_NCACHE_H_
+#define LIBNETTL_NCACHE_H_
+
+#include <adt/hash_table.h>
+#include <adt/list.h>
+#include <fibril_synch.h>
+#include <inet/addr.h>
+#include <types/inet/nstats.h>
+
+/** Neighbour cache entry state */
+typedef enum {
+	/** Resolution in progress, packets are queued */
+	ncs_incomplete,
+	/** Link-layer address is known */
+	ncs_reachable,
+	/** Resolution failed (negative entry) */
+	ncs_failed
+} ncache_state_t;
+
+/** Neighbour cache entry */
+typedef struct {
+	/** Link to ncache_t.entries */
+	ht_link_t lentries;
+	/** Network address */
+	inet_addr_t addr;
+	/** Link-layer address (valid in ncs_reachable state) */
+	addr48_t mac;
+	/** State */
+	ncache_state_t state;
+	/** Remaining lifetime in ticks */
+	unsigned ttl;
+	/** Number of solicitations sent */
+	unsigned nsolicit;
+	/** Source address for solicitations */
+	inet_addr_t src;
+	/** Packets waiting for resolution (of ncache_pkt_t) */
+	list_t pkts;
+	/** Number of entries in @c pkts */
+	size_t npkts;
+} ncache_entry_t;
+
+/** Packet waiting for address resolution */
+typedef struct {
+	/** Link to ncache_entry_t.pkts */
+	link_t lpkts;
+	/** Packet (owned by the cache user) */
+	void *pkt;
+} ncache_pkt_t;
+
+/** Neighbour cache callbacks */
+typedef struct {
+	/** Send solicitation (ARP request, neighbour solicitation) */
+	errno_t (*solicit)(void *, inet_addr_t *, inet_addr_t *);
+	/** Transmit queued packet to the resolved link-layer address */
+	void (*xmit)(void *, void *, addr48_t);
+	/** Discard queued packet */
+	void (*discard)(void *, void *);
+} ncache_ops_t;
+
+/** Neighbour cache */
+typedef struct {
+	/** Protects the cache */
+	fibril_mutex_t lock;
+	/** Entries (of ncache_entry_t) */
+	hash_table_t entries;
+	/** Callbacks */
+	ncache_ops_t *ops;
+	/** Callback argument */
+	void *arg;
+	/** Aging timer */
+	fibril_timer_t *timer;
+	/** Statistics */
+	inet_nstats_t stats;
+} ncache_t;
+
+extern errno_t ncache_create(ncache_ops_t *, void *, ncache_t **);
+extern void ncache_destroy(ncache_t *);
+extern errno_t ncache_add(ncache_t *, inet_addr_t *, addr48_t);
+extern errno_t ncache_remove(ncache_t *, inet_addr_t *);
+extern errno_t ncache_resolve(ncache_t *, inet_addr_t *, inet_addr_t *,
+    void *, addr48_t);
+extern void ncache_age(ncache_t *);
+extern void ncache_get_stats(ncache_t *, inet_nstats_t *);
+
+#endif
+
+/** @}
+ */
@@ -49,7 +49,8 @@
  * all remote and local addresses.
  */
 
-#include <adt/list.h>
+#include <adt/hash.h>
+#include <adt/hash_table.h>
 #include <errno.h>
 #include <inet/addr.h>
 #include <inet/inet.h>
@@ -58,6 +59,150 @@
 #include <stdint.h>
 #include <stdlib.h>
 
+/** Define to log association map operations (slow) */
+#undef AMAP_DEBUG
+
+#ifdef AMAP_DEBUG
+#define amap_debug(...) log_msg(LOG_DEFAULT, LVL_DEBUG2, __VA_ARGS__)
+#else
+#define amap_debug(...) ((void) 0)
+#endif
+
+/** Key of repla hash table */
+typedef struct {
+	/** Remote endpoint */
+	inet_ep_t *rep;
+	/** Local address */
+	inet_addr_t *laddr;
+} amap_repla_key_t;
+
+/** Compute hash of an address.
+ *
+ * @param addr Address
+ * @return Hash
+ */
+static size_t amap_addr_hash(const inet_addr_t *addr)
+{
+	size_t hash = addr->version;
+	size_t i;
+
+	switch (addr->version) {
+	case ip_v4:
+		hash = hash_combine(hash, addr->addr);
+		break;
+	case ip_v6:
+		for (i = 0; i < sizeof(addr128_t); i += 4) {
+			hash = hash_combine(hash,
+			    ((size_t) addr->addr6[i] << 24) |
+			    ((size_t) addr->addr6[i + 1] << 16) |
+			    ((size_t) addr->addr6[i + 2] << 8) |
+			    addr->addr6[i + 3]);
+		}
+		break;
+	default:
+		break;
+	}
+
+	return hash;
+}
+
+static size_t amap_repla_hash_key(amap_repla_key_t *key)
+{
+	size_t hash;
+
+	hash = amap_addr_hash(&key->rep->addr);
+	hash = hash_combine(hash, key->rep->port);
+	hash = hash_combine(hash, amap_addr_hash(key->laddr));
+	return hash_mix(hash);
+}
+
+static size_t amap_repla_key_hash(void *key)
+{
+	return amap_repla_hash_key((amap_repla_key_t *) key);
+}
+
+static size_t amap_repla_hash(const ht_link_t *item)
+{
+	amap_repla_t *repla = hash_table_get_inst(item, amap_repla_t, lamap);
+	amap_repla_key_t key = {
+		.rep = &repla->rep,
+		.laddr = &repla->laddr
+	};
+
+	return amap_repla_hash_key(&key);
+}
+
+static bool amap_repla_key_equal(void *arg, const ht_link_t *item)
+{
+	amap_repla_key_t *key = (amap_repla_key_t *) arg;
+	amap_repla_t *repla = hash_table_get_inst(item, amap_repla_t, lamap);
+
+	return repla->rep.port == key->rep->port &&
+	    inet_addr_compare(&repla->rep.addr, &key->rep->addr) &&
+	    inet_addr_compare(&repla->laddr, key->laddr);
+}
+
+/** Remote endpoint, local address hash table operations. */
+static hash_table_ops_t amap_repla_ops = {
+	.hash = amap_repla_hash,
+	.key_hash = amap_repla_key_hash,
+	.key_equal = amap_repla_key_equal,
+	.equal = NULL,
+	.remove_callback = NULL
+};
+
+static size_t amap_laddr_key_hash(void *key)
+{
+	return hash_mix(amap_addr_hash((inet_addr_t *) key));
+}
+
+static size_t amap_laddr_hash(const ht_link_t *item)
+{
+	amap_laddr_t *laddr = hash_table_get_inst(item, amap_laddr_t, lamap);
+	return hash_mix(amap_addr_hash(&laddr->laddr));
+}
+
+static bool amap_laddr_key_equal(void *key, const ht_link_t *item)
+{
+	amap_laddr_t *laddr = hash_table_get_inst(item, amap_laddr_t, lamap);
+	return inet_addr_compare(&laddr->laddr, (inet_addr_t *) key);
+}
+
+/** Local address hash table operations. */
+static hash_table_ops_t amap_laddr_ops = {
+	.hash = amap_laddr_hash,
+	.key_hash = amap_laddr_key_hash,
+	.key_equal = amap_laddr_key_equal,
+	.equal = NULL,
+	.remove_callback = NULL
+};
+
+static size_t amap_llink_key_hash(void *key)
+{
+	return hash_mix(*(sysarg_t *) key);
+}
+
+static size_t amap_llink_hash(const ht_link_t *item)
+{
+	amap_llink_t *llink = hash_table_get_inst(item, amap_llink_t, lamap);
+	return hash_mix(llink->llink);
+}
+
+static bool amap_llink_key_equal(void *key, const ht_link_t *item)
+{
+	amap_llink_t *llink = hash_table_get_inst(item, amap_llink_t, lamap);
+	return llink->llink == *(sysarg_t *) key;
+}
+
+/** Local link hash table operations. */
+static hash_table_ops_t amap_llink_ops = {
+	.hash = amap_llink_hash,
+	.key_hash = amap_llink_key_hash,
+	.key_equal = amap_llink_key_equal,
+	.equal = NULL,
+	.remove_callback = NULL
+};
+
 /** Convert association map flags to port range flags.
  *
  * @param flags Association map flags
@@ -84,7 +229,7 @@ errno_t amap_create(amap_t **rmap)
 	amap_t *map;
 	errno_t rc;
 
-	log_msg(LOG_DEFAULT, LVL_DEBUG2, "amap_create()");
+	amap_debug("amap_create()");
 
 	map = calloc(1, sizeof(amap_t));
 	if (map == NULL)
@@ -93,16 +238,27 @@ errno_t amap_create(amap_t **rmap)
 	rc = portrng_create(&map->unspec);
 	if (rc != EOK) {
 		assert(rc == ENOMEM);
-		free(map);
-		return ENOMEM;
+		goto error;
 	}
 
-	list_initialize(&map->repla);
-	list_initialize(&map->laddr);
-	list_initialize(&map->llink);
+	if (!hash_table_create(&map->repla, 0, 0, &amap_repla_ops))
+		goto error;
+	if (!hash_table_create(&map->laddr, 0, 0, &amap_laddr_ops))
+		goto error;
+	if (!hash_table_create(&map->llink, 0, 0, &amap_llink_ops))
+		goto error;
 
 	*rmap = map;
 	return EOK;
+error:
+	if (map->laddr.bucket != NULL)
+		hash_table_destroy(&map->laddr);
+	if (map->repla.bucket != NULL)
+		hash_table_destroy(&map->repla);
+	if (map->unspec != NULL)
+		portrng_destroy(map->unspec);
+	free(map);
+	return ENOMEM;
 }
 
 /** Destroy association map.
@@ -111,11 +267,15 @@ errno_t amap_create(amap_t **rmap)
  */
 void amap_destroy(amap_t *map)
 {
-	log_msg(LOG_DEFAULT, LVL_DEBUG2, "amap_destroy()");
-
-	assert(list_empty(&map->repla));
-	assert(list_empty(&map->laddr));
-	assert(list_empty(&map->llink));
+	amap_debug("amap_destroy()");
+
+	assert(hash_table_empty(&map->repla));
+	assert(hash_table_empty(&map->laddr));
+	assert(hash_table_empty(&map->llink));
+	hash_table_destroy(&map->repla);
+	hash_table_destroy(&map->laddr);
+	hash_table_destroy(&map->llink);
+	portrng_destroy(map->unspec);
 	free(map);
 }
 
@@ -133,34 +293,20 @@ void amap_destroy(amap_t *map)
 static errno_t amap_repla_find(amap_t *map, inet_ep_t *rep, inet_addr_t *la,
     amap_repla_t **rrepla)
 {
-	char *sraddr, *sladdr;
-
-	(void) inet_addr_format(&rep->addr, &sraddr);
-	(void) inet_addr_format(la, &sladdr);
-
-	log_msg(LOG_DEFAULT, LVL_DEBUG2, "amap_repla_find(): rep=(%s,%" PRIu16
-	    ") la=%s", sraddr, rep->port, sladdr);
-	free(sraddr);
-	free(sladdr);
-
-	list_foreach(map->repla, lamap, amap_repla_t, repla) {
-		(void) inet_addr_format(&repla->rep.addr, &sraddr);
-		(void) inet_addr_format(&repla->laddr, &sladdr);
-		log_msg(LOG_DEFAULT, LVL_DEBUG2, "amap_repla_find(): "
-		    "compare to rep=(%s, %" PRIu16 ") la=%s",
-		    sraddr, repla->rep.port, sladdr);
-		free(sraddr);
-		free(sladdr);
-		if (inet_addr_compare(&repla->rep.addr, &rep->addr) &&
-		    repla->rep.port == rep->port &&
-		    inet_addr_compare(&repla->laddr, la)) {
-			*rrepla = repla;
-			return EOK;
-		}
+	amap_repla_key_t key;
+	ht_link_t *link;
+
+	key.rep = rep;
+	key.laddr = la;
+
+	link = hash_table_find(&map->repla, &key);
+	if (link == NULL) {
+		*rrepla = NULL;
+		return ENOENT;
 	}
 
-	*rrepla = NULL;
-	return ENOENT;
+	*rrepla = hash_table_get_inst(link, amap_repla_t, lamap);
+	return EOK;
 }
 
 /** Insert repla.
@@ -194,7 +340,7 @@ static errno_t amap_repla_insert(amap_t *map, inet_ep_t *rep, inet_addr_t *la,
 
 	repla->rep = *rep;
 	repla->laddr = *la;
-	list_append(&repla->lamap, &map->repla);
+	hash_table_insert(&map->repla, &repla->lamap);
 
 	*rrepla = repla;
 	return EOK;
@@ -209,7 +355,7 @@ static errno_t amap_repla_insert(amap_t *map, inet_ep_t *rep, inet_addr_t *la,
  */
 static void amap_repla_remove(amap_t *map, amap_repla_t *repla)
 {
-	list_remove(&repla->lamap);
+	hash_table_remove_item(&map->repla, &repla->lamap);
 	portrng_destroy(repla->portrng);
 	free(repla);
 }
@@ -227,15 +373,16 @@ static void amap_repla_remove(amap_t *map, amap_repla_t *repla)
 static errno_t amap_laddr_find(amap_t *map, inet_addr_t *addr,
     amap_laddr_t **rladdr)
 {
-	list_foreach(map->laddr, lamap, amap_laddr_t, laddr) {
-		if (inet_addr_compare(&laddr->laddr, addr)) {
-			*rladdr = laddr;
-			return EOK;
-		}
+	ht_link_t *link;
+
+	link = hash_table_find(&map->laddr, addr);
+	if (link == NULL) {
+		*rladdr = NULL;
+		return ENOENT;
 	}
 
-	*rladdr = NULL;
-	return ENOENT;
+	*rladdr = hash_table_get_inst(link, amap_laddr_t, lamap);
+	return EOK;
 }
 
 /** Insert laddr.
@@ -266,7 +413,7 @@ static errno_t amap_laddr_insert(amap_t *map, inet_addr_t *addr,
 	}
 
 	laddr->laddr = *addr;
-	list_append(&laddr->lamap, &map->laddr);
+	hash_table_insert(&map->laddr, &laddr->lamap);
 
 	*rladdr = laddr;
 	return EOK;
@@ -281,7 +428,7 @@ static errno_t amap_laddr_insert(amap_t *map, inet_addr_t *addr,
  */
 static void amap_laddr_remove(amap_t *map, amap_laddr_t *laddr)
 {
-	list_remove(&laddr->lamap);
+	hash_table_remove_item(&map->laddr, &laddr->lamap);
 	portrng_destroy(laddr->portrng);
 	free(laddr);
 }
@@ -299,15 +446,16 @@ static void amap_laddr_remove(amap_t *map, amap_laddr_t *laddr)
 static errno_t amap_llink_find(amap_t *map, sysarg_t link_id,
     amap_llink_t **rllink)
 {
-	list_foreach(map->llink, lamap, amap_llink_t, llink) {
-		if (llink->llink == link_id) {
-			*rllink = llink;
-			return EOK;
-		}
+	ht_link_t *link;
+
+	link = hash_table_find(&map->llink, &link_id);
+	if (link == NULL) {
+		*rllink = NULL;
+		return ENOENT;
 	}
 
-	*rllink = NULL;
-	return ENOENT;
+	*rllink = hash_table_get_inst(link, amap_llink_t, lamap);
+	return EOK;
 }
 
 /** Insert llink.
@@ -338,7 +486,7 @@ static errno_t amap_llink_insert(amap_t *map, sysarg_t link_id,
 	}
 
 	llink->llink = link_id;
-	list_append(&llink->lamap, &map->llink);
+	hash_table_insert(&map->llink, &llink->lamap);
 
 	*rllink = llink;
 	return EOK;
@@ -353,7 +501,7 @@ static errno_t amap_llink_insert(amap_t *map, sysarg_t link_id,
  */
 static void amap_llink_remove(amap_t *map, amap_llink_t *llink)
 {
-	list_remove(&llink->lamap);
+	hash_table_remove_item(&map->llink, &llink->lamap);
 	portrng_destroy(llink->portrng);
 	free(llink);
 }
@@ -378,7 +526,7 @@ static errno_t amap_insert_repla(amap_t *map, inet_ep2_t *epp, void *arg,
 	inet_ep2_t mepp;
 	errno_t rc;
 
-	log_msg(LOG_DEFAULT, LVL_DEBUG2, "amap_insert_repla()");
+	amap_debug("amap_insert_repla()");
 
 	rc = amap_repla_find(map, &epp->remote, &epp->local.addr, &repla);
 	if (rc != EOK) {
@@ -423,7 +571,7 @@ static errno_t amap_insert_laddr(amap_t *map, inet_ep2_t *epp, void *arg,
 	inet_ep2_t mepp;
 	errno_t rc;
 
-	log_msg(LOG_DEFAULT, LVL_DEBUG2, "amap_insert_laddr()");
+	amap_debug("amap_insert_laddr()");
 
 	rc = amap_laddr_find(map, &epp->local.addr, &laddr);
 	if (rc != EOK) {
@@ -467,7 +615,7 @@ static errno_t amap_insert_llink(amap_t *map, inet_ep2_t *epp, void *arg,
 	inet_ep2_t mepp;
 	errno_t rc;
 
-	log_msg(LOG_DEFAULT, LVL_DEBUG2, "amap_insert_llink()");
+	amap_debug("amap_insert_llink()");
 
 	rc = amap_llink_find(map, epp->local_link, &llink);
 	if (rc != EOK) {
@@ -510,7 +658,7 @@ static errno_t amap_insert_unspec(amap_t *map, inet_ep2_t *epp, void *arg,
 	inet_ep2_t mepp;
 	errno_t rc;
 
-	log_msg(LOG_DEFAULT, LVL_DEBUG2, "amap_insert_unspec()");
+	amap_debug("amap_insert_unspec()");
 	mepp = *epp;
 
 	rc = portrng_alloc(map->unspec, epp->local.port, arg, aflags_to_pflags(flags),
@@ -544,24 +692,23 @@ errno_t amap_insert(amap_t *map, inet_ep2_t *epp, void *arg, amap_flags_t flags,
 	inet_ep2_t mepp;
 	errno_t rc;
 
-	log_msg(LOG_DEFAULT, LVL_DEBUG2, "amap_insert()");
+	amap_debug("amap_insert()");
 
 	mepp = *epp;
 
 	/* Fill in local address? */
 	if (!inet_addr_is_any(&epp->remote.addr) &&
 	    inet_addr_is_any(&epp->local.addr)) {
-		log_msg(LOG_DEFAULT, LVL_DEBUG2, "amap_insert: "
-		    "determine local address");
+		amap_debug("amap_insert: determine local address");
 		rc = inet_get_srcaddr(&epp->remote.addr, 0, &mepp.local.addr);
 		if (rc != EOK) {
-			log_msg(LOG_DEFAULT, LVL_DEBUG2, "amap_insert: "
-			    "cannot determine local address");
+			amap_debug("amap_insert: cannot determine local "
+			    "address");
 			return rc;
 		}
 	} else {
-		log_msg(LOG_DEFAULT, LVL_DEBUG2, "amap_insert: "
-		    "local address specified or remote address not specified");
+		amap_debug("amap_insert: local address specified or "
+		    "remote address not specified");
 	}
 
 	raddr = !inet_addr_is_any(&mepp.remote.addr);
@@ -578,7 +725,7 @@ errno_t amap_insert(amap_t *map, inet_ep2_t *epp, void *arg, amap_flags_t flags,
 	} else if (!raddr && !rport && !laddr && !llink) {
 		return amap_insert_unspec(map, &mepp, arg, flags, aepp);
 	} else {
-		log_msg(LOG_DEFAULT, LVL_DEBUG2, "amap_insert: invalid "
+		amap_debug("amap_insert: invalid "
 		    "combination of raddr=%d rport=%d laddr=%d llink=%d",
 		    raddr, rport, laddr, llink);
 		return EINVAL;
@@ -602,7 +749,7 @@ static void amap_remove_repla(amap_t *map, inet_ep2_t *epp)
 
 	rc = amap_repla_find(map, &epp->remote, &epp->local.addr, &repla);
 	if (rc != EOK) {
-		log_msg(LOG_DEFAULT, LVL_DEBUG2, "amap_remove_repla: not found");
+		amap_debug("amap_remove_repla: not found");
 		return;
 	}
 
@@ -627,7 +774,7 @@ static void amap_remove_laddr(amap_t *map, inet_ep2_t *epp)
 
 	rc = amap_laddr_find(map, &epp->local.addr, &laddr);
 	if (rc != EOK) {
-		log_msg(LOG_DEFAULT, LVL_DEBUG2, "amap_remove_laddr: not found");
+		amap_debug("amap_remove_laddr: not found");
 		return;
 	}
 
@@ -652,7 +799,7 @@ static void amap_remove_llink(amap_t *map, inet_ep2_t *epp)
 
 	rc = amap_llink_find(map, epp->local_link, &llink);
 	if (rc != EOK) {
-		log_msg(LOG_DEFAULT, LVL_DEBUG2, "amap_remove_llink: not found");
+		amap_debug("amap_remove_llink: not found");
 		return;
 	}
 
@@ -687,7 +834,7 @@ void amap_remove(amap_t *map, inet_ep2_t *epp)
 {
 	bool raddr, rport, laddr, llink;
 
-	log_msg(LOG_DEFAULT, LVL_DEBUG2, "amap_remove()");
+	amap_debug("amap_remove()");
 
 	raddr = !inet_addr_is_any(&epp->remote.addr);
 	rport = epp->remote.port != inet_port_any;
@@ -703,7 +850,7 @@ void amap_remove(amap_t *map, inet_ep2_t *epp)
 	} else if (!raddr && !rport && !laddr && !llink) {
 		amap_remove_unspec(map, epp);
 	} else {
-		log_msg(LOG_DEFAULT, LVL_DEBUG2, "amap_remove: invalid "
+		amap_debug("amap_remove: invalid "
 		    "combination of raddr=%d rport=%d laddr=%d llink=%d",
 		    raddr, rport, laddr, llink);
 		return;
@@ -712,7 +859,8 @@ void amap_remove(amap_t *map, inet_ep2_t *epp)
 
 /** Find association matching an endpoint pair.
  *
- * Used to find which association to deliver a datagram to.
+ * Used to find which association to deliver a datagram to. The lookup
+ * does not allocate memory.
  *
  * @param map	Association map
  * @param epp	Endpoint pair
@@ -727,8 +875,7 @@ errno_t amap_find_match(amap_t *map, inet_ep2_t *epp, void **rarg)
 	amap_laddr_t *laddr;
 	amap_llink_t *llink;
 
-	log_msg(LOG_DEFAULT, LVL_DEBUG2, "amap_find_match(llink=%zu)",
-	    epp->local_link);
+	amap_debug("amap_find_match(llink=%zu)", epp->local_link);
 
 	/* Remode endpoint, local address */
 	rc = amap_repla_find(map, &epp->remote, &epp->local.addr, &repla);
@@ -736,8 +883,8 @@ errno_t amap_find_match(amap_t *map, inet_ep2_t *epp, void **rarg)
 		rc = portrng_find_port(repla->portrng, epp->local.port,
 		    rarg);
 		if (rc == EOK) {
-			log_msg(LOG_DEFAULT, LVL_DEBUG2, "Matched repla / "
-			    "port %" PRIu16, epp->local.port);
+			amap_debug("Matched repla / port %" PRIu16,
+			    epp->local.port);
 			return EOK;
 		}
 	}
@@ -748,33 +895,35 @@ errno_t amap_find_match(amap_t *map, inet_ep2_t *epp, void **rarg)
 		rc = portrng_find_port(laddr->portrng, epp->local.port,
 		    rarg);
 		if (rc == EOK) {
-			log_msg(LOG_DEFAULT, LVL_DEBUG2, "Matched laddr / "
-			    "port %" PRIu16, epp->local.port);
+			amap_debug("Matched laddr / port %" PRIu16,
+			    epp->local.port);
 			return EOK;
 		}
 	}
 
 	/* Local link */
-	rc = amap_llink_find(map, epp->local_link, &llink);
-	if (epp->local_link != 0 && rc == EOK) {
-		rc = portrng_find_port(llink->portrng, epp->local.port,
-		    rarg);
+	if (epp->local_link != 0) {
+		rc = amap_llink_find(map, epp->local_link, &llink);
 		if (rc == EOK) {
-			log_msg(LOG_DEFAULT, LVL_DEBUG2, "Matched llink / "
-			    "port %" PRIu16, epp->local.port);
-			return EOK;
+			rc = portrng_find_port(llink->portrng,
+			    epp->local.port, rarg);
+			if (rc == EOK) {
+				amap_debug("Matched llink / port %" PRIu16,
+				    epp->local.port);
+				return EOK;
+			}
 		}
 	}
 
 	/* Unspecified */
 	rc = portrng_find_port(map->unspec, epp->local.port, rarg);
 	if (rc == EOK) {
-		log_msg(LOG_DEFAULT, LVL_DEBUG2, "Matched unspec / port %" PRIu16,
+		amap_debug("Matched unspec / port %" PRIu16,
 		    epp->local.port);
 		return EOK;
 	}
 
-	log_msg(LOG_DEFAULT, LVL_DEBUG2, "No match.");
+	amap_debug("No match.");
 	return ENOENT;
 }
 
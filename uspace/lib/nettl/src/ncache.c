@@ -0,0 +1,588 @@
+/*
+ * Copyright (c) 2019 Jiri Svoboda
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * - Redistributions of source code must retain the above copyright
+ *   notice, this list of conditions and the following disclaimer.
+ * - Redistributions in binary form must reproduce the above copyright
+ *   notice, this list of conditions and the following disclaimer in the
+ *   documentation and/or other materials provided with the distribution.
+ * - The name of the author may not be used to endorse or promote products
+ *   derived from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHOR ``AS IS'' AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+ * OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+ * IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT
+ * NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF
+ * THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/** @addtogroup libnettl
+ * @{
+ */
+/**
+ * @file Neighbour cache
+ *
+ * Maps network addresses of on-link neighbours to their link-layer
+ * addresses (ARP cache, NDP neighbour cache). Entries are kept in a hash
+ * table and age out. While an address is being resolved, packets sent to
+ * it are queued instead of blocking the sender. When resolution fails,
+ * a negative entry is kept for a while so that further packets are
+ * dropped right away instead of triggering another round of solicitations.
+ */
+
+#include <adt/hash.h>
+#include <adt/hash_table.h>
+#include <adt/list.h>
+#include <errno.h>
+#include <fibril_synch.h>
+#include <inet/addr.h>
+#include <mem.h>
+#include <nettl/ncache.h>
+#include <stdlib.h>
+
+/** Aging timer period in microseconds */
+#define NCACHE_TICK  (1000 * 1000)
+
+/** Lifetime of a resolved entry in ticks */
+#define NCACHE_REACHABLE_TTL  300
+
+/** Lifetime of a negative entry in ticks */
+#define NCACHE_FAILED_TTL  20
+
+/** Number of solicitations (one per tick) before resolution fails */
+#define NCACHE_SOLICIT_MAX  3
+
+/** Maximum number of packets queued per unresolved entry */
+#define NCACHE_QUEUE_MAX  8
+
+static void ncache_timer_fun(void *);
+
+/** Solicitation to be sent once the cache is unlocked */
+typedef struct {
+	/** Link to list of solicitations */
+	link_t lsols;
+	/** Source address */
+	inet_addr_t src;
+	/** Address to resolve */
+	inet_addr_t addr;
+} ncache_sol_t;
+
+/** Argument of ncache_age_entry() */
+typedef struct {
+	/** Neighbour cache */
+	ncache_t *nc;
+	/** Packets to discard (of ncache_pkt_t) */
+	list_t *dpkts;
+	/** Solicitations to send (of ncache_sol_t) */
+	list_t *sols;
+} ncache_age_t;
+
+/** Compute hash of an address.
+ *
+ * @param addr Address
+ * @return Hash
+ */
+static size_t ncache_addr_hash(const inet_addr_t *addr)
+{
+	size_t hash = addr->version;
+	size_t i;
+
+	switch (addr->version) {
+	case ip_v4:
+		hash = hash_combine(hash, addr->addr);
+		break;
+	case ip_v6:
+		for (i = 0; i < sizeof(addr128_t); i += 4) {
+			hash = hash_combine(hash,
+			    ((size_t) addr->addr6[i] << 24) |
+			    ((size_t) addr->addr6[i + 1] << 16) |
+			    ((size_t) addr->addr6[i + 2] << 8) |
+			    addr->addr6[i + 3]);
+		}
+		break;
+	default:
+		break;
+	}
+
+	return hash_mix(hash);
+}
+
+static size_t ncache_entry_key_hash(void *key)
+{
+	return ncache_addr_hash((inet_addr_t *) key);
+}
+
+static size_t ncache_entry_hash(const ht_link_t *item)
+{
+	ncache_entry_t *entry = hash_table_get_inst(item, ncache_entry_t,
+	    lentries);
+	return ncache_addr_hash(&entry->addr);
+}
+
+static bool ncache_entry_key_equal(void *key, const ht_link_t *item)
+{
+	ncache_entry_t *entry = hash_table_get_inst(item, ncache_entry_t,
+	    lentries);
+	return inet_addr_compare(&entry->addr, (inet_addr_t *) key);
+}
+
+/** Neighbour cache entry hash table operations. */
+static hash_table_ops_t ncache_entry_ops = {
+	.hash = ncache_entry_hash,
+	.key_hash = ncache_entry_key_hash,
+	.key_equal = ncache_entry_key_equal,
+	.equal = NULL,
+	.remove_callback = NULL
+};
+
+/** Create neighbour cache.
+ *
+ * @param ops  Callbacks
+ * @param arg  Argument to callbacks
+ * @param rnc  Place to store pointer to new neighbour cache
+ * @return EOK on success, ENOMEM if out of memory
+ */
+errno_t ncache_create(ncache_ops_t *ops, void *arg, ncache_t **rnc)
+{
+	ncache_t *nc;
+
+	nc = calloc(1, sizeof(ncache_t));
+	if (nc == NULL)
+		return ENOMEM;
+
+	fibril_mutex_initialize(&nc->lock);
+
+	if (!hash_table_create(&nc->entries, 0, 0, &ncache_entry_ops)) {
+		free(nc);
+		return ENOMEM;
+	}
+
+	nc->timer = fibril_timer_create(&nc->lock);
+	if (nc->timer == NULL) {
+		hash_table_destroy(&nc->entries);
+		free(nc);
+		return ENOMEM;
+	}
+
+	nc->ops = ops;
+	nc->arg = arg;
+
+	fibril_timer_set(nc->timer, NCACHE_TICK, ncache_timer_fun, nc);
+
+	*rnc = nc;
+	return EOK;
+}
+
+/** Move queued packets of an entry to a list.
+ *
+ * @param entry Neighbour cache entry
+ * @param list  List to append the packets to
+ */
+static void ncache_entry_take_pkts(ncache_entry_t *entry, list_t *list)
+{
+	link_t *link;
+
+	while ((link = list_first(&entry->pkts)) != NULL) {
+		list_remove(link);
+		list_append(link, list);
+	}
+
+	entry->npkts = 0;
+}
+
+/** Discard packets in a list.
+ *
+ * @param nc   Neighbour cache
+ * @param list List of ncache_pkt_t
+ */
+static void ncache_discard_pkts(ncache_t *nc, list_t *list)
+{
+	link_t *link;
+	ncache_pkt_t *npkt;
+
+	while ((link = list_first(list)) != NULL) {
+		npkt = list_get_instance(link, ncache_pkt_t, lpkts);
+		list_remove(link);
+		nc->ops->discard(nc->arg, npkt->pkt);
+		free(npkt);
+	}
+}
+
+static bool ncache_destroy_entry(ht_link_t *item, void *arg)
+{
+	ncache_t *nc = (ncache_t *) arg;
+	ncache_entry_t *entry = hash_table_get_inst(item, ncache_entry_t,
+	    lentries);
+	list_t dpkts;
+
+	list_initialize(&dpkts);
+	ncache_entry_take_pkts(entry, &dpkts);
+	ncache_discard_pkts(nc, &dpkts);
+
+	hash_table_remove_item(&nc->entries, item);
+	free(entry);
+	return true;
+}
+
+/** Destroy neighbour cache.
+ *
+ * Packets still waiting for resolution are discarded.
+ *
+ * @param nc Neighbour cache
+ */
+void ncache_destroy(ncache_t *nc)
+{
+	(void) fibril_timer_clear(nc->timer);
+	fibril_timer_destroy(nc->timer);
+
+	hash_table_apply(&nc->entries, ncache_destroy_entry, nc);
+	hash_table_destroy(&nc->entries);
+	free(nc);
+}
+
+/** Find neighbour cache entry.
+ *
+ * @param nc   Neighbour cache (locked)
+ * @param addr Network address
+ * @return Entry or @c NULL if not found
+ */
+static ncache_entry_t *ncache_find(ncache_t *nc, inet_addr_t *addr)
+{
+	ht_link_t *link;
+
+	link = hash_table_find(&nc->entries, addr);
+	if (link == NULL)
+		return NULL;
+
+	return hash_table_get_inst(link, ncache_entry_t, lentries);
+}
+
+/** Create new neighbour cache entry and insert it into the cache.
+ *
+ * @param nc   Neighbour cache (locked)
+ * @param addr Network address
+ * @return New entry or @c NULL if out of memory
+ */
+static ncache_entry_t *ncache_entry_create(ncache_t *nc, inet_addr_t *addr)
+{
+	ncache_entry_t *entry;
+
+	entry = calloc(1, sizeof(ncache_entry_t));
+	if (entry == NULL)
+		return NULL;
+
+	entry->addr = *addr;
+	list_initialize(&entry->pkts);
+
+	hash_table_insert(&nc->entries, &entry->lentries);
+	return entry;
+}
+
+/** Add or refresh translation.
+ *
+ * Called when a neighbour announces its link-layer address. Packets
+ * waiting for the address are transmitted.
+ *
+ * @param nc   Neighbour cache
+ * @param addr Network address
+ * @param mac  Link-layer address
+ * @return EOK on success, ENOMEM if out of memory
+ */
+errno_t ncache_add(ncache_t *nc, inet_addr_t *addr, addr48_t mac)
+{
+	ncache_entry_t *entry;
+	ncache_pkt_t *npkt;
+	list_t xpkts;
+	link_t *link;
+
+	list_initialize(&xpkts);
+
+	fibril_mutex_lock(&nc->lock);
+
+	entry = ncache_find(nc, addr);
+	if (entry == NULL) {
+		entry = ncache_entry_create(nc, addr);
+		if (entry == NULL) {
+			fibril_mutex_unlock(&nc->lock);
+			return ENOMEM;
+		}
+	}
+
+	entry->state = ncs_reachable;
+	addr48(mac, entry->mac);
+	entry->ttl = NCACHE_REACHABLE_TTL;
+	entry->nsolicit = 0;
+	ncache_entry_take_pkts(entry, &xpkts);
+
+	fibril_mutex_unlock(&nc->lock);
+
+	while ((link = list_first(&xpkts)) != NULL) {
+		npkt = list_get_instance(link, ncache_pkt_t, lpkts);
+		list_remove(link);
+		nc->ops->xmit(nc->arg, npkt->pkt, mac);
+		free(npkt);
+	}
+
+	return EOK;
+}
+
+/** Remove translation.
+ *
+ * @param nc   Neighbour cache
+ * @param addr Network address
+ * @return EOK on success, ENOENT if there is no entry for @a addr
+ */
+errno_t ncache_remove(ncache_t *nc, inet_addr_t *addr)
+{
+	ncache_entry_t *entry;
+	list_t dpkts;
+
+	list_initialize(&dpkts);
+
+	fibril_mutex_lock(&nc->lock);
+
+	entry = ncache_find(nc, addr);
+	if (entry == NULL) {
+		fibril_mutex_unlock(&nc->lock);
+		return ENOENT;
+	}
+
+	ncache_entry_take_pkts(entry, &dpkts);
+	hash_table_remove_item(&nc->entries, &entry->lentries);
+	free(entry);
+
+	fibril_mutex_unlock(&nc->lock);
+
+	ncache_discard_pkts(nc, &dpkts);
+	return EOK;
+}
+
+/** Resolve network address to link-layer address.
+ *
+ * If the address is not resolved yet, @a pkt is queued and sent via
+ * the @c xmit callback once the address is known, or passed to the
+ * @c discard callback if resolution fails. With @a pkt set to @c NULL
+ * the function only checks the cache, which allows callers to defer
+ * copying the packet until it actually needs to be queued.
+ *
+ * @param nc   Neighbour cache
+ * @param src  Source address to use in solicitations
+ * @param addr Network address to resolve
+ * @param pkt  Packet to queue or @c NULL
+ * @param mac  Place to store link-layer address
+ *
+ * @return EOK if @a mac was filled in (@a pkt is not consumed),
+ *         EINPROGRESS if @a pkt was queued,
+ *         EAGAIN if @a pkt is @c NULL and the address is not resolved,
+ *         ENOENT if resolution failed recently (@a pkt is not consumed),
+ *         ENOMEM if out of memory (@a pkt is not consumed)
+ */
+errno_t ncache_resolve(ncache_t *nc, inet_addr_t *src, inet_addr_t *addr,
+    void *pkt, addr48_t mac)
+{
+	ncache_entry_t *entry;
+	ncache_pkt_t *npkt;
+	ncache_pkt_t *dpkt;
+	bool solicit;
+
+	fibril_mutex_lock(&nc->lock);
+
+	entry = ncache_find(nc, addr);
+	if (entry != NULL && entry->state == ncs_reachable) {
+		addr48(entry->mac, mac);
+		nc->stats.hits++;
+		fibril_mutex_unlock(&nc->lock);
+		return EOK;
+	}
+
+	if (entry != NULL && entry->state == ncs_failed) {
+		nc->stats.neg_hits++;
+		fibril_mutex_unlock(&nc->lock);
+		return ENOENT;
+	}
+
+	if (pkt == NULL) {
+		fibril_mutex_unlock(&nc->lock);
+		return EAGAIN;
+	}
+
+	npkt = calloc(1, sizeof(ncache_pkt_t));
+	if (npkt == NULL) {
+		fibril_mutex_unlock(&nc->lock);
+		return ENOMEM;
+	}
+
+	npkt->pkt = pkt;
+
+	solicit = false;
+	if (entry == NULL) {
+		entry = ncache_entry_create(nc, addr);
+		if (entry == NULL) {
+			fibril_mutex_unlock(&nc->lock);
+			free(npkt);
+			return ENOMEM;
+		}
+
+		entry->state = ncs_incomplete;
+		entry->src = *src;
+		entry->nsolicit = 1;
+		nc->stats.misses++;
+		nc->stats.solicits++;
+		solicit = true;
+	}
+
+	dpkt = NULL;
+	if (entry->npkts >= NCACHE_QUEUE_MAX) {
+		/* Drop the oldest packet */
+		dpkt = list_get_instance(list_first(&entry->pkts),
+		    ncache_pkt_t, lpkts);
+		list_remove(&dpkt->lpkts);
+		entry->npkts--;
+		nc->stats.dropped++;
+	}
+
+	list_append(&npkt->lpkts, &entry->pkts);
+	entry->npkts++;
+	nc->stats.queued++;
+
+	fibril_mutex_unlock(&nc->lock);
+
+	if (dpkt != NULL) {
+		nc->ops->discard(nc->arg, dpkt->pkt);
+		free(dpkt);
+	}
+
+	if (solicit)
+		(void) nc->ops->solicit(nc->arg, src, addr);
+
+	return EINPROGRESS;
+}
+
+/** Age one neighbour cache entry.
+ *
+ * Schedule retransmission of solicitations for unresolved entries, turn
+ * them into negative entries when there is no answer and remove expired
+ * entries.
+ *
+ * @param item Hash table link of the entry
+ * @param arg  Aging context (ncache_age_t)
+ * @return @c true to continue with the next entry
+ */
+static bool ncache_age_entry(ht_link_t *item, void *arg)
+{
+	ncache_age_t *age = (ncache_age_t *) arg;
+	ncache_t *nc = age->nc;
+	ncache_entry_t *entry = hash_table_get_inst(item, ncache_entry_t,
+	    lentries);
+	ncache_sol_t *sol;
+
+	switch (entry->state) {
+	case ncs_incomplete:
+		if (entry->nsolicit < NCACHE_SOLICIT_MAX) {
+			/* If out of memory, try again on the next tick */
+			sol = calloc(1, sizeof(ncache_sol_t));
+			if (sol == NULL)
+				break;
+
+			sol->src = entry->src;
+			sol->addr = entry->addr;
+			list_append(&sol->lsols, age->sols);
+
+			entry->nsolicit++;
+			nc->stats.solicits++;
+		} else {
+			nc->stats.dropped += entry->npkts;
+			ncache_entry_take_pkts(entry, age->dpkts);
+			entry->state = ncs_failed;
+			entry->ttl = NCACHE_FAILED_TTL;
+		}
+		break;
+	case ncs_reachable:
+	case ncs_failed:
+		if (--entry->ttl == 0) {
+			nc->stats.expired++;
+			hash_table_remove_item(&nc->entries, item);
+			free(entry);
+		}
+		break;
+	}
+
+	return true;
+}
+
+/** Age neighbour cache by one tick.
+ *
+ * Called periodically by the aging timer. Solicitations and discarding
+ * of packets are done after the cache is unlocked, as in
+ * ncache_resolve().
+ *
+ * @param nc Neighbour cache
+ */
+void ncache_age(ncache_t *nc)
+{
+	ncache_age_t age;
+	ncache_sol_t *sol;
+	list_t dpkts;
+	list_t sols;
+	link_t *link;
+
+	list_initialize(&dpkts);
+	list_initialize(&sols);
+	age.nc = nc;
+	age.dpkts = &dpkts;
+	age.sols = &sols;
+
+	fibril_mutex_lock(&nc->lock);
+	hash_table_apply(&nc->entries, ncache_age_entry, &age);
+	fibril_mutex_unlock(&nc->lock);
+
+	while ((link = list_first(&sols)) != NULL) {
+		sol = list_get_instance(link, ncache_sol_t, lsols);
+		list_remove(link);
+		(void) nc->ops->solicit(nc->arg, &sol->src, &sol->addr);
+		free(sol);
+	}
+
+	ncache_discard_pkts(nc, &dpkts);
+}
+
+/** Neighbour cache aging timer function.
+ *
+ * @param arg Neighbour cache
+ */
+static void ncache_timer_fun(void *arg)
+{
+	ncache_t *nc = (ncache_t *) arg;
+
+	ncache_age(nc);
+
+	fibril_mutex_lock(&nc->lock);
+	fibril_timer_set_locked(nc->timer, NCACHE_TICK, ncache_timer_fun, nc);
+	fibril_mutex_unlock(&nc->lock);
+}
+
+/** Get neighbour cache statistics.
+ *
+ * @param nc     Neighbour cache
+ * @param stats  Place to store statistics
+ */
+void ncache_get_stats(ncache_t *nc, inet_nstats_t *stats)
+{
+	fibril_mutex_lock(&nc->lock);
+	*stats = nc->stats;
+	stats->entries = hash_table_size(&nc->entries);
+	fibril_mutex_unlock(&nc->lock);
+}
+
+/** @}
+ */
@@ -36,7 +36,8 @@
  * Allocates port numbers from IETF port number ranges.
  */
 
-#include <adt/list.h>
+#include <adt/odict.h>
+#include <assert.h>
 #include <errno.h>
 #include <inet/endpoint.h>
 #include <nettl/portrng.h>
@@ -45,6 +46,41 @@
 
 #include <io/log.h>
 
+/** Define to log port range operations (slow) */
+#undef PORTRNG_DEBUG
+
+#ifdef PORTRNG_DEBUG
+#define portrng_debug(...) log_msg(LOG_DEFAULT, LVL_DEBUG2, __VA_ARGS__)
+#else
+#define portrng_debug(...) ((void) 0)
+#endif
+
+/** Get key of allocated port.
+ *
+ * @param odlink Link to portrng_t.used
+ * @return Pointer to port number
+ */
+static void *portrng_port_getkey(odlink_t *odlink)
+{
+	portrng_port_t *port = odict_get_instance(odlink, portrng_port_t,
+	    lprng);
+	return &port->pn;
+}
+
+/** Compare port numbers.
+ *
+ * @param a Pointer to first port number
+ * @param b Pointer to second port number
+ * @return <0, 0, >0 if @a a is less than, equal to, greater than @a b
+ */
+static int portrng_port_cmp(void *a, void *b)
+{
+	uint16_t pa = *(uint16_t *) a;
+	uint16_t pb = *(uint16_t *) b;
+
+	return (int) pa - (int) pb;
+}
+
 /** Create port range.
  *
  * @param rpr Place to store pointer to new port range
@@ -54,15 +90,16 @@ errno_t portrng_create(portrng_t **rpr)
 {
 	portrng_t *pr;
 
-	log_msg(LOG_DEFAULT, LVL_DEBUG2, "portrng_create() - begin");
+	portrng_debug("portrng_create() - begin");
 
 	pr = calloc(1, sizeof(portrng_t));
 	if (pr == NULL)
 		return ENOMEM;
 
-	list_initialize(&pr->used);
+	odict_initialize(&pr->used, portrng_port_getkey, portrng_port_cmp);
+	pr->dyn_next = inet_port_dyn_lo;
 	*rpr = pr;
-	log_msg(LOG_DEFAULT, LVL_DEBUG2, "portrng_create() - end");
+	portrng_debug("portrng_create() - end");
 	return EOK;
 }
 
@@ -72,12 +109,67 @@ errno_t portrng_create(portrng_t **rpr)
  */
 void portrng_destroy(portrng_t *pr)
 {
-	log_msg(LOG_DEFAULT, LVL_DEBUG2, "portrng_destroy()");
-	assert(list_empty(&pr->used));
+	portrng_debug("portrng_destroy()");
+	assert(odict_empty(&pr->used));
+	odict_finalize(&pr->used);
 	free(pr);
 }
 
+/** Find allocated port.
+ *
+ * @param pr   Port range
+ * @param pnum Port number
+ * @return Port or @c NULL if @a pnum is not allocated
+ */
+static portrng_port_t *portrng_port_find(portrng_t *pr, uint16_t pnum)
+{
+	odlink_t *link;
+
+	link = odict_find_eq(&pr->used, &pnum, NULL);
+	if (link == NULL)
+		return NULL;
+
+	return odict_get_instance(link, portrng_port_t, lprng);
+}
+
+/** Find lowest free port number in an interval.
+ *
+ * @param pr  Port range
+ * @param lo  Lowest port number to consider
+ * @param hi  Highest port number to consider
+ * @param rpn Place to store free port number
+ * @return @c true if a free port number was found
+ */
+static bool portrng_find_free(portrng_t *pr, uint16_t lo, uint16_t hi,
+    uint16_t *rpn)
+{
+	portrng_port_t *port;
+	odlink_t *link;
+	uint32_t pn;
+
+	/* Skip over the run of allocated ports starting at @a lo */
+	pn = lo;
+	link = odict_find_geq(&pr->used, &lo, NULL);
+	while (link != NULL && pn <= hi) {
+		port = odict_get_instance(link, portrng_port_t, lprng);
+		if (port->pn != pn)
+			break;
+
+		++pn;
+		link = odict_next(link, &pr->used);
+	}
+
+	if (pn > hi)
+		return false;
+
+	*rpn = pn;
+	return true;
+}
+
 /** Allocate port number from port range.
+ *
+ * Dynamic port numbers are allocated in turn, starting after the one
+ * allocated last.
  *
  * @param pr    Port range
  * @param pnum  Port number to allocate specific port, or zero to allocate
@@ -96,48 +188,39 @@ errno_t portrng_alloc(portrng_t *pr, uint16_t pnum, void *arg,
     portrng_flags_t flags, uint16_t *apnum)
 {
 	portrng_port_t *p;
-	uint32_t i;
 	bool found;
 
-	log_msg(LOG_DEFAULT, LVL_DEBUG2, "portrng_alloc() - begin");
+	portrng_debug("portrng_alloc() - begin");
 
 	if (pnum == inet_port_any) {
-
-		for (i = inet_port_dyn_lo; i <= inet_port_dyn_hi; i++) {
-			log_msg(LOG_DEFAULT, LVL_DEBUG2, "trying %" PRIu32, i);
-			found = false;
-			list_foreach(pr->used, lprng, portrng_port_t, port) {
-				if (port->pn == pnum) {
-					found = true;
-					break;
-				}
-			}
-
-			if (!found) {
-				pnum = i;
-				break;
-			}
+		/* Continue after the last allocated port, then wrap around */
+		found = portrng_find_free(pr, pr->dyn_next, inet_port_dyn_hi,
+		    &pnum);
+		if (!found && pr->dyn_next > inet_port_dyn_lo) {
+			found = portrng_find_free(pr, inet_port_dyn_lo,
+			    pr->dyn_next - 1, &pnum);
 		}
 
-		if (pnum == inet_port_any) {
+		if (!found) {
 			/* No free port found */
 			return ENOENT;
 		}
-		log_msg(LOG_DEFAULT, LVL_DEBUG2, "selected %" PRIu16, pnum);
+
+		pr->dyn_next = (pnum < inet_port_dyn_hi) ? pnum + 1 :
+		    inet_port_dyn_lo;
+		portrng_debug("selected %" PRIu16, pnum);
 	} else {
-		log_msg(LOG_DEFAULT, LVL_DEBUG2, "user asked for %" PRIu16, pnum);
+		portrng_debug("user asked for %" PRIu16, pnum);
 
 		if ((flags & pf_allow_system) == 0 &&
 		    pnum < inet_port_user_lo) {
-			log_msg(LOG_DEFAULT, LVL_DEBUG2, "system port not allowed");
+			portrng_debug("system port not allowed");
 			return EINVAL;
 		}
 
-		list_foreach(pr->used, lprng, portrng_port_t, port) {
-			if (port->pn == pnum) {
-				log_msg(LOG_DEFAULT, LVL_DEBUG2, "port already used");
-				return EEXIST;
-			}
+		if (portrng_port_find(pr, pnum) != NULL) {
+			portrng_debug("port already used");
+			return EEXIST;
 		}
 	}
 
@@ -147,10 +230,9 @@ errno_t portrng_alloc(portrng_t *pr, uint16_t pnum, void *arg,
 
 	p->pn = pnum;
 	p->arg = arg;
-	list_append(&p->lprng, &pr->used);
+	odict_insert(&p->lprng, &pr->used, NULL);
 	*apnum = pnum;
-	log_msg(LOG_DEFAULT, LVL_DEBUG2, "portrng_alloc() - end OK pn=%" PRIu16,
-	    pnum);
+	portrng_debug("portrng_alloc() - end OK pn=%" PRIu16, pnum);
 	return EOK;
 }
 
@@ -164,14 +246,14 @@ errno_t portrng_alloc(portrng_t *pr, uint16_t pnum, void *arg,
  */
 errno_t portrng_find_port(portrng_t *pr, uint16_t pnum, void **rarg)
 {
-	list_foreach(pr->used, lprng, portrng_port_t, port) {
-		if (port->pn == pnum) {
-			*rarg = port->arg;
-			return EOK;
-		}
-	}
+	portrng_port_t *port;
 
-	return ENOENT;
+	port = portrng_port_find(pr, pnum);
+	if (port == NULL)
+		return ENOENT;
+
+	*rarg = port->arg;
+	return EOK;
 }
 
 /** Free port in port range.
@@ -181,21 +263,20 @@ errno_t portrng_find_port(portrng_t *pr, uint16_t pnum, void **rarg)
  */
 void portrng_free_port(portrng_t *pr, uint16_t pnum)
 {
-	log_msg(LOG_DEFAULT, LVL_DEBUG2, "portrng_free_port(%u)", pnum);
-	log_msg(LOG_DEFAULT, LVL_DEBUG2, "portrng_free_port() - begin");
-	list_foreach(pr->used, lprng, portrng_port_t, port) {
-		log_msg(LOG_DEFAULT, LVL_DEBUG2, "portrng_free_port - check port %u", port->pn);
-		if (port->pn == pnum) {
-			log_msg(LOG_DEFAULT, LVL_DEBUG2, "portrng_free_port - OK");
-			list_remove(&port->lprng);
-			free(port);
-			log_msg(LOG_DEFAULT, LVL_DEBUG2, "portrng_free_port() - end");
-			return;
-		}
+	portrng_port_t *port;
+
+	portrng_debug("portrng_free_port(%u)", pnum);
+
+	port = portrng_port_find(pr, pnum);
+	if (port == NULL) {
+		portrng_debug("portrng_free_port - FAIL");
+		assert(false);
+		return;
 	}
 
-	log_msg(LOG_DEFAULT, LVL_DEBUG2, "portrng_free_port - FAIL");
-	assert(false);
+	odict_remove(&port->lprng);
+	free(port);
+	portrng_debug("portrng_free_port() - end");
 }
 
 /** Determine if port range is empty.
@@ -205,8 +286,8 @@ void portrng_free_port(portrng_t *pr, uint16_t pnum)
  */
 bool portrng_empty(portrng_t *pr)
 {
-	log_msg(LOG_DEFAULT, LVL_DEBUG2, "portrng_empty()");
-	return list_empty(&pr->used);
+	portrng_debug("portrng_empty()");
+	return odict_empty(&pr->used);
 }
 
 /**
@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2018 Jaroslav Jindrak
+ * Copyright (c) 2019 Jiri Svoboda
  * All rights reserved.
  *
  * Redistribution and use in source and binary forms, with or without
@@ -26,9 +26,10 @@
  * THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
  */
 
-#ifndef LIBCPP_BITS_REGEX
-#define LIBCPP_BITS_REGEX
+#include <pcut/pcut.h>
 
-#error "<regex> is not implemented"
+PCUT_INIT;
 
-#endif
+PCUT_IMPORT(ncache);
+
+PCUT_MAIN();
@@ -0,0 +1,333 @@
+/*
+ * Copyright (c) 2019 Jiri Svoboda
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * - Redistributions of source code must retain the above copyright
+ *   notice, this list of conditions and the following disclaimer.
+ * - Redistributions in binary form must reproduce the above copyright
+ *   notice, this list of conditions and the following disclaimer in the
+ *   documentation and/or other materials provided with the distribution.
+ * - The name of the author may not be used to endorse or promote products
+ *   derived from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHOR ``AS IS'' AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+ * OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+ * IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT
+ * NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF
+ * THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <errno.h>
+#include <inet/addr.h>
+#include <mem.h>
+#include <nettl/ncache.h>
+#include <pcut/pcut.h>
+#include <stdbool.h>
+
+PCUT_INIT;
+
+PCUT_TEST_SUITE(ncache);
+
+enum {
+	/** Number of solicitations before resolution fails (NCACHE_SOLICIT_MAX) */
+	test_solicit_max = 3,
+	/** Lifetime of a negative entry in ticks (NCACHE_FAILED_TTL) */
+	test_failed_ttl = 20,
+	/** Lifetime of a resolved entry in ticks (NCACHE_REACHABLE_TTL) */
+	test_reachable_ttl = 300,
+	/** Packets queued per unresolved entry (NCACHE_QUEUE_MAX) */
+	test_queue_max = 8
+};
+
+static errno_t test_solicit(void *, inet_addr_t *, inet_addr_t *);
+static void test_xmit(void *, void *, addr48_t);
+static void test_discard(void *, void *);
+
+static ncache_ops_t test_ops = {
+	.solicit = test_solicit,
+	.xmit = test_xmit,
+	.discard = test_discard
+};
+
+/** Recorded callback activity */
+typedef struct {
+	/** Neighbour cache */
+	ncache_t *nc;
+	/** Number of solicitations */
+	int nsolicit;
+	/** A callback was called with the cache locked */
+	bool locked;
+	/** Number of transmitted packets */
+	int nxmit;
+	/** Last transmitted packet */
+	void *xmit_pkt;
+	/** Link-layer address of last transmitted packet */
+	addr48_t xmit_mac;
+	/** Number of discarded packets */
+	int ndiscard;
+	/** Last discarded packet */
+	void *discard_pkt;
+} test_resp_t;
+
+static addr48_t test_mac = { 0x00, 0x11, 0x22, 0x33, 0x44, 0x55 };
+
+/** Create and destroy neighbour cache */
+PCUT_TEST(create_destroy)
+{
+	ncache_t *nc;
+	errno_t rc;
+
+	rc = ncache_create(&test_ops, NULL, &nc);
+	PCUT_ASSERT_ERRNO_VAL(EOK, rc);
+
+	ncache_destroy(nc);
+}
+
+/** Queued packet is transmitted once the address is resolved */
+PCUT_TEST(resolve)
+{
+	test_resp_t resp;
+	inet_addr_t src;
+	inet_addr_t addr;
+	inet_nstats_t stats;
+	addr48_t mac;
+	int pkt;
+	errno_t rc;
+
+	memset(&resp, 0, sizeof(resp));
+	inet_addr(&src, 192, 168, 0, 1);
+	inet_addr(&addr, 192, 168, 0, 2);
+
+	rc = ncache_create(&test_ops, &resp, &resp.nc);
+	PCUT_ASSERT_ERRNO_VAL(EOK, rc);
+
+	rc = ncache_resolve(resp.nc, &src, &addr, NULL, mac);
+	PCUT_ASSERT_ERRNO_VAL(EAGAIN, rc);
+	PCUT_ASSERT_INT_EQUALS(0, resp.nsolicit);
+
+	rc = ncache_resolve(resp.nc, &src, &addr, &pkt, mac);
+	PCUT_ASSERT_ERRNO_VAL(EINPROGRESS, rc);
+	PCUT_ASSERT_INT_EQUALS(1, resp.nsolicit);
+	PCUT_ASSERT_INT_EQUALS(0, resp.nxmit);
+
+	rc = ncache_add(resp.nc, &addr, test_mac);
+	PCUT_ASSERT_ERRNO_VAL(EOK, rc);
+	PCUT_ASSERT_INT_EQUALS(1, resp.nxmit);
+	PCUT_ASSERT_EQUALS(&pkt, resp.xmit_pkt);
+	PCUT_ASSERT_TRUE(addr48_compare(test_mac, resp.xmit_mac));
+
+	rc = ncache_resolve(resp.nc, &src, &addr, &pkt, mac);
+	PCUT_ASSERT_ERRNO_VAL(EOK, rc);
+	PCUT_ASSERT_TRUE(addr48_compare(test_mac, mac));
+	PCUT_ASSERT_INT_EQUALS(1, resp.nxmit);
+
+	ncache_get_stats(resp.nc, &stats);
+	PCUT_ASSERT_INT_EQUALS(1, stats.entries);
+	PCUT_ASSERT_INT_EQUALS(1, stats.hits);
+	PCUT_ASSERT_INT_EQUALS(1, stats.misses);
+	PCUT_ASSERT_INT_EQUALS(1, stats.queued);
+	PCUT_ASSERT_INT_EQUALS(1, stats.solicits);
+	PCUT_ASSERT_INT_EQUALS(0, stats.dropped);
+
+	PCUT_ASSERT_FALSE(resp.locked);
+	ncache_destroy(resp.nc);
+}
+
+/** Solicitations are retransmitted up to the limit, then resolution fails */
+PCUT_TEST(solicit_limit)
+{
+	test_resp_t resp;
+	inet_addr_t src;
+	inet_addr_t addr;
+	inet_nstats_t stats;
+	addr48_t mac;
+	int pkt;
+	int i;
+	errno_t rc;
+
+	memset(&resp, 0, sizeof(resp));
+	inet_addr(&src, 192, 168, 0, 1);
+	inet_addr(&addr, 192, 168, 0, 2);
+
+	rc = ncache_create(&test_ops, &resp, &resp.nc);
+	PCUT_ASSERT_ERRNO_VAL(EOK, rc);
+
+	rc = ncache_resolve(resp.nc, &src, &addr, &pkt, mac);
+	PCUT_ASSERT_ERRNO_VAL(EINPROGRESS, rc);
+
+	for (i = 1; i < test_solicit_max; i++) {
+		ncache_age(resp.nc);
+		PCUT_ASSERT_INT_EQUALS(i + 1, resp.nsolicit);
+		PCUT_ASSERT_INT_EQUALS(0, resp.ndiscard);
+	}
+
+	/* No more solicitations, the queued packet is discarded */
+	ncache_age(resp.nc);
+	PCUT_ASSERT_INT_EQUALS(test_solicit_max, resp.nsolicit);
+	PCUT_ASSERT_INT_EQUALS(1, resp.ndiscard);
+	PCUT_ASSERT_EQUALS(&pkt, resp.discard_pkt);
+
+	/* Negative entry answers right away */
+	rc = ncache_resolve(resp.nc, &src, &addr, &pkt, mac);
+	PCUT_ASSERT_ERRNO_VAL(ENOENT, rc);
+	PCUT_ASSERT_INT_EQUALS(test_solicit_max, resp.nsolicit);
+
+	ncache_get_stats(resp.nc, &stats);
+	PCUT_ASSERT_INT_EQUALS(test_solicit_max, stats.solicits);
+	PCUT_ASSERT_INT_EQUALS(1, stats.dropped);
+	PCUT_ASSERT_INT_EQUALS(1, stats.neg_hits);
+
+	PCUT_ASSERT_FALSE(resp.locked);
+	ncache_destroy(resp.nc);
+}
+
+/** Negative and resolved entries expire */
+PCUT_TEST(expiry)
+{
+	test_resp_t resp;
+	inet_addr_t src;
+	inet_addr_t addr;
+	inet_addr_t addr2;
+	inet_nstats_t stats;
+	addr48_t mac;
+	int pkt;
+	int i;
+	errno_t rc;
+
+	memset(&resp, 0, sizeof(resp));
+	inet_addr(&src, 192, 168, 0, 1);
+	inet_addr(&addr, 192, 168, 0, 2);
+	inet_addr(&addr2, 192, 168, 0, 3);
+
+	rc = ncache_create(&test_ops, &resp, &resp.nc);
+	PCUT_ASSERT_ERRNO_VAL(EOK, rc);
+
+	rc = ncache_add(resp.nc, &addr2, test_mac);
+	PCUT_ASSERT_ERRNO_VAL(EOK, rc);
+
+	rc = ncache_resolve(resp.nc, &src, &addr, &pkt, mac);
+	PCUT_ASSERT_ERRNO_VAL(EINPROGRESS, rc);
+
+	for (i = 0; i < test_solicit_max; i++)
+		ncache_age(resp.nc);
+
+	rc = ncache_resolve(resp.nc, &src, &addr, NULL, mac);
+	PCUT_ASSERT_ERRNO_VAL(ENOENT, rc);
+
+	for (i = 0; i < test_failed_ttl; i++)
+		ncache_age(resp.nc);
+
+	/* Negative entry is gone, resolution starts over */
+	ncache_get_stats(resp.nc, &stats);
+	PCUT_ASSERT_INT_EQUALS(1, stats.entries);
+	PCUT_ASSERT_INT_EQUALS(1, stats.expired);
+
+	rc = ncache_resolve(resp.nc, &src, &addr, &pkt, mac);
+	PCUT_ASSERT_ERRNO_VAL(EINPROGRESS, rc);
+	PCUT_ASSERT_INT_EQUALS(test_solicit_max + 1, resp.nsolicit);
+
+	rc = ncache_remove(resp.nc, &addr);
+	PCUT_ASSERT_ERRNO_VAL(EOK, rc);
+	PCUT_ASSERT_INT_EQUALS(2, resp.ndiscard);
+
+	/* Resolved entry expires as well */
+	for (i = test_solicit_max + test_failed_ttl; i < test_reachable_ttl;
+	    i++) {
+		ncache_age(resp.nc);
+	}
+
+	rc = ncache_resolve(resp.nc, &src, &addr2, NULL, mac);
+	PCUT_ASSERT_ERRNO_VAL(EAGAIN, rc);
+
+	ncache_get_stats(resp.nc, &stats);
+	PCUT_ASSERT_INT_EQUALS(0, stats.entries);
+	PCUT_ASSERT_INT_EQUALS(2, stats.expired);
+
+	PCUT_ASSERT_FALSE(resp.locked);
+	ncache_destroy(resp.nc);
+}
+
+/** Oldest packet is dropped when the queue of an entry overflows */
+PCUT_TEST(queue_overflow)
+{
+	test_resp_t resp;
+	inet_addr_t src;
+	inet_addr_t addr;
+	inet_nstats_t stats;
+	addr48_t mac;
+	int pkts[test_queue_max + 1];
+	int i;
+	errno_t rc;
+
+	memset(&resp, 0, sizeof(resp));
+	inet_addr(&src, 192, 168, 0, 1);
+	inet_addr(&addr, 192, 168, 0, 2);
+
+	rc = ncache_create(&test_ops, &resp, &resp.nc);
+	PCUT_ASSERT_ERRNO_VAL(EOK, rc);
+
+	for (i = 0; i < test_queue_max + 1; i++) {
+		rc = ncache_resolve(resp.nc, &src, &addr, &pkts[i], mac);
+		PCUT_ASSERT_ERRNO_VAL(EINPROGRESS, rc);
+	}
+
+	PCUT_ASSERT_INT_EQUALS(1, resp.nsolicit);
+	PCUT_ASSERT_INT_EQUALS(1, resp.ndiscard);
+	PCUT_ASSERT_EQUALS(&pkts[0], resp.discard_pkt);
+
+	rc = ncache_add(resp.nc, &addr, test_mac);
+	PCUT_ASSERT_ERRNO_VAL(EOK, rc);
+	PCUT_ASSERT_INT_EQUALS(test_queue_max, resp.nxmit);
+	PCUT_ASSERT_EQUALS(&pkts[test_queue_max], resp.xmit_pkt);
+
+	ncache_get_stats(resp.nc, &stats);
+	PCUT_ASSERT_INT_EQUALS(test_queue_max + 1, stats.queued);
+	PCUT_ASSERT_INT_EQUALS(1, stats.dropped);
+
+	ncache_destroy(resp.nc);
+}
+
+static errno_t test_solicit(void *arg, inet_addr_t *src, inet_addr_t *addr)
+{
+	test_resp_t *resp = (test_resp_t *) arg;
+
+	if (fibril_mutex_is_locked(&resp->nc->lock))
+		resp->locked = true;
+
+	resp->nsolicit++;
+	return EOK;
+}
+
+static void test_xmit(void *arg, void *pkt, addr48_t mac)
+{
+	test_resp_t *resp = (test_resp_t *) arg;
+
+	if (fibril_mutex_is_locked(&resp->nc->lock))
+		resp->locked = true;
+
+	resp->nxmit++;
+	resp->xmit_pkt = pkt;
+	addr48(mac, resp->xmit_mac);
+}
+
+static void test_discard(void *arg, void *pkt)
+{
+	test_resp_t *resp = (test_resp_t *) arg;
+
+	if (resp->nc != NULL && fibril_mutex_is_locked(&resp->nc->lock))
+		resp->locked = true;
+
+	resp->ndiscard++;
+	resp->discard_pkt = pkt;
+}
+
+PCUT_EXPORT(ncache);
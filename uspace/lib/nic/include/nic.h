@@ -43,6 +43,7 @@
 #include <ddf/driver.h>
 #include <device/hw_res_parsed.h>
 #include <ops/nic.h>
+#include <time.h>
 
 #define DEVICE_CATEGORY_NIC "nic"
 
@@ -68,6 +69,8 @@ typedef struct {
 	link_t link;
 	void *data;
 	size_t size;
+	/** Time when the frame was queued for delivery to the client */
+	struct timespec ts;
 } nic_frame_t;
 
 typedef list_t nic_frame_list_t;
@@ -84,6 +87,19 @@ typedef list_t nic_frame_list_t;
  */
 typedef void (*send_frame_handler)(nic_t *, void *, size_t);
 
+/**
+ * Handler for sending a frame with a partial transport-layer checksum
+ * which the NIC is to complete (see NIC_OFFLOAD_TX_CSUM).
+ *
+ * @param nic_data
+ * @param data		Pointer to frame data
+ * @param size		Size of frame data in bytes
+ * @param csum_start	Offset where checksumming starts
+ * @param csum_offs	Offset of checksum field relative to @a csum_start
+ */
+typedef void (*send_frame_csum_handler)(nic_t *, void *, size_t, size_t,
+    size_t);
+
 /**
  * The handler for transitions between driver states.
  * If the handler returns error code, the transition between
@@ -218,6 +234,7 @@ extern void nic_driver_implement(driver_ops_t *, ddf_dev_ops_t *,
 extern errno_t nic_get_resources(nic_t *, hw_res_list_parsed_t *);
 extern void nic_set_specific(nic_t *, void *);
 extern void nic_set_send_frame_handler(nic_t *, send_frame_handler);
+extern void nic_set_send_frame_csum_handler(nic_t *, send_frame_csum_handler);
 extern void nic_set_state_change_handlers(nic_t *,
     state_change_handler, state_change_handler, state_change_handler);
 extern void nic_set_filtering_change_handlers(nic_t *,
@@ -240,6 +257,7 @@ extern nic_device_state_t nic_query_state(nic_t *);
 extern void nic_set_tx_busy(nic_t *, int);
 extern errno_t nic_report_address(nic_t *, const nic_address_t *);
 extern errno_t nic_report_poll_mode(nic_t *, nic_poll_mode_t, struct timespec *);
+extern void nic_report_offload(nic_t *, uint32_t);
 extern void nic_query_address(nic_t *, nic_address_t *);
 extern void nic_received_frame(nic_t *, nic_frame_t *);
 extern void nic_received_frame_list(nic_t *, nic_frame_list_t *);
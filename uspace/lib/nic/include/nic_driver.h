@@ -126,6 +126,16 @@ struct nic {
 	 * Called with the main_lock locked for reading.
 	 */
 	send_frame_handler send_frame;
+	/**
+	 * Function sending a frame with a partial checksum to be completed
+	 * by the hardware. Optional, called with the main_lock locked for
+	 * reading and only if NIC_OFFLOAD_TX_CSUM is active.
+	 */
+	send_frame_csum_handler send_frame_csum;
+	/** Offload computations supported by the hardware (NIC_OFFLOAD_*) */
+	uint32_t offload_supported;
+	/** Offload computations currently enabled (NIC_OFFLOAD_*) */
+	uint32_t offload_active;
 	/**
 	 * Event handler called when device goes to the ACTIVE state.
 	 * The implementation is optional.
@@ -194,6 +204,20 @@ struct nic {
 	 * The implementation is optional.
 	 */
 	poll_request_handler on_poll_request;
+	/** Frames waiting for delivery to the client (nic_frame_t) */
+	list_t rx_queue;
+	/** Number of frames in @c rx_queue */
+	size_t rx_queue_len;
+	/** Protects @c rx_queue, @c rx_queue_len, @c rx_stop and @c rx_running */
+	fibril_mutex_t rx_lock;
+	/** Signalled when a frame is added to @c rx_queue or the fibril stops */
+	fibril_condvar_t rx_cv;
+	/** Fibril delivering received frames to the client */
+	fid_t rx_fibril;
+	/** The delivery fibril has been asked to stop */
+	bool rx_stop;
+	/** The delivery fibril has not stopped yet */
+	bool rx_running;
 	/** Data specific for particular driver */
 	void *specific;
 };
@@ -41,10 +41,12 @@
 #include <async.h>
 #include <nic/nic.h>
 #include <stddef.h>
+#include "nic.h"
 
 extern errno_t nic_ev_addr_changed(async_sess_t *, const nic_address_t *);
 extern errno_t nic_ev_device_state(async_sess_t *, sysarg_t);
 extern errno_t nic_ev_received(async_sess_t *, void *, size_t);
+extern errno_t nic_ev_received_batch(async_sess_t *, nic_frame_t **, size_t);
 
 #endif
 
@@ -49,6 +49,8 @@
 
 extern errno_t nic_get_address_impl(ddf_fun_t *dev_fun, nic_address_t *address);
 extern errno_t nic_send_frame_impl(ddf_fun_t *dev_fun, void *data, size_t size);
+extern errno_t nic_send_frame_csum_impl(ddf_fun_t *dev_fun, void *data,
+    size_t size, size_t csum_start, size_t csum_offs);
 extern errno_t nic_callback_create_impl(ddf_fun_t *dev_fun);
 extern errno_t nic_get_state_impl(ddf_fun_t *dev_fun, nic_device_state_t *state);
 extern errno_t nic_set_state_impl(ddf_fun_t *dev_fun, nic_device_state_t state);
@@ -76,6 +78,8 @@ extern errno_t nic_wol_virtue_probe_impl(ddf_fun_t *dev_fun, nic_wv_id_t id,
 extern errno_t nic_wol_virtue_list_impl(ddf_fun_t *dev_fun, nic_wv_type_t type,
     size_t max_count, nic_wv_id_t *id_list, size_t *id_count);
 extern errno_t nic_wol_virtue_get_caps_impl(ddf_fun_t *, nic_wv_type_t, int *);
+extern errno_t nic_offload_probe_impl(ddf_fun_t *, uint32_t *, uint32_t *);
+extern errno_t nic_offload_set_impl(ddf_fun_t *, uint32_t, uint32_t);
 extern errno_t nic_poll_get_mode_impl(ddf_fun_t *,
     nic_poll_mode_t *, struct timespec *);
 extern errno_t nic_poll_set_mode_impl(ddf_fun_t *,
@@ -45,7 +45,9 @@
 #include <as.h>
 #include <ddf/interrupt.h>
 #include <ops/nic.h>
+#include <nic_iface.h>
 #include <errno.h>
+#include <time.h>
 
 #include "nic_driver.h"
 #include "nic_ev.h"
@@ -53,6 +55,9 @@
 
 #define NIC_GLOBALS_MAX_CACHE_SIZE 16
 
+/** Maximum number of received frames waiting for delivery to the client */
+#define NIC_RX_QUEUE_MAX 256
+
 nic_globals_t nic_globals;
 
 /**
@@ -101,6 +106,8 @@ void nic_driver_implement(driver_ops_t *driver_ops, ddf_dev_ops_t *dev_ops,
 			iface->set_state = nic_set_state_impl;
 		if (!iface->send_frame)
 			iface->send_frame = nic_send_frame_impl;
+		if (!iface->send_frame_csum)
+			iface->send_frame_csum = nic_send_frame_csum_impl;
 		if (!iface->callback_create)
 			iface->callback_create = nic_callback_create_impl;
 		if (!iface->get_address)
@@ -137,6 +144,10 @@ void nic_driver_implement(driver_ops_t *driver_ops, ddf_dev_ops_t *dev_ops,
 			iface->wol_virtue_list = nic_wol_virtue_list_impl;
 		if (!iface->wol_virtue_get_caps)
 			iface->wol_virtue_get_caps = nic_wol_virtue_get_caps_impl;
+		if (!iface->offload_probe)
+			iface->offload_probe = nic_offload_probe_impl;
+		if (!iface->offload_set)
+			iface->offload_set = nic_offload_set_impl;
 		if (!iface->poll_get_mode)
 			iface->poll_get_mode = nic_poll_get_mode_impl;
 		if (!iface->poll_set_mode)
@@ -160,6 +171,20 @@ void nic_set_send_frame_handler(nic_t *nic_data, send_frame_handler sffunc)
 	nic_data->send_frame = sffunc;
 }
 
+/**
+ * Setup handler for sending frames with a partial checksum. Drivers able
+ * to complete transport-layer checksums in hardware call this together with
+ * nic_report_offload() in the add_device handler.
+ *
+ * @param nic_data
+ * @param sffunc	Function handling the send_frame_csum request
+ */
+void nic_set_send_frame_csum_handler(nic_t *nic_data,
+    send_frame_csum_handler sffunc)
+{
+	nic_data->send_frame_csum = sffunc;
+}
+
 /**
  * Setup event handlers for transitions between driver states.
  * This function can be called only in the add_device handler.
@@ -417,6 +442,23 @@ errno_t nic_report_poll_mode(nic_t *nic_data, nic_poll_mode_t mode,
 	return rc;
 }
 
+/** Inform the NICF about offload computations supported by the hardware.
+ *
+ * All of them are enabled initially, clients may switch them off with
+ * nic_offload_set(). This function can be called only in the add_device
+ * handler.
+ *
+ * @param nic_data  The controller data
+ * @param supported Supported offload computations (NIC_OFFLOAD_*)
+ */
+void nic_report_offload(nic_t *nic_data, uint32_t supported)
+{
+	fibril_rwlock_write_lock(&nic_data->main_lock);
+	nic_data->offload_supported = supported;
+	nic_data->offload_active = supported;
+	fibril_rwlock_write_unlock(&nic_data->main_lock);
+}
+
 /** Inform the NICF about device's MAC address.
  *
  * @return EOK On success
@@ -507,10 +549,150 @@ void nic_set_tx_busy(nic_t *nic_data, int busy)
 	nic_data->tx_busy = busy;
 }
 
+/** Deliver received frames to the client.
+ *
+ * Frames are taken from the receive queue and sent to the client in
+ * batches. While the client processes one batch, new frames accumulate in
+ * the queue and go out together with the next one. Under light load each
+ * frame is thus delivered on its own without delay, while under heavy load
+ * the batches grow (up to NIC_EV_RECEIVED_BATCH_MAX frames) and the cost of
+ * IPC is shared by more frames.
+ *
+ * The fibril runs until nic_rx_stop() is called, frames left in the queue
+ * at that time are released by nic_rx_stop().
+ *
+ * @param arg NIC data (nic_t *)
+ * @return EOK
+ */
+static errno_t nic_rx_fibril(void *arg)
+{
+	nic_t *nic_data = (nic_t *) arg;
+	nic_frame_t *batch[NIC_EV_RECEIVED_BATCH_MAX];
+	struct timespec now;
+	uint64_t qtime;
+	size_t count;
+	size_t i;
+
+	while (true) {
+		fibril_mutex_lock(&nic_data->rx_lock);
+		while (nic_data->rx_queue_len == 0 && !nic_data->rx_stop)
+			fibril_condvar_wait(&nic_data->rx_cv, &nic_data->rx_lock);
+
+		if (nic_data->rx_stop) {
+			nic_data->rx_running = false;
+			fibril_condvar_broadcast(&nic_data->rx_cv);
+			fibril_mutex_unlock(&nic_data->rx_lock);
+			break;
+		}
+
+		count = 0;
+		while (count < NIC_EV_RECEIVED_BATCH_MAX &&
+		    !list_empty(&nic_data->rx_queue)) {
+			link_t *link = list_first(&nic_data->rx_queue);
+			list_remove(link);
+			batch[count++] = list_get_instance(link, nic_frame_t,
+			    link);
+		}
+
+		nic_data->rx_queue_len -= count;
+		fibril_mutex_unlock(&nic_data->rx_lock);
+
+		getuptime(&now);
+		qtime = 0;
+		for (i = 0; i < count; i++)
+			qtime += NSEC2USEC(ts_sub_diff(&now, &batch[i]->ts));
+
+		if (count == 1) {
+			nic_ev_received(nic_data->client_session,
+			    batch[0]->data, batch[0]->size);
+		} else {
+			nic_ev_received_batch(nic_data->client_session,
+			    batch, count);
+		}
+
+		fibril_rwlock_write_lock(&nic_data->stats_lock);
+		nic_data->stats.receive_batches++;
+		nic_data->stats.receive_queue_usec += qtime;
+		fibril_rwlock_write_unlock(&nic_data->stats_lock);
+
+		for (i = 0; i < count; i++)
+			nic_release_frame(nic_data, batch[i]);
+	}
+
+	return EOK;
+}
+
+/** Queue received frame for delivery to the client.
+ *
+ * @param nic_data NIC data
+ * @param frame    Received frame, ownership is transferred
+ */
+static void nic_rx_enqueue(nic_t *nic_data, nic_frame_t *frame)
+{
+	if (nic_data->rx_fibril == 0) {
+		/* No delivery fibril, deliver immediately */
+		nic_ev_received(nic_data->client_session, frame->data,
+		    frame->size);
+		nic_release_frame(nic_data, frame);
+		return;
+	}
+
+	fibril_mutex_lock(&nic_data->rx_lock);
+	if (nic_data->rx_stop) {
+		/* The device is going away */
+		fibril_mutex_unlock(&nic_data->rx_lock);
+		nic_release_frame(nic_data, frame);
+		return;
+	}
+
+	if (nic_data->rx_queue_len >= NIC_RX_QUEUE_MAX) {
+		fibril_mutex_unlock(&nic_data->rx_lock);
+
+		fibril_rwlock_write_lock(&nic_data->stats_lock);
+		nic_data->stats.receive_dropped++;
+		fibril_rwlock_write_unlock(&nic_data->stats_lock);
+
+		nic_release_frame(nic_data, frame);
+		return;
+	}
+
+	getuptime(&frame->ts);
+	list_append(&frame->link, &nic_data->rx_queue);
+	nic_data->rx_queue_len++;
+	fibril_condvar_signal(&nic_data->rx_cv);
+	fibril_mutex_unlock(&nic_data->rx_lock);
+}
+
+/** Stop the delivery fibril and release frames not delivered yet.
+ *
+ * Waits until the fibril has finished delivering its current batch, so
+ * that it no longer touches the NIC data once this function returns.
+ *
+ * @param nic_data NIC data
+ */
+static void nic_rx_stop(nic_t *nic_data)
+{
+	fibril_mutex_lock(&nic_data->rx_lock);
+	nic_data->rx_stop = true;
+	fibril_condvar_broadcast(&nic_data->rx_cv);
+	while (nic_data->rx_running)
+		fibril_condvar_wait(&nic_data->rx_cv, &nic_data->rx_lock);
+
+	while (!list_empty(&nic_data->rx_queue)) {
+		link_t *link = list_first(&nic_data->rx_queue);
+		list_remove(link);
+		nic_release_frame(nic_data, list_get_instance(link,
+		    nic_frame_t, link));
+	}
+
+	nic_data->rx_queue_len = 0;
+	fibril_mutex_unlock(&nic_data->rx_lock);
+}
+
 /**
  * This is the function that the driver should call when it receives a frame.
- * The frame is checked by filters and then sent up to the NIL layer or
- * discarded. The frame is released.
+ * The frame is checked by filters and then queued for delivery to the NIL
+ * layer or discarded. The frame is released once it has been delivered.
  *
  * @param nic_data
  * @param frame		The received frame
@@ -543,8 +725,8 @@ void nic_received_frame(nic_t *nic_data, nic_frame_t *frame)
 			break;
 		}
 		fibril_rwlock_write_unlock(&nic_data->stats_lock);
-		nic_ev_received(nic_data->client_session, frame->data,
-		    frame->size);
+		nic_rx_enqueue(nic_data, frame);
+		return;
 	} else {
 		switch (frame_type) {
 		case NIC_FRAME_UNICAST:
@@ -612,6 +794,9 @@ static nic_t *nic_create(ddf_dev_t *dev)
 	nic_data->poll_mode = NIC_POLL_IMMEDIATE;
 	nic_data->default_poll_mode = NIC_POLL_IMMEDIATE;
 	nic_data->send_frame = NULL;
+	nic_data->send_frame_csum = NULL;
+	nic_data->offload_supported = 0;
+	nic_data->offload_active = 0;
 	nic_data->on_activating = NULL;
 	nic_data->on_going_down = NULL;
 	nic_data->on_stopping = NULL;
@@ -622,6 +807,20 @@ static nic_t *nic_create(ddf_dev_t *dev)
 	fibril_rwlock_initialize(&nic_data->rxc_lock);
 	fibril_rwlock_initialize(&nic_data->wv_lock);
 
+	list_initialize(&nic_data->rx_queue);
+	nic_data->rx_queue_len = 0;
+	fibril_mutex_initialize(&nic_data->rx_lock);
+	fibril_condvar_initialize(&nic_data->rx_cv);
+	nic_data->rx_stop = false;
+	nic_data->rx_running = false;
+
+	/* Without the delivery fibril frames are delivered one by one */
+	nic_data->rx_fibril = fibril_create(nic_rx_fibril, nic_data);
+	if (nic_data->rx_fibril != 0) {
+		nic_data->rx_running = true;
+		fibril_add_ready(nic_data->rx_fibril);
+	}
+
 	memset(&nic_data->mac, 0, sizeof(nic_address_t));
 	memset(&nic_data->default_mac, 0, sizeof(nic_address_t));
 	memset(&nic_data->stats, 0, sizeof(nic_device_stats_t));
@@ -658,6 +857,7 @@ nic_t *nic_create_and_bind(ddf_dev_t *device)
  */
 static void nic_destroy(nic_t *nic_data)
 {
+	nic_rx_stop(nic_data);
 	free(nic_data->specific);
 }
 
@@ -35,9 +35,12 @@
  * @brief
  */
 
+#include <assert.h>
 #include <async.h>
 #include <nic_iface.h>
 #include <errno.h>
+#include <mem.h>
+#include <stdlib.h>
 #include "nic_ev.h"
 
 /** Device address changed. */
@@ -93,5 +96,50 @@ errno_t nic_ev_received(async_sess_t *sess, void *data, size_t size)
 	return retval;
 }
 
+/** Batch of frames received.
+ *
+ * The frames are delivered by a single event. Frame sizes are transferred
+ * first, followed by one data write per frame in the same exchange, so
+ * that the frames need not be copied into a contiguous buffer.
+ *
+ * @param sess   Client session
+ * @param frames Array of frames
+ * @param count  Number of frames, at most NIC_EV_RECEIVED_BATCH_MAX
+ * @return EOK on success or an error code
+ */
+errno_t nic_ev_received_batch(async_sess_t *sess, nic_frame_t **frames,
+    size_t count)
+{
+	size_t sizes[NIC_EV_RECEIVED_BATCH_MAX];
+	size_t i;
+
+	assert(count > 0);
+	assert(count <= NIC_EV_RECEIVED_BATCH_MAX);
+
+	for (i = 0; i < count; i++)
+		sizes[i] = frames[i]->size;
+
+	async_exch_t *exch = async_exchange_begin(sess);
+
+	ipc_call_t answer;
+	aid_t req = async_send_1(exch, NIC_EV_RECEIVED_BATCH, count, &answer);
+	errno_t retval = async_data_write_start(exch, sizes,
+	    count * sizeof(size_t));
+	for (i = 0; i < count && retval == EOK; i++) {
+		retval = async_data_write_start(exch, frames[i]->data,
+		    sizes[i]);
+	}
+
+	async_exchange_end(exch);
+
+	if (retval != EOK) {
+		async_forget(req);
+		return retval;
+	}
+
+	async_wait_for(req, &retval);
+	return retval;
+}
+
 /** @}
  */
@@ -35,6 +35,7 @@
  * @brief Default DDF NIC interface methods implementations
  */
 
+#include <adt/checksum.h>
 #include <errno.h>
 #include <str_error.h>
 #include <ipc/services.h>
@@ -184,6 +185,76 @@ errno_t nic_send_frame_impl(ddf_fun_t *fun, void *data, size_t size)
 	return EOK;
 }
 
+/**
+ * Complete a partial transport-layer checksum in software.
+ *
+ * The checksum field holds the folded pseudo-header sum. The one's
+ * complement sum is taken from @a csum_start to the end of the frame
+ * and its complement is stored in the checksum field. A zero result
+ * is transmitted as 0xffff, which is equivalent for TCP and required
+ * for UDP.
+ *
+ * @param data		Frame data
+ * @param size		Frame size in bytes
+ * @param csum_start	Offset where checksumming starts
+ * @param csum_offs	Offset of checksum field relative to @a csum_start
+ */
+static void nic_csum_complete(uint8_t *data, size_t size, size_t csum_start,
+    size_t csum_offs)
+{
+	uint16_t csum;
+
+	csum = ~compute_ocsum(data + csum_start, size - csum_start, 0);
+	if (csum == 0)
+		csum = 0xffff;
+
+	data[csum_start + csum_offs] = csum >> 8;
+	data[csum_start + csum_offs + 1] = csum & 0xff;
+}
+
+/**
+ * Default implementation of the send_frame_csum method.
+ * Hands the frame to the hardware if it completes checksums (and the
+ * offload is enabled), otherwise completes the checksum in software.
+ *
+ * @param	fun
+ * @param	data		Frame data
+ * @param 	size		Frame size in bytes
+ * @param	csum_start	Offset where checksumming starts
+ * @param	csum_offs	Offset of checksum field relative to @a csum_start
+ *
+ * @return EOK		If the message was sent
+ * @return EINVAL	If the checksum field lies outside of the frame
+ * @return EBUSY	If the device is not in state when the frame can be sent.
+ */
+errno_t nic_send_frame_csum_impl(ddf_fun_t *fun, void *data, size_t size,
+    size_t csum_start, size_t csum_offs)
+{
+	nic_t *nic_data = nic_get_from_ddf_fun(fun);
+
+	if (csum_start > size || csum_offs > size - csum_start ||
+	    size - csum_start - csum_offs < sizeof(uint16_t))
+		return EINVAL;
+
+	fibril_rwlock_read_lock(&nic_data->main_lock);
+	if (nic_data->state != NIC_STATE_ACTIVE || nic_data->tx_busy) {
+		fibril_rwlock_read_unlock(&nic_data->main_lock);
+		return EBUSY;
+	}
+
+	if ((nic_data->offload_active & NIC_OFFLOAD_TX_CSUM) != 0 &&
+	    nic_data->send_frame_csum != NULL) {
+		nic_data->send_frame_csum(nic_data, data, size, csum_start,
+		    csum_offs);
+	} else {
+		nic_csum_complete(data, size, csum_start, csum_offs);
+		nic_data->send_frame(nic_data, data, size);
+	}
+
+	fibril_rwlock_read_unlock(&nic_data->main_lock);
+	return EOK;
+}
+
 /**
  * Default implementation of the connect_client method.
  * Creates callback connection to the client.
@@ -699,6 +770,53 @@ errno_t nic_wol_virtue_get_caps_impl(ddf_fun_t *fun, nic_wv_type_t type, int *co
 	return EOK;
 }
 
+/**
+ * Default implementation of the offload_probe method.
+ *
+ * @param		fun
+ * @param[out]	supported	Offload computations supported by the hardware
+ * @param[out]	active		Offload computations currently enabled
+ *
+ * @return EOK always.
+ */
+errno_t nic_offload_probe_impl(ddf_fun_t *fun, uint32_t *supported,
+    uint32_t *active)
+{
+	nic_t *nic_data = nic_get_from_ddf_fun(fun);
+
+	fibril_rwlock_read_lock(&nic_data->main_lock);
+	*supported = nic_data->offload_supported;
+	*active = nic_data->offload_active;
+	fibril_rwlock_read_unlock(&nic_data->main_lock);
+	return EOK;
+}
+
+/**
+ * Default implementation of the offload_set method.
+ *
+ * @param	fun
+ * @param	mask	Offload computations to change
+ * @param	active	New setting for the computations in @a mask
+ *
+ * @return EOK		If the setting was changed
+ * @return ENOTSUP	If enabling a computation the hardware does not support
+ */
+errno_t nic_offload_set_impl(ddf_fun_t *fun, uint32_t mask, uint32_t active)
+{
+	nic_t *nic_data = nic_get_from_ddf_fun(fun);
+
+	fibril_rwlock_write_lock(&nic_data->main_lock);
+	if ((mask & active & ~nic_data->offload_supported) != 0) {
+		fibril_rwlock_write_unlock(&nic_data->main_lock);
+		return ENOTSUP;
+	}
+
+	nic_data->offload_active = (nic_data->offload_active & ~mask) |
+	    (active & mask);
+	fibril_rwlock_write_unlock(&nic_data->main_lock);
+	return EOK;
+}
+
 /**
  * Default implementation of the poll_get_mode method.
  * Queries the current interrupt/poll mode of the NIC
@@ -0,0 +1,184 @@
+/*
+ * Copyright (c) 2019 Jiri Svoboda
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * - Redistributions of source code must retain the above copyright
+ *   notice, this list of conditions and the following disclaimer.
+ * - Redistributions in binary form must reproduce the above copyright
+ *   notice, this list of conditions and the following disclaimer in the
+ *   documentation and/or other materials provided with the distribution.
+ * - The name of the author may not be used to endorse or promote products
+ *   derived from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHOR ``AS IS'' AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+ * OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+ * IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT
+ * NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF
+ * THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/** @addtogroup libposix
+ * @{
+ */
+/** @file Vectored I/O.
+ */
+
+#include "../internal/common.h"
+#include <sys/uio.h>
+
+#include <errno.h>
+#include <limits.h>
+#include <macros.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <vfs/vfs.h>
+
+/** Number of I/O vector elements passed to VFS at once. */
+#define UIO_BATCH  16
+
+/** Transfer data described by an I/O vector.
+ *
+ * @param read Read data if true, write data otherwise.
+ * @param fildes File descriptor of the opened file.
+ * @param iov I/O vector.
+ * @param iovcnt Number of elements in @a iov.
+ * @param pos Position in the file, updated by the bytes transferred.
+ * @return Number of transferred bytes on success, -1 otherwise.
+ */
+static ssize_t uio_rdwr(bool read, int fildes, const struct iovec *iov,
+    int iovcnt, aoff64_t *pos)
+{
+	vfs_iovec_t viov[UIO_BATCH];
+	size_t total = 0;
+	size_t size = 0;
+	int i, j, n;
+
+	if (iovcnt <= 0 || iovcnt > IOV_MAX) {
+		errno = EINVAL;
+		return -1;
+	}
+
+	for (i = 0; i < iovcnt; i++) {
+		if (iov[i].iov_len > SSIZE_MAX - size) {
+			errno = EINVAL;
+			return -1;
+		}
+		size += iov[i].iov_len;
+	}
+
+	for (i = 0; i < iovcnt; i += n) {
+		size_t want = 0;
+		size_t done;
+		errno_t rc;
+
+		n = min(iovcnt - i, UIO_BATCH);
+		for (j = 0; j < n; j++) {
+			viov[j].base = iov[i + j].iov_base;
+			viov[j].size = iov[i + j].iov_len;
+			want += iov[i + j].iov_len;
+		}
+
+		if (read)
+			rc = vfs_readv(fildes, pos, viov, n, &done);
+		else
+			rc = vfs_writev(fildes, pos, viov, n, &done);
+
+		total += done;
+		if (rc != EOK) {
+			if (total == 0) {
+				errno = rc;
+				return -1;
+			}
+			break;
+		}
+
+		if (done < want)
+			break;
+	}
+
+	return (ssize_t) total;
+}
+
+/**
+ * Read from a file into multiple buffers.
+ *
+ * @param fildes File descriptor of the opened file.
+ * @param iov Buffers to which the read bytes shall be stored.
+ * @param iovcnt Number of buffers.
+ * @return Number of read bytes on success, -1 otherwise.
+ */
+ssize_t readv(int fildes, const struct iovec *iov, int iovcnt)
+{
+	return uio_rdwr(true, fildes, iov, iovcnt, &posix_pos[fildes]);
+}
+
+/**
+ * Write multiple buffers to a file.
+ *
+ * @param fildes File descriptor of the opened file.
+ * @param iov Buffers to write.
+ * @param iovcnt Number of buffers.
+ * @return Number of written bytes on success, -1 otherwise.
+ */
+ssize_t writev(int fildes, const struct iovec *iov, int iovcnt)
+{
+	return uio_rdwr(false, fildes, iov, iovcnt, &posix_pos[fildes]);
+}
+
+/**
+ * Read from a given position in a file into multiple buffers.
+ *
+ * The file position is not changed.
+ *
+ * @param fildes File descriptor of the opened file.
+ * @param iov Buffers to which the read bytes shall be stored.
+ * @param iovcnt Number of buffers.
+ * @param offset Position to read from.
+ * @return Number of read bytes on success, -1 otherwise.
+ */
+ssize_t preadv(int fildes, const struct iovec *iov, int iovcnt, off_t offset)
+{
+	aoff64_t pos = offset;
+
+	if (offset < 0) {
+		errno = EINVAL;
+		return -1;
+	}
+
+	return uio_rdwr(true, fildes, iov, iovcnt, &pos);
+}
+
+/**
+ * Write multiple buffers to a given position in a file.
+ *
+ * The file position is not changed.
+ *
+ * @param fildes File descriptor of the opened file.
+ * @param iov Buffers to write.
+ * @param iovcnt Number of buffers.
+ * @param offset Position to write to.
+ * @return Number of written bytes on success, -1 otherwise.
+ */
+ssize_t pwritev(int fildes, const struct iovec *iov, int iovcnt, off_t offset)
+{
+	aoff64_t pos = offset;
+
+	if (offset < 0) {
+		errno = EINVAL;
+		return -1;
+	}
+
+	return uio_rdwr(false, fildes, iov, iovcnt, &pos);
+}
+
+/** @}
+ */
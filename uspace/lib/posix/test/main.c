@@ -32,6 +32,7 @@ PCUT_INIT;
 
 PCUT_IMPORT(stdio);
 PCUT_IMPORT(stdlib);
+PCUT_IMPORT(uio);
 PCUT_IMPORT(unistd);
 
 PCUT_MAIN();
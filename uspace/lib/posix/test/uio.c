@@ -0,0 +1,243 @@
+/*
+ * Copyright (c) 2019 Jiri Svoboda
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * - Redistributions of source code must retain the above copyright
+ *   notice, this list of conditions and the following disclaimer.
+ * - Redistributions in binary form must reproduce the above copyright
+ *   notice, this list of conditions and the following disclaimer in the
+ *   documentation and/or other materials provided with the distribution.
+ * - The name of the author may not be used to endorse or promote products
+ *   derived from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHOR ``AS IS'' AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+ * OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+ * IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT
+ * NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF
+ * THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <stdio.h>
+#include <pcut/pcut.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <string.h>
+#include <sys/uio.h>
+#include <unistd.h>
+
+PCUT_INIT;
+
+PCUT_TEST_SUITE(uio);
+
+/** writev followed by readv with a different buffer layout */
+PCUT_TEST(writev_readv)
+{
+	char name[L_tmpnam];
+	char hello[] = "Hello";
+	char world[] = ", world";
+	char buf1[3], buf2[5], buf3[8];
+	struct iovec wiov[3];
+	struct iovec riov[3];
+	char *p;
+	ssize_t nbytes;
+	int file;
+
+	p = tmpnam(name);
+	PCUT_ASSERT_NOT_NULL(p);
+
+	file = open(name, O_CREAT | O_EXCL | O_RDWR, 0600);
+	PCUT_ASSERT_TRUE(file >= 0);
+
+	wiov[0].iov_base = hello;
+	wiov[0].iov_len = 5;
+	wiov[1].iov_base = NULL;
+	wiov[1].iov_len = 0;
+	wiov[2].iov_base = world;
+	wiov[2].iov_len = 7;
+
+	nbytes = writev(file, wiov, 3);
+	PCUT_ASSERT_INT_EQUALS(12, nbytes);
+
+	riov[0].iov_base = buf1;
+	riov[0].iov_len = sizeof(buf1);
+	riov[1].iov_base = buf2;
+	riov[1].iov_len = sizeof(buf2);
+	riov[2].iov_base = buf3;
+	riov[2].iov_len = sizeof(buf3);
+
+	/* Only 12 bytes are available */
+	nbytes = preadv(file, riov, 3, 0);
+	PCUT_ASSERT_INT_EQUALS(12, nbytes);
+	PCUT_ASSERT_INT_EQUALS(0, memcmp(buf1, "Hel", 3));
+	PCUT_ASSERT_INT_EQUALS(0, memcmp(buf2, "lo, w", 5));
+	PCUT_ASSERT_INT_EQUALS(0, memcmp(buf3, "orld", 4));
+
+	(void) unlink(name);
+	close(file);
+}
+
+/** pwritev does not move the file position */
+PCUT_TEST(pwritev_pos)
+{
+	char name[L_tmpnam];
+	char data[] = "abcd";
+	char buf[4];
+	struct iovec iov;
+	char *p;
+	ssize_t nbytes;
+	int file;
+
+	p = tmpnam(name);
+	PCUT_ASSERT_NOT_NULL(p);
+
+	file = open(name, O_CREAT | O_EXCL | O_RDWR, 0600);
+	PCUT_ASSERT_TRUE(file >= 0);
+
+	iov.iov_base = data;
+	iov.iov_len = 4;
+	nbytes = pwritev(file, &iov, 1, 2);
+	PCUT_ASSERT_INT_EQUALS(4, nbytes);
+
+	iov.iov_base = buf;
+	iov.iov_len = sizeof(buf);
+	nbytes = readv(file, &iov, 1);
+	PCUT_ASSERT_INT_EQUALS(4, nbytes);
+	PCUT_ASSERT_INT_EQUALS(0, memcmp(buf + 2, "ab", 2));
+
+	(void) unlink(name);
+	close(file);
+}
+
+/** readv with invalid vector size */
+PCUT_TEST(readv_inval)
+{
+	struct iovec iov;
+	ssize_t nbytes;
+
+	nbytes = readv(0, &iov, 0);
+	PCUT_ASSERT_INT_EQUALS(-1, nbytes);
+}
+
+/** preadv on a closed file reports the error of the request */
+PCUT_TEST(preadv_badf)
+{
+	char name[L_tmpnam];
+	char buf[4];
+	struct iovec iov;
+	char *p;
+	ssize_t nbytes;
+	int file;
+
+	p = tmpnam(name);
+	PCUT_ASSERT_NOT_NULL(p);
+
+	file = open(name, O_CREAT | O_EXCL | O_RDWR, 0600);
+	PCUT_ASSERT_TRUE(file >= 0);
+	(void) unlink(name);
+	close(file);
+
+	iov.iov_base = buf;
+	iov.iov_len = sizeof(buf);
+	nbytes = preadv(file, &iov, 1, 0);
+	PCUT_ASSERT_INT_EQUALS(-1, nbytes);
+	PCUT_ASSERT_INT_EQUALS(EBADF, errno);
+}
+
+/** More vector elements than fit in a single VFS request */
+PCUT_TEST(writev_readv_many)
+{
+	char name[L_tmpnam];
+	char data[100];
+	char buf[100];
+	struct iovec iov[100];
+	char *p;
+	ssize_t nbytes;
+	int file;
+	int i;
+
+	p = tmpnam(name);
+	PCUT_ASSERT_NOT_NULL(p);
+
+	file = open(name, O_CREAT | O_EXCL | O_RDWR, 0600);
+	PCUT_ASSERT_TRUE(file >= 0);
+
+	for (i = 0; i < 100; i++) {
+		data[i] = 'a' + i % 26;
+		iov[i].iov_base = &data[i];
+		iov[i].iov_len = 1;
+	}
+
+	nbytes = writev(file, iov, 100);
+	PCUT_ASSERT_INT_EQUALS(100, nbytes);
+
+	memset(buf, 0, sizeof(buf));
+	for (i = 0; i < 100; i++) {
+		iov[i].iov_base = &buf[99 - i];
+		iov[i].iov_len = 1;
+	}
+
+	nbytes = preadv(file, iov, 100, 0);
+	PCUT_ASSERT_INT_EQUALS(100, nbytes);
+	for (i = 0; i < 100; i++)
+		PCUT_ASSERT_INT_EQUALS(data[i], buf[99 - i]);
+
+	(void) unlink(name);
+	close(file);
+}
+
+static char large_data[100000];
+static char large_buf[100000];
+
+/** Vector too large to be staged in a VFS buffer */
+PCUT_TEST(writev_readv_large)
+{
+	char name[L_tmpnam];
+	struct iovec iov[3];
+	char *p;
+	ssize_t nbytes;
+	size_t i;
+	int file;
+
+	p = tmpnam(name);
+	PCUT_ASSERT_NOT_NULL(p);
+
+	file = open(name, O_CREAT | O_EXCL | O_RDWR, 0600);
+	PCUT_ASSERT_TRUE(file >= 0);
+
+	for (i = 0; i < sizeof(large_data); i++)
+		large_data[i] = 'a' + i % 26;
+
+	iov[0].iov_base = large_data;
+	iov[0].iov_len = 10;
+	iov[1].iov_base = large_data + 10;
+	iov[1].iov_len = 70000;
+	iov[2].iov_base = large_data + 70010;
+	iov[2].iov_len = sizeof(large_data) - 70010;
+
+	nbytes = writev(file, iov, 3);
+	PCUT_ASSERT_INT_EQUALS(sizeof(large_data), nbytes);
+
+	iov[0].iov_base = large_buf;
+	iov[0].iov_len = 50000;
+	iov[1].iov_base = large_buf + 50000;
+	iov[1].iov_len = sizeof(large_buf) - 50000;
+
+	nbytes = preadv(file, iov, 2, 0);
+	PCUT_ASSERT_INT_EQUALS(sizeof(large_buf), nbytes);
+	PCUT_ASSERT_INT_EQUALS(0, memcmp(large_data, large_buf,
+	    sizeof(large_buf)));
+
+	(void) unlink(name);
+	close(file);
+}
+
+PCUT_EXPORT(uio);
@@ -178,6 +178,9 @@ typedef struct {
 
 	/** Virtqueues */
 	virtq_t *queues;
+
+	/** Negotiated feature bits (0 - 31) */
+	uint32_t features;
 } virtio_dev_t;
 
 extern errno_t virtio_setup_dma_bufs(unsigned int, size_t, bool, void *[],
@@ -201,7 +204,7 @@ extern bool virtio_virtq_consume_used(virtio_dev_t *, uint16_t, uint16_t *,
 extern errno_t virtio_virtq_setup(virtio_dev_t *, uint16_t, uint16_t);
 extern void virtio_virtq_teardown(virtio_dev_t *, uint16_t);
 
-extern errno_t virtio_device_setup_start(virtio_dev_t *, uint32_t);
+extern errno_t virtio_device_setup_start(virtio_dev_t *, uint32_t, uint32_t);
 extern void virtio_device_setup_fail(virtio_dev_t *);
 extern void virtio_device_setup_finalize(virtio_dev_t *);
 
@@ -297,8 +297,15 @@ void virtio_virtq_teardown(virtio_dev_t *vdev, uint16_t num)
 /**
  * Perform device initialization as described in section 3.1.1 of the
  * specification, steps 1 - 6.
+ *
+ * @param vdev     VIRTIO device
+ * @param features Feature bits the driver requires
+ * @param optional Feature bits the driver can use if offered
+ *
+ * The negotiated feature set is stored in @c vdev->features.
  */
-errno_t virtio_device_setup_start(virtio_dev_t *vdev, uint32_t features)
+errno_t virtio_device_setup_start(virtio_dev_t *vdev, uint32_t features,
+    uint32_t optional)
 {
 	virtio_pci_common_cfg_t *cfg = vdev->common_cfg;
 
@@ -322,7 +329,8 @@ errno_t virtio_device_setup_start(virtio_dev_t *vdev, uint32_t features)
 
 	if (features != (features & device_features))
 		return ENOTSUP;
-	features &= device_features;
+	features |= optional & device_features;
+	vdev->features = features;
 
 	/* 4. Write the accepted feature flags */
 	pio_write_le32(&cfg->driver_feature_select, VIRTIO_FEATURES_0_31);
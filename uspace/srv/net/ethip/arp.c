@@ -46,9 +46,6 @@
 #include "pdu.h"
 #include "std.h"
 
-/** Time to wait for ARP reply in microseconds */
-#define ARP_REQUEST_TIMEOUT (3 * 1000 * 1000)
-
 static errno_t arp_send_packet(ethip_nic_t *nic, arp_eth_packet_t *packet);
 
 void arp_received(ethip_nic_t *nic, eth_frame_t *frame)
@@ -77,7 +74,7 @@ void arp_received(ethip_nic_t *nic, eth_frame_t *frame)
 
 	log_msg(LOG_DEFAULT, LVL_DEBUG, "Request/reply to my address");
 
-	(void) atrans_add(packet.sender_proto_addr,
+	(void) atrans_add(nic, packet.sender_proto_addr,
 	    packet.sender_hw_addr);
 
 	if (packet.opcode == aop_request) {
@@ -93,8 +90,23 @@ void arp_received(ethip_nic_t *nic, eth_frame_t *frame)
 	}
 }
 
+/** Translate IPv4 address to MAC address.
+ *
+ * If the address is not in the ARP cache, an ARP request is sent and
+ * @a pkt (if not @c NULL) is queued until the reply arrives.
+ *
+ * @param nic      NIC
+ * @param src_addr Source address
+ * @param ip_addr  Destination address
+ * @param pkt      Packet to queue or @c NULL
+ * @param mac_addr Place to store MAC address
+ *
+ * @return EOK on success, EINPROGRESS if @a pkt was queued, EAGAIN if
+ *         @a pkt is @c NULL and the address is not resolved yet, ENOENT
+ *         if the address could not be resolved or an error code
+ */
 errno_t arp_translate(ethip_nic_t *nic, addr32_t src_addr, addr32_t ip_addr,
-    addr48_t mac_addr)
+    ethip_pkt_t *pkt, addr48_t mac_addr)
 {
 	/* Broadcast address */
 	if (ip_addr == addr32_broadcast_all_hosts) {
@@ -102,10 +114,18 @@ errno_t arp_translate(ethip_nic_t *nic, addr32_t src_addr, addr32_t ip_addr,
 		return EOK;
 	}
 
-	errno_t rc = atrans_lookup(ip_addr, mac_addr);
-	if (rc == EOK)
-		return EOK;
+	return atrans_resolve(nic, src_addr, ip_addr, pkt, mac_addr);
+}
 
+/** Send ARP request.
+ *
+ * @param nic      NIC
+ * @param src_addr Source address
+ * @param ip_addr  Address to resolve
+ * @return EOK on success or an error code
+ */
+errno_t arp_request(ethip_nic_t *nic, addr32_t src_addr, addr32_t ip_addr)
+{
 	arp_eth_packet_t packet;
 
 	packet.opcode = aop_request;
@@ -114,11 +134,7 @@ errno_t arp_translate(ethip_nic_t *nic, addr32_t src_addr, addr32_t ip_addr,
 	addr48(addr48_broadcast, packet.target_hw_addr);
 	packet.target_proto_addr = ip_addr;
 
-	rc = arp_send_packet(nic, &packet);
-	if (rc != EOK)
-		return rc;
-
-	return atrans_lookup_timeout(ip_addr, ARP_REQUEST_TIMEOUT, mac_addr);
+	return arp_send_packet(nic, &packet);
 }
 
 static errno_t arp_send_packet(ethip_nic_t *nic, arp_eth_packet_t *packet)
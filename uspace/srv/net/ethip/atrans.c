@@ -34,131 +34,112 @@
  * @brief
  */
 
-#include <adt/list.h>
 #include <errno.h>
-#include <fibril_synch.h>
+#include <inet/addr.h>
 #include <inet/iplink_srv.h>
-#include <stdlib.h>
+#include <nettl/ncache.h>
 
+#include "arp.h"
 #include "atrans.h"
 #include "ethip.h"
 
-/** Address translation list (of ethip_atrans_t) */
-static FIBRIL_MUTEX_INITIALIZE(atrans_list_lock);
-static LIST_INITIALIZE(atrans_list);
-static FIBRIL_CONDVAR_INITIALIZE(atrans_cv);
+static errno_t atrans_solicit(void *, inet_addr_t *, inet_addr_t *);
+static void atrans_xmit(void *, void *, addr48_t);
+static void atrans_discard(void *, void *);
 
-static ethip_atrans_t *atrans_find(addr32_t ip_addr)
-{
-	list_foreach(atrans_list, atrans_list, ethip_atrans_t, atrans) {
-		if (atrans->ip_addr == ip_addr)
-			return atrans;
-	}
-
-	return NULL;
-}
+/** Address translation cache callbacks */
+static ncache_ops_t atrans_ops = {
+	.solicit = atrans_solicit,
+	.xmit = atrans_xmit,
+	.discard = atrans_discard
+};
 
-errno_t atrans_add(addr32_t ip_addr, addr48_t mac_addr)
+/** Send ARP request on behalf of the address translation cache. */
+static errno_t atrans_solicit(void *arg, inet_addr_t *src, inet_addr_t *addr)
 {
-	ethip_atrans_t *atrans;
-	ethip_atrans_t *prev;
-
-	atrans = calloc(1, sizeof(ethip_atrans_t));
-	if (atrans == NULL)
-		return ENOMEM;
+	ethip_nic_t *nic = (ethip_nic_t *) arg;
+	addr32_t src_v4;
+	addr32_t addr_v4;
 
-	atrans->ip_addr = ip_addr;
-	addr48(mac_addr, atrans->mac_addr);
+	if (inet_addr_get(src, &src_v4, NULL) != ip_v4 ||
+	    inet_addr_get(addr, &addr_v4, NULL) != ip_v4)
+		return EINVAL;
 
-	fibril_mutex_lock(&atrans_list_lock);
-	prev = atrans_find(ip_addr);
-	if (prev != NULL) {
-		list_remove(&prev->atrans_list);
-		free(prev);
-	}
-
-	list_append(&atrans->atrans_list, &atrans_list);
-	fibril_mutex_unlock(&atrans_list_lock);
-	fibril_condvar_broadcast(&atrans_cv);
-
-	return EOK;
+	return arp_request(nic, src_v4, addr_v4);
 }
 
-errno_t atrans_remove(addr32_t ip_addr)
+/** Transmit packet that was waiting for address resolution. */
+static void atrans_xmit(void *arg, void *pkt, addr48_t mac_addr)
 {
-	ethip_atrans_t *atrans;
-
-	fibril_mutex_lock(&atrans_list_lock);
-	atrans = atrans_find(ip_addr);
-	if (atrans == NULL) {
-		fibril_mutex_unlock(&atrans_list_lock);
-		return ENOENT;
-	}
-
-	list_remove(&atrans->atrans_list);
-	fibril_mutex_unlock(&atrans_list_lock);
-	free(atrans);
-
-	return EOK;
+	ethip_pkt_xmit((ethip_nic_t *) arg, (ethip_pkt_t *) pkt, mac_addr);
 }
 
-static errno_t atrans_lookup_locked(addr32_t ip_addr, addr48_t mac_addr)
+/** Discard packet that was waiting for address resolution. */
+static void atrans_discard(void *arg, void *pkt)
 {
-	ethip_atrans_t *atrans = atrans_find(ip_addr);
-	if (atrans == NULL)
-		return ENOENT;
-
-	addr48(atrans->mac_addr, mac_addr);
-	return EOK;
+	ethip_pkt_delete((ethip_pkt_t *) pkt);
 }
 
-errno_t atrans_lookup(addr32_t ip_addr, addr48_t mac_addr)
+/** Create address translation cache of a NIC.
+ *
+ * @param nic NIC
+ * @return EOK on success, ENOMEM if out of memory
+ */
+errno_t atrans_init(ethip_nic_t *nic)
 {
-	errno_t rc;
-
-	fibril_mutex_lock(&atrans_list_lock);
-	rc = atrans_lookup_locked(ip_addr, mac_addr);
-	fibril_mutex_unlock(&atrans_list_lock);
-
-	return rc;
+	return ncache_create(&atrans_ops, nic, &nic->atrans);
 }
 
-static void atrans_lookup_timeout_handler(void *arg)
+/** Destroy address translation cache of a NIC.
+ *
+ * @param nic NIC
+ */
+void atrans_fini(ethip_nic_t *nic)
 {
-	bool *timedout = (bool *)arg;
-
-	fibril_mutex_lock(&atrans_list_lock);
-	*timedout = true;
-	fibril_mutex_unlock(&atrans_list_lock);
-	fibril_condvar_broadcast(&atrans_cv);
+	if (nic->atrans != NULL)
+		ncache_destroy(nic->atrans);
 }
 
-errno_t atrans_lookup_timeout(addr32_t ip_addr, usec_t timeout,
-    addr48_t mac_addr)
+errno_t atrans_add(ethip_nic_t *nic, addr32_t ip_addr, addr48_t mac_addr)
 {
-	fibril_timer_t *t;
-	bool timedout;
-	errno_t rc;
+	inet_addr_t addr;
 
-	t = fibril_timer_create(NULL);
-	if (t == NULL)
-		return ENOMEM;
+	inet_addr_set(ip_addr, &addr);
+	return ncache_add(nic->atrans, &addr, mac_addr);
+}
 
-	timedout = false;
-	fibril_timer_set(t, timeout, atrans_lookup_timeout_handler, &timedout);
+errno_t atrans_remove(ethip_nic_t *nic, addr32_t ip_addr)
+{
+	inet_addr_t addr;
 
-	fibril_mutex_lock(&atrans_list_lock);
+	inet_addr_set(ip_addr, &addr);
+	return ncache_remove(nic->atrans, &addr);
+}
 
-	while ((rc = atrans_lookup_locked(ip_addr, mac_addr)) == ENOENT &&
-	    !timedout) {
-		fibril_condvar_wait(&atrans_cv, &atrans_list_lock);
-	}
+/** Translate IPv4 address to MAC address.
+ *
+ * See ncache_resolve() for the meaning of @a pkt and the return values.
+ *
+ * @param nic      NIC
+ * @param src_addr Source address for ARP requests
+ * @param ip_addr  Address to translate
+ * @param pkt      Packet to queue if address is not resolved, or @c NULL
+ * @param mac_addr Place to store MAC address
+ */
+errno_t atrans_resolve(ethip_nic_t *nic, addr32_t src_addr, addr32_t ip_addr,
+    ethip_pkt_t *pkt, addr48_t mac_addr)
+{
+	inet_addr_t src;
+	inet_addr_t addr;
 
-	fibril_mutex_unlock(&atrans_list_lock);
-	(void) fibril_timer_clear(t);
-	fibril_timer_destroy(t);
+	inet_addr_set(src_addr, &src);
+	inet_addr_set(ip_addr, &addr);
+	return ncache_resolve(nic->atrans, &src, &addr, pkt, mac_addr);
+}
 
-	return rc;
+void atrans_get_stats(ethip_nic_t *nic, inet_nstats_t *stats)
+{
+	ncache_get_stats(nic->atrans, stats);
 }
 
 /** @}
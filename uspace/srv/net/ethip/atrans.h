@@ -41,10 +41,13 @@
 #include <inet/addr.h>
 #include "ethip.h"
 
-extern errno_t atrans_add(addr32_t, addr48_t);
-extern errno_t atrans_remove(addr32_t);
-extern errno_t atrans_lookup(addr32_t, addr48_t);
-extern errno_t atrans_lookup_timeout(addr32_t, usec_t, addr48_t);
+extern errno_t atrans_init(ethip_nic_t *);
+extern void atrans_fini(ethip_nic_t *);
+extern errno_t atrans_add(ethip_nic_t *, addr32_t, addr48_t);
+extern errno_t atrans_remove(ethip_nic_t *, addr32_t);
+extern errno_t atrans_resolve(ethip_nic_t *, addr32_t, addr32_t, ethip_pkt_t *,
+    addr48_t);
+extern void atrans_get_stats(ethip_nic_t *, inet_nstats_t *);
 
 #endif
 
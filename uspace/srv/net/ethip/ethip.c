@@ -36,15 +36,20 @@
  * Based on the IETF RFC 894 standard.
  */
 
+#include <assert.h>
 #include <async.h>
 #include <errno.h>
 #include <inet/iplink_srv.h>
 #include <io/log.h>
+#include <ipc/iplink.h>
 #include <loc.h>
+#include <mem.h>
+#include <nic/nic.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <task.h>
 #include "arp.h"
+#include "atrans.h"
 #include "ethip.h"
 #include "ethip_nic.h"
 #include "pdu.h"
@@ -57,6 +62,8 @@ static errno_t ethip_close(iplink_srv_t *srv);
 static errno_t ethip_send(iplink_srv_t *srv, iplink_sdu_t *sdu);
 static errno_t ethip_send6(iplink_srv_t *srv, iplink_sdu6_t *sdu);
 static errno_t ethip_get_mtu(iplink_srv_t *srv, size_t *mtu);
+static errno_t ethip_get_offload(iplink_srv_t *srv, uint32_t *offload);
+static errno_t ethip_get_nstats(iplink_srv_t *srv, inet_nstats_t *stats);
 static errno_t ethip_get_mac48(iplink_srv_t *srv, addr48_t *mac);
 static errno_t ethip_set_mac48(iplink_srv_t *srv, addr48_t *mac);
 static errno_t ethip_addr_add(iplink_srv_t *srv, inet_addr_t *addr);
@@ -70,6 +77,8 @@ static iplink_ops_t ethip_iplink_ops = {
 	.send = ethip_send,
 	.send6 = ethip_send6,
 	.get_mtu = ethip_get_mtu,
+	.get_offload = ethip_get_offload,
+	.get_nstats = ethip_get_nstats,
 	.get_mac48 = ethip_get_mac48,
 	.set_mac48 = ethip_set_mac48,
 	.addr_add = ethip_addr_add,
@@ -106,6 +115,7 @@ errno_t ethip_iplink_init(ethip_nic_t *nic)
 	iplink_srv_init(&nic->iplink);
 	nic->iplink.ops = &ethip_iplink_ops;
 	nic->iplink.arg = nic;
+	nic->iplink.pool = nic->pool;
 
 	if (asprintf(&svc_name, "net/eth%u", ++link_num) < 0) {
 		log_msg(LOG_DEFAULT, LVL_ERROR, "Out of memory.");
@@ -169,6 +179,107 @@ static errno_t ethip_close(iplink_srv_t *srv)
 	return EOK;
 }
 
+/** Encode and send Ethernet frame.
+ *
+ * If the payload is held in a packet buffer, the Ethernet header is
+ * prepended in place. Otherwise the frame is assembled in a new buffer.
+ *
+ * @param nic        NIC
+ * @param frame      Ethernet frame
+ * @param pbuf       Packet buffer holding the frame payload or @c NULL
+ * @param csum_start Offset in payload where transport checksumming starts
+ * @param csum_offs  Offset of partial transport checksum relative to
+ *                   @a csum_start, zero if the payload is complete
+ * @return EOK on success or an error code
+ */
+static errno_t ethip_send_frame(ethip_nic_t *nic, eth_frame_t *frame,
+    pbuf_t *pbuf, size_t csum_start, size_t csum_offs)
+{
+	void *data;
+	size_t size;
+	errno_t rc;
+
+	if (pbuf != NULL && eth_pdu_encode_pbuf(frame, pbuf) == EOK) {
+		data = pbuf_data(pbuf);
+		size = pbuf_size(pbuf);
+	} else {
+		rc = eth_pdu_encode(frame, &data, &size);
+		if (rc != EOK)
+			return rc;
+
+		pbuf = NULL;
+	}
+
+	if (csum_offs != 0) {
+		rc = ethip_nic_send_csum(nic, data, size,
+		    sizeof(eth_header_t) + csum_start, csum_offs);
+	} else {
+		rc = ethip_nic_send(nic, data, size);
+	}
+
+	if (pbuf == NULL)
+		free(data);
+
+	return rc;
+}
+
+/** Create copy of outgoing IPv4 packet for queueing.
+ *
+ * @param sdu Service data unit
+ * @return New packet or @c NULL if out of memory
+ */
+static ethip_pkt_t *ethip_pkt_create(iplink_sdu_t *sdu)
+{
+	ethip_pkt_t *pkt;
+
+	pkt = calloc(1, sizeof(ethip_pkt_t));
+	if (pkt == NULL)
+		return NULL;
+
+	pkt->data = malloc(sdu->size);
+	if (pkt->data == NULL) {
+		free(pkt);
+		return NULL;
+	}
+
+	memcpy(pkt->data, sdu->data, sdu->size);
+	pkt->size = sdu->size;
+	pkt->csum_start = sdu->csum_start;
+	pkt->csum_offs = sdu->csum_offs;
+	return pkt;
+}
+
+/** Delete queued IPv4 packet.
+ *
+ * @param pkt Packet
+ */
+void ethip_pkt_delete(ethip_pkt_t *pkt)
+{
+	free(pkt->data);
+	free(pkt);
+}
+
+/** Transmit queued IPv4 packet once its destination is resolved.
+ *
+ * @param nic      NIC
+ * @param pkt      Packet, deleted by this function
+ * @param mac_addr Destination MAC address
+ */
+void ethip_pkt_xmit(ethip_nic_t *nic, ethip_pkt_t *pkt, addr48_t mac_addr)
+{
+	eth_frame_t frame;
+
+	addr48(mac_addr, frame.dest);
+	addr48(nic->mac_addr, frame.src);
+	frame.etype_len = ETYPE_IP;
+	frame.data = pkt->data;
+	frame.size = pkt->size;
+
+	(void) ethip_send_frame(nic, &frame, NULL, pkt->csum_start,
+	    pkt->csum_offs);
+	ethip_pkt_delete(pkt);
+}
+
 static errno_t ethip_send(iplink_srv_t *srv, iplink_sdu_t *sdu)
 {
 	log_msg(LOG_DEFAULT, LVL_DEBUG, "ethip_send()");
@@ -176,7 +287,20 @@ static errno_t ethip_send(iplink_srv_t *srv, iplink_sdu_t *sdu)
 	ethip_nic_t *nic = (ethip_nic_t *) srv->arg;
 	eth_frame_t frame;
 
-	errno_t rc = arp_translate(nic, sdu->src, sdu->dest, frame.dest);
+	errno_t rc = arp_translate(nic, sdu->src, sdu->dest, NULL, frame.dest);
+	if (rc == EAGAIN) {
+		/* Queue a copy of the packet until the ARP reply arrives */
+		ethip_pkt_t *pkt = ethip_pkt_create(sdu);
+		if (pkt == NULL)
+			return ENOMEM;
+
+		rc = arp_translate(nic, sdu->src, sdu->dest, pkt, frame.dest);
+		if (rc == EINPROGRESS)
+			return EOK;
+
+		ethip_pkt_delete(pkt);
+	}
+
 	if (rc != EOK) {
 		log_msg(LOG_DEFAULT, LVL_WARN, "Failed to look up IPv4 address 0x%"
 		    PRIx32, sdu->dest);
@@ -188,16 +312,8 @@ static errno_t ethip_send(iplink_srv_t *srv, iplink_sdu_t *sdu)
 	frame.data = sdu->data;
 	frame.size = sdu->size;
 
-	void *data;
-	size_t size;
-	rc = eth_pdu_encode(&frame, &data, &size);
-	if (rc != EOK)
-		return rc;
-
-	rc = ethip_nic_send(nic, data, size);
-	free(data);
-
-	return rc;
+	return ethip_send_frame(nic, &frame, sdu->pbuf, sdu->csum_start,
+	    sdu->csum_offs);
 }
 
 static errno_t ethip_send6(iplink_srv_t *srv, iplink_sdu6_t *sdu)
@@ -213,16 +329,8 @@ static errno_t ethip_send6(iplink_srv_t *srv, iplink_sdu6_t *sdu)
 	frame.data = sdu->data;
 	frame.size = sdu->size;
 
-	void *data;
-	size_t size;
-	errno_t rc = eth_pdu_encode(&frame, &data, &size);
-	if (rc != EOK)
-		return rc;
-
-	rc = ethip_nic_send(nic, data, size);
-	free(data);
-
-	return rc;
+	return ethip_send_frame(nic, &frame, sdu->pbuf, sdu->csum_start,
+	    sdu->csum_offs);
 }
 
 errno_t ethip_received(iplink_srv_t *srv, void *data, size_t size)
@@ -264,10 +372,72 @@ errno_t ethip_received(iplink_srv_t *srv, void *data, size_t size)
 		    frame.etype_len);
 	}
 
-	free(frame.data);
 	return rc;
 }
 
+/** Process a batch of received frames.
+ *
+ * IP datagrams contained in the frames are passed up to the client
+ * in a single batch.
+ *
+ * @param srv    IP link server
+ * @param frames Array of frames
+ * @param sizes  Array of frame sizes
+ * @param count  Number of frames, at most IPLINK_EV_RECV_BATCH_MAX
+ *
+ * @return EOK on success or an error code
+ */
+errno_t ethip_received_batch(iplink_srv_t *srv, void **frames, size_t *sizes,
+    size_t count)
+{
+	ethip_nic_t *nic = (ethip_nic_t *) srv->arg;
+	iplink_recv_sdu_t sdus[IPLINK_EV_RECV_BATCH_MAX];
+	ip_ver_t vers[IPLINK_EV_RECV_BATCH_MAX];
+	eth_frame_t frame;
+	size_t nsdus;
+	size_t i;
+	errno_t rc;
+
+	log_msg(LOG_DEFAULT, LVL_DEBUG, "ethip_received_batch(): srv=%p, "
+	    "count=%zu", srv, count);
+
+	assert(count <= IPLINK_EV_RECV_BATCH_MAX);
+
+	nsdus = 0;
+	for (i = 0; i < count; i++) {
+		rc = eth_pdu_decode(frames[i], sizes[i], &frame);
+		if (rc != EOK)
+			continue;
+
+		switch (frame.etype_len) {
+		case ETYPE_ARP:
+			arp_received(nic, &frame);
+			break;
+		case ETYPE_IP:
+		case ETYPE_IPV6:
+			/* Empty SDUs cannot be part of a batch */
+			if (frame.size == 0)
+				break;
+			sdus[nsdus].data = frame.data;
+			sdus[nsdus].size = frame.size;
+			vers[nsdus] = frame.etype_len == ETYPE_IP ? ip_v4 : ip_v6;
+			++nsdus;
+			break;
+		default:
+			log_msg(LOG_DEFAULT, LVL_DEBUG, "Unknown ethertype "
+			    "0x%" PRIx16, frame.etype_len);
+		}
+	}
+
+	if (nsdus == 0)
+		return EOK;
+
+	if (nsdus == 1)
+		return iplink_ev_recv(&nic->iplink, &sdus[0], vers[0]);
+
+	return iplink_ev_recv_batch(&nic->iplink, sdus, vers, nsdus);
+}
+
 static errno_t ethip_get_mtu(iplink_srv_t *srv, size_t *mtu)
 {
 	log_msg(LOG_DEFAULT, LVL_DEBUG, "ethip_get_mtu()");
@@ -275,6 +445,26 @@ static errno_t ethip_get_mtu(iplink_srv_t *srv, size_t *mtu)
 	return EOK;
 }
 
+static errno_t ethip_get_offload(iplink_srv_t *srv, uint32_t *offload)
+{
+	ethip_nic_t *nic = (ethip_nic_t *) srv->arg;
+
+	log_msg(LOG_DEFAULT, LVL_DEBUG, "ethip_get_offload()");
+	*offload = 0;
+	if ((nic->offload & NIC_OFFLOAD_TX_CSUM) != 0)
+		*offload |= IPLINK_OFFLOAD_CSUM;
+	return EOK;
+}
+
+static errno_t ethip_get_nstats(iplink_srv_t *srv, inet_nstats_t *stats)
+{
+	ethip_nic_t *nic = (ethip_nic_t *) srv->arg;
+
+	log_msg(LOG_DEFAULT, LVL_DEBUG, "ethip_get_nstats()");
+	atrans_get_stats(nic, stats);
+	return EOK;
+}
+
 static errno_t ethip_get_mac48(iplink_srv_t *srv, addr48_t *mac)
 {
 	log_msg(LOG_DEFAULT, LVL_DEBUG, "ethip_get_mac48()");
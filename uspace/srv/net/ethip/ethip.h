@@ -40,8 +40,10 @@
 #include <adt/list.h>
 #include <async.h>
 #include <inet/iplink_srv.h>
+#include <inet/pbuf.h>
 #include <inet/addr.h>
 #include <loc.h>
+#include <nettl/ncache.h>
 #include <stddef.h>
 #include <stdint.h>
 
@@ -59,9 +61,18 @@ typedef struct ethip_nic {
 	iplink_srv_t iplink;
 	service_id_t iplink_sid;
 
+	/** Packet buffers for received frames and outgoing SDUs */
+	pbuf_pool_t *pool;
+
+	/** Offload computations enabled on the NIC (NIC_OFFLOAD_*) */
+	uint32_t offload;
+
 	/** MAC address */
 	addr48_t mac_addr;
 
+	/** ARP cache */
+	ncache_t *atrans;
+
 	/**
 	 * List of IP addresses configured on this link
 	 * (of the type ethip_link_addr_t)
@@ -108,15 +119,24 @@ typedef struct {
 	addr32_t target_proto_addr;
 } arp_eth_packet_t;
 
-/** Address translation table element */
+/** Outgoing IPv4 packet waiting for ARP resolution */
 typedef struct {
-	link_t atrans_list;
-	addr32_t ip_addr;
-	addr48_t mac_addr;
-} ethip_atrans_t;
+	/** Serialized IP packet */
+	void *data;
+	/** Size of @c data in bytes */
+	size_t size;
+	/** Offset in @c data where transport checksumming starts */
+	uint16_t csum_start;
+	/** Offset of partial transport checksum or zero */
+	uint16_t csum_offs;
+} ethip_pkt_t;
 
 extern errno_t ethip_iplink_init(ethip_nic_t *);
 extern errno_t ethip_received(iplink_srv_t *, void *, size_t);
+extern errno_t ethip_received_batch(iplink_srv_t *, void **, size_t *,
+    size_t);
+extern void ethip_pkt_xmit(ethip_nic_t *, ethip_pkt_t *, addr48_t);
+extern void ethip_pkt_delete(ethip_pkt_t *);
 
 #endif
 
@@ -41,14 +41,53 @@
 #include <str_error.h>
 #include <fibril_synch.h>
 #include <inet/iplink_srv.h>
+#include <inet/pbuf.h>
 #include <io/log.h>
+#include <ipc/iplink.h>
 #include <loc.h>
 #include <nic_iface.h>
 #include <stdlib.h>
 #include <mem.h>
+#include "atrans.h"
 #include "ethip.h"
 #include "ethip_nic.h"
 #include "pdu.h"
+#include "std.h"
+
+/** Number of packet buffers per NIC */
+#define ETHIP_NIC_PBUFS  32
+
+/** Negotiate offload computations with NIC.
+ *
+ * Enable the offloads ethip makes use of if the NIC supports them. They are
+ * advertised to the IP link client, which then skips the work.
+ *
+ * @param nic NIC
+ */
+static void ethip_nic_offload_init(ethip_nic_t *nic)
+{
+	uint32_t supported;
+	uint32_t active;
+	errno_t rc;
+
+	nic->offload = 0;
+
+	rc = nic_offload_probe(nic->sess, &supported, &active);
+	if (rc != EOK)
+		return;
+
+	if ((supported & NIC_OFFLOAD_TX_CSUM) == 0)
+		return;
+
+	rc = nic_offload_set(nic->sess, NIC_OFFLOAD_TX_CSUM,
+	    NIC_OFFLOAD_TX_CSUM);
+	if (rc != EOK)
+		return;
+
+	nic->offload = NIC_OFFLOAD_TX_CSUM;
+	log_msg(LOG_DEFAULT, LVL_DEBUG, "NIC '%s' completes TX checksums.",
+	    nic->svc_name);
+}
 
 static errno_t ethip_nic_open(service_id_t sid);
 static void ethip_nic_cb_conn(ipc_call_t *icall, void *arg);
@@ -112,6 +151,29 @@ static ethip_nic_t *ethip_nic_new(void)
 		return NULL;
 	}
 
+	/*
+	 * Leave room for the Ethernet header in front of outgoing SDUs
+	 * and make received frames of maximum size fit as well.
+	 */
+	errno_t rc = pbuf_pool_create(ETHIP_NIC_PBUFS,
+	    sizeof(eth_header_t) + ETH_FRAME_MAX_SIZE, sizeof(eth_header_t),
+	    &nic->pool);
+	if (rc != EOK) {
+		log_msg(LOG_DEFAULT, LVL_ERROR, "Failed allocating packet "
+		    "buffers. Out of memory.");
+		free(nic);
+		return NULL;
+	}
+
+	rc = atrans_init(nic);
+	if (rc != EOK) {
+		log_msg(LOG_DEFAULT, LVL_ERROR, "Failed creating ARP cache. "
+		    "Out of memory.");
+		pbuf_pool_destroy(nic->pool);
+		free(nic);
+		return NULL;
+	}
+
 	link_initialize(&nic->link);
 	list_initialize(&nic->addr_list);
 
@@ -138,6 +200,8 @@ static void ethip_nic_delete(ethip_nic_t *nic)
 	if (nic->svc_name != NULL)
 		free(nic->svc_name);
 
+	atrans_fini(nic);
+	pbuf_pool_destroy(nic->pool);
 	free(nic);
 }
 
@@ -181,6 +245,8 @@ static errno_t ethip_nic_open(service_id_t sid)
 	list_append(&nic->link, &ethip_nic_list);
 	in_list = true;
 
+	ethip_nic_offload_init(nic);
+
 	rc = ethip_iplink_init(nic);
 	if (rc != EOK)
 		goto error;
@@ -261,12 +327,14 @@ static void ethip_nic_received(ethip_nic_t *nic, ipc_call_t *call)
 	errno_t rc;
 	void *data;
 	size_t size;
+	pbuf_t *pbuf;
 
 	log_msg(LOG_DEFAULT, LVL_DEBUG, "ethip_nic_received() nic=%p", nic);
 
-	rc = async_data_write_accept(&data, false, 0, 0, 0, &size);
+	rc = pbuf_data_write_receive(nic->pool, &data, &size, &pbuf);
 	if (rc != EOK) {
 		log_msg(LOG_DEFAULT, LVL_DEBUG, "data_write_accept() failed");
+		async_answer_0(call, rc);
 		return;
 	}
 
@@ -276,12 +344,81 @@ static void ethip_nic_received(ethip_nic_t *nic, ipc_call_t *call)
 	log_msg(LOG_DEFAULT, LVL_DEBUG, "call ethip_received");
 	rc = ethip_received(&nic->iplink, data, size);
 	log_msg(LOG_DEFAULT, LVL_DEBUG, "free data");
-	free(data);
+	pbuf_data_free(data, pbuf);
 
 	log_msg(LOG_DEFAULT, LVL_DEBUG, "ethip_nic_received() done, rc=%s", str_error_name(rc));
 	async_answer_0(call, rc);
 }
 
+static void ethip_nic_received_batch(ethip_nic_t *nic, ipc_call_t *call)
+{
+	void *frames[NIC_EV_RECEIVED_BATCH_MAX];
+	pbuf_t *pbufs[NIC_EV_RECEIVED_BATCH_MAX];
+	size_t *sizes;
+	size_t count;
+	size_t ssize;
+	size_t total;
+	size_t size;
+	size_t nrecv;
+	size_t i;
+	errno_t rc;
+
+	count = IPC_GET_ARG1(*call);
+
+	log_msg(LOG_DEFAULT, LVL_DEBUG, "ethip_nic_received_batch() nic=%p, "
+	    "count=%zu", nic, count);
+
+	if (count == 0 || count > NIC_EV_RECEIVED_BATCH_MAX ||
+	    count > IPLINK_EV_RECV_BATCH_MAX) {
+		async_answer_0(call, EINVAL);
+		return;
+	}
+
+	ssize = count * sizeof(size_t);
+	rc = async_data_write_accept((void **) &sizes, false, ssize, ssize, 0,
+	    NULL);
+	if (rc != EOK) {
+		async_answer_0(call, rc);
+		return;
+	}
+
+	/* Reject empty frames and batches whose total size is out of bounds */
+	total = 0;
+	for (i = 0; i < count; i++) {
+		if (sizes[i] == 0 ||
+		    sizes[i] > NIC_EV_RECEIVED_BATCH_SIZE_MAX - total) {
+			free(sizes);
+			async_answer_0(call, EINVAL);
+			return;
+		}
+
+		total += sizes[i];
+	}
+
+	/* Each frame follows in its own data write */
+	for (nrecv = 0; nrecv < count; nrecv++) {
+		rc = pbuf_data_write_receive(nic->pool, &frames[nrecv], &size,
+		    &pbufs[nrecv]);
+		if (rc != EOK)
+			break;
+
+		if (size != sizes[nrecv]) {
+			pbuf_data_free(frames[nrecv], pbufs[nrecv]);
+			rc = EINVAL;
+			break;
+		}
+	}
+
+	if (rc == EOK)
+		rc = ethip_received_batch(&nic->iplink, frames, sizes, count);
+
+	for (i = 0; i < nrecv; i++)
+		pbuf_data_free(frames[i], pbufs[i]);
+
+	free(sizes);
+	async_answer_0(call, rc);
+}
+
 static void ethip_nic_device_state(ethip_nic_t *nic, ipc_call_t *call)
 {
 	log_msg(LOG_DEFAULT, LVL_DEBUG, "ethip_nic_device_state()");
@@ -313,6 +450,9 @@ static void ethip_nic_cb_conn(ipc_call_t *icall, void *arg)
 		case NIC_EV_DEVICE_STATE:
 			ethip_nic_device_state(nic, &call);
 			break;
+		case NIC_EV_RECEIVED_BATCH:
+			ethip_nic_received_batch(nic, &call);
+			break;
 		default:
 			log_msg(LOG_DEFAULT, LVL_DEBUG, "unknown IPC method: %" PRIun, IPC_GET_IMETHOD(call));
 			async_answer_0(&call, ENOTSUP);
@@ -358,6 +498,26 @@ errno_t ethip_nic_send(ethip_nic_t *nic, void *data, size_t size)
 	return rc;
 }
 
+/** Send frame with partial transport checksum.
+ *
+ * @param nic        NIC
+ * @param data       Frame data
+ * @param size       Frame size in bytes
+ * @param csum_start Offset where checksumming starts
+ * @param csum_offs  Offset of checksum field relative to @a csum_start
+ * @return EOK on success or an error code
+ */
+errno_t ethip_nic_send_csum(ethip_nic_t *nic, void *data, size_t size,
+    size_t csum_start, size_t csum_offs)
+{
+	errno_t rc;
+	log_msg(LOG_DEFAULT, LVL_DEBUG, "ethip_nic_send_csum(size=%zu)", size);
+	rc = nic_send_frame_csum(nic->sess, data, size, csum_start, csum_offs);
+	log_msg(LOG_DEFAULT, LVL_DEBUG, "nic_send_frame_csum -> %s",
+	    str_error_name(rc));
+	return rc;
+}
+
 /** Setup accepted multicast addresses
  *
  * Currently the set of accepted multicast addresses is
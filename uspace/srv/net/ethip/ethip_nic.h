@@ -44,6 +44,8 @@
 extern errno_t ethip_nic_discovery_start(void);
 extern ethip_nic_t *ethip_nic_find_by_iplink_sid(service_id_t);
 extern errno_t ethip_nic_send(ethip_nic_t *, void *, size_t);
+extern errno_t ethip_nic_send_csum(ethip_nic_t *, void *, size_t, size_t,
+    size_t);
 extern errno_t ethip_nic_addr_add(ethip_nic_t *, inet_addr_t *);
 extern errno_t ethip_nic_addr_remove(ethip_nic_t *, inet_addr_t *);
 extern ethip_link_addr_t *ethip_nic_addr_find(ethip_nic_t *, inet_addr_t *);
@@ -34,6 +34,7 @@
  * @brief
  */
 
+#include <assert.h>
 #include <byteorder.h>
 #include <errno.h>
 #include <io/log.h>
@@ -73,7 +74,51 @@ errno_t eth_pdu_encode(eth_frame_t *frame, void **rdata, size_t *rsize)
 	return EOK;
 }
 
-/** Decode Ethernet PDU. */
+/** Encode Ethernet PDU in place.
+ *
+ * The frame payload must be the data of @a pbuf. The Ethernet header
+ * is prepended to it in the buffer's headroom and the frame is padded
+ * to the minimum frame size, so that the payload is not copied.
+ *
+ * @param frame Ethernet frame
+ * @param pbuf  Packet buffer holding the frame payload
+ * @return EOK on success, ENOMEM if the buffer lacks headroom or tailroom
+ */
+errno_t eth_pdu_encode_pbuf(eth_frame_t *frame, pbuf_t *pbuf)
+{
+	eth_header_t *hdr;
+	size_t size;
+	void *pad;
+
+	assert(frame->data == pbuf_data(pbuf));
+	assert(frame->size == pbuf_size(pbuf));
+
+	hdr = pbuf_push(pbuf, sizeof(eth_header_t));
+	if (hdr == NULL)
+		return ENOMEM;
+
+	addr48(frame->src, hdr->src);
+	addr48(frame->dest, hdr->dest);
+	hdr->etype_len = host2uint16_t_be(frame->etype_len);
+
+	size = pbuf_size(pbuf);
+	if (size < ETH_FRAME_MIN_SIZE) {
+		pad = pbuf_put(pbuf, ETH_FRAME_MIN_SIZE - size);
+		if (pad == NULL)
+			return ENOMEM;
+		memset(pad, 0, ETH_FRAME_MIN_SIZE - size);
+	}
+
+	log_msg(LOG_DEFAULT, LVL_DEBUG, "Encoded Ethernet frame (%zu bytes)",
+	    pbuf_size(pbuf));
+
+	return EOK;
+}
+
+/** Decode Ethernet PDU.
+ *
+ * The decoded frame payload points into @a data, it is not copied.
+ */
 errno_t eth_pdu_decode(void *data, size_t size, eth_frame_t *frame)
 {
 	eth_header_t *hdr;
@@ -88,17 +133,12 @@ errno_t eth_pdu_decode(void *data, size_t size, eth_frame_t *frame)
 	hdr = (eth_header_t *)data;
 
 	frame->size = size - sizeof(eth_header_t);
-	frame->data = calloc(frame->size, 1);
-	if (frame->data == NULL)
-		return ENOMEM;
+	frame->data = (uint8_t *)data + sizeof(eth_header_t);
 
 	addr48(hdr->src, frame->src);
 	addr48(hdr->dest, frame->dest);
 	frame->etype_len = uint16_t_be2host(hdr->etype_len);
 
-	memcpy(frame->data, (uint8_t *)data + sizeof(eth_header_t),
-	    frame->size);
-
 	log_msg(LOG_DEFAULT, LVL_DEBUG, "Decoded Ethernet frame payload (%zu bytes)", frame->size);
 
 	return EOK;
@@ -37,9 +37,11 @@
 #ifndef ETH_PDU_H_
 #define ETH_PDU_H_
 
+#include <inet/pbuf.h>
 #include "ethip.h"
 
 extern errno_t eth_pdu_encode(eth_frame_t *, void **, size_t *);
+extern errno_t eth_pdu_encode_pbuf(eth_frame_t *, pbuf_t *);
 extern errno_t eth_pdu_decode(void *, size_t, eth_frame_t *);
 extern errno_t arp_pdu_encode(arp_eth_packet_t *, void **, size_t *);
 extern errno_t arp_pdu_decode(void *, size_t, arp_eth_packet_t *);
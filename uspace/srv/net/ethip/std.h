@@ -43,6 +43,7 @@
 #define ETH_ADDR_SIZE       6
 #define IPV4_ADDR_SIZE      4
 #define ETH_FRAME_MIN_SIZE  60
+#define ETH_FRAME_MAX_SIZE  1514
 
 /** Ethernet frame header */
 typedef struct {
@@ -44,6 +44,7 @@
 #include "addrobj.h"
 #include "inetsrv.h"
 #include "inet_link.h"
+#include "lpm.h"
 #include "ndp.h"
 
 static inet_addrobj_t *inet_addrobj_find_by_name_locked(const char *, inet_link_t *);
@@ -52,6 +53,10 @@ static FIBRIL_MUTEX_INITIALIZE(addr_list_lock);
 static LIST_INITIALIZE(addr_list);
 static sysarg_t addr_id = 0;
 
+/** Longest-prefix-match table, maps network to first address object in list */
+static inet_lpm_t addr_lpm;
+static bool addr_lpm_init = false;
+
 inet_addrobj_t *inet_addrobj_new(void)
 {
 	inet_addrobj_t *addr = calloc(1, sizeof(inet_addrobj_t));
@@ -80,6 +85,7 @@ void inet_addrobj_delete(inet_addrobj_t *addr)
 errno_t inet_addrobj_add(inet_addrobj_t *addr)
 {
 	inet_addrobj_t *aobj;
+	errno_t rc;
 
 	fibril_mutex_lock(&addr_list_lock);
 	aobj = inet_addrobj_find_by_name_locked(addr->name, addr->ilink);
@@ -89,6 +95,17 @@ errno_t inet_addrobj_add(inet_addrobj_t *addr)
 		return EEXIST;
 	}
 
+	if (!addr_lpm_init) {
+		inet_lpm_init(&addr_lpm);
+		addr_lpm_init = true;
+	}
+
+	rc = inet_lpm_insert(&addr_lpm, &addr->naddr, addr);
+	if (rc != EOK && rc != EEXIST) {
+		fibril_mutex_unlock(&addr_list_lock);
+		return rc;
+	}
+
 	list_append(&addr->addr_list, &addr_list);
 	fibril_mutex_unlock(&addr_list_lock);
 
@@ -97,40 +114,66 @@ errno_t inet_addrobj_add(inet_addrobj_t *addr)
 
 void inet_addrobj_remove(inet_addrobj_t *addr)
 {
+	void *arg;
+	errno_t rc;
+
 	fibril_mutex_lock(&addr_list_lock);
 	list_remove(&addr->addr_list);
+
+	rc = inet_lpm_find_exact(&addr_lpm, &addr->naddr, &arg);
+	if (rc == EOK && arg == addr) {
+		(void) inet_lpm_remove(&addr_lpm, &addr->naddr);
+
+		/* Let the next address object on the same network take over */
+		list_foreach(addr_list, addr_list, inet_addrobj_t, other) {
+			if (inet_lpm_same(&other->naddr, &addr->naddr)) {
+				rc = inet_lpm_insert(&addr_lpm, &other->naddr,
+				    other);
+				if (rc != EOK) {
+					log_msg(LOG_DEFAULT, LVL_ERROR,
+					    "Failed re-inserting address %p.",
+					    other);
+				}
+				break;
+			}
+		}
+	}
+
 	fibril_mutex_unlock(&addr_list_lock);
 }
 
 /** Find address object matching address @a addr.
  *
  * @param addr Address
- * @oaram find iaf_net to find network (using mask),
- *             iaf_addr to find local address (exact match)
+ * @oaram find iaf_net to find network (using mask, most specific
+ *             network wins), iaf_addr to find local address (exact match)
  *
  */
 inet_addrobj_t *inet_addrobj_find(inet_addr_t *addr, inet_addrobj_find_t find)
 {
+	void *arg;
+
 	fibril_mutex_lock(&addr_list_lock);
 
+	if (find == iaf_net) {
+		if (addr_lpm_init && inet_lpm_find(&addr_lpm, addr, &arg) == EOK) {
+			fibril_mutex_unlock(&addr_list_lock);
+			log_msg(LOG_DEFAULT, LVL_DEBUG, "inet_addrobj_find: found %p",
+			    arg);
+			return (inet_addrobj_t *) arg;
+		}
+
+		log_msg(LOG_DEFAULT, LVL_DEBUG, "inet_addrobj_find: Not found");
+		fibril_mutex_unlock(&addr_list_lock);
+		return NULL;
+	}
+
 	list_foreach(addr_list, addr_list, inet_addrobj_t, naddr) {
-		switch (find) {
-		case iaf_net:
-			if (inet_naddr_compare_mask(&naddr->naddr, addr)) {
-				fibril_mutex_unlock(&addr_list_lock);
-				log_msg(LOG_DEFAULT, LVL_DEBUG, "inet_addrobj_find: found %p",
-				    naddr);
-				return naddr;
-			}
-			break;
-		case iaf_addr:
-			if (inet_naddr_compare(&naddr->naddr, addr)) {
-				fibril_mutex_unlock(&addr_list_lock);
-				log_msg(LOG_DEFAULT, LVL_DEBUG, "inet_addrobj_find: found %p",
-				    naddr);
-				return naddr;
-			}
-			break;
+		if (inet_naddr_compare(&naddr->naddr, addr)) {
+			fibril_mutex_unlock(&addr_list_lock);
+			log_msg(LOG_DEFAULT, LVL_DEBUG, "inet_addrobj_find: found %p",
+			    naddr);
+			return naddr;
 		}
 	}
 
@@ -238,7 +281,22 @@ errno_t inet_addrobj_send_dgram(inet_addrobj_t *addr, inet_addr_t *ldest,
 		/*
 		 * Translate local destination IPv6 address.
 		 */
-		rc = ndp_translate(lsrc_v6, ldest_v6, ldest_mac, addr->ilink);
+		rc = ndp_translate(lsrc_v6, ldest_v6, ldest_mac, addr->ilink,
+		    NULL);
+		if (rc == EAGAIN) {
+			/* Queue a copy until the neighbour advertisement */
+			ndp_pkt_t *pkt = ndp_pkt_create(dgram, proto, ttl, df);
+			if (pkt == NULL)
+				return ENOMEM;
+
+			rc = ndp_translate(lsrc_v6, ldest_v6, ldest_mac,
+			    addr->ilink, pkt);
+			if (rc == EINPROGRESS)
+				return EOK;
+
+			ndp_pkt_delete(pkt);
+		}
+
 		if (rc != EOK)
 			return rc;
 
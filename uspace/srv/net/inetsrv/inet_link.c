@@ -46,6 +46,8 @@
 #include "addrobj.h"
 #include "inetsrv.h"
 #include "inet_link.h"
+#include "inet_std.h"
+#include "ntrans.h"
 #include "pdu.h"
 
 static bool first_link = true;
@@ -115,7 +117,6 @@ static errno_t inet_iplink_recv(iplink_t *iplink, iplink_recv_sdu_t *sdu, ip_ver
 	log_msg(LOG_DEFAULT, LVL_DEBUG, "call inet_recv_packet()");
 	rc = inet_recv_packet(&packet);
 	log_msg(LOG_DEFAULT, LVL_DEBUG, "call inet_recv_packet -> %s", str_error_name(rc));
-	free(packet.data);
 
 	return rc;
 }
@@ -144,6 +145,13 @@ static inet_link_t *inet_link_new(void)
 		return NULL;
 	}
 
+	if (ntrans_init(ilink) != EOK) {
+		log_msg(LOG_DEFAULT, LVL_ERROR, "Failed creating neighbour "
+		    "cache. Out of memory.");
+		free(ilink);
+		return NULL;
+	}
+
 	link_initialize(&ilink->link_list);
 
 	return ilink;
@@ -154,6 +162,7 @@ static void inet_link_delete(inet_link_t *ilink)
 	if (ilink->svc_name != NULL)
 		free(ilink->svc_name);
 
+	ntrans_fini(ilink);
 	free(ilink);
 }
 
@@ -197,6 +206,11 @@ errno_t inet_link_open(service_id_t sid)
 		goto error;
 	}
 
+	/* Links which do not know about offloading do not perform any */
+	rc = iplink_get_offload(ilink->iplink, &ilink->offload);
+	if (rc != EOK)
+		ilink->offload = 0;
+
 	/*
 	 * Get the MAC address of the link. If the link has a MAC
 	 * address, we assume that it supports NDP.
@@ -296,6 +310,54 @@ error:
 	return rc;
 }
 
+/** Complete partial transport checksum of datagram in software.
+ *
+ * @param dgram Datagram with @c csum_offs set
+ */
+static void inet_link_csum_complete(inet_dgram_t *dgram)
+{
+	uint8_t *data = dgram->data;
+	uint16_t csum;
+
+	csum = inet_checksum_calc(INET_CHECKSUM_INIT, data, dgram->size);
+	if (csum == 0)
+		csum = 0xffff;
+
+	data[dgram->csum_offs] = csum >> 8;
+	data[dgram->csum_offs + 1] = csum & 0xff;
+	dgram->csum_offs = 0;
+}
+
+/** Prepare partial transport checksum for transmission.
+ *
+ * Leave the checksum to the link if it can complete it and the datagram
+ * is not going to be fragmented, otherwise complete it in software.
+ *
+ * @param ilink    Internet link
+ * @param dgram    Datagram
+ * @param hdr_size Size of unfragmented IP header
+ * @return @c true iff the link is to complete the checksum
+ */
+static bool inet_link_csum_prepare(inet_link_t *ilink, inet_dgram_t *dgram,
+    size_t hdr_size)
+{
+	if (dgram->csum_offs == 0)
+		return false;
+
+	if (dgram->csum_offs + sizeof(uint16_t) > dgram->size) {
+		/* Bogus offset, leave the datagram as it is */
+		dgram->csum_offs = 0;
+		return false;
+	}
+
+	if ((ilink->offload & IPLINK_OFFLOAD_CSUM) != 0 &&
+	    hdr_size + dgram->size <= ilink->def_mtu)
+		return true;
+
+	inet_link_csum_complete(dgram);
+	return false;
+}
+
 /** Send IPv4 datagram over Internet link
  *
  * @param ilink Internet link
@@ -333,6 +395,11 @@ errno_t inet_link_send_dgram(inet_link_t *ilink, addr32_t lsrc, addr32_t ldest,
 
 	sdu.src = lsrc;
 	sdu.dest = ldest;
+	sdu.csum_start = sizeof(ip_header_t);
+	sdu.csum_offs = 0;
+
+	if (inet_link_csum_prepare(ilink, dgram, sizeof(ip_header_t)))
+		sdu.csum_offs = dgram->csum_offs;
 
 	inet_packet_t packet;
 
@@ -401,6 +468,11 @@ errno_t inet_link_send_dgram6(inet_link_t *ilink, addr48_t ldest,
 
 	iplink_sdu6_t sdu6;
 	addr48(ldest, sdu6.dest);
+	sdu6.csum_start = sizeof(ip6_header_t);
+	sdu6.csum_offs = 0;
+
+	if (inet_link_csum_prepare(ilink, dgram, sizeof(ip6_header_t)))
+		sdu6.csum_offs = dgram->csum_offs;
 
 	/*
 	 * Fill packet structure. Fragmentation is performed by
@@ -49,6 +49,7 @@
 #include "inetsrv.h"
 #include "inet_link.h"
 #include "inetcfg.h"
+#include "ntrans.h"
 #include "sroute.h"
 
 static errno_t inetcfg_addr_create_static(char *name, inet_naddr_t *naddr,
@@ -184,6 +185,29 @@ static errno_t inetcfg_link_get(sysarg_t link_id, inet_link_info_t *linfo)
 	return EOK;
 }
 
+static errno_t inetcfg_link_get_nstats(sysarg_t link_id, ip_ver_t ver,
+    inet_nstats_t *stats)
+{
+	inet_link_t *ilink;
+
+	ilink = inet_link_get_by_id(link_id);
+	if (ilink == NULL)
+		return ENOENT;
+
+	switch (ver) {
+	case ip_v4:
+		/* The ARP cache is kept by the link provider */
+		return iplink_get_nstats(ilink->iplink, stats);
+	case ip_v6:
+		if (!ilink->mac_valid)
+			return ENOTSUP;
+		ntrans_get_stats(ilink, stats);
+		return EOK;
+	default:
+		return EINVAL;
+	}
+}
+
 static errno_t inetcfg_link_remove(sysarg_t link_id)
 {
 	return ENOTSUP;
@@ -193,6 +217,7 @@ static errno_t inetcfg_sroute_create(char *name, inet_naddr_t *dest,
     inet_addr_t *router, sysarg_t *sroute_id)
 {
 	inet_sroute_t *sroute;
+	errno_t rc;
 
 	sroute = inet_sroute_new();
 	if (sroute == NULL) {
@@ -203,7 +228,13 @@ static errno_t inetcfg_sroute_create(char *name, inet_naddr_t *dest,
 	sroute->dest = *dest;
 	sroute->router = *router;
 	sroute->name = str_dup(name);
-	inet_sroute_add(sroute);
+
+	rc = inet_sroute_add(sroute);
+	if (rc != EOK) {
+		inet_sroute_delete(sroute);
+		*sroute_id = 0;
+		return rc;
+	}
 
 	*sroute_id = sroute->id;
 	return EOK;
@@ -558,6 +589,38 @@ static void inetcfg_link_get_srv(ipc_call_t *call)
 	async_answer_1(call, retval, linfo.def_mtu);
 }
 
+static void inetcfg_link_get_nstats_srv(ipc_call_t *call)
+{
+	ipc_call_t rcall;
+	size_t max_size;
+	sysarg_t link_id;
+	ip_ver_t ver;
+	inet_nstats_t stats;
+	errno_t rc;
+
+	link_id = IPC_GET_ARG1(*call);
+	ver = IPC_GET_ARG2(*call);
+	log_msg(LOG_DEFAULT, LVL_DEBUG, "inetcfg_link_get_nstats_srv()");
+
+	if (!async_data_read_receive(&rcall, &max_size)) {
+		async_answer_0(&rcall, EREFUSED);
+		async_answer_0(call, EREFUSED);
+		return;
+	}
+
+	rc = inetcfg_link_get_nstats(link_id, ver, &stats);
+	if (rc != EOK) {
+		async_answer_0(&rcall, rc);
+		async_answer_0(call, rc);
+		return;
+	}
+
+	errno_t retval = async_data_read_finalize(&rcall, &stats,
+	    min(max_size, sizeof(stats)));
+
+	async_answer_0(call, retval);
+}
+
 static void inetcfg_link_remove_srv(ipc_call_t *call)
 {
 	sysarg_t link_id;
@@ -783,6 +846,9 @@ void inet_cfg_conn(ipc_call_t *icall, void *arg)
 		case INETCFG_LINK_GET:
 			inetcfg_link_get_srv(&call);
 			break;
+		case INETCFG_LINK_GET_NSTATS:
+			inetcfg_link_get_nstats_srv(&call);
+			break;
 		case INETCFG_LINK_REMOVE:
 			inetcfg_link_remove_srv(&call);
 			break;
@@ -295,6 +295,7 @@ static void inet_send_srv(inet_client_t *client, ipc_call_t *icall)
 
 	uint8_t ttl = IPC_GET_ARG3(*icall);
 	int df = IPC_GET_ARG4(*icall);
+	dgram.csum_offs = IPC_GET_ARG5(*icall);
 
 	ipc_call_t call;
 	size_t size;
@@ -525,6 +526,7 @@ errno_t inet_recv_packet(inet_packet_t *packet)
 			dgram.tos = packet->tos;
 			dgram.data = packet->data;
 			dgram.size = packet->size;
+			dgram.csum_offs = 0;
 
 			return inet_recv_dgram_local(&dgram, packet->proto);
 		} else {
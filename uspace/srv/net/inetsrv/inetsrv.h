@@ -42,6 +42,7 @@
 #include <inet/addr.h>
 #include <inet/iplink.h>
 #include <ipc/loc.h>
+#include <nettl/ncache.h>
 #include <stddef.h>
 #include <stdint.h>
 #include <types/inet.h>
@@ -108,8 +109,12 @@ typedef struct {
 	async_sess_t *sess;
 	iplink_t *iplink;
 	size_t def_mtu;
+	/** Offload computations performed by the link (IPLINK_OFFLOAD_*) */
+	uint32_t offload;
 	addr48_t mac;
 	bool mac_valid;
+	/** IPv6 neighbour cache */
+	ncache_t *ntrans;
 } inet_link_t;
 
 typedef struct {
@@ -0,0 +1,505 @@
+/*
+ * Copyright (c) 2019 Jiri Svoboda
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * - Redistributions of source code must retain the above copyright
+ *   notice, this list of conditions and the following disclaimer.
+ * - Redistributions in binary form must reproduce the above copyright
+ *   notice, this list of conditions and the following disclaimer in the
+ *   documentation and/or other materials provided with the distribution.
+ * - The name of the author may not be used to endorse or promote products
+ *   derived from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHOR ``AS IS'' AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+ * OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+ * IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT
+ * NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF
+ * THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/** @addtogroup inet
+ * @{
+ */
+/**
+ * @file Longest-prefix-match table
+ *
+ * Networks are stored in a path-compressed binary trie (one per address
+ * family). Every node carries the complete prefix leading to it, so
+ * chains of single-child nodes are never needed. Nodes either hold
+ * a network or branch into two subtrees.
+ */
+
+#include <assert.h>
+#include <errno.h>
+#include <inet/addr.h>
+#include <macros.h>
+#include <mem.h>
+#include <stdlib.h>
+#include "lpm.h"
+
+/** Get bit @a i of key @a key (most significant bit first). */
+static unsigned inet_lpm_bit(const uint8_t *key, unsigned i)
+{
+	return (key[i / 8] >> (7 - i % 8)) & 1;
+}
+
+/** Determine number of leading bits two keys have in common.
+ *
+ * @param a   First key
+ * @param b   Second key
+ * @param max Maximum number of bits to compare
+ * @return Length of common prefix in bits, at most @a max
+ */
+static unsigned inet_lpm_common(const uint8_t *a, const uint8_t *b,
+    unsigned max)
+{
+	unsigned i;
+	uint8_t diff;
+
+	for (i = 0; i < max; i += 8) {
+		diff = a[i / 8] ^ b[i / 8];
+		if (diff != 0) {
+			while ((diff & 0x80) == 0) {
+				diff <<= 1;
+				++i;
+			}
+
+			return min(i, max);
+		}
+	}
+
+	return max;
+}
+
+/** Convert address to trie key.
+ *
+ * @param ver  IP version
+ * @param v4   IPv4 address
+ * @param v6   IPv6 address
+ * @param key  Place to store key
+ * @return Maximum key length for the address family in bits
+ */
+static unsigned inet_lpm_key(ip_ver_t ver, addr32_t v4, addr128_t v6,
+    uint8_t *key)
+{
+	memset(key, 0, INET_LPM_BITS_MAX / 8);
+
+	if (ver == ip_v4) {
+		key[0] = v4 >> 24;
+		key[1] = (v4 >> 16) & 0xff;
+		key[2] = (v4 >> 8) & 0xff;
+		key[3] = v4 & 0xff;
+		return 32;
+	}
+
+	memcpy(key, v6, 16);
+	return 128;
+}
+
+/** Clear key bits past the prefix length.
+ *
+ * @param key  Key
+ * @param bits Prefix length
+ */
+static void inet_lpm_mask(uint8_t *key, unsigned bits)
+{
+	unsigned i;
+
+	if (bits % 8 != 0)
+		key[bits / 8] &= 0xff << (8 - bits % 8);
+
+	for (i = (bits + 7) / 8; i < INET_LPM_BITS_MAX / 8; i++)
+		key[i] = 0;
+}
+
+/** Get trie root for the specified address family.
+ *
+ * @param lpm LPM table
+ * @param ver IP version
+ * @return Pointer to root pointer or @c NULL if @a ver is not supported
+ */
+static inet_lpm_node_t **inet_lpm_root(inet_lpm_t *lpm, ip_ver_t ver)
+{
+	switch (ver) {
+	case ip_v4:
+		return &lpm->root4;
+	case ip_v6:
+		return &lpm->root6;
+	default:
+		return NULL;
+	}
+}
+
+/** Create trie node.
+ *
+ * @param key  Key
+ * @param bits Prefix length
+ * @return New node or @c NULL if out of memory
+ */
+static inet_lpm_node_t *inet_lpm_node_new(const uint8_t *key, unsigned bits)
+{
+	inet_lpm_node_t *node;
+
+	node = calloc(1, sizeof(inet_lpm_node_t));
+	if (node == NULL)
+		return NULL;
+
+	memcpy(node->key, key, sizeof(node->key));
+	node->bits = bits;
+	return node;
+}
+
+/** Destroy trie recursively.
+ *
+ * @param node Root of (sub)trie or @c NULL
+ */
+static void inet_lpm_node_destroy(inet_lpm_node_t *node)
+{
+	if (node == NULL)
+		return;
+
+	inet_lpm_node_destroy(node->child[0]);
+	inet_lpm_node_destroy(node->child[1]);
+	free(node);
+}
+
+/** Initialize LPM table.
+ *
+ * @param lpm LPM table
+ */
+void inet_lpm_init(inet_lpm_t *lpm)
+{
+	lpm->root4 = NULL;
+	lpm->root6 = NULL;
+	lpm->count = 0;
+}
+
+/** Finalize LPM table.
+ *
+ * Frees all nodes. The stored arguments are not touched.
+ *
+ * @param lpm LPM table
+ */
+void inet_lpm_fini(inet_lpm_t *lpm)
+{
+	inet_lpm_node_destroy(lpm->root4);
+	inet_lpm_node_destroy(lpm->root6);
+	inet_lpm_init(lpm);
+}
+
+/** Insert network into LPM table.
+ *
+ * @param lpm   LPM table
+ * @param naddr Network
+ * @param arg   Argument to associate with the network
+ *
+ * @return EOK on success, EEXIST if the network is already present,
+ *         EINVAL if the network is invalid, ENOMEM if out of memory
+ */
+errno_t inet_lpm_insert(inet_lpm_t *lpm, inet_naddr_t *naddr, void *arg)
+{
+	uint8_t key[INET_LPM_BITS_MAX / 8];
+	inet_lpm_node_t **np;
+	inet_lpm_node_t *node;
+	inet_lpm_node_t *nnode;
+	inet_lpm_node_t *branch;
+	addr32_t v4;
+	addr128_t v6;
+	uint8_t bits;
+	unsigned maxbits;
+	unsigned cpl;
+	ip_ver_t ver;
+
+	ver = inet_naddr_get(naddr, &v4, &v6, &bits);
+	np = inet_lpm_root(lpm, ver);
+	if (np == NULL)
+		return EINVAL;
+
+	maxbits = inet_lpm_key(ver, v4, v6, key);
+	if (bits > maxbits)
+		return EINVAL;
+
+	inet_lpm_mask(key, bits);
+
+	while (true) {
+		node = *np;
+		if (node == NULL) {
+			/* Empty subtree, add leaf */
+			nnode = inet_lpm_node_new(key, bits);
+			if (nnode == NULL)
+				return ENOMEM;
+			break;
+		}
+
+		cpl = inet_lpm_common(node->key, key, min(node->bits, bits));
+
+		if (cpl == node->bits) {
+			if (node->bits == bits) {
+				/* Exact match */
+				if (node->used)
+					return EEXIST;
+
+				node->used = true;
+				node->arg = arg;
+				++lpm->count;
+				return EOK;
+			}
+
+			/* Node is a prefix of the new network, descend */
+			np = &node->child[inet_lpm_bit(key, node->bits)];
+			continue;
+		}
+
+		nnode = inet_lpm_node_new(key, bits);
+		if (nnode == NULL)
+			return ENOMEM;
+
+		if (cpl == bits) {
+			/* New network is a prefix of the node */
+			nnode->child[inet_lpm_bit(node->key, bits)] = node;
+		} else {
+			/* Paths diverge at bit cpl, add a branching node */
+			branch = inet_lpm_node_new(key, cpl);
+			if (branch == NULL) {
+				free(nnode);
+				return ENOMEM;
+			}
+
+			branch->child[inet_lpm_bit(node->key, cpl)] = node;
+			branch->child[inet_lpm_bit(key, cpl)] = nnode;
+			nnode->used = true;
+			nnode->arg = arg;
+			*np = branch;
+			++lpm->count;
+			return EOK;
+		}
+
+		break;
+	}
+
+	nnode->used = true;
+	nnode->arg = arg;
+	*np = nnode;
+	++lpm->count;
+	return EOK;
+}
+
+/** Locate node holding exactly the specified network.
+ *
+ * @param lpm   LPM table
+ * @param naddr Network
+ * @param rnp   Place to store pointer to link pointing to the node
+ * @param rpp   Place to store pointer to link pointing to the parent
+ *              node or @c NULL if the node is the root
+ *
+ * @return EOK on success, ENOENT if the network is not present
+ */
+static errno_t inet_lpm_locate(inet_lpm_t *lpm, inet_naddr_t *naddr,
+    inet_lpm_node_t ***rnp, inet_lpm_node_t ***rpp)
+{
+	uint8_t key[INET_LPM_BITS_MAX / 8];
+	inet_lpm_node_t **np;
+	inet_lpm_node_t **pp;
+	inet_lpm_node_t *node;
+	addr32_t v4;
+	addr128_t v6;
+	uint8_t bits;
+	ip_ver_t ver;
+
+	ver = inet_naddr_get(naddr, &v4, &v6, &bits);
+	np = inet_lpm_root(lpm, ver);
+	if (np == NULL)
+		return ENOENT;
+
+	if (bits > inet_lpm_key(ver, v4, v6, key))
+		return ENOENT;
+
+	inet_lpm_mask(key, bits);
+	pp = NULL;
+
+	while (true) {
+		node = *np;
+		if (node == NULL || node->bits > bits ||
+		    inet_lpm_common(node->key, key, node->bits) < node->bits)
+			return ENOENT;
+
+		if (node->bits == bits)
+			break;
+
+		pp = np;
+		np = &node->child[inet_lpm_bit(key, node->bits)];
+	}
+
+	if (!node->used)
+		return ENOENT;
+
+	*rnp = np;
+	*rpp = pp;
+	return EOK;
+}
+
+/** Remove network from LPM table.
+ *
+ * @param lpm   LPM table
+ * @param naddr Network
+ *
+ * @return EOK on success, ENOENT if the network is not present
+ */
+errno_t inet_lpm_remove(inet_lpm_t *lpm, inet_naddr_t *naddr)
+{
+	inet_lpm_node_t **np;
+	inet_lpm_node_t **pp;
+	inet_lpm_node_t *node;
+	inet_lpm_node_t *parent;
+	errno_t rc;
+
+	rc = inet_lpm_locate(lpm, naddr, &np, &pp);
+	if (rc != EOK)
+		return rc;
+
+	node = *np;
+	node->used = false;
+	node->arg = NULL;
+	--lpm->count;
+
+	if (node->child[0] != NULL && node->child[1] != NULL) {
+		/* Still needed as a branching node */
+		return EOK;
+	}
+
+	/* Replace node with its only child (if any) */
+	*np = node->child[0] != NULL ? node->child[0] : node->child[1];
+	free(node);
+
+	/* Parent might now be a branching node with a single child */
+	if (pp != NULL) {
+		parent = *pp;
+		if (!parent->used && (parent->child[0] == NULL ||
+		    parent->child[1] == NULL)) {
+			*pp = parent->child[0] != NULL ? parent->child[0] :
+			    parent->child[1];
+			free(parent);
+		}
+	}
+
+	return EOK;
+}
+
+/** Find argument stored with exactly the specified network.
+ *
+ * @param lpm   LPM table
+ * @param naddr Network
+ * @param rarg  Place to store argument
+ *
+ * @return EOK on success, ENOENT if the network is not present
+ */
+errno_t inet_lpm_find_exact(inet_lpm_t *lpm, inet_naddr_t *naddr, void **rarg)
+{
+	inet_lpm_node_t **np;
+	inet_lpm_node_t **pp;
+	errno_t rc;
+
+	rc = inet_lpm_locate(lpm, naddr, &np, &pp);
+	if (rc != EOK)
+		return rc;
+
+	*rarg = (*np)->arg;
+	return EOK;
+}
+
+/** Determine whether two networks have the same prefix.
+ *
+ * Host bits past the prefix length are ignored, so 10.0.0.1/24 and
+ * 10.0.0.2/24 are the same network.
+ *
+ * @param a First network
+ * @param b Second network
+ * @return @c true if @a a and @a b denote the same network
+ */
+bool inet_lpm_same(inet_naddr_t *a, inet_naddr_t *b)
+{
+	uint8_t akey[INET_LPM_BITS_MAX / 8];
+	uint8_t bkey[INET_LPM_BITS_MAX / 8];
+	addr32_t av4, bv4;
+	addr128_t av6, bv6;
+	uint8_t abits, bbits;
+	ip_ver_t aver, bver;
+
+	aver = inet_naddr_get(a, &av4, &av6, &abits);
+	bver = inet_naddr_get(b, &bv4, &bv6, &bbits);
+	if (aver != bver || abits != bbits)
+		return false;
+
+	if (aver != ip_v4 && aver != ip_v6)
+		return false;
+
+	if (abits > inet_lpm_key(aver, av4, av6, akey))
+		return false;
+
+	(void) inet_lpm_key(bver, bv4, bv6, bkey);
+	inet_lpm_mask(akey, abits);
+	inet_lpm_mask(bkey, bbits);
+
+	return memcmp(akey, bkey, sizeof(akey)) == 0;
+}
+
+/** Find longest prefix matching address.
+ *
+ * @param lpm  LPM table
+ * @param addr Address
+ * @param rarg Place to store argument of the most specific network
+ *             containing @a addr
+ *
+ * @return EOK on success, ENOENT if no network contains @a addr
+ */
+errno_t inet_lpm_find(inet_lpm_t *lpm, inet_addr_t *addr, void **rarg)
+{
+	uint8_t key[INET_LPM_BITS_MAX / 8];
+	inet_lpm_node_t **np;
+	inet_lpm_node_t *node;
+	inet_lpm_node_t *best;
+	addr32_t v4;
+	addr128_t v6;
+	unsigned maxbits;
+	ip_ver_t ver;
+
+	ver = inet_addr_get(addr, &v4, &v6);
+	np = inet_lpm_root(lpm, ver);
+	if (np == NULL)
+		return ENOENT;
+
+	maxbits = inet_lpm_key(ver, v4, v6, key);
+
+	best = NULL;
+	node = *np;
+	while (node != NULL) {
+		if (inet_lpm_common(node->key, key, node->bits) < node->bits)
+			break;
+
+		if (node->used)
+			best = node;
+
+		if (node->bits >= maxbits)
+			break;
+
+		node = node->child[inet_lpm_bit(key, node->bits)];
+	}
+
+	if (best == NULL)
+		return ENOENT;
+
+	*rarg = best->arg;
+	return EOK;
+}
+
+/** @}
+ */
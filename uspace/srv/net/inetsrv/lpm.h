@@ -0,0 +1,88 @@
+/*
+ * Copyright (c) 2019 Jiri Svoboda
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * - Redistributions of source code must retain the above copyright
+ *   notice, this list of conditions and the following disclaimer.
+ * - Redistributions in binary form must reproduce the above copyright
+ *   notice, this list of conditions and the following disclaimer in the
+ *   documentation and/or other materials provided with the distribution.
+ * - The name of the author may not be used to endorse or promote products
+ *   derived from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHOR ``AS IS'' AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+ * OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+ * IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT
+ * NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF
+ * THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/** @addtogroup inet
+ * @{
+ */
+/**
+ * @file Longest-prefix-match table
+ */
+
+#ifndef INET_LPM_H_
+#define INET_LPM_H_
+
+#include <errno.h>
+#include <inet/addr.h>
+#include <stdbool.h>
+#include <stdint.h>
+
+/** Maximum key length in bits */
+#define INET_LPM_BITS_MAX  128
+
+/** Longest-prefix-match trie node */
+typedef struct inet_lpm_node {
+	/** Prefix, most significant bit first (first @c bits are valid) */
+	uint8_t key[INET_LPM_BITS_MAX / 8];
+	/** Prefix length in bits */
+	uint8_t bits;
+	/** @c true if a network is stored at this node */
+	bool used;
+	/** Argument stored with the network */
+	void *arg;
+	/** Subtrees for the next bit being 0 or 1 */
+	struct inet_lpm_node *child[2];
+} inet_lpm_node_t;
+
+/** Longest-prefix-match table.
+ *
+ * Maps networks (address prefixes) to arguments. Each address family
+ * has its own path-compressed binary trie, so a lookup visits at most
+ * as many nodes as there are distinct prefix lengths on the path to the
+ * address, independent of the number of networks stored.
+ */
+typedef struct {
+	/** Root of IPv4 trie */
+	inet_lpm_node_t *root4;
+	/** Root of IPv6 trie */
+	inet_lpm_node_t *root6;
+	/** Number of networks in the table */
+	size_t count;
+} inet_lpm_t;
+
+extern void inet_lpm_init(inet_lpm_t *);
+extern void inet_lpm_fini(inet_lpm_t *);
+extern errno_t inet_lpm_insert(inet_lpm_t *, inet_naddr_t *, void *);
+extern errno_t inet_lpm_remove(inet_lpm_t *, inet_naddr_t *);
+extern errno_t inet_lpm_find_exact(inet_lpm_t *, inet_naddr_t *, void **);
+extern bool inet_lpm_same(inet_naddr_t *, inet_naddr_t *);
+extern errno_t inet_lpm_find(inet_lpm_t *, inet_addr_t *, void **);
+
+#endif
+
+/** @}
+ */
@@ -44,9 +44,6 @@
 #include "inet_link.h"
 #include "ndp.h"
 
-/** Time to wait for NDP reply in microseconds */
-#define NDP_REQUEST_TIMEOUT  (3 * 1000 * 1000)
-
 static addr128_t solicited_node_ip =
     { 0xff, 0x02, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0x01, 0xff, 0, 0, 0 };
 
@@ -106,7 +103,7 @@ errno_t ndp_received(inet_dgram_t *dgram)
 	case ICMPV6_NEIGHBOUR_SOLICITATION:
 		laddr = inet_addrobj_find(&target, iaf_addr);
 		if (laddr != NULL) {
-			rc = ntrans_add(packet.sender_proto_addr,
+			rc = ntrans_add(laddr->ilink, packet.sender_proto_addr,
 			    packet.sender_hw_addr);
 			if (rc != EOK)
 				return rc;
@@ -126,8 +123,8 @@ errno_t ndp_received(inet_dgram_t *dgram)
 	case ICMPV6_NEIGHBOUR_ADVERTISEMENT:
 		laddr = inet_addrobj_find(&dgram->dest, iaf_addr);
 		if (laddr != NULL)
-			return ntrans_add(packet.sender_proto_addr,
-			    packet.sender_hw_addr);
+			return ntrans_add(laddr->ilink,
+			    packet.sender_proto_addr, packet.sender_hw_addr);
 
 		break;
 	case ICMPV6_ROUTER_ADVERTISEMENT:
@@ -140,18 +137,25 @@ errno_t ndp_received(inet_dgram_t *dgram)
 }
 
 /** Translate IPv6 to MAC address
+ *
+ * If the address is not in the neighbour cache, a neighbour solicitation
+ * is sent and @a pkt (if not @c NULL) is queued until the neighbour
+ * advertisement arrives.
  *
  * @param src  Source IPv6 address
  * @param dest Destination IPv6 address
  * @param mac  Target MAC address to be assigned
  * @param link Network interface
+ * @param pkt  Packet to queue or @c NULL
  *
  * @return EOK on success
+ * @return EINPROGRESS if @a pkt was queued
+ * @return EAGAIN if @a pkt is @c NULL and the address is not resolved
  * @return ENOENT when NDP translation failed
  *
  */
 errno_t ndp_translate(addr128_t src_addr, addr128_t ip_addr, addr48_t mac_addr,
-    inet_link_t *ilink)
+    inet_link_t *ilink, ndp_pkt_t *pkt)
 {
 	if (!ilink->mac_valid) {
 		/* The link does not support NDP */
@@ -159,10 +163,20 @@ errno_t ndp_translate(addr128_t src_addr, addr128_t ip_addr, addr48_t mac_addr,
 		return EOK;
 	}
 
-	errno_t rc = ntrans_lookup(ip_addr, mac_addr);
-	if (rc == EOK)
-		return EOK;
+	return ntrans_resolve(ilink, src_addr, ip_addr, pkt, mac_addr);
+}
 
+/** Send neighbour solicitation
+ *
+ * @param ilink    Network interface
+ * @param src_addr Source IPv6 address
+ * @param ip_addr  IPv6 address to be resolved
+ *
+ * @return EOK on success or an error code
+ *
+ */
+errno_t ndp_solicit(inet_link_t *ilink, addr128_t src_addr, addr128_t ip_addr)
+{
 	ndp_packet_t packet;
 
 	packet.opcode = ICMPV6_NEIGHBOUR_SOLICITATION;
@@ -172,11 +186,63 @@ errno_t ndp_translate(addr128_t src_addr, addr128_t ip_addr, addr48_t mac_addr,
 	addr48_solicited_node(ip_addr, packet.target_hw_addr);
 	ndp_solicited_node_ip(ip_addr, packet.target_proto_addr);
 
-	rc = ndp_send_packet(ilink, &packet);
-	if (rc != EOK)
-		return rc;
+	return ndp_send_packet(ilink, &packet);
+}
 
-	(void) ntrans_wait_timeout(NDP_REQUEST_TIMEOUT);
+/** Create copy of outgoing datagram for queueing
+ *
+ * @param dgram Datagram
+ * @param proto Protocol
+ * @param ttl   Hop limit
+ * @param df    Do not fragment
+ *
+ * @return New packet or NULL if out of memory
+ *
+ */
+ndp_pkt_t *ndp_pkt_create(inet_dgram_t *dgram, uint8_t proto, uint8_t ttl,
+    int df)
+{
+	ndp_pkt_t *pkt;
+
+	pkt = calloc(1, sizeof(ndp_pkt_t));
+	if (pkt == NULL)
+		return NULL;
+
+	pkt->dgram = *dgram;
+	pkt->dgram.data = malloc(dgram->size);
+	if (pkt->dgram.data == NULL) {
+		free(pkt);
+		return NULL;
+	}
+
+	memcpy(pkt->dgram.data, dgram->data, dgram->size);
+	pkt->proto = proto;
+	pkt->ttl = ttl;
+	pkt->df = df;
+	return pkt;
+}
+
+/** Delete queued datagram
+ *
+ * @param pkt Packet
+ *
+ */
+void ndp_pkt_delete(ndp_pkt_t *pkt)
+{
+	free(pkt->dgram.data);
+	free(pkt);
+}
 
-	return ntrans_lookup(ip_addr, mac_addr);
+/** Transmit queued datagram once its destination is resolved
+ *
+ * @param ilink    Network interface
+ * @param pkt      Packet, deleted by this function
+ * @param mac_addr Destination MAC address
+ *
+ */
+void ndp_pkt_xmit(inet_link_t *ilink, ndp_pkt_t *pkt, addr48_t mac_addr)
+{
+	(void) inet_link_send_dgram6(ilink, mac_addr, &pkt->dgram, pkt->proto,
+	    pkt->ttl, pkt->df);
+	ndp_pkt_delete(pkt);
 }
@@ -62,7 +62,24 @@ typedef struct {
 	addr128_t solicited_ip;
 } ndp_packet_t;
 
+/** Outgoing IPv6 datagram waiting for neighbour resolution */
+typedef struct {
+	/** Datagram (with its own copy of the data) */
+	inet_dgram_t dgram;
+	/** Protocol */
+	uint8_t proto;
+	/** Hop limit */
+	uint8_t ttl;
+	/** Do not fragment */
+	int df;
+} ndp_pkt_t;
+
 extern errno_t ndp_received(inet_dgram_t *);
-extern errno_t ndp_translate(addr128_t, addr128_t, addr48_t, inet_link_t *);
+extern errno_t ndp_translate(addr128_t, addr128_t, addr48_t, inet_link_t *,
+    ndp_pkt_t *);
+extern errno_t ndp_solicit(inet_link_t *, addr128_t, addr128_t);
+extern ndp_pkt_t *ndp_pkt_create(inet_dgram_t *, uint8_t, uint8_t, int);
+extern void ndp_pkt_xmit(inet_link_t *, ndp_pkt_t *, addr48_t);
+extern void ndp_pkt_delete(ndp_pkt_t *);
 
 #endif
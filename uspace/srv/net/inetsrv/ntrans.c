@@ -34,37 +34,78 @@
  * @brief
  */
 
-#include <adt/list.h>
 #include <errno.h>
-#include <fibril_synch.h>
-#include <inet/iplink_srv.h>
-#include <stdlib.h>
+#include <inet/addr.h>
+#include <nettl/ncache.h>
+#include "ndp.h"
 #include "ntrans.h"
 
-/** Address translation list (of inet_ntrans_t) */
-static FIBRIL_MUTEX_INITIALIZE(ntrans_list_lock);
-static LIST_INITIALIZE(ntrans_list);
-static FIBRIL_CONDVAR_INITIALIZE(ntrans_cv);
+static errno_t ntrans_solicit(void *, inet_addr_t *, inet_addr_t *);
+static void ntrans_xmit(void *, void *, addr48_t);
+static void ntrans_discard(void *, void *);
 
-/** Look for address in translation table
+/** Neighbour cache callbacks */
+static ncache_ops_t ntrans_ops = {
+	.solicit = ntrans_solicit,
+	.xmit = ntrans_xmit,
+	.discard = ntrans_discard
+};
+
+/** Send neighbour solicitation on behalf of the neighbour cache. */
+static errno_t ntrans_solicit(void *arg, inet_addr_t *src, inet_addr_t *addr)
+{
+	inet_link_t *ilink = (inet_link_t *) arg;
+	addr128_t src_v6;
+	addr128_t addr_v6;
+
+	if (inet_addr_get(src, NULL, &src_v6) != ip_v6 ||
+	    inet_addr_get(addr, NULL, &addr_v6) != ip_v6)
+		return EINVAL;
+
+	return ndp_solicit(ilink, src_v6, addr_v6);
+}
+
+/** Transmit packet that was waiting for address resolution. */
+static void ntrans_xmit(void *arg, void *pkt, addr48_t mac_addr)
+{
+	ndp_pkt_xmit((inet_link_t *) arg, (ndp_pkt_t *) pkt, mac_addr);
+}
+
+/** Discard packet that was waiting for address resolution. */
+static void ntrans_discard(void *arg, void *pkt)
+{
+	ndp_pkt_delete((ndp_pkt_t *) pkt);
+}
+
+/** Create neighbour cache of a link
  *
- * @param ip_addr IPv6 address
+ * @param ilink Link
+ *
+ * @return EOK on success
+ * @return ENOMEM if not enough memory
  *
- * @return inet_ntrans_t with the address on success
- * @return NULL if nothing found
  */
-static inet_ntrans_t *ntrans_find(addr128_t ip_addr)
+errno_t ntrans_init(inet_link_t *ilink)
 {
-	list_foreach(ntrans_list, ntrans_list, inet_ntrans_t, ntrans) {
-		if (addr128_compare(ntrans->ip_addr, ip_addr))
-			return ntrans;
-	}
+	return ncache_create(&ntrans_ops, ilink, &ilink->ntrans);
+}
 
-	return NULL;
+/** Destroy neighbour cache of a link
+ *
+ * @param ilink Link
+ *
+ */
+void ntrans_fini(inet_link_t *ilink)
+{
+	if (ilink->ntrans != NULL)
+		ncache_destroy(ilink->ntrans);
 }
 
 /** Add entry to translation table
  *
+ * Packets waiting for the address are transmitted.
+ *
+ * @param ilink    Link
  * @param ip_addr  IPv6 address of the new entry
  * @param mac_addr MAC address of the new entry
  *
@@ -72,97 +113,68 @@ static inet_ntrans_t *ntrans_find(addr128_t ip_addr)
  * @return ENOMEM if not enough memory
  *
  */
-errno_t ntrans_add(addr128_t ip_addr, addr48_t mac_addr)
+errno_t ntrans_add(inet_link_t *ilink, addr128_t ip_addr, addr48_t mac_addr)
 {
-	inet_ntrans_t *ntrans;
-	inet_ntrans_t *prev;
-
-	ntrans = calloc(1, sizeof(inet_ntrans_t));
-	if (ntrans == NULL)
-		return ENOMEM;
-
-	addr128(ip_addr, ntrans->ip_addr);
-	addr48(mac_addr, ntrans->mac_addr);
-
-	fibril_mutex_lock(&ntrans_list_lock);
-	prev = ntrans_find(ip_addr);
-	if (prev != NULL) {
-		list_remove(&prev->ntrans_list);
-		free(prev);
-	}
+	inet_addr_t addr;
 
-	list_append(&ntrans->ntrans_list, &ntrans_list);
-	fibril_mutex_unlock(&ntrans_list_lock);
-	fibril_condvar_broadcast(&ntrans_cv);
-
-	return EOK;
+	inet_addr_set6(ip_addr, &addr);
+	return ncache_add(ilink->ntrans, &addr, mac_addr);
 }
 
 /** Remove entry from translation table
  *
+ * @param ilink   Link
  * @param ip_addr IPv6 address of the entry to be removed
  *
  * @return EOK on success
  * @return ENOENT when no such address found
  *
  */
-errno_t ntrans_remove(addr128_t ip_addr)
+errno_t ntrans_remove(inet_link_t *ilink, addr128_t ip_addr)
 {
-	inet_ntrans_t *ntrans;
-
-	fibril_mutex_lock(&ntrans_list_lock);
-	ntrans = ntrans_find(ip_addr);
-	if (ntrans == NULL) {
-		fibril_mutex_unlock(&ntrans_list_lock);
-		return ENOENT;
-	}
+	inet_addr_t addr;
 
-	list_remove(&ntrans->ntrans_list);
-	fibril_mutex_unlock(&ntrans_list_lock);
-	free(ntrans);
-
-	return EOK;
+	inet_addr_set6(ip_addr, &addr);
+	return ncache_remove(ilink->ntrans, &addr);
 }
 
 /** Translate IPv6 address to MAC address using the translation table
  *
+ * If the address is not known, a neighbour solicitation is sent and
+ * @a pkt (if not @c NULL) is queued until the advertisement arrives.
+ *
+ * @param ilink    Link
+ * @param src_addr Source IPv6 address for solicitations
  * @param ip_addr  IPv6 address to be translated
+ * @param pkt      Packet to queue or @c NULL
  * @param mac_addr MAC address to be assigned
  *
  * @return EOK on success
- * @return ENOENT when no such address found
+ * @return EINPROGRESS if @a pkt was queued
+ * @return EAGAIN if @a pkt is @c NULL and the address is not resolved
+ * @return ENOENT when the address could not be resolved recently
  *
  */
-errno_t ntrans_lookup(addr128_t ip_addr, addr48_t mac_addr)
+errno_t ntrans_resolve(inet_link_t *ilink, addr128_t src_addr,
+    addr128_t ip_addr, ndp_pkt_t *pkt, addr48_t mac_addr)
 {
-	fibril_mutex_lock(&ntrans_list_lock);
-	inet_ntrans_t *ntrans = ntrans_find(ip_addr);
-	if (ntrans == NULL) {
-		fibril_mutex_unlock(&ntrans_list_lock);
-		return ENOENT;
-	}
-
-	fibril_mutex_unlock(&ntrans_list_lock);
-	addr48(ntrans->mac_addr, mac_addr);
-	return EOK;
+	inet_addr_t src;
+	inet_addr_t addr;
+
+	inet_addr_set6(src_addr, &src);
+	inet_addr_set6(ip_addr, &addr);
+	return ncache_resolve(ilink->ntrans, &src, &addr, pkt, mac_addr);
 }
 
-/** Wait on translation table CV for some time
+/** Get neighbour cache statistics
  *
- * @param timeout Timeout in microseconds
- *
- * @return EOK if woken up by another fibril
- * @return ETIMEOUT if timed out
+ * @param ilink Link
+ * @param stats Place to store statistics
  *
  */
-errno_t ntrans_wait_timeout(usec_t timeout)
+void ntrans_get_stats(inet_link_t *ilink, inet_nstats_t *stats)
 {
-	fibril_mutex_lock(&ntrans_list_lock);
-	errno_t rc = fibril_condvar_wait_timeout(&ntrans_cv, &ntrans_list_lock,
-	    timeout);
-	fibril_mutex_unlock(&ntrans_list_lock);
-
-	return rc;
+	ncache_get_stats(ilink->ntrans, stats);
 }
 
 /** @}
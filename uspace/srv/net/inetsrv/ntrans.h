@@ -37,20 +37,18 @@
 #ifndef NTRANS_H_
 #define NTRANS_H_
 
-#include <inet/iplink_srv.h>
 #include <inet/addr.h>
+#include <types/inet/nstats.h>
+#include "inetsrv.h"
+#include "ndp.h"
 
-/** Address translation table element */
-typedef struct {
-	link_t ntrans_list;
-	addr128_t ip_addr;
-	addr48_t mac_addr;
-} inet_ntrans_t;
-
-extern errno_t ntrans_add(addr128_t, addr48_t);
-extern errno_t ntrans_remove(addr128_t);
-extern errno_t ntrans_lookup(addr128_t, addr48_t);
-extern errno_t ntrans_wait_timeout(usec_t);
+extern errno_t ntrans_init(inet_link_t *);
+extern void ntrans_fini(inet_link_t *);
+extern errno_t ntrans_add(inet_link_t *, addr128_t, addr48_t);
+extern errno_t ntrans_remove(inet_link_t *, addr128_t);
+extern errno_t ntrans_resolve(inet_link_t *, addr128_t, addr128_t, ndp_pkt_t *,
+    addr48_t);
+extern void ntrans_get_stats(inet_link_t *, inet_nstats_t *);
 
 #endif
 
@@ -35,6 +35,7 @@
  */
 
 #include <align.h>
+#include <adt/checksum.h>
 #include <bitops.h>
 #include <byteorder.h>
 #include <errno.h>
@@ -47,40 +48,9 @@
 #include "inet_std.h"
 #include "pdu.h"
 
-/** One's complement addition.
- *
- * Result is a + b + carry.
- */
-static uint16_t inet_ocadd16(uint16_t a, uint16_t b)
-{
-	uint32_t s;
-
-	s = (uint32_t)a + (uint32_t)b;
-	return (s & 0xffff) + (s >> 16);
-}
-
 uint16_t inet_checksum_calc(uint16_t ivalue, void *data, size_t size)
 {
-	uint16_t sum;
-	uint16_t w;
-	size_t words, i;
-	uint8_t *bdata;
-
-	sum = ~ivalue;
-	words = size / 2;
-	bdata = (uint8_t *)data;
-
-	for (i = 0; i < words; i++) {
-		w = ((uint16_t)bdata[2 * i] << 8) | bdata[2 * i + 1];
-		sum = inet_ocadd16(sum, w);
-	}
-
-	if (size % 2 != 0) {
-		w = ((uint16_t)bdata[2 * words] << 8);
-		sum = inet_ocadd16(sum, w);
-	}
-
-	return ~sum;
+	return ~compute_ocsum(data, size, ~ivalue);
 }
 
 /** Encode IPv4 PDU.
@@ -300,11 +270,11 @@ errno_t inet_pdu_encode6(inet_packet_t *packet, addr128_t src, addr128_t dest,
  * @param data    Serialized IPv4 datagram
  * @param size    Length of serialized IPv4 datagram
  * @param link_id Link on which PDU was received
- * @param packet  IP datagram structure to be filled
+ * @param packet  IP datagram structure to be filled. The payload is not
+ *                copied, it points into @a data.
  *
  * @return EOK on success
  * @return EINVAL if the datagram is invalid or damaged
- * @return ENOMEM if not enough memory
  *
  */
 errno_t inet_pdu_decode(void *data, size_t size, service_id_t link_id,
@@ -360,13 +330,7 @@ errno_t inet_pdu_decode(void *data, size_t size, service_id_t link_id,
 	    BIT_RANGE_EXTRACT(uint8_t, VI_IHL_h, VI_IHL_l, hdr->ver_ihl);
 
 	packet->size = tot_len - data_offs;
-	packet->data = calloc(packet->size, 1);
-	if (packet->data == NULL) {
-		log_msg(LOG_DEFAULT, LVL_WARN, "Out of memory.");
-		return ENOMEM;
-	}
-
-	memcpy(packet->data, (uint8_t *) data + data_offs, packet->size);
+	packet->data = (uint8_t *) data + data_offs;
 	packet->link_id = link_id;
 
 	return EOK;
@@ -377,11 +341,11 @@ errno_t inet_pdu_decode(void *data, size_t size, service_id_t link_id,
  * @param data    Serialized IPv6 datagram
  * @param size    Length of serialized IPv6 datagram
  * @param link_id Link on which PDU was received
- * @param packet  IP datagram structure to be filled
+ * @param packet  IP datagram structure to be filled. The payload is not
+ *                copied, it points into @a data.
  *
  * @return EOK on success
  * @return EINVAL if the datagram is invalid or damaged
- * @return ENOMEM if not enough memory
  *
  */
 errno_t inet_pdu_decode6(void *data, size_t size, service_id_t link_id,
@@ -454,13 +418,7 @@ errno_t inet_pdu_decode6(void *data, size_t size, service_id_t link_id,
 	packet->offs = foff * FRAG_OFFS_UNIT;
 
 	packet->size = payload_len;
-	packet->data = calloc(packet->size, 1);
-	if (packet->data == NULL) {
-		log_msg(LOG_DEFAULT, LVL_WARN, "Out of memory.");
-		return ENOMEM;
-	}
-
-	memcpy(packet->data, (uint8_t *) data + data_offs, packet->size);
+	packet->data = (uint8_t *) data + data_offs;
 	packet->link_id = link_id;
 	return EOK;
 }
@@ -478,6 +436,7 @@ errno_t ndp_pdu_encode(ndp_packet_t *ndp, inet_dgram_t *dgram)
 	inet_addr_set6(ndp->sender_proto_addr, &dgram->src);
 	inet_addr_set6(ndp->target_proto_addr, &dgram->dest);
 	dgram->tos = 0;
+	dgram->csum_offs = 0;
 	dgram->size = sizeof(icmpv6_message_t) + sizeof(ndp_message_t);
 
 	dgram->data = calloc(1, dgram->size);
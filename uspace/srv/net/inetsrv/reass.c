@@ -332,6 +332,7 @@ static errno_t reass_dgram_deliver(reass_dgram_t *rdg)
 	dgram.src = frag->packet.src;
 	dgram.dest = frag->packet.dest;
 	dgram.tos = frag->packet.tos;
+	dgram.csum_offs = 0;
 	proto = frag->packet.proto;
 
 	/* Pull together data from individual fragments */
@@ -44,11 +44,59 @@
 #include "sroute.h"
 #include "inetsrv.h"
 #include "inet_link.h"
+#include "lpm.h"
+
+/** Base-two logarithm of the number of entries in the route cache */
+#define SROUTE_CACHE_BITS  6
+/** Number of entries in the route cache */
+#define SROUTE_CACHE_SIZE  (1 << SROUTE_CACHE_BITS)
+
+/** Route cache entry */
+typedef struct {
+	/** Routing table generation the entry is valid for */
+	uint64_t gen;
+	/** Destination address */
+	inet_addr_t addr;
+	/** Route to @c addr or @c NULL if there is none */
+	inet_sroute_t *sroute;
+} inet_sroute_cache_t;
 
 static FIBRIL_MUTEX_INITIALIZE(sroute_list_lock);
 static LIST_INITIALIZE(sroute_list);
 static sysarg_t sroute_id = 0;
 
+/** Longest-prefix-match table, maps destination to first route in list */
+static inet_lpm_t sroute_lpm;
+static bool sroute_lpm_init = false;
+
+/** Routing table generation, bumped whenever a route is added or removed */
+static uint64_t sroute_gen = 1;
+static inet_sroute_cache_t sroute_cache[SROUTE_CACHE_SIZE];
+
+/** Compute route cache slot for destination address. */
+static size_t inet_sroute_cache_slot(inet_addr_t *addr)
+{
+	addr32_t v4;
+	addr128_t v6;
+	uint32_t hash;
+	size_t i;
+
+	if (inet_addr_get(addr, &v4, &v6) == ip_v6) {
+		hash = 0;
+		for (i = 0; i < 16; i += 4) {
+			hash ^= ((uint32_t) v6[i] << 24) |
+			    ((uint32_t) v6[i + 1] << 16) |
+			    ((uint32_t) v6[i + 2] << 8) | v6[i + 3];
+		}
+	} else {
+		hash = v4;
+	}
+
+	/* Fibonacci hashing */
+	hash *= 0x9e3779b9;
+	return hash >> (32 - SROUTE_CACHE_BITS);
+}
+
 inet_sroute_t *inet_sroute_new(void)
 {
 	inet_sroute_t *sroute = calloc(1, sizeof(inet_sroute_t));
@@ -74,17 +122,70 @@ void inet_sroute_delete(inet_sroute_t *sroute)
 	free(sroute);
 }
 
-void inet_sroute_add(inet_sroute_t *sroute)
+/** Add static route.
+ *
+ * If there already is a route with the same destination, the new route
+ * only takes effect once the existing one is removed.
+ *
+ * @param sroute Static route
+ * @return EOK on success, ENOMEM if out of memory
+ */
+errno_t inet_sroute_add(inet_sroute_t *sroute)
 {
+	errno_t rc;
+
 	fibril_mutex_lock(&sroute_list_lock);
+
+	if (!sroute_lpm_init) {
+		inet_lpm_init(&sroute_lpm);
+		sroute_lpm_init = true;
+	}
+
+	rc = inet_lpm_insert(&sroute_lpm, &sroute->dest, sroute);
+	if (rc != EOK && rc != EEXIST) {
+		fibril_mutex_unlock(&sroute_list_lock);
+		return rc;
+	}
+
 	list_append(&sroute->sroute_list, &sroute_list);
+	++sroute_gen;
 	fibril_mutex_unlock(&sroute_list_lock);
+
+	return EOK;
 }
 
+/** Remove static route.
+ *
+ * @param sroute Static route
+ */
 void inet_sroute_remove(inet_sroute_t *sroute)
 {
+	void *arg;
+	errno_t rc;
+
 	fibril_mutex_lock(&sroute_list_lock);
 	list_remove(&sroute->sroute_list);
+
+	rc = inet_lpm_find_exact(&sroute_lpm, &sroute->dest, &arg);
+	if (rc == EOK && arg == sroute) {
+		(void) inet_lpm_remove(&sroute_lpm, &sroute->dest);
+
+		/* Let the next route with the same destination take over */
+		list_foreach(sroute_list, sroute_list, inet_sroute_t, other) {
+			if (inet_lpm_same(&other->dest, &sroute->dest)) {
+				rc = inet_lpm_insert(&sroute_lpm, &other->dest,
+				    other);
+				if (rc != EOK) {
+					log_msg(LOG_DEFAULT, LVL_ERROR,
+					    "Failed re-inserting route %p.",
+					    other);
+				}
+				break;
+			}
+		}
+	}
+
+	++sroute_gen;
 	fibril_mutex_unlock(&sroute_list_lock);
 }
 
@@ -94,37 +195,32 @@ void inet_sroute_remove(inet_sroute_t *sroute)
  */
 inet_sroute_t *inet_sroute_find(inet_addr_t *addr)
 {
-	ip_ver_t addr_ver = inet_addr_get(addr, NULL, NULL);
-
-	inet_sroute_t *best = NULL;
-	uint8_t best_bits = 0;
+	inet_sroute_cache_t *ce;
+	inet_sroute_t *best;
+	void *arg;
 
 	fibril_mutex_lock(&sroute_list_lock);
 
-	list_foreach(sroute_list, sroute_list, inet_sroute_t, sroute) {
-		uint8_t dest_bits;
-		ip_ver_t dest_ver = inet_naddr_get(&sroute->dest, NULL, NULL,
-		    &dest_bits);
-
-		/* Skip comparison with different address family */
-		if (addr_ver != dest_ver)
-			continue;
-
-		/* Look for the most specific route */
-		if ((best != NULL) && (best_bits >= dest_bits))
-			continue;
-
-		if (inet_naddr_compare_mask(&sroute->dest, addr)) {
-			log_msg(LOG_DEFAULT, LVL_DEBUG, "inet_sroute_find: found candidate %p",
-			    sroute);
-
-			best = sroute;
-			best_bits = dest_bits;
-		}
+	ce = &sroute_cache[inet_sroute_cache_slot(addr)];
+	if (ce->gen == sroute_gen && inet_addr_compare(&ce->addr, addr)) {
+		best = ce->sroute;
+		fibril_mutex_unlock(&sroute_list_lock);
+		return best;
 	}
 
-	if (best == NULL)
+	best = NULL;
+	if (sroute_lpm_init && inet_lpm_find(&sroute_lpm, addr, &arg) == EOK) {
+		best = (inet_sroute_t *) arg;
+		log_msg(LOG_DEFAULT, LVL_DEBUG, "inet_sroute_find: found %p",
+		    best);
+	} else {
 		log_msg(LOG_DEFAULT, LVL_DEBUG, "inet_sroute_find: Not found");
+	}
+
+	/* Negative results are cached as well */
+	ce->gen = sroute_gen;
+	ce->addr = *addr;
+	ce->sroute = best;
 
 	fibril_mutex_unlock(&sroute_list_lock);
 
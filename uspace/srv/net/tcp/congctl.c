@@ -0,0 +1,246 @@
+/*
+ * Copyright (c) 2019 Jiri Svoboda
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * - Redistributions of source code must retain the above copyright
+ *   notice, this list of conditions and the following disclaimer.
+ * - Redistributions in binary form must reproduce the above copyright
+ *   notice, this list of conditions and the following disclaimer in the
+ *   documentation and/or other materials provided with the distribution.
+ * - The name of the author may not be used to endorse or promote products
+ *   derived from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHOR ``AS IS'' AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+ * OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+ * IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT
+ * NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF
+ * THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/** @addtogroup tcp
+ * @{
+ */
+
+/**
+ * @file Congestion control
+ *
+ * Generic part of congestion control: initial window, fast retransmit
+ * and fast recovery (RFC 5681, RFC 6582) and reaction to retransmission
+ * timeout. Window growth and reduction is delegated to a pluggable
+ * algorithm (see tcp_cc_ops_t).
+ *
+ * Without SACK the congestion window is inflated by each duplicate ACK
+ * during recovery (NewReno). With SACK the number of bytes in flight
+ * already accounts for segments that left the network and the window
+ * is not inflated (RFC 6675).
+ */
+
+#include <macros.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <str.h>
+#include "congctl.h"
+#include "cubic.h"
+#include "newreno.h"
+#include "tcp_type.h"
+
+/** Number of duplicate ACKs that trigger fast retransmit */
+#define DUPACK_THRESH	3
+
+/** Upper bound on the congestion window */
+#define CWND_MAX	(UINT32_MAX / 2)
+
+/** Available congestion control algorithms */
+static const tcp_cc_ops_t *tcp_cc_algs[] = {
+	&tcp_cc_newreno,
+	&tcp_cc_cubic,
+	NULL
+};
+
+/** Algorithm used by new connections */
+const tcp_cc_ops_t *tcp_cc_default = &tcp_cc_newreno;
+
+/** Find congestion control algorithm by name.
+ *
+ * @param name Algorithm name
+ * @return Algorithm or @c NULL if not found
+ */
+const tcp_cc_ops_t *tcp_cc_find(const char *name)
+{
+	const tcp_cc_ops_t **alg;
+
+	for (alg = tcp_cc_algs; *alg != NULL; alg++) {
+		if (str_cmp((*alg)->name, name) == 0)
+			return *alg;
+	}
+
+	return NULL;
+}
+
+/** Compute initial window (RFC 5681 3.1).
+ *
+ * @param mss Sender maximum segment size
+ * @return Initial congestion window in bytes
+ */
+static uint32_t tcp_cc_initial_window(uint16_t mss)
+{
+	if (mss > 2190)
+		return 2 * mss;
+	if (mss > 1095)
+		return 3 * mss;
+	return 4 * mss;
+}
+
+/** Initialize congestion control state.
+ *
+ * Can be called again once the maximum segment size is known.
+ * If no algorithm has been selected, the default one is used.
+ *
+ * @param conn Connection
+ */
+void tcp_cc_init(tcp_conn_t *conn)
+{
+	tcp_cc_t *cc = &conn->cc;
+
+	if (cc->ops == NULL)
+		cc->ops = tcp_cc_default;
+
+	cc->cwnd = tcp_cc_initial_window(conn->snd_mss);
+	cc->ssthresh = UINT32_MAX;
+	cc->dupacks = 0;
+	cc->in_recovery = false;
+	cc->recover = conn->snd_una;
+
+	cc->ops->init(conn);
+}
+
+/** Return amount of data sent, but not yet cumulatively acknowledged.
+ *
+ * @param conn Connection
+ * @return Flight size in bytes
+ */
+uint32_t tcp_cc_flight_size(tcp_conn_t *conn)
+{
+	return conn->snd_nxt - conn->snd_una;
+}
+
+/** Increase congestion window.
+ *
+ * @param conn Connection
+ * @param incr Number of bytes to add
+ */
+void tcp_cc_cwnd_inc(tcp_conn_t *conn, uint64_t incr)
+{
+	conn->cc.cwnd = min((uint64_t) conn->cc.cwnd + incr, CWND_MAX);
+}
+
+/** New data has been acknowledged.
+ *
+ * @param conn  Connection (SND.UNA already updated)
+ * @param acked Number of newly acknowledged bytes
+ * @return @c true if this is a partial acknowledgement during recovery
+ *         and the first unacknowledged segment should be retransmitted
+ */
+bool tcp_cc_ack(tcp_conn_t *conn, uint32_t acked)
+{
+	tcp_cc_t *cc = &conn->cc;
+	uint32_t mss = conn->snd_mss;
+
+	cc->dupacks = 0;
+
+	if (!cc->in_recovery) {
+		cc->ops->cong_avoid(conn, acked);
+		return false;
+	}
+
+	if ((int32_t) (conn->snd_una - cc->recover) >= 0) {
+		/* Full acknowledgement, deflate window (RFC 6582 3.2 step 3) */
+		cc->in_recovery = false;
+		cc->cwnd = min(cc->ssthresh,
+		    max(tcp_cc_flight_size(conn), mss) + mss);
+		return false;
+	}
+
+	/* Partial acknowledgement (RFC 6582 3.2 step 4) */
+	if (!conn->sack_ok) {
+		cc->cwnd = cc->cwnd > acked ? cc->cwnd - acked : 0;
+		if (acked >= mss)
+			cc->cwnd += mss;
+		cc->cwnd = max(cc->cwnd, mss);
+	}
+
+	return true;
+}
+
+/** Duplicate ACK has been received.
+ *
+ * @param conn Connection
+ * @return @c true if fast recovery has been entered and the first
+ *         unacknowledged segment should be retransmitted
+ */
+bool tcp_cc_dupack(tcp_conn_t *conn)
+{
+	tcp_cc_t *cc = &conn->cc;
+	uint32_t mss = conn->snd_mss;
+
+	++cc->dupacks;
+
+	if (cc->in_recovery) {
+		/* Each duplicate ACK signals a segment has left the network */
+		if (!conn->sack_ok)
+			tcp_cc_cwnd_inc(conn, mss);
+		return false;
+	}
+
+	if (cc->dupacks != DUPACK_THRESH)
+		return false;
+
+	/*
+	 * Do not start a new recovery until everything that was
+	 * outstanding at the start of the last one has been acknowledged
+	 * (RFC 6582 3.2 step 2).
+	 */
+	if ((int32_t) (conn->snd_una - cc->recover) <= 0)
+		return false;
+
+	cc->ssthresh = cc->ops->ssthresh(conn);
+	cc->cwnd = cc->ssthresh;
+	if (!conn->sack_ok)
+		tcp_cc_cwnd_inc(conn, DUPACK_THRESH * mss);
+
+	cc->recover = conn->snd_nxt;
+	cc->in_recovery = true;
+	return true;
+}
+
+/** Retransmission timer has expired.
+ *
+ * @param conn     Connection
+ * @param repeated @c true if the segment had already been retransmitted
+ *                 due to timeout (slow start threshold is kept)
+ */
+void tcp_cc_timeout(tcp_conn_t *conn, bool repeated)
+{
+	tcp_cc_t *cc = &conn->cc;
+
+	if (!repeated)
+		cc->ssthresh = cc->ops->ssthresh(conn);
+
+	cc->cwnd = conn->snd_mss;
+	cc->dupacks = 0;
+	cc->in_recovery = false;
+	cc->recover = conn->snd_nxt;
+}
+
+/**
+ * @}
+ */
@@ -39,22 +39,36 @@
 #include <inet/endpoint.h>
 #include <io/log.h>
 #include <macros.h>
+#include <mem.h>
 #include <nettl/amap.h>
 #include <stdbool.h>
 #include <stdlib.h>
+#include "congctl.h"
 #include "conn.h"
 #include "inet.h"
 #include "iqueue.h"
+#include "ncsim.h"
 #include "pdu.h"
 #include "rqueue.h"
+#include "rtt.h"
 #include "segment.h"
 #include "seq_no.h"
 #include "tcp_type.h"
 #include "tqueue.h"
 #include "ucall.h"
 
-#define RCV_BUF_SIZE 4096/*2*/
-#define SND_BUF_SIZE 4096
+/** Initial receive and send buffer sizes */
+#define RCV_BUF_SIZE 16384
+#define SND_BUF_SIZE 16384
+/** Sizes up to which the buffers can be auto-tuned */
+#define RCV_BUF_MAX (4 * 1024 * 1024)
+#define SND_BUF_MAX (4 * 1024 * 1024)
+
+/** Default send MSS if the peer does not announce one (RFC 9293 3.7.1) */
+#define TCP_MSS_DEFAULT 536
+/** Largest MSS we announce (Ethernet MTU minus IPv4/IPv6 and TCP headers) */
+#define TCP_MSS_LOCAL_V4 1460
+#define TCP_MSS_LOCAL_V6 1440
 
 #define MAX_SEGMENT_LIFETIME	(15*1000*1000) //(2*60*1000*1000)
 #define TIME_WAIT_TIMEOUT	(2*MAX_SEGMENT_LIFETIME)
@@ -105,6 +119,21 @@ void tcp_conns_fini(void)
 	amap = NULL;
 }
 
+/** Determine window scale shift count needed for a buffer size.
+ *
+ * @param size Maximum receive buffer size
+ * @return Smallest shift count that lets us advertise the entire buffer
+ */
+static uint8_t tcp_conn_wscale(size_t size)
+{
+	uint8_t shift = 0;
+
+	while (shift < TCP_WSCALE_MAX && (size >> shift) > UINT16_MAX)
+		++shift;
+
+	return shift;
+}
+
 /** Create new connection structure.
  *
  * @param epp		Endpoint pair (will be deeply copied)
@@ -133,6 +162,8 @@ tcp_conn_t *tcp_conn_new(inet_ep2_t *epp)
 	/* Allocate receive buffer */
 	fibril_condvar_initialize(&conn->rcv_buf_cv);
 	conn->rcv_buf_size = RCV_BUF_SIZE;
+	conn->rcv_buf_max = RCV_BUF_MAX;
+	conn->rcv_buf_start = 0;
 	conn->rcv_buf_used = 0;
 	conn->rcv_buf_fin = false;
 
@@ -143,6 +174,7 @@ tcp_conn_t *tcp_conn_new(inet_ep2_t *epp)
 	/** Allocate send buffer */
 	fibril_condvar_initialize(&conn->snd_buf_cv);
 	conn->snd_buf_size = SND_BUF_SIZE;
+	conn->snd_buf_max = SND_BUF_MAX;
 	conn->snd_buf_used = 0;
 	conn->snd_buf_fin = false;
 	conn->snd_buf = calloc(1, conn->snd_buf_size);
@@ -176,6 +208,22 @@ tcp_conn_t *tcp_conn_new(inet_ep2_t *epp)
 	if (epp != NULL)
 		conn->ident = *epp;
 
+	/* Until the peer tells us otherwise */
+	conn->snd_mss = TCP_MSS_DEFAULT;
+	conn->sack_perm = true;
+	conn->sack_ok = false;
+	conn->wscale_perm = true;
+	conn->wscale_ok = false;
+	conn->snd_wscale = 0;
+	conn->rcv_wscale = tcp_conn_wscale(conn->rcv_buf_max);
+	conn->ts_perm = true;
+	conn->ts_ok = false;
+	conn->ts_recent = 0;
+
+	tcp_rtt_init(&conn->rtt);
+	conn->cc.ops = NULL;
+	tcp_cc_init(conn);
+
 	fibril_mutex_lock(&conn_list_lock);
 	list_append(&conn->link, &conn_list);
 	fibril_mutex_unlock(&conn_list_lock);
@@ -511,6 +559,69 @@ bool tcp_conn_got_syn(tcp_conn_t *conn)
 	assert(false);
 }
 
+/** Determine MSS we announce to the peer.
+ *
+ * @param conn	Connection
+ * @return	Maximum segment size we are willing to receive
+ */
+uint16_t tcp_conn_local_mss(tcp_conn_t *conn)
+{
+	if (conn->ident.remote.addr.version == ip_v6)
+		return TCP_MSS_LOCAL_V6;
+
+	return TCP_MSS_LOCAL_V4;
+}
+
+/** Process options of an incoming SYN segment.
+ *
+ * Set up send MSS and SACK usage and (re)initialize congestion control
+ * since the initial window depends on the MSS.
+ *
+ * @param conn	Connection
+ * @param seg	SYN segment
+ */
+static void tcp_conn_syn_opts(tcp_conn_t *conn, tcp_segment_t *seg)
+{
+	if (seg->mss != 0)
+		conn->snd_mss = min(seg->mss, tcp_conn_local_mss(conn));
+	else
+		conn->snd_mss = TCP_MSS_DEFAULT;
+
+	conn->sack_ok = conn->sack_perm && seg->sack_perm;
+
+	/* Window scaling is only used if both sides send the option */
+	conn->wscale_ok = conn->wscale_perm && seg->has_wscale;
+	if (conn->wscale_ok) {
+		conn->snd_wscale = seg->wscale;
+	} else {
+		conn->snd_wscale = 0;
+		conn->rcv_wscale = 0;
+		/* Cannot advertise more than 64 KiB without scaling */
+		conn->rcv_buf_max = min(conn->rcv_buf_max, UINT16_MAX);
+	}
+
+	conn->ts_ok = conn->ts_perm && seg->has_ts;
+	if (conn->ts_ok)
+		conn->ts_recent = seg->tsval;
+
+	tcp_cc_init(conn);
+}
+
+/** Determine send window from incoming segment.
+ *
+ * @param conn	Connection
+ * @param seg	Segment
+ * @return	Window announced by the peer, in bytes
+ */
+static uint32_t tcp_conn_seg_wnd(tcp_conn_t *conn, tcp_segment_t *seg)
+{
+	/* Window in SYN segment is never scaled (RFC 7323 2.2) */
+	if ((seg->ctrl & CTL_SYN) != 0)
+		return seg->wnd;
+
+	return seg->wnd << conn->snd_wscale;
+}
+
 /** Segment arrived in Listen state.
  *
  * @param conn		Connection
@@ -560,6 +671,12 @@ static void tcp_conn_sa_listen(tcp_conn_t *conn, tcp_segment_t *seg)
 	conn->snd_wl1 = seg->seq;
 	conn->snd_wl2 = seg->seq;
 
+	/* Only offer options in SYN-ACK the peer has offered */
+	tcp_conn_syn_opts(conn, seg);
+	conn->sack_perm = conn->sack_ok;
+	conn->wscale_perm = conn->wscale_ok;
+	conn->ts_perm = conn->ts_ok;
+
 	tcp_conn_state_set(conn, st_syn_received);
 
 	tcp_tqueue_ctrl_seg(conn, CTL_SYN | CTL_ACK /* XXX */);
@@ -574,6 +691,8 @@ static void tcp_conn_sa_listen(tcp_conn_t *conn, tcp_segment_t *seg)
  */
 static void tcp_conn_sa_syn_sent(tcp_conn_t *conn, tcp_segment_t *seg)
 {
+	uint32_t old_una;
+
 	log_msg(LOG_DEFAULT, LVL_DEBUG, "tcp_conn_sa_syn_sent(%p, %p)", conn, seg);
 
 	if ((seg->ctrl & CTL_ACK) != 0) {
@@ -615,14 +734,17 @@ static void tcp_conn_sa_syn_sent(tcp_conn_t *conn, tcp_segment_t *seg)
 	conn->rcv_nxt = seg->seq + 1;
 	conn->irs = seg->seq;
 
+	tcp_conn_syn_opts(conn, seg);
+
 	if ((seg->ctrl & CTL_ACK) != 0) {
+		old_una = conn->snd_una;
 		conn->snd_una = seg->ack;
 
 		/*
 		 * Prune acked segments from retransmission queue and
 		 * possibly transmit more data.
 		 */
-		tcp_tqueue_ack_received(conn);
+		tcp_tqueue_ack_received(conn, seg->ack - old_una);
 	}
 
 	log_msg(LOG_DEFAULT, LVL_DEBUG, "Sent SYN, got SYN.");
@@ -662,6 +784,7 @@ static void tcp_conn_sa_syn_sent(tcp_conn_t *conn, tcp_segment_t *seg)
 static void tcp_conn_sa_queue(tcp_conn_t *conn, tcp_segment_t *seg)
 {
 	tcp_segment_t *pseg;
+	bool out_of_order;
 
 	log_msg(LOG_DEFAULT, LVL_DEBUG, "tcp_conn_sa_seq(%p, %p)", conn, seg);
 
@@ -673,6 +796,28 @@ static void tcp_conn_sa_queue(tcp_conn_t *conn, tcp_segment_t *seg)
 		return;
 	}
 
+	/*
+	 * Data beyond RCV.NXT means a segment was lost. Acknowledge
+	 * immediately so that the sender gets duplicate ACKs (and SACK
+	 * information) for fast retransmit (RFC 5681 4.2).
+	 */
+	out_of_order = seg->len > 0 && !seq_no_segment_ready(conn, seg);
+
+	if (conn->ts_ok && seg->has_ts && (seg->ctrl & CTL_RST) == 0) {
+		/* Protection against wrapped sequence numbers (RFC 7323 5.3) */
+		if ((int32_t) (seg->tsval - conn->ts_recent) < 0) {
+			log_msg(LOG_DEFAULT, LVL_DEBUG, "PAWS: dropping segment "
+			    "with old timestamp.");
+			tcp_tqueue_ctrl_seg(conn, CTL_ACK);
+			tcp_segment_delete(seg);
+			return;
+		}
+
+		/* Record timestamp to echo (RFC 7323 4.3) */
+		if ((int32_t) (seg->seq - conn->last_ack_sent) <= 0)
+			conn->ts_recent = seg->tsval;
+	}
+
 	/* Queue for processing */
 	tcp_iqueue_insert_seg(&conn->incoming, seg);
 
@@ -684,6 +829,9 @@ static void tcp_conn_sa_queue(tcp_conn_t *conn, tcp_segment_t *seg)
 	 */
 	while (tcp_iqueue_get_ready_seg(&conn->incoming, &pseg) == EOK)
 		tcp_conn_seg_process(conn, pseg);
+
+	if (out_of_order && conn->cstate != st_closed)
+		tcp_tqueue_ctrl_seg(conn, CTL_ACK);
 }
 
 /** Process segment RST field.
@@ -784,6 +932,8 @@ static cproc_t tcp_conn_seg_proc_syn(tcp_conn_t *conn, tcp_segment_t *seg)
  */
 static cproc_t tcp_conn_seg_proc_ack_sr(tcp_conn_t *conn, tcp_segment_t *seg)
 {
+	uint32_t old_una;
+
 	if (!seq_no_ack_acceptable(conn, seg->ack)) {
 		/* ACK is not acceptable, send RST. */
 		log_msg(LOG_DEFAULT, LVL_WARN, "Segment ACK not acceptable, sending RST.");
@@ -797,8 +947,12 @@ static cproc_t tcp_conn_seg_proc_ack_sr(tcp_conn_t *conn, tcp_segment_t *seg)
 	tcp_conn_state_set(conn, st_established);
 
 	/* XXX Not mentioned in spec?! */
+	old_una = conn->snd_una;
 	conn->snd_una = seg->ack;
 
+	/* Prune SYN from retransmission queue, sampling the RTT */
+	tcp_tqueue_ack_received(conn, seg->ack - old_una);
+
 	return cp_continue;
 }
 
@@ -811,12 +965,23 @@ static cproc_t tcp_conn_seg_proc_ack_sr(tcp_conn_t *conn, tcp_segment_t *seg)
  */
 static cproc_t tcp_conn_seg_proc_ack_est(tcp_conn_t *conn, tcp_segment_t *seg)
 {
+	uint32_t acked = 0;
+	bool dupack;
+
 	log_msg(LOG_DEFAULT, LVL_DEBUG, "tcp_conn_seg_proc_ack_est(%p, %p)", conn, seg);
 
 	log_msg(LOG_DEFAULT, LVL_DEBUG, "SEG.ACK=%u, SND.UNA=%u, SND.NXT=%u",
 	    (unsigned)seg->ack, (unsigned)conn->snd_una,
 	    (unsigned)conn->snd_nxt);
 
+	/*
+	 * Duplicate ACK in the sense of RFC 5681 2: acknowledges nothing
+	 * new, carries no data and does not change the window while we
+	 * have data outstanding.
+	 */
+	dupack = seg->ack == conn->snd_una && conn->snd_una != conn->snd_nxt &&
+	    seg->len == 0 && tcp_conn_seg_wnd(conn, seg) == conn->snd_wnd;
+
 	if (!seq_no_ack_acceptable(conn, seg->ack)) {
 		log_msg(LOG_DEFAULT, LVL_DEBUG, "ACK not acceptable.");
 		if (!seq_no_ack_duplicate(conn, seg->ack)) {
@@ -831,11 +996,12 @@ static cproc_t tcp_conn_seg_proc_ack_est(tcp_conn_t *conn, tcp_segment_t *seg)
 		}
 	} else {
 		/* Update SND.UNA */
+		acked = seg->ack - conn->snd_una;
 		conn->snd_una = seg->ack;
 	}
 
 	if (seq_no_new_wnd_update(conn, seg)) {
-		conn->snd_wnd = seg->wnd;
+		conn->snd_wnd = tcp_conn_seg_wnd(conn, seg);
 		conn->snd_wl1 = seg->seq;
 		conn->snd_wl2 = seg->ack;
 
@@ -844,11 +1010,20 @@ static cproc_t tcp_conn_seg_proc_ack_est(tcp_conn_t *conn, tcp_segment_t *seg)
 		    conn->snd_wnd, conn->snd_wl1, conn->snd_wl2);
 	}
 
+	/* Timestamps allow sampling RTT on every ACK, even retransmissions */
+	if (conn->ts_ok && seg->has_ts && seg->tsecr != 0 && acked > 0)
+		tcp_rtt_sample(&conn->rtt, tcp_ts_rtt(seg->tsecr));
+
+	tcp_tqueue_sack_received(conn, seg);
+
 	/*
 	 * Prune acked segments from retransmission queue and
 	 * possibly transmit more data.
 	 */
-	tcp_tqueue_ack_received(conn);
+	if (dupack)
+		tcp_tqueue_dupack_received(conn);
+	else
+		tcp_tqueue_ack_received(conn, acked);
 
 	return cp_continue;
 }
@@ -1013,6 +1188,106 @@ static cproc_t tcp_conn_seg_proc_urg(tcp_conn_t *conn, tcp_segment_t *seg)
 	return cp_continue;
 }
 
+/** Move unread data to the beginning of the receive buffer.
+ *
+ * @param conn	Connection
+ */
+static void tcp_conn_rcv_buf_compact(tcp_conn_t *conn)
+{
+	if (conn->rcv_buf_start == 0)
+		return;
+
+	memmove(conn->rcv_buf, conn->rcv_buf + conn->rcv_buf_start,
+	    conn->rcv_buf_used);
+	conn->rcv_buf_start = 0;
+}
+
+/** Auto-tune receive buffer size.
+ *
+ * Called after the user has read data from the receive buffer. If the
+ * user consumes more than half of the buffer per round-trip time,
+ * the buffer (and thus the window) limits throughput. Grow it so that
+ * it holds twice the amount of data consumed per RTT (dynamic right
+ * sizing).
+ *
+ * @param conn	Connection
+ * @param copied Number of bytes the user has just read
+ */
+void tcp_conn_rcv_buf_tune(tcp_conn_t *conn, size_t copied)
+{
+	struct timespec now;
+	size_t nsize;
+	uint8_t *nbuf;
+
+	assert(fibril_mutex_is_locked(&conn->lock));
+
+	conn->rcv_space_copied += copied;
+
+	if (!conn->rtt.valid || conn->rcv_buf_size >= conn->rcv_buf_max)
+		return;
+
+	getuptime(&now);
+	if (NSEC2USEC(ts_sub_diff(&now, &conn->rcv_space_time)) <
+	    conn->rtt.srtt)
+		return;
+
+	if (2 * conn->rcv_space_copied > conn->rcv_buf_size) {
+		nsize = conn->rcv_buf_size;
+		while (nsize < 2 * conn->rcv_space_copied)
+			nsize *= 2;
+		nsize = min(nsize, conn->rcv_buf_max);
+
+		tcp_conn_rcv_buf_compact(conn);
+		nbuf = realloc(conn->rcv_buf, nsize);
+		if (nbuf != NULL) {
+			log_msg(LOG_DEFAULT, LVL_DEBUG, "%s: receive buffer "
+			    "%zu -> %zu", conn->name, conn->rcv_buf_size, nsize);
+			conn->rcv_wnd += nsize - conn->rcv_buf_size;
+			conn->rcv_buf = nbuf;
+			conn->rcv_buf_size = nsize;
+		}
+	}
+
+	conn->rcv_space_copied = 0;
+	conn->rcv_space_time = now;
+}
+
+/** Auto-tune send buffer size.
+ *
+ * Called when the send buffer is full. Grow the buffer so that it can
+ * hold twice the congestion window, so that the user can stay ahead
+ * of the transmitter.
+ *
+ * @param conn	Connection
+ */
+void tcp_conn_snd_buf_tune(tcp_conn_t *conn)
+{
+	size_t target;
+	size_t nsize;
+	uint8_t *nbuf;
+
+	assert(fibril_mutex_is_locked(&conn->lock));
+
+	target = min(2 * (size_t) min(conn->cc.cwnd, conn->snd_wnd),
+	    conn->snd_buf_max);
+	if (target <= conn->snd_buf_size)
+		return;
+
+	nsize = conn->snd_buf_size;
+	while (nsize < target)
+		nsize *= 2;
+	nsize = min(nsize, conn->snd_buf_max);
+
+	nbuf = realloc(conn->snd_buf, nsize);
+	if (nbuf == NULL)
+		return;
+
+	log_msg(LOG_DEFAULT, LVL_DEBUG, "%s: send buffer %zu -> %zu",
+	    conn->name, conn->snd_buf_size, nsize);
+	conn->snd_buf = nbuf;
+	conn->snd_buf_size = nsize;
+}
+
 /** Process segment text.
  *
  * @param conn		Connection
@@ -1059,9 +1334,14 @@ static cproc_t tcp_conn_seg_proc_text(tcp_conn_t *conn, tcp_segment_t *seg)
 	text_size = tcp_segment_text_size(seg);
 	xfer_size = min(text_size, conn->rcv_buf_size - conn->rcv_buf_used);
 
+	/* Make room at the end of the receive buffer */
+	if (conn->rcv_buf_start + conn->rcv_buf_used + xfer_size >
+	    conn->rcv_buf_size)
+		tcp_conn_rcv_buf_compact(conn);
+
 	/* Copy data to receive buffer */
-	tcp_segment_text_copy(seg, conn->rcv_buf + conn->rcv_buf_used,
-	    xfer_size);
+	tcp_segment_text_copy(seg, conn->rcv_buf + conn->rcv_buf_start +
+	    conn->rcv_buf_used, xfer_size);
 	conn->rcv_buf_used += xfer_size;
 
 	/* Signal to the receive function that new data has arrived */
@@ -1409,6 +1689,18 @@ static void tcp_transmit_segment(inet_ep2_t *epp, tcp_segment_t *seg)
 
 	tcp_segment_dump(seg);
 
+	if (tcp_conn_lb == tcp_lb_ncsim) {
+		/* Loop back segment through network condition simulator */
+		dseg = tcp_segment_dup(seg);
+		if (dseg == NULL) {
+			log_msg(LOG_DEFAULT, LVL_WARN, "Not enough memory. Segment dropped.");
+			return;
+		}
+
+		tcp_ncsim_bounce_seg(epp, dseg);
+		return;
+	}
+
 	if (tcp_conn_lb == tcp_lb_segment) {
 		/* Loop back segment */
 #if 0
@@ -53,6 +53,9 @@ extern void tcp_conn_delref(tcp_conn_t *);
 extern void tcp_conn_lock(tcp_conn_t *);
 extern void tcp_conn_unlock(tcp_conn_t *);
 extern bool tcp_conn_got_syn(tcp_conn_t *);
+extern uint16_t tcp_conn_local_mss(tcp_conn_t *);
+extern void tcp_conn_rcv_buf_tune(tcp_conn_t *, size_t);
+extern void tcp_conn_snd_buf_tune(tcp_conn_t *);
 extern void tcp_conn_segment_arrived(tcp_conn_t *, inet_ep2_t *,
     tcp_segment_t *);
 extern void tcp_unexpected_segment(inet_ep2_t *, tcp_segment_t *);
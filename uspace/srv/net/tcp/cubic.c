@@ -0,0 +1,220 @@
+/*
+ * Copyright (c) 2019 Jiri Svoboda
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * - Redistributions of source code must retain the above copyright
+ *   notice, this list of conditions and the following disclaimer.
+ * - Redistributions in binary form must reproduce the above copyright
+ *   notice, this list of conditions and the following disclaimer in the
+ *   documentation and/or other materials provided with the distribution.
+ * - The name of the author may not be used to endorse or promote products
+ *   derived from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHOR ``AS IS'' AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+ * OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+ * IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT
+ * NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF
+ * THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/** @addtogroup tcp
+ * @{
+ */
+
+/**
+ * @file CUBIC congestion control
+ *
+ * CUBIC (RFC 8312) grows the congestion window as a cubic function of
+ * the time since the last congestion event, which makes it independent
+ * of the round-trip time and lets it quickly reclaim bandwidth on
+ * long fat paths. All computations use integer arithmetic, windows
+ * are kept in bytes and time in milliseconds.
+ */
+
+#include <macros.h>
+#include <mem.h>
+#include <stdint.h>
+#include <time.h>
+#include "congctl.h"
+#include "cubic.h"
+#include "tcp_type.h"
+
+/** Multiplicative window decrease factor (beta = 0.7) */
+#define CUBIC_BETA_NUM	7
+#define CUBIC_BETA_DEN	10
+
+/** Largest time offset from K we evaluate the cubic function at (ms) */
+#define CUBIC_T_MAX	(100 * 1000)
+
+static void tcp_cubic_init(tcp_conn_t *);
+static void tcp_cubic_cong_avoid(tcp_conn_t *, uint32_t);
+static uint32_t tcp_cubic_ssthresh(tcp_conn_t *);
+
+const tcp_cc_ops_t tcp_cc_cubic = {
+	.name = "cubic",
+	.init = tcp_cubic_init,
+	.cong_avoid = tcp_cubic_cong_avoid,
+	.ssthresh = tcp_cubic_ssthresh
+};
+
+/** Integer cube root.
+ *
+ * @param x Argument
+ * @return Largest r such that r * r * r <= x
+ */
+static uint32_t tcp_cubic_cbrt(uint64_t x)
+{
+	uint64_t r = 0;
+	uint64_t b;
+	int s;
+
+	for (s = 63; s >= 0; s -= 3) {
+		r <<= 1;
+		b = 3 * r * (r + 1) + 1;
+		if ((x >> s) >= b) {
+			x -= b << s;
+			r++;
+		}
+	}
+
+	return r;
+}
+
+/** Initialize CUBIC state.
+ *
+ * @param conn Connection
+ */
+static void tcp_cubic_init(tcp_conn_t *conn)
+{
+	memset(&conn->cc.alg.cubic, 0, sizeof(tcp_cubic_t));
+}
+
+/** Start a new congestion avoidance epoch.
+ *
+ * @param conn Connection
+ * @param now  Current time
+ */
+static void tcp_cubic_epoch_start(tcp_conn_t *conn, struct timespec *now)
+{
+	tcp_cubic_t *cubic = &conn->cc.alg.cubic;
+	uint32_t cwnd = conn->cc.cwnd;
+
+	cubic->epoch_start = *now;
+	cubic->epoch_valid = true;
+
+	if (cwnd < cubic->w_max) {
+		/*
+		 * K = cbrt((W_max - cwnd) / C) seconds with windows
+		 * in segments and C = 0.4. In milliseconds and bytes:
+		 * K = cbrt((W_max - cwnd) * 10^9 / (0.4 * MSS))
+		 */
+		cubic->k = tcp_cubic_cbrt((uint64_t) (cubic->w_max - cwnd) *
+		    2500000000ULL / conn->snd_mss);
+		cubic->origin = cubic->w_max;
+	} else {
+		cubic->k = 0;
+		cubic->origin = cwnd;
+	}
+
+	cubic->w_est = cwnd;
+}
+
+/** Grow congestion window after new data has been acknowledged.
+ *
+ * @param conn  Connection
+ * @param acked Number of newly acknowledged bytes
+ */
+static void tcp_cubic_cong_avoid(tcp_conn_t *conn, uint32_t acked)
+{
+	tcp_cc_t *cc = &conn->cc;
+	tcp_cubic_t *cubic = &cc->alg.cubic;
+	uint32_t mss = conn->snd_mss;
+	struct timespec now;
+	int64_t t, d, offs, target;
+
+	if (cc->cwnd < cc->ssthresh) {
+		/* Slow start */
+		tcp_cc_cwnd_inc(conn, min(acked, mss));
+		return;
+	}
+
+	getuptime(&now);
+	if (!cubic->epoch_valid)
+		tcp_cubic_epoch_start(conn, &now);
+
+	/* Target window one RTT from now */
+	t = ts_sub_diff(&now, &cubic->epoch_start) / 1000000 +
+	    conn->rtt.srtt / 1000;
+	d = t - cubic->k;
+	if (d > CUBIC_T_MAX)
+		d = CUBIC_T_MAX;
+	if (d < -CUBIC_T_MAX)
+		d = -CUBIC_T_MAX;
+
+	/* C * d^3 converted from segments and seconds to bytes and ms */
+	offs = (d * d * d / 1000) * 4 * mss / 10000000;
+	target = (int64_t) cubic->origin + offs;
+
+	/* Limit growth to 1.5 times the current window per RTT */
+	if (target > (int64_t) cc->cwnd * 3 / 2)
+		target = (int64_t) cc->cwnd * 3 / 2;
+
+	if (target > cc->cwnd) {
+		tcp_cc_cwnd_inc(conn, (uint64_t) (target - cc->cwnd) * acked /
+		    cc->cwnd);
+	} else {
+		/* Plateau around W_max, grow very slowly */
+		tcp_cc_cwnd_inc(conn, max((uint64_t) mss * acked /
+		    (100 * (uint64_t) cc->cwnd), 1));
+	}
+
+	/*
+	 * TCP-friendly region. A standard TCP flow with the same beta
+	 * would grow by 3 * (1 - beta) / (1 + beta) = 9/17 segments
+	 * per RTT.
+	 */
+	cubic->w_est = min((uint64_t) cubic->w_est +
+	    (uint64_t) 9 * mss * acked / (17 * (uint64_t) cc->cwnd),
+	    UINT32_MAX / 2);
+	if (cubic->w_est > cc->cwnd)
+		cc->cwnd = cubic->w_est;
+}
+
+/** Compute slow start threshold after congestion has been detected.
+ *
+ * @param conn Connection
+ * @return New slow start threshold
+ */
+static uint32_t tcp_cubic_ssthresh(tcp_conn_t *conn)
+{
+	tcp_cubic_t *cubic = &conn->cc.alg.cubic;
+	uint32_t cwnd = conn->cc.cwnd;
+
+	cubic->epoch_valid = false;
+
+	/* Fast convergence, release bandwidth to competing flows */
+	if (cwnd < cubic->w_last_max) {
+		cubic->w_last_max = cwnd;
+		cubic->w_max = (uint64_t) cwnd * (CUBIC_BETA_DEN +
+		    CUBIC_BETA_NUM) / (2 * CUBIC_BETA_DEN);
+	} else {
+		cubic->w_last_max = cwnd;
+		cubic->w_max = cwnd;
+	}
+
+	return max((uint64_t) cwnd * CUBIC_BETA_NUM / CUBIC_BETA_DEN,
+	    2 * (uint32_t) conn->snd_mss);
+}
+
+/**
+ * @}
+ */
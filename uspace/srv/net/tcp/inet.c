@@ -39,6 +39,7 @@
 #include <errno.h>
 #include <inet/inet.h>
 #include <mem.h>
+#include <stddef.h>
 #include <io/log.h>
 #include <stdlib.h>
 
@@ -71,7 +72,7 @@ static errno_t tcp_inet_ev_recv(inet_dgram_t *dgram)
 
 	log_msg(LOG_DEFAULT, LVL_DEBUG, "tcp_inet_ev_recv() - split header/payload");
 
-	tcp_pdu_t *pdu;
+	tcp_pdu_t pdu;
 	size_t hdr_size;
 	tcp_header_t *hdr;
 	uint32_t data_offset;
@@ -102,18 +103,19 @@ static errno_t tcp_inet_ev_recv(inet_dgram_t *dgram)
 
 	log_msg(LOG_DEFAULT, LVL_DEBUG, "pdu_raw_size=%zu, hdr_size=%zu",
 	    pdu_raw_size, hdr_size);
-	pdu = tcp_pdu_create(pdu_raw, hdr_size, pdu_raw + hdr_size,
-	    pdu_raw_size - hdr_size);
-	if (pdu == NULL) {
-		log_msg(LOG_DEFAULT, LVL_WARN, "Failed creating PDU. Dropped.");
-		return ENOMEM;
-	}
 
-	pdu->src = dgram->src;
-	pdu->dest = dgram->dest;
+	/*
+	 * The PDU only lives for the duration of this call, so it can
+	 * refer to the datagram instead of holding a copy of it.
+	 */
+	pdu.header = pdu_raw;
+	pdu.header_size = hdr_size;
+	pdu.text = pdu_raw + hdr_size;
+	pdu.text_size = pdu_raw_size - hdr_size;
+	pdu.src = dgram->src;
+	pdu.dest = dgram->dest;
 
-	tcp_received_pdu(pdu);
-	tcp_pdu_delete(pdu);
+	tcp_received_pdu(&pdu);
 
 	return EOK;
 }
@@ -143,6 +145,7 @@ void tcp_transmit_pdu(tcp_pdu_t *pdu)
 	dgram.tos = 0;
 	dgram.data = pdu_raw;
 	dgram.size = pdu_raw_size;
+	dgram.csum_offs = offsetof(tcp_header_t, checksum);
 
 	rc = inet_send(&dgram, INET_TTL_MAX, 0);
 	if (rc != EOK)
@@ -75,6 +75,7 @@ void tcp_iqueue_insert_seg(tcp_iqueue_t *iqueue, tcp_segment_t *seg)
 	}
 
 	iqe->seg = seg;
+	iqueue->recent = seg->seq;
 
 	/* Sort by sequence number */
 
@@ -186,6 +187,84 @@ errno_t tcp_iqueue_get_ready_seg(tcp_iqueue_t *iqueue, tcp_segment_t **seg)
 	return EOK;
 }
 
+/** Add SACK block to the list of blocks to report.
+ *
+ * The block containing the most recently received segment goes first
+ * (RFC 2018), other blocks are appended while there is space.
+ *
+ * @param iqueue Incoming queue
+ * @param b      Block
+ * @param blk    Array of blocks
+ * @param n      Number of blocks in @a blk, updated
+ * @param max    Size of @a blk
+ */
+static void tcp_iqueue_sack_add(tcp_iqueue_t *iqueue, tcp_sack_blk_t *b,
+    tcp_sack_blk_t *blk, size_t *n, size_t max)
+{
+	size_t i;
+
+	if ((int32_t)(iqueue->recent - b->left) >= 0 &&
+	    (int32_t)(iqueue->recent - b->right) < 0) {
+		if (*n < max)
+			++*n;
+		for (i = *n - 1; i > 0; i--)
+			blk[i] = blk[i - 1];
+		blk[0] = *b;
+	} else if (*n < max) {
+		blk[(*n)++] = *b;
+	}
+}
+
+/** Describe out-of-order data in incoming queue with SACK blocks.
+ *
+ * @param iqueue Incoming queue
+ * @param blk    Array to store SACK blocks to
+ * @param max    Maximum number of blocks to store
+ * @return Number of blocks stored
+ */
+size_t tcp_iqueue_sack_blocks(tcp_iqueue_t *iqueue, tcp_sack_blk_t *blk,
+    size_t max)
+{
+	tcp_conn_t *conn = iqueue->conn;
+	tcp_segment_t *seg;
+	tcp_sack_blk_t cur;
+	bool have_cur;
+	size_t n;
+
+	if (max == 0)
+		return 0;
+
+	n = 0;
+	have_cur = false;
+
+	list_foreach(iqueue->list, link, tcp_iqueue_entry_t, iqe) {
+		seg = iqe->seg;
+
+		/* Only data past RCV.NXT is out of order */
+		if (seg->len == 0 || (int32_t)(seg->seq - conn->rcv_nxt) <= 0)
+			continue;
+
+		if (have_cur && (int32_t)(seg->seq - cur.right) <= 0) {
+			/* Adjacent or overlapping, extend current block */
+			if ((int32_t)(seg->seq + seg->len - cur.right) > 0)
+				cur.right = seg->seq + seg->len;
+			continue;
+		}
+
+		if (have_cur)
+			tcp_iqueue_sack_add(iqueue, &cur, blk, &n, max);
+
+		cur.left = seg->seq;
+		cur.right = seg->seq + seg->len;
+		have_cur = true;
+	}
+
+	if (have_cur)
+		tcp_iqueue_sack_add(iqueue, &cur, blk, &n, max);
+
+	return n;
+}
+
 /**
  * @}
  */
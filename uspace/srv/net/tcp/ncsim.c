@@ -45,15 +45,19 @@
 #include <io/log.h>
 #include <stdlib.h>
 #include <fibril.h>
+#include <time.h>
 #include "conn.h"
 #include "ncsim.h"
 #include "rqueue.h"
 #include "segment.h"
 #include "tcp_type.h"
 
+/** Simulated segments, sorted by delivery time */
 static list_t sim_queue;
 static fibril_mutex_t sim_queue_lock;
 static fibril_condvar_t sim_queue_cv;
+/** Simulated network conditions */
+static tcp_ncsim_cfg_t sim_cfg;
 
 /** Initialize segment receive queue. */
 void tcp_ncsim_init(void)
@@ -63,59 +67,72 @@ void tcp_ncsim_init(void)
 	fibril_condvar_initialize(&sim_queue_cv);
 }
 
+/** Set simulated network conditions.
+ *
+ * @param cfg	Network conditions
+ */
+void tcp_ncsim_set_cfg(const tcp_ncsim_cfg_t *cfg)
+{
+	fibril_mutex_lock(&sim_queue_lock);
+	sim_cfg = *cfg;
+	fibril_mutex_unlock(&sim_queue_lock);
+}
+
 /** Bounce segment through simulator into receive queue.
  *
  * @param epp	Endpoint pair, oriented for transmission
- * @param seg	Segment
+ * @param seg	Segment (ownership transferred to simulator)
  */
 void tcp_ncsim_bounce_seg(inet_ep2_t *epp, tcp_segment_t *seg)
 {
 	tcp_squeue_entry_t *sqe;
 	tcp_squeue_entry_t *old_qe;
-	inet_ep2_t rident;
+	usec_t delay;
 	link_t *link;
 
 	log_msg(LOG_DEFAULT, LVL_DEBUG, "tcp_ncsim_bounce_seg()");
-	tcp_ep2_flipped(epp, &rident);
-	tcp_rqueue_insert_seg(&rident, seg);
-	return;
 
-	if (0 /*rand() % 4 == 3*/) {
+	fibril_mutex_lock(&sim_queue_lock);
+
+	if (sim_cfg.loss > 0 && (unsigned) (rand() % 1000) < sim_cfg.loss) {
 		/* Drop segment */
-		log_msg(LOG_DEFAULT, LVL_ERROR, "NCSim dropping segment");
+		fibril_mutex_unlock(&sim_queue_lock);
+		log_msg(LOG_DEFAULT, LVL_DEBUG, "NCSim dropping segment");
 		tcp_segment_delete(seg);
 		return;
 	}
 
 	sqe = calloc(1, sizeof(tcp_squeue_entry_t));
 	if (sqe == NULL) {
+		fibril_mutex_unlock(&sim_queue_lock);
 		log_msg(LOG_DEFAULT, LVL_ERROR, "Failed allocating SQE.");
+		tcp_segment_delete(seg);
 		return;
 	}
 
-	sqe->delay = rand() % (1000 * 1000);
+	delay = sim_cfg.delay;
+	if (sim_cfg.jitter > 0)
+		delay += rand() % sim_cfg.jitter;
+
+	getuptime(&sqe->due);
+	ts_add_diff(&sqe->due, USEC2NSEC(delay));
 	sqe->epp = *epp;
 	sqe->seg = seg;
 
-	fibril_mutex_lock(&sim_queue_lock);
-
-	link = list_first(&sim_queue);
-	while (link != NULL && sqe->delay > 0) {
+	/* Insert after the last entry that is not due later */
+	link = list_last(&sim_queue);
+	while (link != NULL) {
 		old_qe = list_get_instance(link, tcp_squeue_entry_t, link);
-		if (sqe->delay < old_qe->delay)
+		if (ts_gteq(&sqe->due, &old_qe->due))
 			break;
 
-		sqe->delay -= old_qe->delay;
-
-		link = link->next;
-		if (link == &sim_queue.head)
-			link = NULL;
+		link = list_prev(link, &sim_queue);
 	}
 
 	if (link != NULL)
 		list_insert_after(&sqe->link, link);
 	else
-		list_append(&sqe->link, &sim_queue);
+		list_prepend(&sqe->link, &sim_queue);
 
 	fibril_condvar_broadcast(&sim_queue_cv);
 	fibril_mutex_unlock(&sim_queue_lock);
@@ -127,29 +144,37 @@ static errno_t tcp_ncsim_fibril(void *arg)
 	link_t *link;
 	tcp_squeue_entry_t *sqe;
 	inet_ep2_t rident;
-	errno_t rc;
+	struct timespec now;
+	usec_t wait;
 
 	log_msg(LOG_DEFAULT, LVL_DEBUG, "tcp_ncsim_fibril()");
 
 	while (true) {
 		fibril_mutex_lock(&sim_queue_lock);
 
-		while (list_empty(&sim_queue))
-			fibril_condvar_wait(&sim_queue_cv, &sim_queue_lock);
+		while (true) {
+			while (list_empty(&sim_queue))
+				fibril_condvar_wait(&sim_queue_cv, &sim_queue_lock);
 
-		do {
 			link = list_first(&sim_queue);
 			sqe = list_get_instance(link, tcp_squeue_entry_t, link);
 
-			log_msg(LOG_DEFAULT, LVL_DEBUG, "NCSim - Sleep");
-			rc = fibril_condvar_wait_timeout(&sim_queue_cv,
-			    &sim_queue_lock, sqe->delay);
-		} while (rc != ETIMEOUT);
+			getuptime(&now);
+			if (ts_gteq(&now, &sqe->due))
+				break;
+
+			/*
+			 * Wait until the head is due. A new segment can only
+			 * become the new head, so simply re-evaluate on wakeup.
+			 */
+			wait = NSEC2USEC(ts_sub_diff(&sqe->due, &now));
+			(void) fibril_condvar_wait_timeout(&sim_queue_cv,
+			    &sim_queue_lock, wait > 0 ? wait : 1);
+		}
 
 		list_remove(link);
 		fibril_mutex_unlock(&sim_queue_lock);
 
-		log_msg(LOG_DEFAULT, LVL_DEBUG, "NCSim - End Sleep");
 		tcp_ep2_flipped(&sqe->epp, &rident);
 		tcp_rqueue_insert_seg(&rident, sqe->seg);
 		free(sqe);
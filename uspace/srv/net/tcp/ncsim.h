@@ -39,6 +39,7 @@
 #include "tcp_type.h"
 
 extern void tcp_ncsim_init(void);
+extern void tcp_ncsim_set_cfg(const tcp_ncsim_cfg_t *);
 extern void tcp_ncsim_bounce_seg(inet_ep2_t *, tcp_segment_t *);
 extern void tcp_ncsim_fibril_start(void);
 
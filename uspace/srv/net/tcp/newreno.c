@@ -0,0 +1,98 @@
+/*
+ * Copyright (c) 2019 Jiri Svoboda
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * - Redistributions of source code must retain the above copyright
+ *   notice, this list of conditions and the following disclaimer.
+ * - Redistributions in binary form must reproduce the above copyright
+ *   notice, this list of conditions and the following disclaimer in the
+ *   documentation and/or other materials provided with the distribution.
+ * - The name of the author may not be used to endorse or promote products
+ *   derived from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHOR ``AS IS'' AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+ * OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+ * IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT
+ * NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF
+ * THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/** @addtogroup tcp
+ * @{
+ */
+
+/**
+ * @file NewReno congestion control
+ *
+ * Slow start and congestion avoidance as specified by RFC 5681.
+ * Fast recovery is handled by the generic part in congctl.c.
+ */
+
+#include <macros.h>
+#include <stdint.h>
+#include "congctl.h"
+#include "newreno.h"
+#include "tcp_type.h"
+
+static void tcp_newreno_init(tcp_conn_t *);
+static void tcp_newreno_cong_avoid(tcp_conn_t *, uint32_t);
+static uint32_t tcp_newreno_ssthresh(tcp_conn_t *);
+
+const tcp_cc_ops_t tcp_cc_newreno = {
+	.name = "newreno",
+	.init = tcp_newreno_init,
+	.cong_avoid = tcp_newreno_cong_avoid,
+	.ssthresh = tcp_newreno_ssthresh
+};
+
+/** Initialize NewReno state.
+ *
+ * @param conn Connection
+ */
+static void tcp_newreno_init(tcp_conn_t *conn)
+{
+	/* NewReno has no state of its own */
+}
+
+/** Grow congestion window after new data has been acknowledged.
+ *
+ * @param conn  Connection
+ * @param acked Number of newly acknowledged bytes
+ */
+static void tcp_newreno_cong_avoid(tcp_conn_t *conn, uint32_t acked)
+{
+	tcp_cc_t *cc = &conn->cc;
+	uint32_t mss = conn->snd_mss;
+
+	if (cc->cwnd < cc->ssthresh) {
+		/* Slow start */
+		tcp_cc_cwnd_inc(conn, min(acked, mss));
+	} else {
+		/* Congestion avoidance, about one segment per RTT */
+		tcp_cc_cwnd_inc(conn, max((uint64_t) mss * acked / cc->cwnd,
+		    1));
+	}
+}
+
+/** Compute slow start threshold after congestion has been detected.
+ *
+ * @param conn Connection
+ * @return New slow start threshold
+ */
+static uint32_t tcp_newreno_ssthresh(tcp_conn_t *conn)
+{
+	return max(tcp_cc_flight_size(conn) / 2, 2 * (uint32_t) conn->snd_mss);
+}
+
+/**
+ * @}
+ */
@@ -34,10 +34,12 @@
  * @file TCP header encoding and decoding
  */
 
+#include <adt/checksum.h>
 #include <bitops.h>
 #include <byteorder.h>
 #include <errno.h>
 #include <inet/endpoint.h>
+#include <macros.h>
 #include <mem.h>
 #include <stdlib.h>
 #include "pdu.h"
@@ -48,40 +50,9 @@
 
 #define TCP_CHECKSUM_INIT 0xffff
 
-/** One's complement addition.
- *
- * Result is a + b + carry.
- */
-static uint16_t tcp_ocadd16(uint16_t a, uint16_t b)
-{
-	uint32_t s;
-
-	s = (uint32_t)a + (uint32_t)b;
-	return (s & 0xffff) + (s >> 16);
-}
-
 static uint16_t tcp_checksum_calc(uint16_t ivalue, void *data, size_t size)
 {
-	uint16_t sum;
-	uint16_t w;
-	size_t words, i;
-	uint8_t *bdata;
-
-	sum = ~ivalue;
-	words = size / 2;
-	bdata = (uint8_t *)data;
-
-	for (i = 0; i < words; i++) {
-		w = ((uint16_t)bdata[2 * i] << 8) | bdata[2 * i + 1];
-		sum = tcp_ocadd16(sum, w);
-	}
-
-	if (size % 2 != 0) {
-		w = ((uint16_t)bdata[2 * words] << 8);
-		sum = tcp_ocadd16(sum, w);
-	}
-
-	return ~sum;
+	return ~compute_ocsum(data, size, ~ivalue);
 }
 
 static void tcp_header_decode_flags(uint16_t doff_flags, tcp_control_t *rctl)
@@ -125,7 +96,202 @@ static void tcp_header_encode_flags(tcp_control_t ctl, uint16_t doff_flags0,
 	*rdoff_flags = doff_flags;
 }
 
-static void tcp_header_setup(inet_ep2_t *epp, tcp_segment_t *seg, tcp_header_t *hdr)
+/** Return number of SACK blocks that fit in the option space.
+ *
+ * @param seg Segment
+ * @return Number of SACK blocks to encode
+ */
+static size_t tcp_opts_nsack(tcp_segment_t *seg)
+{
+	size_t avail;
+
+	if (seg->nsack == 0)
+		return 0;
+
+	avail = TCP_OPTS_MAX_SIZE - 4;
+	if (seg->mss != 0)
+		avail -= 4;
+	if (seg->has_wscale)
+		avail -= 4;
+	if (seg->sack_perm)
+		avail -= 4;
+	if (seg->has_ts)
+		avail -= TCP_OPT_TS_SIZE;
+
+	return min(seg->nsack, avail / 8);
+}
+
+/** Compute size of encoded TCP options.
+ *
+ * @param seg Segment
+ * @return Size of options in bytes, multiple of four
+ */
+static size_t tcp_opts_size(tcp_segment_t *seg)
+{
+	size_t size = 0;
+
+	if (seg->mss != 0)
+		size += 4;
+	if (seg->has_wscale)
+		size += 4;
+	if (seg->sack_perm)
+		size += 4;
+	if (seg->has_ts)
+		size += TCP_OPT_TS_SIZE;
+	if (tcp_opts_nsack(seg) > 0)
+		size += 4 + 8 * tcp_opts_nsack(seg);
+
+	return size;
+}
+
+/** Store 32-bit value in network byte order. */
+static void tcp_opts_put32(uint8_t *p, uint32_t v)
+{
+	p[0] = v >> 24;
+	p[1] = (v >> 16) & 0xff;
+	p[2] = (v >> 8) & 0xff;
+	p[3] = v & 0xff;
+}
+
+/** Load 32-bit value in network byte order. */
+static uint32_t tcp_opts_get32(uint8_t *p)
+{
+	return ((uint32_t)p[0] << 24) | ((uint32_t)p[1] << 16) |
+	    ((uint32_t)p[2] << 8) | p[3];
+}
+
+/** Encode TCP options.
+ *
+ * @param seg  Segment
+ * @param opts Buffer of tcp_opts_size() bytes
+ */
+static void tcp_opts_encode(tcp_segment_t *seg, uint8_t *opts)
+{
+	size_t nsack;
+	size_t i;
+
+	if (seg->mss != 0) {
+		*opts++ = OPT_MAX_SEG_SIZE;
+		*opts++ = 4;
+		*opts++ = seg->mss >> 8;
+		*opts++ = seg->mss & 0xff;
+	}
+
+	if (seg->has_wscale) {
+		*opts++ = OPT_NOP;
+		*opts++ = OPT_WINDOW_SCALE;
+		*opts++ = 3;
+		*opts++ = seg->wscale;
+	}
+
+	if (seg->sack_perm) {
+		*opts++ = OPT_NOP;
+		*opts++ = OPT_NOP;
+		*opts++ = OPT_SACK_PERMITTED;
+		*opts++ = 2;
+	}
+
+	if (seg->has_ts) {
+		*opts++ = OPT_NOP;
+		*opts++ = OPT_NOP;
+		*opts++ = OPT_TIMESTAMP;
+		*opts++ = 10;
+		tcp_opts_put32(opts, seg->tsval);
+		tcp_opts_put32(opts + 4, seg->tsecr);
+		opts += 8;
+	}
+
+	nsack = tcp_opts_nsack(seg);
+	if (nsack > 0) {
+		*opts++ = OPT_NOP;
+		*opts++ = OPT_NOP;
+		*opts++ = OPT_SACK;
+		*opts++ = 2 + 8 * nsack;
+
+		for (i = 0; i < nsack; i++) {
+			tcp_opts_put32(opts, seg->sack[i].left);
+			tcp_opts_put32(opts + 4, seg->sack[i].right);
+			opts += 8;
+		}
+	}
+}
+
+/** Decode TCP options.
+ *
+ * Unknown options are skipped, decoding stops at a malformed option.
+ *
+ * @param opts Options
+ * @param size Size of options in bytes
+ * @param seg  Segment to fill in
+ */
+static void tcp_opts_decode(uint8_t *opts, size_t size, tcp_segment_t *seg)
+{
+	size_t i;
+	size_t olen;
+	size_t nsack;
+	size_t j;
+
+	i = 0;
+	while (i < size) {
+		if (opts[i] == OPT_END_LIST)
+			break;
+
+		if (opts[i] == OPT_NOP) {
+			++i;
+			continue;
+		}
+
+		if (i + 1 >= size)
+			break;
+
+		olen = opts[i + 1];
+		if (olen < 2 || i + olen > size)
+			break;
+
+		switch (opts[i]) {
+		case OPT_MAX_SEG_SIZE:
+			if (olen == 4)
+				seg->mss = (opts[i + 2] << 8) | opts[i + 3];
+			break;
+		case OPT_WINDOW_SCALE:
+			if (olen == 3) {
+				seg->has_wscale = true;
+				seg->wscale = min(opts[i + 2], TCP_WSCALE_MAX);
+			}
+			break;
+		case OPT_SACK_PERMITTED:
+			if (olen == 2)
+				seg->sack_perm = true;
+			break;
+		case OPT_TIMESTAMP:
+			if (olen == 10) {
+				seg->has_ts = true;
+				seg->tsval = tcp_opts_get32(opts + i + 2);
+				seg->tsecr = tcp_opts_get32(opts + i + 6);
+			}
+			break;
+		case OPT_SACK:
+			if ((olen - 2) % 8 != 0)
+				break;
+			nsack = min((olen - 2) / 8, TCP_SACK_BLOCKS_MAX);
+			for (j = 0; j < nsack; j++) {
+				seg->sack[j].left =
+				    tcp_opts_get32(opts + i + 2 + 8 * j);
+				seg->sack[j].right =
+				    tcp_opts_get32(opts + i + 6 + 8 * j);
+			}
+			seg->nsack = nsack;
+			break;
+		default:
+			break;
+		}
+
+		i += olen;
+	}
+}
+
+static void tcp_header_setup(inet_ep2_t *epp, tcp_segment_t *seg,
+    tcp_header_t *hdr, size_t hdr_size)
 {
 	uint16_t doff_flags;
 	uint16_t doff;
@@ -135,7 +301,7 @@ static void tcp_header_setup(inet_ep2_t *epp, tcp_segment_t *seg, tcp_header_t *
 	hdr->seq = host2uint32_t_be(seg->seq);
 	hdr->ack = host2uint32_t_be(seg->ack);
 
-	doff = (sizeof(tcp_header_t) / sizeof(uint32_t)) << DF_DATA_OFFSET_l;
+	doff = (hdr_size / sizeof(uint32_t)) << DF_DATA_OFFSET_l;
 	tcp_header_encode_flags(seg->ctrl, doff, &doff_flags);
 
 	hdr->doff_flags = host2uint16_t_be(doff_flags);
@@ -194,14 +360,17 @@ static errno_t tcp_header_encode(inet_ep2_t *epp, tcp_segment_t *seg,
     void **header, size_t *size)
 {
 	tcp_header_t *hdr;
+	size_t hdr_size;
 
-	hdr = calloc(1, sizeof(tcp_header_t));
+	hdr_size = sizeof(tcp_header_t) + tcp_opts_size(seg);
+	hdr = calloc(1, hdr_size);
 	if (hdr == NULL)
 		return ENOMEM;
 
-	tcp_header_setup(epp, seg, hdr);
+	tcp_header_setup(epp, seg, hdr, hdr_size);
+	tcp_opts_encode(seg, (uint8_t *)(hdr + 1));
 	*header = hdr;
-	*size = sizeof(tcp_header_t);
+	*size = hdr_size;
 
 	return EOK;
 }
@@ -260,10 +429,17 @@ void tcp_pdu_delete(tcp_pdu_t *pdu)
 	free(pdu);
 }
 
-static uint16_t tcp_pdu_checksum_calc(tcp_pdu_t *pdu)
+/** Compute pseudo-header checksum.
+ *
+ * The rest of the checksum is completed by the network layer or the NIC
+ * (see @c csum_offs in inet_dgram_t).
+ *
+ * @param pdu PDU
+ * @return Folded one's complement sum of the pseudo-header
+ */
+static uint16_t tcp_pdu_phdr_sum(tcp_pdu_t *pdu)
 {
 	uint16_t cs_phdr;
-	uint16_t cs_headers;
 	tcp_phdr_t phdr;
 	tcp_phdr6_t phdr6;
 
@@ -281,8 +457,7 @@ static uint16_t tcp_pdu_checksum_calc(tcp_pdu_t *pdu)
 		assert(false);
 	}
 
-	cs_headers = tcp_checksum_calc(cs_phdr, pdu->header, pdu->header_size);
-	return tcp_checksum_calc(cs_headers, pdu->text, pdu->text_size);
+	return ~cs_phdr;
 }
 
 static void tcp_pdu_set_checksum(tcp_pdu_t *pdu, uint16_t checksum)
@@ -306,6 +481,11 @@ errno_t tcp_pdu_decode(tcp_pdu_t *pdu, inet_ep2_t *epp, tcp_segment_t **seg)
 	tcp_header_decode(pdu->header, nseg);
 	nseg->len += seq_no_control_len(nseg->ctrl);
 
+	if (pdu->header_size > sizeof(tcp_header_t)) {
+		tcp_opts_decode((uint8_t *)pdu->header + sizeof(tcp_header_t),
+		    pdu->header_size - sizeof(tcp_header_t), nseg);
+	}
+
 	hdr = (tcp_header_t *)pdu->header;
 
 	epp->local.port = uint16_t_be2host(hdr->dest_port);
@@ -348,8 +528,8 @@ errno_t tcp_pdu_encode(inet_ep2_t *epp, tcp_segment_t *seg, tcp_pdu_t **pdu)
 	npdu->text_size = text_size;
 	memcpy(npdu->text, seg->data, text_size);
 
-	/* Checksum calculation */
-	checksum = tcp_pdu_checksum_calc(npdu);
+	/* Partial checksum, to be completed on transmission */
+	checksum = tcp_pdu_phdr_sum(npdu);
 	tcp_pdu_set_checksum(npdu, checksum);
 
 	*pdu = npdu;
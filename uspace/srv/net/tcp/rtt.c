@@ -0,0 +1,150 @@
+/*
+ * Copyright (c) 2019 Jiri Svoboda
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * - Redistributions of source code must retain the above copyright
+ *   notice, this list of conditions and the following disclaimer.
+ * - Redistributions in binary form must reproduce the above copyright
+ *   notice, this list of conditions and the following disclaimer in the
+ *   documentation and/or other materials provided with the distribution.
+ * - The name of the author may not be used to endorse or promote products
+ *   derived from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHOR ``AS IS'' AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+ * OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+ * IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT
+ * NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF
+ * THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/** @addtogroup tcp
+ * @{
+ */
+
+/**
+ * @file Round-trip time estimation
+ *
+ * Computes the retransmission timeout from round-trip time samples
+ * as specified by RFC 6298.
+ */
+
+#include <macros.h>
+#include "rtt.h"
+#include "tcp_type.h"
+
+/** Initial retransmission timeout */
+#define RTO_INITIAL	(1000 * 1000)
+
+/** Lower bound on the retransmission timeout.
+ *
+ * RFC 6298 recommends one second. Like most implementations we use
+ * a smaller value, otherwise a single loss on a fast link stalls
+ * the connection for far longer than the path round-trip time.
+ */
+#define RTO_MIN		(200 * 1000)
+
+/** Upper bound on the retransmission timeout */
+#define RTO_MAX		(60 * 1000 * 1000)
+
+/** Timer granularity */
+#define RTT_CLOCK_G	(1000)
+
+/** Clamp retransmission timeout to the allowed range.
+ *
+ * @param rto Retransmission timeout
+ * @return Clamped retransmission timeout
+ */
+static usec_t tcp_rtt_clamp(usec_t rto)
+{
+	if (rto < RTO_MIN)
+		return RTO_MIN;
+	if (rto > RTO_MAX)
+		return RTO_MAX;
+	return rto;
+}
+
+/** Initialize RTT estimator.
+ *
+ * @param rtt RTT estimator
+ */
+void tcp_rtt_init(tcp_rtt_t *rtt)
+{
+	rtt->valid = false;
+	rtt->srtt = 0;
+	rtt->rttvar = 0;
+	rtt->rto = RTO_INITIAL;
+}
+
+/** Update RTT estimator with a new measurement.
+ *
+ * The caller is responsible for not sampling retransmitted segments
+ * (Karn's algorithm).
+ *
+ * @param rtt RTT estimator
+ * @param r   Measured round-trip time
+ */
+void tcp_rtt_sample(tcp_rtt_t *rtt, usec_t r)
+{
+	usec_t delta;
+
+	if (!rtt->valid) {
+		/* First measurement (RFC 6298 2.2) */
+		rtt->srtt = r;
+		rtt->rttvar = r / 2;
+		rtt->valid = true;
+	} else {
+		/* Subsequent measurement (RFC 6298 2.3) */
+		delta = rtt->srtt > r ? rtt->srtt - r : r - rtt->srtt;
+		rtt->rttvar = (3 * rtt->rttvar + delta) / 4;
+		rtt->srtt = (7 * rtt->srtt + r) / 8;
+	}
+
+	rtt->rto = tcp_rtt_clamp(rtt->srtt + max(RTT_CLOCK_G, 4 * rtt->rttvar));
+}
+
+/** Back off the retransmission timer after it has expired.
+ *
+ * @param rtt RTT estimator
+ */
+void tcp_rtt_backoff(tcp_rtt_t *rtt)
+{
+	rtt->rto = tcp_rtt_clamp(2 * rtt->rto);
+}
+
+/** Read timestamp clock.
+ *
+ * The timestamp clock (RFC 7323 5.4) ticks once per millisecond.
+ *
+ * @return Current timestamp value
+ */
+uint32_t tcp_ts_now(void)
+{
+	struct timespec now;
+
+	getuptime(&now);
+	return (uint32_t) (now.tv_sec * 1000 + now.tv_nsec / 1000000);
+}
+
+/** Compute round-trip time from an echoed timestamp.
+ *
+ * @param tsecr Timestamp echo reply from an acknowledgement
+ * @return Round-trip time
+ */
+usec_t tcp_ts_rtt(uint32_t tsecr)
+{
+	/* Count at least one tick to account for clock granularity */
+	return max(tcp_ts_now() - tsecr, 1) * (usec_t) 1000;
+}
+
+/**
+ * @}
+ */
@@ -74,6 +74,15 @@ tcp_segment_t *tcp_segment_dup(tcp_segment_t *seg)
 	scopy->len = seg->len;
 	scopy->wnd = seg->wnd;
 	scopy->up = seg->up;
+	scopy->mss = seg->mss;
+	scopy->sack_perm = seg->sack_perm;
+	scopy->nsack = seg->nsack;
+	memcpy(scopy->sack, seg->sack, sizeof(seg->sack));
+	scopy->has_wscale = seg->has_wscale;
+	scopy->wscale = seg->wscale;
+	scopy->has_ts = seg->has_ts;
+	scopy->tsval = seg->tsval;
+	scopy->tsecr = seg->tsecr;
 
 	tsize = tcp_segment_text_size(seg);
 	scopy->data = calloc(tsize, 1);
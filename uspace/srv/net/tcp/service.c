@@ -676,20 +676,45 @@ static errno_t tcp_conn_send_impl(tcp_client_t *client, sysarg_t conn_id,
 	return EOK;
 }
 
+/** Data read request being answered by tcp_conn_recv_impl() */
+typedef struct {
+	/** Data read call */
+	ipc_call_t *call;
+	/** Call has been answered */
+	bool answered;
+} tcp_recv_req_t;
+
+/** Hand received data directly from receive buffer to the client.
+ *
+ * @param arg  Data read request (tcp_recv_req_t *)
+ * @param data Received data
+ * @param size Number of bytes
+ * @return EOK on success or an error code
+ */
+static errno_t tcp_conn_recv_finalize(void *arg, const void *data, size_t size)
+{
+	tcp_recv_req_t *req = (tcp_recv_req_t *) arg;
+
+	req->answered = true;
+	return async_data_read_finalize(req->call, data, size);
+}
+
 /** Receive data from connection.
  *
  * Handle client request to receive data (with parameters unmarshalled).
+ * Data is copied straight from the connection receive buffer to the
+ * client, answering the data read request.
  *
  * @param client  TCP client
  * @param conn_id Connection ID
- * @param data    Data buffer
+ * @param req     Data read request
  * @param size    Buffer size in bytes
  * @param nrecv   Place to store actual number of bytes received
  *
  * @return EOK on success or an error code
  */
 static errno_t tcp_conn_recv_impl(tcp_client_t *client, sysarg_t conn_id,
-    void *data, size_t size, size_t *nrecv)
+    tcp_recv_req_t *req, size_t size, size_t *nrecv)
 {
 	tcp_cconn_t *cconn;
 	xflags_t xflags;
@@ -704,7 +729,8 @@ static errno_t tcp_conn_recv_impl(tcp_client_t *client, sysarg_t conn_id,
 		return rc;
 	}
 
-	trc = tcp_uc_receive(cconn->conn, data, size, nrecv, &xflags);
+	trc = tcp_uc_receive_direct(cconn->conn, size, tcp_conn_recv_finalize,
+	    req, nrecv, &xflags);
 	if (trc != TCP_EOK) {
 		switch (trc) {
 		case TCP_EAGAIN:
@@ -712,7 +738,8 @@ static errno_t tcp_conn_recv_impl(tcp_client_t *client, sysarg_t conn_id,
 			return EAGAIN;
 		case TCP_ECLOSING:
 			*nrecv = 0;
-			return EOK;
+			req->answered = true;
+			return async_data_read_finalize(req->call, NULL, 0);
 		default:
 			log_msg(LOG_DEFAULT, LVL_DEBUG, "tcp_conn_recv_impl() - trc=%d", trc);
 			return EIO;
@@ -1007,9 +1034,9 @@ static void tcp_conn_send_srv(tcp_client_t *client, ipc_call_t *icall)
 static void tcp_conn_recv_srv(tcp_client_t *client, ipc_call_t *icall)
 {
 	ipc_call_t call;
+	tcp_recv_req_t req;
 	sysarg_t conn_id;
 	size_t size, rsize;
-	void *data;
 	errno_t rc;
 
 	log_msg(LOG_DEFAULT, LVL_DEBUG, "tcp_conn_recv_srv()");
@@ -1022,31 +1049,18 @@ static void tcp_conn_recv_srv(tcp_client_t *client, ipc_call_t *icall)
 		return;
 	}
 
-	size = min(size, 16384);
-	data = malloc(size);
-	if (data == NULL) {
-		async_answer_0(&call, ENOMEM);
-		async_answer_0(icall, ENOMEM);
-		return;
-	}
-
-	rc = tcp_conn_recv_impl(client, conn_id, data, size, &rsize);
-	if (rc != EOK) {
-		async_answer_0(&call, rc);
-		async_answer_0(icall, rc);
-		free(data);
-		return;
-	}
+	req.call = &call;
+	req.answered = false;
 
-	rc = async_data_read_finalize(&call, data, size);
+	rc = tcp_conn_recv_impl(client, conn_id, &req, size, &rsize);
 	if (rc != EOK) {
+		if (!req.answered)
+			async_answer_0(&call, rc);
 		async_answer_0(icall, rc);
-		free(data);
 		return;
 	}
 
 	async_answer_1(icall, EOK, rsize);
-	free(data);
 
 	log_msg(LOG_DEFAULT, LVL_DEBUG, "tcp_conn_recv_srv(): OK");
 }
@@ -1062,9 +1076,9 @@ static void tcp_conn_recv_srv(tcp_client_t *client, ipc_call_t *icall)
 static void tcp_conn_recv_wait_srv(tcp_client_t *client, ipc_call_t *icall)
 {
 	ipc_call_t call;
+	tcp_recv_req_t req;
 	sysarg_t conn_id;
 	size_t size, rsize;
-	void *data;
 	errno_t rc;
 
 	log_msg(LOG_DEFAULT, LVL_DEBUG, "tcp_conn_recv_wait_srv()");
@@ -1078,35 +1092,20 @@ static void tcp_conn_recv_wait_srv(tcp_client_t *client, ipc_call_t *icall)
 		return;
 	}
 
-	size = min(size, 16384);
-	data = malloc(size);
-	if (data == NULL) {
-		log_msg(LOG_DEFAULT, LVL_DEBUG, "tcp_conn_recv_wait_srv - allocation failed");
-		async_answer_0(&call, ENOMEM);
-		async_answer_0(icall, ENOMEM);
-		return;
-	}
+	req.call = &call;
+	req.answered = false;
 
-	rc = tcp_conn_recv_impl(client, conn_id, data, size, &rsize);
+	rc = tcp_conn_recv_impl(client, conn_id, &req, size, &rsize);
 	if (rc != EOK) {
 		log_msg(LOG_DEFAULT, LVL_DEBUG, "tcp_conn_recv_wait_srv - recv_impl failed rc=%s", str_error_name(rc));
-		async_answer_0(&call, rc);
-		async_answer_0(icall, rc);
-		free(data);
-		return;
-	}
-
-	rc = async_data_read_finalize(&call, data, size);
-	if (rc != EOK) {
-		log_msg(LOG_DEFAULT, LVL_DEBUG, "tcp_conn_recv_wait_srv - finalize failed");
+		if (!req.answered)
+			async_answer_0(&call, rc);
 		async_answer_0(icall, rc);
-		free(data);
 		return;
 	}
 
-	log_msg(LOG_DEFAULT, LVL_DEBUG, "tcp_conn_recv_wait_srv(): rsize=%zu", size);
+	log_msg(LOG_DEFAULT, LVL_DEBUG, "tcp_conn_recv_wait_srv(): rsize=%zu", rsize);
 	async_answer_1(icall, EOK, rsize);
-	free(data);
 
 	log_msg(LOG_DEFAULT, LVL_DEBUG, "tcp_conn_recv_wait_srv(): OK");
 }
@@ -109,9 +109,26 @@ enum opt_kind {
 	/** No-operation */
 	OPT_NOP			= 1,
 	/** Maximum segment size */
-	OPT_MAX_SEG_SIZE	= 2
+	OPT_MAX_SEG_SIZE	= 2,
+	/** Window scale */
+	OPT_WINDOW_SCALE	= 3,
+	/** SACK permitted */
+	OPT_SACK_PERMITTED	= 4,
+	/** SACK */
+	OPT_SACK		= 5,
+	/** Timestamps */
+	OPT_TIMESTAMP		= 8
 };
 
+/** Maximum size of TCP options */
+#define TCP_OPTS_MAX_SIZE 40
+
+/** Size of the timestamp option including padding (RFC 7323 Appendix A) */
+#define TCP_OPT_TS_SIZE 12
+
+/** Maximum window scale shift count (RFC 7323 2.3) */
+#define TCP_WSCALE_MAX 14
+
 #endif
 
 /** @}
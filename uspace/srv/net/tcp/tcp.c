@@ -38,6 +38,7 @@
 #include <errno.h>
 #include <io/log.h>
 #include <stdio.h>
+#include <str.h>
 #include <task.h>
 
 #include "conn.h"
@@ -54,12 +55,11 @@ static tcp_rqueue_cb_t tcp_rqueue_cb = {
 	.seg_received = tcp_as_segment_arrived
 };
 
-static errno_t tcp_init(void)
+/** Initialize protocol core (everything except network and service). */
+static errno_t tcp_core_init(void)
 {
 	errno_t rc;
 
-	log_msg(LOG_DEFAULT, LVL_DEBUG, "tcp_init()");
-
 	rc = tcp_conns_init();
 	if (rc != EOK) {
 		assert(rc == ENOMEM);
@@ -73,6 +73,19 @@ static errno_t tcp_init(void)
 	tcp_ncsim_init();
 	tcp_ncsim_fibril_start();
 
+	return EOK;
+}
+
+static errno_t tcp_init(void)
+{
+	errno_t rc;
+
+	log_msg(LOG_DEFAULT, LVL_DEBUG, "tcp_init()");
+
+	rc = tcp_core_init();
+	if (rc != EOK)
+		return rc;
+
 	if (0)
 		tcp_test();
 
@@ -101,6 +114,16 @@ int main(int argc, char **argv)
 		return 1;
 	}
 
+	if (argc == 2 && str_cmp(argv[1], "--goodput") == 0) {
+		/* Benchmark over internal loopback, do not register service */
+		rc = tcp_core_init();
+		if (rc != EOK)
+			return 1;
+
+		tcp_test_goodput();
+		return 0;
+	}
+
 	rc = tcp_init();
 	if (rc != EOK)
 		return 1;
@@ -43,11 +43,15 @@
 #include <refcount.h>
 #include <stddef.h>
 #include <stdint.h>
+#include <time.h>
 #include <inet/addr.h>
 #include <inet/endpoint.h>
 
 struct tcp_conn;
 
+/** Maximum number of SACK blocks carried by a segment */
+#define TCP_SACK_BLOCKS_MAX 4
+
 /** Connection state */
 typedef enum {
 	/** Listen */
@@ -124,6 +128,8 @@ typedef enum {
 typedef struct {
 	struct tcp_conn *conn;
 	list_t list;
+	/** Sequence number of the most recently queued segment */
+	uint32_t recent;
 } tcp_iqueue_t;
 
 /** Active or passive connection */
@@ -148,12 +154,32 @@ typedef struct {
 	void (*recv_data)(tcp_conn_t *, void *);
 } tcp_cb_t;
 
+/** Consumer of received data.
+ *
+ * Used to hand received data directly from the receive buffer to
+ * the reader.
+ *
+ * @param arg  Argument
+ * @param data Received data
+ * @param size Number of bytes
+ * @return EOK on success, error code if data could not be consumed
+ */
+typedef errno_t (*tcp_rcv_fn_t)(void *, const void *, size_t);
+
 /** Data returned by Status user call */
 typedef struct {
 	/** Connection state */
 	tcp_cstate_t cstate;
 } tcp_conn_status_t;
 
+/** SACK block (RFC 2018) */
+typedef struct {
+	/** First sequence number of the block */
+	uint32_t left;
+	/** Sequence number immediately following the block */
+	uint32_t right;
+} tcp_sack_blk_t;
+
 typedef struct {
 	/** SYN, FIN */
 	tcp_control_t ctrl;
@@ -169,6 +195,25 @@ typedef struct {
 	/** Segment urgent pointer */
 	uint32_t up;
 
+	/** Maximum segment size option (zero if not present) */
+	uint16_t mss;
+	/** SACK-permitted option present */
+	bool sack_perm;
+	/** Number of SACK blocks */
+	size_t nsack;
+	/** SACK blocks */
+	tcp_sack_blk_t sack[TCP_SACK_BLOCKS_MAX];
+	/** Window scale option present */
+	bool has_wscale;
+	/** Window scale shift count */
+	uint8_t wscale;
+	/** Timestamps option present */
+	bool has_ts;
+	/** Timestamp value */
+	uint32_t tsval;
+	/** Timestamp echo reply */
+	uint32_t tsecr;
+
 	/** Segment data, may be moved when trimming segment */
 	void *data;
 	/** Segment data, original pointer used to free data */
@@ -191,7 +236,8 @@ typedef struct {
 /** NCSim queue entry */
 typedef struct {
 	link_t link;
-	usec_t delay;
+	/** Time when the segment should be delivered */
+	struct timespec due;
 	inet_ep2_t epp;
 	tcp_segment_t *seg;
 } tcp_squeue_entry_t;
@@ -207,6 +253,14 @@ typedef struct {
 	link_t link;
 	tcp_conn_t *conn;
 	tcp_segment_t *seg;
+	/** Time of the most recent transmission */
+	struct timespec sent;
+	/** Segment has been retransmitted (not usable for RTT sampling) */
+	bool retx;
+	/** Segment has been selectively acknowledged by the peer */
+	bool sacked;
+	/** Segment is deemed lost and awaits retransmission */
+	bool lost;
 } tcp_tqueue_entry_t;
 
 /** Retransmission queue callbacks */
@@ -222,11 +276,80 @@ typedef struct {
 
 	/** Retransmission timer */
 	fibril_timer_t *timer;
+	/** Number of consecutive retransmission timeouts */
+	unsigned backoff;
 
 	/** Callbacks */
 	tcp_tqueue_cb_t *cb;
 } tcp_tqueue_t;
 
+/** Congestion control algorithm.
+ *
+ * The generic part (congctl.c) implements fast retransmit and recovery,
+ * the algorithm decides how the congestion window grows and how much
+ * it shrinks on congestion.
+ */
+typedef struct {
+	/** Algorithm name */
+	const char *name;
+	/** Initialize algorithm state */
+	void (*init)(tcp_conn_t *);
+	/** New data was acknowledged outside of recovery (number of bytes) */
+	void (*cong_avoid)(tcp_conn_t *, uint32_t);
+	/** Congestion was detected, return new slow start threshold */
+	uint32_t (*ssthresh)(tcp_conn_t *);
+} tcp_cc_ops_t;
+
+/** CUBIC congestion control state */
+typedef struct {
+	/** Window size just before the last reduction (bytes) */
+	uint32_t w_max;
+	/** Window size before the previous reduction (bytes) */
+	uint32_t w_last_max;
+	/** Start of the current congestion avoidance epoch */
+	struct timespec epoch_start;
+	/** @c true if @c epoch_start is valid */
+	bool epoch_valid;
+	/** Window size at the start of the epoch (bytes) */
+	uint32_t origin;
+	/** Time until the window reaches @c origin again (ms) */
+	uint32_t k;
+	/** Window estimate of a standard TCP flow (bytes) */
+	uint32_t w_est;
+} tcp_cubic_t;
+
+/** Congestion control state */
+typedef struct {
+	/** Algorithm */
+	const tcp_cc_ops_t *ops;
+	/** Congestion window (bytes) */
+	uint32_t cwnd;
+	/** Slow start threshold (bytes) */
+	uint32_t ssthresh;
+	/** Number of consecutive duplicate ACKs */
+	unsigned dupacks;
+	/** In fast recovery */
+	bool in_recovery;
+	/** Highest sequence number sent when recovery was entered */
+	uint32_t recover;
+	/** Algorithm-specific state */
+	union {
+		tcp_cubic_t cubic;
+	} alg;
+} tcp_cc_t;
+
+/** Round-trip time estimator state (RFC 6298) */
+typedef struct {
+	/** At least one RTT sample was taken */
+	bool valid;
+	/** Smoothed round-trip time */
+	usec_t srtt;
+	/** Round-trip time variation */
+	usec_t rttvar;
+	/** Retransmission timeout */
+	usec_t rto;
+} tcp_rtt_t;
+
 /** Connection */
 struct tcp_conn {
 	char *name;
@@ -267,6 +390,10 @@ struct tcp_conn {
 
 	/** Retransmission queue */
 	tcp_tqueue_t retransmit;
+	/** Round-trip time estimator */
+	tcp_rtt_t rtt;
+	/** Congestion control */
+	tcp_cc_t cc;
 
 	/** Time-Wait timeout timer */
 	fibril_timer_t *tw_timer;
@@ -275,8 +402,16 @@ struct tcp_conn {
 	uint8_t *rcv_buf;
 	/** Receive buffer size */
 	size_t rcv_buf_size;
+	/** Receive buffer maximum size the buffer can be grown to */
+	size_t rcv_buf_max;
+	/** Offset of first unread byte in receive buffer */
+	size_t rcv_buf_start;
 	/** Receive buffer number of bytes used */
 	size_t rcv_buf_used;
+	/** Bytes read by user since @c rcv_space_time (buffer auto-tuning) */
+	size_t rcv_space_copied;
+	/** Start of current receive buffer auto-tuning measurement */
+	struct timespec rcv_space_time;
 	/** Receive buffer contains FIN */
 	bool rcv_buf_fin;
 	/** Receive buffer CV. Broadcast when new data is inserted */
@@ -286,6 +421,8 @@ struct tcp_conn {
 	uint8_t *snd_buf;
 	/** Send buffer size */
 	size_t snd_buf_size;
+	/** Send buffer maximum size the buffer can be grown to */
+	size_t snd_buf_max;
 	/** Send buffer number of bytes used */
 	size_t snd_buf_used;
 	/** Send buffer contains FIN */
@@ -307,6 +444,28 @@ struct tcp_conn {
 	uint32_t snd_wl2;
 	/** Initial send sequence number */
 	uint32_t iss;
+	/** Send maximum segment size */
+	uint16_t snd_mss;
+	/** Offer SACK to the peer */
+	bool sack_perm;
+	/** Both sides agreed on using SACK */
+	bool sack_ok;
+	/** Offer window scaling to the peer */
+	bool wscale_perm;
+	/** Both sides agreed on window scaling */
+	bool wscale_ok;
+	/** Shift count for windows received from the peer */
+	uint8_t snd_wscale;
+	/** Shift count for windows we send to the peer */
+	uint8_t rcv_wscale;
+	/** Offer timestamps to the peer */
+	bool ts_perm;
+	/** Both sides agreed on using timestamps */
+	bool ts_ok;
+	/** Timestamp to echo in next segment sent (TS.Recent) */
+	uint32_t ts_recent;
+	/** Last acknowledgement number sent (Last.ACK.sent) */
+	uint32_t last_ack_sent;
 
 	/** Receive next */
 	uint32_t rcv_nxt;
@@ -386,9 +545,21 @@ typedef enum {
 	/** Segment loopback */
 	tcp_lb_segment,
 	/** PDU loopback */
-	tcp_lb_pdu
+	tcp_lb_pdu,
+	/** Segment loopback through the network condition simulator */
+	tcp_lb_ncsim
 } tcp_lb_t;
 
+/** Network condition simulator configuration */
+typedef struct {
+	/** Probability of dropping a segment (per mille) */
+	unsigned loss;
+	/** One-way delay */
+	usec_t delay;
+	/** Maximum random delay added to @c delay */
+	usec_t jitter;
+} tcp_ncsim_cfg_t;
+
 #endif
 
 /** @}
@@ -37,8 +37,17 @@
 #include <async.h>
 #include <errno.h>
 #include <stdio.h>
+#include <stdlib.h>
 #include <fibril.h>
+#include <fibril_synch.h>
 #include <str.h>
+#include <str_error.h>
+#include <time.h>
+#include "congctl.h"
+#include "conn.h"
+#include "cubic.h"
+#include "ncsim.h"
+#include "newreno.h"
 #include "tcp_type.h"
 #include "ucall.h"
 
@@ -46,6 +55,54 @@
 
 #define RCV_BUF_SIZE 64
 
+/** Amount of data transferred in each goodput run */
+#define GP_XFER_SIZE (512 * 1024)
+/** Size of user buffers used in goodput runs */
+#define GP_CHUNK_SIZE 4096
+/** Base port numbers for goodput runs (each run uses a distinct pair) */
+#define GP_SRV_PORT 8000
+#define GP_CLI_PORT 9000
+
+/** Goodput run */
+typedef struct {
+	/** Server port */
+	uint16_t srv_port;
+	/** Client port */
+	uint16_t cli_port;
+	/** Number of bytes received by server */
+	size_t rcvd;
+	/** Server has received all data */
+	bool done;
+	fibril_mutex_t lock;
+	fibril_condvar_t cv;
+} tcp_gp_run_t;
+
+/** Goodput network condition */
+typedef struct {
+	const char *name;
+	tcp_ncsim_cfg_t cfg;
+} tcp_gp_cond_t;
+
+static tcp_gp_cond_t gp_conds[] = {
+	{
+		.name = "no loss, no delay",
+		.cfg = { .loss = 0, .delay = 0, .jitter = 0 }
+	},
+	{
+		.name = "1% loss, 10 ms",
+		.cfg = { .loss = 10, .delay = 10000, .jitter = 1000 }
+	},
+	{
+		.name = "5% loss, 50 ms",
+		.cfg = { .loss = 50, .delay = 50000, .jitter = 5000 }
+	}
+};
+
+static const tcp_cc_ops_t *gp_algs[] = {
+	&tcp_cc_newreno,
+	&tcp_cc_cubic
+};
+
 static errno_t test_srv(void *arg)
 {
 	tcp_conn_t *conn;
@@ -122,6 +179,184 @@ static errno_t test_cli(void *arg)
 	return 0;
 }
 
+/** Goodput test server fibril. */
+static errno_t test_gp_srv(void *arg)
+{
+	tcp_gp_run_t *run = (tcp_gp_run_t *) arg;
+	tcp_conn_t *conn;
+	inet_ep2_t epp;
+	char *buf;
+	size_t rcvd;
+	xflags_t xflags;
+	tcp_error_t trc;
+
+	buf = malloc(GP_CHUNK_SIZE);
+	if (buf == NULL)
+		goto done;
+
+	inet_ep2_init(&epp);
+	inet_addr(&epp.local.addr, 127, 0, 0, 1);
+	epp.local.port = run->srv_port;
+	inet_addr(&epp.remote.addr, 127, 0, 0, 1);
+	epp.remote.port = run->cli_port;
+
+	if (tcp_uc_open(&epp, ap_passive, 0, &conn) != TCP_EOK)
+		goto done;
+	conn->name = (char *) "GS";
+
+	while (true) {
+		/* tcp_uc_receive() does not block */
+		tcp_conn_lock(conn);
+		while (conn->rcv_buf_used == 0 && !conn->rcv_buf_fin &&
+		    !conn->reset)
+			fibril_condvar_wait(&conn->rcv_buf_cv, &conn->lock);
+		tcp_conn_unlock(conn);
+
+		trc = tcp_uc_receive(conn, buf, GP_CHUNK_SIZE, &rcvd, &xflags);
+		if (trc != TCP_EOK)
+			break;
+
+		run->rcvd += rcvd;
+	}
+
+	tcp_uc_close(conn);
+	tcp_uc_delete(conn);
+done:
+	free(buf);
+	fibril_mutex_lock(&run->lock);
+	run->done = true;
+	fibril_condvar_broadcast(&run->cv);
+	fibril_mutex_unlock(&run->lock);
+	return 0;
+}
+
+/** Run one goodput measurement.
+ *
+ * @param run Run parameters
+ * @param rate Place to store goodput in KiB/s
+ * @return EOK on success, EIO if data was lost or connection failed
+ */
+static errno_t test_gp_run(tcp_gp_run_t *run, unsigned *rate)
+{
+	tcp_conn_t *conn;
+	inet_ep2_t epp;
+	struct timespec start, end;
+	char *buf;
+	size_t sent;
+	fid_t srv_fid;
+	usec_t dur;
+
+	buf = calloc(1, GP_CHUNK_SIZE);
+	if (buf == NULL)
+		return ENOMEM;
+
+	fibril_mutex_initialize(&run->lock);
+	fibril_condvar_initialize(&run->cv);
+	run->rcvd = 0;
+	run->done = false;
+
+	srv_fid = fibril_create(test_gp_srv, run);
+	if (srv_fid == 0) {
+		free(buf);
+		return ENOMEM;
+	}
+
+	fibril_add_ready(srv_fid);
+	fibril_yield();
+
+	inet_ep2_init(&epp);
+	inet_addr(&epp.local.addr, 127, 0, 0, 1);
+	epp.local.port = run->cli_port;
+	inet_addr(&epp.remote.addr, 127, 0, 0, 1);
+	epp.remote.port = run->srv_port;
+
+	getuptime(&start);
+
+	if (tcp_uc_open(&epp, ap_active, 0, &conn) == TCP_EOK) {
+		conn->name = (char *) "GC";
+
+		sent = 0;
+		while (sent < GP_XFER_SIZE) {
+			if (tcp_uc_send(conn, buf, GP_CHUNK_SIZE, 0) != TCP_EOK)
+				break;
+			sent += GP_CHUNK_SIZE;
+		}
+
+		tcp_uc_close(conn);
+	} else {
+		conn = NULL;
+	}
+
+	fibril_mutex_lock(&run->lock);
+	while (!run->done)
+		fibril_condvar_wait(&run->cv, &run->lock);
+	fibril_mutex_unlock(&run->lock);
+
+	getuptime(&end);
+
+	if (conn != NULL)
+		tcp_uc_delete(conn);
+	free(buf);
+
+	if (run->rcvd != GP_XFER_SIZE)
+		return EIO;
+
+	dur = NSEC2USEC(ts_sub_diff(&end, &start));
+	if (dur == 0)
+		dur = 1;
+
+	*rate = (uint64_t) GP_XFER_SIZE * 1000000 / 1024 / dur;
+	return EOK;
+}
+
+/** Measure goodput under simulated network conditions.
+ *
+ * Transfer data over the internal loopback through the network
+ * condition simulator using each congestion control algorithm.
+ */
+void tcp_test_goodput(void)
+{
+	const tcp_cc_ops_t *old_default;
+	tcp_lb_t old_lb;
+	tcp_gp_run_t run;
+	unsigned rate;
+	unsigned n;
+	size_t i, j;
+	errno_t rc;
+
+	old_default = tcp_cc_default;
+	old_lb = tcp_conn_lb;
+	tcp_conn_lb = tcp_lb_ncsim;
+	n = 0;
+
+	printf("Transferring %u KiB per run.\n", GP_XFER_SIZE / 1024);
+
+	for (i = 0; i < sizeof(gp_algs) / sizeof(gp_algs[0]); i++) {
+		tcp_cc_default = gp_algs[i];
+
+		for (j = 0; j < sizeof(gp_conds) / sizeof(gp_conds[0]); j++) {
+			tcp_ncsim_set_cfg(&gp_conds[j].cfg);
+
+			run.srv_port = GP_SRV_PORT + n;
+			run.cli_port = GP_CLI_PORT + n;
+			++n;
+
+			rc = test_gp_run(&run, &rate);
+			if (rc == EOK) {
+				printf("%-8s %-20s %8u KiB/s\n",
+				    gp_algs[i]->name, gp_conds[j].name, rate);
+			} else {
+				printf("%-8s %-20s failed (%s)\n",
+				    gp_algs[i]->name, gp_conds[j].name,
+				    str_error(rc));
+			}
+		}
+	}
+
+	tcp_cc_default = old_default;
+	tcp_conn_lb = old_lb;
+}
+
 void tcp_test(void)
 {
 	fid_t srv_fid;
@@ -36,6 +36,7 @@
 #define TEST_H
 
 extern void tcp_test(void);
+extern void tcp_test_goodput(void);
 
 #endif
 
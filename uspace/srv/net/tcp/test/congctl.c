@@ -0,0 +1,221 @@
+/*
+ * Copyright (c) 2019 Jiri Svoboda
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * - Redistributions of source code must retain the above copyright
+ *   notice, this list of conditions and the following disclaimer.
+ * - Redistributions in binary form must reproduce the above copyright
+ *   notice, this list of conditions and the following disclaimer in the
+ *   documentation and/or other materials provided with the distribution.
+ * - The name of the author may not be used to endorse or promote products
+ *   derived from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHOR ``AS IS'' AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+ * OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+ * IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT
+ * NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF
+ * THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <inet/endpoint.h>
+#include <pcut/pcut.h>
+
+#include "../congctl.h"
+#include "../conn.h"
+#include "../cubic.h"
+#include "../newreno.h"
+
+PCUT_INIT;
+
+PCUT_TEST_SUITE(congctl);
+
+/** Test looking up algorithms by name */
+PCUT_TEST(find)
+{
+	PCUT_ASSERT_EQUALS(&tcp_cc_newreno, tcp_cc_find("newreno"));
+	PCUT_ASSERT_EQUALS(&tcp_cc_cubic, tcp_cc_find("cubic"));
+	PCUT_ASSERT_NULL(tcp_cc_find("nonexistent"));
+}
+
+/** Test initial window depends on MSS */
+PCUT_TEST(initial_window)
+{
+	tcp_conn_t *conn;
+	inet_ep2_t epp;
+
+	inet_ep2_init(&epp);
+	conn = tcp_conn_new(&epp);
+	PCUT_ASSERT_NOT_NULL(conn);
+
+	conn->snd_mss = 536;
+	tcp_cc_init(conn);
+	PCUT_ASSERT_INT_EQUALS(4 * 536, conn->cc.cwnd);
+
+	conn->snd_mss = 1460;
+	tcp_cc_init(conn);
+	PCUT_ASSERT_INT_EQUALS(3 * 1460, conn->cc.cwnd);
+
+	conn->snd_mss = 4000;
+	tcp_cc_init(conn);
+	PCUT_ASSERT_INT_EQUALS(2 * 4000, conn->cc.cwnd);
+
+	PCUT_ASSERT_INT_EQUALS(UINT32_MAX, conn->cc.ssthresh);
+	PCUT_ASSERT_FALSE(conn->cc.in_recovery);
+
+	tcp_conn_delete(conn);
+}
+
+/** Test NewReno slow start and congestion avoidance */
+PCUT_TEST(newreno_grow)
+{
+	tcp_conn_t *conn;
+	inet_ep2_t epp;
+
+	inet_ep2_init(&epp);
+	conn = tcp_conn_new(&epp);
+	PCUT_ASSERT_NOT_NULL(conn);
+
+	conn->cc.ops = &tcp_cc_newreno;
+	conn->snd_mss = 1460;
+	tcp_cc_init(conn);
+
+	/* Slow start, grow by at most one MSS per ACK */
+	PCUT_ASSERT_FALSE(tcp_cc_ack(conn, 2920));
+	PCUT_ASSERT_INT_EQUALS(4 * 1460, conn->cc.cwnd);
+
+	/* Congestion avoidance, grow by about one MSS per RTT */
+	conn->cc.ssthresh = 4000;
+	PCUT_ASSERT_FALSE(tcp_cc_ack(conn, 1460));
+	PCUT_ASSERT_INT_EQUALS(4 * 1460 + 365, conn->cc.cwnd);
+
+	tcp_conn_delete(conn);
+}
+
+/** Test NewReno fast retransmit and fast recovery */
+PCUT_TEST(newreno_recovery)
+{
+	tcp_conn_t *conn;
+	inet_ep2_t epp;
+
+	inet_ep2_init(&epp);
+	conn = tcp_conn_new(&epp);
+	PCUT_ASSERT_NOT_NULL(conn);
+
+	conn->cc.ops = &tcp_cc_newreno;
+	conn->snd_mss = 1460;
+	conn->snd_una = 0;
+	tcp_cc_init(conn);
+
+	conn->snd_una = 1000;
+	conn->snd_nxt = 1000 + 10 * 1460;
+
+	PCUT_ASSERT_FALSE(tcp_cc_dupack(conn));
+	PCUT_ASSERT_FALSE(tcp_cc_dupack(conn));
+
+	/* Third duplicate ACK, enter fast recovery */
+	PCUT_ASSERT_TRUE(tcp_cc_dupack(conn));
+	PCUT_ASSERT_TRUE(conn->cc.in_recovery);
+	PCUT_ASSERT_INT_EQUALS(5 * 1460, conn->cc.ssthresh);
+	PCUT_ASSERT_INT_EQUALS(8 * 1460, conn->cc.cwnd);
+	PCUT_ASSERT_INT_EQUALS(conn->snd_nxt, conn->cc.recover);
+
+	/* Further duplicate ACKs inflate the window */
+	PCUT_ASSERT_FALSE(tcp_cc_dupack(conn));
+	PCUT_ASSERT_INT_EQUALS(9 * 1460, conn->cc.cwnd);
+
+	/* Partial ACK, stay in recovery */
+	conn->snd_una += 1460;
+	PCUT_ASSERT_TRUE(tcp_cc_ack(conn, 1460));
+	PCUT_ASSERT_TRUE(conn->cc.in_recovery);
+	PCUT_ASSERT_INT_EQUALS(9 * 1460, conn->cc.cwnd);
+
+	/* Full ACK, leave recovery and deflate window */
+	conn->snd_una = conn->snd_nxt;
+	PCUT_ASSERT_FALSE(tcp_cc_ack(conn, 9 * 1460));
+	PCUT_ASSERT_FALSE(conn->cc.in_recovery);
+	PCUT_ASSERT_INT_EQUALS(2 * 1460, conn->cc.cwnd);
+
+	tcp_conn_delete(conn);
+}
+
+/** Test retransmission timeout collapses the window */
+PCUT_TEST(timeout)
+{
+	tcp_conn_t *conn;
+	inet_ep2_t epp;
+
+	inet_ep2_init(&epp);
+	conn = tcp_conn_new(&epp);
+	PCUT_ASSERT_NOT_NULL(conn);
+
+	conn->cc.ops = &tcp_cc_newreno;
+	conn->snd_mss = 1460;
+	tcp_cc_init(conn);
+
+	conn->snd_una = 1000;
+	conn->snd_nxt = 1000 + 10 * 1460;
+
+	tcp_cc_timeout(conn, false);
+	PCUT_ASSERT_INT_EQUALS(1460, conn->cc.cwnd);
+	PCUT_ASSERT_INT_EQUALS(5 * 1460, conn->cc.ssthresh);
+
+	/* Repeated timeout keeps the slow start threshold */
+	tcp_cc_timeout(conn, true);
+	PCUT_ASSERT_INT_EQUALS(1460, conn->cc.cwnd);
+	PCUT_ASSERT_INT_EQUALS(5 * 1460, conn->cc.ssthresh);
+
+	tcp_conn_delete(conn);
+}
+
+/** Test CUBIC multiplicative decrease and window growth */
+PCUT_TEST(cubic)
+{
+	tcp_conn_t *conn;
+	inet_ep2_t epp;
+	uint32_t cwnd;
+	int i;
+
+	inet_ep2_init(&epp);
+	conn = tcp_conn_new(&epp);
+	PCUT_ASSERT_NOT_NULL(conn);
+
+	conn->cc.ops = &tcp_cc_cubic;
+	conn->snd_mss = 1460;
+	conn->snd_una = 0;
+	tcp_cc_init(conn);
+
+	conn->snd_una = 1000;
+	conn->snd_nxt = 1000 + 10 * 1460;
+	conn->cc.cwnd = 10 * 1460;
+
+	tcp_cc_dupack(conn);
+	tcp_cc_dupack(conn);
+	PCUT_ASSERT_TRUE(tcp_cc_dupack(conn));
+
+	/* Beta is 0.7 */
+	PCUT_ASSERT_INT_EQUALS(7 * 1460, conn->cc.ssthresh);
+
+	conn->snd_una = conn->snd_nxt;
+	PCUT_ASSERT_FALSE(tcp_cc_ack(conn, 10 * 1460));
+	PCUT_ASSERT_FALSE(conn->cc.in_recovery);
+
+	/* Window never shrinks in congestion avoidance */
+	for (i = 0; i < 10; i++) {
+		cwnd = conn->cc.cwnd;
+		tcp_cc_ack(conn, 1460);
+		PCUT_ASSERT_TRUE(conn->cc.cwnd >= cwnd);
+	}
+
+	tcp_conn_delete(conn);
+}
+
+PCUT_EXPORT(congctl);
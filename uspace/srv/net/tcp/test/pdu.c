@@ -108,4 +108,92 @@ PCUT_TEST(encdec_data)
 	free(data);
 }
 
+/** Test encode/decode round trip for SYN and ACK options */
+PCUT_TEST(encdec_opts)
+{
+	tcp_segment_t *seg, *dseg;
+	tcp_pdu_t *pdu;
+	inet_ep2_t epp, depp;
+	errno_t rc;
+
+	inet_ep2_init(&epp);
+	inet_addr(&epp.local.addr, 1, 2, 3, 4);
+	inet_addr(&epp.remote.addr, 5, 6, 7, 8);
+
+	/* Maximum segment size and SACK permitted */
+	seg = tcp_segment_make_ctrl(CTL_SYN);
+	PCUT_ASSERT_NOT_NULL(seg);
+
+	seg->seq = 20;
+	seg->mss = 1460;
+	seg->sack_perm = true;
+	seg->has_wscale = true;
+	seg->wscale = 7;
+	seg->has_ts = true;
+	seg->tsval = 0x12345678;
+	seg->tsecr = 0;
+
+	rc = tcp_pdu_encode(&epp, seg, &pdu);
+	PCUT_ASSERT_ERRNO_VAL(EOK, rc);
+	rc = tcp_pdu_decode(pdu, &depp, &dseg);
+	PCUT_ASSERT_ERRNO_VAL(EOK, rc);
+
+	test_seg_same(seg, dseg);
+	PCUT_ASSERT_INT_EQUALS(1460, dseg->mss);
+	PCUT_ASSERT_TRUE(dseg->sack_perm);
+	PCUT_ASSERT_INT_EQUALS(0, dseg->nsack);
+	PCUT_ASSERT_TRUE(dseg->has_wscale);
+	PCUT_ASSERT_INT_EQUALS(7, dseg->wscale);
+	PCUT_ASSERT_TRUE(dseg->has_ts);
+	PCUT_ASSERT_INT_EQUALS(0x12345678, dseg->tsval);
+	PCUT_ASSERT_INT_EQUALS(0, dseg->tsecr);
+
+	tcp_pdu_delete(pdu);
+	tcp_segment_delete(dseg);
+	tcp_segment_delete(seg);
+
+	/* SACK blocks */
+	seg = tcp_segment_make_ctrl(CTL_ACK);
+	PCUT_ASSERT_NOT_NULL(seg);
+
+	seg->seq = 20;
+	seg->ack = 100;
+	seg->has_ts = true;
+	seg->tsval = 1000;
+	seg->tsecr = 900;
+	seg->nsack = 4;
+	seg->sack[0].left = 300;
+	seg->sack[0].right = 400;
+	seg->sack[1].left = 150;
+	seg->sack[1].right = 200;
+	seg->sack[2].left = 500;
+	seg->sack[2].right = 600;
+	seg->sack[3].left = 700;
+	seg->sack[3].right = 800;
+
+	rc = tcp_pdu_encode(&epp, seg, &pdu);
+	PCUT_ASSERT_ERRNO_VAL(EOK, rc);
+	rc = tcp_pdu_decode(pdu, &depp, &dseg);
+	PCUT_ASSERT_ERRNO_VAL(EOK, rc);
+
+	test_seg_same(seg, dseg);
+	PCUT_ASSERT_INT_EQUALS(0, dseg->mss);
+	PCUT_ASSERT_FALSE(dseg->sack_perm);
+	PCUT_ASSERT_FALSE(dseg->has_wscale);
+	PCUT_ASSERT_TRUE(dseg->has_ts);
+	PCUT_ASSERT_INT_EQUALS(1000, dseg->tsval);
+	PCUT_ASSERT_INT_EQUALS(900, dseg->tsecr);
+
+	/* Only three SACK blocks fit alongside timestamps */
+	PCUT_ASSERT_INT_EQUALS(3, dseg->nsack);
+	PCUT_ASSERT_INT_EQUALS(300, dseg->sack[0].left);
+	PCUT_ASSERT_INT_EQUALS(400, dseg->sack[0].right);
+	PCUT_ASSERT_INT_EQUALS(150, dseg->sack[1].left);
+	PCUT_ASSERT_INT_EQUALS(200, dseg->sack[1].right);
+
+	tcp_pdu_delete(pdu);
+	tcp_segment_delete(dseg);
+	tcp_segment_delete(seg);
+}
+
 PCUT_EXPORT(pdu);
@@ -0,0 +1,107 @@
+/*
+ * Copyright (c) 2019 Jiri Svoboda
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * - Redistributions of source code must retain the above copyright
+ *   notice, this list of conditions and the following disclaimer.
+ * - Redistributions in binary form must reproduce the above copyright
+ *   notice, this list of conditions and the following disclaimer in the
+ *   documentation and/or other materials provided with the distribution.
+ * - The name of the author may not be used to endorse or promote products
+ *   derived from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHOR ``AS IS'' AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+ * OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+ * IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT
+ * NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF
+ * THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <pcut/pcut.h>
+
+#include "../rtt.h"
+#include "../tcp_type.h"
+
+PCUT_INIT;
+
+PCUT_TEST_SUITE(rtt);
+
+/** Test initial retransmission timeout */
+PCUT_TEST(init)
+{
+	tcp_rtt_t rtt;
+
+	tcp_rtt_init(&rtt);
+	PCUT_ASSERT_FALSE(rtt.valid);
+	PCUT_ASSERT_INT_EQUALS(1000 * 1000, rtt.rto);
+}
+
+/** Test computing RTO from samples */
+PCUT_TEST(sample)
+{
+	tcp_rtt_t rtt;
+
+	tcp_rtt_init(&rtt);
+
+	/* First sample, SRTT = R, RTTVAR = R/2, RTO = SRTT + 4 * RTTVAR */
+	tcp_rtt_sample(&rtt, 100000);
+	PCUT_ASSERT_TRUE(rtt.valid);
+	PCUT_ASSERT_INT_EQUALS(100000, rtt.srtt);
+	PCUT_ASSERT_INT_EQUALS(50000, rtt.rttvar);
+	PCUT_ASSERT_INT_EQUALS(300000, rtt.rto);
+
+	/* Same sample again, variance decays */
+	tcp_rtt_sample(&rtt, 100000);
+	PCUT_ASSERT_INT_EQUALS(100000, rtt.srtt);
+	PCUT_ASSERT_INT_EQUALS(37500, rtt.rttvar);
+	PCUT_ASSERT_INT_EQUALS(250000, rtt.rto);
+}
+
+/** Test RTO is clamped at the lower bound */
+PCUT_TEST(sample_min)
+{
+	tcp_rtt_t rtt;
+
+	tcp_rtt_init(&rtt);
+
+	tcp_rtt_sample(&rtt, 1000);
+	PCUT_ASSERT_INT_EQUALS(1000, rtt.srtt);
+	PCUT_ASSERT_INT_EQUALS(200000, rtt.rto);
+}
+
+/** Test exponential backoff */
+PCUT_TEST(backoff)
+{
+	tcp_rtt_t rtt;
+	int i;
+
+	tcp_rtt_init(&rtt);
+	tcp_rtt_sample(&rtt, 1000);
+	PCUT_ASSERT_INT_EQUALS(200000, rtt.rto);
+
+	tcp_rtt_backoff(&rtt);
+	PCUT_ASSERT_INT_EQUALS(400000, rtt.rto);
+
+	tcp_rtt_backoff(&rtt);
+	PCUT_ASSERT_INT_EQUALS(800000, rtt.rto);
+
+	/* RTO is capped */
+	for (i = 0; i < 20; i++)
+		tcp_rtt_backoff(&rtt);
+	PCUT_ASSERT_INT_EQUALS(60 * 1000 * 1000, rtt.rto);
+
+	/* A new sample recomputes RTO */
+	tcp_rtt_sample(&rtt, 1000);
+	PCUT_ASSERT_INT_EQUALS(200000, rtt.rto);
+}
+
+PCUT_EXPORT(rtt);
@@ -31,6 +31,7 @@
 #include <pcut/pcut.h>
 
 #include "../conn.h"
+#include "../segment.h"
 #include "../tqueue.h"
 
 PCUT_INIT;
@@ -43,6 +44,10 @@ enum {
 
 static int seg_cnt;
 static tcp_segment_t *trans_seg[test_seg_max];
+/** Text size of transmitted segments, recorded before they are freed */
+static size_t trans_text[test_seg_max];
+/** Whether transmitted segments carried the timestamp option */
+static bool trans_ts[test_seg_max];
 
 static void tqueue_test_transmit_seg(inet_ep2_t *, tcp_segment_t *);
 
@@ -244,7 +249,7 @@ PCUT_TEST(ack_received)
 
 	/* One of the two segments is acked */
 	conn->snd_una = 20;
-	tcp_tqueue_ack_received(conn);
+	tcp_tqueue_ack_received(conn, 10);
 
 	PCUT_ASSERT_INT_EQUALS(1, list_count(&conn->retransmit.list));
 
@@ -253,8 +258,180 @@ PCUT_TEST(ack_received)
 	tcp_conn_delete(conn);
 }
 
+/** Test splitting data into segments of at most SND.MSS */
+PCUT_TEST(new_data_mss)
+{
+	tcp_conn_t *conn;
+	inet_ep2_t epp;
+
+	/* XXX tqueue can only be created via tcp_conn_new */
+	inet_ep2_init(&epp);
+	conn = tcp_conn_new(&epp);
+	PCUT_ASSERT_NOT_NULL(conn);
+
+	conn->cstate = st_established;
+	conn->snd_una = 10;
+	conn->snd_nxt = 10;
+	conn->snd_wnd = 1024;
+	conn->snd_mss = 100;
+	conn->snd_buf_used = 250;
+	conn->snd_buf_fin = false;
+
+	/* Redirect segment transmission */
+	conn->retransmit.cb = &tqueue_test_cb;
+	seg_cnt = 0;
+
+	tcp_conn_lock(conn);
+	tcp_tqueue_new_data(conn);
+
+	PCUT_ASSERT_EQUALS(260, conn->snd_nxt);
+	PCUT_ASSERT_EQUALS(0, conn->snd_buf_used);
+	PCUT_ASSERT_INT_EQUALS(3, seg_cnt);
+	PCUT_ASSERT_INT_EQUALS(3, list_count(&conn->retransmit.list));
+
+	tcp_conn_reset(conn);
+	tcp_conn_unlock(conn);
+	tcp_conn_delete(conn);
+}
+
+/** Test that the timestamp option is deducted from the segment data */
+PCUT_TEST(new_data_mss_ts)
+{
+	tcp_conn_t *conn;
+	inet_ep2_t epp;
+	int i;
+
+	/* XXX tqueue can only be created via tcp_conn_new */
+	inet_ep2_init(&epp);
+	conn = tcp_conn_new(&epp);
+	PCUT_ASSERT_NOT_NULL(conn);
+
+	conn->cstate = st_established;
+	conn->snd_una = 10;
+	conn->snd_nxt = 10;
+	conn->snd_wnd = 1024;
+	conn->snd_mss = 100;
+	conn->ts_ok = true;
+	conn->snd_buf_used = 250;
+	conn->snd_buf_fin = false;
+
+	/* Redirect segment transmission */
+	conn->retransmit.cb = &tqueue_test_cb;
+	seg_cnt = 0;
+
+	tcp_conn_lock(conn);
+	tcp_tqueue_new_data(conn);
+
+	PCUT_ASSERT_EQUALS(260, conn->snd_nxt);
+	PCUT_ASSERT_EQUALS(0, conn->snd_buf_used);
+	PCUT_ASSERT_INT_EQUALS(3, seg_cnt);
+
+	/* Full segments carry SND.MSS minus the timestamp option */
+	for (i = 0; i < 2; i++) {
+		PCUT_ASSERT_TRUE(trans_ts[i]);
+		PCUT_ASSERT_INT_EQUALS(88, trans_text[i]);
+	}
+
+	PCUT_ASSERT_INT_EQUALS(74, trans_text[2]);
+
+	tcp_conn_reset(conn);
+	tcp_conn_unlock(conn);
+	tcp_conn_delete(conn);
+}
+
+/** Test that the congestion window limits amount of data in flight */
+PCUT_TEST(new_data_cwnd)
+{
+	tcp_conn_t *conn;
+	inet_ep2_t epp;
+
+	/* XXX tqueue can only be created via tcp_conn_new */
+	inet_ep2_init(&epp);
+	conn = tcp_conn_new(&epp);
+	PCUT_ASSERT_NOT_NULL(conn);
+
+	conn->cstate = st_established;
+	conn->snd_una = 10;
+	conn->snd_nxt = 10;
+	conn->snd_wnd = 1024;
+	conn->snd_mss = 100;
+	conn->cc.cwnd = 200;
+	conn->snd_buf_used = 500;
+	conn->snd_buf_fin = false;
+
+	/* Redirect segment transmission */
+	conn->retransmit.cb = &tqueue_test_cb;
+	seg_cnt = 0;
+
+	tcp_conn_lock(conn);
+	tcp_tqueue_new_data(conn);
+
+	PCUT_ASSERT_EQUALS(210, conn->snd_nxt);
+	PCUT_ASSERT_EQUALS(300, conn->snd_buf_used);
+	PCUT_ASSERT_INT_EQUALS(2, seg_cnt);
+
+	/* First segment acked, window opens up */
+	conn->snd_una = 110;
+	tcp_tqueue_ack_received(conn, 100);
+
+	PCUT_ASSERT_TRUE(conn->cc.cwnd > 200);
+	PCUT_ASSERT_TRUE(seg_cnt >= 3);
+
+	tcp_conn_reset(conn);
+	tcp_conn_unlock(conn);
+	tcp_conn_delete(conn);
+}
+
+/** Test fast retransmit after three duplicate ACKs */
+PCUT_TEST(fast_retransmit)
+{
+	tcp_conn_t *conn;
+	inet_ep2_t epp;
+
+	/* XXX tqueue can only be created via tcp_conn_new */
+	inet_ep2_init(&epp);
+	conn = tcp_conn_new(&epp);
+	PCUT_ASSERT_NOT_NULL(conn);
+
+	conn->cstate = st_established;
+	conn->snd_una = 10;
+	conn->snd_nxt = 10;
+	conn->snd_wnd = 1024;
+	conn->snd_mss = 100;
+	conn->snd_buf_used = 500;
+	conn->snd_buf_fin = false;
+
+	/* Redirect segment transmission */
+	conn->retransmit.cb = &tqueue_test_cb;
+	seg_cnt = 0;
+
+	tcp_conn_lock(conn);
+	tcp_tqueue_new_data(conn);
+
+	PCUT_ASSERT_EQUALS(510, conn->snd_nxt);
+	PCUT_ASSERT_INT_EQUALS(5, seg_cnt);
+
+	tcp_tqueue_dupack_received(conn);
+	tcp_tqueue_dupack_received(conn);
+	PCUT_ASSERT_INT_EQUALS(5, seg_cnt);
+	PCUT_ASSERT_FALSE(conn->cc.in_recovery);
+
+	/* Third duplicate ACK triggers retransmission of first segment */
+	tcp_tqueue_dupack_received(conn);
+	PCUT_ASSERT_INT_EQUALS(6, seg_cnt);
+	PCUT_ASSERT_EQUALS(10, trans_seg[5]->seq);
+	PCUT_ASSERT_TRUE(conn->cc.in_recovery);
+	PCUT_ASSERT_EQUALS(510, conn->cc.recover);
+
+	tcp_conn_reset(conn);
+	tcp_conn_unlock(conn);
+	tcp_conn_delete(conn);
+}
+
 static void tqueue_test_transmit_seg(inet_ep2_t *epp, tcp_segment_t *seg)
 {
+	trans_text[seg_cnt] = tcp_segment_text_size(seg);
+	trans_ts[seg_cnt] = seg->has_ts;
 	trans_seg[seg_cnt++] = seg;
 }
 
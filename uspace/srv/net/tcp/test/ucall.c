@@ -29,7 +29,9 @@
 #include <errno.h>
 #include <inet/endpoint.h>
 #include <io/log.h>
+#include <mem.h>
 #include <pcut/pcut.h>
+#include <str.h>
 
 #include "../conn.h"
 #include "../rqueue.h"
@@ -42,6 +44,7 @@ PCUT_TEST_SUITE(ucall);
 static void test_cstate_change(tcp_conn_t *, void *, tcp_cstate_t);
 static void test_conns_establish(tcp_conn_t **, tcp_conn_t **);
 static void test_conns_tear_down(tcp_conn_t *, tcp_conn_t *);
+static errno_t test_rcv_fn(void *, const void *, size_t);
 
 static tcp_rqueue_cb_t test_rqueue_cb = {
 	.seg_received = tcp_as_segment_arrived
@@ -133,6 +136,75 @@ PCUT_TEST(conn_establish)
 	test_conns_tear_down(cconn, sconn);
 }
 
+/** Test negotiating window scaling, timestamps and SACK */
+PCUT_TEST(conn_establish_opts)
+{
+	tcp_conn_t *cconn, *sconn;
+
+	test_conns_establish(&cconn, &sconn);
+
+	PCUT_ASSERT_TRUE(cconn->wscale_ok);
+	PCUT_ASSERT_TRUE(sconn->wscale_ok);
+	PCUT_ASSERT_INT_EQUALS(sconn->rcv_wscale, cconn->snd_wscale);
+	PCUT_ASSERT_INT_EQUALS(cconn->rcv_wscale, sconn->snd_wscale);
+	PCUT_ASSERT_TRUE(cconn->rcv_wscale > 0);
+
+	PCUT_ASSERT_TRUE(cconn->ts_ok);
+	PCUT_ASSERT_TRUE(sconn->ts_ok);
+	PCUT_ASSERT_TRUE(cconn->sack_ok);
+	PCUT_ASSERT_TRUE(sconn->sack_ok);
+
+	/* Scaled window makes it through intact */
+	PCUT_ASSERT_INT_EQUALS(sconn->rcv_wnd >> sconn->rcv_wscale <<
+	    sconn->rcv_wscale, cconn->snd_wnd);
+
+	test_conns_tear_down(cconn, sconn);
+}
+
+/** Test receiving data directly from the receive buffer */
+PCUT_TEST(receive_direct)
+{
+	tcp_conn_t *cconn, *sconn;
+	const char *msg = "Hello";
+	char buf[16];
+	size_t rcvd;
+	xflags_t xflags;
+	tcp_error_t trc;
+
+	test_conns_establish(&cconn, &sconn);
+
+	trc = tcp_uc_send(cconn, (void *) msg, str_size(msg), 0);
+	PCUT_ASSERT_INT_EQUALS(TCP_EOK, trc);
+
+	/* Wait for data to arrive */
+	tcp_conn_lock(sconn);
+	while (sconn->rcv_buf_used < str_size(msg))
+		fibril_condvar_wait(&sconn->rcv_buf_cv, &sconn->lock);
+	tcp_conn_unlock(sconn);
+
+	/* Consume part of the data */
+	memset(buf, 0, sizeof(buf));
+	trc = tcp_uc_receive_direct(sconn, 2, test_rcv_fn, buf, &rcvd,
+	    &xflags);
+	PCUT_ASSERT_INT_EQUALS(TCP_EOK, trc);
+	PCUT_ASSERT_INT_EQUALS(2, rcvd);
+	PCUT_ASSERT_STR_EQUALS("He", buf);
+
+	/* Failing consumer leaves data in the buffer */
+	trc = tcp_uc_receive_direct(sconn, sizeof(buf), test_rcv_fn, NULL,
+	    &rcvd, &xflags);
+	PCUT_ASSERT_INT_EQUALS(TCP_EUNSPEC, trc);
+
+	/* The rest of the data */
+	memset(buf, 0, sizeof(buf));
+	trc = tcp_uc_receive(sconn, buf, sizeof(buf), &rcvd, &xflags);
+	PCUT_ASSERT_INT_EQUALS(TCP_EOK, trc);
+	PCUT_ASSERT_INT_EQUALS(3, rcvd);
+	PCUT_ASSERT_STR_EQUALS("llo", buf);
+
+	test_conns_tear_down(cconn, sconn);
+}
+
 /** Test establishing and then closing down a connection first on one side,
  * then on_the other.
  */
@@ -314,4 +386,14 @@ static void test_conns_tear_down(tcp_conn_t *cconn, tcp_conn_t *sconn)
 	tcp_uc_delete(sconn);
 }
 
+/** Receive data consumer, fails if @a arg is @c NULL. */
+static errno_t test_rcv_fn(void *arg, const void *data, size_t size)
+{
+	if (arg == NULL)
+		return EIO;
+
+	memcpy(arg, data, size);
+	return EOK;
+}
+
 PCUT_EXPORT(ucall);
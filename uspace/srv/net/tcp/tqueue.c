@@ -42,18 +42,21 @@
 #include <macros.h>
 #include <mem.h>
 #include <stdlib.h>
+#include <time.h>
 
+#include "congctl.h"
 #include "conn.h"
 #include "inet.h"
+#include "iqueue.h"
 #include "ncsim.h"
 #include "rqueue.h"
+#include "rtt.h"
 #include "segment.h"
 #include "seq_no.h"
+#include "std.h"
 #include "tqueue.h"
 #include "tcp_type.h"
 
-#define RETRANSMIT_TIMEOUT	(2*1000*1000)
-
 static void retransmit_timeout_func(void *);
 static void tcp_tqueue_timer_set(tcp_conn_t *);
 static void tcp_tqueue_timer_clear(tcp_conn_t *);
@@ -61,6 +64,7 @@ static void tcp_tqueue_seg(tcp_conn_t *, tcp_segment_t *);
 static void tcp_conn_transmit_segment(tcp_conn_t *, tcp_segment_t *);
 static void tcp_prepare_transmit_segment(tcp_conn_t *, tcp_segment_t *);
 static void tcp_tqueue_send_immed(tcp_conn_t *, tcp_segment_t *);
+static void tcp_tqueue_retransmit(tcp_conn_t *, tcp_tqueue_entry_t *);
 
 errno_t tcp_tqueue_init(tcp_tqueue_t *tqueue, tcp_conn_t *conn,
     tcp_tqueue_cb_t *cb)
@@ -68,6 +72,7 @@ errno_t tcp_tqueue_init(tcp_tqueue_t *tqueue, tcp_conn_t *conn,
 	tqueue->conn = conn;
 	tqueue->timer = fibril_timer_create(&conn->lock);
 	tqueue->cb = cb;
+	tqueue->backoff = 0;
 	if (tqueue->timer == NULL)
 		return ENOMEM;
 
@@ -118,6 +123,7 @@ static void tcp_tqueue_seg(tcp_conn_t *conn, tcp_segment_t *seg)
 {
 	tcp_segment_t *rt_seg;
 	tcp_tqueue_entry_t *tqe;
+	bool was_empty;
 
 	assert(fibril_mutex_is_locked(&conn->lock));
 
@@ -146,11 +152,17 @@ static void tcp_tqueue_seg(tcp_conn_t *conn, tcp_segment_t *seg)
 		tqe->conn = conn;
 		tqe->seg = rt_seg;
 		rt_seg->seq = conn->snd_nxt;
+		getuptime(&tqe->sent);
 
+		was_empty = list_empty(&conn->retransmit.list);
 		list_append(&tqe->link, &conn->retransmit.list);
 
-		/* Set retransmission timer */
-		tcp_tqueue_timer_set(conn);
+		/*
+		 * Start retransmission timer unless it is already running
+		 * for an earlier segment (RFC 6298 5.1)
+		 */
+		if (was_empty)
+			tcp_tqueue_timer_set(conn);
 	}
 
 	tcp_prepare_transmit_segment(conn, seg);
@@ -172,16 +184,115 @@ static void tcp_prepare_transmit_segment(tcp_conn_t *conn, tcp_segment_t *seg)
 	tcp_conn_transmit_segment(conn, seg);
 }
 
+/** Compute number of bytes the network is believed to hold.
+ *
+ * Segments that were selectively acknowledged or are deemed lost
+ * (and not yet retransmitted) have left the network (RFC 6675 pipe).
+ *
+ * @param conn Connection
+ * @return Number of bytes in the network
+ */
+static uint32_t tcp_tqueue_pipe(tcp_conn_t *conn)
+{
+	uint32_t pipe = 0;
+
+	list_foreach(conn->retransmit.list, link, tcp_tqueue_entry_t, tqe) {
+		if (!tqe->sacked && !tqe->lost)
+			pipe += tqe->seg->len;
+	}
+
+	return pipe;
+}
+
+/** Mark segments deemed lost based on SACK information.
+ *
+ * A segment is deemed lost if more than (DupThresh - 1) * SMSS bytes
+ * above it have been selectively acknowledged (RFC 6675 IsLost).
+ * Segments that have already been retransmitted are left to
+ * the retransmission timer.
+ *
+ * @param conn Connection
+ */
+static void tcp_tqueue_mark_lost(tcp_conn_t *conn)
+{
+	tcp_tqueue_entry_t *tqe;
+	uint32_t sacked_above;
+	link_t *link;
+
+	sacked_above = 0;
+	link = list_last(&conn->retransmit.list);
+	while (link != NULL) {
+		tqe = list_get_instance(link, tcp_tqueue_entry_t, link);
+
+		if (tqe->sacked)
+			sacked_above += tqe->seg->len;
+		else if (!tqe->retx && sacked_above > 2 * (uint32_t) conn->snd_mss)
+			tqe->lost = true;
+
+		link = list_prev(link, &conn->retransmit.list);
+	}
+}
+
+/** Retransmit segments deemed lost as far as congestion window allows.
+ *
+ * @param conn Connection
+ */
+static void tcp_tqueue_retransmit_lost(tcp_conn_t *conn)
+{
+	uint32_t pipe;
+
+	pipe = tcp_tqueue_pipe(conn);
+
+	list_foreach(conn->retransmit.list, link, tcp_tqueue_entry_t, tqe) {
+		if (!tqe->lost)
+			continue;
+
+		if (pipe > 0 && pipe + tqe->seg->len > conn->cc.cwnd)
+			break;
+
+		tcp_tqueue_retransmit(conn, tqe);
+		pipe += tqe->seg->len;
+	}
+}
+
+/** Determine maximum amount of data in a segment.
+ *
+ * SND.MSS limits the segment text together with any TCP options
+ * (RFC 9293 3.7.1). Once timestamps are in use, every segment carries
+ * the timestamp option, which is deducted from the data size.
+ *
+ * @param conn	Connection
+ * @return	Maximum number of data bytes in a segment
+ */
+static size_t tcp_tqueue_seg_data_max(tcp_conn_t *conn)
+{
+	if (conn->ts_ok && conn->snd_mss > TCP_OPT_TS_SIZE)
+		return conn->snd_mss - TCP_OPT_TS_SIZE;
+
+	return conn->snd_mss;
+}
+
 /** Transmit data from the send buffer.
+ *
+ * Segments deemed lost are retransmitted first. New data is sent
+ * in segments of at most SND.MSS bytes (less the options carried by
+ * every segment) as long as both the peer's receive window and the
+ * congestion window allow.
  *
  * @param conn	Connection
  */
 void tcp_tqueue_new_data(tcp_conn_t *conn)
 {
 	size_t avail_wnd;
+	size_t cwnd_avail;
 	size_t xfer_seqlen;
 	size_t snd_buf_seqlen;
 	size_t data_size;
+	size_t buf_left;
+	size_t seg_max;
+	size_t off;
+	uint32_t flight;
+	uint32_t pipe;
 	tcp_control_t ctrl;
 	bool send_fin;
 
@@ -189,66 +300,140 @@ void tcp_tqueue_new_data(tcp_conn_t *conn)
 
 	log_msg(LOG_DEFAULT, LVL_DEBUG, "%s: tcp_tqueue_new_data()", conn->name);
 
-	/* Number of free sequence numbers in send window */
-	avail_wnd = (conn->snd_una + conn->snd_wnd) - conn->snd_nxt;
-	snd_buf_seqlen = conn->snd_buf_used + (conn->snd_buf_fin ? 1 : 0);
+	tcp_tqueue_retransmit_lost(conn);
 
-	xfer_seqlen = min(snd_buf_seqlen, avail_wnd);
-	log_msg(LOG_DEFAULT, LVL_DEBUG, "%s: snd_buf_seqlen = %zu, SND.WND = %" PRIu32 ", "
-	    "xfer_seqlen = %zu", conn->name, snd_buf_seqlen, conn->snd_wnd,
-	    xfer_seqlen);
+	seg_max = tcp_tqueue_seg_data_max(conn);
 
-	if (xfer_seqlen == 0)
-		return;
+	off = 0;
+	while (true) {
+		buf_left = conn->snd_buf_used - off;
 
-	/* XXX Do not always send immediately */
+		/* Number of free sequence numbers in send window */
+		flight = tcp_cc_flight_size(conn);
+		avail_wnd = conn->snd_wnd > flight ? conn->snd_wnd - flight : 0;
 
-	send_fin = conn->snd_buf_fin && xfer_seqlen == snd_buf_seqlen;
-	data_size = xfer_seqlen - (send_fin ? 1 : 0);
+		/* Number of bytes the congestion window allows */
+		pipe = tcp_tqueue_pipe(conn);
+		cwnd_avail = conn->cc.cwnd > pipe ? conn->cc.cwnd - pipe : 0;
 
-	if (send_fin) {
-		log_msg(LOG_DEFAULT, LVL_DEBUG, "%s: Sending out FIN.", conn->name);
-		/* We are sending out FIN */
-		ctrl = CTL_FIN;
-	} else {
-		ctrl = 0;
+		snd_buf_seqlen = buf_left + (conn->snd_buf_fin ? 1 : 0);
+		log_msg(LOG_DEFAULT, LVL_DEBUG, "%s: snd_buf_seqlen = %zu, "
+		    "SND.WND = %" PRIu32 ", CWND = %" PRIu32 ", pipe = %"
+		    PRIu32, conn->name, snd_buf_seqlen, conn->snd_wnd,
+		    conn->cc.cwnd, pipe);
+
+		if (snd_buf_seqlen == 0)
+			break;
+
+		/* Wait for the congestion window to open up to a full segment */
+		if (cwnd_avail < min(snd_buf_seqlen, seg_max))
+			break;
+
+		/* XXX Do not always send immediately */
+
+		data_size = min(min(buf_left, avail_wnd),
+		    min(cwnd_avail, seg_max));
+		send_fin = conn->snd_buf_fin && data_size == buf_left &&
+		    data_size < min(avail_wnd, cwnd_avail);
+		xfer_seqlen = data_size + (send_fin ? 1 : 0);
+
+		if (xfer_seqlen == 0)
+			break;
+
+		if (send_fin) {
+			log_msg(LOG_DEFAULT, LVL_DEBUG, "%s: Sending out FIN.", conn->name);
+			/* We are sending out FIN */
+			ctrl = CTL_FIN;
+		} else {
+			ctrl = 0;
+		}
+
+		seg = tcp_segment_make_data(ctrl, conn->snd_buf + off, data_size);
+		if (seg == NULL) {
+			log_msg(LOG_DEFAULT, LVL_ERROR, "Memory allocation failure.");
+			break;
+		}
+
+		off += data_size;
+
+		if (send_fin) {
+			conn->snd_buf_fin = false;
+			tcp_conn_fin_sent(conn);
+		}
+
+		tcp_tqueue_seg(conn, seg);
+		tcp_segment_delete(seg);
 	}
 
-	seg = tcp_segment_make_data(ctrl, conn->snd_buf, data_size);
-	if (seg == NULL) {
-		log_msg(LOG_DEFAULT, LVL_ERROR, "Memory allocation failure.");
+	if (off == 0)
 		return;
-	}
 
 	/* Remove data from send buffer */
-	memmove(conn->snd_buf, conn->snd_buf + data_size,
-	    conn->snd_buf_used - data_size);
-	conn->snd_buf_used -= data_size;
-
-	if (send_fin)
-		conn->snd_buf_fin = false;
+	memmove(conn->snd_buf, conn->snd_buf + off, conn->snd_buf_used - off);
+	conn->snd_buf_used -= off;
 
 	fibril_condvar_broadcast(&conn->snd_buf_cv);
+}
+
+/** Process SACK blocks in an incoming segment.
+ *
+ * Mark segments in the retransmission queue that the peer has
+ * received out of order.
+ *
+ * @param conn Connection
+ * @param seg  Incoming segment
+ */
+void tcp_tqueue_sack_received(tcp_conn_t *conn, tcp_segment_t *seg)
+{
+	tcp_sack_blk_t *blk;
+	tcp_segment_t *rseg;
+	size_t i;
 
-	if (send_fin)
-		tcp_conn_fin_sent(conn);
+	if (!conn->sack_ok)
+		return;
 
-	tcp_tqueue_seg(conn, seg);
-	tcp_segment_delete(seg);
+	for (i = 0; i < seg->nsack; i++) {
+		blk = &seg->sack[i];
+
+		/* Ignore blocks outside of SND.UNA .. SND.NXT */
+		if ((int32_t)(blk->left - conn->snd_una) < 0 ||
+		    (int32_t)(blk->right - conn->snd_nxt) > 0 ||
+		    (int32_t)(blk->right - blk->left) <= 0)
+			continue;
+
+		list_foreach(conn->retransmit.list, link, tcp_tqueue_entry_t,
+		    tqe) {
+			rseg = tqe->seg;
+			if ((int32_t)(rseg->seq - blk->left) >= 0 &&
+			    (int32_t)(rseg->seq + rseg->len - blk->right) <= 0) {
+				tqe->sacked = true;
+				tqe->lost = false;
+			}
+		}
+	}
 }
 
 /** Remove ACKed segments from retransmission queue and possibly transmit
  * more data.
  *
  * This should be called when SND.UNA is updated due to incoming ACK.
+ *
+ * @param conn  Connection
+ * @param acked Number of newly acknowledged bytes
  */
-void tcp_tqueue_ack_received(tcp_conn_t *conn)
+void tcp_tqueue_ack_received(tcp_conn_t *conn, uint32_t acked)
 {
 	link_t *cur, *next;
+	struct timespec now;
+	bool have_sample;
+	usec_t sample = 0;
 
 	log_msg(LOG_DEFAULT, LVL_DEBUG, "%s: tcp_tqueue_ack_received(%p)", conn->name,
 	    conn);
 
+	getuptime(&now);
+	have_sample = false;
+
 	cur = conn->retransmit.list.head.next;
 
 	while (cur != &conn->retransmit.list.head) {
@@ -270,6 +455,16 @@ void tcp_tqueue_ack_received(tcp_conn_t *conn)
 				conn->fin_is_acked = true;
 			}
 
+			/*
+			 * Karn's algorithm: do not sample retransmitted
+			 * segments. With timestamps the caller samples
+			 * every ACK instead.
+			 */
+			if (!tqe->retx && !conn->ts_ok) {
+				sample = NSEC2USEC(ts_sub_diff(&now, &tqe->sent));
+				have_sample = true;
+			}
+
 			tcp_segment_delete(tqe->seg);
 			free(tqe);
 
@@ -280,6 +475,24 @@ void tcp_tqueue_ack_received(tcp_conn_t *conn)
 		cur = next;
 	}
 
+	if (have_sample)
+		tcp_rtt_sample(&conn->rtt, sample);
+
+	if (acked > 0) {
+		conn->retransmit.backoff = 0;
+
+		if (tcp_cc_ack(conn, acked) &&
+		    !list_empty(&conn->retransmit.list)) {
+			/* Partial ACK, the next segment was lost as well */
+			tcp_tqueue_retransmit(conn, list_get_instance(
+			    list_first(&conn->retransmit.list),
+			    tcp_tqueue_entry_t, link));
+		}
+	}
+
+	if (conn->cc.in_recovery && conn->sack_ok)
+		tcp_tqueue_mark_lost(conn);
+
 	/* Clear retransmission timer if the queue is empty. */
 	if (list_empty(&conn->retransmit.list))
 		tcp_tqueue_timer_clear(conn);
@@ -288,17 +501,73 @@ void tcp_tqueue_ack_received(tcp_conn_t *conn)
 	tcp_tqueue_new_data(conn);
 }
 
+/** Duplicate ACK has been received.
+ *
+ * Perform fast retransmit after the third duplicate ACK and transmit
+ * more data if the congestion window allows.
+ *
+ * @param conn Connection
+ */
+void tcp_tqueue_dupack_received(tcp_conn_t *conn)
+{
+	log_msg(LOG_DEFAULT, LVL_DEBUG, "%s: tcp_tqueue_dupack_received(%p)",
+	    conn->name, conn);
+
+	if (tcp_cc_dupack(conn) && !list_empty(&conn->retransmit.list)) {
+		log_msg(LOG_DEFAULT, LVL_DEBUG, "%s: fast retransmit",
+		    conn->name);
+		tcp_tqueue_retransmit(conn, list_get_instance(
+		    list_first(&conn->retransmit.list), tcp_tqueue_entry_t,
+		    link));
+	}
+
+	if (conn->cc.in_recovery && conn->sack_ok)
+		tcp_tqueue_mark_lost(conn);
+
+	tcp_tqueue_new_data(conn);
+}
+
 static void tcp_conn_transmit_segment(tcp_conn_t *conn, tcp_segment_t *seg)
 {
 	log_msg(LOG_DEFAULT, LVL_DEBUG, "%s: tcp_conn_transmit_segment(%p, %p)",
 	    conn->name, conn, seg);
 
-	seg->wnd = conn->rcv_wnd;
-
-	if ((seg->ctrl & CTL_ACK) != 0)
+	if ((seg->ctrl & CTL_ACK) != 0) {
 		seg->ack = conn->rcv_nxt;
-	else
+		conn->last_ack_sent = seg->ack;
+	} else {
 		seg->ack = 0;
+	}
+
+	if ((seg->ctrl & CTL_SYN) != 0) {
+		/* Window in SYN segment is never scaled (RFC 7323 2.2) */
+		seg->wnd = min(conn->rcv_wnd, UINT16_MAX);
+	} else {
+		seg->wnd = min(conn->rcv_wnd >> conn->rcv_wscale, UINT16_MAX);
+	}
+
+	if ((seg->ctrl & CTL_SYN) != 0 ? conn->ts_perm : conn->ts_ok) {
+		seg->has_ts = true;
+		seg->tsval = tcp_ts_now();
+		seg->tsecr = conn->ts_recent;
+	}
+
+	if ((seg->ctrl & CTL_SYN) != 0) {
+		/* Negotiate maximum segment size, window scale and SACK */
+		seg->mss = tcp_conn_local_mss(conn);
+		seg->has_wscale = conn->wscale_perm;
+		seg->wscale = conn->rcv_wscale;
+		seg->sack_perm = conn->sack_perm;
+		seg->nsack = 0;
+	} else if ((seg->ctrl & CTL_ACK) != 0 && conn->sack_ok &&
+	    tcp_segment_text_size(seg) == 0) {
+		/*
+		 * Report out-of-order data. Only pure ACKs carry SACK blocks
+		 * so that options never push a full segment over the MSS.
+		 */
+		seg->nsack = tcp_iqueue_sack_blocks(&conn->incoming, seg->sack,
+		    TCP_SACK_BLOCKS_MAX);
+	}
 
 	tcp_tqueue_send_immed(conn, seg);
 }
@@ -317,11 +586,35 @@ void tcp_tqueue_send_immed(tcp_conn_t *conn, tcp_segment_t *seg)
 	conn->retransmit.cb->transmit_seg(&conn->ident, seg);
 }
 
+/** Retransmit segment from the retransmission queue.
+ *
+ * @param conn Connection
+ * @param tqe  Retransmission queue entry
+ */
+static void tcp_tqueue_retransmit(tcp_conn_t *conn, tcp_tqueue_entry_t *tqe)
+{
+	tcp_segment_t *rt_seg;
+
+	rt_seg = tcp_segment_dup(tqe->seg);
+	if (rt_seg == NULL) {
+		log_msg(LOG_DEFAULT, LVL_ERROR, "Memory allocation failed.");
+		/* XXX Handle properly */
+		return;
+	}
+
+	tqe->retx = true;
+	tqe->lost = false;
+	getuptime(&tqe->sent);
+
+	log_msg(LOG_DEFAULT, LVL_DEBUG, "### %s: retransmitting segment", conn->name);
+	tcp_conn_transmit_segment(conn, rt_seg);
+	tcp_segment_delete(rt_seg);
+}
+
 static void retransmit_timeout_func(void *arg)
 {
 	tcp_conn_t *conn = (tcp_conn_t *) arg;
 	tcp_tqueue_entry_t *tqe;
-	tcp_segment_t *rt_seg;
 	link_t *link;
 
 	log_msg(LOG_DEFAULT, LVL_DEBUG, "### %s: retransmit_timeout_func(%p)", conn->name, conn);
@@ -345,20 +638,25 @@ static void retransmit_timeout_func(void *arg)
 
 	tqe = list_get_instance(link, tcp_tqueue_entry_t, link);
 
-	rt_seg = tcp_segment_dup(tqe->seg);
-	if (rt_seg == NULL) {
-		log_msg(LOG_DEFAULT, LVL_ERROR, "Memory allocation failed.");
-		tcp_conn_unlock(conn);
-		tcp_conn_delref(conn);
-		/* XXX Handle properly */
-		return;
+	/* Collapse congestion window and back off the timer */
+	tcp_cc_timeout(conn, conn->retransmit.backoff > 0);
+	++conn->retransmit.backoff;
+	tcp_rtt_backoff(&conn->rtt);
+
+	/*
+	 * Forget SACK information in case the peer reneged (RFC 2018)
+	 * and consider everything outstanding lost. The rest is
+	 * retransmitted as the congestion window opens up again.
+	 */
+	list_foreach(conn->retransmit.list, link, tcp_tqueue_entry_t, e) {
+		e->sacked = false;
+		e->lost = true;
 	}
 
-	log_msg(LOG_DEFAULT, LVL_DEBUG, "### %s: retransmitting segment", conn->name);
-	tcp_conn_transmit_segment(tqe->conn, rt_seg);
+	tcp_tqueue_retransmit(conn, tqe);
 
 	/* Reset retransmission timer */
-	fibril_timer_set_locked(conn->retransmit.timer, RETRANSMIT_TIMEOUT,
+	fibril_timer_set_locked(conn->retransmit.timer, conn->rtt.rto,
 	    retransmit_timeout_func, (void *) conn);
 
 	tcp_conn_unlock(conn);
@@ -377,7 +675,7 @@ static void tcp_tqueue_timer_set(tcp_conn_t *conn)
 	tcp_tqueue_timer_clear(conn);
 
 	tcp_conn_addref(conn);
-	fibril_timer_set_locked(conn->retransmit.timer, RETRANSMIT_TIMEOUT,
+	fibril_timer_set_locked(conn->retransmit.timer, conn->rtt.rto,
 	    retransmit_timeout_func, (void *) conn);
 
 	log_msg(LOG_DEFAULT, LVL_DEBUG, "### %s: tcp_tqueue_timer_set() end", conn->name);
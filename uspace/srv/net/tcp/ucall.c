@@ -147,6 +147,12 @@ tcp_error_t tcp_uc_send(tcp_conn_t *conn, void *data, size_t size,
 
 	while (size > 0) {
 		buf_free = conn->snd_buf_size - conn->snd_buf_used;
+		if (buf_free == 0) {
+			/* Grow send buffer if it limits throughput */
+			tcp_conn_snd_buf_tune(conn);
+			buf_free = conn->snd_buf_size - conn->snd_buf_used;
+		}
+
 		while (buf_free == 0 && !conn->reset) {
 			log_msg(LOG_DEFAULT, LVL_DEBUG, "%s: buf_free == 0, waiting.",
 			    conn->name);
@@ -176,11 +182,40 @@ tcp_error_t tcp_uc_send(tcp_conn_t *conn, void *data, size_t size,
 	return TCP_EOK;
 }
 
+/** Copy received data to user buffer. */
+static errno_t tcp_uc_receive_copy(void *arg, const void *data, size_t size)
+{
+	memcpy(arg, data, size);
+	return EOK;
+}
+
 /** RECEIVE user call */
 tcp_error_t tcp_uc_receive(tcp_conn_t *conn, void *buf, size_t size,
     size_t *rcvd, xflags_t *xflags)
+{
+	return tcp_uc_receive_direct(conn, size, tcp_uc_receive_copy, buf,
+	    rcvd, xflags);
+}
+
+/** RECEIVE user call handing data directly to consumer.
+ *
+ * Received data is passed to @a fn straight from the receive buffer,
+ * saving a copy into an intermediate buffer. If @a fn fails, no data
+ * is removed from the receive buffer.
+ *
+ * @param conn   Connection
+ * @param size   Maximum number of bytes to receive
+ * @param fn     Consumer function
+ * @param arg    Argument to @a fn
+ * @param rcvd   Place to store number of bytes received
+ * @param xflags Place to store flags
+ * @return TCP_EOK on success or TCP error code
+ */
+tcp_error_t tcp_uc_receive_direct(tcp_conn_t *conn, size_t size,
+    tcp_rcv_fn_t fn, void *arg, size_t *rcvd, xflags_t *xflags)
 {
 	size_t xfer_size;
+	errno_t rc;
 
 	log_msg(LOG_DEFAULT, LVL_DEBUG, "%s: tcp_uc_receive()", conn->name);
 
@@ -215,17 +250,26 @@ tcp_error_t tcp_uc_receive(tcp_conn_t *conn, void *buf, size_t size,
 		}
 	}
 
-	/* Copy data from receive buffer to user buffer */
+	/* Hand data from receive buffer to the consumer */
 	xfer_size = min(size, conn->rcv_buf_used);
-	memcpy(buf, conn->rcv_buf, xfer_size);
+	rc = fn(arg, conn->rcv_buf + conn->rcv_buf_start, xfer_size);
+	if (rc != EOK) {
+		tcp_conn_unlock(conn);
+		return TCP_EUNSPEC;
+	}
+
 	*rcvd = xfer_size;
 
 	/* Remove data from receive buffer */
-	memmove(conn->rcv_buf, conn->rcv_buf + xfer_size, conn->rcv_buf_used -
-	    xfer_size);
+	conn->rcv_buf_start += xfer_size;
 	conn->rcv_buf_used -= xfer_size;
+	if (conn->rcv_buf_used == 0)
+		conn->rcv_buf_start = 0;
 	conn->rcv_wnd += xfer_size;
 
+	/* Grow receive buffer if it limits throughput */
+	tcp_conn_rcv_buf_tune(conn, xfer_size);
+
 	/* TODO */
 	*xflags = 0;
 
@@ -46,6 +46,8 @@ extern tcp_error_t tcp_uc_open(inet_ep2_t *, acpass_t,
     tcp_open_flags_t, tcp_conn_t **);
 extern tcp_error_t tcp_uc_send(tcp_conn_t *, void *, size_t, xflags_t);
 extern tcp_error_t tcp_uc_receive(tcp_conn_t *, void *, size_t, size_t *, xflags_t *);
+extern tcp_error_t tcp_uc_receive_direct(tcp_conn_t *, size_t, tcp_rcv_fn_t,
+    void *, size_t *, xflags_t *);
 extern tcp_error_t tcp_uc_close(tcp_conn_t *);
 extern void tcp_uc_abort(tcp_conn_t *);
 extern void tcp_uc_status(tcp_conn_t *, tcp_conn_status_t *);
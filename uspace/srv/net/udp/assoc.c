@@ -34,6 +34,7 @@
  * @file UDP associations
  */
 
+#include <adt/hash.h>
 #include <adt/list.h>
 #include <errno.h>
 #include <stdbool.h>
@@ -55,6 +56,8 @@ static FIBRIL_MUTEX_INITIALIZE(assoc_list_lock);
 static amap_t *amap;
 
 static udp_assoc_t *udp_assoc_find_ref(inet_ep2_t *);
+static errno_t udp_assoc_rgroup_join(udp_assoc_t *);
+static void udp_assoc_rgroup_leave(udp_assoc_t *);
 static errno_t udp_assoc_queue_msg(udp_assoc_t *, inet_ep2_t *, udp_msg_t *);
 
 /** Initialize associations. */
@@ -190,13 +193,17 @@ errno_t udp_assoc_add(udp_assoc_t *assoc)
 	fibril_mutex_lock(&assoc_list_lock);
 
 	rc = amap_insert(amap, &assoc->ident, assoc, af_allow_system, &aepp);
+	if (rc == EOK)
+		assoc->ident = aepp;
+	else if (rc == EEXIST && assoc->reuseport)
+		rc = udp_assoc_rgroup_join(assoc);
+
 	if (rc != EOK) {
 		udp_assoc_delref(assoc);
 		fibril_mutex_unlock(&assoc_list_lock);
 		return rc;
 	}
 
-	assoc->ident = aepp;
 	list_append(&assoc->link, &assoc_list);
 	fibril_mutex_unlock(&assoc_list_lock);
 
@@ -210,7 +217,10 @@ errno_t udp_assoc_add(udp_assoc_t *assoc)
 void udp_assoc_remove(udp_assoc_t *assoc)
 {
 	fibril_mutex_lock(&assoc_list_lock);
-	amap_remove(amap, &assoc->ident);
+	if (assoc->rgroup != NULL)
+		udp_assoc_rgroup_leave(assoc);
+	else
+		amap_remove(amap, &assoc->ident);
 	list_remove(&assoc->link);
 	fibril_mutex_unlock(&assoc_list_lock);
 	udp_assoc_delref(assoc);
@@ -404,6 +414,162 @@ static errno_t udp_assoc_queue_msg(udp_assoc_t *assoc, inet_ep2_t *epp,
 	return EOK;
 }
 
+/** Determine if two addresses are the same, treating all unspecified
+ * addresses as equal.
+ */
+static bool udp_addr_equal(inet_addr_t *a, inet_addr_t *b)
+{
+	if (inet_addr_is_any(a))
+		return inet_addr_is_any(b);
+
+	return inet_addr_compare(a, b);
+}
+
+/** Determine if two endpoint pairs are the same.
+ *
+ * @param a First endpoint pair
+ * @param b Second endpoint pair
+ * @return @c true if @a a and @a b are equal
+ */
+static bool udp_ep2_equal(inet_ep2_t *a, inet_ep2_t *b)
+{
+	return a->local_link == b->local_link &&
+	    a->local.port == b->local.port &&
+	    a->remote.port == b->remote.port &&
+	    udp_addr_equal(&a->local.addr, &b->local.addr) &&
+	    udp_addr_equal(&a->remote.addr, &b->remote.addr);
+}
+
+/** Compute hash of an endpoint.
+ *
+ * @param ep Endpoint
+ * @return Hash
+ */
+static size_t udp_ep_hash(inet_ep_t *ep)
+{
+	size_t hash = hash_combine(ep->addr.version, ep->port);
+	size_t i;
+
+	switch (ep->addr.version) {
+	case ip_v4:
+		hash = hash_combine(hash, ep->addr.addr);
+		break;
+	case ip_v6:
+		for (i = 0; i < sizeof(addr128_t); i++)
+			hash = hash_combine(hash, ep->addr.addr6[i]);
+		break;
+	default:
+		break;
+	}
+
+	return hash_mix(hash);
+}
+
+/** Join the reuse port group of an existing association.
+ *
+ * Called with assoc_list_lock held when @a assoc could not be entered
+ * in the association map because its endpoint pair is already taken.
+ * Succeeds if the endpoint pair is taken by associations which all allow
+ * port reuse. The first member of a group is the one entered in
+ * the association map.
+ *
+ * @param assoc Association with @c reuseport set
+ * @return EOK on success, EEXIST if endpoint pair is not shareable,
+ *         ENOMEM if out of memory
+ */
+static errno_t udp_assoc_rgroup_join(udp_assoc_t *assoc)
+{
+	udp_rgroup_t *rgroup;
+
+	list_foreach(assoc_list, link, udp_assoc_t, owner) {
+		if (!owner->reuseport ||
+		    !udp_ep2_equal(&owner->ident, &assoc->ident))
+			continue;
+
+		rgroup = owner->rgroup;
+		if (rgroup == NULL) {
+			rgroup = calloc(1, sizeof(udp_rgroup_t));
+			if (rgroup == NULL)
+				return ENOMEM;
+
+			list_initialize(&rgroup->assocs);
+			list_append(&owner->lrgroup, &rgroup->assocs);
+			rgroup->nassocs = 1;
+			owner->rgroup = rgroup;
+		}
+
+		list_append(&assoc->lrgroup, &rgroup->assocs);
+		++rgroup->nassocs;
+		assoc->rgroup = rgroup;
+		return EOK;
+	}
+
+	return EEXIST;
+}
+
+/** Leave reuse port group.
+ *
+ * Called with assoc_list_lock held. If @a assoc is the member entered
+ * in the association map, the next member takes its place. The group
+ * is dissolved once only one member remains.
+ *
+ * @param assoc Association
+ */
+static void udp_assoc_rgroup_leave(udp_assoc_t *assoc)
+{
+	udp_rgroup_t *rgroup = assoc->rgroup;
+	udp_assoc_t *first;
+	inet_ep2_t aepp;
+	bool was_first;
+	errno_t rc;
+
+	was_first = list_first(&rgroup->assocs) == &assoc->lrgroup;
+	list_remove(&assoc->lrgroup);
+	--rgroup->nassocs;
+	assoc->rgroup = NULL;
+
+	first = list_get_instance(list_first(&rgroup->assocs), udp_assoc_t,
+	    lrgroup);
+
+	if (was_first) {
+		amap_remove(amap, &assoc->ident);
+		rc = amap_insert(amap, &first->ident, first, af_allow_system,
+		    &aepp);
+		if (rc != EOK) {
+			log_msg(LOG_DEFAULT, LVL_ERROR, "Failed re-entering "
+			    "shared association in map.");
+		}
+	}
+
+	if (rgroup->nassocs == 1) {
+		list_remove(&first->lrgroup);
+		first->rgroup = NULL;
+		free(rgroup);
+	}
+}
+
+/** Select reuse port group member to receive message.
+ *
+ * All messages from the same remote endpoint go to the same member.
+ *
+ * @param rgroup Reuse port group
+ * @param remote Remote endpoint of the message
+ * @return Member association
+ */
+static udp_assoc_t *udp_assoc_rgroup_select(udp_rgroup_t *rgroup,
+    inet_ep_t *remote)
+{
+	link_t *link;
+	size_t idx;
+
+	idx = udp_ep_hash(remote) % rgroup->nassocs;
+	link = list_first(&rgroup->assocs);
+	while (idx-- > 0)
+		link = list_next(link, &rgroup->assocs);
+
+	return list_get_instance(link, udp_assoc_t, lrgroup);
+}
+
 /** Find association structure for specified endpoint pair.
  *
  * An association is uniquely identified by an endpoint pair. Look up our
@@ -430,6 +596,8 @@ static udp_assoc_t *udp_assoc_find_ref(inet_ep2_t *epp)
 	}
 
 	assoc = (udp_assoc_t *)arg;
+	if (assoc->rgroup != NULL)
+		assoc = udp_assoc_rgroup_select(assoc->rgroup, &epp->remote);
 	udp_assoc_addref(assoc);
 
 	fibril_mutex_unlock(&assoc_list_lock);
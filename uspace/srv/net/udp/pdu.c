@@ -34,6 +34,7 @@
  * @file UDP PDU encoding and decoding
  */
 
+#include <adt/checksum.h>
 #include <bitops.h>
 #include <byteorder.h>
 #include <errno.h>
@@ -47,40 +48,9 @@
 
 #define UDP_CHECKSUM_INIT 0xffff
 
-/** One's complement addition.
- *
- * Result is a + b + carry.
- */
-static uint16_t udp_ocadd16(uint16_t a, uint16_t b)
-{
-	uint32_t s;
-
-	s = (uint32_t)a + (uint32_t)b;
-	return (s & 0xffff) + (s >> 16);
-}
-
 static uint16_t udp_checksum_calc(uint16_t ivalue, void *data, size_t size)
 {
-	uint16_t sum;
-	uint16_t w;
-	size_t words, i;
-	uint8_t *bdata;
-
-	sum = ~ivalue;
-	words = size / 2;
-	bdata = (uint8_t *)data;
-
-	for (i = 0; i < words; i++) {
-		w = ((uint16_t)bdata[2 * i] << 8) | bdata[2 * i + 1];
-		sum = udp_ocadd16(sum, w);
-	}
-
-	if (size % 2 != 0) {
-		w = ((uint16_t)bdata[2 * words] << 8);
-		sum = udp_ocadd16(sum, w);
-	}
-
-	return ~sum;
+	return ~compute_ocsum(data, size, ~ivalue);
 }
 
 static ip_ver_t udp_phdr_setup(udp_pdu_t *pdu, udp_phdr_t *phdr,
@@ -129,7 +99,15 @@ void udp_pdu_delete(udp_pdu_t *pdu)
 	free(pdu);
 }
 
-static uint16_t udp_pdu_checksum_calc(udp_pdu_t *pdu)
+/** Compute pseudo-header checksum.
+ *
+ * The rest of the checksum is completed by the network layer or the NIC
+ * (see @c csum_offs in inet_dgram_t).
+ *
+ * @param pdu PDU
+ * @return Folded one's complement sum of the pseudo-header
+ */
+static uint16_t udp_pdu_phdr_sum(udp_pdu_t *pdu)
 {
 	uint16_t cs_phdr;
 	udp_phdr_t phdr;
@@ -149,7 +127,7 @@ static uint16_t udp_pdu_checksum_calc(udp_pdu_t *pdu)
 		assert(false);
 	}
 
-	return udp_checksum_calc(cs_phdr, pdu->data, pdu->data_size);
+	return ~cs_phdr;
 }
 
 static void udp_pdu_set_checksum(udp_pdu_t *pdu, uint16_t checksum)
@@ -238,8 +216,8 @@ errno_t udp_pdu_encode(inet_ep2_t *epp, udp_msg_t *msg, udp_pdu_t **pdu)
 	memcpy((uint8_t *)npdu->data + sizeof(udp_header_t), msg->data,
 	    msg->data_size);
 
-	/* Checksum calculation */
-	checksum = udp_pdu_checksum_calc(npdu);
+	/* Partial checksum, to be completed on transmission */
+	checksum = udp_pdu_phdr_sum(npdu);
 	udp_pdu_set_checksum(npdu, checksum);
 
 	*pdu = npdu;
@@ -42,6 +42,7 @@
 #include <ipc/udp.h>
 #include <loc.h>
 #include <macros.h>
+#include <mem.h>
 #include <stdlib.h>
 
 #include "assoc.h"
@@ -54,6 +55,9 @@
 /** Maximum message size */
 #define MAX_MSG_SIZE DATA_XFER_LIMIT
 
+/** Maximum number of data events sent again after failed queue reads */
+#define UDP_EV_DATA_RETRIES 3
+
 static void udp_cassoc_recv_msg(void *, inet_ep2_t *, udp_msg_t *);
 
 /** Callbacks to tie us to association layer */
@@ -67,7 +71,8 @@ static udp_assoc_cb_t udp_cassoc_cb = {
  * @param epp    Endpoint pair on which message was received
  * @param msg    Message
  *
- * @return EOK on success, ENOMEM if out of memory
+ * @return EOK on success, ENOMEM if out of memory, ELIMIT if the
+ *         receive queue of the client association is full
  */
 static errno_t udp_cassoc_queue_msg(udp_cassoc_t *cassoc, inet_ep2_t *epp,
     udp_msg_t *msg)
@@ -77,6 +82,9 @@ static errno_t udp_cassoc_queue_msg(udp_cassoc_t *cassoc, inet_ep2_t *epp,
 	log_msg(LOG_DEFAULT, LVL_DEBUG, "udp_cassoc_queue_msg(%p, %p, %p)",
 	    cassoc, epp, msg);
 
+	if (cassoc->nrcvq >= UDP_CASSOC_RCVQ_MAX)
+		return ELIMIT;
+
 	rqe = calloc(1, sizeof(udp_crcv_queue_entry_t));
 	if (rqe == NULL)
 		return ENOMEM;
@@ -87,9 +95,22 @@ static errno_t udp_cassoc_queue_msg(udp_cassoc_t *cassoc, inet_ep2_t *epp,
 	rqe->cassoc = cassoc;
 
 	list_append(&rqe->link, &cassoc->client->crcv_queue);
+	++cassoc->nrcvq;
 	return EOK;
 }
 
+/** Remove entry from client receive queue and delete it.
+ *
+ * @param rqe Client receive queue entry
+ */
+static void udp_crcv_queue_entry_delete(udp_crcv_queue_entry_t *rqe)
+{
+	list_remove(&rqe->link);
+	--rqe->cassoc->nrcvq;
+	udp_msg_delete(rqe->msg);
+	free(rqe);
+}
+
 /** Send 'data' event to client.
  *
  * @param client Client
@@ -100,6 +121,8 @@ static void udp_ev_data(udp_client_t *client)
 
 	log_msg(LOG_DEFAULT, LVL_DEBUG, "udp_ev_data()");
 
+	client->ev_pending = true;
+
 	exch = async_exchange_begin(client->sess);
 	aid_t req = async_send_0(exch, UDP_EV_DATA, NULL);
 	async_exchange_end(exch);
@@ -107,6 +130,33 @@ static void udp_ev_data(udp_client_t *client)
 	async_forget(req);
 }
 
+/** Client stopped reading its receive queue.
+ *
+ * Called when a request of the client finds the receive queue empty
+ * or fails. In both cases the client stops reading the queue in
+ * response to the last data event. If it failed and messages are left
+ * in the queue, the client is notified again (a limited number of times
+ * in a row), otherwise the next received message notifies it.
+ *
+ * @param client Client
+ * @param rc     ENOENT if the queue is empty, otherwise the error
+ */
+static void udp_ev_data_end(udp_client_t *client, errno_t rc)
+{
+	client->ev_pending = false;
+
+	if (rc == ENOENT) {
+		client->ev_retries = 0;
+		return;
+	}
+
+	if (!list_empty(&client->crcv_queue) &&
+	    client->ev_retries < UDP_EV_DATA_RETRIES) {
+		++client->ev_retries;
+		udp_ev_data(client);
+	}
+}
+
 /** Create client association.
  *
  * This effectively adds an association into a client's namespace.
@@ -149,6 +199,14 @@ static errno_t udp_cassoc_create(udp_client_t *client, udp_assoc_t *assoc,
  */
 static void udp_cassoc_destroy(udp_cassoc_t *cassoc)
 {
+	/* Drop messages still queued for this client association */
+	list_foreach_safe(cassoc->client->crcv_queue, cur, next) {
+		udp_crcv_queue_entry_t *rqe = list_get_instance(cur,
+		    udp_crcv_queue_entry_t, link);
+		if (rqe->cassoc == cassoc)
+			udp_crcv_queue_entry_delete(rqe);
+	}
+
 	list_remove(&cassoc->lclient);
 	free(cassoc);
 }
@@ -177,7 +235,10 @@ static errno_t udp_cassoc_get(udp_client_t *client, sysarg_t id,
 
 /** Message received on client association.
  *
- * Used as udp_assoc_cb.recv_msg callback.
+ * Used as udp_assoc_cb.recv_msg callback. The client is only notified
+ * if it has no data event pending, as it reads queued messages in response
+ * to the event until it finds the queue empty or fails (see
+ * udp_ev_data_end()).
  *
  * @param arg Callback argument, client association
  * @param epp Endpoint pair where message was received
@@ -186,9 +247,20 @@ static errno_t udp_cassoc_get(udp_client_t *client, sysarg_t id,
 static void udp_cassoc_recv_msg(void *arg, inet_ep2_t *epp, udp_msg_t *msg)
 {
 	udp_cassoc_t *cassoc = (udp_cassoc_t *) arg;
+	bool notify;
+	errno_t rc;
+
+	notify = !cassoc->client->ev_pending;
 
-	udp_cassoc_queue_msg(cassoc, epp, msg);
-	udp_ev_data(cassoc->client);
+	rc = udp_cassoc_queue_msg(cassoc, epp, msg);
+	if (rc != EOK) {
+		log_msg(LOG_DEFAULT, LVL_DEBUG, "Message dropped.");
+		udp_msg_delete(msg);
+		return;
+	}
+
+	if (notify)
+		udp_ev_data(cassoc->client);
 }
 
 /** Create association.
@@ -197,12 +269,13 @@ static void udp_cassoc_recv_msg(void *arg, inet_ep2_t *epp, udp_msg_t *msg)
  *
  * @param client    UDP client
  * @param epp       Endpoint pair
+ * @param flags     Association flags
  * @param rassoc_id Place to store ID of new association
  *
  * @return EOK on success or an error code
  */
 static errno_t udp_assoc_create_impl(udp_client_t *client, inet_ep2_t *epp,
-    sysarg_t *rassoc_id)
+    udp_assoc_flags_t flags, sysarg_t *rassoc_id)
 {
 	udp_assoc_t *assoc;
 	udp_cassoc_t *cassoc;
@@ -217,6 +290,9 @@ static errno_t udp_assoc_create_impl(udp_client_t *client, inet_ep2_t *epp,
 	if (epp->local_link != 0)
 		udp_assoc_set_iplink(assoc, epp->local_link);
 
+	if ((flags & udp_af_reuseport) != 0)
+		assoc->reuseport = true;
+
 	rc = udp_cassoc_create(client, assoc, &cassoc);
 	if (rc != EOK) {
 		assert(rc == ENOMEM);
@@ -380,7 +456,8 @@ static void udp_assoc_create_srv(udp_client_t *client, ipc_call_t *icall)
 		return;
 	}
 
-	rc = udp_assoc_create_impl(client, &epp, &assoc_id);
+	rc = udp_assoc_create_impl(client, &epp, IPC_GET_ARG1(*icall),
+	    &assoc_id);
 	if (rc != EOK) {
 		async_answer_0(icall, rc);
 		return;
@@ -510,6 +587,93 @@ static void udp_assoc_send_msg_srv(udp_client_t *client, ipc_call_t *icall)
 	free(data);
 }
 
+/** Send batch of messages via association.
+ *
+ * Handle client request to send a batch of messages. Messages are sent
+ * in order until the first failure.
+ *
+ * @param client UDP client
+ * @param icall  Async request data
+ *
+ */
+static void udp_assoc_send_msgs_srv(udp_client_t *client, ipc_call_t *icall)
+{
+	ipc_call_t call;
+	udp_mrec_t *mrec;
+	sysarg_t assoc_id;
+	uint8_t *buf;
+	size_t size;
+	size_t off;
+	size_t cnt;
+	size_t sent;
+	errno_t rc;
+
+	log_msg(LOG_DEFAULT, LVL_DEBUG, "udp_assoc_send_msgs_srv()");
+
+	if (!async_data_write_receive(&call, &size)) {
+		async_answer_0(&call, EREFUSED);
+		async_answer_0(icall, EREFUSED);
+		return;
+	}
+
+	if (size > MAX_MSG_SIZE) {
+		async_answer_0(&call, EINVAL);
+		async_answer_0(icall, EINVAL);
+		return;
+	}
+
+	buf = malloc(size);
+	if (buf == NULL) {
+		async_answer_0(&call, ENOMEM);
+		async_answer_0(icall, ENOMEM);
+		return;
+	}
+
+	rc = async_data_write_finalize(&call, buf, size);
+	if (rc != EOK) {
+		async_answer_0(&call, rc);
+		async_answer_0(icall, rc);
+		free(buf);
+		return;
+	}
+
+	assoc_id = IPC_GET_ARG1(*icall);
+	cnt = IPC_GET_ARG2(*icall);
+
+	off = 0;
+	rc = EOK;
+	for (sent = 0; sent < cnt; sent++) {
+		if (size - off < sizeof(udp_mrec_t)) {
+			rc = EINVAL;
+			break;
+		}
+
+		mrec = (udp_mrec_t *) (buf + off);
+		if (mrec->size > size - off - sizeof(udp_mrec_t)) {
+			rc = EINVAL;
+			break;
+		}
+
+		rc = udp_assoc_send_msg_impl(client, assoc_id,
+		    inet_addr_is_any(&mrec->ep.addr) &&
+		    mrec->ep.port == inet_port_any ? NULL : &mrec->ep,
+		    mrec + 1, mrec->size);
+		if (rc != EOK)
+			break;
+
+		off += min(UDP_MREC_SIZE(mrec->size), size - off);
+	}
+
+	free(buf);
+
+	if (sent == 0 && rc != EOK) {
+		async_answer_0(icall, rc);
+		return;
+	}
+
+	async_answer_1(icall, EOK, sent);
+}
+
 /** Get next received message.
  *
  * @param client UDP Client
@@ -548,12 +712,14 @@ static void udp_rmsg_info_srv(udp_client_t *client, ipc_call_t *icall)
 	if (!async_data_read_receive(&call, &size)) {
 		async_answer_0(&call, EREFUSED);
 		async_answer_0(icall, EREFUSED);
+		udp_ev_data_end(client, EREFUSED);
 		return;
 	}
 
 	if (enext == NULL) {
 		async_answer_0(&call, ENOENT);
 		async_answer_0(icall, ENOENT);
+		udp_ev_data_end(client, ENOENT);
 		return;
 	}
 
@@ -561,6 +727,7 @@ static void udp_rmsg_info_srv(udp_client_t *client, ipc_call_t *icall)
 	    max(size, (size_t)sizeof(inet_ep_t)));
 	if (rc != EOK) {
 		async_answer_0(icall, rc);
+		udp_ev_data_end(client, rc);
 		return;
 	}
 
@@ -645,15 +812,102 @@ static void udp_rmsg_discard_srv(udp_client_t *client, ipc_call_t *icall)
 	if (enext == NULL) {
 		log_msg(LOG_DEFAULT, LVL_DEBUG, "usg_rmsg_discard_srv: enext==NULL");
 		async_answer_0(icall, ENOENT);
+		udp_ev_data_end(client, ENOENT);
 		return;
 	}
 
-	list_remove(&enext->link);
-	udp_msg_delete(enext->msg);
-	free(enext);
+	udp_crcv_queue_entry_delete(enext);
 	async_answer_0(icall, EOK);
 }
 
+/** Read batch of received messages.
+ *
+ * Handle client request to read as many received messages as fit
+ * in the client buffer. The messages are removed from the queue.
+ *
+ * @param client UDP client
+ * @param icall  Async request data
+ *
+ */
+static void udp_rmsg_read_msgs_srv(udp_client_t *client, ipc_call_t *icall)
+{
+	ipc_call_t call;
+	udp_mrec_t *mrec;
+	uint8_t *buf;
+	size_t size;
+	size_t bsize;
+	size_t cnt;
+	size_t i;
+	errno_t rc;
+
+	log_msg(LOG_DEFAULT, LVL_DEBUG, "udp_rmsg_read_msgs_srv()");
+
+	if (!async_data_read_receive(&call, &size)) {
+		async_answer_0(&call, EREFUSED);
+		async_answer_0(icall, EREFUSED);
+		udp_ev_data_end(client, EREFUSED);
+		return;
+	}
+
+	if (list_empty(&client->crcv_queue)) {
+		async_answer_0(&call, ENOENT);
+		async_answer_0(icall, ENOENT);
+		udp_ev_data_end(client, ENOENT);
+		return;
+	}
+
+	/* Determine how many messages fit */
+	bsize = 0;
+	cnt = 0;
+	list_foreach(client->crcv_queue, link, udp_crcv_queue_entry_t, rqe) {
+		if (bsize + UDP_MREC_SIZE(rqe->msg->data_size) > size)
+			break;
+		bsize += UDP_MREC_SIZE(rqe->msg->data_size);
+		++cnt;
+	}
+
+	if (cnt == 0) {
+		async_answer_0(&call, EOVERFLOW);
+		async_answer_0(icall, EOVERFLOW);
+		return;
+	}
+
+	buf = calloc(1, bsize);
+	if (buf == NULL) {
+		async_answer_0(&call, ENOMEM);
+		async_answer_0(icall, ENOMEM);
+		udp_ev_data_end(client, ENOMEM);
+		return;
+	}
+
+	bsize = 0;
+	i = 0;
+	list_foreach(client->crcv_queue, link, udp_crcv_queue_entry_t, rqe) {
+		if (i++ >= cnt)
+			break;
+
+		mrec = (udp_mrec_t *) (buf + bsize);
+		mrec->assoc_id = rqe->cassoc->id;
+		mrec->ep = rqe->epp.remote;
+		mrec->size = rqe->msg->data_size;
+		memcpy(mrec + 1, rqe->msg->data, rqe->msg->data_size);
+		bsize += UDP_MREC_SIZE(rqe->msg->data_size);
+	}
+
+	rc = async_data_read_finalize(&call, buf, bsize);
+	free(buf);
+	if (rc != EOK) {
+		async_answer_0(icall, rc);
+		udp_ev_data_end(client, rc);
+		return;
+	}
+
+	for (i = 0; i < cnt; i++)
+		udp_crcv_queue_entry_delete(udp_rmsg_get_next(client));
+
+	async_answer_1(icall, EOK, cnt);
+}
+
 /** Handle UDP client connection.
  *
  * @param icall Connect call data
@@ -673,6 +927,8 @@ static void udp_client_conn(ipc_call_t *icall, void *arg)
 	client.sess = NULL;
 	list_initialize(&client.cassoc);
 	list_initialize(&client.crcv_queue);
+	client.ev_pending = false;
+	client.ev_retries = 0;
 
 	while (true) {
 		log_msg(LOG_DEFAULT, LVL_DEBUG, "udp_client_conn: wait req");
@@ -713,6 +969,12 @@ static void udp_client_conn(ipc_call_t *icall, void *arg)
 		case UDP_RMSG_DISCARD:
 			udp_rmsg_discard_srv(&client, &call);
 			break;
+		case UDP_ASSOC_SEND_MSGS:
+			udp_assoc_send_msgs_srv(&client, &call);
+			break;
+		case UDP_RMSG_READ_MSGS:
+			udp_rmsg_read_msgs_srv(&client, &call);
+			break;
 		default:
 			async_answer_0(&call, ENOTSUP);
 			break;
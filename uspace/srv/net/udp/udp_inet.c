@@ -37,6 +37,7 @@
 #include <errno.h>
 #include <inet/inet.h>
 #include <io/log.h>
+#include <stddef.h>
 
 #include "assoc.h"
 #include "pdu.h"
@@ -89,6 +90,7 @@ errno_t udp_transmit_pdu(udp_pdu_t *pdu)
 	dgram.tos = 0;
 	dgram.data = pdu->data;
 	dgram.size = pdu->data_size;
+	dgram.csum_offs = offsetof(udp_header_t, checksum);
 
 	rc = inet_send(&dgram, INET_TTL_MAX, 0);
 	if (rc != EOK)
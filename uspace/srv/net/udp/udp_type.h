@@ -47,6 +47,9 @@
 
 #define UDP_FRAGMENT_SIZE 65535
 
+/** Maximum number of messages queued for a client association */
+#define UDP_CASSOC_RCVQ_MAX 256
+
 /** UDP error codes */
 typedef enum {
 	UDP_EOK,
@@ -92,6 +95,8 @@ typedef struct {
 	void (*recv_msg)(void *, inet_ep2_t *, udp_msg_t *);
 } udp_assoc_cb_t;
 
+struct udp_rgroup;
+
 /** UDP association
  *
  * This is a rough equivalent of a TCP connection endpoint. It allows
@@ -122,6 +127,12 @@ typedef struct {
 	fibril_condvar_t rcv_queue_cv;
 	/** Allow sending messages with no local address */
 	bool nolocal;
+	/** Allow other associations to share the endpoint pair */
+	bool reuseport;
+	/** Reuse port group or @c NULL if not sharing the endpoint pair */
+	struct udp_rgroup *rgroup;
+	/** Link to udp_rgroup_t.assocs */
+	link_t lrgroup;
 
 	udp_assoc_cb_t *cb;
 	void *cb_arg;
@@ -130,6 +141,19 @@ typedef struct {
 typedef struct {
 } udp_assoc_status_t;
 
+/** Reuse port group.
+ *
+ * Associations sharing the same endpoint pair. Only the first one
+ * is entered in the association map, incoming messages are distributed
+ * among all members based on the remote endpoint.
+ */
+typedef struct udp_rgroup {
+	/** Member associations */
+	list_t assocs; /* of udp_assoc_t */
+	/** Number of member associations */
+	size_t nassocs;
+} udp_rgroup_t;
+
 /** UDP receive queue entry */
 typedef struct {
 	/** Link to receive queue */
@@ -152,6 +176,8 @@ typedef struct udp_cassoc {
 	/** Client */
 	struct udp_client *client;
 	link_t lclient;
+	/** Number of messages in client receive queue */
+	size_t nrcvq;
 } udp_cassoc_t;
 
 /** UDP client receive queue entry */
@@ -174,6 +200,10 @@ typedef struct udp_client {
 	list_t cassoc; /* of udp_cassoc_t */
 	/** Client receive queue */
 	list_t crcv_queue;
+	/** Data event sent, client has not emptied the receive queue yet */
+	bool ev_pending;
+	/** Data events sent again after failed reads of the receive queue */
+	unsigned ev_retries;
 } udp_client_t;
 
 #endif
@@ -99,6 +99,14 @@ int main(int argc, char **argv)
 		return ENOMEM;
 	}
 
+	/*
+	 * Initialize the name and attribute cache.
+	 */
+	if (!vfs_dcache_init()) {
+		printf("%s: Failed to initialize name cache\n", NAME);
+		return ENOMEM;
+	}
+
 	/*
 	 * Allocate and initialize the Path Lookup Buffer.
 	 */
@@ -154,16 +154,20 @@ extern list_t fs_mntlist;	/**< List of mounted file systems. */
 
 extern vfs_pair_t rootfs;	/**< Root file system. */
 
+/** Size of one PLB slot. */
+#define PLB_SLOT_SIZE	1024
+
+/** Number of PLB slots. */
+#define PLB_SLOTS	(PLB_SIZE / PLB_SLOT_SIZE)
+
 /** Each instance of this type describes one path lookup in progress. */
 typedef struct {
-	link_t	plb_link;	/**< Active PLB entries list link. */
 	unsigned index;		/**< Index of the first character in PLB. */
 	size_t len;		/**< Number of characters in this PLB entry. */
+	uint64_t slots;		/**< Bitmap of PLB slots claimed by the entry. */
 } plb_entry_t;
 
-extern fibril_mutex_t plb_mutex;/**< Mutex protecting plb and plb_entries. */
 extern uint8_t *plb;		/**< Path Lookup Buffer */
-extern list_t plb_entries;	/**< List of active PLB entries. */
 
 /** Holding this rwlock prevents changes in file system namespace. */
 extern fibril_rwlock_t namespace_rwlock;
@@ -176,8 +180,22 @@ extern vfs_info_t *fs_handle_to_info(fs_handle_t);
 extern errno_t vfs_get_fstypes(vfs_fstypes_t *);
 
 extern errno_t vfs_lookup_internal(vfs_node_t *, char *, int, vfs_lookup_res_t *);
+extern void vfs_lookup_stats_get(vfs_stats_t *);
 extern errno_t vfs_link_internal(vfs_node_t *, char *, vfs_triplet_t *);
 
+extern bool vfs_dcache_init(void);
+extern bool vfs_dcache_enabled(fs_handle_t);
+extern bool vfs_dcache_lookup(vfs_triplet_t *, const char *, size_t, int,
+    errno_t *, size_t *, vfs_lookup_res_t *, unsigned *);
+extern void vfs_dcache_insert(unsigned, vfs_triplet_t *, const char *, size_t,
+    int, errno_t, size_t, vfs_lookup_res_t *);
+extern void vfs_dcache_size_update(vfs_triplet_t *, aoff64_t);
+extern void vfs_dcache_invalidate(bool);
+extern void vfs_dcache_stats_get(vfs_stats_t *);
+extern bool vfs_acache_get(vfs_triplet_t *, vfs_stat_t *, unsigned *);
+extern void vfs_acache_insert(unsigned, vfs_triplet_t *, vfs_stat_t *);
+extern void vfs_acache_invalidate(vfs_triplet_t *);
+
 extern bool vfs_nodes_init(void);
 extern vfs_node_t *vfs_node_get(vfs_lookup_res_t *);
 extern vfs_node_t *vfs_node_peek(vfs_lookup_res_t *result);
@@ -210,16 +228,21 @@ extern errno_t vfs_op_mtab_get(void);
 extern errno_t vfs_op_open(int fd, int flags);
 extern errno_t vfs_op_put(int fd);
 extern errno_t vfs_op_read(int fd, aoff64_t, size_t *out_bytes);
+extern errno_t vfs_op_readv(int fd, aoff64_t, const size_t *, size_t,
+    size_t *out_bytes);
 extern errno_t vfs_op_rename(int basefd, char *old, char *new);
 extern errno_t vfs_op_resize(int fd, int64_t size);
 extern errno_t vfs_op_stat(int fd);
 extern errno_t vfs_op_statfs(int fd);
+extern errno_t vfs_op_stats(vfs_stats_t *);
 extern errno_t vfs_op_sync(int fd);
 extern errno_t vfs_op_unlink(int parentfd, int expectfd, char *path);
 extern errno_t vfs_op_unmount(int mpfd);
 extern errno_t vfs_op_wait_handle(bool high_fd, int *out_fd);
 extern errno_t vfs_op_walk(int parentfd, int flags, char *path, int *out_fd);
 extern errno_t vfs_op_write(int fd, aoff64_t, size_t *out_bytes);
+extern errno_t vfs_op_writev(int fd, aoff64_t, const size_t *, size_t,
+    size_t *out_bytes);
 
 extern void vfs_register(ipc_call_t *);
 
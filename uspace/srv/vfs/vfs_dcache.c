@@ -0,0 +1,549 @@
+/*
+ * Copyright (c) 2019 Jiri Svoboda
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * - Redistributions of source code must retain the above copyright
+ *   notice, this list of conditions and the following disclaimer.
+ * - Redistributions in binary form must reproduce the above copyright
+ *   notice, this list of conditions and the following disclaimer in the
+ *   documentation and/or other materials provided with the distribution.
+ * - The name of the author may not be used to endorse or promote products
+ *   derived from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHOR ``AS IS'' AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+ * OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+ * IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT
+ * NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF
+ * THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/** @addtogroup vfs
+ * @{
+ */
+
+/**
+ * @file	vfs_dcache.c
+ * @brief	Name and attribute cache.
+ *
+ * The name cache remembers results of VFS_OUT_LOOKUP requests, i.e. the
+ * mapping of a (base node, path) pair to the node where the file system
+ * server stopped the lookup. Lookups which did not find the file are
+ * cached as well (negative entries). The attribute cache remembers results
+ * of VFS_OUT_STAT requests.
+ *
+ * Both caches are only used for file systems which declare themselves
+ * cacheable upon registration. Any change of the file system name space
+ * done through VFS invalidates the entire cache. To prevent a lookup which
+ * raced with such a change from inserting a stale entry, each insertion is
+ * tagged with the cache generation observed before the request was sent
+ * to the file system server.
+ */
+
+#include "vfs.h"
+#include <adt/hash.h>
+#include <adt/hash_table.h>
+#include <adt/list.h>
+#include <errno.h>
+#include <fibril_synch.h>
+#include <mem.h>
+#include <stdlib.h>
+#include <str.h>
+
+/** Maximum number of cached lookups. */
+#define DCACHE_ENTRIES_MAX	1024
+
+/** Maximum length of a cached path. */
+#define DCACHE_PATH_MAX		256
+
+/** Maximum number of cached node attributes. */
+#define ACACHE_ENTRIES_MAX	1024
+
+/** Cached lookup. */
+typedef struct {
+	ht_link_t ht_link;	/**< Name cache hash table link. */
+	link_t lru_link;	/**< Name cache LRU list link. */
+	vfs_triplet_t base;	/**< Node from which the lookup started. */
+	int lflag;		/**< Lookup flags relevant to the result. */
+	char *path;		/**< Looked up path (not NULL-terminated). */
+	size_t len;		/**< Length of path. */
+	errno_t rc;		/**< Return code of the lookup. */
+	size_t consumed;	/**< Number of path characters resolved. */
+	vfs_lookup_res_t res;	/**< Lookup result. */
+} dcache_entry_t;
+
+/** Name cache lookup key. */
+typedef struct {
+	vfs_triplet_t *base;
+	const char *path;
+	size_t len;
+	int lflag;
+} dcache_key_t;
+
+/** Cached node attributes. */
+typedef struct {
+	ht_link_t ht_link;	/**< Attribute cache hash table link. */
+	link_t lru_link;	/**< Attribute cache LRU list link. */
+	vfs_triplet_t triplet;	/**< Node identity. */
+	vfs_stat_t stat;	/**< Node attributes. */
+} acache_entry_t;
+
+/** Mutex protecting both caches. */
+static FIBRIL_MUTEX_INITIALIZE(dcache_mutex);
+
+/** Cache generation, incremented on every invalidation. */
+static unsigned dcache_gen;
+
+static hash_table_t dentries;
+static LIST_INITIALIZE(dentries_lru);
+
+static hash_table_t attrs;
+static LIST_INITIALIZE(attrs_lru);
+
+static uint64_t stat_dcache_hits;
+static uint64_t stat_dcache_neg_hits;
+static uint64_t stat_dcache_misses;
+static uint64_t stat_acache_hits;
+static uint64_t stat_acache_misses;
+
+static size_t triplet_hash(vfs_triplet_t *tri)
+{
+	size_t hash = hash_combine(tri->fs_handle, tri->index);
+	return hash_combine(hash, tri->service_id);
+}
+
+static bool triplet_equal(vfs_triplet_t *a, vfs_triplet_t *b)
+{
+	return a->fs_handle == b->fs_handle &&
+	    a->service_id == b->service_id && a->index == b->index;
+}
+
+static size_t dentries_key_hash(void *arg)
+{
+	dcache_key_t *key = (dcache_key_t *) arg;
+	size_t hash = hash_combine(triplet_hash(key->base), key->lflag);
+
+	for (size_t i = 0; i < key->len; i++)
+		hash = hash * 31 + (uint8_t) key->path[i];
+
+	return hash_mix(hash);
+}
+
+static size_t dentries_hash(const ht_link_t *item)
+{
+	dcache_entry_t *entry = hash_table_get_inst(item, dcache_entry_t,
+	    ht_link);
+	dcache_key_t key = {
+		.base = &entry->base,
+		.path = entry->path,
+		.len = entry->len,
+		.lflag = entry->lflag
+	};
+
+	return dentries_key_hash(&key);
+}
+
+static bool dentries_key_equal(void *arg, const ht_link_t *item)
+{
+	dcache_key_t *key = (dcache_key_t *) arg;
+	dcache_entry_t *entry = hash_table_get_inst(item, dcache_entry_t,
+	    ht_link);
+
+	return triplet_equal(key->base, &entry->base) &&
+	    key->lflag == entry->lflag && key->len == entry->len &&
+	    memcmp(key->path, entry->path, key->len) == 0;
+}
+
+static bool dentries_equal(const ht_link_t *item1, const ht_link_t *item2)
+{
+	dcache_entry_t *entry = hash_table_get_inst(item1, dcache_entry_t,
+	    ht_link);
+	dcache_key_t key = {
+		.base = &entry->base,
+		.path = entry->path,
+		.len = entry->len,
+		.lflag = entry->lflag
+	};
+
+	return dentries_key_equal(&key, item2);
+}
+
+static void dentries_remove_callback(ht_link_t *item)
+{
+	dcache_entry_t *entry = hash_table_get_inst(item, dcache_entry_t,
+	    ht_link);
+
+	list_remove(&entry->lru_link);
+	free(entry->path);
+	free(entry);
+}
+
+static hash_table_ops_t dentries_ops = {
+	.hash = dentries_hash,
+	.key_hash = dentries_key_hash,
+	.key_equal = dentries_key_equal,
+	.equal = dentries_equal,
+	.remove_callback = dentries_remove_callback
+};
+
+static size_t attrs_key_hash(void *key)
+{
+	return triplet_hash((vfs_triplet_t *) key);
+}
+
+static size_t attrs_hash(const ht_link_t *item)
+{
+	acache_entry_t *entry = hash_table_get_inst(item, acache_entry_t,
+	    ht_link);
+	return triplet_hash(&entry->triplet);
+}
+
+static bool attrs_key_equal(void *key, const ht_link_t *item)
+{
+	acache_entry_t *entry = hash_table_get_inst(item, acache_entry_t,
+	    ht_link);
+	return triplet_equal((vfs_triplet_t *) key, &entry->triplet);
+}
+
+static bool attrs_equal(const ht_link_t *item1, const ht_link_t *item2)
+{
+	acache_entry_t *entry = hash_table_get_inst(item1, acache_entry_t,
+	    ht_link);
+	return attrs_key_equal(&entry->triplet, item2);
+}
+
+static void attrs_remove_callback(ht_link_t *item)
+{
+	acache_entry_t *entry = hash_table_get_inst(item, acache_entry_t,
+	    ht_link);
+
+	list_remove(&entry->lru_link);
+	free(entry);
+}
+
+static hash_table_ops_t attrs_ops = {
+	.hash = attrs_hash,
+	.key_hash = attrs_key_hash,
+	.key_equal = attrs_key_equal,
+	.equal = attrs_equal,
+	.remove_callback = attrs_remove_callback
+};
+
+/** Initialize the name and attribute cache.
+ *
+ * @return		Return true on success, false on failure.
+ */
+bool vfs_dcache_init(void)
+{
+	if (!hash_table_create(&dentries, 0, 0, &dentries_ops))
+		return false;
+
+	if (!hash_table_create(&attrs, 0, 0, &attrs_ops)) {
+		hash_table_destroy(&dentries);
+		return false;
+	}
+
+	return true;
+}
+
+/** Determine whether nodes of a file system can be cached.
+ *
+ * @param fs_handle	File system handle.
+ *
+ * @return		True if the file system is cacheable.
+ */
+bool vfs_dcache_enabled(fs_handle_t fs_handle)
+{
+	vfs_info_t *info = fs_handle_to_info(fs_handle);
+	return info != NULL && info->cacheable;
+}
+
+/** Return lookup flags which influence the result of VFS_OUT_LOOKUP. */
+static int dcache_lflag(int lflag)
+{
+	return lflag & (L_FILE | L_DIRECTORY);
+}
+
+/** Look up a cached lookup result.
+ *
+ * @param base		Node from which the lookup starts.
+ * @param path		Path to look up (need not be NULL-terminated).
+ * @param len		Length of path.
+ * @param lflag		Lookup flags.
+ * @param[out] rc	Return code of the cached lookup.
+ * @param[out] consumed	Number of path characters resolved.
+ * @param[out] res	Lookup result.
+ * @param[out] gen	Cache generation to pass to vfs_dcache_insert() on miss.
+ *
+ * @return		True on cache hit, false on miss.
+ */
+bool vfs_dcache_lookup(vfs_triplet_t *base, const char *path, size_t len,
+    int lflag, errno_t *rc, size_t *consumed, vfs_lookup_res_t *res,
+    unsigned *gen)
+{
+	dcache_key_t key = {
+		.base = base,
+		.path = path,
+		.len = len,
+		.lflag = dcache_lflag(lflag)
+	};
+
+	fibril_mutex_lock(&dcache_mutex);
+
+	*gen = dcache_gen;
+
+	ht_link_t *link = hash_table_find(&dentries, &key);
+	if (link == NULL) {
+		stat_dcache_misses++;
+		fibril_mutex_unlock(&dcache_mutex);
+		return false;
+	}
+
+	dcache_entry_t *entry = hash_table_get_inst(link, dcache_entry_t,
+	    ht_link);
+
+	/* Move the entry to the head of the LRU list. */
+	list_remove(&entry->lru_link);
+	list_prepend(&entry->lru_link, &dentries_lru);
+
+	*rc = entry->rc;
+	*consumed = entry->consumed;
+	*res = entry->res;
+
+	if (entry->rc != EOK || entry->consumed != len)
+		stat_dcache_neg_hits++;
+	else
+		stat_dcache_hits++;
+
+	fibril_mutex_unlock(&dcache_mutex);
+	return true;
+}
+
+/** Insert a lookup result into the cache.
+ *
+ * @param gen		Cache generation returned by vfs_dcache_lookup().
+ * @param base		Node from which the lookup started.
+ * @param path		Looked up path (need not be NULL-terminated).
+ * @param len		Length of path.
+ * @param lflag		Lookup flags.
+ * @param rc		Return code of the lookup.
+ * @param consumed	Number of path characters resolved.
+ * @param res		Lookup result.
+ */
+void vfs_dcache_insert(unsigned gen, vfs_triplet_t *base, const char *path,
+    size_t len, int lflag, errno_t rc, size_t consumed, vfs_lookup_res_t *res)
+{
+	/* Only cache definite answers. */
+	if (rc != EOK && rc != ENOENT && rc != ENOTDIR && rc != EISDIR)
+		return;
+
+	if (len > DCACHE_PATH_MAX)
+		return;
+
+	dcache_entry_t *entry = malloc(sizeof(dcache_entry_t));
+	if (entry == NULL)
+		return;
+
+	entry->path = malloc(len);
+	if (entry->path == NULL) {
+		free(entry);
+		return;
+	}
+
+	memcpy(entry->path, path, len);
+	entry->len = len;
+	entry->base = *base;
+	entry->lflag = dcache_lflag(lflag);
+	entry->rc = rc;
+	entry->consumed = consumed;
+	if (rc == EOK)
+		entry->res = *res;
+	else
+		memset(&entry->res, 0, sizeof(vfs_lookup_res_t));
+	link_initialize(&entry->lru_link);
+
+	fibril_mutex_lock(&dcache_mutex);
+
+	if (gen != dcache_gen || !hash_table_insert_unique(&dentries,
+	    &entry->ht_link)) {
+		/* Raced with invalidation or another insertion. */
+		fibril_mutex_unlock(&dcache_mutex);
+		free(entry->path);
+		free(entry);
+		return;
+	}
+
+	list_prepend(&entry->lru_link, &dentries_lru);
+
+	if (hash_table_size(&dentries) > DCACHE_ENTRIES_MAX) {
+		dcache_entry_t *old = list_get_instance(list_last(&dentries_lru),
+		    dcache_entry_t, lru_link);
+		hash_table_remove_item(&dentries, &old->ht_link);
+	}
+
+	fibril_mutex_unlock(&dcache_mutex);
+}
+
+/** Update cached size of a node.
+ *
+ * The size of a node which is not active is taken from the lookup result.
+ * This needs to be called when an active node whose size may have changed
+ * is being released.
+ *
+ * @param triplet	Node identity.
+ * @param size		Current size of the node.
+ */
+void vfs_dcache_size_update(vfs_triplet_t *triplet, aoff64_t size)
+{
+	fibril_mutex_lock(&dcache_mutex);
+
+	list_foreach(dentries_lru, lru_link, dcache_entry_t, entry) {
+		if (entry->rc == EOK &&
+		    triplet_equal(&entry->res.triplet, triplet))
+			entry->res.size = size;
+	}
+
+	fibril_mutex_unlock(&dcache_mutex);
+}
+
+/** Look up cached node attributes.
+ *
+ * @param triplet	Node identity.
+ * @param[out] stat	Node attributes.
+ * @param[out] gen	Cache generation to pass to vfs_acache_insert() on miss.
+ *
+ * @return		True on cache hit, false on miss.
+ */
+bool vfs_acache_get(vfs_triplet_t *triplet, vfs_stat_t *stat, unsigned *gen)
+{
+	fibril_mutex_lock(&dcache_mutex);
+
+	*gen = dcache_gen;
+
+	ht_link_t *link = hash_table_find(&attrs, triplet);
+	if (link == NULL) {
+		stat_acache_misses++;
+		fibril_mutex_unlock(&dcache_mutex);
+		return false;
+	}
+
+	acache_entry_t *entry = hash_table_get_inst(link, acache_entry_t,
+	    ht_link);
+
+	list_remove(&entry->lru_link);
+	list_prepend(&entry->lru_link, &attrs_lru);
+
+	*stat = entry->stat;
+	stat_acache_hits++;
+
+	fibril_mutex_unlock(&dcache_mutex);
+	return true;
+}
+
+/** Insert node attributes into the cache.
+ *
+ * @param gen		Cache generation returned by vfs_acache_get().
+ * @param triplet	Node identity.
+ * @param stat		Node attributes.
+ */
+void vfs_acache_insert(unsigned gen, vfs_triplet_t *triplet, vfs_stat_t *stat)
+{
+	acache_entry_t *entry = malloc(sizeof(acache_entry_t));
+	if (entry == NULL)
+		return;
+
+	entry->triplet = *triplet;
+	entry->stat = *stat;
+	link_initialize(&entry->lru_link);
+
+	fibril_mutex_lock(&dcache_mutex);
+
+	if (gen != dcache_gen || !hash_table_insert_unique(&attrs,
+	    &entry->ht_link)) {
+		fibril_mutex_unlock(&dcache_mutex);
+		free(entry);
+		return;
+	}
+
+	list_prepend(&entry->lru_link, &attrs_lru);
+
+	if (hash_table_size(&attrs) > ACACHE_ENTRIES_MAX) {
+		acache_entry_t *old = list_get_instance(list_last(&attrs_lru),
+		    acache_entry_t, lru_link);
+		hash_table_remove_item(&attrs, &old->ht_link);
+	}
+
+	fibril_mutex_unlock(&dcache_mutex);
+}
+
+/** Invalidate cached attributes of a node.
+ *
+ * @param triplet	Node identity.
+ */
+void vfs_acache_invalidate(vfs_triplet_t *triplet)
+{
+	fibril_mutex_lock(&dcache_mutex);
+	dcache_gen++;
+	hash_table_remove(&attrs, triplet);
+	fibril_mutex_unlock(&dcache_mutex);
+}
+
+static bool dentries_negative_visitor(ht_link_t *item, void *arg)
+{
+	dcache_entry_t *entry = hash_table_get_inst(item, dcache_entry_t,
+	    ht_link);
+
+	if (entry->rc != EOK || entry->consumed != entry->len)
+		hash_table_remove_item(&dentries, item);
+
+	return true;
+}
+
+/** Invalidate the name and attribute cache.
+ *
+ * This must be called whenever the file system name space changes. When
+ * a name is only added to the name space, the positive name cache entries
+ * remain valid.
+ *
+ * @param negative_only	Only invalidate entries of names that were not found.
+ */
+void vfs_dcache_invalidate(bool negative_only)
+{
+	fibril_mutex_lock(&dcache_mutex);
+	dcache_gen++;
+	if (negative_only)
+		hash_table_apply(&dentries, dentries_negative_visitor, NULL);
+	else
+		hash_table_clear(&dentries);
+	hash_table_clear(&attrs);
+	fibril_mutex_unlock(&dcache_mutex);
+}
+
+/** Get name and attribute cache statistics.
+ *
+ * @param stats		Statistics structure to fill in.
+ */
+void vfs_dcache_stats_get(vfs_stats_t *stats)
+{
+	fibril_mutex_lock(&dcache_mutex);
+	stats->dcache_entries = hash_table_size(&dentries);
+	stats->dcache_hits = stat_dcache_hits;
+	stats->dcache_neg_hits = stat_dcache_neg_hits;
+	stats->dcache_misses = stat_dcache_misses;
+	stats->acache_entries = hash_table_size(&attrs);
+	stats->acache_hits = stat_acache_hits;
+	stats->acache_misses = stat_acache_misses;
+	fibril_mutex_unlock(&dcache_mutex);
+}
+
+/**
+ * @}
+ */
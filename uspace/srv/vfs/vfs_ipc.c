@@ -183,6 +183,44 @@ static void vfs_in_read(ipc_call_t *req)
 	async_answer_1(req, rc, bytes);
 }
 
+/** Receive the sizes of the data transfers of a vectored request.
+ *
+ * @param cnt        Number of data transfers announced by the client
+ * @param[out] sizes Newly allocated array of @a cnt sizes
+ *
+ * @return EOK on success or an error code
+ */
+static errno_t vfs_in_vec_sizes(size_t cnt, size_t **sizes)
+{
+	if (cnt == 0 || cnt > VFS_VEC_MAX) {
+		async_data_write_void(EINVAL);
+		return EINVAL;
+	}
+
+	return async_data_write_accept((void **) sizes, false,
+	    cnt * sizeof(size_t), cnt * sizeof(size_t), 0, NULL);
+}
+
+static void vfs_in_readv(ipc_call_t *req)
+{
+	int fd = IPC_GET_ARG1(*req);
+	aoff64_t pos = MERGE_LOUP32(IPC_GET_ARG2(*req),
+	    IPC_GET_ARG3(*req));
+	size_t cnt = IPC_GET_ARG4(*req);
+	size_t *sizes;
+
+	errno_t rc = vfs_in_vec_sizes(cnt, &sizes);
+	if (rc != EOK) {
+		async_answer_0(req, rc);
+		return;
+	}
+
+	size_t bytes = 0;
+	rc = vfs_op_readv(fd, pos, sizes, cnt, &bytes);
+	free(sizes);
+	async_answer_1(req, rc, bytes);
+}
+
 static void vfs_in_rename(ipc_call_t *req)
 {
 	/* The common base directory. */
@@ -250,6 +288,26 @@ static void vfs_in_statfs(ipc_call_t *req)
 	async_answer_0(req, rc);
 }
 
+static void vfs_in_stats(ipc_call_t *req)
+{
+	vfs_stats_t stats;
+
+	errno_t rc = vfs_op_stats(&stats);
+	async_answer_0(req, rc);
+	if (rc != EOK)
+		return;
+
+	/* Now we should get a read request */
+	ipc_call_t call;
+	size_t len;
+	if (!async_data_read_receive(&call, &len))
+		return;
+
+	if (len > sizeof(stats))
+		len = sizeof(stats);
+	(void) async_data_read_finalize(&call, &stats, len);
+}
+
 static void vfs_in_sync(ipc_call_t *req)
 {
 	int fd = IPC_GET_ARG1(*req);
@@ -315,6 +373,26 @@ static void vfs_in_write(ipc_call_t *req)
 	async_answer_1(req, rc, bytes);
 }
 
+static void vfs_in_writev(ipc_call_t *req)
+{
+	int fd = IPC_GET_ARG1(*req);
+	aoff64_t pos = MERGE_LOUP32(IPC_GET_ARG2(*req),
+	    IPC_GET_ARG3(*req));
+	size_t cnt = IPC_GET_ARG4(*req);
+	size_t *sizes;
+
+	errno_t rc = vfs_in_vec_sizes(cnt, &sizes);
+	if (rc != EOK) {
+		async_answer_0(req, rc);
+		return;
+	}
+
+	size_t bytes = 0;
+	rc = vfs_op_writev(fd, pos, sizes, cnt, &bytes);
+	free(sizes);
+	async_answer_1(req, rc, bytes);
+}
+
 void vfs_connection(ipc_call_t *icall, void *arg)
 {
 	bool cont = true;
@@ -356,6 +434,9 @@ void vfs_connection(ipc_call_t *icall, void *arg)
 		case VFS_IN_READ:
 			vfs_in_read(&call);
 			break;
+		case VFS_IN_READV:
+			vfs_in_readv(&call);
+			break;
 		case VFS_IN_REGISTER:
 			vfs_register(&call);
 			cont = false;
@@ -372,6 +453,9 @@ void vfs_connection(ipc_call_t *icall, void *arg)
 		case VFS_IN_STATFS:
 			vfs_in_statfs(&call);
 			break;
+		case VFS_IN_STATS:
+			vfs_in_stats(&call);
+			break;
 		case VFS_IN_SYNC:
 			vfs_in_sync(&call);
 			break;
@@ -390,6 +474,9 @@ void vfs_connection(ipc_call_t *icall, void *arg)
 		case VFS_IN_WRITE:
 			vfs_in_write(&call);
 			break;
+		case VFS_IN_WRITEV:
+			vfs_in_writev(&call);
+			break;
 		default:
 			async_answer_0(&call, ENOTSUP);
 			break;
@@ -43,98 +43,173 @@
 #include <stdarg.h>
 #include <stdbool.h>
 #include <fibril_synch.h>
+#include <stdatomic.h>
+#include <time.h>
 #include <adt/list.h>
 #include <vfs/canonify.h>
 #include <dirent.h>
 #include <assert.h>
 
-FIBRIL_MUTEX_INITIALIZE(plb_mutex);
-LIST_INITIALIZE(plb_entries);	/**< PLB entry ring buffer. */
 uint8_t *plb = NULL;
 
-static errno_t plb_insert_entry(plb_entry_t *entry, char *path, size_t *start,
-    size_t len)
-{
-	fibril_mutex_lock(&plb_mutex);
+/** Bitmap of PLB slots claimed by lookups in progress. */
+static _Atomic uint64_t plb_slots = 0;
 
-	link_initialize(&entry->plb_link);
-	entry->len = len;
+/** Number of fibrils waiting for PLB space. */
+static atomic_uint plb_waiters = 0;
 
-	size_t first;	/* the first free index */
-	size_t last;	/* the last free index */
+/** Mutex protecting plb_avail_cv. */
+static FIBRIL_MUTEX_INITIALIZE(plb_mutex);
 
-	if (list_empty(&plb_entries)) {
-		first = 0;
-		last = PLB_SIZE - 1;
-	} else {
-		plb_entry_t *oldest = list_get_instance(
-		    list_first(&plb_entries), plb_entry_t, plb_link);
-		plb_entry_t *newest = list_get_instance(
-		    list_last(&plb_entries), plb_entry_t, plb_link);
+/** Condition variable signalled when PLB slots are released. */
+static FIBRIL_CONDVAR_INITIALIZE(plb_avail_cv);
 
-		first = (newest->index + newest->len) % PLB_SIZE;
-		last = (oldest->index - 1) % PLB_SIZE;
-	}
+/** Lookup statistics. */
+static atomic_uint_fast64_t stat_lookups = 0;
+static atomic_uint_fast64_t stat_active = 0;
+static atomic_uint_fast64_t stat_active_max = 0;
+static atomic_uint_fast64_t stat_waits = 0;
+static atomic_uint_fast64_t stat_wait_usec = 0;
 
-	if (first <= last) {
-		if ((last - first) + 1 < len) {
-			/*
-			 * The buffer cannot absorb the path.
-			 */
-			fibril_mutex_unlock(&plb_mutex);
-			return ELIMIT;
+/** Try to claim a run of free PLB slots.
+ *
+ * @param cnt Number of consecutive slots to claim.
+ * @param[out] first Index of the first claimed slot.
+ *
+ * @return Bitmap of the claimed slots or zero if there is no such run.
+ */
+static uint64_t plb_slots_claim(unsigned cnt, unsigned *first)
+{
+	uint64_t mask = (cnt == 64) ? UINT64_MAX : ((UINT64_C(1) << cnt) - 1);
+	uint64_t cur = atomic_load(&plb_slots);
+
+	unsigned i = 0;
+	while (i + cnt <= PLB_SLOTS) {
+		uint64_t run = mask << i;
+
+		if ((cur & run) != 0) {
+			i++;
+			continue;
 		}
-	} else {
-		if (PLB_SIZE - ((first - last) + 1) < len) {
-			/*
-			 * The buffer cannot absorb the path.
-			 */
-			fibril_mutex_unlock(&plb_mutex);
-			return ELIMIT;
+
+		if (atomic_compare_exchange_weak(&plb_slots, &cur, cur | run)) {
+			*first = i;
+			return run;
 		}
+
+		/* cur was reloaded, try the same position again */
 	}
 
-	/*
-	 * We know the first free index in PLB and we also know that there is
-	 * enough space in the buffer to hold our path.
-	 */
+	return 0;
+}
 
-	entry->index = first;
-	entry->len = len;
+/** Release PLB slots and wake up the waiters.
+ *
+ * @param slots Bitmap of the slots to release.
+ */
+static void plb_slots_release(uint64_t slots)
+{
+	atomic_fetch_and(&plb_slots, ~slots);
 
-	/*
-	 * Claim PLB space by inserting the entry into the PLB entry ring
-	 * buffer.
-	 */
-	list_append(&entry->plb_link, &plb_entries);
+	if (atomic_load(&plb_waiters) > 0) {
+		fibril_mutex_lock(&plb_mutex);
+		fibril_condvar_broadcast(&plb_avail_cv);
+		fibril_mutex_unlock(&plb_mutex);
+	}
+}
+
+/** Update the maximum number of concurrent lookups. */
+static void plb_stat_active_inc(void)
+{
+	uint_fast64_t active = atomic_fetch_add(&stat_active, 1) + 1;
+	uint_fast64_t max = atomic_load(&stat_active_max);
+
+	while (active > max) {
+		if (atomic_compare_exchange_weak(&stat_active_max, &max,
+		    active))
+			break;
+	}
+}
+
+/** Insert path into PLB.
+ *
+ * The PLB is divided into PLB_SLOTS slots of PLB_SLOT_SIZE bytes. Each
+ * lookup claims a run of consecutive slots large enough to hold the path,
+ * so that independent lookups do not need to serialize. If there is not
+ * enough space, the caller waits until some of the other lookups finish.
+ *
+ * The entry never ends exactly at the end of PLB, thus the position
+ * returned by the file system server always fits into 16 bits.
+ */
+static errno_t plb_insert_entry(plb_entry_t *entry, char *path, size_t *start,
+    size_t len)
+{
+	unsigned cnt = len / PLB_SLOT_SIZE + 1;
+	unsigned first;
+
+	if (cnt > PLB_SLOTS)
+		return ELIMIT;
+
+	entry->slots = plb_slots_claim(cnt, &first);
+	if (entry->slots == 0) {
+		struct timespec ts_start;
+		struct timespec ts_end;
+
+		getuptime(&ts_start);
+
+		fibril_mutex_lock(&plb_mutex);
+		atomic_fetch_add(&plb_waiters, 1);
+
+		while ((entry->slots = plb_slots_claim(cnt, &first)) == 0)
+			fibril_condvar_wait(&plb_avail_cv, &plb_mutex);
+
+		atomic_fetch_sub(&plb_waiters, 1);
+		fibril_mutex_unlock(&plb_mutex);
+
+		getuptime(&ts_end);
+
+		atomic_fetch_add(&stat_waits, 1);
+		atomic_fetch_add(&stat_wait_usec,
+		    NSEC2USEC(ts_sub_diff(&ts_end, &ts_start)));
+	}
 
-	fibril_mutex_unlock(&plb_mutex);
+	atomic_fetch_add(&stat_lookups, 1);
+	plb_stat_active_inc();
+
+	entry->index = first * PLB_SLOT_SIZE;
+	entry->len = len;
 
 	/*
 	 * Copy the path into PLB.
 	 */
-	size_t cnt1 = min(len, (PLB_SIZE - first) + 1);
-	size_t cnt2 = len - cnt1;
-
-	memcpy(&plb[first], path, cnt1);
-	memcpy(plb, &path[cnt1], cnt2);
+	memcpy(&plb[entry->index], path, len);
 
-	*start = first;
+	*start = entry->index;
 	return EOK;
 }
 
 static void plb_clear_entry(plb_entry_t *entry, size_t first, size_t len)
 {
-	fibril_mutex_lock(&plb_mutex);
-	list_remove(&entry->plb_link);
 	/*
 	 * Erasing the path from PLB will come handy for debugging purposes.
 	 */
-	size_t cnt1 = min(len, (PLB_SIZE - first) + 1);
-	size_t cnt2 = len - cnt1;
-	memset(&plb[first], 0, cnt1);
-	memset(plb, 0, cnt2);
-	fibril_mutex_unlock(&plb_mutex);
+	memset(&plb[first], 0, len);
+
+	atomic_fetch_sub(&stat_active, 1);
+	plb_slots_release(entry->slots);
+}
+
+/** Get path lookup statistics.
+ *
+ * @param stats Statistics structure to fill in.
+ */
+void vfs_lookup_stats_get(vfs_stats_t *stats)
+{
+	stats->lookups = atomic_load(&stat_lookups);
+	stats->lookups_active = atomic_load(&stat_active);
+	stats->lookups_active_max = atomic_load(&stat_active_max);
+	stats->lookup_waits = atomic_load(&stat_waits);
+	stats->lookup_wait_usec = atomic_load(&stat_wait_usec);
 }
 
 errno_t vfs_link_internal(vfs_node_t *base, char *path, vfs_triplet_t *child)
@@ -202,6 +277,9 @@ errno_t vfs_link_internal(vfs_node_t *base, char *path, vfs_triplet_t *child)
 	if (orig_rc != EOK)
 		rc = orig_rc;
 
+	if (rc == EOK)
+		vfs_dcache_invalidate(true);
+
 out:
 	return rc;
 }
@@ -237,6 +315,42 @@ static errno_t out_lookup(vfs_triplet_t *base, size_t *pfirst, size_t *plen,
 	return EOK;
 }
 
+/** Perform VFS_OUT_LOOKUP using the name cache.
+ *
+ * Lookups which do not modify the name space are answered from the name
+ * cache if possible. Results of other lookups are inserted into the cache.
+ */
+static errno_t out_lookup_cached(vfs_triplet_t *base, size_t *pfirst,
+    size_t *plen, int lflag, vfs_lookup_res_t *result)
+{
+	if ((lflag & (L_CREATE | L_UNLINK)) != 0 ||
+	    !vfs_dcache_enabled(base->fs_handle))
+		return out_lookup(base, pfirst, plen, lflag, result);
+
+	const char *path = (const char *) &plb[*pfirst];
+	size_t first = *pfirst;
+	size_t len = *plen;
+	size_t consumed;
+	unsigned gen;
+	errno_t rc;
+
+	if (vfs_dcache_lookup(base, path, len, lflag, &rc, &consumed, result,
+	    &gen)) {
+		if (rc == EOK) {
+			*pfirst = first + consumed;
+			*plen = len - consumed;
+		}
+
+		return rc;
+	}
+
+	rc = out_lookup(base, pfirst, plen, lflag, result);
+	vfs_dcache_insert(gen, base, path, len, lflag, rc,
+	    (rc == EOK) ? *pfirst - first : 0, result);
+
+	return rc;
+}
+
 static errno_t _vfs_lookup_internal(vfs_node_t *base, char *path, int lflag,
     vfs_lookup_res_t *result, size_t len)
 {
@@ -264,8 +378,8 @@ static errno_t _vfs_lookup_internal(vfs_node_t *base, char *path, int lflag,
 			base = base->mount;
 		}
 
-		rc = out_lookup((vfs_triplet_t *) base, &next, &nlen, lflag,
-		    &res);
+		rc = out_lookup_cached((vfs_triplet_t *) base, &next, &nlen,
+		    lflag, &res);
 		if (rc != EOK)
 			goto out;
 
@@ -387,6 +501,13 @@ errno_t vfs_lookup_internal(vfs_node_t *base, char *path, int lflag,
 
 		vfs_node_put(parent);
 
+		/*
+		 * Creating a name only invalidates the negative name cache
+		 * entries, but removing a name can invalidate any of them.
+		 */
+		if (rc == EOK)
+			vfs_dcache_invalidate((lflag & L_UNLINK) == 0);
+
 	} else {
 		rc = _vfs_lookup_internal(base, path, lflag, result, len);
 	}
@@ -124,6 +124,13 @@ void vfs_node_delref(vfs_node_t *node)
 	fibril_mutex_unlock(&nodes_mutex);
 
 	if (free_node) {
+		/*
+		 * Lookup results in the name cache carry the node size which
+		 * might have changed while the node was active.
+		 */
+		vfs_triplet_t triplet = node_triplet(node);
+		vfs_dcache_size_update(&triplet, node->size);
+
 		/*
 		 * VFS_OUT_DESTROY will free up the file's resources if there
 		 * are no more hard links.
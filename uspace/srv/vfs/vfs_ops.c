@@ -271,6 +271,9 @@ errno_t vfs_op_mount(int mpfd, unsigned service_id, unsigned flags,
 		mp->node->mount = root;
 	}
 
+	if (rc == EOK)
+		vfs_dcache_invalidate(false);
+
 	fibril_rwlock_write_unlock(&namespace_rwlock);
 
 	if (rc != EOK)
@@ -377,6 +380,126 @@ static errno_t rdwr_ipc_client(async_exch_t *exch, vfs_file_t *file, aoff64_t po
 	return rc;
 }
 
+/** Largest vectored request in a file which is staged in a VFS buffer. */
+#define RDWR_VEC_BUF_MAX  (64 * 1024)
+
+/** Vectored read/write request. */
+typedef struct {
+	/** Number of data transfers announced by the client */
+	size_t cnt;
+	/** Sizes of the data transfers announced by the client */
+	const size_t *sizes;
+	/** Sum of @c sizes */
+	size_t total;
+	/** Total number of bytes transferred */
+	size_t bytes;
+	/** True once the transfers of the client are being answered */
+	bool started;
+} rdwr_vec_t;
+
+/** Refuse the pending transfer of a vectored request.
+ *
+ * If the request fails before its transfers are answered, the first
+ * transfer of the client is still pending in the exchange. Answer it with
+ * the error of the request so that the client stops sending and learns the
+ * actual reason of the failure. After a short transfer, the next one is
+ * refused with ELIMIT.
+ *
+ * @param read True for VFS_IN_READV, false for VFS_IN_WRITEV
+ * @param rc   Error code of the request
+ */
+static void rdwr_vec_refuse(bool read, errno_t rc)
+{
+	ipc_call_t call;
+	bool ok;
+
+	if (read)
+		ok = async_data_read_receive(&call, NULL);
+	else
+		ok = async_data_write_receive(&call, NULL);
+
+	async_answer_0(&call, ok ? rc : EINVAL);
+}
+
+/** Forward a sequence of client data transfers to the endpoint FS.
+ *
+ * Each transfer of the client is forwarded to the FS as a separate
+ * VFS_OUT_READ/VFS_OUT_WRITE at the position following the previous
+ * transfer, so that the data is copied only once, directly between the
+ * client and the FS. In a file the position advances by the bytes
+ * transferred, in a directory it advances by one entry per transfer.
+ */
+static errno_t rdwr_ipc_client_vec_forward(async_exch_t *exch,
+    vfs_file_t *file, aoff64_t pos, ipc_call_t *answer, bool read,
+    rdwr_vec_t *vec)
+{
+	errno_t rc = EOK;
+	size_t i;
+
+	vec->started = true;
+
+	for (i = 0; i < vec->cnt; i++) {
+		ipc_call_t call;
+		size_t size;
+		bool ok;
+
+		if (read)
+			ok = async_data_read_receive(&call, &size);
+		else
+			ok = async_data_write_receive(&call, &size);
+
+		if (!ok || size != vec->sizes[i]) {
+			async_answer_0(&call, EINVAL);
+			rc = EINVAL;
+			break;
+		}
+
+		ipc_call_t seg_answer;
+		aoff64_t seg_pos;
+		if (file->node->type == VFS_NODE_DIRECTORY)
+			seg_pos = pos + i;
+		else
+			seg_pos = pos + vec->bytes;
+
+		aid_t msg = async_send_4(exch, read ? VFS_OUT_READ :
+		    VFS_OUT_WRITE, file->node->service_id, file->node->index,
+		    LOWER32(seg_pos), UPPER32(seg_pos), &seg_answer);
+		if (msg == 0) {
+			async_answer_0(&call, EINVAL);
+			rc = EINVAL;
+			break;
+		}
+
+		rc = async_forward_fast(&call, exch, 0, 0, 0,
+		    IPC_FF_ROUTE_FROM_ME);
+		if (rc != EOK) {
+			async_forget(msg);
+			async_answer_0(&call, rc);
+			break;
+		}
+
+		async_wait_for(msg, &rc);
+		if (rc != EOK)
+			break;
+
+		size_t bytes = IPC_GET_ARG1(seg_answer);
+		vec->bytes += bytes;
+		*answer = seg_answer;
+
+		if (bytes < size) {
+			/* Short transfer, refuse the next one. */
+			if (i + 1 < vec->cnt)
+				rdwr_vec_refuse(read, ELIMIT);
+			break;
+		}
+	}
+
+	if (rc != EOK && vec->bytes > 0)
+		return EOK;
+
+	return rc;
+}
+
 static errno_t rdwr_ipc_internal(async_exch_t *exch, vfs_file_t *file, aoff64_t pos,
     ipc_call_t *answer, bool read, void *data)
 {
@@ -391,7 +514,11 @@ static errno_t rdwr_ipc_internal(async_exch_t *exch, vfs_file_t *file, aoff64_t
 	if (msg == 0)
 		return EINVAL;
 
-	errno_t retval = async_data_read_start(exch, chunk->buffer, chunk->size);
+	errno_t retval;
+	if (read)
+		retval = async_data_read_start(exch, chunk->buffer, chunk->size);
+	else
+		retval = async_data_write_start(exch, chunk->buffer, chunk->size);
 	if (retval != EOK) {
 		async_forget(msg);
 		return retval;
@@ -405,6 +532,148 @@ static errno_t rdwr_ipc_internal(async_exch_t *exch, vfs_file_t *file, aoff64_t
 	return (errno_t) rc;
 }
 
+/** Transfer a sequence of client data transfers through a VFS buffer.
+ *
+ * The data of all transfers is staged in a single buffer, so that the FS
+ * sees one VFS_OUT_READ/VFS_OUT_WRITE for the whole sequence. For small
+ * transfers this saves the IPC round trip to the FS per transfer at the
+ * cost of copying the data once more.
+ */
+static errno_t rdwr_ipc_client_vec_buf(async_exch_t *exch, vfs_file_t *file,
+    aoff64_t pos, ipc_call_t *answer, bool read, rdwr_vec_t *vec)
+{
+	rdwr_io_chunk_t chunk = {
+		.buffer = malloc(vec->total),
+		.size = vec->total
+	};
+
+	if (chunk.buffer == NULL)
+		return ENOMEM;
+
+	uint8_t *buf = chunk.buffer;
+	errno_t rc;
+
+	if (read) {
+		rc = rdwr_ipc_internal(exch, file, pos, answer, true, &chunk);
+		if (rc != EOK) {
+			free(buf);
+			return rc;
+		}
+	}
+
+	vec->started = true;
+
+	size_t off = 0;
+	size_t i;
+
+	rc = EOK;
+	for (i = 0; i < vec->cnt; i++) {
+		ipc_call_t call;
+		size_t size;
+		bool ok;
+
+		if (read)
+			ok = async_data_read_receive(&call, &size);
+		else
+			ok = async_data_write_receive(&call, &size);
+
+		if (!ok || size != vec->sizes[i]) {
+			async_answer_0(&call, EINVAL);
+			rc = EINVAL;
+			break;
+		}
+
+		if (read) {
+			size = min(size, chunk.size - off);
+			rc = async_data_read_finalize(&call, buf + off, size);
+		} else {
+			rc = async_data_write_finalize(&call, buf + off, size);
+		}
+
+		if (rc != EOK)
+			break;
+
+		off += size;
+
+		if (size < vec->sizes[i]) {
+			/* Short transfer, refuse the next one. */
+			if (i + 1 < vec->cnt)
+				rdwr_vec_refuse(read, ELIMIT);
+			break;
+		}
+	}
+
+	if (!read && off > 0) {
+		/* Write whatever the client managed to send. */
+		chunk.size = off;
+		rc = rdwr_ipc_internal(exch, file, pos, answer, false, &chunk);
+		off = (rc == EOK) ? chunk.size : 0;
+	}
+
+	free(buf);
+
+	vec->bytes = off;
+	if (rc != EOK && off > 0)
+		return EOK;
+
+	return rc;
+}
+
+/** Transfer a sequence of client data transfers to/from the endpoint FS.
+ *
+ * The client follows the VFS_IN_READV/VFS_IN_WRITEV request with the
+ * sizes of its transfers and then with @c cnt IPC_M_DATA_READ/
+ * IPC_M_DATA_WRITE calls of these sizes in the same exchange. All of them
+ * are handled under a single acquisition of the node's contents lock.
+ * Small requests in a file are staged in a VFS buffer and passed to the FS
+ * in one transfer, the others are forwarded transfer by transfer.
+ *
+ * The client stops sending transfers as soon as one of them fails. If the
+ * FS transfers fewer bytes than requested (e.g. at the end of the file),
+ * the next transfer of the client, if any, is refused with ELIMIT so that
+ * both sides agree on where the sequence ends.
+ *
+ * If some data was transferred before an error occurs, the request
+ * succeeds and reports the number of bytes transferred so far.
+ */
+static errno_t rdwr_ipc_client_vec(async_exch_t *exch, vfs_file_t *file,
+    aoff64_t pos, ipc_call_t *answer, bool read, void *data)
+{
+	rdwr_vec_t *vec = (rdwr_vec_t *) data;
+
+	if (file->node->type != VFS_NODE_DIRECTORY &&
+	    vec->total <= RDWR_VEC_BUF_MAX) {
+		return rdwr_ipc_client_vec_buf(exch, file, pos, answer, read,
+		    vec);
+	}
+
+	return rdwr_ipc_client_vec_forward(exch, file, pos, answer, read, vec);
+}
+
+/** Initialize a vectored request from the sizes announced by the client.
+ *
+ * @return EOK on success, EINVAL if a transfer is empty or too large
+ */
+static errno_t rdwr_vec_init(rdwr_vec_t *vec, const size_t *sizes,
+    size_t cnt)
+{
+	size_t i;
+
+	vec->cnt = cnt;
+	vec->sizes = sizes;
+	vec->total = 0;
+	vec->bytes = 0;
+	vec->started = false;
+
+	for (i = 0; i < cnt; i++) {
+		if (sizes[i] == 0 || sizes[i] > DATA_XFER_LIMIT)
+			return EINVAL;
+		vec->total += sizes[i];
+	}
+
+	return EOK;
+}
+
 static errno_t vfs_rdwr(int fd, aoff64_t pos, bool read, rdwr_ipc_cb_t ipc_cb,
     void *ipc_cb_data)
 {
@@ -478,6 +747,9 @@ static errno_t vfs_rdwr(int fd, aoff64_t pos, bool read, rdwr_ipc_cb_t ipc_cb,
 
 	vfs_exchange_release(fs_exch);
 
+	if (!read && rc == EOK)
+		vfs_acache_invalidate((vfs_triplet_t *) file->node);
+
 	if (file->node->type == VFS_NODE_DIRECTORY)
 		fibril_rwlock_read_unlock(&namespace_rwlock);
 
@@ -508,6 +780,21 @@ errno_t vfs_op_read(int fd, aoff64_t pos, size_t *out_bytes)
 	return vfs_rdwr(fd, pos, true, rdwr_ipc_client, out_bytes);
 }
 
+errno_t vfs_op_readv(int fd, aoff64_t pos, const size_t *sizes, size_t cnt,
+    size_t *out_bytes)
+{
+	rdwr_vec_t vec;
+
+	errno_t rc = rdwr_vec_init(&vec, sizes, cnt);
+	if (rc == EOK)
+		rc = vfs_rdwr(fd, pos, true, rdwr_ipc_client_vec, &vec);
+	if (rc != EOK && !vec.started)
+		rdwr_vec_refuse(true, rc);
+
+	*out_bytes = vec.bytes;
+	return rc;
+}
+
 errno_t vfs_op_rename(int basefd, char *old, char *new)
 {
 	vfs_file_t *base_file = vfs_file_get(basefd);
@@ -619,14 +906,49 @@ errno_t vfs_op_resize(int fd, int64_t size)
 
 	errno_t rc = vfs_truncate_internal(file->node->fs_handle,
 	    file->node->service_id, file->node->index, size);
-	if (rc == EOK)
+	if (rc == EOK) {
 		file->node->size = size;
+		vfs_acache_invalidate((vfs_triplet_t *) file->node);
+	}
 
 	fibril_rwlock_write_unlock(&file->node->contents_rwlock);
 	vfs_file_put(file);
 	return rc;
 }
 
+/** Get node attributes from the attribute cache or the file system.
+ *
+ * @param node VFS node.
+ * @param stat Place to store the attributes.
+ *
+ * @return EOK on success or an error code.
+ */
+static errno_t vfs_stat_cached(vfs_node_t *node, vfs_stat_t *stat)
+{
+	vfs_triplet_t *triplet = (vfs_triplet_t *) node;
+	unsigned gen;
+	errno_t rc;
+
+	if (vfs_acache_get(triplet, stat, &gen))
+		return EOK;
+
+	async_exch_t *exch = vfs_exchange_grab(node->fs_handle);
+	aid_t msg = async_send_2(exch, VFS_OUT_STAT, node->service_id,
+	    node->index, NULL);
+	rc = async_data_read_start(exch, stat, sizeof(vfs_stat_t));
+	vfs_exchange_release(exch);
+
+	errno_t retval;
+	async_wait_for(msg, &retval);
+	if (retval != EOK)
+		rc = retval;
+
+	if (rc == EOK)
+		vfs_acache_insert(gen, triplet, stat);
+
+	return rc;
+}
+
 errno_t vfs_op_stat(int fd)
 {
 	vfs_file_t *file = vfs_file_get(fd);
@@ -634,11 +956,41 @@ errno_t vfs_op_stat(int fd)
 		return EBADF;
 
 	vfs_node_t *node = file->node;
+	errno_t rc;
 
-	async_exch_t *exch = vfs_exchange_grab(node->fs_handle);
-	errno_t rc = async_data_read_forward_fast(exch, VFS_OUT_STAT,
-	    node->service_id, node->index, true, 0, NULL);
-	vfs_exchange_release(exch);
+	if (!vfs_dcache_enabled(node->fs_handle)) {
+		async_exch_t *exch = vfs_exchange_grab(node->fs_handle);
+		rc = async_data_read_forward_fast(exch, VFS_OUT_STAT,
+		    node->service_id, node->index, true, 0, NULL);
+		vfs_exchange_release(exch);
+
+		vfs_file_put(file);
+		return rc;
+	}
+
+	ipc_call_t call;
+	size_t len;
+	if (!async_data_read_receive(&call, &len)) {
+		async_answer_0(&call, EINVAL);
+		vfs_file_put(file);
+		return EINVAL;
+	}
+
+	if (len != sizeof(vfs_stat_t)) {
+		async_answer_0(&call, EINVAL);
+		vfs_file_put(file);
+		return EINVAL;
+	}
+
+	vfs_stat_t stat;
+	rc = vfs_stat_cached(node, &stat);
+	if (rc != EOK) {
+		async_answer_0(&call, rc);
+		vfs_file_put(file);
+		return rc;
+	}
+
+	rc = async_data_read_finalize(&call, &stat, sizeof(vfs_stat_t));
 
 	vfs_file_put(file);
 	return rc;
@@ -661,6 +1013,14 @@ errno_t vfs_op_statfs(int fd)
 	return rc;
 }
 
+errno_t vfs_op_stats(vfs_stats_t *stats)
+{
+	memset(stats, 0, sizeof(vfs_stats_t));
+	vfs_lookup_stats_get(stats);
+	vfs_dcache_stats_get(stats);
+	return EOK;
+}
+
 errno_t vfs_op_sync(int fd)
 {
 	vfs_file_t *file = vfs_file_get(fd);
@@ -819,6 +1179,8 @@ errno_t vfs_op_unmount(int mpfd)
 	vfs_node_put(mp->node);
 	mp->node->mount = NULL;
 
+	vfs_dcache_invalidate(false);
+
 	fibril_rwlock_write_unlock(&namespace_rwlock);
 
 	vfs_file_put(mp);
@@ -916,6 +1278,21 @@ errno_t vfs_op_write(int fd, aoff64_t pos, size_t *out_bytes)
 	return vfs_rdwr(fd, pos, false, rdwr_ipc_client, out_bytes);
 }
 
+errno_t vfs_op_writev(int fd, aoff64_t pos, const size_t *sizes, size_t cnt,
+    size_t *out_bytes)
+{
+	rdwr_vec_t vec;
+
+	errno_t rc = rdwr_vec_init(&vec, sizes, cnt);
+	if (rc == EOK)
+		rc = vfs_rdwr(fd, pos, false, rdwr_ipc_client_vec, &vec);
+	if (rc != EOK && !vec.started)
+		rdwr_vec_refuse(false, rc);
+
+	*out_bytes = vec.bytes;
+	return rc;
+}
+
 /**
  * @}
  */